@@ -0,0 +1,122 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lemon {
+
+// Escapes a Prometheus label value (backslash, double quote, newline)
+std::string prometheus_escape_label_value(const std::string& value);
+
+// Federates the native Prometheus metrics of backend servers (llama-server,
+// vLLM, and whisper.cpp/sd.cpp builds that expose /metrics) into Lemonade's
+// own /metrics. Backends are scraped in parallel on a background thread and
+// the rewritten sample blocks are cached per backend, so a scrape of
+// Lemonade's /metrics only concatenates memory and never waits on a slow or
+// hung backend.
+//
+// Scraping only runs while someone is reading /metrics: after
+// `idle_timeout` without a render() the collector parks until the next one.
+// The cache is kept while parked, so that render() still returns the last
+// sample of every backend that is still loaded, with its age, and wakes the
+// collector.
+class BackendMetricsCollector {
+public:
+    using Labels = std::map<std::string, std::string>;
+
+    struct Target {
+        std::string backend_url;   // e.g. http://127.0.0.1:8001/v1
+        std::string recipe;
+        Labels labels;             // Appended to every federated sample
+    };
+
+    // Freshness of one backend's cached metrics, rendered as
+    // lemonade_backend_metrics_up / lemonade_backend_metrics_age_seconds
+    struct Status {
+        Labels labels;
+        bool up = false;               // Last scrape succeeded
+        double age_seconds = -1.0;     // Since the last successful scrape, -1 if never
+    };
+
+    struct Snapshot {
+        std::string text;              // Federated HELP/TYPE and sample lines
+        std::vector<Status> statuses;
+    };
+
+    using TargetProvider = std::function<std::vector<Target>()>;
+    // Fetches GET /metrics from a backend; returns false on connection errors
+    using Fetcher = std::function<bool(const std::string& backend_url, int& status, std::string& body)>;
+
+    BackendMetricsCollector(TargetProvider provider,
+                            Fetcher fetcher,
+                            int interval_ms = 5000,
+                            std::chrono::seconds idle_timeout = std::chrono::minutes(10));
+    ~BackendMetricsCollector();
+
+    void start();
+    void stop();
+
+    // Scrapes every current target once, in parallel, and updates the cache
+    void scrape_now();
+
+    // Cached metrics of every current target. Never performs I/O; wakes a
+    // parked collector so the following scrapes are fresh.
+    Snapshot render();
+
+    // Metric name prefix used for a recipe's federated metrics, or "" if the
+    // recipe's server has no Prometheus endpoint
+    static std::string metric_prefix_for_recipe(const std::string& recipe);
+
+    // Rewrites one backend's exposition text: metric names are prefixed for
+    // the recipe and `labels` are appended to every sample. Results are
+    // grouped by metric family (HELP/TYPE lines in `metadata`, samples in
+    // `samples`) so several backends can be merged into valid output.
+    static void rewrite_exposition(const std::string& body,
+                                   const std::string& recipe,
+                                   const Labels& labels,
+                                   std::map<std::string, std::string>& metadata,
+                                   std::map<std::string, std::string>& samples);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::string recipe;
+        Labels labels;
+        std::map<std::string, std::string> metadata;  // Family -> HELP/TYPE lines
+        std::map<std::string, std::string> samples;   // Family -> sample lines
+        Clock::time_point scraped_at{};               // Last successful scrape
+        bool up = false;
+        bool unsupported = false;                     // Backend answered 404
+    };
+
+    void collection_loop();
+    // Drops cache entries of backends unloaded while the collector was parked
+    void prune_unloaded();
+    static std::string entry_key(const Target& target);
+
+    TargetProvider provider_;
+    Fetcher fetcher_;
+    const int interval_ms_;
+    const std::chrono::seconds idle_timeout_;
+
+    std::mutex scrape_mutex_;    // Serializes scrape rounds
+
+    mutable std::mutex cache_mutex_;
+    std::map<std::string, Entry> cache_;   // Current targets, by backend URL + recipe
+
+    std::mutex run_mutex_;
+    std::condition_variable run_cv_;
+    bool running_ = false;
+    Clock::time_point last_render_{};
+    std::thread thread_;
+};
+
+} // namespace lemon
@@ -2,6 +2,8 @@
 
 #include "../wrapped_server.h"
 #include "backend_utils.h"
+#include "../llamacpp_autotune.h"
+#include <functional>
 #include <string>
 
 namespace lemon {
@@ -54,6 +56,24 @@ public:
 
     // ITokenizerServer implementation
     json tokenize(const json& request) override;
+
+    // Runs one benchmark process, so the caller can hold off model loads for
+    // just that run
+    using BenchRunner = std::function<void(const std::function<void()>& bench)>;
+
+    // Measures threads, flash attention, batch sizes and (when the release
+    // ships llama-batched-bench) parallel slots for `model_info` on this
+    // host with short llama-bench runs, using the backend and device from
+    // `options`. `fingerprint` receives the host_fingerprint() the result
+    // belongs under in the `llamacpp_tuning` option. Each run goes through
+    // `run_bench` when set. Once `cancelled` returns true the current run is
+    // killed and autotune throws. Throws on failure.
+    static LlamaCppTuning autotune(const ModelInfo& model_info,
+                                   const RecipeOptions& options,
+                                   BackendManager* backend_manager,
+                                   std::string& fingerprint,
+                                   const BenchRunner& run_bench = nullptr,
+                                   const std::function<bool()>& cancelled = nullptr);
 };
 
 } // namespace backends
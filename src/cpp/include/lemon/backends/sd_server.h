@@ -54,9 +54,10 @@ public:
     // sd-server's HTTP API does not expose an upscaling endpoint, so we use the
     // sd-cli binary's -M upscale mode as a subprocess.
     //
-    // Called by Server::handle_image_upscale (server.cpp), which is registered
-    // as the route handler for POST /api/v1/images/upscale (see register_post
-    // in Server::Server).
+    // Called through UpscaleWorkerPool (upscale_worker.h) by
+    // Server::handle_image_upscale (server.cpp), which is registered as the
+    // route handler for POST /api/v1/images/upscale (see register_post in
+    // Server::Server). The pool uses it whenever no primed worker can serve.
     //
     // Endpoint: POST /api/v1/images/upscale
     //   Request body (JSON):
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "../utils/process_manager.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace lemon {
+namespace backends {
+
+// Keeps one sd-cli upscaler primed per ESRGAN model so /images/upscale does
+// not pay for a process start, library loading and two temp-file round trips
+// on every request.
+//
+// sd-cli handles a single image per run, so a worker is a standby process
+// started ahead of time with named pipes as its -i/-o paths: it sits blocked
+// on its input until a request arrives, the PNG bytes go in and come back
+// through the pipes, and the next standby is started as soon as it exits.
+// Workers idle for `idle_timeout_seconds` are stopped. A model whose standby
+// cannot be started or driven (no FIFO support on Windows, an sd-cli that
+// never opens its input, or LEMONADE_UPSCALE_WORKER=0) falls back to
+// one-shot runs. An image the standby rejects is a failed request, not a
+// broken worker.
+class UpscaleWorkerPool {
+public:
+    using EnvVars = std::vector<std::pair<std::string, std::string>>;
+    // One-shot upscale used when no worker can serve, with the contract of
+    // upscale(); SDServer::upscale_via_cli in the server
+    using OneShotFn = std::function<std::string(const std::string& b64_image,
+                                                const std::string& upscale_model_path,
+                                                const std::string& cli_exe_path,
+                                                const EnvVars& env_vars)>;
+
+    explicit UpscaleWorkerPool(OneShotFn one_shot, int idle_timeout_seconds = 300);
+    ~UpscaleWorkerPool();
+
+    UpscaleWorkerPool(const UpscaleWorkerPool&) = delete;
+    UpscaleWorkerPool& operator=(const UpscaleWorkerPool&) = delete;
+
+    // Base64 PNG in, base64 PNG out, "" on failure. Requests for one model
+    // run one at a time.
+    std::string upscale(const std::string& b64_image,
+                        const std::string& upscale_model_path,
+                        const std::string& cli_exe_path,
+                        const EnvVars& env_vars);
+
+    // Stops every worker, e.g. when all models are unloaded
+    void clear();
+
+    // Workers currently holding a standby process
+    size_t standby_count() const;
+
+private:
+    struct Worker {
+        std::mutex mutex;  // Serializes upscales for this model
+        std::string cli_exe_path;
+        std::string model_path;
+        EnvVars env_vars;
+        std::string dir;  // Holds the input/output FIFOs
+        utils::ProcessHandle process{nullptr, 0};
+        bool has_process = false;
+        bool disabled = false;  // The standby could not be started or fed; use one-shot runs
+        std::vector<utils::ProcessHandle> exiting;  // Finished runs not yet reaped
+        std::chrono::steady_clock::time_point last_used;
+    };
+
+    std::shared_ptr<Worker> get_worker(const std::string& model_path,
+                                       const std::string& cli_exe_path,
+                                       const EnvVars& env_vars);
+    static bool start_standby(Worker& worker);
+    static void stop_standby(Worker& worker);
+    static void remove_worker_dir(Worker& worker);
+    static void reap_exiting(Worker& worker, bool force);
+    // Runs one image through the standby. Returns false if the standby never
+    // opened its input; otherwise `upscaled` is the PNG it produced, "" if
+    // it produced none
+    static bool run_standby(Worker& worker, const std::string& png, std::string& upscaled);
+    void reap_loop();
+
+    const OneShotFn one_shot_;
+    const std::chrono::seconds idle_timeout_;
+    const bool enabled_;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, std::shared_ptr<Worker>> workers_;  // Keyed by cli + model path
+
+    std::atomic<bool> running_{true};
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::thread reaper_;
+};
+
+} // namespace backends
+} // namespace lemon
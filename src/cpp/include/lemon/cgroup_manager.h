@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lemon {
+
+// Resource controls written to a backend's cgroup when it is created.
+// Sized from the model's expected resident memory and its priority:
+// interactive backends get their memory protected from reclaim and a large
+// CPU share, batch backends are reclaimed first and throttled above their
+// expected size, so they absorb host pressure. Neither gets a hard cap.
+struct CgroupLimits {
+    int64_t memory_low = 0;    // Bytes protected from reclaim; 0 = none
+    int64_t memory_high = -1;  // Reclaim/throttle above; -1 = no limit
+    int64_t memory_max = -1;   // OOM-kill above; -1 = no limit
+    int cpu_weight = 100;      // 1-10000, cgroup v2 default 100
+
+    // `expected_bytes` of 0 (unknown size) leaves memory unlimited
+    static CgroupLimits for_backend(bool interactive, int64_t expected_bytes);
+};
+
+// Counters from a cgroup's memory.events file
+struct CgroupMemoryEvents {
+    uint64_t low = 0;       // Reclaimed below memory.low
+    uint64_t high = 0;      // Throttled above memory.high
+    uint64_t max = 0;       // Hit memory.max
+    uint64_t oom = 0;       // Allocation failed at memory.max
+    uint64_t oom_kill = 0;  // Processes OOM-killed
+
+    // Whether the cgroup hit its hard limit rather than only being
+    // reclaimed or throttled
+    bool hard() const { return max > 0 || oom > 0 || oom_kill > 0; }
+    bool any() const { return low > 0 || high > 0 || hard(); }
+    // Counters that grew since `before`
+    CgroupMemoryEvents since(const CgroupMemoryEvents& before) const;
+};
+
+CgroupMemoryEvents parse_memory_events(const std::string& text);
+
+// Puts each backend process in its own cgroup v2 leaf under a subtree
+// delegated to lemond, so the kernel accounts, limits and OOM-kills per
+// backend instead of picking a victim host-wide. A watcher thread follows
+// every leaf's memory.events and reports limit hits to the pressure
+// callback. Everything is a no-op where cgroup v2 is not mounted or not
+// writable (e.g. an unprivileged service without Delegate=yes).
+class CgroupManager {
+public:
+    // Called from the watcher thread with the leaf's label, its directory and
+    // the counters that grew
+    using PressureCallback = std::function<void(const std::string& label, const std::string& leaf,
+                                                const CgroupMemoryEvents& events)>;
+
+    // Manages leaves under `base_dir`, a cgroup whose subtree_control
+    // already enables the memory (and ideally cpu) controller. An empty
+    // `base_dir` gives a disabled manager.
+    explicit CgroupManager(std::string base_dir);
+    ~CgroupManager();
+
+    // The process-wide manager. On Linux, when lemond's own cgroup (from
+    // /proc/self/cgroup) is writable, lemond moves itself into a "lemond"
+    // leaf and backends get sibling leaves. LEMONADE_CGROUPS=0 disables it.
+    static CgroupManager& global();
+
+    bool available() const { return !base_dir_.empty(); }
+    const std::string& base_dir() const { return base_dir_; }
+
+    // Creates a leaf for `label` (a model name), applies `limits` and moves
+    // `pid` into it. Returns the leaf directory, or "" when unavailable or
+    // the process could not be moved.
+    std::string attach(const std::string& label, int pid, const CgroupLimits& limits);
+
+    // Stops watching the leaf and removes it once its processes have exited
+    void release(const std::string& leaf);
+
+    // Bytes charged to the leaf (memory.current); -1 when unknown
+    static int64_t memory_current(const std::string& leaf);
+
+    void set_pressure_callback(PressureCallback callback);
+
+private:
+    struct Leaf {
+        std::string label;
+        CgroupMemoryEvents seen;
+    };
+
+    void watch_loop();
+    void wake_watcher();
+    void remove_released_leaves();
+
+    const std::string base_dir_;
+    std::mutex mutex_;
+    std::map<std::string, Leaf> leaves_;  // By leaf directory
+    std::vector<std::string> released_;   // Awaiting rmdir
+
+    std::mutex callback_mutex_;
+    PressureCallback pressure_callback_;
+
+    std::atomic<bool> running_{false};
+    std::thread watcher_;
+    int wake_pipe_[2] = {-1, -1};
+};
+
+} // namespace lemon
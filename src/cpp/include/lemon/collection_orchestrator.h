@@ -2,10 +2,12 @@
 
 #include <functional>
 #include <map>
+#include <optional>
 #include <string>
 #include <vector>
 #include <httplib.h>
 #include <nlohmann/json.hpp>
+#include "collection_tool_runner.h"
 #include "model_manager.h"
 
 namespace lemon {
@@ -45,11 +47,7 @@ public:
     // A piece of media produced by a tool this turn. Public so non-OpenAI
     // surfaces (the MCP gateway) can render artifacts as their own native
     // content blocks instead of markdown/HTML data-URIs.
-    struct Artifact {
-        std::string type;  // "image" | "audio"
-        std::string data;  // base64 payload
-        std::string mime;  // e.g. "image/png", "audio/mpeg"
-    };
+    using Artifact = CollectionArtifact;
 
     // Structured view of one orchestrator turn. For callers (MCP) that need
     // the artifacts as separate values instead of having them folded into a
@@ -61,6 +59,7 @@ public:
         std::vector<Artifact> artifacts;       // media produced this turn, in order
         json app_tool_calls = nullptr;         // non-null array => passthrough to caller
         std::string finish_reason = "stop";    // "stop" | "tool_calls"
+        json tool_timings = json::array();     // one entry per omni tool call
     };
 
     // Run the loop and return a complete OpenAI chat.completion JSON object.
@@ -94,6 +93,7 @@ private:
         json app_tool_calls = nullptr;  // non-null array => passthrough to caller
         std::string finish_reason = "stop";
         json base_response = json::object();
+        json tool_timings = json::array();
     };
 
     ToolSet build_tools(const ModelInfo& collection_info, const json& request);
@@ -103,14 +103,15 @@ private:
     LoopResult run_loop(const json& request, const ModelInfo& collection_info,
                         const std::function<void(const Artifact&)>& on_artifact);
 
-    // Execute one omni tool call. Appends or replaces an entry in `artifacts` and
-    // sets `produced_index` to that slot (or -1 if no media was produced).
-    // `success_text` receives the role:"tool" content reported back to the model.
-    // Returns true on success. Throws on backend error.
+    // Execute one omni tool call. Sets `produced` to the media it made, if any;
+    // edit_image operates on `source_image_b64` and its result replaces the
+    // latest image when committed. `success_text` receives the role:"tool"
+    // content reported back to the model. Returns true on success. Throws on
+    // backend error. Safe to call concurrently for independent calls.
     bool execute_tool(const std::string& tool_name, const std::string& model,
-                      const json& args, std::vector<Artifact>& artifacts,
-                      const std::string& source_image_b64, const std::string& source_image_mime,
-                      int& produced_index, std::string& success_text);
+                      const json& args, const std::string& source_image_b64,
+                      const std::string& source_image_mime,
+                      std::optional<Artifact>& produced, std::string& success_text);
 
     // Render an artifact as the markdown/HTML a frontend (Open WebUI) displays.
     static std::string render_artifact(const Artifact& artifact);
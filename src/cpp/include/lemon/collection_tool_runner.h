@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace lemon {
+
+using json = nlohmann::json;
+
+// A piece of media produced by an omni tool call
+struct CollectionArtifact {
+    std::string type;  // "image" | "audio"
+    std::string data;  // base64 payload
+    std::string mime;  // e.g. "image/png", "audio/mpeg"
+};
+
+// Runs the omni tool calls of one planner turn for CollectionOrchestrator.
+//
+// Independent calls (e.g. generate_image + text_to_speech) hit different
+// backends, so they run concurrently. A call waits for the earlier calls in
+// its `deps`; edit_image uses the newest image those produced as its source.
+// Outcomes are handed back in call order, so artifact order never depends on
+// which backend finishes first. Every worker has finished by the time run()
+// returns or throws.
+class CollectionToolRunner {
+public:
+    struct Call {
+        std::string name;
+        std::string model;
+        json args = json::object();
+        bool skip = false;             // Answered by the caller without running
+        std::vector<size_t> deps;      // Earlier calls this one must wait for
+    };
+
+    struct Outcome {
+        bool ok = false;
+        std::optional<CollectionArtifact> produced;
+        std::string text;              // role:"tool" content reported back to the planner
+        double wait_ms = 0.0;          // Waiting on the calls in `deps`
+        double load_ms = 0.0;          // ensure_loaded for the component model
+        double execute_ms = 0.0;
+        // {tool, model, status, wait_ms, load_ms, execute_ms}; status is
+        // "ok", "error" or "skipped"
+        json timing = json::object();
+    };
+
+    // Loads a component model on demand. Throws on failure.
+    using EnsureLoadedFn = std::function<void(const std::string& model)>;
+    // Runs one call against its component. `source_b64`/`source_mime` is the
+    // image an edit operates on. Returns true on success; throws on backend
+    // error. Called concurrently for independent calls.
+    using ExecuteFn = std::function<bool(const Call& call, const std::string& source_b64,
+                                         const std::string& source_mime,
+                                         std::optional<CollectionArtifact>& produced,
+                                         std::string& text)>;
+    // Receives each call's outcome in call order, skipped calls included
+    using CommitFn = std::function<void(size_t index, const Outcome& outcome)>;
+
+    CollectionToolRunner(EnsureLoadedFn ensure_loaded, ExecuteFn execute);
+
+    // Runs `calls` and commits their outcomes in order. An edit with no image
+    // from its deps falls back to `prior_b64`/`prior_mime`. If `commit`
+    // throws, the remaining workers are waited for before it propagates.
+    void run(const std::vector<Call>& calls, const std::string& prior_b64,
+             const std::string& prior_mime, const CommitFn& commit) const;
+
+private:
+    EnsureLoadedFn ensure_loaded_;
+    ExecuteFn execute_;
+};
+
+} // namespace lemon
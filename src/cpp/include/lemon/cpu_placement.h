@@ -0,0 +1,87 @@
+#pragma once
+
+#include <lemon/utils/process_manager.h>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace lemon {
+
+// One physical core and its logical CPUs (SMT siblings)
+struct CpuCore {
+    int package = 0;
+    int node = 0;
+    std::vector<int> cpus;
+};
+
+struct CpuTopology {
+    std::vector<CpuCore> cores;  // Online cores, ordered by NUMA node then first CPU
+    int node_count = 0;
+
+    // Reads cpu/online, cpu/cpuN/topology and node/nodeN/cpulist under
+    // `sysfs_root`. Hosts without NUMA information are one node; an empty
+    // topology means the CPU layout could not be read.
+    static CpuTopology read_sysfs(const std::string& sysfs_root = "/sys/devices/system");
+
+    int cores_on_node(int node) const;
+    int largest_node_cores() const;
+};
+
+// "0-3,8,10-11" <-> {0,1,2,3,8,10,11}
+std::vector<int> parse_cpu_list(const std::string& list);
+std::string format_cpu_list(std::vector<int> cpus);
+
+// Hands out disjoint sets of physical cores to backend processes so models
+// resident on one CPU host do not contend for the same cores, keeping each
+// set on one NUMA node when it fits. Best fit: the node with the fewest free
+// cores that still holds the whole request, leaving large nodes for large
+// requests. A request that fits no single node spans nodes; one that cannot
+// get at least half its cores runs unplaced (on any CPU).
+class CpuPlacementPlanner {
+public:
+    explicit CpuPlacementPlanner(CpuTopology topology, bool enabled = true);
+
+    // The process-wide planner for this host. Enabled on Linux hosts with
+    // more than one NUMA node; LEMONADE_CPU_PLACEMENT=1 enables it on any
+    // Linux host and LEMONADE_CPU_PLACEMENT=0 disables it.
+    static CpuPlacementPlanner& global();
+
+    bool enabled() const { return enabled_; }
+
+    // Cores a backend of `recipe` should get. `threads` is the compute
+    // thread count the backend was configured with (0 = the recipe's
+    // default): LLM and image backends default to the largest NUMA node
+    // shared between replicas, speech backends to 4 cores. Recipes that do
+    // not run on the CPU get 0.
+    int core_demand(const std::string& recipe, int threads, int replica_count) const;
+
+    // Reserves `cores` cores for `owner`, replacing what it held before.
+    // `label` names the owner in to_json(). Returns an empty placement when
+    // disabled or when too few cores are free.
+    utils::CpuPlacement reserve(uint64_t owner, const std::string& label, int cores);
+    void release(uint64_t owner);
+
+    // {"enabled", "nodes", "cores", "free_cores", "assignments": [{label, cpus, cores, numa_node}]}
+    nlohmann::json to_json() const;
+
+private:
+    struct Assignment {
+        std::string label;
+        std::vector<size_t> cores;  // Indices into topology_.cores
+        int numa_node = -1;
+    };
+
+    utils::CpuPlacement placement_for(const Assignment& assignment) const;
+
+    const CpuTopology topology_;
+    const bool enabled_;
+    mutable std::mutex mutex_;
+    std::vector<bool> core_taken_;
+    std::map<uint64_t, Assignment> assignments_;
+};
+
+} // namespace lemon
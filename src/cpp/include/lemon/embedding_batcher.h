@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "histogram.h"
+
+namespace lemon {
+
+using json = nlohmann::json;
+
+// Coalesces concurrent /v1/embeddings and /v1/rerank requests for the same
+// model into one backend call. The first request for a group becomes the
+// leader: it waits up to window_ms for compatible requests (same model and
+// parameters; for rerank also the same query), sends one combined `input` /
+// `documents` array, then scatters the response back to every caller with
+// per-caller indices and apportioned usage. No extra threads are involved —
+// callers block on their own HTTP worker thread exactly as they would for a
+// direct backend call.
+class EmbeddingBatcher {
+public:
+    enum class Kind { Embeddings, Reranking };
+
+    struct Limits {
+        int window_ms = 0;          // <= 0 disables coalescing
+        int max_batch_size = 64;    // Max inputs/documents per backend call
+        int max_batch_tokens = 8192;  // Approximate token budget per backend call
+    };
+
+    // Sends one (possibly combined) request to the backend.
+    using DispatchFn = std::function<json(const json& request)>;
+
+    EmbeddingBatcher();
+
+    // Runs `request` through the coalescer. Requests that cannot be combined
+    // (unparseable input, streaming-style token arrays mixed with text, ...)
+    // are dispatched directly. Exceptions thrown by `dispatch` are rethrown to
+    // every caller in the affected batch.
+    json submit(Kind kind, const json& request, const Limits& limits, const DispatchFn& dispatch);
+
+    // {"embeddings": {...}, "reranking": {...}} with batch-size / added-latency
+    // histograms and request/batch counters for /metrics.
+    json get_stats() const;
+
+    // Helpers exposed for unit tests.
+    static std::string group_key(Kind kind, const json& request);
+    static bool extract_items(Kind kind, const json& request, std::vector<json>& items);
+
+private:
+    struct Entry {
+        const json* request = nullptr;
+        std::vector<json> items;
+        size_t offset = 0;            // Position of items[0] in the combined array
+        long weight = 0;              // Approximate token count (usage apportioning)
+        std::chrono::steady_clock::time_point enqueued;
+        json response;
+        std::exception_ptr error;
+        bool done = false;
+    };
+
+    struct Batch {
+        std::vector<Entry*> entries;
+        size_t item_count = 0;
+        long token_count = 0;
+        bool closed = false;          // No further joins; leader may dispatch now
+        std::condition_variable cv;
+    };
+
+    struct KindStats {
+        KindStats();
+        Histogram batch_size;
+        Histogram added_latency_seconds;
+        uint64_t requests_total = 0;
+        uint64_t batches_total = 0;
+    };
+
+    void run_batch(Kind kind, const std::shared_ptr<Batch>& batch, const DispatchFn& dispatch);
+    static json build_combined_request(Kind kind, const Batch& batch);
+    static void scatter(Kind kind, Batch& batch, const json& response);
+    static long estimate_tokens(const json& item);
+    KindStats& stats_for(Kind kind) { return kind == Kind::Embeddings ? embeddings_stats_ : reranking_stats_; }
+
+    mutable std::mutex mutex_;
+    std::map<std::string, std::shared_ptr<Batch>> open_batches_;
+    KindStats embeddings_stats_;
+    KindStats reranking_stats_;
+};
+
+} // namespace lemon
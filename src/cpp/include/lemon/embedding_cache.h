@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace lemon {
+
+using json = nlohmann::json;
+
+// Content-addressed cache of embedding vectors. Entries are keyed by
+// SHA-256(checkpoint, request options that change the vector, input item), so
+// the same chunk embedded by the same model with the same normalization is
+// only ever computed once.
+//
+// Two tiers:
+//   - memory: LRU bounded by a byte budget; float vectors are stored packed as
+//     float32 (what the backends compute in) rather than as JSON.
+//   - disk (optional): a file cache with one small file per entry under
+//     <cache_dir>/embeddings, promoted into memory on hit. Bounded by its own
+//     byte budget, oldest files removed first.
+//
+// All methods are thread-safe.
+class EmbeddingCache {
+public:
+    EmbeddingCache() = default;
+
+    // (Re)applies budgets. A zero memory budget disables the cache entirely;
+    // a zero disk budget (or empty dir) disables the disk tier. Switching to
+    // a new disk directory indexes its files without holding up lookups.
+    // Meant to run at startup and when the settings change.
+    void configure(size_t memory_bytes, size_t disk_bytes, const std::string& disk_dir);
+
+    bool enabled() const;
+
+    // Hex SHA-256 over the three key components.
+    static std::string make_key(const std::string& checkpoint, const json& options, const json& item);
+
+    // Returns true and fills `embedding` on a hit. `input_bytes` is the size
+    // of the input item, accounted as bytes saved when the lookup hits.
+    bool lookup(const std::string& key, size_t input_bytes, json& embedding);
+
+    void insert(const std::string& key, const json& embedding);
+
+    // {"hits", "misses", "disk_hits", "bytes_saved", "memory_bytes",
+    //  "memory_entries", "disk_bytes", "disk_entries"}
+    json get_stats() const;
+
+    // Exposed for unit tests.
+    static std::string encode(const json& embedding);
+    static bool decode(const char* data, size_t size, json& embedding);
+
+private:
+    struct MemoryEntry {
+        std::string key;
+        std::string blob;
+    };
+    struct DiskEntry {
+        std::string key;
+        size_t size;
+    };
+
+    std::string disk_path(const std::string& key) const;
+    bool read_disk_entry(const std::string& key, std::string& blob) const;
+    void insert_memory_locked(const std::string& key, std::string blob);
+    static void load_disk_index(const std::string& dir, std::list<DiskEntry>& lru,
+                                std::unordered_map<std::string, std::list<DiskEntry>::iterator>& index,
+                                size_t& bytes);
+    std::vector<std::string> trim_disk_locked();
+
+    mutable std::mutex mutex_;
+    size_t memory_budget_ = 0;
+    size_t disk_budget_ = 0;
+    std::string disk_dir_;
+
+    std::list<MemoryEntry> memory_lru_;  // Front = most recently used
+    std::unordered_map<std::string, std::list<MemoryEntry>::iterator> memory_index_;
+    size_t memory_bytes_ = 0;
+
+    std::list<DiskEntry> disk_lru_;      // Front = most recently written/read
+    std::unordered_map<std::string, std::list<DiskEntry>::iterator> disk_index_;
+    size_t disk_bytes_ = 0;
+
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t disk_hits_ = 0;
+    uint64_t bytes_saved_ = 0;
+};
+
+} // namespace lemon
@@ -21,6 +21,7 @@ namespace ErrorType {
     constexpr const char* FILE_ERROR = "file_error";
     constexpr const char* INTERNAL_ERROR = "internal_error";
     constexpr const char* SLOTS_PINNED = "slots_pinned_error";
+    constexpr const char* REQUEST_CANCELLED = "request_cancelled";
 }
 
 // Base exception class for all Lemon errors
@@ -35,7 +36,8 @@ public:
 
     const std::string& type() const { return type_; }
 
-    json to_json() const {
+    // Virtual so ErrorResponse::from_exception() keeps the fields subclasses add
+    virtual json to_json() const {
         return {
             {"error", {
                 {"message", message_},
@@ -70,7 +72,7 @@ public:
         : LemonException(backend + " error: " + message, ErrorType::BACKEND_ERROR),
           backend_(backend), status_code_(status_code) {}
 
-    json to_json() const {
+    json to_json() const override {
         auto j = LemonException::to_json();
         j["error"]["backend"] = backend_;
         if (status_code_ > 0) {
@@ -103,6 +105,22 @@ public:
                         ErrorType::UNSUPPORTED_OPERATION) {}
 };
 
+// The client went away before the backend answered. Reported with the
+// non-standard 499 (client closed request) status, which nobody receives but
+// keeps the access log honest.
+class RequestCancelledException : public LemonException {
+public:
+    RequestCancelledException(const std::string& details = "")
+        : LemonException("Request cancelled" + (details.empty() ? "" : ": " + details),
+                        ErrorType::REQUEST_CANCELLED) {}
+
+    json to_json() const override {
+        auto j = LemonException::to_json();
+        j["error"]["status_code"] = 499;
+        return j;
+    }
+};
+
 // Helper class for consistent error responses
 class ErrorResponse {
 public:
@@ -4,6 +4,15 @@
 #include <thread>
 #include <atomic>
 #include <mutex>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <optional>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
 
 namespace lemon {
 
@@ -11,20 +20,65 @@ class Router;
 class GlobalVramMonitor;
 class WrappedServer;
 
+// Per-server eviction settings, parsed once from the recipe options when the
+// server is created instead of on every evaluation.
+struct EvictionPolicy {
+    std::optional<bool> auto_evict;     // Unset: follow the global auto_evict setting
+    long evict_idle_timeout_sec = 300;
+    long downsize_idle_timeout_sec = 60;
+    double weight_factor = 1.0;
+    std::string priority;               // "interactive", "batch", or "" for the model type's default
+
+    static EvictionPolicy from_recipe_options(const nlohmann::json& recipe_options);
+};
+
+// Downsizes and evicts idle models. Instead of polling on a fixed interval,
+// the engine keeps a min-heap of each server's next idle deadline and sleeps
+// until the earliest one, a VRAM-pressure signal, or server activity that
+// requires re-arming. The router lock is only taken when something is due.
 class EvictionEngine {
 public:
     EvictionEngine(Router* router, GlobalVramMonitor* vram_monitor);
     ~EvictionEngine();
 
-    void start(int interval_ms = 5000);
+    // `fallback_interval_ms` bounds how long the engine sleeps with nothing
+    // armed, so runtime changes to the global auto_evict setting are picked up.
+    void start(int fallback_interval_ms = 60000);
     void stop();
 
     // Triggered by GlobalVramMonitor when pressure breaches threshold
     void on_vram_pressure(double pct);
 
+    // Triggered by CgroupManager when `model_name`'s backend went over its own
+    // memory.high in its cgroup `leaf` (`hard`: it hit memory.max). Only that
+    // backend reacts, since the limits are its own: if idle it is downsized,
+    // and at a hard limit evicted when it cannot be downsized. A busy backend
+    // is left to the kernel's throttling.
+    void on_memory_pressure(const std::string& model_name, const std::string& leaf, bool hard);
+
+    // Triggered by CgroupManager when host-wide reclaim reached the memory.low
+    // protection of `model_name`'s backend. The backend that reported it is
+    // not at fault; an idle batch model is shed instead, the one with the
+    // most memory charged to its cgroup first.
+    void on_host_memory_pressure(const std::string& model_name);
+
+    // Called when a server is accessed, finishes its last request or is
+    // unpinned: arms its next idle deadline. Lock-free when an earlier
+    // deadline is already armed.
+    void note_activity(const WrappedServer* server);
+
 private:
+    using Clock = std::chrono::steady_clock;
+    using Deadline = std::pair<Clock::time_point, std::string>;
+
     void evaluation_loop();
-    void evaluate_servers(double current_vram_pct);
+    // Returns true if a model was evicted, in which case the caller re-runs the
+    // evaluation so every remaining server gets re-armed.
+    bool evaluate_servers(double current_vram_pct);
+    void relieve_memory_pressure(const std::string& leaf, bool hard);
+    void relieve_host_memory_pressure();
+    void arm(const std::string& model_name, Clock::time_point deadline);
+    void publish_next_deadline_locked();
 
     Router* router_;
     GlobalVramMonitor* vram_monitor_;
@@ -32,6 +86,19 @@ private:
     std::atomic<bool> running_;
     int interval_ms_;
     std::thread engine_thread_;
+
+    std::mutex timer_mutex_;
+    std::condition_variable timer_cv_;
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> deadlines_;
+    std::unordered_map<std::string, Clock::time_point> armed_;  // Live heap entry per model
+    // Top of deadlines_ (Clock::time_point::max() when empty), readable
+    // without timer_mutex_. Any deadline firing runs a full pass that re-arms
+    // every idle server, so activity due no earlier than this needs no arm().
+    std::atomic<Clock::rep> next_deadline_{Clock::time_point::max().time_since_epoch().count()};
+    double pending_pressure_pct_ = -1.0;
+    // By cgroup leaf: 1 reclaim/throttle, 2 hard limit
+    std::map<std::string, int> pending_memory_pressure_;
+    bool pending_host_pressure_ = false;
 };
 
 } // namespace lemon
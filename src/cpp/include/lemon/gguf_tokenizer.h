@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace lemon {
+
+/// Tokenizer rebuilt from a GGUF file's `tokenizer.ggml.*` metadata.
+///
+/// Follows llama.cpp's SentencePiece ("llama": score-ordered bigram merges
+/// with <0xXX> byte fallback) and byte-level BPE ("gpt2": ranked merges after
+/// the gpt-2, llama3 or qwen2 pre-tokenizer split) vocabularies, so prompt
+/// token counts are known without a round trip to the backend. Unicode
+/// classes for the pre-tokenizer are exact for ASCII and approximate for
+/// rarer scripts; other vocab types (WordPiece, Unigram, RWKV) and BPE
+/// pre-tokenizers are not implemented and make load() return nullptr.
+class GgufTokenizer {
+public:
+    /// Reads the vocabulary from `gguf_path`. Returns nullptr, with the
+    /// reason in `error`, when the file has no supported vocabulary.
+    static std::shared_ptr<const GgufTokenizer> load(const std::string& gguf_path,
+                                                     std::string* error = nullptr);
+
+    /// add_special: add BOS/EOS the way the model asks for them.
+    /// parse_special: control tokens written in the text (e.g.
+    /// "<|im_start|>") become single tokens, as llama-server does.
+    std::vector<int32_t> tokenize(const std::string& text, bool add_special,
+                                  bool parse_special) const;
+
+    /// Text of one token, with byte tokens and byte-level BPE decoded
+    std::string token_to_piece(int32_t id) const;
+
+    size_t vocab_size() const { return tokens_.size(); }
+    const std::string& model_type() const { return model_type_; }
+
+private:
+    enum class PreTokenizer { None, Gpt2, Llama3, Qwen2 };
+
+    GgufTokenizer() = default;
+    bool init(const std::vector<std::string>& merges, std::string* error);
+
+    void tokenize_spm(const std::string& text, std::vector<int32_t>& out) const;
+    void tokenize_bpe(const std::string& text, std::vector<int32_t>& out) const;
+    void bpe_word(const char* data, size_t len, std::vector<int32_t>& out) const;
+    int32_t find_token(const std::string& text) const;
+
+    std::string model_type_;  // "llama" (SentencePiece) or "gpt2" (BPE)
+    PreTokenizer pre_ = PreTokenizer::None;
+    std::vector<std::string> tokens_;
+    std::vector<float> scores_;
+    std::vector<int32_t> token_types_;
+    std::unordered_map<std::string, int32_t> token_to_id_;
+
+    // (left id, right id) -> (rank, merged id)
+    std::unordered_map<uint64_t, std::pair<int32_t, int32_t>> merges_;
+    std::array<int32_t, 256> byte_tokens_{};  // SPM <0xXX> / BPE byte symbols
+
+    // Tokens matched literally in the text, longest first per leading byte
+    std::array<std::vector<int32_t>, 256> specials_by_byte_;
+
+    int32_t bos_ = -1;
+    int32_t eos_ = -1;
+    int32_t unk_ = -1;
+    bool add_bos_ = false;
+    bool add_eos_ = false;
+    bool add_space_prefix_ = true;
+    bool ignore_merges_ = false;
+};
+
+/// Tokenizers keyed by GGUF path, so each model's vocabulary is read once.
+/// Files without a supported vocabulary are remembered as such.
+class GgufTokenizerCache {
+public:
+    explicit GgufTokenizerCache(size_t capacity = 8) : capacity_(capacity) {}
+
+    std::shared_ptr<const GgufTokenizer> get(const std::string& gguf_path);
+
+private:
+    using Entry = std::pair<std::string, std::shared_ptr<const GgufTokenizer>>;
+
+    const size_t capacity_;
+    std::mutex mutex_;
+    std::list<Entry> lru_;  // Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+};
+
+} // namespace lemon
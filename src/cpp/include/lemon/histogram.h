@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace lemon {
+
+using json = nlohmann::json;
+
+// Fixed-bucket histogram with Prometheus semantics (cumulative "le" buckets
+// plus _sum/_count). Thread-safe; observe() is a short critical section so it
+// can sit on request paths. Rendered by build_prometheus_metrics via to_json().
+class Histogram {
+public:
+    explicit Histogram(std::vector<double> upper_bounds)
+        : bounds_(std::move(upper_bounds)), counts_(bounds_.size() + 1, 0) {}
+
+    void observe(double value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t i = 0;
+        while (i < bounds_.size() && value > bounds_[i]) {
+            ++i;
+        }
+        counts_[i]++;
+        sum_ += value;
+        count_++;
+    }
+
+    uint64_t count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return count_;
+    }
+
+    // {"buckets": [[le, cumulative_count], ...], "sum": s, "count": n}
+    // The implicit +Inf bucket is `count`.
+    json to_json() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        json buckets = json::array();
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < bounds_.size(); ++i) {
+            cumulative += counts_[i];
+            buckets.push_back(json::array({bounds_[i], cumulative}));
+        }
+        return {{"buckets", buckets}, {"sum", sum_}, {"count", count_}};
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<double> bounds_;
+    std::vector<uint64_t> counts_;  // Non-cumulative; last slot is the +Inf overflow
+    double sum_ = 0.0;
+    uint64_t count_ = 0;
+};
+
+} // namespace lemon
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace lemon {
+
+// llama-server launch settings measured on this host by the autotuner, kept
+// in the `llamacpp_tuning` recipe option keyed by host_fingerprint(). Zero
+// (or -1 for flash_attn) leaves the setting to llama-server's default.
+struct LlamaCppTuning {
+    int threads = 0;
+    int batch_size = 0;
+    int ubatch_size = 0;
+    int parallel = 0;
+    int flash_attn = -1;      // 1 on, 0 off
+    double prefill_tps = 0.0; // Prompt processing, tokens/s
+    double decode_tps = 0.0;  // Generation, tokens/s per sequence
+
+    bool valid() const { return threads > 0; }
+
+    nlohmann::json to_json() const;
+    static LlamaCppTuning from_json(const nlohmann::json& j);
+};
+
+// Prompt and generation lengths of the request the tuner optimizes for.
+// Settings are ranked by the time llama.cpp would take to serve it.
+constexpr int AUTOTUNE_PROMPT_TOKENS = 512;
+constexpr int AUTOTUNE_GEN_TOKENS = 128;
+
+// Seconds to serve the reference request at the given throughputs;
+// infinity when either is unknown
+double reference_request_seconds(double prefill_tps, double decode_tps);
+
+// Parses `llama-bench -o jsonl` output. Each configuration's prompt (n_gen
+// = 0) and generation (n_prompt = 0) rows are merged into one entry, in the
+// order llama-bench ran them. Non-JSON lines (load logs) are skipped.
+std::vector<LlamaCppTuning> parse_llama_bench_jsonl(const std::string& output);
+
+// The entry that serves the reference request fastest, ignoring entries with
+// ubatch_size > batch_size (llama.cpp clamps those to the batch size).
+// Returns an invalid tuning when no entry has both throughputs.
+LlamaCppTuning pick_fastest(const std::vector<LlamaCppTuning>& results);
+
+// One row of `llama-batched-bench --output-format jsonl`
+struct BatchedBenchResult {
+    int parallel = 0;          // Sequences decoded together (pl)
+    double decode_tps = 0.0;   // Aggregate generation tokens/s (speed_tg)
+};
+
+std::vector<BatchedBenchResult> parse_batched_bench_jsonl(const std::string& output);
+
+// Most sequences that can be decoded together while each still gets at least
+// half the single-sequence decode speed; 1 when batching does not pay off.
+int pick_parallel(const std::vector<BatchedBenchResult>& results);
+
+// Thread counts worth trying: half the physical cores, all physical cores
+// and all hardware threads, in increasing order without duplicates
+std::vector<int> autotune_thread_candidates(int cores, int threads);
+
+// Identifies the hardware a tuning was measured on, from the "devices"
+// object of /system-info. GPUs are part of the key only for GPU backends.
+std::string host_fingerprint(const nlohmann::json& devices, const std::string& backend);
+
+// Looks up the tuning for `fingerprint` in a `llamacpp_tuning` option value
+std::optional<LlamaCppTuning> find_tuning(const nlohmann::json& tunings, const std::string& fingerprint);
+
+} // namespace lemon
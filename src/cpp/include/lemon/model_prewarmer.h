@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lemon {
+
+// Pulls model files into the OS page cache while a load is still waiting on
+// eviction, port setup and process spawn, so the backend's mmap of a
+// multi-GB GGUF is served from memory instead of faulting it in from a cold
+// disk in whatever order the loader touches it.
+//
+// Each prewarm hints the kernel (posix_fadvise WILLNEED where available) and
+// then reads the files in large sequential chunks on a few threads. Reads are
+// capped at `max_bytes` so a model larger than RAM does not evict itself
+// while being warmed. A prewarm is keyed by the caller (the router uses the
+// main model path), runs at most once per key at a time, and stops as soon as
+// it is finished or cancelled.
+class ModelPrewarmer {
+public:
+    struct Stats {
+        uint64_t bytes = 0;           // Read into the page cache
+        uint64_t total_bytes = 0;     // Eligible bytes across all files
+        double seconds = 0.0;
+        bool completed = false;       // Every eligible byte was read
+
+        double mb_per_second() const {
+            return seconds > 0.0 ? (static_cast<double>(bytes) / (1024.0 * 1024.0)) / seconds : 0.0;
+        }
+    };
+
+    // max_bytes = 0 caps reads at half of physical memory
+    explicit ModelPrewarmer(int threads = 4,
+                            size_t chunk_bytes = 8 * 1024 * 1024,
+                            uint64_t max_bytes = 0);
+    ~ModelPrewarmer();
+    ModelPrewarmer(const ModelPrewarmer&) = delete;
+    ModelPrewarmer& operator=(const ModelPrewarmer&) = delete;
+
+    // Starts prewarming the regular files among `paths` in the background.
+    // Returns false if a prewarm for `key` is already running or there is
+    // nothing to read.
+    bool start(const std::string& key, const std::vector<std::string>& paths);
+
+    // Stops the prewarm for `key` if it is still running and returns what it
+    // did, or nullopt if there was none.
+    std::optional<Stats> finish(const std::string& key);
+
+    // Stops and discards the prewarm for `key`, if any
+    void cancel(const std::string& key) { finish(key); }
+
+    // Disabled by LEMONADE_MODEL_PREWARM=0
+    static bool enabled();
+
+private:
+    struct Chunk {
+        size_t file;
+        uint64_t offset;
+        uint64_t length;
+    };
+
+    struct Job {
+        std::vector<std::string> files;
+        std::vector<Chunk> chunks;
+        uint64_t total_bytes = 0;
+        std::atomic<size_t> next_chunk{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<bool> cancelled{false};
+        std::atomic<size_t> finished_chunks{0};
+        std::chrono::steady_clock::time_point started;
+        std::atomic<int64_t> elapsed_us{-1};   // Set when the last chunk is read
+        std::vector<std::thread> workers;
+    };
+
+    void read_chunks(Job& job, bool advise);
+
+    int threads_;
+    size_t chunk_bytes_;
+    uint64_t max_bytes_;
+
+    std::mutex mutex_;
+    std::map<std::string, std::shared_ptr<Job>> jobs_;
+};
+
+} // namespace lemon
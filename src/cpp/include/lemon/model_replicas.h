@@ -0,0 +1,74 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lemon {
+
+// Upper bound on the `replicas` recipe option. Each replica is a full backend
+// process with its own copy of the weights, so this is a sanity cap rather
+// than a tuning knob.
+constexpr int MAX_MODEL_REPLICAS = 16;
+
+// Picks the replica that should serve the next request: among live replicas,
+// the one with the fewest outstanding requests, breaking ties by the oldest
+// last access so idle replicas take turns instead of replica 0 absorbing
+// every request. Falls back to the first entry when none is alive, so the
+// caller can report the dead backend.
+//
+// `Server` needs is_backend_alive(), get_active_request_count() and
+// get_last_access_time().
+template <typename Server>
+std::shared_ptr<Server> pick_least_outstanding(const std::vector<std::shared_ptr<Server>>& replicas) {
+    std::shared_ptr<Server> best;
+    int best_outstanding = 0;
+    for (const auto& replica : replicas) {
+        if (!replica->is_backend_alive()) {
+            continue;
+        }
+        const int outstanding = replica->get_active_request_count();
+        if (!best || outstanding < best_outstanding ||
+            (outstanding == best_outstanding &&
+             replica->get_last_access_time() < best->get_last_access_time())) {
+            best = replica;
+            best_outstanding = outstanding;
+        }
+    }
+    if (!best && !replicas.empty()) {
+        return replicas.front();
+    }
+    return best;
+}
+
+// CPU cores assigned to one replica of a model
+struct ReplicaCpuSlice {
+    int first_cpu = 0;
+    int last_cpu = 0;
+    int threads = 0;
+
+    bool valid() const { return threads > 0; }
+    std::string range() const { return std::to_string(first_cpu) + "-" + std::to_string(last_cpu); }
+};
+
+// Splits `cpu_count` logical CPUs into `replica_count` contiguous slices and
+// returns the one for `replica_index`, so replicas of a CPU-bound model do
+// not contend for the same cores. Leftover CPUs go to the lowest indices.
+// Returns an invalid slice when there are fewer CPUs than replicas.
+inline ReplicaCpuSlice replica_cpu_slice(int cpu_count, int replica_index, int replica_count) {
+    ReplicaCpuSlice slice;
+    if (replica_count < 1 || replica_index < 0 || replica_index >= replica_count ||
+        cpu_count < replica_count) {
+        return slice;
+    }
+    const int base = cpu_count / replica_count;
+    const int extra = cpu_count % replica_count;
+    slice.first_cpu = replica_index * base + std::min(replica_index, extra);
+    slice.threads = base + (replica_index < extra ? 1 : 0);
+    slice.last_cpu = slice.first_cpu + slice.threads - 1;
+    return slice;
+}
+
+} // namespace lemon
@@ -9,6 +9,7 @@
 #include "router.h"
 #include "model_manager.h"
 #include "model_types.h"
+#include "sse_transcoder.h"
 
 namespace lemon {
 
@@ -45,25 +46,16 @@ private:
     std::string normalize_model_name(const std::string& name);
     json build_ollama_model_entry(const std::string& id, const ModelInfo& info);
     json convert_openai_chat_to_ollama(const json& openai_response, const std::string& model);
-    json convert_openai_delta_to_ollama(const json& openai_chunk, const std::string& model);
     json convert_ollama_to_openai_chat(const json& ollama_request);
     json convert_ollama_to_openai_completion(const json& ollama_request);
     json convert_anthropic_to_openai_chat(const json& anthropic_request, std::vector<std::string>& warnings);
     json convert_openai_chat_to_anthropic(const json& openai_response, const std::string& model, const std::vector<std::string>& warnings);
-    // Common SSE → NDJSON streaming adapter
-    using ChunkConverter = std::function<json(const json& openai_chunk)>;
-    using DoneBuilder = std::function<json(int prompt_eval_count, int eval_count)>;
+    // Streams an OpenAI SSE response through `transcoder` to the client
     using StreamFn = std::function<void(const std::string& body, httplib::DataSink& sink)>;
-    void stream_sse_to_ndjson(const std::string& openai_body,
-                              httplib::DataSink& client_sink,
-                              ChunkConverter convert_chunk,
-                              DoneBuilder build_done,
-                              StreamFn call_router);
-    void stream_openai_sse_to_anthropic_sse(const std::string& openai_body,
-                                            httplib::DataSink& client_sink,
-                                            const std::string& model,
-                                            const std::vector<std::string>& warnings,
-                                            StreamFn call_router);
+    void stream_transcoded(const std::string& openai_body,
+                           httplib::DataSink& client_sink,
+                           SseTranscoder& transcoder,
+                           StreamFn call_router);
 };
 
 } // namespace lemon
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "peer_routing.h"
+
+namespace lemon {
+
+// The other Lemonade nodes this one can forward requests to. Peers come from
+// the `peers` setting and, when `peer_discovery` is on, from NetworkBeacon
+// broadcasts; a background thread polls each one's /peer/status. A peer that
+// has not answered for a few poll intervals is not offered for routing until
+// it answers again.
+//
+// Anyone on the network can send a beacon, and every peer is sent the API key
+// and forwarded prompts, so beacon peers are ignored unless discovery was
+// explicitly accepted in start().
+class PeerCluster {
+public:
+    PeerCluster();
+    ~PeerCluster();
+
+    PeerCluster(const PeerCluster&) = delete;
+    PeerCluster& operator=(const PeerCluster&) = delete;
+
+    // `api_key` is sent to peers as a bearer token; a cluster shares one key.
+    // Peers known from an earlier start() are forgotten.
+    void start(const std::vector<std::string>& static_peers,
+               const std::string& api_key,
+               bool accept_discovered = false,
+               int poll_interval_ms = 2000);
+    void stop();
+    bool running() const { return running_; }
+
+    // Adds a peer announced by a beacon, if start() accepted discovered peers.
+    // Cheap; called from the beacon thread.
+    void add_discovered(const std::string& url);
+
+    const std::string& node_id() const { return node_id_; }
+
+    // Peers that answered their last poll recently, excluding this node
+    std::vector<PeerStatus> live_peers() const;
+
+    void record_forward(const std::string& peer_url, const std::string& model_name, PeerRoute route);
+
+    // Peers and forward counts, for /metrics
+    nlohmann::json snapshot() const;
+
+private:
+    struct Peer {
+        PeerStatus status;
+        std::chrono::steady_clock::time_point last_ok;
+        bool ever_ok = false;
+        bool self = false;  // The URL turned out to be this node
+    };
+
+    void poll_loop();
+    void poll_peer(const std::string& url);
+
+    const std::string node_id_;
+    std::string api_key_;
+    bool accept_discovered_ = false;
+    std::chrono::milliseconds poll_interval_{2000};
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Peer> peers_;  // Keyed by API base URL
+    std::map<std::tuple<std::string, std::string, std::string>, uint64_t> forwards_;
+
+    std::atomic<bool> running_{false};
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::thread poll_thread_;
+};
+
+} // namespace lemon
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace lemon {
+
+// Set on requests one node forwards to another; a request that carries it is
+// always served where it lands, so forwarding can never loop
+constexpr const char* PEER_FORWARDED_HEADER = "X-Lemonade-Forwarded-By";
+
+// What a Lemonade node reports about itself at GET /api/v1/peer/status
+struct PeerStatus {
+    std::string node_id;                     // Random per process; lets a node skip itself
+    std::string hostname;
+    std::string url;                         // API base, e.g. "http://10.0.0.7:13305/api/v1/"
+    std::vector<std::string> loaded_models;  // Public names of models with a live backend
+    int queue_depth = 0;                     // Requests in flight across all backends
+    int64_t free_vram_bytes = -1;            // -1 when unknown
+    bool has_free_slot = true;               // Can load an LLM without evicting one
+
+    bool has_model(const std::string& model_name) const;
+
+    nlohmann::json to_json() const;
+    static PeerStatus from_json(const nlohmann::json& j);
+};
+
+enum class PeerRoute {
+    Local,      // Serve on this node
+    HotPeer,    // A peer already has the model loaded
+    RoomyPeer   // Loading here would evict a model; a peer has a free slot
+};
+
+const char* peer_route_to_string(PeerRoute route);
+
+struct PeerChoice {
+    PeerRoute route = PeerRoute::Local;
+    int peer = -1;  // Index into the peers given to choose_peer, -1 for Local
+};
+
+// Decides where a request for `model_name` runs:
+//   1. loaded here: Local
+//   2. loaded on a peer: the least busy such peer
+//   3. loading here would evict another model: the peer with a free slot and
+//      the most free VRAM, then the shortest queue
+//   4. otherwise Local; a peer never loads what this node could load for free
+PeerChoice choose_peer(const std::string& model_name,
+                       bool loaded_locally,
+                       bool local_needs_eviction,
+                       const std::vector<PeerStatus>& peers);
+
+// Parses the `peers` setting: comma- or space-separated addresses. "host:port",
+// "http://host:port" and "http://host:port/api/v1/" all become the API base
+// "http://host:port/api/v1/".
+std::vector<std::string> parse_peer_urls(const std::string& setting);
+
+// API base announced by a NetworkBeacon payload, or "" if the payload is not
+// a Lemonade beacon
+std::string peer_url_from_beacon(const std::string& payload);
+
+} // namespace lemon
@@ -1,18 +1,32 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
+#include "backend_metrics_collector.h"
 #include "router.h"
+#include "system_metrics_sampler.h"
 
 namespace lemon {
 
 struct SystemMetrics {
     double cpu_percent = -1.0;
+    double memory_gb = -1.0;
     double gpu_percent = -1.0;
     double vram_gb = -1.0;
     double npu_percent = -1.0;
+    std::vector<BackendProcessSample> backends;
 };
 
-std::string build_prometheus_metrics(Router& router, const SystemMetrics& system_metrics);
+// Fetches a local backend's /metrics over HTTP with short timeouts
+BackendMetricsCollector::Fetcher make_backend_metrics_fetcher();
+
+// Renders Lemonade's /metrics from in-memory state only. `backend_metrics`
+// may be null, in which case backend-native metrics are omitted.
+// `realtime_transcription` is TranscriptionScheduler::get_stats(), or empty
+// without a WebSocket server.
+std::string build_prometheus_metrics(Router& router, const SystemMetrics& system_metrics,
+                                     BackendMetricsCollector* backend_metrics = nullptr,
+                                     const json& realtime_transcription = json::object());
 
 } // namespace lemon
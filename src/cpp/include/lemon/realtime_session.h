@@ -5,10 +5,10 @@
 #include <unordered_map>
 #include <mutex>
 #include <functional>
-#include <future>
 #include <atomic>
 #include <nlohmann/json.hpp>
 #include "streaming_audio_buffer.h"
+#include "transcription_scheduler.h"
 #include "vad.h"
 #include "utils/tcp_jsonl_client.h"
 
@@ -47,9 +47,9 @@ struct RealtimeSession {
     int64_t audio_start_ms = 0;  // Start of current speech segment
     std::atomic<bool> vad_speech_window_open{false};
 
-    // Interim transcription state
+    // Interim transcription state. Overlapping interims are coalesced by the
+    // manager's TranscriptionScheduler.
     int64_t last_interim_transcription_ms = 0;  // When we last fired an interim transcription
-    std::atomic<bool> interim_in_flight{false};  // Guard against overlapping interim requests
 
     // Streaming backend connection (used when backend supports IStreamingTranscriptionServer).
     // streaming_mutex guards streaming_client against concurrent forward/disconnect.
@@ -128,14 +128,19 @@ public:
      */
     bool session_exists(const std::string& session_id) const;
 
+    /**
+     * Transcription scheduler queue depth and latency stats for /metrics.
+     */
+    json get_transcription_stats() const;
+
 private:
     Router* router_;
     std::unordered_map<std::string, std::shared_ptr<RealtimeSession>> sessions_;
     mutable std::mutex sessions_mutex_;
 
-    // Pending transcription futures for clean shutdown
-    std::vector<std::future<void>> pending_transcriptions_;
-    std::mutex transcriptions_mutex_;
+    // Runs buffered transcriptions: finals first, sessions round-robin,
+    // capped at the model's replica count
+    TranscriptionScheduler scheduler_;
 
     // Generate unique session ID
     static std::string generate_session_id();
@@ -144,7 +149,7 @@ private:
     void apply_turn_detection_config(std::shared_ptr<RealtimeSession> session,
                                      const json& turn_detection);
 
-    // Snapshot audio buffer and dispatch transcription to worker thread
+    // Snapshot audio buffer and queue a final transcription
     void transcribe_and_send(std::shared_ptr<RealtimeSession> session);
 
     // Fire an interim (partial) transcription without clearing the buffer
@@ -153,7 +158,7 @@ private:
     // Check whether an interim transcription should fire and trigger it
     void maybe_interim_transcribe(std::shared_ptr<RealtimeSession> session);
 
-    // Run Whisper transcription (executes on worker thread)
+    // Run Whisper transcription (executes on a scheduler worker)
     // When is_interim is true the result is sent as a delta event.
     void transcribe_wav(std::shared_ptr<RealtimeSession> session,
                         std::vector<uint8_t> wav_data, std::string model,
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+
+namespace lemon {
+
+using json = nlohmann::json;
+
+// De-duplicates deterministic chat/completion requests (temperature 0 or a
+// fixed seed). Two independent mechanisms share one key space:
+//
+//   - single-flight: identical requests that are in flight at the same time
+//     share one backend call; followers block until the leader finishes and
+//     receive a copy of its result (non-streaming) or a replay of its SSE
+//     stream (streaming).
+//   - response cache (opt-in): finished responses are kept in an LRU bounded
+//     by bytes and a TTL, so later identical requests skip inference.
+//
+// Keys are built by the Router from the canonical request (object keys are
+// sorted by nlohmann::json) plus the loaded model's checkpoint and recipe
+// options, so changing the model or its launch options never serves stale
+// output. Only successful results are shared or cached.
+class ResponseCache {
+public:
+    ResponseCache() = default;
+
+    // A zero byte budget disables the cache (single-flight is independent).
+    void configure(size_t max_bytes, int ttl_seconds, bool single_flight);
+
+    // temperature == 0 or an integer seed.
+    static bool is_deterministic(const json& request);
+
+    // The canonical text itself is the key (no hashing), so distinct
+    // requests can never collide.
+    static std::string make_key(const std::string& endpoint, const std::string& scope, const json& request);
+
+    // Non-streaming: returns a cached response, joins an identical in-flight
+    // request, or runs `compute` (and caches its result if successful).
+    json run(const std::string& key, const std::function<json()>& compute);
+
+    // Streaming: `produce` must run the request against the client sink while
+    // returning the full SSE text it wrote. Returns the SSE text to replay to
+    // the client instead, or an empty string when `produce` already served
+    // the client itself.
+    std::string run_stream(const std::string& key, const std::function<std::string()>& produce);
+
+    // True when a captured stream ended cleanly and carries no error event.
+    static bool is_complete_stream(const std::string& sse);
+
+    // {"enabled", "hits", "misses", "shared", "entries", "bytes", "evictions", "expired"}
+    // with "hits"/"misses"/"shared" split by {"json", "stream"}.
+    json get_stats() const;
+
+private:
+    struct Entry {
+        std::string key;
+        std::string payload;  // Dumped JSON or raw SSE text
+        std::chrono::steady_clock::time_point expires;
+    };
+
+    struct Flight {
+        bool done = false;
+        bool ok = false;
+        std::string payload;
+        std::exception_ptr error;
+        std::condition_variable cv;
+    };
+
+    struct Counters {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t shared = 0;
+    };
+
+    std::string execute(const std::string& key, bool stream,
+                        const std::function<std::string(bool& ok)>& compute, bool& replay);
+    bool lookup_locked(const std::string& key, std::string& payload);
+    void insert_locked(const std::string& key, const std::string& payload);
+
+    mutable std::mutex mutex_;
+    size_t max_bytes_ = 0;
+    std::chrono::seconds ttl_{300};
+    bool single_flight_ = false;
+
+    std::list<Entry> lru_;  // Front = most recently used
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    size_t bytes_ = 0;
+    std::map<std::string, std::shared_ptr<Flight>> in_flight_;
+
+    Counters json_counters_;
+    Counters stream_counters_;
+    uint64_t evictions_ = 0;
+    uint64_t expired_ = 0;
+};
+
+} // namespace lemon
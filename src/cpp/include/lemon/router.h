@@ -4,15 +4,24 @@
 #include <memory>
 #include <map>
 #include <mutex>
+#include <unordered_map>
 #include <condition_variable>
+#include <deque>
+#include <thread>
 #include <vector>
 #include <optional>
+#include <tuple>
 #include <nlohmann/json.hpp>
 #include <httplib.h>
 #include "wrapped_server.h"
 #include "model_manager.h"
 #include "backend_manager.h"
 #include "runtime_config.h"
+#include "embedding_batcher.h"
+#include "embedding_cache.h"
+#include "response_cache.h"
+#include "model_prewarmer.h"
+#include "gguf_tokenizer.h"
 
 // 5 seconds is generous enough for inference to complete but prevents
 // indefinite blocking if a backend is stuck.
@@ -23,6 +32,7 @@ namespace lemon {
 using json = nlohmann::json;
 
 class CloudProviderRegistry;
+class PeerCluster;
 
 struct ModelTelemetryIdentity {
     std::string model_name;
@@ -59,6 +69,10 @@ public:
     // ownership) — Server owns the registry.
     void set_cloud_registry(CloudProviderRegistry* registry);
 
+    // Wires the peer cluster used by choose_peer(); null disables forwarding.
+    // Pointer (not ownership) — Server owns the cluster.
+    void set_peer_cluster(PeerCluster* peers);
+
     // allow_reload_on_option_change: intended for explicit /load callers only.
     // Auto-load callers (inference-triggered) should leave this false so they
     // don't overturn options set by a prior explicit /load.
@@ -71,11 +85,41 @@ public:
 
     void unload_model(const std::string& model_name = "");  // Empty = unload all
 
+    // Benchmarks llama.cpp launch settings for an unloaded llamacpp model on
+    // this host (see LlamaCppServer::autotune). Each benchmark run waits for,
+    // and holds off, model loads; loads queued behind it go ahead between
+    // runs. Stops early once `cancelled` returns true. Returns
+    // {"fingerprint", "tuning"}.
+    json autotune_model(const ModelInfo& model_info, const std::function<bool()>& cancelled = nullptr);
+
+    // Starts reading a local model's files into the page cache so the
+    // backend's own reads hit memory. Called as soon as a request for an
+    // unloaded model is seen; load_model() collects or cancels it.
+    void prewarm_model(const ModelInfo& model_info);
+
+    // Returns the cloud model that should take a request for `requested_model`
+    // because the local backend is saturated or still loading (see the
+    // cloud_fallback recipe option), or "" to serve it locally. Each spill is
+    // counted for /metrics.
+    std::string choose_spillover(const std::string& requested_model);
+
+    // Returns the API base URL of the peer that should serve a request for
+    // `requested_model` (see choose_peer() in peer_routing.h), or "" to serve
+    // it here. Each forward is counted for /metrics.
+    std::string choose_peer(const std::string& requested_model);
+
+    // This node's loaded models, queue depth and free memory, as served to
+    // peers at /peer/status. Identity fields are left to the caller.
+    json get_peer_status() const;
+
     std::string get_loaded_model() const;
     std::string get_loaded_recipe() const;
 
     json get_all_loaded_models() const;
 
+    // (model name, pid) of every running local backend process; lock-free
+    std::vector<std::pair<std::string, int>> get_backend_pids() const;
+
     json get_max_model_limits() const;
 
     // Get pinned model counts per type
@@ -99,6 +143,10 @@ public:
     // Returns empty string if the backend does not support streaming transcription.
     std::string get_streaming_transcription_address(const std::string& model_name) const;
 
+    // Live replicas serving a model, i.e. how many requests its backends can
+    // decode at once when each handles one at a time. 0 when not loaded.
+    int serving_replica_count(const std::string& model_name) const;
+
     json chat_completion(const json& request);
     json completion(const json& request);
     json embeddings(const json& request);
@@ -130,37 +178,148 @@ public:
 
     void update_prompt_tokens(const std::string& model_name, int prompt_tokens);
 
+    // Applies embedding_cache_mb and embedding_cache_disk_mb. Runs at startup
+    // and when either setting changes.
+    void configure_embedding_cache();
+
     // Test hooks
     void simulate_vram_pressure(double pct);
 
 private:
-    // Multi-model support: Manage multiple WrappedServers
-    std::vector<std::unique_ptr<WrappedServer>> loaded_servers_;
+    // Multi-model support: Manage multiple WrappedServers. Mutated only under
+    // load_mutex_; every change is republished to registry_.
+    std::vector<std::shared_ptr<WrappedServer>> loaded_servers_;
+
+    // Immutable copy of loaded_servers_ for the read path. Request dispatch and
+    // status queries load it atomically instead of taking load_mutex_; each
+    // handle keeps its server alive for as long as a request holds it.
+    struct ServerRegistry {
+        std::vector<std::shared_ptr<WrappedServer>> servers;
+        std::unordered_map<std::string, std::vector<std::shared_ptr<WrappedServer>>> by_name;
+    };
+    std::shared_ptr<const ServerRegistry> registry_ = std::make_shared<const ServerRegistry>();
+    std::shared_ptr<const ServerRegistry> registry_snapshot() const { return std::atomic_load(&registry_); }
+    void publish_registry_locked();
+
+    // Lock-free lookups against the current registry. A model may run several
+    // replicas (the `replicas` recipe option); `lookup_server` picks the live
+    // one with the fewest outstanding requests.
+    std::shared_ptr<WrappedServer> lookup_server(const std::string& canonical_model_name) const;
+    std::shared_ptr<WrappedServer> most_recent_server() const;
+
+    enum class AcquireStatus { Acquired, NotLoaded, BackendDead };
+    // Looks up and claims a server for one request (acquire_for_inference +
+    // update_access_time). Re-resolves if the server was retired between the
+    // lookup and the claim. On BackendDead, `server` is the dead entry.
+    AcquireStatus acquire_server(const std::string& canonical_model_name, std::shared_ptr<WrappedServer>& server);
 
     // Configuration (non-owning pointer; same lifetime as Server)
     RuntimeConfig* config_;
     ModelManager* model_manager_;  // Non-owning pointer to ModelManager
     BackendManager* backend_manager_;  // Non-owning pointer to BackendManager
     CloudProviderRegistry* cloud_registry_ = nullptr;  // Non-owning
+    PeerCluster* peer_cluster_ = nullptr;              // Non-owning
 
     mutable std::mutex telemetry_mutex_;
     Telemetry aggregate_telemetry_;
     std::map<std::string, ModelTelemetryRecord> telemetry_by_model_;
 
     // Concurrency control for load operations
-    mutable std::mutex load_mutex_;              // Protects loading state and loaded_servers_
+    mutable std::mutex load_mutex_;              // Serializes loads/evictions and guards loaded_servers_
     bool is_loading_ = false;                    // True when a load operation is in progress
     std::condition_variable load_cv_;            // Signals when load completes
 
+    // Standby replicas start on their own thread, outside is_loading_
+    struct StandbyJob {
+        std::string model_name;
+        ModelInfo model_info;
+        RecipeOptions options;
+        bool do_not_upgrade = false;
+        bool pinned = false;
+        int replica_count = 1;
+    };
+    std::mutex standby_mutex_;
+    std::condition_variable standby_cv_;
+    std::deque<StandbyJob> standby_jobs_;
+    bool standby_stopping_ = false;
+    std::thread standby_thread_;
+
     std::unique_ptr<GlobalVramMonitor> vram_monitor_;
     std::unique_ptr<EvictionEngine> eviction_engine_;
 
+    // Page-cache prewarm of model files, keyed by the main model path
+    ModelPrewarmer prewarmer_;
+
+    // Spillover state: models with a load in progress or queued, and spill
+    // counts keyed by (model, fallback, reason)
+    class PendingLoad {
+    public:
+        PendingLoad(Router& router, const std::string& model_name);
+        ~PendingLoad();
+    private:
+        Router& router_;
+        std::string model_name_;
+    };
+    mutable std::mutex spillover_mutex_;
+    std::map<std::string, int> pending_loads_;
+    std::map<std::tuple<std::string, std::string, std::string>, uint64_t> spillover_counts_;
+
+    // Non-streaming requests cancelled mid-inference by a client disconnect,
+    // by canonical model name
+    mutable std::mutex cancelled_mutex_;
+    std::map<std::string, uint64_t> cancelled_counts_;
+    void add_estimated_cost(json& model_info, const std::string& model_name, const Telemetry& telemetry) const;
+
+    // Lock-free: true when loading the model here would first evict another
+    // model from its type's slots
+    bool load_would_evict(const ModelInfo& model_info) const;
+    // Free GPU memory reported to peers, re-measured at most every few seconds
+    mutable std::mutex peer_status_mutex_;
+    mutable std::chrono::steady_clock::time_point free_vram_measured_;
+    mutable int64_t free_vram_bytes_ = -1;
+
+    // Coalesces concurrent embeddings/rerank requests (opt-in via
+    // embedding_batch_window_ms).
+    EmbeddingBatcher embedding_batcher_;
+    EmbeddingBatcher::Limits embedding_batch_limits() const;
+
+    // Content-addressed embedding vectors (opt-in via embedding_cache_mb).
+    // Only inputs that miss the cache are sent to the backend.
+    EmbeddingCache embedding_cache_;
+    json embeddings_with_cache(const json& request, const std::string& cache_scope,
+                               const std::vector<json>& items,
+                               const std::function<json(const json&)>& forward);
+
+    // Single-flight + opt-in response cache for deterministic chat/completion
+    // requests (response_cache_mb, response_cache_ttl_seconds,
+    // response_single_flight). Returns "" when the request is not eligible.
+    ResponseCache response_cache_;
+    std::string response_cache_key(const std::string& endpoint, const json& request);
+    void stream_with_response_cache(const std::string& endpoint, const std::string& request_body,
+                                    httplib::DataSink& sink,
+                                    const std::function<void(httplib::DataSink&)>& run);
+
+    // Identifies the loaded model's checkpoint + recipe options for cache keys;
+    // "" when the request's model is not loaded.
+    std::string model_cache_scope(const json& request) const;
+
+    // Vocabularies read from llama.cpp models' GGUF files, for /tokenize and
+    // for rejecting prompts that cannot fit the loaded context before they
+    // take a backend slot. nullptr when the model's vocab is not supported.
+    GgufTokenizerCache tokenizers_;
+    std::shared_ptr<const GgufTokenizer> tokenizer_for(const std::string& canonical_model_name);
+    // context_length_exceeded error when the request's prompt alone fills the
+    // loaded model's ctx_size; null when it fits or cannot be counted here.
+    json check_prompt_fits(const json& request);
+    bool reject_oversized_stream(const std::string& request_body, httplib::DataSink& sink);
+
     // Helper methods for multi-model management
     WrappedServer* find_server_by_model_name(const std::string& model_name) const;
-    WrappedServer* get_most_recent_server() const;
     void prune_unavailable_servers_locked();
     bool reload_model_after_watchdog_reset(const std::string& requested_model, const RecipeOptions& options);
     bool is_watchdog_reset_response(const json& response) const;
+    // Counts a request the backend abandoned because its client disconnected
+    void note_if_cancelled(const json& response, const std::string& model_name);
     int count_servers_by_type(ModelType type) const;
     int count_pinned_servers_by_type(ModelType type) const;
     WrappedServer* find_lru_server_by_type(ModelType type) const;
@@ -171,6 +330,31 @@ private:
     void evict_all_npu_servers();
     void evict_server(WrappedServer* server, int timeout_seconds = -1);
     void evict_all_servers();
+    // Replica management; all require load_mutex_. Eviction, unload and
+    // pinning act on every replica of a model.
+    std::vector<WrappedServer*> find_replicas_locked(const std::string& model_name) const;
+    void evict_model_locked(const std::string& model_name, int timeout_seconds = -1);
+    int resolve_replica_count(const RecipeOptions& options, const ModelInfo& model_info) const;
+    // Queues the start of an already-serving model's replicas that are not
+    // running. Call after the load that made the model serve has cleared
+    // is_loading_, so standbys never hold up other loads.
+    void start_standby_replicas(const std::string& canonical_model_name,
+                                const ModelInfo& model_info,
+                                const RecipeOptions& effective_options,
+                                bool do_not_upgrade,
+                                bool pinned,
+                                int replica_count);
+    void standby_loop();
+    // Evicts dead replicas, then starts the missing ones one at a time.
+    // load_mutex_ is taken only to inspect and publish, never across a start.
+    void run_standby_job(const StandbyJob& job);
+    // Admission for one more replica of `job`'s model: a free slot and room
+    // for its expected size, evicting the least recently used other model of
+    // the type as a primary load would. False when only this model or pinned
+    // ones could be evicted. `available_gb` is measured by the caller outside
+    // the lock (<= 0: unknown); `evicted` is set when a model was evicted and
+    // memory should be measured again. Requires load_mutex_.
+    bool admit_replica_locked(const StandbyJob& job, double available_gb, bool& evicted);
     // Eviction-engine entry point: physically unload a model previously marked
     // EVICTING, but only if it has not been rescued by an in-flight request
     // (see WrappedServer::try_commit_eviction). Safe against request races.
@@ -34,7 +34,17 @@ public:
     int ctx_size() const;
     bool auto_evict() const;
     double auto_evict_threshold_pct() const;
-
+    int embedding_batch_window_ms() const;
+    int embedding_batch_max_size() const;
+    int embedding_batch_max_tokens() const;
+    int embedding_cache_mb() const;
+    int embedding_cache_disk_mb() const;
+    int response_cache_mb() const;
+    int response_cache_ttl_seconds() const;
+    bool response_single_flight() const;
+    bool peer_forwarding() const;
+    std::string peers() const;
+    bool peer_discovery() const;
 
     // Feature flags
     bool offline() const;
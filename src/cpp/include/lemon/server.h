@@ -20,15 +20,19 @@
 #include "model_manager.h"
 #include "backend_manager.h"
 #include "cloud_provider_registry.h"
+#include "peer_cluster.h"
+#include "backends/upscale_worker.h"
 #include "upgradable_http_server.h"
 #include "websocket_server.h"
 #include "lemon/utils/network_beacon.h"
-#include "lemon/system_metrics_platform.h"
+#include "lemon/system_metrics_sampler.h"
+#include "lemon/backend_metrics_collector.h"
 
 namespace lemon {
 
 // Forward declaration
 class SystemMetricsPlatform;
+class StaticAssetCache;
 
 class Server {
 public:
@@ -106,6 +110,8 @@ private:
     void handle_pull(const httplib::Request& req, httplib::Response& res);
     void handle_pull_variants(const httplib::Request& req, httplib::Response& res);
     void handle_load(const httplib::Request& req, httplib::Response& res);
+    void handle_autotune(const httplib::Request& req, httplib::Response& res);
+    void handle_autotune_status(const httplib::Request& req, httplib::Response& res);
     void handle_unload(const httplib::Request& req, httplib::Response& res);
     void handle_pin(const httplib::Request& req, httplib::Response& res);
     void handle_delete(const httplib::Request& req, httplib::Response& res);
@@ -125,9 +131,11 @@ private:
     void handle_cloud_auth_clear(const httplib::Request& req, httplib::Response& res);
     void handle_params(const httplib::Request& req, httplib::Response& res);
     void handle_metrics(const httplib::Request& req, httplib::Response& res);
+    void handle_peer_status(const httplib::Request& req, httplib::Response& res);
     void handle_stats(const httplib::Request& req, httplib::Response& res);
     void handle_system_info(const httplib::Request& req, httplib::Response& res);
     void handle_system_stats(const httplib::Request& req, httplib::Response& res);
+    void handle_system_stats_history(const httplib::Request& req, httplib::Response& res);
     void handle_log_level(const httplib::Request& req, httplib::Response& res);
     void handle_shutdown(const httplib::Request& req, httplib::Response& res);
     void handle_simulate_vram_pressure(const httplib::Request& req, httplib::Response& res);
@@ -187,6 +195,20 @@ private:
     void join_download_job(const std::shared_ptr<DownloadJob>& job);
     void cancel_download_jobs();
 
+    // The autotune sweep takes minutes, so POST /autotune starts it on a worker
+    // and GET /autotune reports on the latest one. One sweep runs at a time.
+    struct AutotuneJob {
+        std::string model_name;
+        bool save = true;
+        std::string status;  // "running", "success" or "error"
+        nlohmann::json result;
+        std::string error;
+    };
+
+    nlohmann::json autotune_job_to_json(const AutotuneJob& job) const;
+    void run_autotune_job(std::shared_ptr<AutotuneJob> job);
+    void cancel_autotune_job();
+
     // Helper function for local model resolution and registration
     void resolve_and_register_local_model(
         const std::string& dest_path,
@@ -217,6 +239,22 @@ private:
     // Helper function for auto-loading models (eliminates code duplication and race conditions)
     void auto_load_model_if_needed(const std::string& model_name);
 
+    // Points the request at its model's cloud fallback when the router
+    // decides to spill it; returns true if the model was rewritten
+    bool apply_spillover(nlohmann::json& request_json);
+
+    // Sends the request to the peer node the router picks for its model and
+    // relays the answer (streamed or not) into `res`. Returns false, leaving
+    // `res` untouched, when the request should be served here.
+    bool forward_to_peer(const httplib::Request& req,
+                         httplib::Response& res,
+                         const nlohmann::json& request_json,
+                         const std::string& endpoint);
+
+    // Starts or stops the peer cluster and beacon listener to match the
+    // peer_forwarding, peers, peer_discovery and no_broadcast settings
+    void update_peer_forwarding();
+
     // Helper: persist the registry's installed-providers list into config.json
     // by overlaying onto the current runtime-config snapshot. Called after
     // install/uninstall. Errors are logged and swallowed — a failure to
@@ -240,11 +278,6 @@ private:
 
     // Helper function to generate detailed model error responses (not found, not supported, load failure)
     nlohmann::json create_model_error(const std::string& requested_model, const std::string& exception_msg);
-    // System stats helper methods
-    double get_cpu_usage();
-    double get_gpu_usage();
-    double get_vram_usage();
-    double get_npu_utilization();
 
     std::shared_ptr<RuntimeConfig> config_;
     std::string cache_dir_;  // Lemonade cache dir for config.json persistence
@@ -266,11 +299,21 @@ private:
     std::unique_ptr<ModelManager> model_manager_;
     std::unique_ptr<BackendManager> backend_manager_;
     std::unique_ptr<CloudProviderRegistry> cloud_registry_;
+    // Declared before udp_beacon_, whose listener feeds it
+    std::unique_ptr<PeerCluster> peer_cluster_;
+    // Primed sd-cli processes for /images/upscale, one per ESRGAN model
+    std::unique_ptr<backends::UpscaleWorkerPool> upscale_workers_;
     std::unique_ptr<WebSocketServer> websocket_server_;
 
     std::mutex downloads_mutex_;
     std::map<std::string, std::shared_ptr<DownloadJob>> download_jobs_;
 
+    // Guards autotune_job_ and the worker handle
+    std::mutex autotune_mutex_;
+    std::shared_ptr<AutotuneJob> autotune_job_;
+    std::thread autotune_worker_;
+    std::atomic<bool> autotune_cancel_{false};
+
     bool running_;
     bool startup_failed_ = false;
     std::atomic<bool> shutdown_requested_{false};
@@ -281,18 +324,14 @@ private:
     std::string admin_api_key_;
     NetworkBeacon udp_beacon_;
 
-    // CPU usage tracking
-#if defined(__linux__) || defined(_WIN32)
-    struct CpuStats {
-        uint64_t total_idle = 0;
-        uint64_t total = 0;
-    };
-    CpuStats last_cpu_stats_;
-    std::mutex cpu_stats_mutex_;
-#endif
+    // Background system metrics sampler; endpoints read its latest sample
+    std::unique_ptr<SystemMetricsSampler> metrics_sampler_;
+
+    // Cached backend-native /metrics, federated into ours
+    std::unique_ptr<BackendMetricsCollector> backend_metrics_;
 
-    // Platform-specific system metrics
-    std::unique_ptr<SystemMetricsPlatform> metrics_platform_;
+    // In-memory web app assets, shared by the IPv4/IPv6 route tables
+    std::shared_ptr<StaticAssetCache> web_app_assets_;
 };
 
 } // namespace lemon
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <nlohmann/json.hpp>
+
+namespace lemon {
+
+// Per-model rule for sending overflow requests from a saturated local model
+// to a cloud model, parsed from the model's recipe options:
+//   cloud_fallback       cloud model that takes the overflow ("" disables)
+//   spill_queue_depth    spill once the least busy replica has this many
+//                        requests in flight (0 disables)
+//   spill_max_wait       spill when the predicted wait, in seconds, exceeds
+//                        this (0 disables)
+//   spill_while_loading  spill while the local backend is still loading
+struct SpilloverPolicy {
+    std::string fallback_model;
+    int max_queue_depth = 0;
+    double max_wait_seconds = 0.0;
+    bool while_loading = true;
+
+    bool enabled() const { return !fallback_model.empty(); }
+
+    static SpilloverPolicy from_recipe_options(const nlohmann::json& recipe_options);
+};
+
+enum class SpillReason {
+    None,           // Serve locally
+    QueueDepth,
+    PredictedWait,
+    Loading
+};
+
+const char* spill_reason_to_string(SpillReason reason);
+
+// What the router knows about the local model when a request arrives
+struct LocalModelLoad {
+    bool loaded = false;                // A live backend is serving the model
+    bool loading = false;               // A load of the model is in progress or queued
+    int outstanding = 0;                // In-flight requests on the least busy replica
+    double mean_request_seconds = 0.0;  // Recent mean request time there, 0 if unknown
+};
+
+// The wait is predicted as outstanding requests times the recent mean request
+// time. A model that is neither loaded nor loading is never spilled: the
+// request that finds it that way starts the load.
+SpillReason decide_spillover(const SpilloverPolicy& policy, const LocalModelLoad& load);
+
+} // namespace lemon
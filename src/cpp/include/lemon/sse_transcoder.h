@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lemon {
+
+// Splits a byte stream into lines without re-copying the unread tail for
+// every line. Views returned by next_line() stay valid until the next append().
+class SseLineFramer {
+public:
+    void append(const char* data, size_t len);
+
+    // Next complete line without its "\n" / "\r\n"; false once only a partial
+    // line is buffered.
+    bool next_line(std::string_view& line);
+
+private:
+    std::string buffer_;
+    size_t read_ = 0;
+};
+
+// The parts of one OpenAI chat/completions stream chunk that the dialect
+// translators use, as raw JSON slices of the chunk text: strings keep their
+// quotes and escapes so they can be pasted into the output unchanged. Empty
+// views mean the field was absent.
+struct OpenAIStreamDelta {
+    struct ToolCall {
+        long index = 0;
+        std::string_view id;
+        std::string_view name;
+        std::string_view arguments;
+    };
+
+    std::string_view id;
+    bool has_choice = false;  // choices[0] exists
+    bool has_delta = false;   // choices[0].delta is an object
+    std::string_view text;    // choices[0].text (completions)
+    std::string_view finish_reason;
+    std::string_view role;
+    std::string_view content;
+    std::string_view reasoning_content;
+    std::string_view tool_calls;  // The whole delta.tool_calls value
+    std::vector<ToolCall> tool_call_deltas;
+    long prompt_tokens = -1;      // usage.*, -1 when absent
+    long completion_tokens = -1;
+
+    void clear();
+};
+
+// Picks the fields above out of one chunk in a single pass without building
+// a DOM. Returns false if the text is not a well-formed JSON object.
+bool scan_openai_stream_chunk(std::string_view chunk, OpenAIStreamDelta& out);
+
+// Translates an OpenAI SSE stream into the Ollama NDJSON or Anthropic SSE
+// dialect. Each upstream chunk is framed, scanned and written out through
+// fixed templates into one reused buffer, so the compatibility endpoints
+// stream without a json::parse/dump round trip per token.
+class SseTranscoder {
+public:
+    enum class Target {
+        OllamaChat,      // /api/chat NDJSON
+        OllamaGenerate,  // /api/generate NDJSON
+        Anthropic        // /v1/messages SSE
+    };
+
+    using Writer = std::function<bool(const char* data, size_t len)>;
+
+    // `warnings` are reported in the Anthropic message_delta event
+    SseTranscoder(Target target, const std::string& model,
+                  std::vector<std::string> warnings = {});
+
+    // Consumes upstream bytes and writes whatever they complete. Returns
+    // false when the writer does.
+    bool feed(const char* data, size_t len, const Writer& write);
+
+    // Writes the closing Ollama "done" line or Anthropic stop events
+    bool finish(const Writer& write);
+
+private:
+    void on_chunk(const OpenAIStreamDelta& chunk);
+    void append_ollama_chat(const OpenAIStreamDelta& chunk);
+    void append_ollama_generate(const OpenAIStreamDelta& chunk);
+    void append_anthropic(const OpenAIStreamDelta& chunk);
+    void append_anthropic_message_start(std::string_view id);
+    void append_event(std::string_view event, std::string_view prefix,
+                      std::string_view value, std::string_view suffix);
+    bool flush(const Writer& write);
+
+    const Target target_;
+    const std::string model_json_;  // Model name as a JSON string
+    const std::vector<std::string> warnings_;
+
+    SseLineFramer framer_;
+    OpenAIStreamDelta chunk_;
+    std::string out_;
+
+    long prompt_tokens_ = 0;
+    long completion_tokens_ = 0;
+
+    // Anthropic block state
+    bool sent_message_start_ = false;
+    bool sent_text_start_ = false;
+    std::vector<bool> started_tools_;
+    std::vector<std::string> tool_ids_;    // JSON strings
+    std::vector<std::string> tool_names_;  // JSON strings
+    std::string_view stop_reason_ = "end_turn";
+};
+
+} // namespace lemon
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace lemon {
+
+class DirectoryWatcher;
+
+// Immutable in-memory snapshot of a static asset directory (the web app).
+// Every file is read once, precompressed (zstd always; brotli and gzip when
+// the build links them) and tagged with a content-hash ETag, so requests are
+// served from memory without touching the disk or compressing on the HTTP
+// worker threads that also carry inference traffic.
+//
+// The constructor only reads the files; a builder thread then compresses
+// them and swaps the result in, so startup is not held up by compression
+// and the first requests are served uncompressed. A DirectoryWatcher wakes
+// the builder when the directory changes. Requests never build a snapshot,
+// and requests holding an old one finish undisturbed.
+class StaticAssetCache {
+public:
+    struct Asset {
+        std::string content_type;
+        std::string etag;         // Strong ETag of the identity body, quoted
+        bool immutable = false;   // Content-hashed filename: cache forever
+        std::string identity;
+        std::string br;           // Empty when not worth (or unable) to compress
+        std::string zstd;
+        std::string gzip;
+    };
+
+    using Table = std::unordered_map<std::string, Asset>;
+
+    explicit StaticAssetCache(const std::string& root_dir);
+    ~StaticAssetCache();
+
+    // Looks up `relative_path` (as requested by the client) in the current
+    // snapshot. Returns nullptr for unknown files and for paths that try to
+    // leave the root. The returned pointer stays valid while `holder` lives.
+    const Asset* find(const std::string& relative_path, std::shared_ptr<const Table>& holder);
+
+    // Picks the best encoding the client accepts ("br", "zstd", "gzip" or ""
+    // for identity) and returns the matching body.
+    static const std::string& select_encoding(const Asset& asset, const std::string& accept_encoding,
+                                              std::string& encoding);
+
+    // ETag of one representation: encodings get a suffixed variant so
+    // caches never mix up compressed and identity bodies.
+    static std::string etag_for(const Asset& asset, const std::string& encoding);
+
+    // True if an If-None-Match header value matches the asset's ETag
+    // (including its per-encoding variants and "*").
+    static bool etag_matches(const Asset& asset, const std::string& if_none_match);
+
+    // Filenames carrying webpack's content hash: a dot-separated stem segment
+    // of 20 lowercase hex digits, as in "[hash][ext]" asset names
+    // ("3f2a9c1b0d4e5f6a7b8c.svg") or "[name].[contenthash].js".
+    static bool is_hashed_filename(const std::string& path);
+
+    static std::string content_type_for(const std::string& path);
+
+private:
+    std::shared_ptr<const Table> load(bool compress) const;
+    void run_builder();
+
+    std::string root_dir_;
+    std::mutex mutex_;
+    std::condition_variable builder_cv_;
+    std::shared_ptr<const Table> table_;
+    bool stale_ = true;      // Guarded by mutex_
+    bool stopping_ = false;  // Guarded by mutex_
+    std::thread builder_;
+    std::unique_ptr<DirectoryWatcher> watcher_;
+};
+
+} // namespace lemon
@@ -6,6 +6,12 @@
 
 namespace lemon {
 
+// Cumulative CPU time and resident memory of one process
+struct ProcessUsage {
+    uint64_t cpu_time_ns = 0;
+    uint64_t rss_bytes = 0;
+};
+
 // Platform-specific system metrics collection
 class SystemMetricsPlatform {
 public:
@@ -31,6 +37,13 @@ public:
 
     // NPU utilization percentage (0-100), -1 if not available or unsupported
     virtual double get_npu_utilization() = 0;
+
+    // Usage of another process (e.g. a backend server), false if not available
+    virtual bool get_process_usage(int pid, ProcessUsage& usage) {
+        (void)pid;
+        (void)usage;
+        return false;
+    }
 };
 
 // Factory function to create platform-specific implementation
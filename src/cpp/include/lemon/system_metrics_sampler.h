@@ -0,0 +1,104 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "lemon/system_metrics_platform.h"
+
+namespace lemon {
+
+// Resource usage of one backend process at sample time
+struct BackendProcessSample {
+    std::string model_name;
+    int pid = 0;
+    double cpu_percent = -1.0;  // Percent of one core since the previous sample
+    double rss_gb = -1.0;
+};
+
+// One point in time. Negative values mean "not available on this platform".
+struct SystemMetricsSample {
+    int64_t timestamp_ms = 0;   // Unix epoch milliseconds
+    double cpu_percent = -1.0;
+    double memory_gb = -1.0;
+    double gpu_percent = -1.0;
+    double vram_gb = -1.0;
+    double npu_percent = -1.0;
+    std::vector<BackendProcessSample> backends;
+
+    nlohmann::json to_json() const;
+};
+
+// Samples system and backend-process metrics on a single background thread at
+// a fixed cadence and keeps the most recent samples in a fixed-size ring
+// buffer. Endpoints read the latest sample without touching /proc, sysfs or
+// driver ioctls, and dashboards can fetch the history as a time series.
+class SystemMetricsSampler {
+public:
+    // Returns (model name, pid) for every running backend process
+    using BackendProvider = std::function<std::vector<std::pair<std::string, int>>()>;
+
+    SystemMetricsSampler(std::unique_ptr<SystemMetricsPlatform> platform,
+                         int interval_ms = 1000, size_t capacity = 600);
+    ~SystemMetricsSampler();
+
+    void set_backend_provider(BackendProvider provider);
+
+    // Takes a first sample synchronously so readers never see an empty
+    // buffer, then keeps sampling in the background until stop().
+    void start();
+    void stop();
+
+    // Takes one sample immediately and appends it to the history
+    void sample_now();
+
+    SystemMetricsSample latest() const;
+
+    // Samples newer than `since_ms` (epoch milliseconds), oldest first
+    std::vector<SystemMetricsSample> history(int64_t since_ms = 0) const;
+
+    int interval_ms() const { return interval_ms_; }
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct ProcessCpuState {
+        uint64_t cpu_time_ns = 0;
+        std::chrono::steady_clock::time_point taken;
+    };
+
+    void sampling_loop();
+    SystemMetricsSample collect();
+
+    std::unique_ptr<SystemMetricsPlatform> platform_;
+    const int interval_ms_;
+    const size_t capacity_;
+
+    BackendProvider backend_provider_;
+
+    // Delta state, only touched from collect() (serialized by collect_mutex_)
+    std::mutex collect_mutex_;
+    std::mutex cpu_state_mutex_;
+    uint64_t last_cpu_total_ = 0;
+    uint64_t last_cpu_idle_ = 0;
+    std::unordered_map<int, ProcessCpuState> last_process_cpu_;
+
+    mutable std::mutex samples_mutex_;
+    std::deque<SystemMetricsSample> samples_;
+
+    std::mutex run_mutex_;
+    std::condition_variable run_cv_;
+    bool running_ = false;
+    std::thread thread_;
+};
+
+} // namespace lemon
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "histogram.h"
+
+namespace lemon {
+
+using json = nlohmann::json;
+
+// Central queue for the buffered (non-streaming) transcriptions of realtime
+// sessions. A fixed pool of workers runs jobs in this order:
+//
+//   - finals before interims, since a final is what the client commits;
+//   - sessions round-robin within each class, so one chatty session cannot
+//     starve the others;
+//   - at most one job per session at a time, which keeps a session's results
+//     in order;
+//   - at most `capacity(model)` jobs per model at a time, because whisper.cpp
+//     and moonshine servers decode one request at a time and extra
+//     concurrency only queues up inside the backend.
+//
+// A session has at most one queued interim. A newer interim replaces it, and
+// a final drops it, because its audio is a prefix of the newer snapshot.
+class TranscriptionScheduler {
+public:
+    enum class Kind { Final, Interim };
+
+    // How many requests a model's backend can run at once. Called with the
+    // scheduler's lock held; must not call back into the scheduler.
+    using CapacityFn = std::function<int(const std::string& model)>;
+    using Job = std::function<void()>;
+
+    // A null `capacity` allows one request per model
+    explicit TranscriptionScheduler(CapacityFn capacity = nullptr, int workers = 4);
+    ~TranscriptionScheduler();
+
+    TranscriptionScheduler(const TranscriptionScheduler&) = delete;
+    TranscriptionScheduler& operator=(const TranscriptionScheduler&) = delete;
+
+    // Queues `job` for `session_id` against `model`. Returns false once the
+    // scheduler is shutting down; the job is not run.
+    bool submit(const std::string& session_id, const std::string& model, Kind kind, Job job);
+
+    // Drops a closed session's queued jobs and latency stats. A running job
+    // finishes.
+    void close_session(const std::string& session_id);
+
+    // Drops queued interims, runs the queued finals and joins the workers
+    void shutdown();
+
+    // Queue depth, coalesced/completed counters, queue-wait and end-to-end
+    // latency histograms by kind, and per-session latency for open sessions.
+    json get_stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Pending {
+        std::string model;
+        Job job;
+        Clock::time_point queued;
+    };
+
+    struct SessionQueue {
+        std::deque<Pending> finals;
+        std::unique_ptr<Pending> interim;
+        bool running = false;
+    };
+
+    struct SessionLatency {
+        uint64_t finals = 0;
+        uint64_t interims = 0;
+        double final_seconds_sum = 0.0;
+        double interim_seconds_sum = 0.0;
+        double final_seconds_max = 0.0;
+        double last_final_seconds = 0.0;
+    };
+
+    struct KindStats {
+        KindStats();
+        Histogram queue_wait_seconds;
+        Histogram latency_seconds;
+        uint64_t submitted_total = 0;
+        uint64_t completed_total = 0;
+        uint64_t dropped_total = 0;  // Coalesced, superseded or cancelled
+    };
+
+    void worker_loop();
+    // Takes the next runnable job under the lock, or returns false
+    bool take_next(std::string& session_id, Kind& kind, Pending& pending);
+    bool model_has_capacity(const std::string& model) const;
+    KindStats& stats_for(Kind kind) { return kind == Kind::Final ? final_stats_ : interim_stats_; }
+    const KindStats& stats_for(Kind kind) const { return kind == Kind::Final ? final_stats_ : interim_stats_; }
+
+    CapacityFn capacity_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::map<std::string, SessionQueue> queues_;
+    std::deque<std::string> round_robin_;     // Sessions in service order
+    std::map<std::string, int> in_flight_;    // By model
+    std::map<std::string, SessionLatency> session_latency_;
+    KindStats final_stats_;
+    KindStats interim_stats_;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace lemon
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <map>
 #include <vector>
@@ -9,6 +10,7 @@
 #include <iostream>
 #include <iomanip>
 #include <atomic>
+#include <stdexcept>
 
 namespace lemon {
 namespace utils {
@@ -50,6 +52,7 @@ struct DownloadResult {
 // Progress callback returns bool: true = continue, false = cancel download
 using ProgressCallback = std::function<bool(size_t downloaded, size_t total)>;
 using StreamCallback = std::function<bool(const char* data, size_t length)>;
+using DataCallback = std::function<void(const char* data, size_t length, uint64_t offset)>;
 
 // Download configuration options
 struct DownloadOptions {
@@ -68,6 +71,41 @@ struct DownloadOptions {
     // for non-LFS file ETags. SHA256 is used for LFS objects and release assets.
     std::string expected_hash;
     std::string expected_hash_algorithm;
+
+    // Optional tee of the body bytes as they are written, with their offset
+    // in the output file (non-zero from the start when resuming)
+    DataCallback on_data;
+};
+
+// Thrown by post() and post_multipart() when the calling thread's
+// CancelScope asked for the transfer to stop
+class RequestCancelledError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Lets a request handler abort the blocking backend calls it makes on its own
+// thread, e.g. once its client has hung up. While a scope is active, post()
+// and post_multipart() poll `cancelled` (libcurl calls back at least once a
+// second) and drop the backend connection when it returns true; llama-server
+// and most OpenAI-compatible servers stop generating for a closed connection.
+// Scopes nest; the enclosing one is restored on destruction.
+class CancelScope {
+public:
+    explicit CancelScope(std::function<bool()> cancelled);
+    ~CancelScope();
+
+    CancelScope(const CancelScope&) = delete;
+    CancelScope& operator=(const CancelScope&) = delete;
+
+    // Whether a scope is active on this thread
+    static bool active();
+    // Whether the innermost scope on this thread reports cancellation
+    static bool requested();
+
+private:
+    std::function<bool()> cancelled_;
+    CancelScope* previous_;
 };
 
 class HttpClient {
@@ -113,6 +151,14 @@ public:
     // Check if URL is reachable
     static bool is_reachable(const std::string& url, int timeout_seconds = 5);
 
+    // Sends requests for URLs whose authority (host[:port]) is `authority`
+    // over the Unix domain socket at `socket_path` instead of TCP. An empty
+    // path removes the route. Used for local backends; downloads ignore it.
+    static void set_unix_socket_route(const std::string& authority, const std::string& socket_path);
+
+    // The socket a URL is routed over, or "" for plain TCP
+    static std::string unix_socket_for(const std::string& url);
+
 private:
     static std::atomic<long> default_timeout_seconds_;
 
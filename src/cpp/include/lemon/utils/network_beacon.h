@@ -3,6 +3,7 @@
 
 #include <atomic>
 #include <cstdint>
+#include <functional>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -34,6 +35,10 @@ public:
     void startBroadcasting(int beaconPort, int serverPort, uint16_t intervalSeconds);
     void stopBroadcasting();
 
+    // Peer: calls onPayload with every beacon received on beaconPort
+    void startListening(int beaconPort, std::function<void(const std::string&)> onPayload);
+    void stopListening();
+
 private:
     std::mutex _netMtx;
     std::thread _netThread;
@@ -47,6 +52,11 @@ private:
     void cleanup();
     void createSocket();
     void broadcastThreadLoop();
+
+    std::thread _listenThread;
+    std::atomic<bool> _listenThreadRunning = false;
+    SOCKET _listenSocket;
+    void listenThreadLoop(std::function<void(const std::string&)> onPayload);
 };
 
 #endif
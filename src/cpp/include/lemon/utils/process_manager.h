@@ -12,9 +12,24 @@ struct ProcessHandle {
     int pid;
 };
 
+// CPUs and preferred NUMA node a child process is confined to from its
+// start (sched_setaffinity and set_mempolicy in the child). Empty means no
+// restriction. Applied on Linux only; other platforms start the process
+// unconfined.
+struct CpuPlacement {
+    std::vector<int> cpus;    // Logical CPUs, SMT siblings included
+    int physical_cores = 0;   // Cores behind `cpus`, for sizing thread pools
+    int numa_node = -1;       // -1 leaves memory placement to the kernel
+
+    bool empty() const { return cpus.empty(); }
+};
+
 // Returns true to continue, false to kill the process
 using OutputLineCallback = std::function<bool(const std::string& line)>;
 
+// Sees every line a captured backend process writes to stdout/stderr
+using OutputObserver = std::function<void(const std::string& line)>;
+
 class ProcessManager {
 public:
     static ProcessHandle start_process(
@@ -23,7 +38,8 @@ public:
         const std::string& working_dir = "",
         bool inherit_output = false,
         bool filter_health_logs = false,
-        const std::vector<std::pair<std::string, std::string>>& env_vars = {});
+        const std::vector<std::pair<std::string, std::string>>& env_vars = {},
+        const CpuPlacement& placement = {});
 
     // Blocks until process exits or callback returns false (which kills the process)
     // Returns exit code, or -1 if killed by callback
@@ -64,6 +80,20 @@ public:
     static int run_command(const std::string& command, std::string& output, int timeout_seconds = 30);
 
     static int find_free_port(int start_port = 8001);
+
+    // Whether something accepts TCP connections on 127.0.0.1:`port`. Cheaper
+    // than an HTTP probe; used to notice a backend's listening socket early.
+    static bool is_port_listening(int port);
+
+    // Same for a backend listening on a Unix domain socket
+    static bool is_unix_socket_listening(const std::string& path);
+
+    // Observe the output lines of a process started with filter_health_logs.
+    // One observer per PID; clear it before the PID can be reused.
+    static void set_output_observer(int pid, OutputObserver observer);
+    static void clear_output_observer(int pid);
+    // Called by the platform layer for every captured line
+    static void notify_output_line(int pid, const std::string& line);
 };
 
 } // namespace utils
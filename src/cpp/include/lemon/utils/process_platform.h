@@ -21,6 +21,20 @@ public:
         bool filter_health_logs,
         const std::vector<std::pair<std::string, std::string>>& env_vars) = 0;
 
+    // spawn() with the child confined to `placement`. The default ignores
+    // the placement, so platforms without CPU affinity support need nothing.
+    virtual ProcessHandle spawn_placed(
+        const std::string& executable,
+        const std::vector<std::string>& args,
+        const std::string& working_dir,
+        bool inherit_output,
+        bool filter_health_logs,
+        const std::vector<std::pair<std::string, std::string>>& env_vars,
+        const CpuPlacement& placement) {
+        (void)placement;
+        return spawn(executable, args, working_dir, inherit_output, filter_health_logs, env_vars);
+    }
+
     virtual void terminate(ProcessHandle handle) = 0;
     virtual bool is_running(ProcessHandle handle) = 0;
     virtual int get_exit_code(ProcessHandle handle) = 0;
@@ -47,6 +61,8 @@ public:
 
     // Utility functions
     virtual int find_free_port(int start_port) = 0;
+    virtual bool is_port_listening(int port) = 0;
+    virtual bool is_unix_socket_listening(const std::string& path) = 0;
     virtual int run_command(const std::string& command, std::string& output, int timeout_seconds) = 0;
 };
 
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace lemon {
+namespace utils {
+
+// Single supervision thread for every backend process. Instead of two output
+// filter threads and a watchdog thread per backend, one reactor multiplexes:
+//   - backend stdout/stderr pipes, split into lines (Linux, epoll)
+//   - process exits, reported as soon as they happen via pidfd_open (Linux);
+//     elsewhere, or on kernels without pidfds, by polling on the timer wheel
+//   - timers on a hashed timing wheel, used to pace watchdog health checks
+//
+// Reactor callbacks run on the reactor thread and must not block. Blocking
+// work (HTTP health probes, terminating a hung backend) is handed to post(),
+// which runs it on a small pool of worker threads. Jobs of one owner run one
+// at a time, so a hung backend ties up a single worker and never stalls
+// another backend's probes, output or exit handling.
+class ProcessReactor {
+public:
+    using Id = uint64_t;
+    using LineCallback = std::function<void(const std::string& line)>;
+
+    // Process-wide instance, started on first use
+    static ProcessReactor& instance();
+
+    ProcessReactor();
+    ~ProcessReactor();
+    ProcessReactor(const ProcessReactor&) = delete;
+    ProcessReactor& operator=(const ProcessReactor&) = delete;
+
+    // Whether watch_output() is supported (Linux with epoll)
+    bool supports_pipes() const { return epoll_fd_ >= 0; }
+
+    // Reads `fd` until EOF, calling `on_line` for every line (without the
+    // trailing newline; a final unterminated line is delivered at EOF). The
+    // reactor takes ownership of the descriptor and closes it at EOF.
+    // Returns false if the fd cannot be watched; ownership stays with the caller.
+    bool watch_output(int fd, LineCallback on_line);
+
+    // Calls `on_exit` once, when process `pid` exits. `is_running` is the
+    // fallback liveness check used where pidfds are unavailable; it must be
+    // cheap and non-reaping (see ProcessManager::is_running).
+    Id watch_exit(int pid, std::function<bool()> is_running, std::function<void()> on_exit);
+
+    // Runs `callback` after `delay`, and then every `delay` if `periodic`
+    Id add_timer(std::chrono::milliseconds delay, std::function<void()> callback, bool periodic = false);
+
+    // Cancels an exit watch or timer. When called from another thread while
+    // the callback is running, waits for it to return, so the caller may
+    // destroy whatever the callback captured afterwards.
+    void cancel(Id id);
+
+    // Runs blocking work off the reactor thread. Jobs posted with the same
+    // `owner` run one at a time in submission order; jobs of different owners
+    // run concurrently on up to kMaxWorkers threads.
+    void post(const void* owner, std::function<void()> job);
+    void post(std::function<void()> job) { post(nullptr, std::move(job)); }
+
+    // Timing wheel resolution
+    static constexpr std::chrono::milliseconds kTick{50};
+    // Exit polling cadence where pidfds are unavailable
+    static constexpr std::chrono::milliseconds kExitPollInterval{1000};
+    // Worker threads are started on demand, up to this many
+    static constexpr size_t kMaxWorkers = 8;
+
+private:
+    static constexpr size_t kWheelSlots = 256;
+
+    struct Callback {
+        Id id;
+        std::function<void()> fn;
+        bool one_shot;
+    };
+
+    struct Timer {
+        std::function<void()> callback;
+        int64_t interval_ticks = 0;  // 0 for one-shot timers
+        int64_t rounds = 0;          // Full wheel turns left before firing
+    };
+
+    struct ExitWatch {
+        int pid = 0;
+        int pidfd = -1;              // -1: polled from the timer wheel
+        std::function<bool()> is_running;
+        std::function<void()> on_exit;
+    };
+
+    struct OutputWatch {
+        LineCallback on_line;
+        std::string buffer;
+    };
+
+    struct Job {
+        const void* owner;
+        std::function<void()> fn;
+    };
+
+    void reactor_loop();
+    void worker_loop();
+    void wake();
+
+    // All require mutex_
+    void schedule_locked(Id id, Timer timer, int64_t delay_ticks);
+    int next_timeout_ms_locked() const;
+    void collect_due_timers_locked(std::vector<Callback>& due);
+    void remove_exit_locked(Id id);
+
+    void poll_exits(std::vector<Callback>& due);
+    void run_callbacks(std::vector<Callback>& callbacks);
+    void drain_output(int fd);
+
+    std::mutex mutex_;
+    std::condition_variable callback_done_cv_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<Id> next_id_{1};
+    std::unordered_set<Id> live_;   // Registered timers and exit watches
+    Id running_callback_ = 0;
+    std::thread::id reactor_thread_id_;
+
+    // Hashed timing wheel: a timer `delay` ticks away lands in slot
+    // (current + delay) % kWheelSlots with delay / kWheelSlots rounds to go.
+    std::vector<std::unordered_map<Id, Timer>> wheel_;
+    std::unordered_map<Id, size_t> timer_slots_;
+    size_t current_slot_ = 0;
+    std::chrono::steady_clock::time_point last_tick_;
+
+    std::unordered_map<Id, ExitWatch> exits_;
+    std::unordered_map<int, Id> exits_by_pidfd_;
+    size_t polled_exits_ = 0;
+    std::chrono::steady_clock::time_point next_exit_poll_;
+    std::unordered_map<int, OutputWatch> outputs_;
+
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+    std::condition_variable wake_cv_;   // Used instead of epoll where unavailable
+    bool wake_pending_ = false;
+
+    std::mutex jobs_mutex_;
+    std::condition_variable jobs_cv_;
+    std::deque<Job> jobs_;
+    std::unordered_set<const void*> busy_owners_;  // Owners with a job running
+    size_t idle_workers_ = 0;
+    std::vector<std::thread> workers_;
+
+    std::thread reactor_thread_;
+};
+
+} // namespace utils
+} // namespace lemon
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace lemon::utils {
+
+// Extracts a .tar.gz, .tar.xz or .zip archive from its bytes while they are
+// being downloaded, so a backend install takes about as long as the download
+// alone instead of download + re-read + an external tar/unzip process.
+//
+// Bytes must arrive in file order. A gap or overlap (a download restarted from
+// scratch, or resumed from a partial file this process never saw) abandons
+// the extraction; finish() then returns false and the caller extracts the
+// finished file the old way. Tarballs drop their top-level directory like
+// `tar --strip-components=1`; zip entries are extracted as stored, matching
+// ArchivePlatform.
+class StreamExtractor {
+public:
+    // Returns null when `archive_name` is not a supported format, its
+    // decompressor was not compiled in, or LEMONADE_STREAM_EXTRACT=0
+    static std::unique_ptr<StreamExtractor> create(const std::string& archive_name,
+                                                   const std::string& dest_dir);
+
+    ~StreamExtractor();
+
+    StreamExtractor(const StreamExtractor&) = delete;
+    StreamExtractor& operator=(const StreamExtractor&) = delete;
+
+    // `offset` is where `data` starts in the archive file
+    void feed(const char* data, size_t length, uint64_t offset);
+
+    // True when exactly `archive_size` bytes were fed and the archive ended
+    // cleanly, i.e. dest_dir holds the complete extraction
+    bool finish(uint64_t archive_size);
+
+    // Why extraction was abandoned; empty while it is healthy
+    const std::string& error() const;
+
+    // Files, directories and links written so far
+    uint64_t entries() const;
+
+    struct Impl;
+
+private:
+    explicit StreamExtractor(std::unique_ptr<Impl> impl);
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace lemon::utils
@@ -73,6 +73,11 @@ public:
      */
     bool adopt_socket(intptr_t fd);
 
+    /**
+     * Realtime transcription scheduler stats for /metrics.
+     */
+    nlohmann::json get_realtime_transcription_stats() const;
+
     // libwebsockets callback (public — referenced by file-scope protocols array)
     static int ws_callback(struct lws* wsi, enum lws_callback_reasons reason,
                            void* user, void* in, size_t len);
@@ -13,10 +13,12 @@
 #include <httplib.h>
 #include "utils/process_manager.h"
 #include "utils/http_client.h"
+#include "utils/process_reactor.h"
 #include "server_capabilities.h"
 #include "model_manager.h"
 #include "backend_manager.h"
 #include "recipe_options.h"
+#include "eviction_engine.h"
 
 namespace lemon {
 
@@ -68,6 +70,41 @@ struct Telemetry {
     }
 };
 
+// Where the time of the last backend load went. Phases are -1 until seen.
+struct BackendLoadTiming {
+    long total_ms = -1;    // Whole load(), as measured by the router
+    long spawn_ms = -1;    // Load start until the backend process was spawned
+    long listen_ms = -1;   // Spawn until the backend port accepted connections
+    long ready_ms = -1;    // Spawn until the health endpoint answered
+    std::string ready_signal;  // "output": woken by a readiness log line; "poll"
+
+    // Page-cache prewarm of the model files that overlapped the load
+    long prewarm_ms = -1;
+    uint64_t prewarm_bytes = 0;
+    double prewarm_mb_per_second = 0.0;
+    bool prewarm_completed = false;
+
+    json to_json() const {
+        auto ms_or_null = [](long ms) { return ms < 0 ? json(nullptr) : json(ms); };
+        json result = {
+            {"total_ms", ms_or_null(total_ms)},
+            {"spawn_ms", ms_or_null(spawn_ms)},
+            {"listen_ms", ms_or_null(listen_ms)},
+            {"ready_ms", ms_or_null(ready_ms)}
+        };
+        if (!ready_signal.empty()) {
+            result["ready_signal"] = ready_signal;
+        }
+        if (prewarm_ms >= 0) {
+            result["prewarm_ms"] = prewarm_ms;
+            result["prewarm_bytes"] = prewarm_bytes;
+            result["prewarm_mb_per_second"] = prewarm_mb_per_second;
+            result["prewarm_completed"] = prewarm_completed;
+        }
+        return result;
+    }
+};
+
 class WrappedServer : public ICompletionServer {
 public:
     WrappedServer(const std::string& server_name, const std::string& log_level,
@@ -91,6 +128,14 @@ public:
     // Multi-model support: Track last access time (for LRU eviction)
     void update_access_time() {
         last_access_time_ = std::chrono::steady_clock::now();
+        notify_activity();
+    }
+
+    // Notified on access and when the last in-flight request finishes, so the
+    // eviction engine can (re-)arm this server's idle deadline. Set by the
+    // router before the server is published.
+    void set_activity_listener(std::function<void(const WrappedServer*)> listener) {
+        activity_listener_ = std::move(listener);
     }
 
     std::chrono::steady_clock::time_point get_last_access_time() const {
@@ -117,10 +162,64 @@ public:
         return load_duration_ms_;
     }
 
+    // Called by the router right before load(); spawn and readiness phases
+    // are stamped relative to it.
+    void begin_load_timing();
+    BackendLoadTiming get_load_timing() const;
+    void set_prewarm_timing(long ms, uint64_t bytes, double mb_per_second, bool completed);
+
     // Pinned status for eviction prevention
     bool is_pinned() const { return pinned_; }
     void set_pinned(bool pinned) { pinned_ = pinned; }
 
+    // Position of this backend among the replicas of its model. Set by the
+    // router before load() so backends can split CPU cores between replicas.
+    void set_replica(int index, int count) {
+        replica_index_ = index;
+        replica_count_ = count;
+    }
+    int get_replica_index() const { return replica_index_; }
+    int get_replica_count() const { return replica_count_; }
+
+    // Cores and NUMA node the backend process was started on (see
+    // reserve_cpu_placement); empty when it runs unplaced
+    utils::CpuPlacement get_cpu_placement() const;
+
+    // Expected resident size of the model, used to size the memory limits of
+    // the backend's cgroup. Set by the router before load(); 0 = unknown.
+    void set_expected_memory_gb(double gb) { expected_memory_gb_ = gb; }
+
+    // Interactive models (chat, speech) keep their memory and CPU share under
+    // pressure; batch models (embeddings, reranking, images) yield first.
+    // The `priority` recipe option overrides the model type's default.
+    bool is_interactive() const;
+
+    // Memory charged to the backend's cgroup (memory.current), -1 when the
+    // backend does not run in its own cgroup
+    int64_t get_memory_bytes() const;
+
+    // The backend's cgroup directory, "" when it has none
+    std::string get_cgroup_leaf() const;
+
+    // Requests currently holding this server (see acquire_for_inference)
+    int get_active_request_count() const {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        return active_request_count_;
+    }
+
+    // Moving average of how long requests on this server take, used to
+    // predict queueing delay for spillover. 0 until a request has finished.
+    void note_request_duration(double seconds) {
+        double mean = mean_request_seconds_.load(std::memory_order_relaxed);
+        double next;
+        do {
+            next = mean > 0.0 ? mean + 0.2 * (seconds - mean) : seconds;
+        } while (!mean_request_seconds_.compare_exchange_weak(mean, next, std::memory_order_relaxed));
+    }
+    double get_mean_request_seconds() const {
+        return mean_request_seconds_.load(std::memory_order_relaxed);
+    }
+
     // Acquire model for inference, safely recovering from DOWNSIZING/EVICTING if necessary.
     // Blocks if LOADING.
     //
@@ -169,6 +268,22 @@ public:
         return true;
     }
 
+    // Called by the eviction engine to atomically claim an idle model for
+    // eviction. Returns true only if the model is READY or DOWNSIZED, has no
+    // request in flight and no maintenance running, transitioning it to
+    // EVICTING. A model that is LOADING, IN_USE, mid-downsize or already
+    // claimed is left alone.
+    bool try_begin_eviction() {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        if ((state_ == ModelState::READY || state_ == ModelState::DOWNSIZED) &&
+            active_request_count_ == 0 && !maintenance_in_progress_) {
+            state_ = ModelState::EVICTING;
+            state_cv_.notify_all();
+            return true;
+        }
+        return false;
+    }
+
     // Called by the eviction engine (under the router lock) to atomically decide
     // whether a model marked EVICTING may actually be unloaded. Returns true only
     // if the model is still idle and EVICTING (commit -> transition to UNLOADED so
@@ -190,20 +305,26 @@ public:
     }
 
     void release_inference() {
-        std::lock_guard<std::mutex> lock(state_mutex_);
-        if (--active_request_count_ == 0) {
-            state_ = ModelState::READY;
-            state_cv_.notify_all();
+        bool idle = false;
+        {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            if (--active_request_count_ == 0) {
+                state_ = ModelState::READY;
+                state_cv_.notify_all();
+                idle = true;
+            }
+        }
+        if (idle) {
+            notify_activity();
         }
     }
 
     // Called by the eviction engine (under the router lock) to atomically claim an
     // idle model for a maintenance downsize. Returns true only if the model is
     // currently READY and idle, transitioning it to DOWNSIZING and marking
-    // maintenance in progress so wait_until_not_busy() — and therefore
-    // evict_server() — blocks until the matching finish_downsize() runs. This is
-    // what keeps the server alive while the engine performs downsize() outside the
-    // router lock with only a raw pointer to it.
+    // maintenance in progress so retire() — and therefore evict_server() —
+    // blocks until the matching finish_downsize() runs, so the backend is never
+    // stopped underneath an in-progress downsize().
     bool try_begin_downsize() {
         std::lock_guard<std::mutex> lock(state_mutex_);
         if (state_ == ModelState::READY && active_request_count_ == 0) {
@@ -216,7 +337,7 @@ public:
     }
 
     // Completes the maintenance downsize started by try_begin_downsize(). Clears
-    // the maintenance flag (releasing any waiters in wait_until_not_busy() /
+    // the maintenance flag (releasing any waiters in retire() /
     // acquire_for_inference()) and, while still DOWNSIZING, transitions to
     // DOWNSIZED on success or back to READY on failure so a failed backend
     // operation never leaves a model falsely marked as downsized.
@@ -234,10 +355,13 @@ public:
         return active_request_count_ > 0 || maintenance_in_progress_;
     }
 
-    // Wait until the router no longer has active work using this object.
-    // Returns true when the server is idle. Returns false if a bounded wait
-    // timed out; callers must not destroy the WrappedServer in that case.
-    bool wait_until_not_busy(int timeout_seconds = -1) const {
+    // Called by the router after unpublishing this server. Waits until no
+    // request or maintenance operation is using it and, in the same critical
+    // section, marks it UNLOADED so a request that looked it up just before it
+    // was unpublished fails acquire_for_inference() instead of reaching a
+    // backend that is about to stop. Returns false if a bounded wait timed out;
+    // the server then stays alive until the last request drops its reference.
+    bool retire(int timeout_seconds = -1) {
         std::unique_lock<std::mutex> lock(state_mutex_);
         auto not_busy = [this] {
             return active_request_count_ == 0 && !maintenance_in_progress_;
@@ -245,14 +369,12 @@ public:
 
         if (timeout_seconds < 0) {
             state_cv_.wait(lock, not_busy);
-            return true;
+        } else if (!state_cv_.wait_for(lock, std::chrono::seconds(timeout_seconds), not_busy)) {
+            return false;
         }
-
-        return state_cv_.wait_for(
-            lock,
-            std::chrono::seconds(timeout_seconds),
-            not_busy
-        );
+        state_ = ModelState::UNLOADED;
+        state_cv_.notify_all();
+        return true;
     }
 
     // Multi-model support: Model metadata
@@ -263,6 +385,7 @@ public:
         model_type_ = type;
         device_type_ = device;
         recipe_options_ = recipe_options;
+        eviction_policy_ = EvictionPolicy::from_recipe_options(recipe_options.to_json());
     }
 
     std::string get_model_name() const { return model_name_; }
@@ -270,6 +393,7 @@ public:
     ModelType get_model_type() const { return model_type_; }
     DeviceType get_device_type() const { return device_type_; }
     RecipeOptions get_recipe_options() const { return recipe_options_; }
+    const EvictionPolicy& get_eviction_policy() const { return eviction_policy_; }
     int get_process_id() const { return get_process_handle_snapshot().pid; }
     int get_backend_port() const;
 
@@ -381,9 +505,45 @@ protected:
     // Choose an available port
     int choose_port();
 
-    // Wait for server to be ready (can be overridden for custom health checks)
+    // Picks a Unix domain socket for a backend that can listen on one
+    // (llama-server accepts a path ending in ".sock" as --host). Returns ""
+    // when the backend should use TCP: on Windows, with
+    // LEMONADE_BACKEND_UNIX_SOCKETS=0, without a runtime dir, or after
+    // mark_tcp_only() for this executable. Otherwise the socket is routed
+    // in HttpClient and get_base_url() switches to it until unload.
+    std::string choose_unix_socket(const std::string& executable);
+
+    // Drops the current socket before a retry over TCP
+    void fall_back_to_tcp();
+
+    // Remembers that `executable` serves on TCP but not on a Unix socket, so
+    // later loads go straight to TCP
+    void mark_tcp_only(const std::string& executable);
+
+    bool uses_unix_socket() const;
+
+    // Reserves disjoint cores for this backend's next process from
+    // CpuPlacementPlanner::global(), sized by the recipe and `threads` (the
+    // compute threads the backend was configured with, 0 = recipe default).
+    // Pass the result to ProcessManager::start_process. The cores are
+    // returned when the process handle is consumed for cleanup.
+    utils::CpuPlacement reserve_cpu_placement(int threads = 0);
+
+    // Wait for server to be ready (can be overridden for custom health checks).
+    // poll_interval_ms caps the adaptive backoff between health probes.
     virtual bool wait_for_ready(const std::string& endpoint, long timeout_seconds = 600, long poll_interval_ms = 100);
 
+    enum class ReadyWaitResult { Ready, Exited, TimedOut };
+
+    // Event-driven readiness wait shared by wait_for_ready() overrides. Wakes
+    // on the backend's "listening"/"model loaded" output lines, probes the
+    // port before the health endpoint, and otherwise polls with backoff from
+    // 10 ms up to `max_poll_interval`. On Exited the process handle is left
+    // for the caller to reap. Records listen/ready times in the load timing.
+    ReadyWaitResult await_backend_ready(const std::string& endpoint,
+                                        std::chrono::milliseconds timeout,
+                                        std::chrono::milliseconds max_poll_interval);
+
     // Configure/start the generic backend watchdog. Non-streaming requests are
     // always monitored so a hung backend becomes a reload+retry delay instead
     // of a stuck user request. Streaming can still avoid replaying partial data.
@@ -406,16 +566,23 @@ protected:
     // Validate that the process is running (platform-agnostic check)
     bool is_process_running() const;
 
-    std::string get_base_url() const {
-        return "http://127.0.0.1:" + std::to_string(get_backend_port());
-    }
+    std::string get_base_url() const;
 
     json create_watchdog_reset_response() const;
 
     std::string server_name_;
     int port_;
+    std::string unix_socket_path_;  // Set while the backend listens on a Unix socket
+    std::string unix_authority_;    // Placeholder host routed to unix_socket_path_
+    utils::CpuPlacement cpu_placement_;  // Set while the backend holds reserved cores
+    std::string cgroup_leaf_;            // Backend's cgroup directory, "" when none
+    double expected_memory_gb_ = 0.0;
     ProcessHandle process_handle_;
     mutable std::mutex process_mutex_;
+    mutable std::mutex load_timing_mutex_;
+    BackendLoadTiming load_timing_;
+    std::chrono::steady_clock::time_point load_started_at_;
+    std::chrono::steady_clock::time_point spawned_at_;
     Telemetry telemetry_;
     std::string log_level_;
     ModelManager* model_manager_;  // Non-owning pointer to ModelManager
@@ -428,6 +595,8 @@ protected:
     DeviceType device_type_ = DEVICE_NONE;
     std::chrono::steady_clock::time_point last_access_time_;
     RecipeOptions recipe_options_;
+    EvictionPolicy eviction_policy_;
+    std::function<void(const WrappedServer*)> activity_listener_;
 
     // Busy state tracking (for safe eviction)
     mutable std::mutex state_mutex_;
@@ -436,23 +605,52 @@ protected:
     int active_request_count_;
 
     // True while the eviction engine is performing a maintenance downsize on this
-    // server. Counts as "busy" so wait_until_not_busy() (and therefore
-    // evict_server()) blocks until the operation completes, preventing the server
-    // from being unloaded/destroyed while the engine holds a raw pointer to it.
+    // server. Counts as "busy" so retire() (and therefore evict_server()) blocks
+    // until the operation completes, preventing the backend from being unloaded
+    // mid-downsize.
     bool maintenance_in_progress_;
     long load_duration_ms_;
     bool pinned_ = false;
+    int replica_index_ = 0;
+    int replica_count_ = 1;
+    std::atomic<double> mean_request_seconds_{0.0};
 
 private:
+    void notify_activity() const {
+        if (activity_listener_) {
+            activity_listener_(this);
+        }
+    }
+
     void begin_backend_request(BackendRequestKind kind);
     void end_backend_request(BackendRequestKind kind);
-    void backend_watchdog_loop();
     bool has_backend_process_exited() const;
     void request_backend_reset_from_watchdog(const std::string& reason);
+    // Unroutes and removes the current Unix socket, if any
+    void release_unix_socket();
+    // Returns the reserved cores, if any, to the placement planner
+    void release_cpu_placement();
+    // Removes the backend's cgroup once its process has exited
+    void release_cgroup();
+
+    // The watchdog runs on the shared utils::ProcessReactor: a periodic timer
+    // decides whether a health probe is due, the backend's exit is watched
+    // through its pidfd, and probes/resets run on the reactor's worker.
+    void on_watchdog_timer();
+    void run_watchdog_probe(const std::string& health_url, long idle_seconds);
+    // Requires watchdog_mutex_
+    void post_watchdog_job_locked(std::function<void()> job);
 
     mutable std::mutex watchdog_mutex_;
-    std::condition_variable watchdog_cv_;
-    std::thread watchdog_thread_;
+    std::condition_variable watchdog_jobs_cv_;
+    int watchdog_jobs_in_flight_ = 0;
+    bool watchdog_probe_pending_ = false;
+    int watchdog_failures_ = 0;
+    std::chrono::seconds watchdog_grace_{90};
+    int watchdog_probe_timeout_seconds_ = 2;
+    int watchdog_max_failures_ = 3;
+    utils::ProcessReactor::Id watchdog_timer_ = 0;
+    utils::ProcessReactor::Id watchdog_exit_watch_ = 0;
     BackendWatchdogPolicy watchdog_policy_;
     std::chrono::steady_clock::time_point last_backend_activity_;
     std::string watchdog_reset_reason_;
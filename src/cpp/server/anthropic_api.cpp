@@ -71,11 +71,6 @@ static std::string generate_anthropic_message_id() {
     return "msg_" + std::to_string(millis);
 }
 
-static bool write_sse_event(httplib::DataSink& sink, const std::string& event, const json& data) {
-    std::string payload = "event: " + event + "\ndata: " + data.dump() + "\n\n";
-    return sink.write(payload.c_str(), payload.size());
-}
-
 static std::string stringify_anthropic_tool_result_content(const json& content,
                                                            std::vector<std::string>& warnings) {
     if (content.is_string()) {
@@ -553,320 +548,6 @@ json OllamaApi::convert_openai_chat_to_anthropic(const json& openai_response,
     return anthropic_res;
 }
 
-void OllamaApi::stream_openai_sse_to_anthropic_sse(const std::string& openai_body,
-                                                   httplib::DataSink& client_sink,
-                                                   const std::string& model,
-                                                   const std::vector<std::string>& warnings,
-                                                   StreamFn call_router) {
-    httplib::DataSink adapter_sink;
-    std::string sse_buffer;
-
-    bool sent_message_start = false;
-    bool sent_text_content_start = false;
-    bool sent_text_content_stop = false;
-    std::vector<bool> started_tool_blocks;
-    std::vector<bool> stopped_tool_blocks;
-    std::vector<std::string> tool_ids;
-    std::vector<std::string> tool_names;
-    std::string stop_reason = "end_turn";
-    int input_tokens = 0;
-    int output_tokens = 0;
-    std::string message_id = generate_anthropic_message_id();
-
-    adapter_sink.is_writable = client_sink.is_writable;
-
-    adapter_sink.write = [&client_sink,
-                          &sse_buffer,
-                          &sent_message_start,
-                          &sent_text_content_start,
-                          &sent_text_content_stop,
-                          &started_tool_blocks,
-                          &stopped_tool_blocks,
-                          &tool_ids,
-                          &tool_names,
-                          &stop_reason,
-                          &input_tokens,
-                          &output_tokens,
-                          &message_id,
-                          &model](const char* data, size_t len) -> bool {
-        sse_buffer.append(data, len);
-
-        size_t pos;
-        while ((pos = sse_buffer.find('\n')) != std::string::npos) {
-            std::string line = sse_buffer.substr(0, pos);
-            sse_buffer.erase(0, pos + 1);
-
-            if (!line.empty() && line.back() == '\r') {
-                line.pop_back();
-            }
-
-            if (line.empty() || line.find("data: ") != 0) {
-                continue;
-            }
-
-            std::string json_str = line.substr(6);
-            if (json_str == "[DONE]") {
-                continue;
-            }
-
-            try {
-                auto openai_chunk = json::parse(json_str);
-
-                if (!sent_message_start) {
-                    if (openai_chunk.contains("id") && openai_chunk["id"].is_string()) {
-                        message_id = openai_chunk["id"].get<std::string>();
-                    }
-
-                    json message_start = {
-                        {"type", "message_start"},
-                        {"message", {
-                            {"id", message_id},
-                            {"type", "message"},
-                            {"role", "assistant"},
-                            {"model", model},
-                            {"content", json::array()},
-                            {"stop_reason", nullptr},
-                            {"stop_sequence", nullptr},
-                            {"usage", {{"input_tokens", 0}, {"output_tokens", 0}}}
-                        }}
-                    };
-                    if (!write_sse_event(client_sink, "message_start", message_start)) {
-                        return false;
-                    }
-                    sent_message_start = true;
-                }
-
-                if (openai_chunk.contains("usage") && openai_chunk["usage"].is_object()) {
-                    const auto& usage = openai_chunk["usage"];
-                    input_tokens = usage.value("prompt_tokens", input_tokens);
-                    output_tokens = usage.value("completion_tokens", output_tokens);
-                }
-
-                if (openai_chunk.contains("choices") && openai_chunk["choices"].is_array() &&
-                    !openai_chunk["choices"].empty()) {
-                    const auto& choice = openai_chunk["choices"][0];
-
-                    if (choice.contains("delta") && choice["delta"].is_object()) {
-                        const auto& delta = choice["delta"];
-                        if (delta.contains("content") && delta["content"].is_string()) {
-                            std::string delta_text = delta["content"].get<std::string>();
-                            if (!delta_text.empty()) {
-                                if (!sent_text_content_start) {
-                                    json content_start = {
-                                        {"type", "content_block_start"},
-                                        {"index", 0},
-                                        {"content_block", {{"type", "text"}, {"text", ""}}}
-                                    };
-                                    if (!write_sse_event(client_sink, "content_block_start", content_start)) {
-                                        return false;
-                                    }
-                                    sent_text_content_start = true;
-                                }
-
-                                json content_delta = {
-                                    {"type", "content_block_delta"},
-                                    {"index", 0},
-                                    {"delta", {{"type", "text_delta"}, {"text", delta_text}}}
-                                };
-                                if (!write_sse_event(client_sink, "content_block_delta", content_delta)) {
-                                    return false;
-                                }
-                            }
-                        }
-
-                        if (delta.contains("tool_calls") && delta["tool_calls"].is_array()) {
-                            for (const auto& tool_delta : delta["tool_calls"]) {
-                                if (!tool_delta.is_object()) {
-                                    continue;
-                                }
-
-                                int openai_tool_index = tool_delta.value("index", 0);
-                                if (openai_tool_index < 0) {
-                                    continue;
-                                }
-
-                                size_t idx = static_cast<size_t>(openai_tool_index);
-                                if (started_tool_blocks.size() <= idx) {
-                                    started_tool_blocks.resize(idx + 1, false);
-                                    stopped_tool_blocks.resize(idx + 1, false);
-                                    tool_ids.resize(idx + 1);
-                                    tool_names.resize(idx + 1);
-                                }
-
-                                if (tool_delta.contains("id") && tool_delta["id"].is_string()) {
-                                    tool_ids[idx] = tool_delta["id"].get<std::string>();
-                                }
-
-                                if (tool_delta.contains("function") && tool_delta["function"].is_object()) {
-                                    const auto& fn = tool_delta["function"];
-                                    if (fn.contains("name") && fn["name"].is_string()) {
-                                        tool_names[idx] = fn["name"].get<std::string>();
-                                    }
-                                }
-
-                                if (!started_tool_blocks[idx]) {
-                                    if (tool_ids[idx].empty()) {
-                                        tool_ids[idx] = generate_anthropic_message_id();
-                                    }
-                                    if (tool_names[idx].empty()) {
-                                        tool_names[idx] = "unknown_tool";
-                                    }
-
-                                    json tool_block_start = {
-                                        {"type", "content_block_start"},
-                                        {"index", static_cast<int>(idx) + 1},
-                                        {"content_block", {
-                                            {"type", "tool_use"},
-                                            {"id", tool_ids[idx]},
-                                            {"name", tool_names[idx]},
-                                            {"input", json::object()}
-                                        }}
-                                    };
-                                    if (!write_sse_event(client_sink, "content_block_start", tool_block_start)) {
-                                        return false;
-                                    }
-                                    started_tool_blocks[idx] = true;
-                                }
-
-                                if (tool_delta.contains("function") && tool_delta["function"].is_object()) {
-                                    const auto& fn = tool_delta["function"];
-                                    if (fn.contains("arguments") && fn["arguments"].is_string()) {
-                                        std::string args_delta = fn["arguments"].get<std::string>();
-                                        if (!args_delta.empty()) {
-                                            json tool_input_delta = {
-                                                {"type", "content_block_delta"},
-                                                {"index", static_cast<int>(idx) + 1},
-                                                {"delta", {
-                                                    {"type", "input_json_delta"},
-                                                    {"partial_json", args_delta}
-                                                }}
-                                            };
-                                            if (!write_sse_event(client_sink, "content_block_delta", tool_input_delta)) {
-                                                return false;
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-
-                    if (choice.contains("finish_reason") && !choice["finish_reason"].is_null()) {
-                        stop_reason = map_finish_reason_to_anthropic_stop_reason(choice);
-                    }
-                }
-            } catch (const std::exception& e) {
-                std::cerr << "[OllamaApi] Failed to parse Anthropic stream chunk: " << e.what() << std::endl;
-            }
-        }
-        return true;
-    };
-
-    adapter_sink.done = [&client_sink,
-                         &sent_message_start,
-                         &sent_text_content_start,
-                         &sent_text_content_stop,
-                         &started_tool_blocks,
-                         &stopped_tool_blocks,
-                         &stop_reason,
-                         &input_tokens,
-                         &output_tokens,
-                         &warnings]() {
-        if (!sent_message_start) {
-            json message_start = {
-                {"type", "message_start"},
-                {"message", {
-                    {"id", generate_anthropic_message_id()},
-                    {"type", "message"},
-                    {"role", "assistant"},
-                    {"content", json::array()},
-                    {"stop_reason", nullptr},
-                    {"stop_sequence", nullptr},
-                    {"usage", {{"input_tokens", 0}, {"output_tokens", 0}}}
-                }}
-            };
-            if (!write_sse_event(client_sink, "message_start", message_start)) {
-                client_sink.done();
-                return;
-            }
-            sent_message_start = true;
-        }
-
-        if (!sent_text_content_start && started_tool_blocks.empty()) {
-            json content_start = {
-                {"type", "content_block_start"},
-                {"index", 0},
-                {"content_block", {{"type", "text"}, {"text", ""}}}
-            };
-            if (!write_sse_event(client_sink, "content_block_start", content_start)) {
-                client_sink.done();
-                return;
-            }
-            sent_text_content_start = true;
-        }
-
-        if (sent_text_content_start && !sent_text_content_stop) {
-            json content_stop = {
-                {"type", "content_block_stop"},
-                {"index", 0}
-            };
-            if (!write_sse_event(client_sink, "content_block_stop", content_stop)) {
-                client_sink.done();
-                return;
-            }
-            sent_text_content_stop = true;
-        }
-
-        for (size_t idx = 0; idx < started_tool_blocks.size(); ++idx) {
-            if (started_tool_blocks[idx] && !stopped_tool_blocks[idx]) {
-                json tool_stop = {
-                    {"type", "content_block_stop"},
-                    {"index", static_cast<int>(idx) + 1}
-                };
-                if (!write_sse_event(client_sink, "content_block_stop", tool_stop)) {
-                    client_sink.done();
-                    return;
-                }
-                stopped_tool_blocks[idx] = true;
-            }
-        }
-
-        if (stop_reason == "end_turn") {
-            for (bool started : started_tool_blocks) {
-                if (started) {
-                    stop_reason = "tool_use";
-                    break;
-                }
-            }
-        }
-
-        json message_delta = {
-            {"type", "message_delta"},
-            {"delta", {
-                {"stop_reason", stop_reason},
-                {"stop_sequence", nullptr}
-            }},
-            {"usage", {
-                {"input_tokens", input_tokens},
-                {"output_tokens", output_tokens}
-            }}
-        };
-        if (!warnings.empty()) {
-            message_delta["warnings"] = warnings;
-        }
-        if (!write_sse_event(client_sink, "message_delta", message_delta)) {
-            client_sink.done();
-            return;
-        }
-
-        json message_stop = {{"type", "message_stop"}};
-        write_sse_event(client_sink, "message_stop", message_stop);
-        client_sink.done();
-    };
-
-    call_router(openai_body, adapter_sink);
-}
-
 void OllamaApi::handle_anthropic_messages(const httplib::Request& req, httplib::Response& res) {
     try {
         auto request_json = json::parse(req.body);
@@ -927,7 +608,8 @@ void OllamaApi::handle_anthropic_messages(const httplib::Request& req, httplib::
                 [this, openai_body, model, warnings](size_t offset, httplib::DataSink& sink) {
                     if (offset > 0) return false;
 
-                    stream_openai_sse_to_anthropic_sse(openai_body, sink, model, warnings,
+                    SseTranscoder transcoder(SseTranscoder::Target::Anthropic, model, warnings);
+                    stream_transcoded(openai_body, sink, transcoder,
                         [this](const std::string& body, httplib::DataSink& s) {
                             router_->chat_completion_stream(body, s);
                         }
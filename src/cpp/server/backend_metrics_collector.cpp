@@ -0,0 +1,400 @@
+#include "lemon/backend_metrics_collector.h"
+
+#include <algorithm>
+#include <cctype>
+#include <future>
+#include <set>
+#include <sstream>
+
+#include "lemon/utils/aixlog.hpp"
+
+namespace lemon {
+
+std::string prometheus_escape_label_value(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char ch : value) {
+        if (ch == '\\') {
+            escaped += "\\\\";
+        } else if (ch == '"') {
+            escaped += "\\\"";
+        } else if (ch == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += ch;
+        }
+    }
+    return escaped;
+}
+
+namespace {
+
+std::string sanitize_prometheus_metric_name(const std::string& name) {
+    std::string sanitized;
+    sanitized.reserve(name.size());
+    for (char ch : name) {
+        unsigned char uch = static_cast<unsigned char>(ch);
+        if (std::isalnum(uch) || ch == '_') {
+            sanitized += ch;
+        } else {
+            sanitized += '_';
+        }
+    }
+    if (sanitized.empty() || std::isdigit(static_cast<unsigned char>(sanitized[0]))) {
+        sanitized.insert(sanitized.begin(), '_');
+    }
+    return sanitized;
+}
+
+// Native prefix each backend already puts on its metrics ("llamacpp:",
+// "vllm:"), dropped so names are not doubled up after Lemonade's own prefix.
+std::string native_prefix_for_recipe(const std::string& recipe) {
+    if (recipe == "llamacpp") return "llamacpp_";
+    if (recipe == "vllm") return "vllm_";
+    if (recipe == "whispercpp") return "whisper_";
+    if (recipe == "sd-cpp") return "sd_";
+    return "";
+}
+
+std::string normalize_metric_name(const std::string& name, const std::string& recipe,
+                                  const std::string& prefix) {
+    std::string sanitized = sanitize_prometheus_metric_name(name);
+    const std::string native = native_prefix_for_recipe(recipe);
+    if (!native.empty() && sanitized.rfind(native, 0) == 0) {
+        sanitized = sanitized.substr(native.size());
+    }
+    return prefix + sanitized;
+}
+
+std::string append_prometheus_labels(const std::string& existing_labels,
+                                     const BackendMetricsCollector::Labels& labels) {
+    std::ostringstream oss;
+    bool first = existing_labels.empty();
+    if (!existing_labels.empty()) {
+        oss << existing_labels;
+    }
+    for (const auto& [key, value] : labels) {
+        if (!first) {
+            oss << ",";
+        }
+        first = false;
+        oss << key << "=\"" << prometheus_escape_label_value(value) << "\"";
+    }
+    return oss.str();
+}
+
+// Histogram and summary samples carry a suffix on the family name
+bool belongs_to_family(const std::string& sample_name, const std::string& family) {
+    if (family.empty() || sample_name.rfind(family, 0) != 0) {
+        return false;
+    }
+    const std::string suffix = sample_name.substr(family.size());
+    return suffix.empty() || suffix == "_bucket" || suffix == "_sum" ||
+           suffix == "_count" || suffix == "_total" || suffix == "_created";
+}
+
+} // namespace
+
+BackendMetricsCollector::BackendMetricsCollector(TargetProvider provider,
+                                                 Fetcher fetcher,
+                                                 int interval_ms,
+                                                 std::chrono::seconds idle_timeout)
+    : provider_(std::move(provider)),
+      fetcher_(std::move(fetcher)),
+      interval_ms_(std::max(interval_ms, 100)),
+      idle_timeout_(idle_timeout) {}
+
+BackendMetricsCollector::~BackendMetricsCollector() {
+    stop();
+}
+
+std::string BackendMetricsCollector::metric_prefix_for_recipe(const std::string& recipe) {
+    if (recipe == "llamacpp") return "lemonade_llamacpp_";
+    if (recipe == "vllm") return "lemonade_vllm_";
+    // Probed: only some whisper.cpp / sd.cpp server builds expose /metrics,
+    // a 404 marks the backend unsupported until it is reloaded.
+    if (recipe == "whispercpp") return "lemonade_whispercpp_";
+    if (recipe == "sd-cpp") return "lemonade_sdcpp_";
+    return "";
+}
+
+std::string BackendMetricsCollector::entry_key(const Target& target) {
+    return target.recipe + " " + target.backend_url;
+}
+
+void BackendMetricsCollector::rewrite_exposition(const std::string& body,
+                                                 const std::string& recipe,
+                                                 const Labels& labels,
+                                                 std::map<std::string, std::string>& metadata,
+                                                 std::map<std::string, std::string>& samples) {
+    const std::string prefix = metric_prefix_for_recipe(recipe);
+    if (prefix.empty()) {
+        return;
+    }
+
+    std::string current_family;
+    std::istringstream lines(body);
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+
+        if (line[0] == '#') {
+            const bool is_help = line.rfind("# HELP ", 0) == 0;
+            const bool is_type = line.rfind("# TYPE ", 0) == 0;
+            if (!is_help && !is_type) {
+                continue;
+            }
+            size_t name_start = 7;
+            size_t name_end = line.find(' ', name_start);
+            if (name_end == std::string::npos) {
+                continue;
+            }
+            std::string family = normalize_metric_name(line.substr(name_start, name_end - name_start),
+                                                       recipe, prefix);
+            if (is_type) {
+                current_family = family;
+            }
+            metadata[family] += line.substr(0, name_start) + family + line.substr(name_end) + "\n";
+            continue;
+        }
+
+        size_t name_end = line.find_first_of("{ \t");
+        if (name_end == std::string::npos || name_end == 0) {
+            continue;
+        }
+
+        std::string metric_name = normalize_metric_name(line.substr(0, name_end), recipe, prefix);
+        std::string label_text;
+        size_t value_start = name_end;
+        if (line[name_end] == '{') {
+            size_t label_end = line.find('}', name_end + 1);
+            if (label_end == std::string::npos) {
+                continue;
+            }
+            label_text = line.substr(name_end + 1, label_end - name_end - 1);
+            value_start = label_end + 1;
+        }
+
+        const std::string family = belongs_to_family(metric_name, current_family) ? current_family : metric_name;
+        std::string merged_labels = append_prometheus_labels(label_text, labels);
+        std::string& block = samples[family];
+        block += metric_name;
+        if (!merged_labels.empty()) {
+            block += "{" + merged_labels + "}";
+        }
+        block += line.substr(value_start);
+        block += "\n";
+    }
+}
+
+void BackendMetricsCollector::start() {
+    {
+        std::lock_guard<std::mutex> lock(run_mutex_);
+        if (running_) {
+            return;
+        }
+        running_ = true;
+    }
+    thread_ = std::thread(&BackendMetricsCollector::collection_loop, this);
+}
+
+void BackendMetricsCollector::stop() {
+    {
+        std::lock_guard<std::mutex> lock(run_mutex_);
+        running_ = false;
+    }
+    run_cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void BackendMetricsCollector::collection_loop() {
+    std::unique_lock<std::mutex> lock(run_mutex_);
+    while (running_) {
+        // Park while nobody reads /metrics; render() wakes us up
+        if (last_render_ == Clock::time_point{} || Clock::now() - last_render_ > idle_timeout_) {
+            run_cv_.wait(lock, [this] {
+                return !running_ || (last_render_ != Clock::time_point{} &&
+                                     Clock::now() - last_render_ <= idle_timeout_);
+            });
+            continue;
+        }
+
+        lock.unlock();
+        scrape_now();
+        lock.lock();
+
+        run_cv_.wait_for(lock, std::chrono::milliseconds(interval_ms_), [this] { return !running_; });
+    }
+}
+
+void BackendMetricsCollector::scrape_now() {
+    std::lock_guard<std::mutex> scrape_lock(scrape_mutex_);
+
+    std::vector<Target> targets;
+    try {
+        targets = provider_();
+    } catch (const std::exception& e) {
+        LOG(DEBUG, "Metrics") << "Could not list backends to scrape: " << e.what() << std::endl;
+        return;
+    }
+
+    struct Result {
+        bool done = false;       // Scraped (successfully or not) this round
+        Entry entry;
+    };
+
+    // Skip recipes without an endpoint and backends that already answered 404
+    std::vector<std::pair<std::string, std::future<Result>>> pending;
+    std::set<std::string> current;
+    {
+        std::lock_guard<std::mutex> cache_lock(cache_mutex_);
+        for (const auto& target : targets) {
+            if (metric_prefix_for_recipe(target.recipe).empty()) {
+                continue;
+            }
+            const std::string key = entry_key(target);
+            if (!current.insert(key).second) {
+                continue;
+            }
+            auto it = cache_.find(key);
+            if (it != cache_.end() && it->second.unsupported) {
+                continue;
+            }
+            // Each backend is fetched on its own thread so a slow one only
+            // delays its own entry, bounded by the fetcher's timeouts.
+            pending.emplace_back(key, std::async(std::launch::async, [this, target]() {
+                Result result;
+                result.entry.recipe = target.recipe;
+                result.entry.labels = target.labels;
+                int status = 0;
+                std::string body;
+                bool ok = false;
+                try {
+                    ok = fetcher_(target.backend_url, status, body);
+                } catch (...) {
+                    // Backend metrics are best effort
+                }
+                result.done = true;
+                if (ok && status == 200) {
+                    rewrite_exposition(body, target.recipe, target.labels,
+                                       result.entry.metadata, result.entry.samples);
+                    result.entry.up = true;
+                    result.entry.scraped_at = Clock::now();
+                } else if (ok && status == 404) {
+                    result.entry.unsupported = true;
+                }
+                return result;
+            }));
+        }
+    }
+
+    std::vector<std::pair<std::string, Result>> results;
+    for (auto& [key, future] : pending) {
+        results.emplace_back(key, future.get());
+    }
+
+    std::lock_guard<std::mutex> cache_lock(cache_mutex_);
+    // Unloaded backends drop out of the cache
+    for (auto it = cache_.begin(); it != cache_.end();) {
+        it = current.count(it->first) ? std::next(it) : cache_.erase(it);
+    }
+    for (auto& [key, result] : results) {
+        Entry& entry = cache_[key];
+        if (result.entry.up || result.entry.unsupported) {
+            entry = std::move(result.entry);
+        } else {
+            // Keep the last good scrape time so its age keeps growing
+            entry.recipe = result.entry.recipe;
+            entry.labels = result.entry.labels;
+            entry.metadata.clear();
+            entry.samples.clear();
+            entry.up = false;
+        }
+    }
+}
+
+void BackendMetricsCollector::prune_unloaded() {
+    std::vector<Target> targets;
+    try {
+        targets = provider_();
+    } catch (const std::exception&) {
+        return;
+    }
+    std::set<std::string> current;
+    for (const auto& target : targets) {
+        current.insert(entry_key(target));
+    }
+    std::lock_guard<std::mutex> cache_lock(cache_mutex_);
+    for (auto it = cache_.begin(); it != cache_.end();) {
+        it = current.count(it->first) ? std::next(it) : cache_.erase(it);
+    }
+}
+
+BackendMetricsCollector::Snapshot BackendMetricsCollector::render() {
+    bool was_idle = false;
+    {
+        std::lock_guard<std::mutex> lock(run_mutex_);
+        was_idle = last_render_ == Clock::time_point{} || Clock::now() - last_render_ > idle_timeout_;
+        last_render_ = Clock::now();
+        if (was_idle) {
+            run_cv_.notify_all();
+        }
+    }
+    // The cache is as old as the idle period: serve it, minus backends that
+    // went away in the meantime, while the woken collector refreshes it
+    if (was_idle) {
+        prune_unloaded();
+    }
+
+    Snapshot snapshot;
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    const auto now = Clock::now();
+
+    // Merge per-family so each family's HELP/TYPE appears once, followed by
+    // the samples of every backend that reports it.
+    std::set<std::string> families;
+    for (const auto& [key, entry] : cache_) {
+        if (entry.unsupported) {
+            continue;
+        }
+        Status status;
+        status.labels = entry.labels;
+        status.up = entry.up;
+        if (entry.scraped_at != Clock::time_point{}) {
+            status.age_seconds = std::chrono::duration<double>(now - entry.scraped_at).count();
+        }
+        snapshot.statuses.push_back(std::move(status));
+
+        for (const auto& [family, block] : entry.samples) {
+            families.insert(family);
+        }
+    }
+
+    for (const auto& family : families) {
+        bool described = false;
+        for (const auto& [key, entry] : cache_) {
+            auto samples = entry.samples.find(family);
+            if (samples == entry.samples.end()) {
+                continue;
+            }
+            if (!described) {
+                auto meta = entry.metadata.find(family);
+                if (meta != entry.metadata.end()) {
+                    snapshot.text += meta->second;
+                }
+                described = true;
+            }
+            snapshot.text += samples->second;
+        }
+    }
+    return snapshot;
+}
+
+} // namespace lemon
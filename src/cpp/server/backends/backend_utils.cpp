@@ -17,6 +17,7 @@
 #include "lemon/utils/http_client.h"
 #include "lemon/utils/process_manager.h"
 #include "lemon/utils/archive_platform.h"
+#include "lemon/utils/stream_extractor.h"
 #include <cctype>
 #include <cstdlib>
 #include <cstring>
@@ -624,6 +625,11 @@ namespace lemon::backends {
                 }
                 // 404 = no manifest = single-file release; fall through.
             }
+
+            // Extract into staging while the bytes arrive. The archive is
+            // still written to zip_path for hash verification, resume and the
+            // fallback to extract_archive() below.
+            auto stream_extractor = utils::StreamExtractor::create(filename, staging_dir);
             if (!is_split) {
                 std::string url = base_download_url + filename;
                 LOG(DEBUG, spec.log_name()) << "Downloading from: " << url << std::endl;
@@ -648,6 +654,12 @@ namespace lemon::backends {
                 utils::DownloadOptions archive_download_opts;
                 archive_download_opts.expected_hash = lookup_expected_asset_hash(
                     spec.recipe, backend, expected_version, repo, filename);
+                if (stream_extractor) {
+                    archive_download_opts.on_data = [&stream_extractor](const char* data, size_t length,
+                                                                        uint64_t offset) {
+                        stream_extractor->feed(data, length, offset);
+                    };
+                }
 
                 auto download_result = utils::HttpClient::download_file(
                     url, zip_path, http_progress_cb, {}, archive_download_opts);
@@ -665,6 +677,7 @@ namespace lemon::backends {
                                            << expected_version << std::endl;
 
                 std::ofstream combined(zip_path, std::ios::binary);
+                uint64_t part_offset = 0;  // Where the current part starts in the combined archive
                 int part_index = 0;
                 const int total_parts = static_cast<int>(part_assets.size());
                 for (const auto& part_filename : part_assets) {
@@ -704,6 +717,12 @@ namespace lemon::backends {
                     utils::DownloadOptions part_download_opts;
                     part_download_opts.expected_hash = lookup_expected_asset_hash(
                         spec.recipe, backend, expected_version, repo, part_filename);
+                    if (stream_extractor) {
+                        part_download_opts.on_data = [&stream_extractor, part_offset](const char* data, size_t length,
+                                                                                      uint64_t offset) {
+                            stream_extractor->feed(data, length, part_offset + offset);
+                        };
+                    }
 
                     auto part_result = utils::HttpClient::download_file(
                         part_url, part_path, part_http_cb, {}, part_download_opts);
@@ -716,6 +735,8 @@ namespace lemon::backends {
                     }
 
                     // Append part to the combined archive
+                    std::error_code part_size_ec;
+                    part_offset += fs::file_size(part_path, part_size_ec);
                     std::ifstream part_in(part_path, std::ios::binary);
                     combined << part_in.rdbuf();
                     part_in.close();
@@ -738,7 +759,24 @@ namespace lemon::backends {
             // Extract into the staging directory (NOT install_dir) so a failed
             // extraction cannot destroy the currently-installed binary. The
             // staging guard removes the partial tree when we throw.
-            if (!extract_archive(zip_path, staging_dir, spec.log_name())) {
+            bool streamed = false;
+            if (stream_extractor) {
+                streamed = stream_extractor->finish(file_size);
+                if (streamed) {
+                    LOG(DEBUG, spec.log_name()) << "Extracted " << stream_extractor->entries()
+                                                << " entries while downloading" << std::endl;
+                } else {
+                    // e.g. the archive was already cached or the download restarted
+                    LOG(DEBUG, spec.log_name()) << "Streaming extraction abandoned ("
+                                                << stream_extractor->error()
+                                                << "), extracting the archive instead" << std::endl;
+                    stream_extractor.reset();
+                    std::error_code clear_ec;
+                    fs::remove_all(staging_dir, clear_ec);
+                    fs::create_directories(staging_dir);
+                }
+            }
+            if (!streamed && !extract_archive(zip_path, staging_dir, spec.log_name())) {
                 throw std::runtime_error("Failed to extract archive: " + zip_path);
             }
 
@@ -520,6 +520,8 @@ json CloudServer::post_with_auth(const std::string& path, const json& request,
                 {"response", error_details}
             }
         );
+    } catch (const utils::RequestCancelledError&) {
+        return ErrorResponse::from_exception(RequestCancelledException("client disconnected"));
     } catch (const std::exception& e) {
         return ErrorResponse::from_exception(NetworkException(e.what()));
     }
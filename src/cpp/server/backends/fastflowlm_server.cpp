@@ -247,43 +247,36 @@ void FastFlowLMServer::unload() {
 
 bool FastFlowLMServer::wait_for_ready() {
     // FLM doesn't have a health endpoint, so we use /api/tags to check if it's up
-    std::string tags_url = get_base_url() + "/api/tags";
-
     LOG(INFO, "FastFlowLM") << "Waiting for " + server_name_ + " to be ready..." << std::endl;
 
-    const int max_attempts = 300;  // 5 minutes timeout (large models can take time to load)
-    for (int attempt = 0; attempt < max_attempts; ++attempt) {
-        // Check if process is still running. If it already exited, consume and
-        // reap the owned handle here so failed-start cleanup cannot later signal
-        // a stale PID.
-        const ProcessHandle handle = get_process_handle_snapshot();
-        if (!has_process_handle(handle) || !utils::ProcessManager::is_running(handle)) {
-            LOG(ERROR, "FastFlowLM") << server_name_ << " process has terminated!" << std::endl;
-            const ProcessHandle exited_handle = consume_process_handle_for_cleanup();
-            int exit_code = has_process_handle(exited_handle)
-                ? utils::ProcessManager::reap_process(exited_handle)
-                : -1;
-            LOG(ERROR, "FastFlowLM") << "Process exit code: " << exit_code << std::endl;
-            LOG(ERROR, "FastFlowLM") << "Troubleshooting tips:" << std::endl;
-            LOG(ERROR, "FastFlowLM") << "  1. Check if FLM is installed correctly: flm --version" << std::endl;
-            LOG(ERROR, "FastFlowLM") << "  2. Try running: flm serve <model> --ctx-len 8192 --port 8001" << std::endl;
-            LOG(ERROR, "FastFlowLM") << "  3. Check NPU drivers are installed (Windows only)" << std::endl;
-            return false;
-        }
-
-        // Try to reach the /api/tags endpoint
-        if (utils::HttpClient::is_reachable(tags_url, 1)) {
-            LOG(INFO, "FastFlowLM") << server_name_ + " is ready!" << std::endl;
-            start_backend_watchdog("/api/tags");
-            return true;
-        }
+    const int timeout_seconds = 300;  // 5 minutes timeout (large models can take time to load)
+    const ReadyWaitResult result = await_backend_ready("/api/tags",
+                                                       std::chrono::seconds(timeout_seconds),
+                                                       std::chrono::milliseconds(250));
+    if (result == ReadyWaitResult::Exited) {
+        // Consume and reap the owned handle here so failed-start cleanup
+        // cannot later signal a stale PID.
+        LOG(ERROR, "FastFlowLM") << server_name_ << " process has terminated!" << std::endl;
+        const ProcessHandle exited_handle = consume_process_handle_for_cleanup();
+        int exit_code = has_process_handle(exited_handle)
+            ? utils::ProcessManager::reap_process(exited_handle)
+            : -1;
+        LOG(ERROR, "FastFlowLM") << "Process exit code: " << exit_code << std::endl;
+        LOG(ERROR, "FastFlowLM") << "Troubleshooting tips:" << std::endl;
+        LOG(ERROR, "FastFlowLM") << "  1. Check if FLM is installed correctly: flm --version" << std::endl;
+        LOG(ERROR, "FastFlowLM") << "  2. Try running: flm serve <model> --ctx-len 8192 --port 8001" << std::endl;
+        LOG(ERROR, "FastFlowLM") << "  3. Check NPU drivers are installed (Windows only)" << std::endl;
+        return false;
+    }
 
-        // Sleep 1 second between attempts
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+    if (result == ReadyWaitResult::Ready) {
+        LOG(INFO, "FastFlowLM") << server_name_ + " is ready!" << std::endl;
+        start_backend_watchdog("/api/tags");
+        return true;
     }
 
     LOG(ERROR, "FastFlowLM") << server_name_ << " failed to start within "
-              << max_attempts << " seconds" << std::endl;
+              << timeout_seconds << " seconds" << std::endl;
     return false;
 }
 
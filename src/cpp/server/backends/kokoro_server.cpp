@@ -124,6 +124,12 @@ void KokoroServer::load(const std::string& model_name, const ModelInfo& model_in
         "--port", std::to_string(port_)
     };
 
+    // The CPU build gets its own cores
+    utils::CpuPlacement placement;
+    if (backend == "cpu") {
+        placement = reserve_cpu_placement();
+    }
+
     // Launch the subprocess
     ProcessHandle started_handle = utils::ProcessManager::start_process(
         exe_path,
@@ -131,7 +137,8 @@ void KokoroServer::load(const std::string& model_name, const ModelInfo& model_in
         "",     // working_dir (empty = current)
         is_debug(),  // inherit_output
         false,
-        env_vars
+        env_vars,
+        placement
     );
     set_process_handle(started_handle);
 
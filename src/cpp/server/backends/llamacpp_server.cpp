@@ -8,6 +8,8 @@
 #include "lemon/utils/json_utils.h"
 #include "lemon/utils/path_utils.h"
 #include "lemon/error_types.h"
+#include "lemon/llamacpp_autotune.h"
+#include "lemon/model_replicas.h"
 #include "lemon/system_info.h"
 #include <algorithm>
 #include <cstdlib>
@@ -16,6 +18,7 @@
 #include <iostream>
 #include <lemon/utils/aixlog.hpp>
 #include <set>
+#include <thread>
 #ifdef __APPLE__
 #include <pwd.h>
 #include <unistd.h>
@@ -41,6 +44,9 @@ namespace backends {
 static const int EMBEDDING_BATCH_SIZE = 8192;
 static const int EMBEDDING_UBATCH_SIZE = 8192;
 
+// Upper bound on one llama-bench or llama-batched-bench run during autotune
+static const int AUTOTUNE_STAGE_TIMEOUT_SECONDS = 900;
+
 // Helper to push reserved flags and their aliases
 static void push_reserved(std::set<std::string>& reserved,
                     const std::string& key,
@@ -298,12 +304,18 @@ void LlamaCppServer::load(const std::string& model_name,
     std::string mmproj_path = model_info.resolved_path("mmproj");
     std::string draft_path = model_info.resolved_path("draft");
 
-    // Choose port
-    port_ = choose_port();
-
     // Get executable path
     std::string executable = BackendUtils::get_backend_binary_path(SPEC, llamacpp_backend);
 
+    // llama-server listens on a Unix socket when --host is a path ending in
+    // ".sock". A --host in the custom arguments keeps TCP.
+    const std::vector<std::string> user_args = parse_custom_args(llamacpp_args);
+    const bool user_host = std::find(user_args.begin(), user_args.end(), "--host") != user_args.end();
+    const std::string socket_path = user_host ? "" : choose_unix_socket(executable);
+    if (socket_path.empty()) {
+        port_ = choose_port();
+    }
+
     // Check for embeddings and reranking support based on model type
     bool supports_embeddings = (model_info.type == ModelType::EMBEDDING);
     bool supports_reranking = (model_info.type == ModelType::RERANKING);
@@ -336,7 +348,13 @@ void LlamaCppServer::load(const std::string& model_name,
     }
     push_reserved(reserved_flags, "--device", std::vector<std::string>{"-dev"});
 
-    push_arg(args, reserved_flags, "--port", std::to_string(port_));
+    if (socket_path.empty()) {
+        push_arg(args, reserved_flags, "--port", std::to_string(port_));
+    } else {
+        args.push_back("--host");
+        args.push_back(socket_path);
+        push_reserved(reserved_flags, "--port", {});
+    }
     push_arg(args, reserved_flags, "--jinja", std::vector<std::string>{"--no-jinja"});
     push_arg(args, reserved_flags, "--metrics");
 
@@ -378,6 +396,101 @@ void LlamaCppServer::load(const std::string& model_name,
         push_overridable_arg(args, llamacpp_args, "--no-mmap");
     }
 
+    auto user_sets = [&user_args](std::initializer_list<const char*> flags) {
+        for (const char* flag : flags) {
+            if (std::find(user_args.begin(), user_args.end(), flag) != user_args.end()) return true;
+        }
+        return false;
+    };
+    auto user_value = [&user_args](std::initializer_list<const char*> flags) {
+        for (size_t i = 0; i + 1 < user_args.size(); ++i) {
+            for (const char* flag : flags) {
+                if (user_args[i] == flag) return std::atoi(user_args[i + 1].c_str());
+            }
+        }
+        return 0;
+    };
+
+    // Launch settings measured by the autotuner on this host. Embedding and
+    // reranking models keep the defaults: they are tuned for generation.
+    std::optional<LlamaCppTuning> tuning;
+    const json tunings = options.get_option("llamacpp_tuning");
+    if (tunings.is_object() && !supports_embeddings && !supports_reranking) {
+        const json devices = SystemInfoCache::get_system_info_with_cache().value("devices", json::object());
+        const std::string fingerprint = host_fingerprint(devices, llamacpp_backend);
+        tuning = find_tuning(tunings, fingerprint);
+        if (tuning) {
+            LOG(INFO, "LlamaCpp") << "Applying autotuned settings for " << fingerprint << ": "
+                                  << tuning->to_json().dump() << std::endl;
+        } else {
+            LOG(DEBUG, "LlamaCpp") << "No autotuned settings for " << fingerprint << std::endl;
+        }
+    }
+
+    // CPU inference gets its own cores, on one NUMA node when they fit,
+    // unless the user already chose a CPU placement
+    const bool user_placed = llamacpp_args.find("--cpu-range") != std::string::npos ||
+                             llamacpp_args.find("--cpu-mask") != std::string::npos;
+    int planned_threads = user_value({"--threads", "-t"});
+    if (planned_threads <= 0 && tuning && get_replica_count() <= 1) {
+        planned_threads = tuning->threads;
+    }
+    utils::CpuPlacement placement;
+    if (!use_gpu && !user_placed) {
+        placement = reserve_cpu_placement(planned_threads);
+    }
+    if (!placement.empty() && !user_sets({"--threads", "-t"})) {
+        int threads = placement.physical_cores;
+        if (tuning && get_replica_count() <= 1) {
+            threads = std::min(tuning->threads, static_cast<int>(placement.cpus.size()));
+        }
+        args.push_back("--threads");
+        args.push_back(std::to_string(threads));
+    }
+
+    // Without a placement, replicas of one model each get their own block
+    // of cores
+    if (placement.empty() && get_replica_count() > 1 && !user_placed) {
+        ReplicaCpuSlice slice = replica_cpu_slice(static_cast<int>(std::thread::hardware_concurrency()),
+                                                  get_replica_index(), get_replica_count());
+        if (slice.valid()) {
+            LOG(INFO, "LlamaCpp") << "Replica " << (get_replica_index() + 1) << "/" << get_replica_count()
+                                  << " uses CPUs " << slice.range() << std::endl;
+            push_overridable_arg(args, llamacpp_args, "--threads", std::to_string(slice.threads));
+            args.push_back("--cpu-range");
+            args.push_back(slice.range());
+            push_overridable_arg(args, llamacpp_args, "--cpu-strict", "1");
+        }
+    }
+
+    if (tuning) {
+        // Replicas already got a share of the cores above
+        if (placement.empty() && get_replica_count() <= 1 && !user_sets({"--threads", "-t"})) {
+            args.push_back("--threads");
+            args.push_back(std::to_string(tuning->threads));
+        }
+        if (tuning->batch_size > 0 && !user_sets({"--batch-size", "-b"})) {
+            args.push_back("--batch-size");
+            args.push_back(std::to_string(tuning->batch_size));
+        }
+        if (tuning->ubatch_size > 0 && !user_sets({"--ubatch-size", "-ub"})) {
+            args.push_back("--ubatch-size");
+            args.push_back(std::to_string(tuning->ubatch_size));
+        }
+        if (tuning->flash_attn >= 0 && !user_sets({"--flash-attn", "-fa"})) {
+            args.push_back("--flash-attn");
+            args.push_back(tuning->flash_attn ? "on" : "off");
+        }
+        // A unified KV cache lets every slot use the whole context
+        if (tuning->parallel > 0 && !user_sets({"--parallel", "-np"})) {
+            args.push_back("--parallel");
+            args.push_back(std::to_string(tuning->parallel));
+            if (!user_sets({"--kv-unified", "-kvu", "--no-kv-unified"})) {
+                args.push_back("--kv-unified");
+            }
+        }
+    }
+
     // Add embeddings support if the model supports it
     if (supports_embeddings) {
         LOG(INFO, "LlamaCpp") << "Model supports embeddings, adding --embeddings flag" << std::endl;
@@ -558,10 +671,37 @@ void LlamaCppServer::load(const std::string& model_name,
 
     bool inherit_llama_output = (log_level_ == "info") || is_debug();
     set_process_handle(ProcessManager::start_process(
-        process_executable, args, working_dir, inherit_llama_output, true, env_vars));
+        process_executable, args, working_dir, inherit_llama_output, true, env_vars, placement));
 
     // Wait for server to be ready
-    if (!wait_for_ready("/health")) {
+    bool ready = wait_for_ready("/health");
+    auto host = socket_path.empty() ? args.end() : std::find(args.begin(), args.end(), "--host");
+    if (!ready && host != args.end() && host + 1 != args.end() && *(host + 1) == socket_path &&
+        get_load_timing().listen_ms < 0) {
+        // llama-server binds before loading the model, so never listening
+        // may mean this build could not use the socket: retry once over TCP.
+        const ProcessHandle handle = consume_process_handle_for_cleanup();
+        if (has_process_handle(handle)) {
+            ProcessManager::stop_process(handle);
+        }
+        fall_back_to_tcp();
+        *host = "--port";
+        *(host + 1) = std::to_string(choose_port());
+        // Cleanup above returned the cores; take them again
+        if (!placement.empty()) {
+            placement = reserve_cpu_placement(planned_threads);
+        }
+        set_process_handle(ProcessManager::start_process(
+            process_executable, args, working_dir, inherit_llama_output, true, env_vars, placement));
+        ready = wait_for_ready("/health");
+        // Only a build that fails on the socket but works on TCP is sent
+        // straight to TCP from now on; a backend that fails both ways is
+        // just broken
+        if (ready) {
+            mark_tcp_only(executable);
+        }
+    }
+    if (!ready) {
         const ProcessHandle handle = consume_process_handle_for_cleanup();
         if (has_process_handle(handle)) {
             ProcessManager::stop_process(handle);
@@ -569,7 +709,7 @@ void LlamaCppServer::load(const std::string& model_name,
         throw std::runtime_error("llama-server failed to start");
     }
 
-    LOG(DEBUG, "LlamaCpp") << "Model loaded on port " << get_backend_port() << std::endl;
+    LOG(DEBUG, "LlamaCpp") << "Model loaded at " << get_base_url() << std::endl;
 }
 
 void LlamaCppServer::unload() {
@@ -649,5 +789,155 @@ json LlamaCppServer::responses(const json& request) {
     return forward_request("/v1/responses", request);
 }
 
+LlamaCppTuning LlamaCppServer::autotune(const ModelInfo& model_info,
+                                        const RecipeOptions& options,
+                                        BackendManager* backend_manager,
+                                        std::string& fingerprint,
+                                        const BenchRunner& run_bench,
+                                        const std::function<bool()>& cancelled) {
+    std::string llamacpp_backend_option = options.get_option("llamacpp_backend");
+    std::string llamacpp_backend = resolve_llamacpp_backend(llamacpp_backend_option);
+    std::string llamacpp_device = options.get_option("llamacpp_device");
+    RuntimeConfig::validate_backend_choice("llamacpp", llamacpp_backend_option);
+
+    const std::string gguf_path = model_info.resolved_path();
+    if (gguf_path.empty()) {
+        throw std::runtime_error("Autotune needs a local GGUF file for " + model_info.model_name);
+    }
+
+    backend_manager->install_backend(SPEC.recipe, llamacpp_backend);
+
+    // llama.cpp releases ship the benchmark tools next to llama-server
+    const fs::path server_exe = path_from_utf8(BackendUtils::get_backend_binary_path(SPEC, llamacpp_backend));
+    auto sibling_tool = [&server_exe](const std::string& name) -> std::string {
+#ifdef _WIN32
+        const fs::path tool = server_exe.parent_path() / path_from_utf8(name + ".exe");
+#else
+        const fs::path tool = server_exe.parent_path() / path_from_utf8(name);
+#endif
+        return fs::exists(tool) ? path_to_utf8(tool) : "";
+    };
+    const std::string bench_exe = sibling_tool("llama-bench");
+    if (bench_exe.empty()) {
+        throw std::runtime_error("llama-bench not found next to " + path_to_utf8(server_exe) +
+                                 "; the " + llamacpp_backend + " llama.cpp build does not include it");
+    }
+    const std::string batched_exe = sibling_tool("llama-batched-bench");
+
+    const json devices = SystemInfoCache::get_system_info_with_cache().value("devices", json::object());
+    fingerprint = host_fingerprint(devices, llamacpp_backend);
+    const json cpu = devices.value("cpu", json::object());
+    int cores = cpu.is_object() ? cpu.value("cores", 0) : 0;
+    int hw_threads = cpu.is_object() ? cpu.value("threads", 0) : 0;
+    if (hw_threads <= 0) {
+        hw_threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    if (cores <= 0) {
+        cores = hw_threads;
+    }
+
+    const bool use_gpu = (llamacpp_backend != "cpu");
+    std::vector<std::string> device_args = {"-ngl", use_gpu ? "99" : "0"};
+    if (!llamacpp_device.empty()) {
+        // llama-bench separates devices of one configuration with '/'
+        std::string devices_arg = llamacpp_device;
+        std::replace(devices_arg.begin(), devices_arg.end(), ',', '/');
+        device_args.push_back("-dev");
+        device_args.push_back(devices_arg);
+    }
+
+    auto join = [](const std::vector<int>& values) {
+        std::string joined;
+        for (int v : values) {
+            joined += (joined.empty() ? "" : ",") + std::to_string(v);
+        }
+        return joined;
+    };
+
+    auto is_cancelled = [&cancelled]() { return cancelled && cancelled(); };
+    auto run_tool = [&](const std::string& exe, const std::vector<std::string>& args) {
+        std::string output;
+        int exit_code = 0;
+        auto bench = [&]() {
+            if (is_cancelled()) {
+                return;
+            }
+            exit_code = ProcessManager::run_process_with_output(
+                exe, args,
+                [&output, &is_cancelled](const std::string& line) -> bool {
+                    LOG(DEBUG, "LlamaCpp") << line << std::endl;
+                    output += line;
+                    output += '\n';
+                    return !is_cancelled();
+                },
+                "", AUTOTUNE_STAGE_TIMEOUT_SECONDS);
+        };
+        if (run_bench) {
+            run_bench(bench);
+        } else {
+            bench();
+        }
+        if (is_cancelled()) {
+            throw std::runtime_error("Autotune of " + model_info.model_name + " was cancelled");
+        }
+        if (exit_code != 0) {
+            LOG(WARNING, "LlamaCpp") << path_to_utf8(path_from_utf8(exe).filename()) << " exited with code "
+                                     << exit_code << std::endl;
+        }
+        return output;
+    };
+
+    // One stage per parameter, each starting from the winner of the last
+    auto bench_stage = [&](const std::string& stage, const std::vector<std::string>& extra) {
+        std::vector<std::string> args = {"-m", gguf_path, "-p", "256", "-n", "32", "-r", "2", "-o", "jsonl"};
+        args.insert(args.end(), device_args.begin(), device_args.end());
+        args.insert(args.end(), extra.begin(), extra.end());
+        LOG(INFO, "LlamaCpp") << "Autotune " << model_info.model_name << ": " << stage << std::endl;
+        return pick_fastest(parse_llama_bench_jsonl(run_tool(bench_exe, args)));
+    };
+
+    LlamaCppTuning best = bench_stage("threads", {"-t", join(autotune_thread_candidates(cores, hw_threads))});
+    if (!best.valid()) {
+        throw std::runtime_error("llama-bench produced no results for " + model_info.model_name);
+    }
+
+    LlamaCppTuning stage = bench_stage("flash attention", {"-t", std::to_string(best.threads), "-fa", "0,1"});
+    if (stage.valid()) {
+        best = stage;
+    }
+
+    stage = bench_stage("batch sizes", {"-t", std::to_string(best.threads),
+                                        "-fa", std::to_string(best.flash_attn == 1 ? 1 : 0),
+                                        "-b", "512,2048", "-ub", "128,256,512"});
+    if (stage.valid()) {
+        best = stage;
+    }
+
+    if (!batched_exe.empty()) {
+        std::vector<std::string> args = {"-m", gguf_path, "-c", "2048",
+                                         "-t", std::to_string(best.threads),
+                                         "-b", std::to_string(best.batch_size),
+                                         "-ub", std::to_string(best.ubatch_size),
+                                         "-fa", best.flash_attn == 1 ? "on" : "off",
+                                         "-npp", "128", "-ntg", "32", "-npl", "1,2,4,8",
+                                         "--output-format", "jsonl"};
+        args.insert(args.end(), {"-ngl", use_gpu ? "99" : "0"});
+        if (!llamacpp_device.empty()) {
+            args.insert(args.end(), {"--device", llamacpp_device});
+        }
+        LOG(INFO, "LlamaCpp") << "Autotune " << model_info.model_name << ": parallel slots" << std::endl;
+        auto results = parse_batched_bench_jsonl(run_tool(batched_exe, args));
+        if (!results.empty()) {
+            best.parallel = pick_parallel(results);
+        }
+    } else {
+        LOG(INFO, "LlamaCpp") << "llama-batched-bench not found, keeping the default parallel slots" << std::endl;
+    }
+
+    LOG(INFO, "LlamaCpp") << "Autotune result for " << model_info.model_name << " on " << fingerprint
+                          << ": " << best.to_json().dump() << std::endl;
+    return best;
+}
+
 } // namespace backends
 } // namespace lemon
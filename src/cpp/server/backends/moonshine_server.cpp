@@ -168,7 +168,8 @@ void MoonshineServer::load(const std::string& model_name,
         "",     // working_dir
         inherit_output,
         false,  // filter_health_logs
-        env_vars
+        env_vars,
+        reserve_cpu_placement()  // moonshine-server runs on the CPU
     );
     set_process_handle(started_handle);
 
@@ -10,6 +10,8 @@
 #include "lemon/error_types.h"
 #include "lemon/system_info.h"
 #include <httplib.h>
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <filesystem>
 #include <fstream>
@@ -366,6 +368,22 @@ void SDServer::load(const std::string& model_name,
         BackendUtils::apply_cuda_env_vars(env_vars, "SDServer");
     }
 
+    // CPU generation gets its own cores; -t follows them unless the custom
+    // arguments set it
+    utils::CpuPlacement placement;
+    if (resolved_backend == "cpu") {
+        const std::vector<std::string> user_args = parse_custom_args(sdcpp_args);
+        auto t = std::find_if(user_args.begin(), user_args.end(), [](const std::string& arg) {
+            return arg == "-t" || arg == "--threads";
+        });
+        const bool user_threads = t != user_args.end() && t + 1 != user_args.end();
+        placement = reserve_cpu_placement(user_threads ? std::atoi((t + 1)->c_str()) : 0);
+        if (!placement.empty() && !user_threads) {
+            args.push_back("-t");
+            args.push_back(std::to_string(placement.physical_cores));
+        }
+    }
+
     // Launch the server process
     std::string process_exe_path = exe_path;
     std::string working_dir;
@@ -380,7 +398,8 @@ void SDServer::load(const std::string& model_name,
         working_dir,
         is_debug(),  // inherit_output
         false,  // filter_health_logs
-        env_vars
+        env_vars,
+        placement
     );
     set_process_handle(started_handle);
 
@@ -0,0 +1,433 @@
+#include "lemon/backends/upscale_worker.h"
+#include "lemon/utils/json_utils.h"
+#include "lemon/utils/path_utils.h"
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <random>
+#include <sstream>
+#include <lemon/utils/aixlog.hpp>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace lemon {
+namespace backends {
+
+using namespace lemon::utils;
+
+namespace {
+
+// Same budget as a one-shot sd-cli run
+constexpr auto UPSCALE_TIMEOUT = std::chrono::seconds(300);
+
+// How long a request waits for a just-started standby to open its input
+constexpr auto STANDBY_OPEN_TIMEOUT = std::chrono::seconds(60);
+
+bool worker_enabled() {
+#ifdef _WIN32
+    return false;  // sd-cli cannot take a named pipe as -i/-o there
+#else
+    const char* raw = std::getenv("LEMONADE_UPSCALE_WORKER");
+    return !(raw && std::string(raw) == "0");
+#endif
+}
+
+// Signature up front and the IEND chunk at the end, i.e. not truncated
+bool is_png(const std::string& data) {
+    static const char signature[] = "\x89PNG\r\n\x1a\n";
+    static const char iend[] = "\0\0\0\0IEND\xae\x42\x60\x82";
+    return data.size() > 20 && data.compare(0, 8, signature, 8) == 0 &&
+           data.compare(data.size() - 12, 12, iend, 12) == 0;
+}
+
+#ifndef _WIN32
+// Writes all of `data`; a reader that went away yields false, not SIGPIPE
+bool write_all(int fd, const std::string& data) {
+#ifdef F_SETNOSIGPIPE
+    fcntl(fd, F_SETNOSIGPIPE, 1);
+#else
+    sigset_t pipe_set;
+    sigset_t old_set;
+    sigemptyset(&pipe_set);
+    sigaddset(&pipe_set, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipe_set, &old_set);
+#endif
+    size_t written = 0;
+    bool ok = true;
+    while (written < data.size()) {
+        ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            ok = false;
+            break;
+        }
+        written += static_cast<size_t>(n);
+    }
+#ifndef F_SETNOSIGPIPE
+    if (!ok && errno == EPIPE) {
+        // Consume the SIGPIPE raised for this thread before unblocking it
+        struct timespec no_wait = {0, 0};
+        sigtimedwait(&pipe_set, nullptr, &no_wait);
+    }
+    pthread_sigmask(SIG_SETMASK, &old_set, nullptr);
+#endif
+    return ok;
+}
+
+std::string read_all(const std::string& path) {
+    std::string data;
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return data;
+    }
+    char buffer[64 * 1024];
+    while (true) {
+        ssize_t n = ::read(fd, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        data.append(buffer, static_cast<size_t>(n));
+    }
+    ::close(fd);
+    return data;
+}
+#endif
+
+} // namespace
+
+UpscaleWorkerPool::UpscaleWorkerPool(OneShotFn one_shot, int idle_timeout_seconds)
+    : one_shot_(std::move(one_shot)), idle_timeout_(std::max(idle_timeout_seconds, 1)),
+      enabled_(worker_enabled()) {
+    if (enabled_) {
+        reaper_ = std::thread(&UpscaleWorkerPool::reap_loop, this);
+    }
+}
+
+UpscaleWorkerPool::~UpscaleWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        running_ = false;
+    }
+    wake_cv_.notify_all();
+    if (reaper_.joinable()) {
+        reaper_.join();
+    }
+    clear();
+}
+
+std::string UpscaleWorkerPool::upscale(const std::string& b64_image,
+                                       const std::string& upscale_model_path,
+                                       const std::string& cli_exe_path,
+                                       const EnvVars& env_vars) {
+    std::shared_ptr<Worker> worker;
+    if (enabled_ && fs::exists(path_from_utf8(cli_exe_path))) {
+        worker = get_worker(upscale_model_path, cli_exe_path, env_vars);
+    }
+    if (!worker) {
+        return one_shot_(b64_image, upscale_model_path, cli_exe_path, env_vars);
+    }
+
+    std::unique_lock<std::mutex> lock(worker->mutex);
+    worker->last_used = std::chrono::steady_clock::now();
+    if (worker->disabled) {
+        lock.unlock();
+        return one_shot_(b64_image, upscale_model_path, cli_exe_path, env_vars);
+    }
+
+    reap_exiting(*worker, false);
+    if (worker->has_process && !ProcessManager::is_running(worker->process)) {
+        LOG(DEBUG, "SDServer") << "Upscale standby for " << upscale_model_path
+                               << " exited while idle" << std::endl;
+        ProcessManager::reap_process(worker->process);
+        worker->has_process = false;
+    }
+    const bool primed = worker->has_process;
+    if (!primed && !start_standby(*worker)) {
+        worker->disabled = true;
+        lock.unlock();
+        return one_shot_(b64_image, upscale_model_path, cli_exe_path, env_vars);
+    }
+
+    const std::string raw = JsonUtils::base64_decode(b64_image);
+    const auto start = std::chrono::steady_clock::now();
+    std::string upscaled;
+    const bool fed = run_standby(*worker, raw, upscaled);
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    if (!fed) {
+        // Do not keep retrying a standby this sd-cli cannot drive
+        LOG(WARNING, "SDServer") << "Upscale standby failed for " << upscale_model_path
+                                 << ", using one-shot sd-cli runs for this model" << std::endl;
+        worker->disabled = true;
+        remove_worker_dir(*worker);
+        lock.unlock();
+        return one_shot_(b64_image, upscale_model_path, cli_exe_path, env_vars);
+    }
+
+    // Prime the next request while this response goes out
+    start_standby(*worker);
+
+    if (upscaled.empty()) {
+        // The standby took the image and produced nothing, which a one-shot
+        // run of the same sd-cli would repeat; most likely a bad image
+        LOG(WARNING, "SDServer") << "Upscale produced no image for " << upscale_model_path << std::endl;
+        return "";
+    }
+
+    LOG(INFO, "SDServer") << "ESRGAN upscale complete (" << raw.size() << " -> " << upscaled.size()
+                          << " bytes, " << ms << " ms, " << (primed ? "primed" : "cold") << " worker)"
+                          << std::endl;
+    return JsonUtils::base64_encode(upscaled);
+}
+
+void UpscaleWorkerPool::clear() {
+    std::map<std::string, std::shared_ptr<Worker>> workers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        workers.swap(workers_);
+    }
+    for (auto& [key, worker] : workers) {
+        std::lock_guard<std::mutex> worker_lock(worker->mutex);
+        stop_standby(*worker);
+        remove_worker_dir(*worker);
+    }
+}
+
+size_t UpscaleWorkerPool::standby_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto& [key, worker] : workers_) {
+        std::unique_lock<std::mutex> worker_lock(worker->mutex, std::try_to_lock);
+        // A worker busy with a request will have a standby again afterwards
+        if (!worker_lock.owns_lock() || worker->has_process) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+std::shared_ptr<UpscaleWorkerPool::Worker> UpscaleWorkerPool::get_worker(const std::string& model_path,
+                                                                         const std::string& cli_exe_path,
+                                                                         const EnvVars& env_vars) {
+    const std::string key = cli_exe_path + "|" + model_path;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = workers_.find(key);
+    if (it != workers_.end()) {
+        // A different backend build or library path means a new process
+        if (it->second->env_vars == env_vars) {
+            return it->second;
+        }
+        std::lock_guard<std::mutex> worker_lock(it->second->mutex);
+        stop_standby(*it->second);
+        remove_worker_dir(*it->second);
+        workers_.erase(it);
+    }
+
+#ifdef _WIN32
+    return nullptr;
+#else
+    fs::path runtime_base;
+    try {
+        runtime_base = path_from_utf8(get_runtime_dir());
+    } catch (const std::exception& e) {
+        LOG(DEBUG, "SDServer") << "No runtime directory for upscale workers: " << e.what() << std::endl;
+        return nullptr;
+    }
+    std::random_device rd;
+    std::uniform_int_distribution<unsigned int> dis(0, 0xFFFFFF);
+    fs::path dir;
+    std::error_code ec;
+    for (int attempt = 0; attempt < 8 && dir.empty(); ++attempt) {
+        std::ostringstream suffix;
+        suffix << "sd-upscale-worker-" << ::getpid() << "-" << std::hex << dis(rd);
+        fs::path candidate = runtime_base / suffix.str();
+        ec.clear();
+        if (fs::create_directory(candidate, ec)) {
+            dir = candidate;
+        }
+    }
+    if (dir.empty()) {
+        return nullptr;
+    }
+    // The extensions matter: sd-cli picks its image format from them
+    if (mkfifo((dir / "input.png").c_str(), 0600) != 0 || mkfifo((dir / "output.png").c_str(), 0600) != 0) {
+        LOG(DEBUG, "SDServer") << "Could not create upscale FIFOs: " << std::strerror(errno) << std::endl;
+        fs::remove_all(dir, ec);
+        return nullptr;
+    }
+
+    auto worker = std::make_shared<Worker>();
+    worker->cli_exe_path = cli_exe_path;
+    worker->model_path = model_path;
+    worker->env_vars = env_vars;
+    worker->dir = dir.string();
+    worker->last_used = std::chrono::steady_clock::now();
+    workers_[key] = worker;
+    return worker;
+#endif
+}
+
+bool UpscaleWorkerPool::start_standby(Worker& worker) {
+    if (worker.has_process || worker.dir.empty()) {
+        return worker.has_process;
+    }
+    const fs::path dir = path_from_utf8(worker.dir);
+    std::vector<std::string> cli_args = {
+        "-M", "upscale",
+        "--upscale-model", worker.model_path,
+        "-i", (dir / "input.png").string(),
+        "-o", (dir / "output.png").string()
+    };
+    try {
+        worker.process = ProcessManager::start_process(
+            worker.cli_exe_path, cli_args, "", true, false, worker.env_vars);
+    } catch (const std::exception& e) {
+        LOG(WARNING, "SDServer") << "Could not start upscale standby: " << e.what() << std::endl;
+        return false;
+    }
+    worker.has_process = worker.process.pid > 0;
+    return worker.has_process;
+}
+
+void UpscaleWorkerPool::stop_standby(Worker& worker) {
+    if (worker.has_process) {
+        ProcessManager::kill_process(worker.process);
+        worker.has_process = false;
+    }
+}
+
+void UpscaleWorkerPool::reap_exiting(Worker& worker, bool force) {
+    std::vector<ProcessHandle> still_running;
+    for (const auto& process : worker.exiting) {
+        if (force) {
+            ProcessManager::kill_process(process);
+        } else if (ProcessManager::reap_process(process) == -1 && ProcessManager::is_running(process)) {
+            still_running.push_back(process);
+        }
+    }
+    worker.exiting.swap(still_running);
+}
+
+void UpscaleWorkerPool::remove_worker_dir(Worker& worker) {
+    stop_standby(worker);
+    reap_exiting(worker, true);
+    if (!worker.dir.empty()) {
+        std::error_code ec;
+        fs::remove_all(path_from_utf8(worker.dir), ec);
+        worker.dir.clear();
+    }
+}
+
+bool UpscaleWorkerPool::run_standby(Worker& worker, const std::string& png, std::string& upscaled) {
+    upscaled.clear();
+#ifdef _WIN32
+    (void)worker;
+    (void)png;
+    return false;
+#else
+    const fs::path dir = path_from_utf8(worker.dir);
+    const std::string input_path = (dir / "input.png").string();
+    const std::string output_path = (dir / "output.png").string();
+    const auto started = std::chrono::steady_clock::now();
+
+    // A fresh standby may still be loading its libraries
+    int input_fd = -1;
+    while (true) {
+        input_fd = ::open(input_path.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+        if (input_fd >= 0) {
+            break;
+        }
+        if (errno != ENXIO || !ProcessManager::is_running(worker.process) ||
+            std::chrono::steady_clock::now() - started > STANDBY_OPEN_TIMEOUT) {
+            stop_standby(worker);
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    // sd-cli opens its output only once the image is upscaled
+    auto output = std::async(std::launch::async, read_all, output_path);
+
+    fcntl(input_fd, F_SETFL, fcntl(input_fd, F_GETFL) & ~O_NONBLOCK);
+    const bool sent = write_all(input_fd, png);
+    ::close(input_fd);
+
+    while (output.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready) {
+        const bool timed_out = std::chrono::steady_clock::now() - started > UPSCALE_TIMEOUT;
+        if (timed_out || !sent || !ProcessManager::is_running(worker.process)) {
+            if (timed_out) {
+                LOG(WARNING, "SDServer") << "Upscale standby timed out" << std::endl;
+            }
+            ProcessManager::terminate_process(worker.process);
+            // Release the reader if sd-cli never opened the output
+            int fd = ::open(output_path.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+    upscaled = output.get();
+
+    // A complete PNG is the result; sd-cli's teardown is reaped later so it
+    // does not delay the response
+    worker.exiting.push_back(worker.process);
+    worker.has_process = false;
+
+    if (!sent || !is_png(upscaled)) {
+        LOG(DEBUG, "SDServer") << "Upscale standby produced no image (" << upscaled.size()
+                               << " bytes)" << std::endl;
+        upscaled.clear();
+    }
+    return true;
+#endif
+}
+
+void UpscaleWorkerPool::reap_loop() {
+    const auto interval = std::min<std::chrono::seconds>(idle_timeout_, std::chrono::seconds(30));
+    while (running_) {
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_cv_.wait_for(lock, interval, [this]() { return !running_; });
+        }
+        if (!running_) {
+            return;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = workers_.begin(); it != workers_.end();) {
+            Worker& worker = *it->second;
+            std::unique_lock<std::mutex> worker_lock(worker.mutex, std::try_to_lock);
+            if (worker_lock.owns_lock()) {
+                reap_exiting(worker, false);
+            }
+            if (worker_lock.owns_lock() && now - worker.last_used > idle_timeout_) {
+                LOG(DEBUG, "SDServer") << "Stopping idle upscale worker for " << worker.model_path << std::endl;
+                remove_worker_dir(worker);
+                worker_lock.unlock();
+                it = workers_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+} // namespace backends
+} // namespace lemon
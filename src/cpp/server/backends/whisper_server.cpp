@@ -9,6 +9,7 @@
 #include "lemon/utils/path_utils.h"
 #include "lemon/utils/process_manager.h"
 #include "lemon/error_types.h"
+#include <algorithm>
 #include <iostream>
 #include <chrono>
 #include <filesystem>
@@ -256,7 +257,8 @@ void WhisperServer::load(const std::string& model_name,
     // Get whisper-server executable path
     std::string exe_path = BackendUtils::get_backend_binary_path(SPEC, whispercpp_backend);
 
-    // Choose a port
+    // Choose a port. whisper-server loads the model before it binds and has
+    // no Unix socket support, so it always uses TCP.
     port_ = choose_port();
     if (port_ == 0) {
         throw std::runtime_error("Failed to find an available port");
@@ -325,6 +327,20 @@ void WhisperServer::load(const std::string& model_name,
     }
 #endif
 
+    // The CPU build gets its own cores (-t from the custom arguments sizes them)
+    utils::CpuPlacement placement;
+    if (whispercpp_backend == "cpu") {
+        const std::vector<std::string> user_args = parse_custom_args(whispercpp_args);
+        int user_threads = 0;
+        auto t = std::find_if(user_args.begin(), user_args.end(), [](const std::string& arg) {
+            return arg == "-t" || arg == "--threads";
+        });
+        if (t != user_args.end() && t + 1 != user_args.end()) {
+            user_threads = std::atoi((t + 1)->c_str());
+        }
+        placement = reserve_cpu_placement(user_threads);
+    }
+
     // Launch the subprocess
     ProcessHandle started_handle = utils::ProcessManager::start_process(
         exe_path,
@@ -332,7 +348,8 @@ void WhisperServer::load(const std::string& model_name,
         "",     // working_dir (empty = current)
         is_debug(),  // inherit_output
         false,  // filter_health_logs
-        env_vars
+        env_vars,
+        placement
     );
     set_process_handle(started_handle);
 
@@ -343,7 +360,8 @@ void WhisperServer::load(const std::string& model_name,
     LOG(INFO, "WhisperServer") << "Process started with PID: " << started_handle.pid << std::endl;
 
     // Wait for server to be ready
-    if (!wait_for_ready("/health")) {
+    bool ready = wait_for_ready("/health");
+    if (!ready) {
         unload();
         throw std::runtime_error("whisper-server failed to start or become ready");
     }
@@ -563,7 +581,7 @@ json WhisperServer::forward_multipart_audio_request(const std::string& file_path
         fields.push_back(translate_field);
     }
 
-    const std::string url = "http://127.0.0.1:" + std::to_string(get_backend_port()) + "/inference";
+    const std::string url = get_base_url() + "/inference";
     LOG(DEBUG, "WhisperServer") << "Sending multipart request to " << url << std::endl;
 
     // Pass 0 so HttpClient falls back to its default timeout, which is kept in
@@ -654,7 +672,7 @@ json WhisperServer::forward_multipart_audio_data(const std::string& audio_data,
         fields.push_back(translate_field);
     }
 
-    const std::string url = "http://127.0.0.1:" + std::to_string(get_backend_port()) + "/inference";
+    const std::string url = get_base_url() + "/inference";
     LOG(DEBUG, "WhisperServer") << "Sending multipart request to " << url << " (direct data)" << std::endl;
 
     // See the note on the file-path variant above: 0 inherits the configured
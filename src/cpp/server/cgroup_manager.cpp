@@ -0,0 +1,375 @@
+#include "lemon/cgroup_manager.h"
+#include "lemon/utils/aixlog.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace lemon {
+
+static constexpr int64_t MIB = 1024 * 1024;
+
+CgroupLimits CgroupLimits::for_backend(bool interactive, int64_t expected_bytes) {
+    CgroupLimits limits;
+    limits.cpu_weight = interactive ? 400 : 50;
+    if (expected_bytes <= 0) {
+        return limits;
+    }
+    if (interactive) {
+        limits.memory_low = expected_bytes;
+    } else {
+        // Room for context, buffers and allocator slack on top of the weights.
+        // No memory.max: the expected size is an estimate, and a backend that
+        // outgrows it is throttled and downsized rather than OOM-killed.
+        limits.memory_high = expected_bytes + expected_bytes / 2 + 512 * MIB;
+    }
+    return limits;
+}
+
+CgroupMemoryEvents CgroupMemoryEvents::since(const CgroupMemoryEvents& before) const {
+    // A recreated leaf starts over from zero
+    auto grew = [](uint64_t now, uint64_t then) { return now > then ? now - then : 0; };
+    CgroupMemoryEvents delta;
+    delta.low = grew(low, before.low);
+    delta.high = grew(high, before.high);
+    delta.max = grew(max, before.max);
+    delta.oom = grew(oom, before.oom);
+    delta.oom_kill = grew(oom_kill, before.oom_kill);
+    return delta;
+}
+
+CgroupMemoryEvents parse_memory_events(const std::string& text) {
+    CgroupMemoryEvents events;
+    std::istringstream in(text);
+    std::string key;
+    uint64_t value = 0;
+    while (in >> key >> value) {
+        if (key == "low") events.low = value;
+        else if (key == "high") events.high = value;
+        else if (key == "max") events.max = value;
+        else if (key == "oom") events.oom = value;
+        else if (key == "oom_kill") events.oom_kill = value;
+    }
+    return events;
+}
+
+static std::string read_file(const fs::path& path) {
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+// cgroupfs reports a rejected value when the write is flushed
+static bool write_file(const fs::path& path, const std::string& value) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    out << value;
+    out.flush();
+    return out.good();
+}
+
+static bool has_controller(const std::string& controllers, const std::string& name) {
+    std::istringstream in(controllers);
+    std::string controller;
+    while (in >> controller) {
+        if (controller == name) return true;
+    }
+    return false;
+}
+
+// Finds lemond's cgroup and makes its subtree usable for backend leaves.
+// Returns "" when cgroup v2 is missing or the cgroup is not ours to manage.
+static std::string prepare_delegated_base() {
+#ifdef __linux__
+    const char* env = std::getenv("LEMONADE_CGROUPS");
+    if (env && std::string(env) == "0") {
+        return "";
+    }
+
+    // The unified (v2) hierarchy is the "0::" line
+    std::ifstream self("/proc/self/cgroup");
+    std::string line;
+    std::string relative;
+    while (std::getline(self, line)) {
+        if (line.rfind("0::", 0) == 0) {
+            relative = line.substr(3);
+        }
+    }
+    const fs::path root = "/sys/fs/cgroup";
+    if (relative.empty() || relative[0] != '/' || !fs::exists(root / "cgroup.controllers")) {
+        LOG(DEBUG, "Cgroups") << "cgroup v2 not available, backends share lemond's cgroup" << std::endl;
+        return "";
+    }
+
+    std::error_code ec;
+    fs::path base;
+    if (relative == "/") {
+        // The root cgroup may keep processes next to controller-enabled children
+        write_file(root / "cgroup.subtree_control", "+memory +cpu");
+        base = root / "lemonade";
+        fs::create_directory(base, ec);
+    } else {
+        // A cgroup with processes cannot hand controllers to its children,
+        // so lemond moves into a leaf of its own first
+        base = root / relative.substr(1);
+        fs::create_directory(base / "lemond", ec);
+        if (!ec && !write_file(base / "lemond" / "cgroup.procs", std::to_string(getpid()))) {
+            ec = std::make_error_code(std::errc::permission_denied);
+        }
+    }
+    if (ec) {
+        LOG(INFO, "Cgroups") << "Cannot manage cgroup " << base.string() << " (" << ec.message()
+                             << "), backends share lemond's cgroup" << std::endl;
+        return "";
+    }
+
+    const std::string controllers = read_file(base / "cgroup.controllers");
+    if (!has_controller(controllers, "memory")) {
+        LOG(INFO, "Cgroups") << "Memory controller not delegated to " << base.string()
+                             << ", backends share lemond's cgroup" << std::endl;
+        return "";
+    }
+    const bool cpu = has_controller(controllers, "cpu");
+    if (!write_file(base / "cgroup.subtree_control", cpu ? "+memory +cpu" : "+memory") &&
+        !(cpu && write_file(base / "cgroup.subtree_control", "+memory"))) {
+        // Other processes share the cgroup (e.g. the shell of a terminal
+        // session): put lemond back where it was
+        if (relative != "/" && write_file(base / "cgroup.procs", std::to_string(getpid()))) {
+            fs::remove(base / "lemond", ec);
+        }
+        LOG(INFO, "Cgroups") << "Cannot enable controllers in " << base.string()
+                             << ", backends share lemond's cgroup" << std::endl;
+        return "";
+    }
+    LOG(INFO, "Cgroups") << "Backends run in their own cgroups under " << base.string() << std::endl;
+    return base.string();
+#else
+    return "";
+#endif
+}
+
+CgroupManager::CgroupManager(std::string base_dir) : base_dir_(std::move(base_dir)) {
+#ifdef __linux__
+    if (available() && pipe2(wake_pipe_, O_CLOEXEC | O_NONBLOCK) == 0) {
+        running_ = true;
+        watcher_ = std::thread(&CgroupManager::watch_loop, this);
+    }
+#endif
+}
+
+CgroupManager::~CgroupManager() {
+    running_ = false;
+    wake_watcher();
+    if (watcher_.joinable()) {
+        watcher_.join();
+    }
+#ifdef __linux__
+    for (int fd : wake_pipe_) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+}
+
+CgroupManager& CgroupManager::global() {
+    static CgroupManager manager(prepare_delegated_base());
+    return manager;
+}
+
+void CgroupManager::set_pressure_callback(PressureCallback callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    pressure_callback_ = std::move(callback);
+}
+
+std::string CgroupManager::attach(const std::string& label, int pid, const CgroupLimits& limits) {
+    if (!available() || pid <= 0) {
+        return "";
+    }
+    remove_released_leaves();
+
+    std::string name = label;
+    for (char& c : name) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '.' && c != '_' && c != '-') {
+            c = '_';
+        }
+    }
+    const fs::path leaf = fs::path(base_dir_) / (name + "-" + std::to_string(pid));
+    std::error_code ec;
+    fs::create_directory(leaf, ec);
+    if (ec) {
+        LOG(WARNING, "Cgroups") << "Could not create cgroup for " << label << ": " << ec.message() << std::endl;
+        return "";
+    }
+
+    // Limits are best effort: files of controllers that are not delegated
+    // are missing and their writes fail
+    auto set = [&leaf](const char* file, const std::string& value) {
+        if (!write_file(leaf / file, value)) {
+            LOG(DEBUG, "Cgroups") << "Could not set " << file << "=" << value << " on " << leaf.string() << std::endl;
+        }
+    };
+    auto bytes = [](int64_t value) { return value < 0 ? std::string("max") : std::to_string(value); };
+    if (limits.memory_low > 0) {
+        set("memory.low", bytes(limits.memory_low));
+    }
+    set("memory.high", bytes(limits.memory_high));
+    set("memory.max", bytes(limits.memory_max));
+    set("memory.oom.group", "1");  // An OOM kill takes the whole backend down, not one of its threads
+    set("cpu.weight", std::to_string(limits.cpu_weight));
+
+    if (!write_file(leaf / "cgroup.procs", std::to_string(pid))) {
+        LOG(WARNING, "Cgroups") << "Could not move PID " << pid << " into " << leaf.string() << std::endl;
+        fs::remove(leaf, ec);
+        return "";
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        leaves_[leaf.string()] = Leaf{label, parse_memory_events(read_file(leaf / "memory.events"))};
+    }
+    wake_watcher();
+    LOG(DEBUG, "Cgroups") << label << " (PID " << pid << ") runs in " << leaf.string()
+                          << " (memory.high=" << bytes(limits.memory_high) << ", memory.max=" << bytes(limits.memory_max)
+                          << ", cpu.weight=" << limits.cpu_weight << ")" << std::endl;
+    return leaf.string();
+}
+
+void CgroupManager::release(const std::string& leaf) {
+    if (leaf.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        leaves_.erase(leaf);
+        released_.push_back(leaf);
+    }
+    wake_watcher();
+    remove_released_leaves();
+}
+
+// rmdir succeeds once the last process of the leaf has exited; until then
+// the leaf stays queued and the watcher retries
+void CgroupManager::remove_released_leaves() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    released_.erase(std::remove_if(released_.begin(), released_.end(), [](const std::string& leaf) {
+        std::error_code ec;
+        fs::remove(leaf, ec);
+        return !ec || !fs::exists(leaf);
+    }), released_.end());
+}
+
+int64_t CgroupManager::memory_current(const std::string& leaf) {
+    if (leaf.empty()) {
+        return -1;
+    }
+    const std::string text = read_file(fs::path(leaf) / "memory.current");
+    char* end = nullptr;
+    const long long value = std::strtoll(text.c_str(), &end, 10);
+    return end == text.c_str() ? -1 : static_cast<int64_t>(value);
+}
+
+void CgroupManager::wake_watcher() {
+#ifdef __linux__
+    if (wake_pipe_[1] >= 0) {
+        const char byte = 1;
+        (void)!write(wake_pipe_[1], &byte, 1);
+    }
+#endif
+}
+
+// memory.events raises POLLPRI on every counter change; the file is then
+// re-read through the same descriptor to re-arm the notification
+void CgroupManager::watch_loop() {
+#ifdef __linux__
+    std::map<std::string, int> fds;  // Owned by this thread
+    auto read_events = [](int fd) {
+        char buf[512];
+        lseek(fd, 0, SEEK_SET);
+        const ssize_t n = read(fd, buf, sizeof(buf) - 1);
+        return parse_memory_events(n > 0 ? std::string(buf, static_cast<size_t>(n)) : "");
+    };
+
+    while (running_) {
+        std::vector<pollfd> polled = {{wake_pipe_[0], POLLIN, 0}};
+        std::vector<std::string> polled_leaves = {""};
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto it = fds.begin(); it != fds.end();) {
+                if (leaves_.count(it->first) == 0) {
+                    close(it->second);
+                    it = fds.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            for (const auto& [leaf, state] : leaves_) {
+                if (fds.count(leaf) == 0) {
+                    const int fd = open((leaf + "/memory.events").c_str(), O_RDONLY | O_CLOEXEC);
+                    if (fd < 0) continue;
+                    fds[leaf] = fd;
+                    read_events(fd);
+                }
+                polled.push_back({fds[leaf], POLLPRI, 0});
+                polled_leaves.push_back(leaf);
+            }
+        }
+
+        const int ready = poll(polled.data(), polled.size(), 5000);
+        if (!running_) break;
+        if (ready > 0 && (polled[0].revents & POLLIN)) {
+            char drain[64];
+            while (read(wake_pipe_[0], drain, sizeof(drain)) > 0) {}
+        }
+
+        struct Fired {
+            std::string label;
+            std::string leaf;
+            CgroupMemoryEvents delta;
+        };
+        std::vector<Fired> fired;
+        if (ready > 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t i = 1; i < polled.size(); ++i) {
+                if (!(polled[i].revents & (POLLPRI | POLLERR))) continue;
+                const CgroupMemoryEvents now = read_events(polled[i].fd);
+                auto leaf = leaves_.find(polled_leaves[i]);
+                if (leaf == leaves_.end()) continue;
+                const CgroupMemoryEvents delta = now.since(leaf->second.seen);
+                leaf->second.seen = now;
+                if (delta.any()) {
+                    fired.push_back({leaf->second.label, leaf->first, delta});
+                }
+            }
+        }
+        if (!fired.empty()) {
+            std::lock_guard<std::mutex> lock(callback_mutex_);
+            for (const auto& [label, leaf, delta] : fired) {
+                LOG(DEBUG, "Cgroups") << label << " memory events: low+" << delta.low << " high+" << delta.high
+                                      << " max+" << delta.max << " oom_kill+" << delta.oom_kill << std::endl;
+                if (pressure_callback_) {
+                    pressure_callback_(label, leaf, delta);
+                }
+            }
+        }
+        remove_released_leaves();
+    }
+    for (const auto& [leaf, fd] : fds) {
+        close(fd);
+    }
+#endif
+}
+
+} // namespace lemon
@@ -11,6 +11,7 @@
 #include <set>
 #include <string>
 
+#include "lemon/collection_tool_runner.h"
 #include "lemon/logging_config.h"
 #include "lemon/model_types.h"
 #include "lemon/router.h"
@@ -463,56 +464,34 @@ CollectionOrchestrator::ToolSet CollectionOrchestrator::build_tools(const ModelI
 }
 
 bool CollectionOrchestrator::execute_tool(const std::string& tool_name, const std::string& model,
-                                          const json& args, std::vector<Artifact>& artifacts,
-                                          const std::string& source_image_b64,
+                                          const json& args, const std::string& source_image_b64,
                                           const std::string& source_image_mime,
-                                          int& produced_index, std::string& success_text) {
-    produced_index = -1;
+                                          std::optional<Artifact>& produced, std::string& success_text) {
+    produced.reset();
 
     if (tool_name == "generate_image" || tool_name == "edit_image") {
         const std::string prompt = args.value("prompt", "");
 
         if (tool_name == "edit_image") {
-            // Source: most recent generated image, else the seeded history image.
-            std::string img_b64, img_mime;
-            for (auto it = artifacts.rbegin(); it != artifacts.rend(); ++it) {
-                if (it->type == "image") {
-                    img_b64 = it->data;
-                    img_mime = it->mime;
-                    break;
-                }
-            }
-            if (img_b64.empty()) {
-                img_b64 = source_image_b64;
-                img_mime = source_image_mime.empty() ? "image/png" : source_image_mime;
-            }
-            if (img_b64.empty()) {
+            // Source: most recent generated image, else the seeded history image
+            // (resolved by the caller, which knows the call order).
+            if (source_image_b64.empty()) {
                 throw std::runtime_error("Image edit requested, but no previous image is available as a source.");
             }
 
             json req = {{"model", model}, {"prompt", prompt}, {"response_format", "b64_json"},
-                        {"n", 1}, {"image_data", img_b64}, {"image_filename", "image.png"}};
+                        {"n", 1}, {"image_data", source_image_b64}, {"image_filename", "image.png"}};
             const std::string edit_size = resolve_explicit_image_size(args);
             if (!edit_size.empty()) req["size"] = edit_size;
             copy_optional_image_args(args, req);
-            LOG(INFO, "Collection") << "image_edits: editing source image (" << img_b64.size()
-                                    << " b64 chars)" << std::endl;
+            LOG(INFO, "Collection") << "image_edits: editing source image (" << source_image_b64.size()
+                                    << " b64 chars, " << (source_image_mime.empty() ? "image/png" : source_image_mime)
+                                    << ")" << std::endl;
             json resp = router_.image_edits(req);
             const std::string b64 = extract_b64(resp);
             if (b64.empty()) throw std::runtime_error(backend_error_message(resp, "Image edit failed"));
 
-            // Replace the last generated image this turn, else append.
-            int last = -1;
-            for (int i = static_cast<int>(artifacts.size()) - 1; i >= 0; --i) {
-                if (artifacts[i].type == "image") { last = i; break; }
-            }
-            if (last >= 0) {
-                artifacts[last] = Artifact{"image", b64, "image/png"};
-                produced_index = last;
-            } else {
-                artifacts.push_back(Artifact{"image", b64, "image/png"});
-                produced_index = static_cast<int>(artifacts.size()) - 1;
-            }
+            produced = Artifact{"image", b64, "image/png"};
             success_text = "Image edited successfully.";
             return true;
         }
@@ -525,8 +504,7 @@ bool CollectionOrchestrator::execute_tool(const std::string& tool_name, const st
         json resp = router_.image_generations(req);
         const std::string b64 = extract_b64(resp);
         if (b64.empty()) throw std::runtime_error(backend_error_message(resp, "Image generation failed"));
-        artifacts.push_back(Artifact{"image", b64, "image/png"});
-        produced_index = static_cast<int>(artifacts.size()) - 1;
+        produced = Artifact{"image", b64, "image/png"};
         success_text = "Image generated successfully.";
         return true;
     }
@@ -552,8 +530,7 @@ bool CollectionOrchestrator::execute_tool(const std::string& tool_name, const st
         router_.audio_speech(req, sink);
         if (buffer.empty()) throw std::runtime_error("Text-to-speech produced no audio");
 
-        artifacts.push_back(Artifact{"audio", utils::JsonUtils::base64_encode(buffer), "audio/mpeg"});
-        produced_index = static_cast<int>(artifacts.size()) - 1;
+        produced = Artifact{"audio", utils::JsonUtils::base64_encode(buffer), "audio/mpeg"};
         success_text = "Audio generated successfully.";
         return true;
     }
@@ -745,42 +722,100 @@ CollectionOrchestrator::LoopResult CollectionOrchestrator::run_loop(
 
         llm_messages.push_back(assistant_msg);
 
+        // Independent calls run concurrently; edit_image waits for every image
+        // call before it. See CollectionToolRunner.
+        struct PendingCall {
+            std::string id;
+            std::string gen_key;
+            std::string skip_text;       // Non-empty: answered without running
+        };
+        std::vector<PendingCall> pending;
+        std::vector<CollectionToolRunner::Call> calls;
+        std::set<std::string> turn_image_request_keys;
         for (const auto& tc : omni_calls) {
-            const std::string name = tc.value("function", json::object()).value("name", "");
-            const std::string model = toolset.tool_models.count(name) ? toolset.tool_models[name] : "";
-            json args = json::object();
+            PendingCall meta;
+            CollectionToolRunner::Call call;
+            meta.id = tc.value("id", "");
+            call.name = tc.value("function", json::object()).value("name", "");
+            call.model = toolset.tool_models.count(call.name) ? toolset.tool_models[call.name] : "";
             try {
-                args = json::parse(tc["function"].value("arguments", "{}"));
+                call.args = json::parse(tc["function"].value("arguments", "{}"));
             } catch (const std::exception&) {}
 
-            std::string success_text;
-            int produced_index = -1;
-            const std::string gen_key = (name == "generate_image") ? image_request_key(args) : "";
-            if (model.empty()) {
-                success_text = "Error: tool '" + name + "' has no available model";
-            } else if (name == "generate_image" && generated_image_request_keys.count(gen_key)) {
-                success_text = "Duplicate image generation skipped because this exact image request was already generated for this turn.";
-            } else {
-                try {
-                    LOG(INFO, "Collection") << "Tool call: " << name << " -> " << model << std::endl;
-                    ensure_loaded_(model);
-                    execute_tool(name, model, args, artifacts, source_image_b64, source_image_mime,
-                                 produced_index, success_text);
-                    if (name == "generate_image" && produced_index >= 0) {
-                        generated_image_request_keys.insert(gen_key);
+            meta.gen_key = (call.name == "generate_image") ? image_request_key(call.args) : "";
+            if (call.model.empty()) {
+                meta.skip_text = "Error: tool '" + call.name + "' has no available model";
+            } else if (call.name == "generate_image" &&
+                       (generated_image_request_keys.count(meta.gen_key) ||
+                        !turn_image_request_keys.insert(meta.gen_key).second)) {
+                meta.skip_text = "Duplicate image generation skipped because this exact image request was already generated for this turn.";
+            } else if (call.name == "edit_image") {
+                for (size_t d = 0; d < calls.size(); ++d) {
+                    if (!calls[d].skip &&
+                        (calls[d].name == "generate_image" || calls[d].name == "edit_image")) {
+                        call.deps.push_back(d);
                     }
-                } catch (const std::exception& e) {
-                    success_text = std::string("Error: ") + e.what();
-                    produced_index = -1;
                 }
             }
-            if (produced_index >= 0 && produced_index < static_cast<int>(artifacts.size())) {
-                on_artifact(artifacts[produced_index]);
+            call.skip = !meta.skip_text.empty();
+            pending.push_back(std::move(meta));
+            calls.push_back(std::move(call));
+        }
+
+        // Image this turn's edits fall back to when no earlier call made one.
+        std::string prior_image_b64 = source_image_b64;
+        std::string prior_image_mime = source_image_mime;
+        for (auto it = artifacts.rbegin(); it != artifacts.rend(); ++it) {
+            if (it->type == "image") {
+                prior_image_b64 = it->data;
+                prior_image_mime = it->mime;
+                break;
             }
+        }
+        if (prior_image_mime.empty()) prior_image_mime = "image/png";
+
+        CollectionToolRunner runner(
+            ensure_loaded_,
+            [this](const CollectionToolRunner::Call& call, const std::string& source_b64,
+                   const std::string& source_mime, std::optional<Artifact>& produced,
+                   std::string& text) {
+                return execute_tool(call.name, call.model, call.args, source_b64, source_mime,
+                                    produced, text);
+            });
+        runner.run(calls, prior_image_b64, prior_image_mime,
+                   [&](size_t i, const CollectionToolRunner::Outcome& out) {
+            const CollectionToolRunner::Call& call = calls[i];
+            json timing = out.timing;
+            timing["iteration"] = iteration;
+            std::string success_text = pending[i].skip_text;
+            if (!call.skip) {
+                success_text = out.text;
+
+                int produced_index = -1;
+                if (out.produced) {
+                    // An edit replaces the last image this turn, else appends.
+                    if (call.name == "edit_image") {
+                        for (int j = static_cast<int>(artifacts.size()) - 1; j >= 0; --j) {
+                            if (artifacts[j].type == "image") { produced_index = j; break; }
+                        }
+                    }
+                    if (produced_index >= 0) {
+                        artifacts[produced_index] = *out.produced;
+                    } else {
+                        artifacts.push_back(*out.produced);
+                        produced_index = static_cast<int>(artifacts.size()) - 1;
+                    }
+                    if (call.name == "generate_image") {
+                        generated_image_request_keys.insert(pending[i].gen_key);
+                    }
+                    on_artifact(artifacts[produced_index]);
+                }
+            }
+            result.tool_timings.push_back(std::move(timing));
             llm_messages.push_back({{"role", "tool"},
-                                    {"tool_call_id", tc.value("id", "")},
+                                    {"tool_call_id", pending[i].id},
                                     {"content", success_text}});
-        }
+        });
 
         // Mixed/app turn: fold omni media into content (already collected in
         // `artifacts`) and hand the app calls back to the caller to resume.
@@ -836,6 +871,10 @@ json CollectionOrchestrator::chat_completion(const json& request, const ModelInf
     response["choices"] = json::array({{{"index", 0},
                                         {"message", message},
                                         {"finish_reason", lr.finish_reason}}});
+    // Not part of the OpenAI schema, hence the x_ extension prefix
+    if (!lr.tool_timings.empty()) {
+        response["x_tool_timings"] = std::move(lr.tool_timings);
+    }
     return response;
 }
 
@@ -859,6 +898,7 @@ CollectionOrchestrator::ChatParts CollectionOrchestrator::chat_completion_parts(
     parts.artifacts = std::move(lr.artifacts);
     parts.app_tool_calls = std::move(lr.app_tool_calls);
     parts.finish_reason = std::move(lr.finish_reason);
+    parts.tool_timings = std::move(lr.tool_timings);
     return parts;
 }
 
@@ -869,7 +909,7 @@ void CollectionOrchestrator::chat_completion_stream(const json& request,
     const std::string id = new_completion_id();
     const long created = static_cast<long>(std::time(nullptr));
 
-    auto send = [&](const json& delta, const json& finish_reason) {
+    auto send = [&](const json& delta, const json& finish_reason, json tool_timings = nullptr) {
         json chunk = {{"id", id},
                       {"object", "chat.completion.chunk"},
                       {"created", created},
@@ -877,6 +917,9 @@ void CollectionOrchestrator::chat_completion_stream(const json& request,
                       {"choices", json::array({{{"index", 0},
                                                 {"delta", delta},
                                                 {"finish_reason", finish_reason}}})}};
+        if (tool_timings.is_array() && !tool_timings.empty()) {
+            chunk["x_tool_timings"] = std::move(tool_timings);
+        }
         const std::string frame = "data: " + chunk.dump() + "\n\n";
         sink.write(frame.c_str(), frame.size());
     };
@@ -945,7 +988,7 @@ void CollectionOrchestrator::chat_completion_stream(const json& request,
         }
         send(json{{"tool_calls", std::move(stream_tool_calls)}}, nullptr);
     }
-    send(json::object(), lr.finish_reason);
+    send(json::object(), lr.finish_reason, std::move(lr.tool_timings));
     send_done();
 }
 
@@ -0,0 +1,89 @@
+#include "lemon/collection_tool_runner.h"
+
+#include <chrono>
+#include <future>
+#include <utility>
+#include <lemon/utils/aixlog.hpp>
+
+namespace lemon {
+
+namespace {
+
+double elapsed_ms(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+} // namespace
+
+CollectionToolRunner::CollectionToolRunner(EnsureLoadedFn ensure_loaded, ExecuteFn execute)
+    : ensure_loaded_(std::move(ensure_loaded)), execute_(std::move(execute)) {}
+
+void CollectionToolRunner::run(const std::vector<Call>& calls, const std::string& prior_b64,
+                               const std::string& prior_mime, const CommitFn& commit) const {
+    // Workers own copies of everything they touch, dependency futures
+    // included, so none of them refers back into this frame.
+    std::vector<std::shared_future<Outcome>> outcomes(calls.size());
+    for (size_t i = 0; i < calls.size(); ++i) {
+        if (calls[i].skip) continue;
+        std::vector<std::shared_future<Outcome>> deps;
+        for (size_t d : calls[i].deps) {
+            if (d < i && outcomes[d].valid()) deps.push_back(outcomes[d]);
+        }
+        outcomes[i] = std::async(std::launch::async,
+                                 [call = calls[i], deps = std::move(deps), prior_b64, prior_mime,
+                                  ensure_loaded = ensure_loaded_, execute = execute_]() {
+            Outcome out;
+            auto started = std::chrono::steady_clock::now();
+
+            std::string edit_b64 = prior_b64;
+            std::string edit_mime = prior_mime;
+            for (auto d = deps.rbegin(); d != deps.rend(); ++d) {
+                const Outcome& dep = d->get();
+                if (dep.produced && dep.produced->type == "image") {
+                    edit_b64 = dep.produced->data;
+                    edit_mime = dep.produced->mime;
+                    break;
+                }
+            }
+            auto ready = std::chrono::steady_clock::now();
+
+            try {
+                LOG(INFO, "Collection") << "Tool call: " << call.name << " -> " << call.model << std::endl;
+                ensure_loaded(call.model);
+                auto loaded = std::chrono::steady_clock::now();
+                out.load_ms = elapsed_ms(ready, loaded);
+                out.ok = execute(call, edit_b64, edit_mime, out.produced, out.text);
+                out.execute_ms = elapsed_ms(loaded, std::chrono::steady_clock::now());
+            } catch (const std::exception& e) {
+                out.ok = false;
+                out.produced.reset();
+                out.text = std::string("Error: ") + e.what();
+            }
+            out.wait_ms = elapsed_ms(started, ready);
+            out.timing = {{"tool", call.name}, {"model", call.model},
+                          {"status", out.ok ? "ok" : "error"}, {"wait_ms", out.wait_ms},
+                          {"load_ms", out.load_ms}, {"execute_ms", out.execute_ms}};
+            return out;
+        }).share();
+    }
+
+    try {
+        for (size_t i = 0; i < calls.size(); ++i) {
+            if (calls[i].skip) {
+                Outcome skipped;
+                skipped.timing = {{"tool", calls[i].name}, {"model", calls[i].model},
+                                  {"status", "skipped"}};
+                commit(i, skipped);
+                continue;
+            }
+            commit(i, outcomes[i].get());
+        }
+    } catch (...) {
+        for (const auto& outcome : outcomes) {
+            if (outcome.valid()) outcome.wait();
+        }
+        throw;
+    }
+}
+
+} // namespace lemon
@@ -0,0 +1,303 @@
+#include "lemon/cpu_placement.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <set>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace lemon {
+
+using json = nlohmann::json;
+
+static std::string read_first_line(const fs::path& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+static int read_int(const fs::path& path, int fallback) {
+    const std::string text = read_first_line(path);
+    if (text.empty()) {
+        return fallback;
+    }
+    char* end = nullptr;
+    const long value = std::strtol(text.c_str(), &end, 10);
+    return end == text.c_str() ? fallback : static_cast<int>(value);
+}
+
+std::vector<int> parse_cpu_list(const std::string& list) {
+    std::set<int> cpus;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        range.erase(std::remove_if(range.begin(), range.end(), ::isspace), range.end());
+        if (range.empty()) {
+            continue;
+        }
+        const size_t dash = range.find('-');
+        char* end = nullptr;
+        const long first = std::strtol(range.c_str(), &end, 10);
+        if (end == range.c_str() || first < 0) {
+            return {};
+        }
+        long last = first;
+        if (dash != std::string::npos) {
+            const char* tail = range.c_str() + dash + 1;
+            last = std::strtol(tail, &end, 10);
+            if (end == tail || last < first) {
+                return {};
+            }
+        }
+        for (long cpu = first; cpu <= last; ++cpu) {
+            cpus.insert(static_cast<int>(cpu));
+        }
+    }
+    return {cpus.begin(), cpus.end()};
+}
+
+std::string format_cpu_list(std::vector<int> cpus) {
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    std::string out;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+            ++j;
+        }
+        if (!out.empty()) out += ",";
+        out += std::to_string(cpus[i]);
+        if (j > i) out += "-" + std::to_string(cpus[j]);
+        i = j + 1;
+    }
+    return out;
+}
+
+CpuTopology CpuTopology::read_sysfs(const std::string& sysfs_root) {
+    CpuTopology topology;
+    const fs::path root(sysfs_root);
+    const std::vector<int> online = parse_cpu_list(read_first_line(root / "cpu" / "online"));
+    if (online.empty()) {
+        return topology;
+    }
+
+    // Memory-only nodes have an empty cpulist and are left out
+    std::map<int, int> node_of_cpu;
+    std::set<int> nodes;
+    std::error_code ec;
+    for (fs::directory_iterator it(root / "node", ec), end; !ec && it != end; it.increment(ec)) {
+        const std::string name = it->path().filename().string();
+        if (name.rfind("node", 0) != 0 || name.size() == 4 ||
+            !std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+            continue;
+        }
+        const int node = std::stoi(name.substr(4));
+        for (int cpu : parse_cpu_list(read_first_line(it->path() / "cpulist"))) {
+            node_of_cpu[cpu] = node;
+            nodes.insert(node);
+        }
+    }
+    topology.node_count = nodes.empty() ? 1 : static_cast<int>(nodes.size());
+
+    std::map<std::pair<int, int>, size_t> core_index;  // (package, core_id) -> index
+    for (int cpu : online) {
+        const fs::path cpu_topology = root / "cpu" / ("cpu" + std::to_string(cpu)) / "topology";
+        const int package = read_int(cpu_topology / "physical_package_id", 0);
+        // Without a core_id every CPU counts as its own core
+        const int core_id = read_int(cpu_topology / "core_id", -1 - cpu);
+        auto it = node_of_cpu.find(cpu);
+        const int node = it != node_of_cpu.end() ? it->second : 0;
+
+        auto [entry, inserted] = core_index.emplace(std::make_pair(package, core_id), topology.cores.size());
+        if (inserted) {
+            topology.cores.push_back(CpuCore{package, node, {}});
+        }
+        topology.cores[entry->second].cpus.push_back(cpu);
+    }
+
+    std::sort(topology.cores.begin(), topology.cores.end(), [](const CpuCore& a, const CpuCore& b) {
+        return a.node != b.node ? a.node < b.node : a.cpus.front() < b.cpus.front();
+    });
+    return topology;
+}
+
+int CpuTopology::cores_on_node(int node) const {
+    return static_cast<int>(std::count_if(cores.begin(), cores.end(),
+                                          [node](const CpuCore& c) { return c.node == node; }));
+}
+
+int CpuTopology::largest_node_cores() const {
+    std::map<int, int> per_node;
+    int largest = 0;
+    for (const auto& core : cores) {
+        largest = std::max(largest, ++per_node[core.node]);
+    }
+    return largest;
+}
+
+CpuPlacementPlanner::CpuPlacementPlanner(CpuTopology topology, bool enabled)
+    : topology_(std::move(topology)),
+      enabled_(enabled && !topology_.cores.empty()),
+      core_taken_(topology_.cores.size(), false) {}
+
+CpuPlacementPlanner& CpuPlacementPlanner::global() {
+    static CpuPlacementPlanner planner = [] {
+        CpuTopology topology = CpuTopology::read_sysfs();
+        bool enabled = false;
+#ifdef __linux__
+        const char* env = std::getenv("LEMONADE_CPU_PLACEMENT");
+        if (env && std::string(env) == "0") {
+            enabled = false;
+        } else if (env && std::string(env) == "1") {
+            enabled = true;
+        } else {
+            enabled = topology.node_count > 1;
+        }
+#endif
+        return CpuPlacementPlanner(std::move(topology), enabled);
+    }();
+    return planner;
+}
+
+int CpuPlacementPlanner::core_demand(const std::string& recipe, int threads, int replica_count) const {
+    const int total = static_cast<int>(topology_.cores.size());
+    if (total == 0) {
+        return 0;
+    }
+    const bool compute_heavy = recipe == "llamacpp" || recipe == "sd-cpp";
+    const bool speech = recipe == "whispercpp" || recipe == "kokoro" || recipe == "moonshine";
+    if (!compute_heavy && !speech) {
+        return 0;
+    }
+    // One physical core per compute thread; SMT siblings come along
+    if (threads > 0) {
+        return std::min(threads, total);
+    }
+    if (speech) {
+        return std::min(4, total);
+    }
+    return std::max(1, topology_.largest_node_cores() / std::max(1, replica_count));
+}
+
+utils::CpuPlacement CpuPlacementPlanner::placement_for(const Assignment& assignment) const {
+    utils::CpuPlacement placement;
+    for (size_t index : assignment.cores) {
+        const auto& cpus = topology_.cores[index].cpus;
+        placement.cpus.insert(placement.cpus.end(), cpus.begin(), cpus.end());
+    }
+    std::sort(placement.cpus.begin(), placement.cpus.end());
+    placement.physical_cores = static_cast<int>(assignment.cores.size());
+    placement.numa_node = assignment.numa_node;
+    return placement;
+}
+
+utils::CpuPlacement CpuPlacementPlanner::reserve(uint64_t owner, const std::string& label, int cores) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto previous = assignments_.find(owner);
+    if (previous != assignments_.end()) {
+        for (size_t index : previous->second.cores) {
+            core_taken_[index] = false;
+        }
+        assignments_.erase(previous);
+    }
+    if (!enabled_ || cores <= 0) {
+        return {};
+    }
+
+    std::map<int, std::vector<size_t>> free_by_node;
+    size_t total_free = 0;
+    for (size_t i = 0; i < topology_.cores.size(); ++i) {
+        if (!core_taken_[i]) {
+            free_by_node[topology_.cores[i].node].push_back(i);
+            ++total_free;
+        }
+    }
+
+    const size_t wanted = std::min(static_cast<size_t>(cores), topology_.cores.size());
+    Assignment assignment;
+    assignment.label = label;
+
+    int best_node = -1;
+    size_t best_free = std::numeric_limits<size_t>::max();
+    for (const auto& [node, free] : free_by_node) {
+        if (free.size() >= wanted && free.size() < best_free) {
+            best_node = node;
+            best_free = free.size();
+        }
+    }
+
+    if (best_node >= 0) {
+        const auto& free = free_by_node[best_node];
+        assignment.cores.assign(free.begin(), free.begin() + wanted);
+        assignment.numa_node = best_node;
+    } else {
+        if (total_free == 0 || total_free * 2 < wanted) {
+            return {};
+        }
+        // Span nodes, most free first; memory prefers the largest share
+        std::vector<std::pair<int, std::vector<size_t>>> nodes(free_by_node.begin(), free_by_node.end());
+        std::stable_sort(nodes.begin(), nodes.end(), [](const auto& a, const auto& b) {
+            return a.second.size() > b.second.size();
+        });
+        const size_t take_total = std::min(wanted, total_free);
+        for (const auto& [node, free] : nodes) {
+            if (assignment.cores.size() == take_total) break;
+            if (assignment.numa_node < 0) {
+                assignment.numa_node = node;
+            }
+            const size_t take = std::min(free.size(), take_total - assignment.cores.size());
+            assignment.cores.insert(assignment.cores.end(), free.begin(), free.begin() + take);
+        }
+    }
+
+    for (size_t index : assignment.cores) {
+        core_taken_[index] = true;
+    }
+    utils::CpuPlacement placement = placement_for(assignment);
+    assignments_[owner] = std::move(assignment);
+    return placement;
+}
+
+void CpuPlacementPlanner::release(uint64_t owner) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = assignments_.find(owner);
+    if (it == assignments_.end()) {
+        return;
+    }
+    for (size_t index : it->second.cores) {
+        core_taken_[index] = false;
+    }
+    assignments_.erase(it);
+}
+
+json CpuPlacementPlanner::to_json() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    json assignments = json::array();
+    for (const auto& [owner, assignment] : assignments_) {
+        const utils::CpuPlacement placement = placement_for(assignment);
+        assignments.push_back({
+            {"label", assignment.label},
+            {"cpus", format_cpu_list(placement.cpus)},
+            {"cores", placement.physical_cores},
+            {"numa_node", placement.numa_node}
+        });
+    }
+    std::sort(assignments.begin(), assignments.end(), [](const json& a, const json& b) {
+        return a["label"].get<std::string>() < b["label"].get<std::string>();
+    });
+    return {
+        {"enabled", enabled_},
+        {"nodes", topology_.node_count},
+        {"cores", topology_.cores.size()},
+        {"free_cores", std::count(core_taken_.begin(), core_taken_.end(), false)},
+        {"assignments", assignments}
+    };
+}
+
+} // namespace lemon
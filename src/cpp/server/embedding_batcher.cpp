@@ -0,0 +1,366 @@
+#include "lemon/embedding_batcher.h"
+#include "lemon/error_types.h"
+#include "lemon/utils/aixlog.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace lemon {
+
+namespace {
+
+// Classifies an embeddings `input` so that only requests of the same shape are
+// combined: llama.cpp accepts either a list of strings or a list of token
+// arrays, but mixing the two in one call is not portable across backends.
+std::string input_shape(const json& input) {
+    if (input.is_string()) {
+        return "text";
+    }
+    if (!input.is_array() || input.empty()) {
+        return "";
+    }
+    if (std::all_of(input.begin(), input.end(), [](const json& v) { return v.is_string(); })) {
+        return "text";
+    }
+    if (std::all_of(input.begin(), input.end(), [](const json& v) { return v.is_number_integer(); })) {
+        return "tokens";  // A single pre-tokenized input
+    }
+    if (std::all_of(input.begin(), input.end(), [](const json& v) { return v.is_array(); })) {
+        return "tokens";
+    }
+    return "";
+}
+
+// With coalescing enabled, rerank results go back best-first whether or not
+// the request shared its batch, matching the Jina/Cohere rerank APIs
+void sort_by_relevance(json& results) {
+    std::stable_sort(results.begin(), results.end(), [](const json& a, const json& b) {
+        return a.value("relevance_score", 0.0) > b.value("relevance_score", 0.0);
+    });
+}
+
+json sorted_rerank_response(json response) {
+    if (response.is_object() && !response.contains("error") &&
+        response.contains("results") && response["results"].is_array()) {
+        sort_by_relevance(response["results"]);
+    }
+    return response;
+}
+
+const std::vector<double> kBatchSizeBuckets = {1, 2, 4, 8, 16, 32, 64, 128};
+const std::vector<double> kAddedLatencyBuckets = {0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25};
+
+} // namespace
+
+EmbeddingBatcher::KindStats::KindStats()
+    : batch_size(kBatchSizeBuckets), added_latency_seconds(kAddedLatencyBuckets) {}
+
+EmbeddingBatcher::EmbeddingBatcher() = default;
+
+std::string EmbeddingBatcher::group_key(Kind kind, const json& request) {
+    json key = request;
+    if (kind == Kind::Embeddings) {
+        key["__shape"] = input_shape(request.value("input", json()));
+        key.erase("input");
+        key["__kind"] = "embeddings";
+    } else {
+        // top_n is applied per caller after the scatter, so it does not split groups.
+        key.erase("documents");
+        key.erase("top_n");
+        key["__kind"] = "reranking";
+    }
+    return key.dump();
+}
+
+bool EmbeddingBatcher::extract_items(Kind kind, const json& request, std::vector<json>& items) {
+    items.clear();
+    if (kind == Kind::Embeddings) {
+        if (!request.contains("input")) {
+            return false;
+        }
+        const json& input = request["input"];
+        const std::string shape = input_shape(input);
+        if (shape.empty()) {
+            return false;
+        }
+        if (input.is_string() || (shape == "tokens" && input.front().is_number_integer())) {
+            items.push_back(input);
+        } else {
+            items.assign(input.begin(), input.end());
+        }
+        return true;
+    }
+
+    if (!request.contains("query") || !request.contains("documents") ||
+        !request["documents"].is_array() || request["documents"].empty()) {
+        return false;
+    }
+    items.assign(request["documents"].begin(), request["documents"].end());
+    return true;
+}
+
+long EmbeddingBatcher::estimate_tokens(const json& item) {
+    // Rough 4-bytes-per-token estimate; only used for the batch budget and for
+    // apportioning the backend's usage counts, never for billing-grade numbers.
+    if (item.is_string()) {
+        return std::max<long>(1, static_cast<long>(item.get_ref<const std::string&>().size() / 4));
+    }
+    if (item.is_array()) {
+        return std::max<long>(1, static_cast<long>(item.size()));
+    }
+    return std::max<long>(1, static_cast<long>(item.dump().size() / 4));
+}
+
+json EmbeddingBatcher::submit(Kind kind, const json& request, const Limits& limits,
+                              const DispatchFn& dispatch) {
+    Entry entry;
+    entry.request = &request;
+    if (limits.window_ms <= 0 || !extract_items(kind, request, entry.items)) {
+        // Coalescing off (or nothing to coalesce): backend order, as before
+        return dispatch(request);
+    }
+
+    long query_tokens = 0;
+    if (kind == Kind::Reranking) {
+        // llama.cpp scores each (query, document) pair, so the query is paid per document.
+        query_tokens = estimate_tokens(request["query"]);
+    }
+    for (const auto& item : entry.items) {
+        entry.weight += estimate_tokens(item) + query_tokens;
+    }
+    entry.enqueued = std::chrono::steady_clock::now();
+
+    const std::string key = group_key(kind, request);
+    const size_t max_items = static_cast<size_t>(std::max(1, limits.max_batch_size));
+    const long max_tokens = std::max(1, limits.max_batch_tokens);
+
+    std::shared_ptr<Batch> batch;
+    bool leader = false;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stats_for(kind).requests_total++;
+
+        auto it = open_batches_.find(key);
+        if (it != open_batches_.end()) {
+            Batch& open = *it->second;
+            if (open.item_count + entry.items.size() <= max_items &&
+                open.token_count + entry.weight <= max_tokens) {
+                batch = it->second;
+            } else {
+                // Would overflow: flush the open batch now and start a new one.
+                open.closed = true;
+                open.cv.notify_all();
+                open_batches_.erase(it);
+            }
+        }
+        if (!batch) {
+            batch = std::make_shared<Batch>();
+            open_batches_[key] = batch;
+            leader = true;
+        }
+
+        entry.offset = batch->item_count;
+        batch->entries.push_back(&entry);
+        batch->item_count += entry.items.size();
+        batch->token_count += entry.weight;
+
+        if (!batch->closed && (batch->item_count >= max_items || batch->token_count >= max_tokens)) {
+            batch->closed = true;
+            auto current = open_batches_.find(key);
+            if (current != open_batches_.end() && current->second == batch) {
+                open_batches_.erase(current);
+            }
+            batch->cv.notify_all();
+        }
+
+        if (leader) {
+            auto deadline = entry.enqueued + std::chrono::milliseconds(limits.window_ms);
+            batch->cv.wait_until(lock, deadline, [&] { return batch->closed; });
+            if (!batch->closed) {
+                batch->closed = true;
+                auto current = open_batches_.find(key);
+                if (current != open_batches_.end() && current->second == batch) {
+                    open_batches_.erase(current);
+                }
+            }
+        } else {
+            batch->cv.wait(lock, [&] { return entry.done; });
+        }
+    }
+
+    if (leader) {
+        run_batch(kind, batch, dispatch);
+    }
+
+    if (entry.error) {
+        std::rethrow_exception(entry.error);
+    }
+    return std::move(entry.response);
+}
+
+void EmbeddingBatcher::run_batch(Kind kind, const std::shared_ptr<Batch>& batch,
+                                 const DispatchFn& dispatch) {
+    // The batch is closed and detached from open_batches_, so its entry list is
+    // stable and only this (leader) thread touches the entries until done=true.
+    auto dispatch_time = std::chrono::steady_clock::now();
+    KindStats& stats = stats_for(kind);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats.batches_total++;
+    }
+    stats.batch_size.observe(static_cast<double>(batch->entries.size()));
+    for (const Entry* e : batch->entries) {
+        stats.added_latency_seconds.observe(
+            std::chrono::duration<double>(dispatch_time - e->enqueued).count());
+    }
+
+    try {
+        if (batch->entries.size() == 1) {
+            // Nothing to combine: forward the caller's request untouched.
+            json response = dispatch(*batch->entries.front()->request);
+            batch->entries.front()->response =
+                kind == Kind::Reranking ? sorted_rerank_response(std::move(response)) : std::move(response);
+        } else {
+            LOG(DEBUG, "Router") << "Coalesced " << batch->entries.size() << " "
+                                 << (kind == Kind::Embeddings ? "embeddings" : "rerank")
+                                 << " requests (" << batch->item_count << " inputs) into one backend call"
+                                 << std::endl;
+            json response = dispatch(build_combined_request(kind, *batch));
+            scatter(kind, *batch, response);
+        }
+    } catch (...) {
+        std::exception_ptr error = std::current_exception();
+        for (Entry* e : batch->entries) {
+            e->error = error;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Entry* e : batch->entries) {
+        e->done = true;
+    }
+    batch->cv.notify_all();
+}
+
+json EmbeddingBatcher::build_combined_request(Kind kind, const Batch& batch) {
+    json combined = *batch.entries.front()->request;
+    json all_items = json::array();
+    for (const Entry* e : batch.entries) {
+        for (const auto& item : e->items) {
+            all_items.push_back(item);
+        }
+    }
+    if (kind == Kind::Embeddings) {
+        combined["input"] = std::move(all_items);
+    } else {
+        combined["documents"] = std::move(all_items);
+        combined.erase("top_n");
+    }
+    return combined;
+}
+
+void EmbeddingBatcher::scatter(Kind kind, Batch& batch, const json& response) {
+    const char* list_key = (kind == Kind::Embeddings) ? "data" : "results";
+    if (!response.is_object() || response.contains("error") ||
+        !response.contains(list_key) || !response[list_key].is_array()) {
+        // Errors (and anything we do not understand) go back to every caller verbatim.
+        for (Entry* e : batch.entries) {
+            e->response = response;
+        }
+        return;
+    }
+
+    // Index the combined results by their position in the combined input.
+    const json& results = response[list_key];
+    std::vector<const json*> by_index(batch.item_count, nullptr);
+    for (size_t pos = 0; pos < results.size(); ++pos) {
+        const json& r = results[pos];
+        size_t index = pos;
+        if (r.contains("index") && r["index"].is_number_integer() && r["index"].get<long long>() >= 0) {
+            index = static_cast<size_t>(r["index"].get<long long>());
+        }
+        if (index < by_index.size()) {
+            by_index[index] = &r;
+        }
+    }
+
+    // Apportion usage by each caller's share of the estimated tokens; the last
+    // caller absorbs the rounding remainder so the per-caller sums match the
+    // backend's totals exactly.
+    long total_weight = 0;
+    for (const Entry* e : batch.entries) {
+        total_weight += e->weight;
+    }
+    std::map<std::string, long long> usage_remaining;
+    if (response.contains("usage") && response["usage"].is_object()) {
+        for (auto it = response["usage"].begin(); it != response["usage"].end(); ++it) {
+            if (it.value().is_number_integer()) {
+                usage_remaining[it.key()] = it.value().get<long long>();
+            }
+        }
+    }
+
+    for (size_t n = 0; n < batch.entries.size(); ++n) {
+        Entry* e = batch.entries[n];
+        const bool last = (n + 1 == batch.entries.size());
+        json out = response;
+        json list = json::array();
+        bool complete = true;
+        for (size_t k = 0; k < e->items.size(); ++k) {
+            const json* r = by_index[e->offset + k];
+            if (!r) {
+                complete = false;
+                break;
+            }
+            json copy = *r;
+            copy["index"] = k;
+            list.push_back(std::move(copy));
+        }
+        if (!complete) {
+            e->response = ErrorResponse::create(
+                "Backend returned " + std::to_string(results.size()) + " results for a batch of " +
+                    std::to_string(batch.item_count) + " inputs",
+                ErrorType::BACKEND_ERROR);
+            continue;
+        }
+
+        if (kind == Kind::Reranking) {
+            sort_by_relevance(list);
+            const json& top_n = e->request->value("top_n", json());
+            if (top_n.is_number_integer() && top_n.get<long long>() >= 0 &&
+                static_cast<size_t>(top_n.get<long long>()) < list.size()) {
+                list.erase(list.begin() + top_n.get<long long>(), list.end());
+            }
+        }
+        out[list_key] = std::move(list);
+
+        for (auto& [field, remaining] : usage_remaining) {
+            long long share = remaining;
+            if (!last && total_weight > 0) {
+                long long total = response["usage"][field].get<long long>();
+                share = std::min<long long>(remaining, std::llround(
+                    static_cast<double>(total) * e->weight / static_cast<double>(total_weight)));
+            }
+            out["usage"][field] = share;
+            remaining -= share;
+        }
+        e->response = std::move(out);
+    }
+}
+
+json EmbeddingBatcher::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto render = [](const KindStats& s) {
+        return json{
+            {"batch_size", s.batch_size.to_json()},
+            {"added_latency_seconds", s.added_latency_seconds.to_json()},
+            {"requests_total", s.requests_total},
+            {"batches_total", s.batches_total}
+        };
+    };
+    return {
+        {"embeddings", render(embeddings_stats_)},
+        {"reranking", render(reranking_stats_)}
+    };
+}
+
+} // namespace lemon
@@ -0,0 +1,348 @@
+#include "lemon/embedding_cache.h"
+#include "lemon/utils/aixlog.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <system_error>
+#include <mbedtls/md.h>
+
+namespace fs = std::filesystem;
+
+namespace lemon {
+
+namespace {
+
+// Blob layout: one tag byte, then the payload.
+//   'F' -> little-endian float32 values (the common float-array case)
+//   'J' -> JSON text (base64 strings and anything else we do not pack)
+constexpr char kTagFloat32 = 'F';
+constexpr char kTagJson = 'J';
+
+std::string sha256_hex(const std::string& data) {
+    unsigned char digest[32] = {0};
+    const mbedtls_md_info_t* md_info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+    if (!md_info || mbedtls_md(md_info, reinterpret_cast<const unsigned char*>(data.data()),
+                               data.size(), digest) != 0) {
+        // Cannot happen with a working mbedTLS build; fall back to a key that
+        // still includes the full content so lookups stay correct.
+        return data;
+    }
+    std::ostringstream oss;
+    oss << std::hex << std::setfill('0');
+    for (unsigned char byte : digest) {
+        oss << std::setw(2) << static_cast<unsigned int>(byte);
+    }
+    return oss.str();
+}
+
+} // namespace
+
+void EmbeddingCache::configure(size_t memory_bytes, size_t disk_bytes, const std::string& disk_dir) {
+    const std::string dir = (memory_bytes > 0 && disk_bytes > 0) ? disk_dir : "";
+    std::vector<std::string> removed;
+    bool dir_changed = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dir_changed = dir != disk_dir_;
+        if (memory_bytes == memory_budget_ && disk_bytes == disk_budget_ && !dir_changed) {
+            return;
+        }
+
+        memory_budget_ = memory_bytes;
+        while (memory_bytes_ > memory_budget_ && !memory_lru_.empty()) {
+            memory_bytes_ -= memory_lru_.back().blob.size();
+            memory_index_.erase(memory_lru_.back().key);
+            memory_lru_.pop_back();
+        }
+        if (!dir_changed) {
+            disk_budget_ = dir.empty() ? 0 : disk_bytes;
+            removed = trim_disk_locked();
+        }
+    }
+
+    if (dir_changed) {
+        // Index the new directory without the lock; the old tier keeps
+        // serving until the new one is swapped in
+        std::list<DiskEntry> lru;
+        std::unordered_map<std::string, std::list<DiskEntry>::iterator> index;
+        size_t bytes = 0;
+        if (!dir.empty()) {
+            load_disk_index(dir, lru, index, bytes);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        disk_dir_ = dir;
+        disk_budget_ = dir.empty() ? 0 : disk_bytes;
+        disk_lru_ = std::move(lru);
+        disk_index_ = std::move(index);
+        disk_bytes_ = bytes;
+        removed = trim_disk_locked();
+    }
+    for (const auto& path : removed) {
+        std::error_code ec;
+        fs::remove(path, ec);
+    }
+}
+
+bool EmbeddingCache::enabled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return memory_budget_ > 0;
+}
+
+std::string EmbeddingCache::make_key(const std::string& checkpoint, const json& options, const json& item) {
+    // Length-prefix each component so no concatenation of two different
+    // triples can produce the same hash input.
+    std::string material;
+    for (const std::string& part : {checkpoint, options.dump(), item.dump()}) {
+        material += std::to_string(part.size());
+        material += ':';
+        material += part;
+    }
+    return sha256_hex(material);
+}
+
+std::string EmbeddingCache::encode(const json& embedding) {
+    const bool packable = embedding.is_array() && !embedding.empty() &&
+        std::all_of(embedding.begin(), embedding.end(), [](const json& v) { return v.is_number(); });
+    if (!packable) {
+        return std::string(1, kTagJson) + embedding.dump();
+    }
+    std::string blob(1 + embedding.size() * sizeof(float), kTagFloat32);
+    char* out = &blob[1];
+    for (const auto& v : embedding) {
+        float f = v.get<float>();
+        std::memcpy(out, &f, sizeof(float));
+        out += sizeof(float);
+    }
+    return blob;
+}
+
+bool EmbeddingCache::decode(const char* data, size_t size, json& embedding) {
+    if (size < 1) {
+        return false;
+    }
+    if (data[0] == kTagFloat32) {
+        const size_t payload = size - 1;
+        if (payload == 0 || payload % sizeof(float) != 0) {
+            return false;
+        }
+        embedding = json::array();
+        const size_t count = payload / sizeof(float);
+        embedding.get_ref<json::array_t&>().reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            float f;
+            std::memcpy(&f, data + 1 + i * sizeof(float), sizeof(float));
+            embedding.push_back(f);
+        }
+        return true;
+    }
+    if (data[0] == kTagJson) {
+        embedding = json::parse(data + 1, data + size, nullptr, false);
+        return !embedding.is_discarded();
+    }
+    return false;
+}
+
+bool EmbeddingCache::lookup(const std::string& key, size_t input_bytes, json& embedding) {
+    std::string blob;
+    bool on_disk = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (memory_budget_ == 0) {
+            return false;
+        }
+        auto it = memory_index_.find(key);
+        if (it != memory_index_.end()) {
+            memory_lru_.splice(memory_lru_.begin(), memory_lru_, it->second);
+            if (decode(it->second->blob.data(), it->second->blob.size(), embedding)) {
+                hits_++;
+                bytes_saved_ += input_bytes;
+                return true;
+            }
+        }
+        on_disk = disk_index_.count(key) > 0;
+        if (!on_disk) {
+            misses_++;
+            return false;
+        }
+    }
+
+    // Disk read happens outside the lock so a slow disk never stalls
+    // memory-tier hits on other request threads.
+    const bool read_ok = read_disk_entry(key, blob) && decode(blob.data(), blob.size(), embedding);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!read_ok) {
+        misses_++;
+        return false;
+    }
+    hits_++;
+    disk_hits_++;
+    bytes_saved_ += input_bytes;
+    auto disk_it = disk_index_.find(key);
+    if (disk_it != disk_index_.end()) {
+        disk_lru_.splice(disk_lru_.begin(), disk_lru_, disk_it->second);
+    }
+    insert_memory_locked(key, std::move(blob));
+    return true;
+}
+
+void EmbeddingCache::insert(const std::string& key, const json& embedding) {
+    std::string blob = encode(embedding);
+    std::string dir;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (memory_budget_ == 0) {
+            return;
+        }
+        insert_memory_locked(key, blob);
+        if (disk_budget_ == 0 || disk_index_.count(key) > 0) {
+            return;
+        }
+        dir = disk_dir_;
+    }
+
+    // Write-then-rename so a concurrent reader (or a crash) never sees a
+    // partially written entry.
+    const fs::path final_path = disk_path(key);
+    std::error_code ec;
+    fs::create_directories(final_path.parent_path(), ec);
+    const fs::path tmp_path = final_path.string() + ".tmp";
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!out || !out.write(blob.data(), static_cast<std::streamsize>(blob.size()))) {
+            LOG(DEBUG, "EmbeddingCache") << "Failed to write " << tmp_path.string() << std::endl;
+            fs::remove(tmp_path, ec);
+            return;
+        }
+    }
+    fs::rename(tmp_path, final_path, ec);
+    if (ec) {
+        fs::remove(tmp_path, ec);
+        return;
+    }
+
+    std::vector<std::string> removed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (disk_dir_ != dir) {
+            return;  // Reconfigured while writing; the new index does not own this file
+        }
+        if (disk_index_.count(key) == 0) {
+            disk_lru_.push_front({key, blob.size()});
+            disk_index_[key] = disk_lru_.begin();
+            disk_bytes_ += blob.size();
+        }
+        removed = trim_disk_locked();
+    }
+    for (const auto& path : removed) {
+        fs::remove(path, ec);
+    }
+}
+
+json EmbeddingCache::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {
+        {"enabled", memory_budget_ > 0},
+        {"hits", hits_},
+        {"misses", misses_},
+        {"disk_hits", disk_hits_},
+        {"bytes_saved", bytes_saved_},
+        {"memory_bytes", memory_bytes_},
+        {"memory_entries", memory_lru_.size()},
+        {"disk_bytes", disk_bytes_},
+        {"disk_entries", disk_lru_.size()}
+    };
+}
+
+std::string EmbeddingCache::disk_path(const std::string& key) const {
+    // Two-character fan-out keeps directories small for large corpora.
+    return (fs::path(disk_dir_) / key.substr(0, 2) / (key + ".bin")).string();
+}
+
+bool EmbeddingCache::read_disk_entry(const std::string& key, std::string& blob) const {
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (disk_dir_.empty()) {
+            return false;
+        }
+        path = disk_path(key);
+    }
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    blob.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return !blob.empty();
+}
+
+void EmbeddingCache::insert_memory_locked(const std::string& key, std::string blob) {
+    if (blob.size() > memory_budget_) {
+        return;
+    }
+    auto it = memory_index_.find(key);
+    if (it != memory_index_.end()) {
+        memory_bytes_ -= it->second->blob.size();
+        memory_lru_.erase(it->second);
+        memory_index_.erase(it);
+    }
+    memory_bytes_ += blob.size();
+    memory_lru_.push_front({key, std::move(blob)});
+    memory_index_[key] = memory_lru_.begin();
+    while (memory_bytes_ > memory_budget_ && !memory_lru_.empty()) {
+        memory_bytes_ -= memory_lru_.back().blob.size();
+        memory_index_.erase(memory_lru_.back().key);
+        memory_lru_.pop_back();
+    }
+}
+
+void EmbeddingCache::load_disk_index(const std::string& dir, std::list<DiskEntry>& lru,
+                                     std::unordered_map<std::string, std::list<DiskEntry>::iterator>& index,
+                                     size_t& bytes) {
+    // Rebuild the disk LRU from whatever a previous run left behind, oldest
+    // first so that trimming removes the stalest entries.
+    std::error_code ec;
+    if (!fs::exists(dir, ec)) {
+        return;
+    }
+    std::vector<std::pair<fs::file_time_type, DiskEntry>> found;
+    for (auto it = fs::recursive_directory_iterator(dir, ec);
+         !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        if (!it->is_regular_file(ec) || it->path().extension() != ".bin") {
+            continue;
+        }
+        const size_t size = static_cast<size_t>(it->file_size(ec));
+        if (ec) {
+            ec.clear();
+            continue;
+        }
+        found.push_back({it->last_write_time(ec), {it->path().stem().string(), size}});
+    }
+    std::sort(found.begin(), found.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (auto& item : found) {
+        lru.push_front(item.second);
+        index[item.second.key] = lru.begin();
+        bytes += item.second.size;
+    }
+    LOG(DEBUG, "EmbeddingCache") << "Disk tier: " << lru.size() << " entries ("
+                                 << bytes << " bytes) in " << dir << std::endl;
+}
+
+std::vector<std::string> EmbeddingCache::trim_disk_locked() {
+    std::vector<std::string> removed;
+    while (disk_bytes_ > disk_budget_ && !disk_lru_.empty()) {
+        const DiskEntry& victim = disk_lru_.back();
+        removed.push_back(disk_path(victim.key));
+        disk_bytes_ -= victim.size;
+        disk_index_.erase(victim.key);
+        disk_lru_.pop_back();
+    }
+    return removed;
+}
+
+} // namespace lemon
@@ -3,6 +3,7 @@
 #include "lemon/global_vram_monitor.h"
 #include "lemon/wrapped_server.h"
 #include "lemon/utils/aixlog.hpp"
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
@@ -21,6 +22,32 @@ EvictionEngine::~EvictionEngine() {
     stop();
 }
 
+EvictionPolicy EvictionPolicy::from_recipe_options(const json& recipe_opts) {
+    EvictionPolicy policy;
+    if (recipe_opts.contains("auto_evict") && recipe_opts["auto_evict"].is_boolean()) {
+        policy.auto_evict = recipe_opts["auto_evict"].get<bool>();
+    }
+    if (recipe_opts.contains("evict_idle_timeout") && recipe_opts["evict_idle_timeout"].is_number_integer()) {
+        policy.evict_idle_timeout_sec = recipe_opts["evict_idle_timeout"].get<long>();
+    }
+    if (recipe_opts.contains("downsize_idle_timeout") && recipe_opts["downsize_idle_timeout"].is_number_integer()) {
+        policy.downsize_idle_timeout_sec = recipe_opts["downsize_idle_timeout"].get<long>();
+    }
+    if (recipe_opts.contains("evict_weight_factor") && recipe_opts["evict_weight_factor"].is_number()) {
+        policy.weight_factor = recipe_opts["evict_weight_factor"].get<double>();
+    }
+    if (policy.weight_factor <= 0.0) {
+        policy.weight_factor = 1.0;  // guard against divide-by-zero / non-positive config
+    }
+    if (recipe_opts.contains("priority") && recipe_opts["priority"].is_string()) {
+        const std::string priority = recipe_opts["priority"].get<std::string>();
+        if (priority == "interactive" || priority == "batch") {
+            policy.priority = priority;
+        }
+    }
+    return policy;
+}
+
 void EvictionEngine::start(int interval_ms) {
     if (running_) return;
     interval_ms_ = interval_ms;
@@ -29,7 +56,11 @@ void EvictionEngine::start(int interval_ms) {
 }
 
 void EvictionEngine::stop() {
-    running_ = false;
+    {
+        std::lock_guard<std::mutex> lock(timer_mutex_);
+        running_ = false;
+    }
+    timer_cv_.notify_all();
     if (engine_thread_.joinable()) {
         engine_thread_.join();
     }
@@ -39,33 +70,221 @@ void EvictionEngine::on_vram_pressure(double pct) {
     double threshold = RuntimeConfig::global()->auto_evict_threshold_pct();
     if (pct >= threshold) {
         LOG(INFO) << "VRAM pressure critical (" << (pct * 100.0) << "% >= " << (threshold * 100.0) << "%). Evaluating eviction." << std::endl;
-        evaluate_servers(pct);
+        // Hand off to the engine thread rather than evaluating on the monitor's.
+        {
+            std::lock_guard<std::mutex> lock(timer_mutex_);
+            pending_pressure_pct_ = std::max(pending_pressure_pct_, pct);
+        }
+        timer_cv_.notify_all();
+    }
+}
+
+void EvictionEngine::on_memory_pressure(const std::string& model_name, const std::string& leaf, bool hard) {
+    LOG(INFO) << "Memory pressure in the cgroup of " << model_name << (hard ? " (limit reached)" : "")
+              << "." << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(timer_mutex_);
+        int& level = pending_memory_pressure_[leaf];
+        level = std::max(level, hard ? 2 : 1);
     }
+    timer_cv_.notify_all();
+}
+
+void EvictionEngine::on_host_memory_pressure(const std::string& model_name) {
+    LOG(INFO) << "Host memory pressure reached the protected memory of " << model_name << "." << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(timer_mutex_);
+        pending_host_pressure_ = true;
+    }
+    timer_cv_.notify_all();
+}
+
+void EvictionEngine::note_activity(const WrappedServer* server) {
+    if (!server || server->is_pinned()) return;
+    const EvictionPolicy& policy = server->get_eviction_policy();
+    long first_timeout_sec = std::min(policy.downsize_idle_timeout_sec, policy.evict_idle_timeout_sec);
+    auto deadline = server->get_last_access_time() + std::chrono::seconds(first_timeout_sec);
+    // Runs on every request: when the engine already wakes up no later than
+    // this, its pass re-reads the access time, so skip the lock
+    if (deadline.time_since_epoch().count() >= next_deadline_.load(std::memory_order_acquire)) return;
+    arm(server->get_model_name(), deadline);
+}
+
+void EvictionEngine::arm(const std::string& model_name, Clock::time_point deadline) {
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(timer_mutex_);
+        auto it = armed_.find(model_name);
+        if (it != armed_.end() && it->second <= deadline) {
+            // An earlier deadline is already armed; when it fires the engine
+            // re-reads the access time and re-arms from there.
+            return;
+        }
+        wake = deadlines_.empty() || deadline < deadlines_.top().first;
+        armed_[model_name] = deadline;
+        deadlines_.emplace(deadline, model_name);
+        publish_next_deadline_locked();
+    }
+    if (wake) {
+        timer_cv_.notify_all();
+    }
+}
+
+void EvictionEngine::publish_next_deadline_locked() {
+    const Clock::time_point next = deadlines_.empty() ? Clock::time_point::max() : deadlines_.top().first;
+    next_deadline_.store(next.time_since_epoch().count(), std::memory_order_release);
 }
 
 void EvictionEngine::evaluation_loop() {
+    // Initial pass arms deadlines for anything loaded before the engine started.
+    bool due = true;
+    double pressure_pct = -1.0;
+    std::map<std::string, int> memory_pressure;
+    bool host_pressure = false;
+
     while (running_) {
-        // Also perform regular time-based idle checks
-        evaluate_servers(-1.0);
-        std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms_));
+        for (const auto& [leaf, level] : memory_pressure) {
+            relieve_memory_pressure(leaf, level > 1);
+        }
+        if (host_pressure) {
+            relieve_host_memory_pressure();
+        }
+        if (due || pressure_pct >= 0.0) {
+            while (evaluate_servers(pressure_pct) && running_) {
+                pressure_pct = -1.0;  // One pressure eviction per signal, as before
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(timer_mutex_);
+        auto fallback = Clock::now() + std::chrono::milliseconds(interval_ms_);
+        timer_cv_.wait_until(lock, deadlines_.empty() ? fallback : std::min(fallback, deadlines_.top().first), [this] {
+            return !running_ || pending_pressure_pct_ >= 0.0 || !pending_memory_pressure_.empty() ||
+                   pending_host_pressure_ ||
+                   (!deadlines_.empty() && deadlines_.top().first <= Clock::now());
+        });
+
+        // Pop everything that is due. Stale entries (superseded by an earlier
+        // re-arm) trigger a pass too, since note_activity() skips arming
+        // behind whatever deadline is at the top. Fallback wake-ups also
+        // trigger a full pass.
+        auto now = Clock::now();
+        due = now >= fallback;
+        while (!deadlines_.empty() && deadlines_.top().first <= now) {
+            auto it = armed_.find(deadlines_.top().second);
+            if (it != armed_.end() && it->second == deadlines_.top().first) {
+                armed_.erase(it);
+            }
+            deadlines_.pop();
+            due = true;
+        }
+        publish_next_deadline_locked();
+        pressure_pct = pending_pressure_pct_;
+        pending_pressure_pct_ = -1.0;
+        memory_pressure.clear();
+        memory_pressure.swap(pending_memory_pressure_);
+        host_pressure = pending_host_pressure_;
+        pending_host_pressure_ = false;
+    }
+}
+
+void EvictionEngine::relieve_memory_pressure(const std::string& leaf, bool hard) {
+    // The limits that fired are the leaf's own, so freeing another model's
+    // memory would not relieve them
+    std::shared_ptr<WrappedServer> server;
+    {
+        auto registry = router_->registry_snapshot();
+        for (auto& candidate : registry->servers) {
+            if (candidate && !leaf.empty() && candidate->get_cgroup_leaf() == leaf) {
+                server = candidate;
+                break;
+            }
+        }
+    }
+    if (!server || server->is_pinned()) return;
+    const EvictionPolicy& policy = server->get_eviction_policy();
+    if (!policy.auto_evict.value_or(RuntimeConfig::global()->auto_evict())) return;
+
+    const std::string name = server->get_model_name();
+    if (server->try_begin_downsize()) {
+        bool ok = server->downsize();
+        server->finish_downsize(ok);
+        if (ok) {
+            LOG(INFO) << "Model " << name << " downsized under memory pressure." << std::endl;
+            return;
+        }
+    }
+
+    if (hard && server->try_begin_eviction()) {
+        LOG(INFO) << "Eviction Engine unloading model: " << name << " due to memory limit." << std::endl;
+        router_->evict_if_committed(name);
+        return;
     }
+    LOG(DEBUG) << "Model " << name << " is busy; leaving its memory pressure to the kernel." << std::endl;
 }
 
-void EvictionEngine::evaluate_servers(double current_vram_pct) {
+void EvictionEngine::relieve_host_memory_pressure() {
+    // Interactive backends are protected by memory.low; idle batch backends
+    // give memory back, largest measured footprint first. One per signal:
+    // reclaim that keeps reaching protected memory raises another event.
+    std::vector<std::pair<int64_t, std::shared_ptr<WrappedServer>>> candidates;
+    {
+        auto registry = router_->registry_snapshot();
+        for (auto& server : registry->servers) {
+            if (!server || server->is_pinned() || server->is_interactive()) continue;
+            const EvictionPolicy& policy = server->get_eviction_policy();
+            if (!policy.auto_evict.value_or(RuntimeConfig::global()->auto_evict())) continue;
+            const ModelState state = server->get_state();
+            if ((state != ModelState::READY && state != ModelState::DOWNSIZED) ||
+                server->get_active_request_count() > 0) {
+                continue;
+            }
+            candidates.emplace_back(server->get_memory_bytes(), server);
+        }
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    for (const auto& [bytes, server] : candidates) {
+        const std::string name = server->get_model_name();
+        if (server->try_begin_downsize()) {
+            bool ok = server->downsize();
+            server->finish_downsize(ok);
+            if (ok) {
+                LOG(INFO) << "Batch model " << name << " downsized under host memory pressure." << std::endl;
+                return;
+            }
+        }
+        if (server->try_begin_eviction()) {
+            LOG(INFO) << "Eviction Engine unloading batch model: " << name
+                      << " due to host memory pressure." << std::endl;
+            router_->evict_if_committed(name);
+            return;
+        }
+    }
+    LOG(DEBUG) << "No idle batch model to shed under host memory pressure." << std::endl;
+}
+
+bool EvictionEngine::evaluate_servers(double current_vram_pct) {
     std::string model_to_evict;
-    std::vector<std::string> models_to_downsize;
+    // Held by handle rather than name: replicas of one model share a name
+    // but go idle independently.
+    std::vector<std::shared_ptr<WrappedServer>> models_to_downsize;
+    std::vector<Deadline> next_deadlines;
 
     {
-        std::lock_guard<std::mutex> lock(router_->load_mutex_);
+        // Scan the published registry; the router lock is only taken by
+        // evict_if_committed() below once a victim has been chosen.
+        auto registry = router_->registry_snapshot();
 
         auto now = std::chrono::steady_clock::now();
         double threshold = RuntimeConfig::global()->auto_evict_threshold_pct();
         bool pressure_evict = (current_vram_pct >= threshold);
 
         WrappedServer* best_candidate_for_eviction = nullptr;
+        bool candidate_claimed = false;
         double highest_eviction_score = -1.0;
 
-        for (auto& server_ptr : router_->loaded_servers_) {
+        for (auto& server_ptr : registry->servers) {
             WrappedServer* server = server_ptr.get();
             if (!server) continue;
 
@@ -73,30 +292,14 @@ void EvictionEngine::evaluate_servers(double current_vram_pct) {
             if (server->is_pinned()) continue;
 
             // Check auto_evict config
-            bool auto_evict = RuntimeConfig::global()->auto_evict();
-            auto recipe_opts = server->get_recipe_options().to_json();
-            if (recipe_opts.contains("auto_evict") && recipe_opts["auto_evict"].is_boolean()) {
-                auto_evict = recipe_opts["auto_evict"].get<bool>();
-            }
+            const EvictionPolicy& policy = server->get_eviction_policy();
+            bool auto_evict = policy.auto_evict.value_or(RuntimeConfig::global()->auto_evict());
 
             if (!auto_evict) continue;
 
-            long evict_timeout_sec = 300;
-            long downsize_timeout_sec = 60;
-            double weight_factor = 1.0;
-
-            if (recipe_opts.contains("evict_idle_timeout") && recipe_opts["evict_idle_timeout"].is_number_integer()) {
-                evict_timeout_sec = recipe_opts["evict_idle_timeout"].get<long>();
-            }
-            if (recipe_opts.contains("downsize_idle_timeout") && recipe_opts["downsize_idle_timeout"].is_number_integer()) {
-                downsize_timeout_sec = recipe_opts["downsize_idle_timeout"].get<long>();
-            }
-            if (recipe_opts.contains("evict_weight_factor") && recipe_opts["evict_weight_factor"].is_number()) {
-                weight_factor = recipe_opts["evict_weight_factor"].get<double>();
-            }
-            if (weight_factor <= 0.0) {
-                weight_factor = 1.0;  // guard against divide-by-zero / non-positive config
-            }
+            long evict_timeout_sec = policy.evict_idle_timeout_sec;
+            long downsize_timeout_sec = policy.downsize_idle_timeout_sec;
+            double weight_factor = policy.weight_factor;
 
             auto idle_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - server->get_last_access_time()).count();
             long load_duration_ms = server->get_load_duration_ms() > 0 ? server->get_load_duration_ms() : 1000;
@@ -111,10 +314,13 @@ void EvictionEngine::evaluate_servers(double current_vram_pct) {
             ModelState state = server->get_state();
 
             // 1. Time-based hard idle eviction
-            if (idle_ms >= evict_timeout_sec * 1000 && state != ModelState::EVICTING && state != ModelState::UNLOADED && state != ModelState::IN_USE) {
+            // try_begin_eviction() re-checks under the state lock that the model
+            // is still idle and not loading, so a request that lands between the
+            // snapshot and here keeps its backend.
+            if (idle_ms >= evict_timeout_sec * 1000 && server->try_begin_eviction()) {
                 LOG(INFO) << "Model " << server->get_model_name() << " reached evict idle timeout (" << evict_timeout_sec << "s). Evicting." << std::endl;
-                server->set_state(ModelState::EVICTING);
                 best_candidate_for_eviction = server;
+                candidate_claimed = true;
                 pressure_evict = true;
                 break;
             }
@@ -124,11 +330,21 @@ void EvictionEngine::evaluate_servers(double current_vram_pct) {
             // re-checks that it is still idle and transitions it to DOWNSIZING.
             if (idle_ms >= downsize_timeout_sec * 1000 && state == ModelState::READY) {
                 LOG(INFO) << "Model " << server->get_model_name() << " reached downsize idle timeout (" << downsize_timeout_sec << "s). Marking for downsize." << std::endl;
-                models_to_downsize.push_back(server->get_model_name());
+                models_to_downsize.push_back(server_ptr);
+            }
+
+            // Re-arm the next deadline. Busy models are re-armed by
+            // release_inference(); a READY model past its downsize deadline is
+            // collected above, so only its evict deadline remains.
+            if (state == ModelState::READY || state == ModelState::DOWNSIZED) {
+                auto evict_at = server->get_last_access_time() + std::chrono::seconds(evict_timeout_sec);
+                auto downsize_at = server->get_last_access_time() + std::chrono::seconds(downsize_timeout_sec);
+                auto next = (state == ModelState::READY && downsize_at > now) ? std::min(downsize_at, evict_at) : evict_at;
+                next_deadlines.emplace_back(next, server->get_model_name());
             }
 
             // 3. VRAM Pressure tracking
-            if (pressure_evict && state != ModelState::EVICTING && state != ModelState::UNLOADED && state != ModelState::IN_USE) {
+            if (pressure_evict && (state == ModelState::READY || state == ModelState::DOWNSIZED)) {
                 if (eviction_score > highest_eviction_score) {
                     highest_eviction_score = eviction_score;
                     best_candidate_for_eviction = server;
@@ -136,29 +352,27 @@ void EvictionEngine::evaluate_servers(double current_vram_pct) {
             }
         }
 
-        if (pressure_evict && best_candidate_for_eviction) {
+        if (pressure_evict && best_candidate_for_eviction &&
+            (candidate_claimed || best_candidate_for_eviction->try_begin_eviction())) {
             model_to_evict = best_candidate_for_eviction->get_model_name();
-            best_candidate_for_eviction->set_state(ModelState::EVICTING);
             LOG(INFO) << "Eviction Engine unloading model: " << model_to_evict << " due to score/pressure/idle." << std::endl;
         }
-    } // release lock
+    }
 
-    // Perform downsizes outside the lock so they don't block the router. Each
-    // downsize is an owned maintenance operation: try_begin_downsize() (under the
-    // router lock) atomically claims the model and marks it busy, so a concurrent
-    // evict_server() waits in wait_until_not_busy() instead of unloading and
-    // destroying the server while we still hold a raw pointer to it. The matching
-    // finish_downsize() releases that guard and records success/failure.
-    for (const auto& name : models_to_downsize) {
-        WrappedServer* s = nullptr;
-        {
-            std::lock_guard<std::mutex> lk(router_->load_mutex_);
-            s = router_->find_server_by_model_name(name);
-            if (!s || !s->try_begin_downsize()) {
-                continue;  // gone, busy, or no longer idle since phase 1
-            }
+    for (const auto& [deadline, name] : next_deadlines) {
+        arm(name, deadline);
+    }
+
+    // Each downsize is an owned maintenance operation: try_begin_downsize()
+    // atomically claims the model and marks it busy, so a concurrent
+    // evict_server() waits in retire() instead of stopping the backend
+    // mid-downsize, and the registry handle keeps the object alive. The
+    // matching finish_downsize() releases that guard and records success/failure.
+    for (const auto& s : models_to_downsize) {
+        const std::string name = s->get_model_name();
+        if (!s->try_begin_downsize()) {
+            continue;  // gone, busy, or no longer idle since phase 1
         }
-        // s is kept alive by the maintenance guard set in try_begin_downsize().
         bool ok = s->downsize();
         s->finish_downsize(ok);
         if (ok) {
@@ -172,7 +386,9 @@ void EvictionEngine::evaluate_servers(double current_vram_pct) {
         // Race-safe: only unloads if the model hasn't been rescued by an
         // in-flight request since we marked it EVICTING above.
         router_->evict_if_committed(model_to_evict);
+        return true;
     }
+    return false;
 }
 
 } // namespace lemon
@@ -0,0 +1,816 @@
+#include "lemon/gguf_tokenizer.h"
+#include "lemon/gguf_reader.h"
+#include "lemon/utils/aixlog.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <queue>
+
+namespace fs = std::filesystem;
+
+namespace lemon {
+
+namespace {
+
+// llama_token_type values stored in tokenizer.ggml.token_type
+constexpr int32_t kTokenNormal = 1;
+constexpr int32_t kTokenUnknown = 2;
+constexpr int32_t kTokenControl = 3;
+constexpr int32_t kTokenUserDefined = 4;
+constexpr int32_t kTokenByte = 6;
+
+// Upper bound on vocabulary / merge array lengths read from a file
+constexpr uint64_t kMaxArrayLength = 16 * 1024 * 1024;
+
+const char* const kSpmSpace = "\xe2\x96\x81";  // U+2581, SentencePiece's space
+
+enum class CpClass : uint8_t { Other, Letter, Number, Space, End };
+
+struct Codepoint {
+    uint32_t value;
+    uint32_t offset;  // Byte offset in the text
+    CpClass cls;
+};
+
+bool in_ranges(uint32_t cp, const uint32_t (*ranges)[2], size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (cp >= ranges[i][0] && cp <= ranges[i][1]) return true;
+    }
+    return false;
+}
+
+// Unicode class as seen by the pre-tokenizer regexes (\s, \p{N}, \p{L} and
+// everything else). ASCII and Latin-1 are exact; beyond that the common
+// space, digit, punctuation, symbol and combining-mark blocks are listed and
+// the remaining code points count as letters, which is what they are in the
+// scripts models are mostly prompted in.
+CpClass classify(uint32_t cp) {
+    if (cp < 0x80) {
+        if ((cp >= 'a' && cp <= 'z') || (cp >= 'A' && cp <= 'Z')) return CpClass::Letter;
+        if (cp >= '0' && cp <= '9') return CpClass::Number;
+        if (cp == ' ' || (cp >= '\t' && cp <= '\r')) return CpClass::Space;
+        return CpClass::Other;
+    }
+
+    static const uint32_t kSpaces[][2] = {
+        {0x85, 0x85}, {0xA0, 0xA0}, {0x1680, 0x1680}, {0x2000, 0x200A},
+        {0x2028, 0x2029}, {0x202F, 0x202F}, {0x205F, 0x205F}, {0x3000, 0x3000},
+    };
+    static const uint32_t kNumbers[][2] = {
+        {0xB2, 0xB3}, {0xB9, 0xB9}, {0xBC, 0xBE}, {0x660, 0x669}, {0x6F0, 0x6F9},
+        {0x7C0, 0x7C9}, {0x966, 0x96F}, {0x9E6, 0x9EF}, {0xA66, 0xA6F}, {0xAE6, 0xAEF},
+        {0xB66, 0xB6F}, {0xBE6, 0xBF2}, {0xC66, 0xC6F}, {0xCE6, 0xCEF}, {0xD66, 0xD78},
+        {0xDE6, 0xDEF}, {0xE50, 0xE59}, {0xED0, 0xED9}, {0xF20, 0xF33}, {0x1040, 0x1049},
+        {0x17E0, 0x17E9}, {0x1810, 0x1819}, {0x2070, 0x2070}, {0x2074, 0x2079},
+        {0x2080, 0x2089}, {0x2150, 0x2189}, {0x2460, 0x249B}, {0x24EA, 0x24FF},
+        {0x2776, 0x2793}, {0x3007, 0x3007}, {0x3021, 0x3029}, {0x3038, 0x303A},
+        {0x3192, 0x3195}, {0x3220, 0x3229}, {0x3248, 0x324F}, {0x3251, 0x325F},
+        {0x3280, 0x3289}, {0x32B1, 0x32BF}, {0xFF10, 0xFF19}, {0x1D7CE, 0x1D7FF},
+        {0x1F100, 0x1F10C},
+    };
+    static const uint32_t kOthers[][2] = {
+        {0x80, 0xA9}, {0xAB, 0xB4}, {0xB6, 0xB9}, {0xBB, 0xBF}, {0xD7, 0xD7}, {0xF7, 0xF7},
+        {0x2C2, 0x2C5}, {0x2D2, 0x2DF}, {0x2E5, 0x2EB}, {0x2ED, 0x2ED}, {0x2EF, 0x36F},
+        {0x375, 0x375}, {0x37E, 0x37E}, {0x384, 0x385}, {0x387, 0x387}, {0x3F6, 0x3F6},
+        {0x482, 0x489}, {0x55A, 0x55F}, {0x589, 0x58A}, {0x58D, 0x58F}, {0x591, 0x5C7},
+        {0x5F3, 0x5F4}, {0x600, 0x61F}, {0x64B, 0x65F}, {0x66A, 0x66D}, {0x670, 0x670},
+        {0x6D4, 0x6D4}, {0x6D6, 0x6ED}, {0x900, 0x903}, {0x93A, 0x93C}, {0x93E, 0x94F},
+        {0x951, 0x957}, {0x962, 0x965}, {0x970, 0x970}, {0x981, 0x983}, {0x9BC, 0x9BC},
+        {0x9BE, 0x9CD}, {0xE31, 0xE31}, {0xE34, 0xE3A}, {0xE3F, 0xE3F}, {0xE47, 0xE4F},
+        {0xE5A, 0xE5B}, {0x2010, 0x2027}, {0x2030, 0x205E}, {0x2060, 0x206F},
+        {0x207A, 0x207E}, {0x208A, 0x208E}, {0x20A0, 0x20FF}, {0x2100, 0x2101},
+        {0x2103, 0x2106}, {0x2108, 0x2109}, {0x2114, 0x2114}, {0x2116, 0x2118},
+        {0x211E, 0x2123}, {0x2125, 0x2125}, {0x2127, 0x2127}, {0x2129, 0x2129},
+        {0x212E, 0x212E}, {0x213A, 0x213B}, {0x2140, 0x2144}, {0x214A, 0x214D},
+        {0x214F, 0x214F}, {0x218A, 0x218B}, {0x2190, 0x245F}, {0x249C, 0x24E9},
+        {0x2500, 0x2775}, {0x2794, 0x2BFF}, {0x2CE5, 0x2CEA}, {0x2CF9, 0x2CFF},
+        {0x2E00, 0x2E7F}, {0x2E80, 0x2FFF}, {0x3001, 0x3004}, {0x3008, 0x3020},
+        {0x302A, 0x3030}, {0x3036, 0x3037}, {0x303D, 0x303F}, {0x3099, 0x309C},
+        {0x30A0, 0x30A0}, {0x30FB, 0x30FB}, {0x3190, 0x3191}, {0x3196, 0x319F},
+        {0x31C0, 0x31E3}, {0x3200, 0x321E}, {0x322A, 0x3247}, {0x3250, 0x3250},
+        {0x3260, 0x327F}, {0x328A, 0x32B0}, {0x32C0, 0x33FF}, {0x4DC0, 0x4DFF},
+        {0xA490, 0xA4C6}, {0xD800, 0xDFFF}, {0xE000, 0xF8FF}, {0xFB29, 0xFB29},
+        {0xFD3E, 0xFD3F}, {0xFE00, 0xFE6F}, {0xFEFF, 0xFEFF}, {0xFF01, 0xFF0F},
+        {0xFF1A, 0xFF20}, {0xFF3B, 0xFF40}, {0xFF5B, 0xFF65}, {0xFFE0, 0xFFFF},
+        {0x1D000, 0x1D24F}, {0x1D300, 0x1D35F}, {0x1F000, 0x1F0FF}, {0x1F10D, 0x1FBFF},
+        {0xE0000, 0xE0FFF}, {0xF0000, 0x10FFFF},
+    };
+
+    if (in_ranges(cp, kSpaces, sizeof(kSpaces) / sizeof(kSpaces[0]))) return CpClass::Space;
+    if (in_ranges(cp, kNumbers, sizeof(kNumbers) / sizeof(kNumbers[0]))) return CpClass::Number;
+    if (in_ranges(cp, kOthers, sizeof(kOthers) / sizeof(kOthers[0]))) return CpClass::Other;
+    return CpClass::Letter;
+}
+
+void append_utf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+// Decodes UTF-8; a byte that does not start a valid sequence becomes a
+// code point of its own so no input is lost.
+std::vector<Codepoint> decode_utf8(const char* data, size_t len) {
+    std::vector<Codepoint> cps;
+    cps.reserve(len);
+    size_t pos = 0;
+    while (pos < len) {
+        const auto lead = static_cast<unsigned char>(data[pos]);
+        uint32_t value = lead;
+        size_t n = 1;
+        if (lead >= 0xC0 && lead < 0xF8) {
+            n = lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+            value = lead & (0x7F >> n);
+            for (size_t k = 1; k < n; ++k) {
+                const auto c = pos + k < len ? static_cast<unsigned char>(data[pos + k]) : 0;
+                if ((c & 0xC0) != 0x80) {
+                    n = 1;
+                    value = lead;
+                    break;
+                }
+                value = (value << 6) | (c & 0x3F);
+            }
+        }
+        const CpClass cls = (n == 1 && lead >= 0x80) ? CpClass::Other : classify(value);
+        cps.push_back({value, static_cast<uint32_t>(pos), cls});
+        pos += n;
+    }
+    return cps;
+}
+
+// Length llama.cpp gives the UTF-8 sequence starting with `lead` when it
+// splits SentencePiece input into symbols
+size_t spm_symbol_length(char lead) {
+    static const size_t kLengths[] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 3, 4};
+    return kLengths[static_cast<unsigned char>(lead) >> 4];
+}
+
+// GPT-2's reversible byte <-> printable code point mapping
+struct ByteLevel {
+    std::array<std::string, 256> encode;  // UTF-8 of each byte's stand-in
+    std::unordered_map<uint32_t, uint8_t> decode;
+};
+
+const ByteLevel& byte_level() {
+    static const ByteLevel table = [] {
+        ByteLevel t;
+        uint32_t next = 256;
+        for (uint32_t b = 0; b < 256; ++b) {
+            const bool printable = (b >= '!' && b <= '~') || (b >= 0xA1 && b <= 0xAC) || (b >= 0xAE);
+            const uint32_t cp = printable ? b : next++;
+            append_utf8(t.encode[b], cp);
+            t.decode[cp] = static_cast<uint8_t>(b);
+        }
+        return t;
+    }();
+    return table;
+}
+
+// Word boundaries of llama.cpp's pre-tokenizer regexes, as [begin, end)
+// code point indices. llama3_style selects the llama3/qwen2 expression
+// (case-insensitive contractions, one leading non-letter joined to a word,
+// newline runs split off); max_digits caps \p{N} runs (0 = unlimited).
+void split_words(const std::vector<Codepoint>& cps, bool llama3_style, size_t max_digits,
+                 std::vector<std::pair<size_t, size_t>>& words) {
+    const size_t n = cps.size();
+    auto cls = [&](size_t k) { return k < n ? cps[k].cls : CpClass::End; };
+    auto cp = [&](size_t k) -> uint32_t { return k < n ? cps[k].value : 0; };
+    auto is_newline = [&](size_t k) { return cp(k) == '\r' || cp(k) == '\n'; };
+    auto folded = [&](size_t k) {
+        const uint32_t c = cp(k);
+        return (llama3_style && c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+    };
+
+    size_t i = 0;
+    while (i < n) {
+        size_t end = i;
+
+        // 's 't 're 've 'm 'll 'd
+        if (cp(i) == '\'') {
+            const uint32_t c1 = folded(i + 1);
+            const uint32_t c2 = folded(i + 2);
+            if ((c1 == 'r' && c2 == 'e') || (c1 == 'v' && c2 == 'e') || (c1 == 'l' && c2 == 'l')) {
+                end = i + 3;
+            } else if (c1 == 's' || c1 == 't' || c1 == 'm' || c1 == 'd') {
+                end = i + 2;
+            }
+        }
+
+        if (end == i && llama3_style) {
+            // [^\r\n\p{L}\p{N}]?\p{L}+
+            size_t j = i;
+            if (cls(j) != CpClass::Letter && cls(j) != CpClass::Number && !is_newline(j) &&
+                cls(j + 1) == CpClass::Letter) {
+                ++j;
+            }
+            if (cls(j) == CpClass::Letter) {
+                while (cls(j) == CpClass::Letter) ++j;
+                end = j;
+            }
+            // \p{N}{1,max_digits}
+            if (end == i && cls(i) == CpClass::Number) {
+                j = i;
+                while (cls(j) == CpClass::Number && (max_digits == 0 || j - i < max_digits)) ++j;
+                end = j;
+            }
+        } else if (end == i) {
+            // ?\p{L}+ | ?\p{N}+
+            for (CpClass want : {CpClass::Letter, CpClass::Number}) {
+                size_t j = cp(i) == ' ' ? i + 1 : i;
+                if (cls(j) == want) {
+                    while (cls(j) == want) ++j;
+                    end = j;
+                    break;
+                }
+            }
+        }
+
+        // ?[^\s\p{L}\p{N}]+ (llama3: followed by [\r\n]*)
+        if (end == i) {
+            size_t j = cp(i) == ' ' ? i + 1 : i;
+            if (cls(j) == CpClass::Other) {
+                while (cls(j) == CpClass::Other) ++j;
+                if (llama3_style) {
+                    while (is_newline(j)) ++j;
+                }
+                end = j;
+            }
+        }
+
+        // (llama3: \s*[\r\n]+ |) \s+(?!\S) | \s+
+        if (end == i && cls(i) == CpClass::Space) {
+            size_t k = i;
+            size_t last_newline = n;
+            while (cls(k) == CpClass::Space) {
+                if (is_newline(k)) last_newline = k;
+                ++k;
+            }
+            if (llama3_style && last_newline < n) {
+                end = last_newline + 1;
+            } else if (k == n || k - i == 1) {
+                end = k;
+            } else {
+                end = k - 1;
+            }
+        }
+
+        if (end == i) end = i + 1;
+        words.emplace_back(i, end);
+        i = end;
+    }
+}
+
+uint64_t pack_pair(int32_t left, int32_t right) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(left)) << 32) | static_cast<uint32_t>(right);
+}
+
+bool read_string_array(std::istream& in, uint32_t type, std::vector<std::string>& out) {
+    uint32_t elem_type = 0;
+    uint64_t count = 0;
+    if (type != 9 || !read_gguf_le(in, elem_type) || !read_gguf_le(in, count)) return false;
+    if (elem_type != 8 || count > kMaxArrayLength) return false;
+    out.resize(static_cast<size_t>(count));
+    for (auto& value : out) {
+        if (!read_gguf_string(in, value)) return false;
+    }
+    return true;
+}
+
+bool read_bool(std::istream& in, uint32_t type, int& out) {
+    uint8_t value = 0;
+    if (type != 7 || !read_gguf_le(in, value)) return skip_gguf_value(in, type);
+    out = value != 0;
+    return true;
+}
+
+} // namespace
+
+std::shared_ptr<const GgufTokenizer> GgufTokenizer::load(const std::string& gguf_path,
+                                                         std::string* error) {
+    auto fail = [error](const std::string& reason) -> std::shared_ptr<const GgufTokenizer> {
+        if (error) *error = reason;
+        return nullptr;
+    };
+
+    std::ifstream in(fs::u8path(gguf_path), std::ios::binary);
+    if (!in) return fail("cannot open " + gguf_path);
+
+    char magic[4] = {};
+    uint32_t version = 0;
+    uint64_t tensor_count = 0;
+    uint64_t kv_count = 0;
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, "GGUF", 4) != 0) return fail("not a GGUF file");
+    if (!read_gguf_le(in, version) || !read_gguf_le(in, tensor_count) || !read_gguf_le(in, kv_count)) {
+        return fail("truncated GGUF header");
+    }
+
+    std::shared_ptr<GgufTokenizer> tok(new GgufTokenizer());
+    std::string pre;
+    std::vector<std::string> merges;
+    int64_t bos = -1;
+    int64_t eos = -1;
+    int64_t unk = -1;
+    int add_bos = -1;  // -1: not in the file, use the vocab type's default
+    int add_eos = -1;
+    int add_space_prefix = -1;
+
+    for (uint64_t i = 0; i < kv_count; ++i) {
+        std::string key;
+        uint32_t type = 0;
+        if (!read_gguf_string(in, key) || !read_gguf_le(in, type)) {
+            return fail("truncated GGUF metadata");
+        }
+
+        bool ok = true;
+        if (key == "tokenizer.ggml.model" && type == 8) {
+            ok = read_gguf_string(in, tok->model_type_);
+        } else if (key == "tokenizer.ggml.pre" && type == 8) {
+            ok = read_gguf_string(in, pre);
+        } else if (key == "tokenizer.ggml.tokens") {
+            ok = read_string_array(in, type, tok->tokens_);
+        } else if (key == "tokenizer.ggml.merges") {
+            ok = read_string_array(in, type, merges);
+        } else if ((key == "tokenizer.ggml.scores" || key == "tokenizer.ggml.token_type") && type == 9) {
+            uint32_t elem_type = 0;
+            uint64_t count = 0;
+            ok = read_gguf_le(in, elem_type) && read_gguf_le(in, count) && count <= kMaxArrayLength;
+            if (ok && key == "tokenizer.ggml.scores" && elem_type == 6) {
+                tok->scores_.resize(static_cast<size_t>(count));
+                in.read(reinterpret_cast<char*>(tok->scores_.data()),
+                        static_cast<std::streamsize>(count * sizeof(float)));
+                ok = static_cast<bool>(in);
+            } else if (ok && key == "tokenizer.ggml.token_type") {
+                tok->token_types_.resize(static_cast<size_t>(count));
+                for (auto& value : tok->token_types_) {
+                    int64_t v = 0;
+                    if (!(ok = read_gguf_integer_value(in, elem_type, v))) break;
+                    value = static_cast<int32_t>(v);
+                }
+            } else if (ok) {
+                const uint64_t elem_size = gguf_scalar_size(elem_type);
+                ok = elem_size > 0 && skip_gguf_bytes(in, count * elem_size);
+            }
+        } else if (key == "tokenizer.ggml.bos_token_id") {
+            ok = read_gguf_integer_value(in, type, bos);
+        } else if (key == "tokenizer.ggml.eos_token_id") {
+            ok = read_gguf_integer_value(in, type, eos);
+        } else if (key == "tokenizer.ggml.unknown_token_id") {
+            ok = read_gguf_integer_value(in, type, unk);
+        } else if (key == "tokenizer.ggml.add_bos_token") {
+            ok = read_bool(in, type, add_bos);
+        } else if (key == "tokenizer.ggml.add_eos_token") {
+            ok = read_bool(in, type, add_eos);
+        } else if (key == "tokenizer.ggml.add_space_prefix") {
+            ok = read_bool(in, type, add_space_prefix);
+        } else {
+            ok = skip_gguf_value(in, type);
+        }
+        if (!ok) return fail("unreadable GGUF metadata at " + key);
+    }
+
+    // Defaults llama.cpp applies before the file's own flags
+    if (tok->model_type_ == "llama") {
+        tok->bos_ = 1;
+        tok->eos_ = 2;
+        tok->unk_ = 0;
+        tok->add_bos_ = true;
+        tok->add_space_prefix_ = true;
+    } else if (tok->model_type_ == "gpt2") {
+        static const char* const kGpt2[] = {
+            "gpt-2", "phi-2", "jina-es", "jina-de", "gigachat", "jina-v1-en",
+            "jina-v2-es", "jina-v2-de", "jina-v2-code",
+        };
+        static const char* const kLlama3[] = {
+            "llama3", "llama-v3", "llama-bpe", "falcon3", "pixtral",
+        };
+        static const char* const kQwen2[] = {"qwen2", "deepseek-r1-qwen", "megrez"};
+        auto listed = [&pre](const auto& names) {
+            return std::find(std::begin(names), std::end(names), pre) != std::end(names);
+        };
+        if (listed(kGpt2)) {
+            tok->pre_ = PreTokenizer::Gpt2;
+        } else if (listed(kLlama3)) {
+            tok->pre_ = PreTokenizer::Llama3;
+            tok->ignore_merges_ = true;
+            tok->add_bos_ = true;
+        } else if (listed(kQwen2)) {
+            tok->pre_ = PreTokenizer::Qwen2;
+        } else {
+            return fail("BPE pre-tokenizer '" + pre + "' is not supported");
+        }
+        tok->bos_ = 11;
+        tok->eos_ = 11;
+        tok->add_space_prefix_ = false;
+    } else {
+        return fail("vocab type '" + tok->model_type_ + "' is not supported");
+    }
+
+    if (bos >= 0) tok->bos_ = static_cast<int32_t>(bos);
+    if (eos >= 0) tok->eos_ = static_cast<int32_t>(eos);
+    if (unk >= 0) tok->unk_ = static_cast<int32_t>(unk);
+    if (add_bos >= 0) tok->add_bos_ = add_bos != 0;
+    if (add_eos >= 0) tok->add_eos_ = add_eos != 0;
+    if (add_space_prefix >= 0) tok->add_space_prefix_ = add_space_prefix != 0;
+
+    if (!tok->init(merges, error)) return nullptr;
+    return tok;
+}
+
+bool GgufTokenizer::init(const std::vector<std::string>& merges, std::string* error) {
+    if (tokens_.empty()) {
+        if (error) *error = "no tokenizer.ggml.tokens";
+        return false;
+    }
+    const size_t n = tokens_.size();
+    if (token_types_.size() != n) token_types_.assign(n, kTokenNormal);
+    if (scores_.size() != n) scores_.assign(n, 0.0f);
+
+    token_to_id_.reserve(n);
+    for (size_t id = 0; id < n; ++id) {
+        token_to_id_[tokens_[id]] = static_cast<int32_t>(id);
+    }
+
+    auto valid = [n](int32_t id) { return id >= 0 && static_cast<size_t>(id) < n ? id : -1; };
+    bos_ = valid(bos_);
+    eos_ = valid(eos_);
+    unk_ = valid(unk_);
+
+    for (int b = 0; b < 256; ++b) {
+        int32_t id = -1;
+        if (pre_ == PreTokenizer::None) {
+            char hex[8];
+            std::snprintf(hex, sizeof(hex), "<0x%02X>", b);
+            id = find_token(hex);
+            if (id < 0) id = find_token(std::string(1, static_cast<char>(b)));
+        } else {
+            id = find_token(byte_level().encode[b]);
+        }
+        byte_tokens_[b] = id;
+    }
+
+    if (pre_ != PreTokenizer::None) {
+        if (merges.empty()) {
+            if (error) *error = "BPE vocabulary has no tokenizer.ggml.merges";
+            return false;
+        }
+        merges_.reserve(merges.size());
+        for (size_t rank = 0; rank < merges.size(); ++rank) {
+            const std::string& merge = merges[rank];
+            const size_t split = merge.find(' ', 1);
+            if (split == std::string::npos) continue;
+            const std::string left = merge.substr(0, split);
+            const std::string right = merge.substr(split + 1);
+            const int32_t left_id = find_token(left);
+            const int32_t right_id = find_token(right);
+            const int32_t merged_id = find_token(left + right);
+            if (left_id < 0 || right_id < 0 || merged_id < 0) continue;
+            // Keep the best rank when a pair is listed twice
+            merges_.emplace(pack_pair(left_id, right_id),
+                            std::make_pair(static_cast<int32_t>(rank), merged_id));
+        }
+    }
+
+    for (size_t id = 0; id < n; ++id) {
+        const int32_t type = token_types_[id];
+        if ((type == kTokenControl || type == kTokenUserDefined || type == kTokenUnknown) &&
+            !tokens_[id].empty()) {
+            specials_by_byte_[static_cast<unsigned char>(tokens_[id][0])].push_back(static_cast<int32_t>(id));
+        }
+    }
+    for (auto& candidates : specials_by_byte_) {
+        std::stable_sort(candidates.begin(), candidates.end(), [this](int32_t a, int32_t b) {
+            return tokens_[a].size() > tokens_[b].size();
+        });
+    }
+    return true;
+}
+
+int32_t GgufTokenizer::find_token(const std::string& text) const {
+    const auto it = token_to_id_.find(text);
+    return it == token_to_id_.end() ? -1 : it->second;
+}
+
+std::vector<int32_t> GgufTokenizer::tokenize(const std::string& text, bool add_special,
+                                             bool parse_special) const {
+    std::vector<int32_t> out;
+    out.reserve(text.size() / 3 + 2);
+    if (add_special && add_bos_ && bos_ >= 0) out.push_back(bos_);
+
+    // Text between special tokens is tokenized as its own fragment, like
+    // llama.cpp's partitioning; SentencePiece prefixes a space to fragments
+    // that start the text or follow a special token
+    bool prev_special = true;
+    size_t fragment_start = 0;
+    auto flush_fragment = [&](size_t end) {
+        if (end <= fragment_start) return;
+        if (pre_ == PreTokenizer::None) {
+            std::string fragment;
+            if (add_space_prefix_ && prev_special) fragment = " ";
+            fragment.append(text, fragment_start, end - fragment_start);
+            tokenize_spm(fragment, out);
+        } else {
+            tokenize_bpe(text.substr(fragment_start, end - fragment_start), out);
+        }
+        prev_special = false;
+    };
+
+    size_t pos = 0;
+    while (pos < text.size()) {
+        int32_t match = -1;
+        for (int32_t id : specials_by_byte_[static_cast<unsigned char>(text[pos])]) {
+            // User-defined tokens always split; control tokens only when asked
+            if (!parse_special && token_types_[id] != kTokenUserDefined) continue;
+            if (text.compare(pos, tokens_[id].size(), tokens_[id]) == 0) {
+                match = id;
+                break;
+            }
+        }
+        if (match < 0) {
+            ++pos;
+            continue;
+        }
+        flush_fragment(pos);
+        out.push_back(match);
+        prev_special = true;
+        pos += tokens_[match].size();
+        fragment_start = pos;
+    }
+    flush_fragment(text.size());
+
+    if (add_special && add_eos_ && eos_ >= 0) out.push_back(eos_);
+    return out;
+}
+
+void GgufTokenizer::tokenize_spm(const std::string& raw, std::vector<int32_t>& out) const {
+    std::string text;
+    text.reserve(raw.size() + raw.size() / 4);
+    for (char c : raw) {
+        if (c == ' ') {
+            text += kSpmSpace;
+        } else {
+            text += c;
+        }
+    }
+
+    struct Symbol {
+        size_t offset;
+        size_t length;
+        int prev;
+        int next;
+    };
+    std::vector<Symbol> symbols;
+    symbols.reserve(text.size());
+    for (size_t offset = 0; offset < text.size();) {
+        const size_t length = std::min(spm_symbol_length(text[offset]), text.size() - offset);
+        const int index = static_cast<int>(symbols.size());
+        symbols.push_back({offset, length, index - 1, offset + length == text.size() ? -1 : index + 1});
+        offset += length;
+    }
+
+    // Highest score first, leftmost on ties
+    struct Bigram {
+        float score;
+        int left;
+        int right;
+        size_t length;
+    };
+    auto lower_priority = [](const Bigram& a, const Bigram& b) {
+        return a.score < b.score || (a.score == b.score && a.left > b.left);
+    };
+    std::priority_queue<Bigram, std::vector<Bigram>, decltype(lower_priority)> queue(lower_priority);
+
+    std::string piece;
+    auto add_bigram = [&](int left, int right) {
+        if (left < 0 || right < 0) return;
+        const size_t length = symbols[left].length + symbols[right].length;
+        piece.assign(text, symbols[left].offset, length);
+        const int32_t id = find_token(piece);
+        if (id < 0) return;
+        queue.push({scores_[id], left, right, length});
+    };
+
+    for (size_t i = 1; i < symbols.size(); ++i) {
+        add_bigram(static_cast<int>(i - 1), static_cast<int>(i));
+    }
+
+    while (!queue.empty()) {
+        const Bigram bigram = queue.top();
+        queue.pop();
+        Symbol& left = symbols[bigram.left];
+        Symbol& right = symbols[bigram.right];
+        // Skip pairs where either side has since been merged
+        if (left.length == 0 || right.length == 0 || left.length + right.length != bigram.length) {
+            continue;
+        }
+        left.length += right.length;
+        right.length = 0;
+        left.next = right.next;
+        if (right.next >= 0) symbols[right.next].prev = bigram.left;
+        add_bigram(left.prev, bigram.left);
+        add_bigram(bigram.left, left.next);
+    }
+
+    for (int i = symbols.empty() ? -1 : 0; i != -1; i = symbols[i].next) {
+        piece.assign(text, symbols[i].offset, symbols[i].length);
+        const int32_t id = find_token(piece);
+        if (id >= 0) {
+            out.push_back(id);
+            continue;
+        }
+        // Only single characters can miss the vocabulary: spell them in bytes
+        for (size_t j = 0; j < symbols[i].length; ++j) {
+            const int32_t byte_id = byte_tokens_[static_cast<unsigned char>(text[symbols[i].offset + j])];
+            const int32_t fallback = byte_id >= 0 ? byte_id : unk_;
+            if (fallback >= 0) out.push_back(fallback);
+        }
+    }
+}
+
+void GgufTokenizer::tokenize_bpe(const std::string& text, std::vector<int32_t>& out) const {
+    const auto cps = decode_utf8(text.data(), text.size());
+    std::vector<std::pair<size_t, size_t>> words;
+    switch (pre_) {
+        case PreTokenizer::Llama3:
+            split_words(cps, true, 3, words);
+            break;
+        case PreTokenizer::Qwen2:
+            split_words(cps, true, 1, words);
+            break;
+        default:
+            split_words(cps, false, 0, words);
+            break;
+    }
+    for (const auto& word : words) {
+        const size_t begin = cps[word.first].offset;
+        const size_t end = word.second < cps.size() ? cps[word.second].offset : text.size();
+        bpe_word(text.data() + begin, end - begin, out);
+    }
+}
+
+void GgufTokenizer::bpe_word(const char* data, size_t len, std::vector<int32_t>& out) const {
+    const ByteLevel& bytes = byte_level();
+    if (ignore_merges_) {
+        std::string encoded;
+        for (size_t i = 0; i < len; ++i) {
+            encoded += bytes.encode[static_cast<unsigned char>(data[i])];
+        }
+        const int32_t id = find_token(encoded);
+        if (id >= 0) {
+            out.push_back(id);
+            return;
+        }
+    }
+
+    // One symbol per byte; a merged-away symbol has id -2
+    struct Symbol {
+        int32_t id;
+        int prev;
+        int next;
+    };
+    std::vector<Symbol> symbols(len);
+    for (size_t i = 0; i < len; ++i) {
+        symbols[i] = {byte_tokens_[static_cast<unsigned char>(data[i])], static_cast<int>(i) - 1,
+                      i + 1 < len ? static_cast<int>(i) + 1 : -1};
+    }
+
+    // Lowest rank first, leftmost on ties
+    struct Bigram {
+        int32_t rank;
+        int left;
+        int right;
+        int32_t left_id;
+        int32_t right_id;
+        int32_t merged_id;
+    };
+    auto lower_priority = [](const Bigram& a, const Bigram& b) {
+        return a.rank > b.rank || (a.rank == b.rank && a.left > b.left);
+    };
+    std::priority_queue<Bigram, std::vector<Bigram>, decltype(lower_priority)> queue(lower_priority);
+
+    auto add_bigram = [&](int left, int right) {
+        if (left < 0 || right < 0) return;
+        const int32_t left_id = symbols[left].id;
+        const int32_t right_id = symbols[right].id;
+        if (left_id < 0 || right_id < 0) return;
+        const auto it = merges_.find(pack_pair(left_id, right_id));
+        if (it == merges_.end()) return;
+        queue.push({it->second.first, left, right, left_id, right_id, it->second.second});
+    };
+
+    for (size_t i = 1; i < len; ++i) {
+        add_bigram(static_cast<int>(i - 1), static_cast<int>(i));
+    }
+
+    while (!queue.empty()) {
+        const Bigram bigram = queue.top();
+        queue.pop();
+        Symbol& left = symbols[bigram.left];
+        Symbol& right = symbols[bigram.right];
+        if (left.id != bigram.left_id || right.id != bigram.right_id || left.next != bigram.right) {
+            continue;
+        }
+        left.id = bigram.merged_id;
+        left.next = right.next;
+        right.id = -2;
+        if (right.next >= 0) symbols[right.next].prev = bigram.left;
+        add_bigram(left.prev, bigram.left);
+        add_bigram(bigram.left, left.next);
+    }
+
+    for (int i = len == 0 ? -1 : 0; i != -1; i = symbols[i].next) {
+        if (symbols[i].id >= 0) {
+            out.push_back(symbols[i].id);
+        } else if (unk_ >= 0) {
+            out.push_back(unk_);
+        }
+    }
+}
+
+std::string GgufTokenizer::token_to_piece(int32_t id) const {
+    if (id < 0 || static_cast<size_t>(id) >= tokens_.size()) return {};
+    const std::string& text = tokens_[id];
+    const int32_t type = token_types_[id];
+
+    if (pre_ == PreTokenizer::None) {
+        if (type == kTokenByte && text.size() == 6) {
+            return std::string(1, static_cast<char>(std::stoi(text.substr(3, 2), nullptr, 16)));
+        }
+        if (type != kTokenNormal && type != kTokenUserDefined) return text;
+        std::string piece;
+        for (size_t pos = 0; pos < text.size();) {
+            if (text.compare(pos, 3, kSpmSpace) == 0) {
+                piece += ' ';
+                pos += 3;
+            } else {
+                piece += text[pos++];
+            }
+        }
+        return piece;
+    }
+
+    if (type != kTokenNormal) return text;
+    const ByteLevel& bytes = byte_level();
+    std::string piece;
+    for (const auto& cp : decode_utf8(text.data(), text.size())) {
+        const auto it = bytes.decode.find(cp.value);
+        if (it != bytes.decode.end()) {
+            piece += static_cast<char>(it->second);
+        } else {
+            append_utf8(piece, cp.value);
+        }
+    }
+    return piece;
+}
+
+std::shared_ptr<const GgufTokenizer> GgufTokenizerCache::get(const std::string& gguf_path) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(gguf_path);
+        if (it != index_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return it->second->second;
+        }
+    }
+
+    // Read outside the lock: a large vocabulary takes a moment and lookups
+    // for other models should not wait on it
+    std::string error;
+    auto tokenizer = GgufTokenizer::load(gguf_path, &error);
+    if (tokenizer) {
+        LOG(DEBUG, "Tokenizer") << "Loaded " << tokenizer->model_type() << " vocabulary ("
+                                << tokenizer->vocab_size() << " tokens) from " << gguf_path << std::endl;
+    } else {
+        LOG(DEBUG, "Tokenizer") << "No in-process tokenizer for " << gguf_path << ": " << error << std::endl;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(gguf_path);
+    if (it != index_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return it->second->second;
+    }
+    lru_.emplace_front(gguf_path, tokenizer);
+    index_[gguf_path] = lru_.begin();
+    if (lru_.size() > capacity_) {
+        index_.erase(lru_.back().first);
+        lru_.pop_back();
+    }
+    return tokenizer;
+}
+
+} // namespace lemon
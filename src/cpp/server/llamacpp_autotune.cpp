@@ -0,0 +1,205 @@
+#include "lemon/llamacpp_autotune.h"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+namespace lemon {
+
+using json = nlohmann::json;
+
+json LlamaCppTuning::to_json() const {
+    return {
+        {"threads", threads},
+        {"batch_size", batch_size},
+        {"ubatch_size", ubatch_size},
+        {"parallel", parallel},
+        {"flash_attn", flash_attn},
+        {"prefill_tps", prefill_tps},
+        {"decode_tps", decode_tps}
+    };
+}
+
+LlamaCppTuning LlamaCppTuning::from_json(const json& j) {
+    LlamaCppTuning t;
+    if (!j.is_object()) {
+        return t;
+    }
+    auto get_int = [&j](const char* key, int fallback) {
+        auto it = j.find(key);
+        return it != j.end() && it->is_number() ? it->get<int>() : fallback;
+    };
+    auto get_double = [&j](const char* key) {
+        auto it = j.find(key);
+        return it != j.end() && it->is_number() ? it->get<double>() : 0.0;
+    };
+    t.threads = get_int("threads", 0);
+    t.batch_size = get_int("batch_size", 0);
+    t.ubatch_size = get_int("ubatch_size", 0);
+    t.parallel = get_int("parallel", 0);
+    t.flash_attn = get_int("flash_attn", -1);
+    t.prefill_tps = get_double("prefill_tps");
+    t.decode_tps = get_double("decode_tps");
+    return t;
+}
+
+double reference_request_seconds(double prefill_tps, double decode_tps) {
+    if (prefill_tps <= 0.0 || decode_tps <= 0.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return AUTOTUNE_PROMPT_TOKENS / prefill_tps + AUTOTUNE_GEN_TOKENS / decode_tps;
+}
+
+// Each line of the JSONL output that parses as an object
+static std::vector<json> parse_jsonl_objects(const std::string& output) {
+    std::vector<json> rows;
+    std::istringstream in(output);
+    std::string line;
+    while (std::getline(in, line)) {
+        const size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] != '{') {
+            continue;
+        }
+        json row = json::parse(line.begin() + start, line.end(), nullptr, false);
+        if (row.is_object()) {
+            rows.push_back(std::move(row));
+        }
+    }
+    return rows;
+}
+
+// Older llama-bench builds report flash_attn as 0/1, newer ones as a bool
+static int json_flag(const json& row, const char* key) {
+    auto it = row.find(key);
+    if (it == row.end()) return -1;
+    if (it->is_boolean()) return it->get<bool>() ? 1 : 0;
+    if (it->is_number()) return it->get<int>() != 0 ? 1 : 0;
+    return -1;
+}
+
+std::vector<LlamaCppTuning> parse_llama_bench_jsonl(const std::string& output) {
+    std::vector<LlamaCppTuning> results;
+    for (const json& row : parse_jsonl_objects(output)) {
+        const int n_prompt = row.value("n_prompt", 0);
+        const int n_gen = row.value("n_gen", 0);
+        const double avg_ts = row.value("avg_ts", 0.0);
+        if (avg_ts <= 0.0 || (n_prompt > 0) == (n_gen > 0)) {
+            continue;  // Combined pg tests are not used
+        }
+
+        LlamaCppTuning key;
+        key.threads = row.value("n_threads", 0);
+        key.batch_size = row.value("n_batch", 0);
+        key.ubatch_size = row.value("n_ubatch", 0);
+        key.flash_attn = json_flag(row, "flash_attn");
+
+        auto it = std::find_if(results.begin(), results.end(), [&key](const LlamaCppTuning& r) {
+            return r.threads == key.threads && r.batch_size == key.batch_size &&
+                   r.ubatch_size == key.ubatch_size && r.flash_attn == key.flash_attn;
+        });
+        if (it == results.end()) {
+            results.push_back(key);
+            it = results.end() - 1;
+        }
+        (n_prompt > 0 ? it->prefill_tps : it->decode_tps) = avg_ts;
+    }
+    return results;
+}
+
+LlamaCppTuning pick_fastest(const std::vector<LlamaCppTuning>& results) {
+    LlamaCppTuning best;
+    double best_seconds = std::numeric_limits<double>::infinity();
+    for (const auto& r : results) {
+        if (r.ubatch_size > r.batch_size) {
+            continue;
+        }
+        const double seconds = reference_request_seconds(r.prefill_tps, r.decode_tps);
+        if (seconds < best_seconds) {
+            best = r;
+            best_seconds = seconds;
+        }
+    }
+    return best;
+}
+
+std::vector<BatchedBenchResult> parse_batched_bench_jsonl(const std::string& output) {
+    std::vector<BatchedBenchResult> results;
+    for (const json& row : parse_jsonl_objects(output)) {
+        BatchedBenchResult r;
+        r.parallel = row.value("pl", 0);
+        r.decode_tps = row.value("speed_tg", 0.0);
+        if (r.parallel > 0 && r.decode_tps > 0.0) {
+            results.push_back(r);
+        }
+    }
+    return results;
+}
+
+int pick_parallel(const std::vector<BatchedBenchResult>& results) {
+    double single = 0.0;
+    for (const auto& r : results) {
+        if (r.parallel == 1) {
+            single = r.decode_tps;
+        }
+    }
+    int best = 1;
+    if (single <= 0.0) {
+        return best;
+    }
+    for (const auto& r : results) {
+        if (r.parallel > best && r.decode_tps / r.parallel >= 0.5 * single) {
+            best = r.parallel;
+        }
+    }
+    return best;
+}
+
+std::vector<int> autotune_thread_candidates(int cores, int threads) {
+    std::vector<int> candidates;
+    for (int n : {cores / 2, cores, threads}) {
+        if (n > 0) {
+            candidates.push_back(n);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    return candidates;
+}
+
+std::string host_fingerprint(const json& devices, const std::string& backend) {
+    std::string fingerprint = backend;
+    if (!devices.is_object()) {
+        return fingerprint;
+    }
+    const json cpu = devices.value("cpu", json::object());
+    if (cpu.is_object()) {
+        fingerprint += "|" + cpu.value("name", std::string("unknown cpu"));
+        fingerprint += "|" + std::to_string(cpu.value("threads", 0)) + "t";
+    }
+
+    if (backend != "cpu") {
+        for (const char* key : {"amd_gpu", "nvidia_gpu"}) {
+            const json gpus = devices.value(key, json::array());
+            if (!gpus.is_array()) continue;
+            for (const auto& gpu : gpus) {
+                if (gpu.is_object() && gpu.value("available", true)) {
+                    fingerprint += "|" + gpu.value("name", std::string(key));
+                }
+            }
+        }
+    }
+    return fingerprint;
+}
+
+std::optional<LlamaCppTuning> find_tuning(const json& tunings, const std::string& fingerprint) {
+    if (!tunings.is_object() || !tunings.contains(fingerprint)) {
+        return std::nullopt;
+    }
+    LlamaCppTuning t = LlamaCppTuning::from_json(tunings[fingerprint]);
+    if (!t.valid()) {
+        return std::nullopt;
+    }
+    return t;
+}
+
+} // namespace lemon
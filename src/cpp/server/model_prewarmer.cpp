@@ -0,0 +1,204 @@
+#include "lemon/model_prewarmer.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "lemon/utils/aixlog.hpp"
+
+namespace fs = std::filesystem;
+
+namespace lemon {
+
+namespace {
+
+uint64_t half_of_physical_memory() {
+#if defined(_SC_PHYS_PAGES) && defined(_SC_PAGESIZE)
+    const long pages = sysconf(_SC_PHYS_PAGES);
+    const long page_size = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && page_size > 0) {
+        return static_cast<uint64_t>(pages) * static_cast<uint64_t>(page_size) / 2;
+    }
+#endif
+    return UINT64_MAX;
+}
+
+// Lets the kernel start reading ahead before our own reads get there
+void advise_will_need(const std::string& path) {
+#if defined(POSIX_FADV_WILLNEED)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    close(fd);
+#else
+    (void)path;
+#endif
+}
+
+} // namespace
+
+ModelPrewarmer::ModelPrewarmer(int threads, size_t chunk_bytes, uint64_t max_bytes)
+    : threads_(std::max(threads, 1)),
+      chunk_bytes_(std::max<size_t>(chunk_bytes, 64 * 1024)),
+      max_bytes_(max_bytes > 0 ? max_bytes : half_of_physical_memory()) {}
+
+ModelPrewarmer::~ModelPrewarmer() {
+    std::map<std::string, std::shared_ptr<Job>> jobs;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs.swap(jobs_);
+    }
+    for (auto& [key, job] : jobs) {
+        job->cancelled = true;
+        for (auto& worker : job->workers) {
+            worker.join();
+        }
+    }
+}
+
+bool ModelPrewarmer::enabled() {
+    const char* raw = std::getenv("LEMONADE_MODEL_PREWARM");
+    return !raw || std::string(raw) != "0";
+}
+
+bool ModelPrewarmer::start(const std::string& key, const std::vector<std::string>& paths) {
+    std::shared_ptr<Job> stale;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = jobs_.find(key);
+        if (it != jobs_.end()) {
+            // A finished prewarm nobody collected (the load never happened)
+            // does not block a new one
+            if (it->second->elapsed_us.load() < 0) {
+                return false;
+            }
+            stale = it->second;
+            jobs_.erase(it);
+        }
+    }
+    if (stale) {
+        for (auto& worker : stale->workers) {
+            worker.join();
+        }
+    }
+
+    auto job = std::make_shared<Job>();
+    uint64_t budget = max_bytes_;
+    for (const auto& path : paths) {
+        std::error_code ec;
+        if (path.empty() || !fs::is_regular_file(fs::u8path(path), ec)) {
+            continue;
+        }
+        uint64_t size = fs::file_size(fs::u8path(path), ec);
+        if (ec || size == 0) {
+            continue;
+        }
+        size = std::min(size, budget);
+        if (size == 0) {
+            break;
+        }
+        budget -= size;
+
+        const size_t file_index = job->files.size();
+        job->files.push_back(path);
+        for (uint64_t offset = 0; offset < size; offset += chunk_bytes_) {
+            job->chunks.push_back({file_index, offset, std::min<uint64_t>(chunk_bytes_, size - offset)});
+        }
+        job->total_bytes += size;
+    }
+    if (job->chunks.empty()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!jobs_.emplace(key, job).second) {
+        return false;
+    }
+
+    LOG(DEBUG, "Prewarm") << "Prewarming " << (job->total_bytes / (1024 * 1024)) << " MB in "
+                          << job->files.size() << " file(s) for " << key << std::endl;
+    job->started = std::chrono::steady_clock::now();
+    const int workers = static_cast<int>(std::min<size_t>(threads_, job->chunks.size()));
+    for (int i = 0; i < workers; ++i) {
+        job->workers.emplace_back([this, job, i]() { read_chunks(*job, i == 0); });
+    }
+    return true;
+}
+
+void ModelPrewarmer::read_chunks(Job& job, bool advise) {
+    // One worker issues the readahead hints while the others start reading
+    if (advise) {
+        for (const auto& path : job.files) {
+            advise_will_need(path);
+        }
+    }
+
+    std::vector<char> buffer(chunk_bytes_);
+    std::ifstream file;
+    size_t open_index = SIZE_MAX;
+
+    while (!job.cancelled.load(std::memory_order_relaxed)) {
+        // Workers take consecutive chunks, so each file is read front to back
+        const size_t index = job.next_chunk.fetch_add(1);
+        if (index >= job.chunks.size()) {
+            break;
+        }
+        const Chunk& chunk = job.chunks[index];
+        if (chunk.file != open_index) {
+            file.close();
+            file.clear();
+            file.open(fs::u8path(job.files[chunk.file]), std::ios::binary);
+            open_index = chunk.file;
+        }
+        file.clear();
+        if (file.is_open() && file.seekg(static_cast<std::streamoff>(chunk.offset))) {
+            file.read(buffer.data(), static_cast<std::streamsize>(chunk.length));
+            job.bytes.fetch_add(static_cast<uint64_t>(file.gcount()), std::memory_order_relaxed);
+        }
+        if (job.finished_chunks.fetch_add(1) + 1 == job.chunks.size()) {
+            job.elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - job.started).count();
+        }
+    }
+}
+
+std::optional<ModelPrewarmer::Stats> ModelPrewarmer::finish(const std::string& key) {
+    std::shared_ptr<Job> job;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = jobs_.find(key);
+        if (it == jobs_.end()) {
+            return std::nullopt;
+        }
+        job = it->second;
+        jobs_.erase(it);
+    }
+
+    job->cancelled = true;
+    for (auto& worker : job->workers) {
+        worker.join();
+    }
+
+    Stats stats;
+    stats.bytes = job->bytes.load();
+    stats.total_bytes = job->total_bytes;
+    stats.completed = job->elapsed_us.load() >= 0;
+    // Throughput covers the time spent reading, not time idle after completion
+    const int64_t elapsed_us = stats.completed
+        ? job->elapsed_us.load()
+        : std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::steady_clock::now() - job->started).count();
+    stats.seconds = static_cast<double>(elapsed_us) / 1e6;
+    return stats;
+}
+
+} // namespace lemon
@@ -551,114 +551,27 @@ json OllamaApi::convert_openai_chat_to_ollama(const json& openai_response, const
 }
 
 // ============================================================================
-// Response conversion: OpenAI streaming delta → Ollama streaming chunk
+// Common streaming adapter: OpenAI SSE → target dialect
+// Feeds the backend's SSE bytes through the transcoder as they arrive and
+// writes its closing message when the backend stream ends.
 // ============================================================================
-json OllamaApi::convert_openai_delta_to_ollama(const json& openai_chunk, const std::string& model) {
-    json ollama_chunk;
-    ollama_chunk["model"] = model;
-    ollama_chunk["created_at"] = "2024-01-01T00:00:00Z";
-    ollama_chunk["done"] = false;
-
-    // Extract delta content
-    if (openai_chunk.contains("choices") && !openai_chunk["choices"].empty()) {
-        const auto& choice = openai_chunk["choices"][0];
-        if (choice.contains("delta")) {
-            const auto& delta = choice["delta"];
-            json msg;
-            msg["role"] = (delta.contains("role") && delta["role"].is_string())
-                          ? delta["role"].get<std::string>() : "assistant";
-            msg["content"] = (delta.contains("content") && delta["content"].is_string())
-                             ? delta["content"].get<std::string>() : "";
-
-            // Map reasoning_content → thinking (Ollama uses "thinking" for reasoning models)
-            if (delta.contains("reasoning_content") && delta["reasoning_content"].is_string()) {
-                msg["thinking"] = delta["reasoning_content"].get<std::string>();
-            }
-
-            if (delta.contains("tool_calls")) {
-                msg["tool_calls"] = delta["tool_calls"];
-            }
-
-            ollama_chunk["message"] = msg;
-        }
-
-        // Check for finish_reason
-        if (choice.contains("finish_reason") && !choice["finish_reason"].is_null()) {
-            ollama_chunk["done"] = true;
-            ollama_chunk["done_reason"] = choice["finish_reason"];
-        }
-    }
-
-    return ollama_chunk;
-}
-
-// ============================================================================
-// Common streaming adapter: SSE → NDJSON
-// Parses OpenAI SSE stream, converts each chunk via convert_chunk, writes
-// NDJSON to the client, and sends a final done message via build_done.
-// ============================================================================
-void OllamaApi::stream_sse_to_ndjson(const std::string& openai_body,
-                                      httplib::DataSink& client_sink,
-                                      ChunkConverter convert_chunk,
-                                      DoneBuilder build_done,
-                                      StreamFn call_router) {
+void OllamaApi::stream_transcoded(const std::string& openai_body,
+                                  httplib::DataSink& client_sink,
+                                  SseTranscoder& transcoder,
+                                  StreamFn call_router) {
     httplib::DataSink adapter_sink;
-    std::string sse_buffer;
-    int eval_count = 0;
-    int prompt_eval_count = 0;
+    auto write = [&client_sink](const char* data, size_t len) {
+        return client_sink.write(data, len);
+    };
 
     adapter_sink.is_writable = client_sink.is_writable;
 
-    adapter_sink.write = [&client_sink, &sse_buffer, &eval_count,
-                          &prompt_eval_count, &convert_chunk](const char* data, size_t len) -> bool {
-        sse_buffer.append(data, len);
-
-        size_t pos;
-        while ((pos = sse_buffer.find('\n')) != std::string::npos) {
-            std::string line = sse_buffer.substr(0, pos);
-            sse_buffer.erase(0, pos + 1);
-
-            if (!line.empty() && line.back() == '\r') {
-                line.pop_back();
-            }
-
-            if (line.empty() || line.find("data: ") != 0) {
-                continue;
-            }
-
-            std::string json_str = line.substr(6);
-            if (json_str == "[DONE]") {
-                continue;
-            }
-
-            try {
-                auto openai_chunk = json::parse(json_str);
-
-                // Track token counts from usage in final chunk
-                if (openai_chunk.contains("usage")) {
-                    const auto& usage = openai_chunk["usage"];
-                    if (usage.contains("prompt_tokens"))
-                        prompt_eval_count = usage["prompt_tokens"].get<int>();
-                    if (usage.contains("completion_tokens"))
-                        eval_count = usage["completion_tokens"].get<int>();
-                }
-
-                auto ollama_chunk = convert_chunk(openai_chunk);
-                std::string ndjson = ollama_chunk.dump() + "\n";
-                if (!client_sink.write(ndjson.c_str(), ndjson.size())) {
-                    return false;
-                }
-            } catch (const std::exception& e) {
-                LOG(ERROR, "OllamaApi") << "Failed to parse SSE chunk: " << e.what() << std::endl;
-            }
-        }
-        return true;
+    adapter_sink.write = [&transcoder, &write](const char* data, size_t len) -> bool {
+        return transcoder.feed(data, len, write);
     };
 
-    adapter_sink.done = [&client_sink, &eval_count, &prompt_eval_count, &build_done]() {
-        json done_msg = build_done(prompt_eval_count, eval_count);
-        std::string ndjson = done_msg.dump() + "\n";
-        client_sink.write(ndjson.c_str(), ndjson.size());
+    adapter_sink.done = [&client_sink, &transcoder, &write]() {
+        transcoder.finish(write);
         client_sink.done();
     };
 
@@ -755,23 +668,8 @@ void OllamaApi::handle_chat(const httplib::Request& req, httplib::Response& res)
                 "application/x-ndjson",
                 [this, openai_body, model](size_t offset, httplib::DataSink& sink) {
                     if (offset > 0) return false;
-                    stream_sse_to_ndjson(openai_body, sink,
-                        // Convert each SSE chunk to Ollama chat format
-                        [this, &model](const json& chunk) {
-                            return convert_openai_delta_to_ollama(chunk, model);
-                        },
-                        // Build final done message
-                        [&model](int prompt_eval_count, int eval_count) -> json {
-                            return {
-                                {"model", model}, {"created_at", "2024-01-01T00:00:00Z"},
-                                {"message", {{"role", "assistant"}, {"content", ""}}},
-                                {"done", true}, {"done_reason", "stop"},
-                                {"total_duration", 0}, {"load_duration", 0},
-                                {"prompt_eval_count", prompt_eval_count}, {"prompt_eval_duration", 0},
-                                {"eval_count", eval_count}, {"eval_duration", 0}
-                            };
-                        },
-                        // Router stream function
+                    SseTranscoder transcoder(SseTranscoder::Target::OllamaChat, model);
+                    stream_transcoded(openai_body, sink, transcoder,
                         [this](const std::string& body, httplib::DataSink& s) {
                             router_->chat_completion_stream(body, s);
                         }
@@ -866,40 +764,8 @@ void OllamaApi::handle_generate(const httplib::Request& req, httplib::Response&
                 "application/x-ndjson",
                 [this, openai_body, model](size_t offset, httplib::DataSink& sink) {
                     if (offset > 0) return false;
-                    stream_sse_to_ndjson(openai_body, sink,
-                        // Convert each SSE chunk to Ollama generate format
-                        [&model](const json& openai_chunk) -> json {
-                            json ollama_chunk = {
-                                {"model", model}, {"created_at", "2024-01-01T00:00:00Z"},
-                                {"done", false}
-                            };
-                            if (openai_chunk.contains("choices") && !openai_chunk["choices"].empty()) {
-                                const auto& choice = openai_chunk["choices"][0];
-                                if (choice.contains("text"))
-                                    ollama_chunk["response"] = choice["text"];
-                                else if (choice.contains("delta") && choice["delta"].contains("content"))
-                                    ollama_chunk["response"] = choice["delta"]["content"];
-                                else
-                                    ollama_chunk["response"] = "";
-                                if (choice.contains("finish_reason") && !choice["finish_reason"].is_null()) {
-                                    ollama_chunk["done"] = true;
-                                    ollama_chunk["done_reason"] = choice["finish_reason"];
-                                }
-                            }
-                            return ollama_chunk;
-                        },
-                        // Build final done message
-                        [&model](int prompt_eval_count, int eval_count) -> json {
-                            return {
-                                {"model", model}, {"created_at", "2024-01-01T00:00:00Z"},
-                                {"response", ""}, {"done", true}, {"done_reason", "stop"},
-                                {"context", json::array()},
-                                {"total_duration", 0}, {"load_duration", 0},
-                                {"prompt_eval_count", prompt_eval_count}, {"prompt_eval_duration", 0},
-                                {"eval_count", eval_count}, {"eval_duration", 0}
-                            };
-                        },
-                        // Router stream function
+                    SseTranscoder transcoder(SseTranscoder::Target::OllamaGenerate, model);
+                    stream_transcoded(openai_body, sink, transcoder,
                         [this](const std::string& body, httplib::DataSink& s) {
                             router_->completion_stream(body, s);
                         }
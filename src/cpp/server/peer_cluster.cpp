@@ -0,0 +1,192 @@
+#include "lemon/peer_cluster.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+#include "lemon/utils/aixlog.hpp"
+#include "lemon/utils/http_client.h"
+
+namespace lemon {
+
+using json = nlohmann::json;
+
+namespace {
+
+// A peer that misses this many polls in a row drops out of routing
+constexpr int STALE_AFTER_POLLS = 3;
+
+std::string make_node_id() {
+    std::random_device rd;
+    std::mt19937_64 gen((static_cast<uint64_t>(rd()) << 32) ^ rd());
+    std::ostringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << gen();
+    return ss.str();
+}
+
+} // namespace
+
+PeerCluster::PeerCluster() : node_id_(make_node_id()) {}
+
+PeerCluster::~PeerCluster() {
+    stop();
+}
+
+void PeerCluster::start(const std::vector<std::string>& static_peers,
+                        const std::string& api_key,
+                        bool accept_discovered,
+                        int poll_interval_ms) {
+    stop();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        api_key_ = api_key;
+        accept_discovered_ = accept_discovered;
+        poll_interval_ = std::chrono::milliseconds(std::max(poll_interval_ms, 100));
+        // Drop peers from a previous `peers` setting or from discovery that
+        // has since been turned off
+        peers_.clear();
+        for (const auto& url : static_peers) {
+            peers_.emplace(url, Peer{});
+        }
+    }
+    LOG(INFO, "Peers") << "Peer forwarding enabled (node " << node_id_ << ", "
+                       << static_peers.size() << " configured peer(s)"
+                       << (accept_discovered ? ", discovery on" : "") << ")" << std::endl;
+    running_ = true;
+    poll_thread_ = std::thread(&PeerCluster::poll_loop, this);
+}
+
+void PeerCluster::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        running_ = false;
+    }
+    wake_cv_.notify_all();
+    if (poll_thread_.joinable()) {
+        poll_thread_.join();
+    }
+}
+
+void PeerCluster::add_discovered(const std::string& url) {
+    if (url.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!accept_discovered_) {
+        return;
+    }
+    if (peers_.emplace(url, Peer{}).second) {
+        LOG(DEBUG, "Peers") << "Discovered peer " << url << std::endl;
+    }
+}
+
+void PeerCluster::poll_loop() {
+    while (running_) {
+        std::vector<std::string> urls;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& [url, peer] : peers_) {
+                if (!peer.self) {
+                    urls.push_back(url);
+                }
+            }
+        }
+        for (const auto& url : urls) {
+            if (!running_) {
+                return;
+            }
+            poll_peer(url);
+        }
+
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_cv_.wait_for(lock, poll_interval_, [this]() { return !running_; });
+    }
+}
+
+void PeerCluster::poll_peer(const std::string& url) {
+    std::map<std::string, std::string> headers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!api_key_.empty()) {
+            headers["Authorization"] = "Bearer " + api_key_;
+        }
+    }
+
+    PeerStatus status;
+    try {
+        auto response = utils::HttpClient::get(url + "peer/status", headers, 2);
+        if (response.status_code != 200) {
+            return;
+        }
+        status = PeerStatus::from_json(json::parse(response.body));
+    } catch (const std::exception& e) {
+        LOG(DEBUG, "Peers") << "Peer " << url << " did not answer: " << e.what() << std::endl;
+        return;
+    }
+    // The URL the peer was reached at is the one to forward to
+    status.url = url;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = peers_.find(url);
+    if (it == peers_.end()) {
+        return;
+    }
+    Peer& peer = it->second;
+    if (status.node_id == node_id_) {
+        // Our own beacon, or a configured address that points back here
+        peer.self = true;
+        return;
+    }
+    if (!peer.ever_ok) {
+        LOG(INFO, "Peers") << "Peer " << url << " (" << status.hostname << ") is up with "
+                           << status.loaded_models.size() << " model(s) loaded" << std::endl;
+    }
+    peer.status = std::move(status);
+    peer.last_ok = std::chrono::steady_clock::now();
+    peer.ever_ok = true;
+}
+
+std::vector<PeerStatus> PeerCluster::live_peers() const {
+    std::vector<PeerStatus> live;
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [url, peer] : peers_) {
+        if (!peer.self && peer.ever_ok && now - peer.last_ok < poll_interval_ * STALE_AFTER_POLLS) {
+            live.push_back(peer.status);
+        }
+    }
+    return live;
+}
+
+void PeerCluster::record_forward(const std::string& peer_url, const std::string& model_name, PeerRoute route) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    forwards_[std::make_tuple(peer_url, model_name, std::string(peer_route_to_string(route)))]++;
+}
+
+json PeerCluster::snapshot() const {
+    json peers = json::array();
+    json forwards = json::array();
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [url, peer] : peers_) {
+        if (peer.self) {
+            continue;
+        }
+        json entry = peer.status.to_json();
+        entry["url"] = url;
+        entry["up"] = peer.ever_ok && now - peer.last_ok < poll_interval_ * STALE_AFTER_POLLS;
+        peers.push_back(entry);
+    }
+    for (const auto& [key, count] : forwards_) {
+        forwards.push_back({
+            {"peer", std::get<0>(key)},
+            {"model_name", std::get<1>(key)},
+            {"route", std::get<2>(key)},
+            {"requests", count}
+        });
+    }
+    return {{"node_id", node_id_}, {"peers", peers}, {"forwards", forwards}};
+}
+
+} // namespace lemon
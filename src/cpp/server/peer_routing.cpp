@@ -0,0 +1,149 @@
+#include "lemon/peer_routing.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace lemon {
+
+using json = nlohmann::json;
+
+bool PeerStatus::has_model(const std::string& model_name) const {
+    return std::find(loaded_models.begin(), loaded_models.end(), model_name) != loaded_models.end();
+}
+
+json PeerStatus::to_json() const {
+    return {
+        {"node_id", node_id},
+        {"hostname", hostname},
+        {"url", url},
+        {"loaded_models", loaded_models},
+        {"queue_depth", queue_depth},
+        {"free_vram_bytes", free_vram_bytes},
+        {"has_free_slot", has_free_slot}
+    };
+}
+
+PeerStatus PeerStatus::from_json(const json& j) {
+    PeerStatus status;
+    if (!j.is_object()) {
+        return status;
+    }
+    status.node_id = j.value("node_id", "");
+    status.hostname = j.value("hostname", "");
+    status.url = j.value("url", "");
+    if (j.contains("loaded_models") && j["loaded_models"].is_array()) {
+        for (const auto& name : j["loaded_models"]) {
+            if (name.is_string()) {
+                status.loaded_models.push_back(name.get<std::string>());
+            }
+        }
+    }
+    if (j.contains("queue_depth") && j["queue_depth"].is_number_integer()) {
+        status.queue_depth = j["queue_depth"].get<int>();
+    }
+    if (j.contains("free_vram_bytes") && j["free_vram_bytes"].is_number_integer()) {
+        status.free_vram_bytes = j["free_vram_bytes"].get<int64_t>();
+    }
+    if (j.contains("has_free_slot") && j["has_free_slot"].is_boolean()) {
+        status.has_free_slot = j["has_free_slot"].get<bool>();
+    }
+    return status;
+}
+
+const char* peer_route_to_string(PeerRoute route) {
+    switch (route) {
+        case PeerRoute::HotPeer: return "hot";
+        case PeerRoute::RoomyPeer: return "memory";
+        case PeerRoute::Local: break;
+    }
+    return "local";
+}
+
+PeerChoice choose_peer(const std::string& model_name,
+                       bool loaded_locally,
+                       bool local_needs_eviction,
+                       const std::vector<PeerStatus>& peers) {
+    PeerChoice choice;
+    if (loaded_locally || model_name.empty()) {
+        return choice;
+    }
+
+    for (size_t i = 0; i < peers.size(); ++i) {
+        if (!peers[i].has_model(model_name)) {
+            continue;
+        }
+        if (choice.peer < 0 || peers[i].queue_depth < peers[choice.peer].queue_depth) {
+            choice.route = PeerRoute::HotPeer;
+            choice.peer = static_cast<int>(i);
+        }
+    }
+    if (choice.peer >= 0 || !local_needs_eviction) {
+        return choice;
+    }
+
+    for (size_t i = 0; i < peers.size(); ++i) {
+        if (!peers[i].has_free_slot) {
+            continue;
+        }
+        if (choice.peer < 0) {
+            choice.route = PeerRoute::RoomyPeer;
+            choice.peer = static_cast<int>(i);
+            continue;
+        }
+        const PeerStatus& best = peers[choice.peer];
+        if (peers[i].free_vram_bytes > best.free_vram_bytes ||
+            (peers[i].free_vram_bytes == best.free_vram_bytes && peers[i].queue_depth < best.queue_depth)) {
+            choice.peer = static_cast<int>(i);
+        }
+    }
+    return choice;
+}
+
+std::vector<std::string> parse_peer_urls(const std::string& setting) {
+    std::vector<std::string> urls;
+    std::string token;
+    auto flush = [&urls, &token]() {
+        if (token.empty()) {
+            return;
+        }
+        std::string url = token;
+        token.clear();
+        if (url.find("://") == std::string::npos) {
+            url = "http://" + url;
+        }
+        while (!url.empty() && url.back() == '/') {
+            url.pop_back();
+        }
+        const size_t api = url.find("/api/v1");
+        if (api != std::string::npos) {
+            url.erase(api);
+        }
+        url += "/api/v1/";
+        if (std::find(urls.begin(), urls.end(), url) == urls.end()) {
+            urls.push_back(url);
+        }
+    };
+    for (char c : setting) {
+        if (c == ',' || std::isspace(static_cast<unsigned char>(c))) {
+            flush();
+        } else {
+            token += c;
+        }
+    }
+    flush();
+    return urls;
+}
+
+std::string peer_url_from_beacon(const std::string& payload) {
+    json beacon = json::parse(payload, nullptr, false);
+    if (beacon.is_discarded() || !beacon.is_object() || beacon.value("service", "") != "lemonade") {
+        return "";
+    }
+    const std::string url = beacon.value("url", "");
+    if (url.rfind("http://", 0) != 0 && url.rfind("https://", 0) != 0) {
+        return "";
+    }
+    return url;
+}
+
+} // namespace lemon
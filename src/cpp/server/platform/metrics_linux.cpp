@@ -263,6 +263,43 @@ public:
             return -1.0;
         }
     }
+
+    bool get_process_usage(int pid, ProcessUsage& usage) override {
+        if (pid <= 0) {
+            return false;
+        }
+        const std::string proc = "/proc/" + std::to_string(pid);
+
+        std::ifstream stat_file(proc + "/stat");
+        std::string line;
+        if (!stat_file.is_open() || !std::getline(stat_file, line)) {
+            return false;
+        }
+        // The command name may contain spaces; fields resume after the last ')'.
+        // utime and stime are fields 14 and 15 (11th and 12th after it).
+        size_t end = line.rfind(')');
+        if (end == std::string::npos) {
+            return false;
+        }
+        std::istringstream fields(line.substr(end + 2));
+        std::string skip;
+        for (int i = 0; i < 11; ++i) {
+            fields >> skip;
+        }
+        uint64_t utime = 0, stime = 0;
+        if (!(fields >> utime >> stime)) {
+            return false;
+        }
+        const long ticks = sysconf(_SC_CLK_TCK);
+        usage.cpu_time_ns = ticks > 0 ? (utime + stime) * (1000000000ULL / static_cast<uint64_t>(ticks)) : 0;
+
+        std::ifstream statm_file(proc + "/statm");
+        uint64_t size_pages = 0, resident_pages = 0;
+        if (statm_file >> size_pages >> resident_pages) {
+            usage.rss_bytes = resident_pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        }
+        return true;
+    }
 };
 
 std::unique_ptr<SystemMetricsPlatform> create_metrics_platform() {
@@ -1,5 +1,6 @@
 #include <lemon/system_metrics_platform.h>
 #include <windows.h>
+#include <psapi.h>
 #include <cmath>
 
 namespace lemon {
@@ -74,6 +75,30 @@ public:
         // NPU monitoring not implemented for Windows
         return -1.0;
     }
+
+    bool get_process_usage(int pid, ProcessUsage& usage) override {
+        HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, static_cast<DWORD>(pid));
+        if (!process) {
+            return false;
+        }
+
+        FILETIME creation_time, exit_time, kernel_time, user_time;
+        bool ok = GetProcessTimes(process, &creation_time, &exit_time, &kernel_time, &user_time) != 0;
+        if (ok) {
+            auto filetime_to_uint64 = [](const FILETIME& ft) -> uint64_t {
+                return (static_cast<uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+            };
+            // FILETIME counts 100-nanosecond intervals
+            usage.cpu_time_ns = (filetime_to_uint64(kernel_time) + filetime_to_uint64(user_time)) * 100;
+
+            PROCESS_MEMORY_COUNTERS counters;
+            if (GetProcessMemoryInfo(process, &counters, sizeof(counters))) {
+                usage.rss_bytes = counters.WorkingSetSize;
+            }
+        }
+        CloseHandle(process);
+        return ok;
+    }
 };
 
 std::unique_ptr<SystemMetricsPlatform> create_metrics_platform() {
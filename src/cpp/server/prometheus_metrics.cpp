@@ -1,6 +1,7 @@
 #include "lemon/prometheus_metrics.h"
 
 #include "lemon/version.h"
+#include "lemon/utils/http_client.h"
 
 #include <algorithm>
 #include <cctype>
@@ -15,34 +16,11 @@
 
 #include <httplib.h>
 
-#ifdef _WIN32
-    #include <windows.h>
-#elif defined(__linux__)
-    #include <fstream>
-#endif
-
 namespace lemon {
 namespace {
 
 using json = nlohmann::json;
 
-std::string prometheus_escape_label_value(const std::string& value) {
-    std::string escaped;
-    escaped.reserve(value.size());
-    for (char ch : value) {
-        if (ch == '\\') {
-            escaped += "\\\\";
-        } else if (ch == '"') {
-            escaped += "\\\"";
-        } else if (ch == '\n') {
-            escaped += "\\n";
-        } else {
-            escaped += ch;
-        }
-    }
-    return escaped;
-}
-
 bool json_number_as_double(const json& value, double& out) {
     if (!value.is_number()) {
         return false;
@@ -57,49 +35,6 @@ std::string format_prometheus_double(double value) {
     return oss.str();
 }
 
-std::string sanitize_prometheus_metric_name(const std::string& name) {
-    std::string sanitized;
-    sanitized.reserve(name.size());
-    for (char ch : name) {
-        unsigned char uch = static_cast<unsigned char>(ch);
-        if (std::isalnum(uch) || ch == '_') {
-            sanitized += ch;
-        } else {
-            sanitized += '_';
-        }
-    }
-    if (sanitized.empty() || std::isdigit(static_cast<unsigned char>(sanitized[0]))) {
-        sanitized.insert(sanitized.begin(), '_');
-    }
-    return sanitized;
-}
-
-std::string normalize_llamacpp_metric_name(const std::string& name) {
-    std::string sanitized = sanitize_prometheus_metric_name(name);
-    const std::string prefix = "llamacpp_";
-    if (sanitized.rfind(prefix, 0) == 0) {
-        sanitized = sanitized.substr(prefix.size());
-    }
-    return "lemonade_llamacpp_" + sanitized;
-}
-
-std::string append_prometheus_labels(const std::string& existing_labels,
-                                     const std::map<std::string, std::string>& labels) {
-    std::ostringstream oss;
-    bool first = existing_labels.empty();
-    if (!existing_labels.empty()) {
-        oss << existing_labels;
-    }
-    for (const auto& [key, value] : labels) {
-        if (!first) {
-            oss << ",";
-        }
-        first = false;
-        oss << key << "=\"" << prometheus_escape_label_value(value) << "\"";
-    }
-    return oss.str();
-}
-
 class PrometheusBuilder {
 public:
     void describe(const std::string& name, const std::string& help, const std::string& type) {
@@ -151,8 +86,30 @@ public:
         out_ << " " << value << "\n";
     }
 
-    void append_raw_line(const std::string& line) {
-        out_ << line << "\n";
+    // Renders a Histogram::to_json() payload as cumulative _bucket/_sum/_count samples.
+    void histogram(const std::string& name,
+                   const std::map<std::string, std::string>& labels,
+                   const json& data) {
+        if (!data.is_object() || !data.contains("buckets") || !data["buckets"].is_array()) {
+            return;
+        }
+        for (const auto& bucket : data["buckets"]) {
+            if (!bucket.is_array() || bucket.size() != 2) {
+                continue;
+            }
+            std::map<std::string, std::string> bucket_labels = labels;
+            bucket_labels["le"] = format_prometheus_double(bucket[0].get<double>());
+            sample_uint(name + "_bucket", bucket_labels, bucket[1].get<uint64_t>());
+        }
+        std::map<std::string, std::string> inf_labels = labels;
+        inf_labels["le"] = "+Inf";
+        sample_uint(name + "_bucket", inf_labels, data.value("count", 0ULL));
+        sample(name + "_sum", labels, data.value("sum", 0.0));
+        sample_uint(name + "_count", labels, data.value("count", 0ULL));
+    }
+
+    void append_raw(const std::string& text) {
+        out_ << text;
     }
 
     std::string str() const {
@@ -186,133 +143,47 @@ bool parse_backend_port(const std::string& backend_url, int& port) {
     }
 }
 
-std::string rewrite_llamacpp_help_or_type_line(const std::string& line,
-                                               std::set<std::string>& described_backend_metrics) {
-    const bool is_help = line.rfind("# HELP ", 0) == 0;
-    const bool is_type = line.rfind("# TYPE ", 0) == 0;
-    if (!is_help && !is_type) {
-        return "";
-    }
-
-    size_t name_start = 7;
-    size_t name_end = line.find(' ', name_start);
-    if (name_end == std::string::npos) {
-        return "";
-    }
-
-    std::string normalized_name = normalize_llamacpp_metric_name(line.substr(name_start, name_end - name_start));
-    std::string key = std::string(is_help ? "HELP:" : "TYPE:") + normalized_name;
-    if (!described_backend_metrics.insert(key).second) {
-        return "";
-    }
-    return line.substr(0, name_start) + normalized_name + line.substr(name_end);
-}
-
-std::string rewrite_llamacpp_sample_line(const std::string& line,
-                                         const std::map<std::string, std::string>& labels) {
-    if (line.empty() || line[0] == '#') {
-        return "";
-    }
-
-    size_t name_end = line.find_first_of("{ \t");
-    if (name_end == std::string::npos || name_end == 0) {
-        return "";
-    }
-
-    std::string metric_name = normalize_llamacpp_metric_name(line.substr(0, name_end));
-    std::string label_text;
-    size_t value_start = name_end;
-    if (line[name_end] == '{') {
-        size_t label_end = line.find('}', name_end + 1);
-        if (label_end == std::string::npos) {
-            return "";
-        }
-        label_text = line.substr(name_end + 1, label_end - name_end - 1);
-        value_start = label_end + 1;
-    }
-
-    std::string merged_labels = append_prometheus_labels(label_text, labels);
-    if (!merged_labels.empty()) {
-        metric_name += "{" + merged_labels + "}";
-    }
-
-    return metric_name + line.substr(value_start);
-}
+} // namespace
 
-double get_memory_usage_gb() {
-#ifdef _WIN32
-    MEMORYSTATUSEX mem_info;
-    mem_info.dwLength = sizeof(MEMORYSTATUSEX);
-    if (GlobalMemoryStatusEx(&mem_info)) {
-        double used_gb = (mem_info.ullTotalPhys - mem_info.ullAvailPhys) / (1024.0 * 1024.0 * 1024.0);
-        return std::round(used_gb * 10.0) / 10.0;
-    }
-#elif defined(__linux__)
-    std::ifstream meminfo("/proc/meminfo");
-    if (meminfo.is_open()) {
-        std::string line;
-        long long total_kb = 0;
-        long long available_kb = 0;
-        while (std::getline(meminfo, line)) {
-            if (line.find("MemTotal:") == 0) {
-                sscanf(line.c_str(), "MemTotal: %lld kB", &total_kb);
-            } else if (line.find("MemAvailable:") == 0) {
-                sscanf(line.c_str(), "MemAvailable: %lld kB", &available_kb);
-                break;
+BackendMetricsCollector::Fetcher make_backend_metrics_fetcher() {
+    return [](const std::string& backend_url, int& status, std::string& body) {
+        // Backends reached over a Unix socket have no port to dial; HttpClient
+        // knows their route.
+        if (!utils::HttpClient::unix_socket_for(backend_url).empty()) {
+            const size_t authority_start = backend_url.find("://");
+            const size_t path_start = authority_start == std::string::npos
+                ? std::string::npos
+                : backend_url.find('/', authority_start + 3);
+            try {
+                auto res = utils::HttpClient::get(backend_url.substr(0, path_start) + "/metrics", {}, 2);
+                status = res.status_code;
+                body = std::move(res.body);
+                return true;
+            } catch (const std::exception&) {
+                return false;
             }
         }
-        if (total_kb > 0 && available_kb >= 0) {
-            double used_gb = (total_kb - available_kb) / (1024.0 * 1024.0);
-            return std::round(used_gb * 10.0) / 10.0;
-        }
-    }
-#endif
-    return -1.0;
-}
 
-void append_llamacpp_backend_metrics(PrometheusBuilder& metrics,
-                                     const json& model,
-                                     const std::map<std::string, std::string>& labels,
-                                     std::set<std::string>& described_backend_metrics) {
-    if (model.value("recipe", "") != "llamacpp") {
-        return;
-    }
-
-    int backend_port = 0;
-    if (!parse_backend_port(model.value("backend_url", ""), backend_port)) {
-        return;
-    }
-
-    try {
+        int backend_port = 0;
+        if (!parse_backend_port(backend_url, backend_port)) {
+            return false;
+        }
         httplib::Client backend_client("127.0.0.1", backend_port);
         backend_client.set_connection_timeout(1);
-        backend_client.set_read_timeout(1);
-        if (auto backend_res = backend_client.Get("/metrics")) {
-            if (backend_res->status == 200) {
-                std::istringstream backend_metrics(backend_res->body);
-                std::string line;
-                while (std::getline(backend_metrics, line)) {
-                    if (!line.empty() && line.back() == '\r') {
-                        line.pop_back();
-                    }
-                    std::string rewritten = rewrite_llamacpp_help_or_type_line(line, described_backend_metrics);
-                    if (rewritten.empty()) {
-                        rewritten = rewrite_llamacpp_sample_line(line, labels);
-                    }
-                    if (!rewritten.empty()) {
-                        metrics.append_raw_line(rewritten);
-                    }
-                }
-            }
+        backend_client.set_read_timeout(2);
+        auto backend_res = backend_client.Get("/metrics");
+        if (!backend_res) {
+            return false;
         }
-    } catch (...) {
-        // Backend metrics are best effort; skip unavailable backends.
-    }
+        status = backend_res->status;
+        body = std::move(backend_res->body);
+        return true;
+    };
 }
 
-} // namespace
-
-std::string build_prometheus_metrics(Router& router, const SystemMetrics& system_metrics) {
+std::string build_prometheus_metrics(Router& router, const SystemMetrics& system_metrics,
+                                     BackendMetricsCollector* backend_metrics,
+                                     const json& realtime_transcription) {
     PrometheusBuilder metrics;
 
     metrics.describe("lemonade_server_up", "Whether the Lemonade server is running.", "gauge");
@@ -328,6 +199,33 @@ std::string build_prometheus_metrics(Router& router, const SystemMetrics& system
     metrics.describe("lemonade_loaded_models", "Number of models currently loaded in Lemonade.", "gauge");
     metrics.sample("lemonade_loaded_models", {}, static_cast<double>(loaded_models.size()));
 
+    metrics.describe("lemonade_model_load_phase_seconds",
+                     "Duration of each phase of a loaded model's last backend load.", "gauge");
+    for (const auto& model : loaded_models) {
+        const json timing = model.value("load_timing", json::object());
+        for (const char* phase : {"total", "prewarm", "spawn", "listen", "ready"}) {
+            double phase_ms = 0.0;
+            if (json_number_as_double(timing.value(std::string(phase) + "_ms", json()), phase_ms)) {
+                metrics.sample("lemonade_model_load_phase_seconds",
+                               {{"model_name", model.value("model_name", "")},
+                                {"recipe", model.value("recipe", "")},
+                                {"replica", std::to_string(model.value("replica", 0))},
+                                {"phase", phase}},
+                               phase_ms / 1000.0);
+            }
+        }
+    }
+
+    metrics.describe("lemonade_model_active_requests",
+                     "Requests currently in flight on each replica of a loaded model.", "gauge");
+    for (const auto& model : loaded_models) {
+        metrics.sample("lemonade_model_active_requests",
+                       {{"model_name", model.value("model_name", "")},
+                        {"recipe", model.value("recipe", "")},
+                        {"replica", std::to_string(model.value("replica", 0))}},
+                       static_cast<double>(model.value("active_requests", 0)));
+    }
+
     metrics.describe("lemonade_model_info", "Metadata for each Lemonade model observed by this process.", "gauge");
     metrics.describe("lemonade_model_loaded", "Whether this model is currently loaded in Lemonade.", "gauge");
     metrics.describe("lemonade_model_input_tokens", "Latest input token count reported by a model.", "gauge");
@@ -339,6 +237,8 @@ std::string build_prometheus_metrics(Router& router, const SystemMetrics& system
     metrics.describe("lemonade_model_input_tokens_total", "Cumulative input tokens observed for a model.", "counter");
     metrics.describe("lemonade_model_output_tokens_total", "Cumulative output tokens observed for a model.", "counter");
     metrics.describe("lemonade_model_prompt_tokens_total", "Cumulative prompt tokens observed for a model.", "counter");
+    metrics.describe("lemonade_model_estimated_cost_dollars_total",
+                     "Estimated spend on a priced cloud model from its token counts.", "counter");
 
     for (const auto& model : model_metrics) {
         std::map<std::string, std::string> labels = {
@@ -378,18 +278,122 @@ std::string build_prometheus_metrics(Router& router, const SystemMetrics& system
                             telemetry.value("output_tokens_total", 0ULL));
         metrics.sample_uint("lemonade_model_prompt_tokens_total", labels,
                             telemetry.value("prompt_tokens_total", 0ULL));
+        if (json_number_as_double(model.value("estimated_cost", json()), metric_value)) {
+            metrics.sample("lemonade_model_estimated_cost_dollars_total", labels, metric_value);
+        }
     }
 
-    std::set<std::string> described_backend_metrics;
-    for (const auto& model : loaded_models) {
-        std::map<std::string, std::string> labels = {
-            {"model_name", model.value("model_name", "")},
-            {"checkpoint", model.value("checkpoint", "")},
-            {"type", model.value("type", "")},
-            {"device", model.value("device", "")},
-            {"recipe", model.value("recipe", "")}
+    metrics.describe("lemonade_spillover_requests_total",
+                     "Requests sent to a cloud fallback instead of the requested local model.", "counter");
+    for (const auto& spill : snapshot.value("spillover", json::array())) {
+        metrics.sample_uint("lemonade_spillover_requests_total",
+                            {{"model_name", spill.value("model_name", "")},
+                             {"fallback", spill.value("fallback", "")},
+                             {"reason", spill.value("reason", "")}},
+                            spill.value("requests", 0ULL));
+    }
+
+    metrics.describe("lemonade_cancelled_requests_total",
+                     "Non-streaming requests abandoned mid-inference because the client disconnected.", "counter");
+    for (const auto& cancelled : snapshot.value("cancelled", json::array())) {
+        metrics.sample_uint("lemonade_cancelled_requests_total",
+                            {{"model_name", cancelled.value("model_name", "")}},
+                            cancelled.value("requests", 0ULL));
+    }
+
+    if (snapshot.contains("peers") && snapshot["peers"].is_object()) {
+        const json& cluster = snapshot["peers"];
+        metrics.describe("lemonade_peer_up",
+                         "Whether a peer node answered its recent status polls.", "gauge");
+        metrics.describe("lemonade_peer_queue_depth",
+                         "Requests in flight on a peer node at its last status poll.", "gauge");
+        for (const auto& peer : cluster.value("peers", json::array())) {
+            const std::map<std::string, std::string> labels = {{"peer", peer.value("url", "")}};
+            metrics.sample("lemonade_peer_up", labels, peer.value("up", false) ? 1.0 : 0.0);
+            metrics.sample("lemonade_peer_queue_depth", labels, peer.value("queue_depth", 0));
+        }
+        metrics.describe("lemonade_peer_forwarded_requests_total",
+                         "Requests forwarded to a peer node instead of being served here.", "counter");
+        for (const auto& forward : cluster.value("forwards", json::array())) {
+            metrics.sample_uint("lemonade_peer_forwarded_requests_total",
+                                {{"peer", forward.value("peer", "")},
+                                 {"model_name", forward.value("model_name", "")},
+                                 {"route", forward.value("route", "")}},
+                                forward.value("requests", 0ULL));
+        }
+    }
+
+    if (realtime_transcription.is_object() && realtime_transcription.contains("final")) {
+        metrics.describe("lemonade_realtime_transcriptions_queued",
+                         "Realtime transcriptions waiting for a backend slot.", "gauge");
+        metrics.describe("lemonade_realtime_transcriptions_total",
+                         "Realtime transcriptions run against a backend.", "counter");
+        metrics.describe("lemonade_realtime_transcriptions_dropped_total",
+                         "Realtime transcriptions dropped before running: interims superseded by newer audio, or queued for a closed session.", "counter");
+        metrics.describe("lemonade_realtime_transcription_queue_wait_seconds",
+                         "Time a realtime transcription waited for a backend slot.", "histogram");
+        metrics.describe("lemonade_realtime_transcription_latency_seconds",
+                         "Time from queueing a realtime transcription to its result.", "histogram");
+        const json queued = realtime_transcription.value("queued", json::object());
+        for (const char* kind : {"final", "interim"}) {
+            const json stats = realtime_transcription.value(kind, json::object());
+            const std::map<std::string, std::string> labels = {{"kind", kind}};
+            metrics.sample_uint("lemonade_realtime_transcriptions_queued", labels, queued.value(kind, 0ULL));
+            metrics.sample_uint("lemonade_realtime_transcriptions_total", labels, stats.value("completed_total", 0ULL));
+            metrics.sample_uint("lemonade_realtime_transcriptions_dropped_total", labels, stats.value("dropped_total", 0ULL));
+            metrics.histogram("lemonade_realtime_transcription_queue_wait_seconds", labels,
+                              stats.value("queue_wait_seconds", json()));
+            metrics.histogram("lemonade_realtime_transcription_latency_seconds", labels,
+                              stats.value("latency_seconds", json()));
+        }
+
+        metrics.describe("lemonade_realtime_session_final_latency_seconds",
+                         "Final transcription latency of an open realtime session.", "gauge");
+        for (const auto& session : realtime_transcription.value("sessions", json::array())) {
+            const std::string session_id = session.value("session_id", "");
+            metrics.sample("lemonade_realtime_session_final_latency_seconds",
+                           {{"session_id", session_id}, {"stat", "avg"}},
+                           session.value("final_latency_avg_seconds", 0.0));
+            metrics.sample("lemonade_realtime_session_final_latency_seconds",
+                           {{"session_id", session_id}, {"stat", "max"}},
+                           session.value("final_latency_max_seconds", 0.0));
+            metrics.sample("lemonade_realtime_session_final_latency_seconds",
+                           {{"session_id", session_id}, {"stat", "last"}},
+                           session.value("final_latency_last_seconds", 0.0));
+        }
+    }
+
+    // Backend-native metrics come from the collector's cache; no backend I/O here
+    if (backend_metrics) {
+        BackendMetricsCollector::Snapshot federated = backend_metrics->render();
+        metrics.describe("lemonade_backend_metrics_up",
+                         "Whether the last scrape of a backend's own /metrics succeeded.", "gauge");
+        metrics.describe("lemonade_backend_metrics_age_seconds",
+                         "Seconds since a backend's own /metrics was last scraped successfully.", "gauge");
+        for (const auto& status : federated.statuses) {
+            metrics.sample("lemonade_backend_metrics_up", status.labels, status.up ? 1.0 : 0.0);
+            if (status.age_seconds >= 0) {
+                metrics.sample("lemonade_backend_metrics_age_seconds", status.labels, status.age_seconds);
+            }
+        }
+        metrics.append_raw(federated.text);
+    }
+
+    metrics.describe("lemonade_backend_process_cpu_percent",
+                     "CPU used by a backend process, as a percentage of one core.", "gauge");
+    metrics.describe("lemonade_backend_process_resident_memory_gb",
+                     "Resident memory of a backend process in GiB.", "gauge");
+    for (const auto& backend : system_metrics.backends) {
+        const std::map<std::string, std::string> labels = {
+            {"model_name", backend.model_name},
+            {"pid", std::to_string(backend.pid)}
         };
-        append_llamacpp_backend_metrics(metrics, model, labels, described_backend_metrics);
+        if (backend.cpu_percent >= 0) {
+            metrics.sample("lemonade_backend_process_cpu_percent", labels, backend.cpu_percent);
+        }
+        if (backend.rss_gb >= 0) {
+            metrics.sample("lemonade_backend_process_resident_memory_gb", labels, backend.rss_gb);
+        }
     }
 
     json max_models = router.get_max_model_limits();
@@ -411,18 +415,86 @@ std::string build_prometheus_metrics(Router& router, const SystemMetrics& system
     metrics.sample_uint("lemonade_output_tokens_total", {}, totals.value("output_tokens", 0ULL));
     metrics.sample_uint("lemonade_prompt_tokens_total", {}, totals.value("prompt_tokens", 0ULL));
 
+    const json batcher = snapshot.value("embedding_batcher", json::object());
+    metrics.describe("lemonade_batcher_requests_total", "Embedding/rerank requests that passed through the coalescer.", "counter");
+    metrics.describe("lemonade_batcher_backend_calls_total", "Backend calls issued by the embedding/rerank coalescer.", "counter");
+    metrics.describe("lemonade_batcher_batch_size", "Requests coalesced into each embedding/rerank backend call.", "histogram");
+    metrics.describe("lemonade_batcher_added_latency_seconds", "Time a request waited in the embedding/rerank coalescer before dispatch.", "histogram");
+    for (auto it = batcher.begin(); it != batcher.end(); ++it) {
+        if (!it.value().is_object()) {
+            continue;
+        }
+        const std::map<std::string, std::string> labels = {{"kind", it.key()}};
+        metrics.sample_uint("lemonade_batcher_requests_total", labels, it.value().value("requests_total", 0ULL));
+        metrics.sample_uint("lemonade_batcher_backend_calls_total", labels, it.value().value("batches_total", 0ULL));
+        metrics.histogram("lemonade_batcher_batch_size", labels, it.value().value("batch_size", json()));
+        metrics.histogram("lemonade_batcher_added_latency_seconds", labels,
+                          it.value().value("added_latency_seconds", json()));
+    }
+
+    const json embedding_cache = snapshot.value("embedding_cache", json::object());
+    if (embedding_cache.value("enabled", false)) {
+        const uint64_t hits = embedding_cache.value("hits", 0ULL);
+        const uint64_t misses = embedding_cache.value("misses", 0ULL);
+        metrics.describe("lemonade_embedding_cache_hits_total", "Embedding inputs served from the embedding cache.", "counter");
+        metrics.describe("lemonade_embedding_cache_misses_total", "Embedding inputs that missed the cache and went to the backend.", "counter");
+        metrics.describe("lemonade_embedding_cache_disk_hits_total", "Embedding cache hits served from the on-disk tier.", "counter");
+        metrics.describe("lemonade_embedding_cache_hit_ratio", "Fraction of embedding inputs served from the cache.", "gauge");
+        metrics.describe("lemonade_embedding_cache_bytes_saved_total", "Input bytes not sent to embedding backends thanks to cache hits.", "counter");
+        metrics.describe("lemonade_embedding_cache_bytes", "Bytes held by the embedding cache.", "gauge");
+        metrics.describe("lemonade_embedding_cache_entries", "Entries held by the embedding cache.", "gauge");
+        metrics.sample_uint("lemonade_embedding_cache_hits_total", {}, hits);
+        metrics.sample_uint("lemonade_embedding_cache_misses_total", {}, misses);
+        metrics.sample_uint("lemonade_embedding_cache_disk_hits_total", {}, embedding_cache.value("disk_hits", 0ULL));
+        metrics.sample("lemonade_embedding_cache_hit_ratio", {},
+                       hits + misses > 0 ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0);
+        metrics.sample_uint("lemonade_embedding_cache_bytes_saved_total", {}, embedding_cache.value("bytes_saved", 0ULL));
+        metrics.sample_uint("lemonade_embedding_cache_bytes", {{"tier", "memory"}}, embedding_cache.value("memory_bytes", 0ULL));
+        metrics.sample_uint("lemonade_embedding_cache_bytes", {{"tier", "disk"}}, embedding_cache.value("disk_bytes", 0ULL));
+        metrics.sample_uint("lemonade_embedding_cache_entries", {{"tier", "memory"}}, embedding_cache.value("memory_entries", 0ULL));
+        metrics.sample_uint("lemonade_embedding_cache_entries", {{"tier", "disk"}}, embedding_cache.value("disk_entries", 0ULL));
+    }
+
+    const json response_cache = snapshot.value("response_cache", json::object());
+    if (response_cache.value("enabled", false) || response_cache.value("single_flight", false)) {
+        metrics.describe("lemonade_response_cache_hits_total", "Deterministic requests answered from the response cache.", "counter");
+        metrics.describe("lemonade_response_cache_misses_total", "Deterministic requests that ran inference.", "counter");
+        metrics.describe("lemonade_response_cache_hit_ratio", "Fraction of deterministic requests answered from the response cache.", "gauge");
+        metrics.describe("lemonade_single_flight_shared_total", "Deterministic requests that joined an identical in-flight backend call.", "counter");
+        uint64_t hits_sum = 0;
+        uint64_t misses_sum = 0;
+        for (const char* mode : {"json", "stream"}) {
+            const std::map<std::string, std::string> labels = {{"mode", mode}};
+            const uint64_t hits = response_cache.value("hits", json::object()).value(mode, 0ULL);
+            const uint64_t misses = response_cache.value("misses", json::object()).value(mode, 0ULL);
+            hits_sum += hits;
+            misses_sum += misses;
+            metrics.sample_uint("lemonade_response_cache_hits_total", labels, hits);
+            metrics.sample_uint("lemonade_response_cache_misses_total", labels, misses);
+            metrics.sample_uint("lemonade_single_flight_shared_total", labels, response_cache.value("shared", json::object()).value(mode, 0ULL));
+        }
+        metrics.sample("lemonade_response_cache_hit_ratio", {},
+                       hits_sum + misses_sum > 0 ? static_cast<double>(hits_sum) / static_cast<double>(hits_sum + misses_sum) : 0.0);
+
+        metrics.describe("lemonade_response_cache_entries", "Responses held by the response cache.", "gauge");
+        metrics.describe("lemonade_response_cache_bytes", "Bytes held by the response cache.", "gauge");
+        metrics.describe("lemonade_response_cache_evictions_total", "Responses evicted to stay within response_cache_mb.", "counter");
+        metrics.describe("lemonade_response_cache_expired_total", "Responses dropped after response_cache_ttl_seconds.", "counter");
+        metrics.sample_uint("lemonade_response_cache_entries", {}, response_cache.value("entries", 0ULL));
+        metrics.sample_uint("lemonade_response_cache_bytes", {}, response_cache.value("bytes", 0ULL));
+        metrics.sample_uint("lemonade_response_cache_evictions_total", {}, response_cache.value("evictions", 0ULL));
+        metrics.sample_uint("lemonade_response_cache_expired_total", {}, response_cache.value("expired", 0ULL));
+    }
+
     metrics.describe("lemonade_cpu_usage_percent", "System CPU utilization percentage.", "gauge");
     if (system_metrics.cpu_percent >= 0 && std::isfinite(system_metrics.cpu_percent)) {
         metrics.sample("lemonade_cpu_usage_percent", {}, system_metrics.cpu_percent);
     }
 
-#ifndef __APPLE__
     metrics.describe("lemonade_memory_used_gb", "System memory usage in GiB.", "gauge");
-    double memory_gb = get_memory_usage_gb();
-    if (memory_gb >= 0 && std::isfinite(memory_gb)) {
-        metrics.sample("lemonade_memory_used_gb", {}, memory_gb);
+    if (system_metrics.memory_gb >= 0 && std::isfinite(system_metrics.memory_gb)) {
+        metrics.sample("lemonade_memory_used_gb", {}, system_metrics.memory_gb);
     }
-#endif
 
     metrics.describe("lemonade_gpu_usage_percent", "GPU utilization percentage.", "gauge");
     if (system_metrics.gpu_percent >= 0 && std::isfinite(system_metrics.gpu_percent)) {
@@ -16,18 +16,17 @@
 namespace lemon {
 
 RealtimeSessionManager::RealtimeSessionManager(Router* router)
-    : router_(router) {
+    : router_(router),
+      // whisper.cpp and moonshine servers decode one request at a time, so a
+      // model sustains one in-flight transcription per replica
+      scheduler_([router](const std::string& model) {
+          return router ? router->serving_replica_count(model) : 1;
+      }) {
 }
 
 RealtimeSessionManager::~RealtimeSessionManager() {
-    // Wait for pending transcriptions to complete
-    {
-        std::lock_guard<std::mutex> lock(transcriptions_mutex_);
-        for (auto& f : pending_transcriptions_) {
-            if (f.valid()) f.wait();
-        }
-        pending_transcriptions_.clear();
-    }
+    // Finish queued finals; interims are no longer worth sending
+    scheduler_.shutdown();
 
     // Close all sessions
     std::lock_guard<std::mutex> lock(sessions_mutex_);
@@ -288,37 +287,19 @@ void RealtimeSessionManager::maybe_interim_transcribe(std::shared_ptr<RealtimeSe
 void RealtimeSessionManager::transcribe_interim(std::shared_ptr<RealtimeSession> session) {
     if (!session || session->audio_buffer.empty()) return;
 
-    // Avoid overlapping interim transcriptions for the same session
-    bool expected = false;
-    if (!session->interim_in_flight.compare_exchange_strong(expected, true)) {
-        return;  // Another interim is already running
-    }
-
     // Snapshot the buffer WITHOUT clearing it
     auto wav_data = session->audio_buffer.get_wav_padded(500);
     std::string model = session->model;
     session->last_interim_transcription_ms = session->audio_buffer.duration_ms();
 
-    LOG(DEBUG, "RealtimeSession") << "Firing interim transcription at "
+    LOG(DEBUG, "RealtimeSession") << "Queueing interim transcription at "
               << session->last_interim_transcription_ms << "ms" << std::endl;
 
-    auto future = std::async(std::launch::async,
-        [this, session, wav_data = std::move(wav_data), model = std::move(model)]() {
+    // Replaces this session's queued interim, if any, with the newer snapshot
+    scheduler_.submit(session->session_id, model, TranscriptionScheduler::Kind::Interim,
+        [this, session, wav_data = std::move(wav_data), model]() {
             transcribe_wav(session, wav_data, model, /*is_interim=*/true);
-            session->interim_in_flight.store(false);
         });
-
-    {
-        std::lock_guard<std::mutex> lock(transcriptions_mutex_);
-        pending_transcriptions_.erase(
-            std::remove_if(pending_transcriptions_.begin(), pending_transcriptions_.end(),
-                [](const std::future<void>& f) {
-                    return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
-                }),
-            pending_transcriptions_.end()
-        );
-        pending_transcriptions_.push_back(std::move(future));
-    }
 }
 
 void RealtimeSessionManager::commit_audio(const std::string& session_id) {
@@ -408,25 +389,12 @@ void RealtimeSessionManager::transcribe_and_send(std::shared_ptr<RealtimeSession
     session->vad_speech_window_open = false;
     session->last_interim_transcription_ms = 0;  // Reset for next utterance
 
-    // Dispatch transcription to worker thread so it doesn't block the WebSocket callback
-    auto future = std::async(std::launch::async,
-        [this, session, wav_data = std::move(wav_data), model = std::move(model)]() {
+    // Queue on the scheduler so it doesn't block the WebSocket callback;
+    // this drops the session's queued interim, which the final supersedes
+    scheduler_.submit(session->session_id, model, TranscriptionScheduler::Kind::Final,
+        [this, session, wav_data = std::move(wav_data), model]() {
             transcribe_wav(session, wav_data, model);
         });
-
-    // Track future for clean shutdown
-    {
-        std::lock_guard<std::mutex> lock(transcriptions_mutex_);
-        // Remove completed futures
-        pending_transcriptions_.erase(
-            std::remove_if(pending_transcriptions_.begin(), pending_transcriptions_.end(),
-                [](const std::future<void>& f) {
-                    return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
-                }),
-            pending_transcriptions_.end()
-        );
-        pending_transcriptions_.push_back(std::move(future));
-    }
 }
 
 void RealtimeSessionManager::transcribe_wav(
@@ -632,6 +600,7 @@ void RealtimeSessionManager::close_session(const std::string& session_id) {
         }
     }
     if (session) {
+        scheduler_.close_session(session_id);
         disconnect_streaming_backend(session);
     }
 }
@@ -641,6 +610,10 @@ bool RealtimeSessionManager::session_exists(const std::string& session_id) const
     return sessions_.find(session_id) != sessions_.end();
 }
 
+json RealtimeSessionManager::get_transcription_stats() const {
+    return scheduler_.get_stats();
+}
+
 std::shared_ptr<RealtimeSession> RealtimeSessionManager::get_session(const std::string& session_id) {
     std::lock_guard<std::mutex> lock(sessions_mutex_);
 
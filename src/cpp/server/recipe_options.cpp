@@ -15,9 +15,11 @@ using json = nlohmann::json;
 static const json DEFAULTS = {
     {"ctx_size", -1},  // -1 triggers auto-resolution (memory + arch metadata)
     {"merge_args", true},
+    {"replicas", 1},   // Backend processes serving the model, balanced by outstanding requests
     {"llamacpp_device", ""},
     {"llamacpp_backend", ""},  // Will be overridden dynamically
     {"llamacpp_args", ""},
+    {"llamacpp_tuning", nullptr},  // Autotuned launch settings keyed by host fingerprint
     {"sd-cpp_backend", ""},   // "" means auto-detect (mapped from "auto" in config.json)
     {"sdcpp_args", ""},
     {"whispercpp_backend", ""},  // "" means auto-detect (mapped from "auto" in config.json)
@@ -45,7 +47,14 @@ static const json DEFAULTS = {
     {"evict_idle_timeout", 300},      // Default hard idle timeout (5 mins)
     {"downsize_idle_timeout", 60},    // Default soft idle timeout (1 min)
     {"evict_weight_factor", 1.0},     // Eviction-protection weight (higher = more protected)
-    {"pinned", false}
+    {"priority", ""},                 // "interactive" or "batch"; "" follows the model type
+    {"pinned", false},
+
+    // Spillover of overflow requests to a cloud model (LLM recipes)
+    {"cloud_fallback", ""},           // "" disables spillover
+    {"spill_queue_depth", 0},         // In-flight requests on the least busy replica; 0 disables
+    {"spill_max_wait", 0.0},          // Predicted wait in seconds; 0 disables
+    {"spill_while_loading", true}
 };
 
 
@@ -56,6 +65,7 @@ static const json DEFAULTS = {
 static const std::map<std::string, std::string> OPTION_TO_CLI_FLAG = {
     {"ctx_size", "--ctx-size"},
     {"merge_args", "--merge-args"},
+    {"replicas", "--replicas"},
     {"llamacpp_backend", "--llamacpp"},
     {"llamacpp_device", "--llamacpp-device"},
     {"llamacpp_args", "--llamacpp-args"},
@@ -71,9 +81,10 @@ static const std::map<std::string, std::string> OPTION_TO_CLI_FLAG = {
 static std::vector<std::string> get_keys_for_recipe(const std::string& recipe) {
     std::vector<std::string> keys;
     if (recipe == "llamacpp") {
-        keys = {"ctx_size", "llamacpp_device", "llamacpp_backend", "llamacpp_args", "merge_args"};
+        keys = {"ctx_size", "llamacpp_device", "llamacpp_backend", "llamacpp_args", "llamacpp_tuning",
+                "merge_args", "replicas", "cloud_fallback", "spill_queue_depth", "spill_max_wait", "spill_while_loading"};
     } else if (recipe == "whispercpp") {
-        keys = {"whispercpp_backend", "whispercpp_args", "merge_args"};
+        keys = {"whispercpp_backend", "whispercpp_args", "merge_args", "replicas"};
     } else if (recipe == "moonshine") {
         keys = {"moonshine_args", "merge_args"};
     } else if (recipe == "flm") {
@@ -81,9 +92,10 @@ static std::vector<std::string> get_keys_for_recipe(const std::string& recipe) {
     } else if (recipe == "ryzenai-llm") {
         keys = {"ctx_size"};
     } else if (recipe == "sd-cpp") {
-        keys = {"sd-cpp_backend", "sdcpp_args", "steps", "cfg_scale", "width", "height", "sampling_method", "flow_shift", "merge_args"};
+        keys = {"sd-cpp_backend", "sdcpp_args", "steps", "cfg_scale", "width", "height", "sampling_method", "flow_shift", "merge_args", "replicas"};
     } else if (recipe == "vllm") {
-        keys = {"ctx_size", "vllm_backend", "vllm_args", "merge_args"};
+        keys = {"ctx_size", "vllm_backend", "vllm_args", "merge_args",
+                "cloud_fallback", "spill_queue_depth", "spill_max_wait", "spill_while_loading"};
     }
 
     // Add auto-eviction options for all recipes
@@ -91,6 +103,7 @@ static std::vector<std::string> get_keys_for_recipe(const std::string& recipe) {
     keys.push_back("evict_idle_timeout");
     keys.push_back("downsize_idle_timeout");
     keys.push_back("evict_weight_factor");
+    keys.push_back("priority");
     keys.push_back("pinned");
 
     return keys;
@@ -99,7 +112,8 @@ static std::vector<std::string> get_keys_for_recipe(const std::string& recipe) {
 static bool is_empty_option(json option) {
     return option.is_null() ||
            (option.is_number() && (option == -1)) ||
-           (option.is_string() && (option == "" || option == "auto"));
+           (option.is_string() && (option == "" || option == "auto")) ||
+           (option.is_object() && option.empty());
 }
 
 
@@ -168,6 +182,7 @@ static std::string format_option_for_logging(const json& opt) {
     if (opt.is_boolean()) return opt.get<bool>() ? "true" : "false";
     if (opt.is_number_float()) return std::to_string((double) opt);
     if (opt.is_number_integer()) return std::to_string((int) opt);
+    if (opt.is_object()) return opt.dump();
     return opt;
 }
 
@@ -251,6 +266,7 @@ void RecipeOptions::set_option(const std::string& opt, const json& value) {
 static const json CLI_OPTIONS = {
     {"--ctx-size", {{"option_name", "ctx_size"}, {"type_name", "SIZE"}, {"help", "Context size for the model"}, {"group", "General Options"}}},
     {"--merge-args", {{"option_name", "merge_args"}, {"type_name", "BOOL"}, {"help", "Merge global and model arguments when loading the model"}, {"group", "General Options"}}},
+    {"--replicas", {{"option_name", "replicas"}, {"type_name", "N"}, {"help", "Number of backend processes to run for the model (llamacpp, whispercpp, sd-cpp)"}, {"group", "General Options"}}},
     {"--llamacpp", {{"option_name", "llamacpp_backend"}, {"type_name", "BACKEND"}, {"help", "LlamaCpp backend to use"}, {"group", "Llama.cpp Backend Options"}}},
     {"--llamacpp-device", {{"option_name", "llamacpp_device"}, {"type_name", "DEVICES"}, {"help", "Comma-separated list of accelerator devices to use (e.g. Vulkan0)"}, {"group", "Llama.cpp Backend Options"}}},
     {"--llamacpp-args", {{"option_name", "llamacpp_args"}, {"type_name", "ARGS"}, {"help", "Custom arguments to pass to llama-server"}, {"group", "Llama.cpp Backend Options"}}},
@@ -0,0 +1,201 @@
+#include "lemon/response_cache.h"
+
+namespace lemon {
+
+void ResponseCache::configure(size_t max_bytes, int ttl_seconds, bool single_flight) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_bytes_ = max_bytes;
+    ttl_ = std::chrono::seconds(ttl_seconds);
+    single_flight_ = single_flight;
+    while (bytes_ > max_bytes_ && !lru_.empty()) {
+        bytes_ -= lru_.back().key.size() + lru_.back().payload.size();
+        index_.erase(lru_.back().key);
+        lru_.pop_back();
+        evictions_++;
+    }
+}
+
+bool ResponseCache::is_deterministic(const json& request) {
+    if (!request.is_object()) {
+        return false;
+    }
+    auto temperature = request.find("temperature");
+    if (temperature != request.end() && temperature->is_number() && temperature->get<double>() == 0.0) {
+        return true;
+    }
+    auto seed = request.find("seed");
+    // llama.cpp treats seed -1 as "pick a random seed"
+    return seed != request.end() && seed->is_number_integer() && seed->get<long long>() >= 0;
+}
+
+std::string ResponseCache::make_key(const std::string& endpoint, const std::string& scope, const json& request) {
+    std::string key = endpoint;
+    key += '\0';
+    key += scope;
+    key += '\0';
+    key += request.dump();
+    return key;
+}
+
+bool ResponseCache::is_complete_stream(const std::string& sse) {
+    if (sse.find("data: [DONE]") == std::string::npos) {
+        return false;
+    }
+    // Errors are emitted as a `data: {"error": ...}` event by the proxy path.
+    return sse.find("data: {\"error\"") == std::string::npos;
+}
+
+json ResponseCache::run(const std::string& key, const std::function<json()>& compute) {
+    json computed;
+    bool replay = false;
+    std::string payload = execute(key, false, [&](bool& ok) {
+        computed = compute();
+        ok = computed.is_object() && !computed.contains("error");
+        return ok ? computed.dump() : std::string();
+    }, replay);
+
+    if (!replay) {
+        return computed;
+    }
+    json cached = json::parse(payload, nullptr, false);
+    if (cached.is_discarded()) {
+        return compute();
+    }
+    return cached;
+}
+
+std::string ResponseCache::run_stream(const std::string& key, const std::function<std::string()>& produce) {
+    bool replay = false;
+    std::string payload = execute(key, true, [&](bool& ok) {
+        std::string sse = produce();
+        ok = is_complete_stream(sse);
+        return sse;
+    }, replay);
+    return replay ? payload : std::string();
+}
+
+std::string ResponseCache::execute(const std::string& key, bool stream,
+                                   const std::function<std::string(bool& ok)>& compute, bool& replay) {
+    replay = false;
+    std::shared_ptr<Flight> flight;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        Counters& counters = stream ? stream_counters_ : json_counters_;
+
+        std::string payload;
+        if (lookup_locked(key, payload)) {
+            counters.hits++;
+            replay = true;
+            return payload;
+        }
+
+        auto it = single_flight_ ? in_flight_.find(key) : in_flight_.end();
+        if (it != in_flight_.end()) {
+            std::shared_ptr<Flight> leader = it->second;
+            counters.shared++;
+            leader->cv.wait(lock, [&] { return leader->done; });
+            if (leader->ok) {
+                replay = true;
+                return leader->payload;
+            }
+            // The leader failed (or its client went away mid-stream): run our
+            // own request rather than inheriting a partial result.
+        } else if (single_flight_) {
+            flight = std::make_shared<Flight>();
+            in_flight_[key] = flight;
+        }
+        counters.misses++;
+    }
+
+    auto finish = [&](bool ok, const std::string& payload) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (ok) {
+            insert_locked(key, payload);
+        }
+        if (flight) {
+            flight->ok = ok;
+            if (ok) {
+                flight->payload = payload;
+            }
+            flight->done = true;
+            auto it = in_flight_.find(key);
+            if (it != in_flight_.end() && it->second == flight) {
+                in_flight_.erase(it);
+            }
+            flight->cv.notify_all();
+        }
+    };
+
+    bool ok = false;
+    std::string payload;
+    try {
+        payload = compute(ok);
+    } catch (...) {
+        finish(false, "");
+        throw;
+    }
+    finish(ok, payload);
+    return payload;
+}
+
+bool ResponseCache::lookup_locked(const std::string& key, std::string& payload) {
+    if (max_bytes_ == 0) {
+        return false;
+    }
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        return false;
+    }
+    if (std::chrono::steady_clock::now() >= it->second->expires) {
+        bytes_ -= it->second->key.size() + it->second->payload.size();
+        lru_.erase(it->second);
+        index_.erase(it);
+        expired_++;
+        return false;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second);
+    payload = it->second->payload;
+    return true;
+}
+
+void ResponseCache::insert_locked(const std::string& key, const std::string& payload) {
+    const size_t size = key.size() + payload.size();
+    if (max_bytes_ == 0 || size > max_bytes_) {
+        return;
+    }
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        bytes_ -= it->second->key.size() + it->second->payload.size();
+        lru_.erase(it->second);
+        index_.erase(it);
+    }
+    lru_.push_front({key, payload, std::chrono::steady_clock::now() + ttl_});
+    index_[key] = lru_.begin();
+    bytes_ += size;
+    while (bytes_ > max_bytes_ && !lru_.empty()) {
+        bytes_ -= lru_.back().key.size() + lru_.back().payload.size();
+        index_.erase(lru_.back().key);
+        lru_.pop_back();
+        evictions_++;
+    }
+}
+
+json ResponseCache::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto split = [this](uint64_t Counters::*field) {
+        return json{{"json", json_counters_.*field}, {"stream", stream_counters_.*field}};
+    };
+    return {
+        {"enabled", max_bytes_ > 0},
+        {"single_flight", single_flight_},
+        {"hits", split(&Counters::hits)},
+        {"misses", split(&Counters::misses)},
+        {"shared", split(&Counters::shared)},
+        {"entries", lru_.size()},
+        {"bytes", bytes_},
+        {"evictions", evictions_},
+        {"expired", expired_}
+    };
+}
+
+} // namespace lemon
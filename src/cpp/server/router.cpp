@@ -13,8 +13,17 @@
 #include "lemon/error_types.h"
 #include "lemon/recipe_options.h"
 #include "lemon/auto_tune.h"
+#include "lemon/cgroup_manager.h"
+#include "lemon/cpu_placement.h"
+#include "lemon/model_replicas.h"
+#include "lemon/spillover_policy.h"
+#include "lemon/peer_cluster.h"
+#include "lemon/utils/custom_args.h"
+#include "lemon/utils/path_utils.h"
 #include <iostream>
 #include <algorithm>
+#include <set>
+#include <filesystem>
 #include "lemon/utils/aixlog.hpp"
 #include "lemon/global_vram_monitor.h"
 #include "lemon/eviction_engine.h"
@@ -34,6 +43,8 @@ Router::Router(RuntimeConfig* config, ModelManager* model_manager, BackendManage
     vram_monitor_ = std::make_unique<GlobalVramMonitor>();
     eviction_engine_ = std::make_unique<EvictionEngine>(this, vram_monitor_.get());
 
+    configure_embedding_cache();
+
     // Always start the monitor/engine threads; they are cheap no-ops until the
     // user opts in. The monitor skips the VRAM poll when auto_evict is disabled,
     // and the engine's per-server check skips models that haven't opted in.
@@ -41,10 +52,31 @@ Router::Router(RuntimeConfig* config, ModelManager* model_manager, BackendManage
     // thread creation on the construction-time config value.)
     vram_monitor_->start();
     eviction_engine_->start();
+
+    // A backend over its own memory.high or memory.max sheds its own memory;
+    // reclaim reaching a backend's memory.low means the host is short, and
+    // idle batch models give way
+    CgroupManager::global().set_pressure_callback(
+        [this](const std::string& model_name, const std::string& leaf, const CgroupMemoryEvents& events) {
+            if (events.high > 0 || events.hard()) {
+                eviction_engine_->on_memory_pressure(model_name, leaf, events.hard());
+            }
+            if (events.low > 0) {
+                eviction_engine_->on_host_memory_pressure(model_name);
+            }
+        });
 }
 
 Router::~Router() {
     LOG(DEBUG, "Router") << "Destructor: stopping monitors and unloading all models" << std::endl;
+    CgroupManager::global().set_pressure_callback(nullptr);
+    {
+        std::lock_guard<std::mutex> lock(standby_mutex_);
+        standby_stopping_ = true;
+        standby_jobs_.clear();
+    }
+    standby_cv_.notify_all();
+    if (standby_thread_.joinable()) standby_thread_.join();
     if (eviction_engine_) eviction_engine_->stop();
     if (vram_monitor_) vram_monitor_->stop();
     unload_model("");  // Unload all
@@ -54,6 +86,10 @@ void Router::set_cloud_registry(CloudProviderRegistry* registry) {
     cloud_registry_ = registry;
 }
 
+void Router::set_peer_cluster(PeerCluster* peers) {
+    peer_cluster_ = peers;
+}
+
 WrappedServer* Router::find_server_by_model_name(const std::string& model_name) const {
     WrappedServer* unavailable_match = nullptr;
     for (const auto& server : loaded_servers_) {
@@ -74,19 +110,58 @@ std::string Router::resolve_model_name(const std::string& model_name) const {
     return model_name.empty() ? model_name : model_manager_->resolve_model_name(model_name);
 }
 
-WrappedServer* Router::get_most_recent_server() const {
-    WrappedServer* most_recent = nullptr;
+void Router::publish_registry_locked() {
+    auto registry = std::make_shared<ServerRegistry>();
+    registry->servers = loaded_servers_;
     for (const auto& server : loaded_servers_) {
+        registry->by_name[server->get_model_name()].push_back(server);
+    }
+    std::atomic_store(&registry_, std::shared_ptr<const ServerRegistry>(std::move(registry)));
+}
+
+std::shared_ptr<WrappedServer> Router::lookup_server(const std::string& canonical_model_name) const {
+    auto registry = registry_snapshot();
+    auto it = registry->by_name.find(canonical_model_name);
+    if (it == registry->by_name.end()) {
+        return nullptr;
+    }
+    return pick_least_outstanding(it->second);
+}
+
+std::shared_ptr<WrappedServer> Router::most_recent_server() const {
+    std::shared_ptr<WrappedServer> most_recent;
+    for (const auto& server : registry_snapshot()->servers) {
         if (!server->is_backend_alive()) {
             continue;
         }
         if (!most_recent || server->get_last_access_time() > most_recent->get_last_access_time()) {
-            most_recent = server.get();
+            most_recent = server;
         }
     }
     return most_recent;
 }
 
+Router::AcquireStatus Router::acquire_server(const std::string& canonical_model_name,
+                                             std::shared_ptr<WrappedServer>& server) {
+    // A failed acquire means the server was retired after our lookup; a
+    // concurrent reload may already have published its replacement.
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        server = lookup_server(canonical_model_name);
+        if (!server) {
+            return AcquireStatus::NotLoaded;
+        }
+        if (!server->is_backend_alive()) {
+            return AcquireStatus::BackendDead;
+        }
+        if (server->acquire_for_inference()) {
+            server->update_access_time();
+            return AcquireStatus::Acquired;
+        }
+    }
+    server.reset();
+    return AcquireStatus::NotLoaded;
+}
+
 void Router::prune_unavailable_servers_locked() {
     std::vector<WrappedServer*> unavailable;
     for (const auto& server : loaded_servers_) {
@@ -121,18 +196,22 @@ bool Router::is_watchdog_reset_response(const json& response) const {
     return false;
 }
 
+void Router::note_if_cancelled(const json& response, const std::string& model_name) {
+    if (response.is_object() && response.contains("error") && response["error"].is_object() &&
+        response["error"].value("type", "") == ErrorType::REQUEST_CANCELLED) {
+        std::lock_guard<std::mutex> lock(cancelled_mutex_);
+        cancelled_counts_[model_name]++;
+    }
+}
+
 bool Router::reload_model_after_watchdog_reset(const std::string& requested_model, const RecipeOptions& options) {
     try {
         LOG(WARNING, "Router") << "Reloading model after backend watchdog reset: "
                                 << requested_model << std::endl;
         auto info = model_manager_->get_model_info(requested_model);
         bool was_pinned = false;
-        {
-            std::lock_guard<std::mutex> lock(load_mutex_);
-            auto* existing = find_server_by_model_name(requested_model);
-            if (existing) {
-                was_pinned = existing->is_pinned();
-            }
+        if (auto existing = lookup_server(requested_model)) {
+            was_pinned = existing->is_pinned();
         }
         load_model(requested_model, info, options, true, false, was_pinned);
         return true;
@@ -144,6 +223,8 @@ bool Router::reload_model_after_watchdog_reset(const std::string& requested_mode
 }
 
 int Router::count_servers_by_type(ModelType type) const {
+    // Each replica is its own backend process with its own copy of the
+    // weights, so each occupies a slot
     int count = 0;
     for (const auto& server : loaded_servers_) {
         // Cloud servers consume no local memory and stay loaded for free, so
@@ -152,14 +233,16 @@ int Router::count_servers_by_type(ModelType type) const {
             continue;
         }
         if (server->is_backend_alive() && server->get_model_type() == type) {
-            count++;
+            ++count;
         }
     }
     return count;
 }
 
 WrappedServer* Router::find_lru_server_by_type(ModelType type) const {
-    WrappedServer* lru = nullptr;
+    // Replicas share a model's recency: a model is only as idle as its most
+    // recently used replica.
+    std::map<std::string, std::pair<std::chrono::steady_clock::time_point, WrappedServer*>> last_use;
 
     for (const auto& server : loaded_servers_) {
         // Cloud servers are not eviction candidates; they have no memory cost
@@ -172,15 +255,231 @@ WrappedServer* Router::find_lru_server_by_type(ModelType type) const {
             if (server->is_pinned()) {
                 continue;
             }
-            if (!lru || server->get_last_access_time() < lru->get_last_access_time()) {
-                lru = server.get();
+            auto it = last_use.find(server->get_model_name());
+            if (it == last_use.end()) {
+                last_use.emplace(server->get_model_name(),
+                                 std::make_pair(server->get_last_access_time(), server.get()));
+            } else if (server->get_last_access_time() > it->second.first) {
+                it->second.first = server->get_last_access_time();
             }
         }
     }
 
+    WrappedServer* lru = nullptr;
+    std::chrono::steady_clock::time_point lru_time;
+    for (const auto& [name, entry] : last_use) {
+        if (!lru || entry.first < lru_time) {
+            lru = entry.second;
+            lru_time = entry.first;
+        }
+    }
     return lru;
 }
 
+std::vector<WrappedServer*> Router::find_replicas_locked(const std::string& model_name) const {
+    std::vector<WrappedServer*> replicas;
+    for (const auto& server : loaded_servers_) {
+        if (server->get_model_name() == model_name) {
+            replicas.push_back(server.get());
+        }
+    }
+    return replicas;
+}
+
+void Router::evict_model_locked(const std::string& model_name, int timeout_seconds) {
+    for (auto* replica : find_replicas_locked(model_name)) {
+        evict_server(replica, timeout_seconds);
+    }
+}
+
+int Router::resolve_replica_count(const RecipeOptions& options, const ModelInfo& model_info) const {
+    // NPU backends own the device exclusively and cloud/FLM backends are not
+    // separate local processes per model, so they always run a single replica.
+    const std::string& recipe = model_info.recipe;
+    if (recipe == "cloud" || recipe == "flm" || recipe == "ryzenai-llm" ||
+        (model_info.device & DEVICE_NPU)) {
+        return 1;
+    }
+    json value = options.get_option("replicas");
+    if (!value.is_number_integer()) {
+        return 1;
+    }
+    return std::clamp(value.get<int>(), 1, MAX_MODEL_REPLICAS);
+}
+
+void Router::start_standby_replicas(const std::string& canonical_model_name,
+                                    const ModelInfo& model_info,
+                                    const RecipeOptions& effective_options,
+                                    bool do_not_upgrade,
+                                    bool pinned,
+                                    int replica_count) {
+    if (replica_count <= 1) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(standby_mutex_);
+        if (standby_stopping_) {
+            return;
+        }
+        standby_jobs_.push_back({canonical_model_name, model_info, effective_options,
+                                 do_not_upgrade, pinned, replica_count});
+        if (!standby_thread_.joinable()) {
+            standby_thread_ = std::thread(&Router::standby_loop, this);
+        }
+    }
+    standby_cv_.notify_one();
+}
+
+void Router::standby_loop() {
+    std::unique_lock<std::mutex> lock(standby_mutex_);
+    while (true) {
+        standby_cv_.wait(lock, [this] { return standby_stopping_ || !standby_jobs_.empty(); });
+        if (standby_stopping_) {
+            return;
+        }
+        StandbyJob job = std::move(standby_jobs_.front());
+        standby_jobs_.pop_front();
+        lock.unlock();
+        run_standby_job(job);
+        lock.lock();
+    }
+}
+
+bool Router::admit_replica_locked(const StandbyJob& job, double available_gb, bool& evicted) {
+    evicted = false;
+    const ModelInfo& info = job.model_info;
+    const int max_models = config_->max_loaded_models();
+    const bool slot_free = max_models == -1 || count_servers_by_type(info.type) < max_models;
+    const bool fits = info.size <= 0.0 || available_gb <= 0.0 || info.size <= available_gb;
+    if (slot_free && fits) {
+        return true;
+    }
+    WrappedServer* lru = find_lru_server_by_type(info.type);
+    if (!lru || lru->get_model_name() == job.model_name) {
+        return false;
+    }
+    LOG(INFO, "Router") << (slot_free ? "Not enough memory" : "Slot limit reached") << " for another replica of "
+                        << job.model_name << ", evicting LRU: " << lru->get_model_name() << std::endl;
+    evict_model_locked(lru->get_model_name());
+    evicted = true;
+    return false;
+}
+
+void Router::run_standby_job(const StandbyJob& job) {
+    const std::string& name = job.model_name;
+    for (int index = 0; index < job.replica_count; ++index) {
+        std::unique_ptr<WrappedServer> replica;
+        // Measuring memory queries the system, so it is done unlocked
+        double available_gb = job.model_info.size > 0.0 ? get_available_memory_gb(job.model_info.device) : 0.0;
+        {
+            std::unique_lock<std::mutex> lock(load_mutex_);
+            const auto replicas = find_replicas_locked(name);
+            if (replicas.empty()) {
+                return;  // Unloaded or evicted meanwhile
+            }
+            // A dead replica keeps its index until evicted, and would never
+            // be replaced otherwise
+            bool running = false;
+            for (auto* existing : replicas) {
+                if (existing->get_replica_index() != index) continue;
+                if (existing->is_backend_alive()) {
+                    running = true;
+                } else {
+                    LOG(WARNING, "Router") << "Replica " << (index + 1) << " of " << name
+                                           << " is unavailable, evicting before restart" << std::endl;
+                    evict_server(existing);
+                }
+            }
+            if (running) {
+                continue;
+            }
+
+            // Each replica is charged a slot and its expected size like any
+            // load; the model runs as many replicas as fit
+            bool admitted = false;
+            for (int attempt = 0; attempt <= MAX_MODEL_REPLICAS && !admitted; ++attempt) {
+                bool evicted = false;
+                admitted = admit_replica_locked(job, available_gb, evicted);
+                if (!evicted) {
+                    break;
+                }
+                lock.unlock();
+                available_gb = job.model_info.size > 0.0 ? get_available_memory_gb(job.model_info.device) : 0.0;
+                lock.lock();
+                if (find_replicas_locked(name).empty()) {
+                    return;
+                }
+            }
+            if (!admitted) {
+                LOG(INFO, "Router") << "Running " << index << " of " << job.replica_count << " replicas of "
+                                    << name << ": no room for more" << std::endl;
+                return;
+            }
+
+            // The model is already serving; a replica that fails to start only
+            // costs capacity, so it is logged rather than evicting other models.
+            try {
+                replica = create_backend_server(job.model_info);
+            } catch (const std::exception& e) {
+                LOG(WARNING, "Router") << "Could not create replica " << (index + 1) << " of "
+                                       << name << ": " << e.what() << std::endl;
+                return;
+            }
+        }
+        replica->set_model_metadata(name, job.model_info.checkpoint(), job.model_info.type,
+                                    job.model_info.device, job.options);
+        replica->set_replica(index, job.replica_count);
+        replica->set_expected_memory_gb(job.model_info.size);
+        replica->set_pinned(job.pinned);
+        replica->set_activity_listener([this](const WrappedServer* server) {
+            eviction_engine_->note_activity(server);
+        });
+
+        {
+            std::lock_guard<std::mutex> lock(standby_mutex_);
+            if (standby_stopping_) {
+                return;
+            }
+        }
+        LOG(INFO, "Router") << "Starting replica " << (index + 1) << "/" << job.replica_count
+                            << " of " << name << std::endl;
+        auto load_start = std::chrono::steady_clock::now();
+        replica->begin_load_timing();
+        try {
+            replica->load(name, job.model_info, job.options, job.do_not_upgrade);
+            replica->set_load_duration_ms(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - load_start).count());
+        } catch (const std::exception& e) {
+            LOG(WARNING, "Router") << "Replica " << (index + 1) << " of " << name
+                                   << " failed to start: " << e.what() << std::endl;
+            return;
+        }
+
+        bool published = false;
+        {
+            std::lock_guard<std::mutex> lock(load_mutex_);
+            // The model may have been unloaded or reloaded with other options
+            // while this replica was starting
+            const auto replicas = find_replicas_locked(name);
+            const bool superseded = std::any_of(replicas.begin(), replicas.end(), [&](WrappedServer* s) {
+                return s->get_replica_index() == index ||
+                       s->get_recipe_options().to_json() != job.options.to_json();
+            });
+            if (!replicas.empty() && !superseded) {
+                replica->update_access_time();
+                replica->set_state(ModelState::READY);
+                loaded_servers_.push_back(std::move(replica));
+                publish_registry_locked();
+                published = true;
+            }
+        }
+        if (!published) {
+            replica->unload();
+            return;
+        }
+    }
+}
+
 bool Router::has_npu_server() const {
     for (const auto& server : loaded_servers_) {
         if (server->is_backend_alive() && (server->get_device_type() & DEVICE_NPU)) {
@@ -241,32 +540,34 @@ void Router::evict_server(WrappedServer* server, int timeout_seconds) {
     std::string model_name = server->get_model_name();
     LOG(INFO, "Router") << "Evicting model: " << model_name << std::endl;
 
-    // Wait for any ongoing inference to complete. For watchdog-reset/dead
-    // backends the wait is bounded so recovery can continue, but the object must
-    // not be destroyed while a request thread may still be using this raw
-    // pointer. In that case we leave a tombstoned server in loaded_servers_;
-    // future prune/load calls will remove it once the request unwinds.
-    const int wait_timeout = server->is_backend_alive() ? timeout_seconds : EVICTION_TIMEOUT;
-    const bool idle = server->wait_until_not_busy(wait_timeout);
-    if (!idle) {
-        LOG(WARNING, "Router") << "Deferring eviction for model " << model_name
-                                << " because requests are still unwinding after "
-                                << EVICTION_TIMEOUT << "s (state="
-                                << server->get_backend_health_state() << ")"
+    // Unpublish first so no new request can find the server. Requests that
+    // already hold a handle keep the object alive; retire() waits for them so
+    // the backend's memory is released before a replacement loads.
+    std::shared_ptr<WrappedServer> owned;
+    auto it = std::find_if(loaded_servers_.begin(), loaded_servers_.end(),
+                           [server](const std::shared_ptr<WrappedServer>& s) {
+                               return s.get() == server;
+                           });
+    if (it == loaded_servers_.end()) {
+        return;
+    }
+    owned = *it;
+    loaded_servers_.erase(it);
+    publish_registry_locked();
+
+    // For watchdog-reset/dead backends the wait is bounded so recovery can
+    // continue; the last request to finish then destroys (and unloads) it.
+    const int wait_timeout = owned->is_backend_alive() ? timeout_seconds : EVICTION_TIMEOUT;
+    if (!owned->retire(wait_timeout)) {
+        LOG(WARNING, "Router") << "Requests for model " << model_name
+                                << " are still unwinding after " << EVICTION_TIMEOUT
+                                << "s (state=" << owned->get_backend_health_state()
+                                << "); it will be unloaded when the last one finishes"
                                 << std::endl;
         return;
     }
 
-    server->unload();
-
-    // Remove from vector
-    loaded_servers_.erase(
-        std::remove_if(loaded_servers_.begin(), loaded_servers_.end(),
-                      [server](const std::unique_ptr<WrappedServer>& s) {
-                          return s.get() == server;
-                      }),
-        loaded_servers_.end()
-    );
+    owned->unload();
 
     LOG(INFO, "Router") << "Evicted model: " << model_name << std::endl;
 }
@@ -274,10 +575,6 @@ void Router::evict_server(WrappedServer* server, int timeout_seconds) {
 void Router::evict_all_servers() {
     LOG(INFO, "Router") << "Evicting all models (" << loaded_servers_.size() << " total)" << std::endl;
 
-    // Copy raw pointers first; evict_server may erase entries and move
-    // unique_ptrs inside the vector, but the pointed-to WrappedServer objects
-    // remain stable until their individual eviction completes. Busy/dead
-    // servers are safely left as tombstones for a later prune pass.
     std::vector<WrappedServer*> servers;
     servers.reserve(loaded_servers_.size());
     for (const auto& server : loaded_servers_) {
@@ -288,8 +585,7 @@ void Router::evict_all_servers() {
         evict_server(server, EVICTION_TIMEOUT);
     }
 
-    LOG(INFO, "Router") << "Evict all completed. Remaining tombstoned models: "
-                         << loaded_servers_.size() << std::endl;
+    LOG(INFO, "Router") << "Evict all completed" << std::endl;
 }
 
 void Router::simulate_vram_pressure(double pct) {
@@ -344,6 +640,69 @@ std::unique_ptr<WrappedServer> Router::create_backend_server(const ModelInfo& mo
     return new_server;
 }
 
+void Router::prewarm_model(const ModelInfo& model_info) {
+    // Cloud models have no files; FLM and directory-based recipes load
+    // through their own runtimes and are skipped by the regular-file check.
+    if (!ModelPrewarmer::enabled() || model_info.recipe == "cloud" || model_info.recipe == "flm") {
+        return;
+    }
+    const std::string key = model_info.resolved_path("main");
+    if (key.empty() || is_model_loaded(model_info.model_name)) {
+        return;
+    }
+
+    // The main weights first, then the files loaded alongside them
+    std::vector<std::string> paths = {key};
+    for (const auto& [type, path] : model_info.resolved_paths) {
+        if (type != "main") {
+            paths.push_back(path);
+        }
+    }
+    prewarmer_.start(key, paths);
+}
+
+json Router::autotune_model(const ModelInfo& model_info, const std::function<bool()>& cancelled) {
+    if (model_info.recipe != "llamacpp") {
+        throw std::invalid_argument("Autotune supports llamacpp models only, not " + model_info.recipe);
+    }
+
+    // Same option resolution as load_model(), so the sweep uses the backend
+    // and devices the model would be loaded with
+    RecipeOptions tentative = model_info.recipe_options.inherit(RecipeOptions(model_info.recipe, config_->recipe_options("")));
+    json backend_json = tentative.get_option("llamacpp_backend");
+    const std::string backend = backend_json.is_string() ? backend_json.get<std::string>() : "";
+    RecipeOptions effective_options =
+        model_info.recipe_options.inherit(RecipeOptions(model_info.recipe, config_->recipe_options(backend)));
+
+    // Each benchmark runs under the load gate so no model starts while it
+    // measures the machine. The gate is released between runs, so a sweep
+    // of several minutes delays a load by one run at most.
+    auto run_bench = [this](const std::function<void()>& bench) {
+        std::unique_lock<std::mutex> lock(load_mutex_);
+        while (is_loading_) {
+            load_cv_.wait(lock);
+        }
+        is_loading_ = true;
+        lock.unlock();
+        try {
+            bench();
+        } catch (...) {
+            lock.lock();
+            is_loading_ = false;
+            load_cv_.notify_all();
+            throw;
+        }
+        lock.lock();
+        is_loading_ = false;
+        load_cv_.notify_all();
+    };
+
+    std::string fingerprint;
+    LlamaCppTuning tuning = backends::LlamaCppServer::autotune(model_info, effective_options, backend_manager_,
+                                                               fingerprint, run_bench, cancelled);
+    return {{"fingerprint", fingerprint}, {"tuning", tuning.to_json()}};
+}
+
 void Router::load_model(const std::string& model_name,
                        const ModelInfo& model_info,
                        RecipeOptions options,
@@ -351,6 +710,14 @@ void Router::load_model(const std::string& model_name,
                        bool allow_reload_on_option_change,
                        std::optional<bool> pinned) {
     const std::string canonical_model_name = resolve_model_name(model_name);
+    const std::string prewarm_key = model_info.resolved_path("main");
+
+    // Visible to spillover from here until the load finishes, including the
+    // wait for other loads below
+    PendingLoad pending_load(*this, canonical_model_name);
+
+    // Overlap disk reads with waiting for other loads, eviction and spawn
+    prewarm_model(model_info);
     const std::string backend_option = model_info.recipe + "_backend";
 
     RecipeOptions tentative = options.inherit(model_info.recipe_options.inherit(
@@ -408,14 +775,22 @@ void Router::load_model(const std::string& model_name,
             if (allow_reload_on_option_change &&
                 existing->get_recipe_options().to_json() != effective_options.to_json()) {
                 LOG(INFO, "Router") << "Options changed, reloading model: " << canonical_model_name << std::endl;
-                evict_server(existing);
+                evict_model_locked(canonical_model_name);
                 // Fall through to create and load with new options
             } else {
                 LOG(INFO, "Router") << "Model already loaded, updating access time and pinned status" << std::endl;
-                existing->set_pinned(final_pinned);
+                prewarmer_.cancel(prewarm_key);
+                for (auto* replica : find_replicas_locked(canonical_model_name)) {
+                    replica->set_pinned(final_pinned);
+                }
                 existing->update_access_time();
                 is_loading_ = false;
                 load_cv_.notify_all();
+                // Replaces replicas that died or were idle-evicted since the
+                // model was loaded; the model keeps its slot meanwhile.
+                start_standby_replicas(canonical_model_name, model_info, existing->get_recipe_options(),
+                                       do_not_upgrade, final_pinned,
+                                       resolve_replica_count(existing->get_recipe_options(), model_info));
                 return;
             }
         }
@@ -478,7 +853,7 @@ void Router::load_model(const std::string& model_name,
                 LOG(INFO, "Router") << "Slot limit reached for type "
                           << model_type_to_string(model_type)
                           << ", evicting LRU: " << lru->get_model_name() << std::endl;
-                evict_server(lru);
+                evict_model_locked(lru->get_model_name());
             } else {
                 is_loading_ = false;
                 load_cv_.notify_all();
@@ -496,12 +871,19 @@ void Router::load_model(const std::string& model_name,
 
         LOG(DEBUG, "Router") << "Effective settings: " << effective_options.to_log_string() << std::endl;
 
+        const int replica_count = resolve_replica_count(effective_options, model_info);
+
         // Create new backend server
         std::unique_ptr<WrappedServer> new_server = create_backend_server(model_info);
 
         // Set model metadata
         new_server->set_model_metadata(canonical_model_name, model_info.checkpoint(), model_type, device_type, effective_options);
+        new_server->set_replica(0, replica_count);
+        new_server->set_expected_memory_gb(model_info.size);
         new_server->set_pinned(final_pinned);
+        new_server->set_activity_listener([this](const WrappedServer* server) {
+            eviction_engine_->note_activity(server);
+        });
         new_server->update_access_time();
 
         // CRITICAL: Release lock before slow backend startup
@@ -512,6 +894,7 @@ void Router::load_model(const std::string& model_name,
         bool load_success = false;
         std::string error_message;
         auto load_start = std::chrono::steady_clock::now();
+        new_server->begin_load_timing();
 
         try {
             new_server->load(canonical_model_name, model_info, effective_options, do_not_upgrade);
@@ -525,11 +908,22 @@ void Router::load_model(const std::string& model_name,
             LOG(ERROR, "Router") << "Backend load failed: " << error_message << std::endl;
         }
 
+        // Once the backend is up its pages are resident; stop reading ahead
+        if (auto prewarm = prewarmer_.finish(prewarm_key)) {
+            LOG(INFO, "Router") << "Prewarmed " << (prewarm->bytes / (1024 * 1024)) << " of "
+                                << (prewarm->total_bytes / (1024 * 1024)) << " MB at "
+                                << static_cast<long>(prewarm->mb_per_second()) << " MB/s"
+                                << (prewarm->completed ? "" : " (stopped when the backend was ready)")
+                                << "; load took " << new_server->get_load_duration_ms() << "ms" << std::endl;
+            new_server->set_prewarm_timing(static_cast<long>(prewarm->seconds * 1000.0), prewarm->bytes,
+                                           prewarm->mb_per_second(), prewarm->completed);
+        }
+
         lock.lock();
 
         if (load_success) {
             // Success: Refresh access time so this model is returned by
-            // get_most_recent_server() (the pre-load timestamp from line 316
+            // most_recent_server() (the pre-load timestamp from line 316
             // may have been overtaken by other models serving requests while
             // the lock was released during the slow backend load).
             new_server->update_access_time();
@@ -537,10 +931,15 @@ void Router::load_model(const std::string& model_name,
 
             // Add to loaded servers
             loaded_servers_.push_back(std::move(new_server));
+            publish_registry_locked();
 
             is_loading_ = false;
             load_cv_.notify_all();
 
+            // The first replica already serves requests while the standbys start
+            start_standby_replicas(canonical_model_name, model_info, effective_options,
+                                   do_not_upgrade, final_pinned, replica_count);
+
             LOG(INFO, "Router") << "Model loaded successfully. Total loaded: "
                       << loaded_servers_.size() << std::endl;
         } else {
@@ -570,7 +969,12 @@ void Router::load_model(const std::string& model_name,
             // Create new server for retry
             std::unique_ptr<WrappedServer> retry_server = create_backend_server(model_info);
             retry_server->set_model_metadata(canonical_model_name, model_info.checkpoint(), model_type, device_type, effective_options);
+            retry_server->set_replica(0, replica_count);
+            retry_server->set_expected_memory_gb(model_info.size);
             retry_server->set_pinned(final_pinned);
+            retry_server->set_activity_listener([this](const WrappedServer* server) {
+                eviction_engine_->note_activity(server);
+            });
             retry_server->update_access_time();
 
             lock.unlock();
@@ -578,6 +982,7 @@ void Router::load_model(const std::string& model_name,
             LOG(DEBUG, "Router") << "Retrying backend load..." << std::endl;
             try {
                 auto retry_start = std::chrono::steady_clock::now();
+                retry_server->begin_load_timing();
                 retry_server->load(canonical_model_name, model_info, effective_options, do_not_upgrade);
                 auto retry_end = std::chrono::steady_clock::now();
                 retry_server->set_load_duration_ms(std::chrono::duration_cast<std::chrono::milliseconds>(retry_end - retry_start).count());
@@ -585,11 +990,15 @@ void Router::load_model(const std::string& model_name,
                 lock.lock();
 
                 retry_server->set_state(ModelState::READY);
+                const long retry_ms = retry_server->get_load_duration_ms();
                 loaded_servers_.push_back(std::move(retry_server));
+                publish_registry_locked();
                 is_loading_ = false;
                 load_cv_.notify_all();
+                start_standby_replicas(canonical_model_name, model_info, effective_options,
+                                       do_not_upgrade, final_pinned, replica_count);
 
-                LOG(DEBUG, "Router") << "Retry successful in " << retry_server->get_load_duration_ms() << "ms!" << std::endl;
+                LOG(DEBUG, "Router") << "Retry successful in " << retry_ms << "ms!" << std::endl;
             } catch (const std::exception& retry_error) {
                 lock.lock();
                 is_loading_ = false;
@@ -602,6 +1011,7 @@ void Router::load_model(const std::string& model_name,
 
     } catch (const std::exception& e) {
         LOG(ERROR, "Router") << "Failed to load model: " << e.what() << std::endl;
+        prewarmer_.cancel(prewarm_key);
 
         if (!lock.owns_lock()) {
             lock.lock();
@@ -624,18 +1034,27 @@ void Router::unload_model(const std::string& model_name) {
         // Unload specific model
         LOG(INFO, "Router") << "Unload model called: " << model_name << std::endl;
         std::string canonical_model_name = resolve_model_name(model_name);
-        WrappedServer* server = find_server_by_model_name(canonical_model_name);
-        if (!server) {
+        if (!find_server_by_model_name(canonical_model_name)) {
             throw std::runtime_error("Model not loaded: " + model_name);
         }
-        evict_server(server);
+        evict_model_locked(canonical_model_name);
     }
 }
 
 void Router::evict_if_committed(const std::string& model_name) {
     std::lock_guard<std::mutex> lock(load_mutex_);
 
-    WrappedServer* server = find_server_by_model_name(model_name);
+    // The engine marked one replica EVICTING; the others stay loaded
+    WrappedServer* server = nullptr;
+    for (auto* replica : find_replicas_locked(model_name)) {
+        if (replica->get_state() == ModelState::EVICTING) {
+            server = replica;
+            break;
+        }
+    }
+    if (!server) {
+        server = find_server_by_model_name(model_name);
+    }
     if (!server) {
         return;  // Already gone
     }
@@ -652,27 +1071,203 @@ void Router::evict_if_committed(const std::string& model_name) {
     evict_server(server);
 }
 
+Router::PendingLoad::PendingLoad(Router& router, const std::string& model_name)
+    : router_(router), model_name_(model_name) {
+    std::lock_guard<std::mutex> lock(router_.spillover_mutex_);
+    router_.pending_loads_[model_name_]++;
+}
+
+Router::PendingLoad::~PendingLoad() {
+    std::lock_guard<std::mutex> lock(router_.spillover_mutex_);
+    auto it = router_.pending_loads_.find(model_name_);
+    if (it != router_.pending_loads_.end() && --it->second == 0) {
+        router_.pending_loads_.erase(it);
+    }
+}
+
+std::string Router::choose_spillover(const std::string& requested_model) {
+    const std::string canonical_model_name = resolve_model_name(requested_model);
+    if (canonical_model_name.empty()) {
+        return "";
+    }
+
+    // The policy comes from the loaded backend when there is one, so it
+    // matches the options the model was loaded with
+    LocalModelLoad load;
+    std::shared_ptr<WrappedServer> server = lookup_server(canonical_model_name);
+    SpilloverPolicy policy;
+    if (server && server->is_backend_alive()) {
+        policy = SpilloverPolicy::from_recipe_options(server->get_recipe_options().to_json());
+        load.loaded = true;
+        load.outstanding = server->get_active_request_count();
+        load.mean_request_seconds = server->get_mean_request_seconds();
+    } else {
+        if (!model_manager_->model_exists(canonical_model_name)) {
+            return "";
+        }
+        const ModelInfo info = model_manager_->get_model_info(canonical_model_name);
+        policy = SpilloverPolicy::from_recipe_options(
+            info.recipe_options.inherit(RecipeOptions(info.recipe, config_->recipe_options(""))).to_json());
+    }
+    if (!policy.enabled() || policy.fallback_model == canonical_model_name) {
+        return "";
+    }
+    {
+        std::lock_guard<std::mutex> lock(spillover_mutex_);
+        load.loading = pending_loads_.count(canonical_model_name) > 0;
+    }
+
+    const SpillReason reason = decide_spillover(policy, load);
+    if (reason == SpillReason::None) {
+        return "";
+    }
+
+    // Only cloud models take overflow; a local fallback would compete for
+    // the same memory and slots
+    const std::string fallback = resolve_model_name(policy.fallback_model);
+    if (!model_manager_->model_exists(fallback) ||
+        model_manager_->get_model_info(fallback).recipe != "cloud") {
+        LOG(WARNING, "Router") << "Ignoring cloud_fallback '" << policy.fallback_model << "' of "
+                               << canonical_model_name << ": not a registered cloud model" << std::endl;
+        return "";
+    }
+
+    LOG(INFO, "Router") << "Spilling request for " << canonical_model_name << " to " << fallback
+                        << " (" << spill_reason_to_string(reason) << ", " << load.outstanding
+                        << " in flight)" << std::endl;
+    std::lock_guard<std::mutex> lock(spillover_mutex_);
+    spillover_counts_[std::make_tuple(canonical_model_name, fallback, std::string(spill_reason_to_string(reason)))]++;
+    return fallback;
+}
+
+bool Router::load_would_evict(const ModelInfo& model_info) const {
+    const int max_models = config_->max_loaded_models();
+    if (max_models == -1 || model_info.recipe == "cloud") {
+        return false;
+    }
+    // Same accounting as count_servers_by_type, against the published registry
+    int count = 0;
+    for (const auto& server : registry_snapshot()->servers) {
+        if (server->get_recipe_options().get_recipe() == "cloud") {
+            continue;
+        }
+        if (server->is_backend_alive() && server->get_model_type() == model_info.type) {
+            ++count;
+        }
+    }
+    return count >= max_models;
+}
+
+std::string Router::choose_peer(const std::string& requested_model) {
+    if (!peer_cluster_ || !peer_cluster_->running()) {
+        return "";
+    }
+    const std::vector<PeerStatus> peers = peer_cluster_->live_peers();
+    if (peers.empty()) {
+        return "";
+    }
+
+    // Peers list public names; a model unknown here may still be hot on a peer
+    const std::string canonical_model_name = resolve_model_name(requested_model);
+    std::string model_name = requested_model;
+    bool loaded_locally = false;
+    bool needs_eviction = false;
+    if (!canonical_model_name.empty() && model_manager_->model_exists(canonical_model_name)) {
+        const ModelInfo info = model_manager_->get_model_info(canonical_model_name);
+        // Cloud models cost nothing to serve here
+        if (info.recipe == "cloud") {
+            return "";
+        }
+        model_name = model_manager_->get_public_model_name(canonical_model_name);
+        std::shared_ptr<WrappedServer> server = lookup_server(canonical_model_name);
+        loaded_locally = server && server->is_backend_alive();
+        needs_eviction = !loaded_locally && load_would_evict(info);
+    }
+
+    const PeerChoice choice = lemon::choose_peer(model_name, loaded_locally, needs_eviction, peers);
+    if (choice.route == PeerRoute::Local) {
+        return "";
+    }
+    const PeerStatus& peer = peers[choice.peer];
+    LOG(INFO, "Router") << "Forwarding request for " << model_name << " to peer " << peer.url
+                        << " (" << peer_route_to_string(choice.route) << ", "
+                        << peer.queue_depth << " queued there)" << std::endl;
+    peer_cluster_->record_forward(peer.url, model_name, choice.route);
+    return peer.url;
+}
+
+json Router::get_peer_status() const {
+    auto registry = registry_snapshot();
+
+    std::set<std::string> models;
+    int local_llms = 0;  // Backends, as slots are counted
+    int queue_depth = 0;
+    for (const auto& server : registry->servers) {
+        if (!server->is_backend_alive()) {
+            continue;
+        }
+        queue_depth += server->get_active_request_count();
+        // Cloud models are served by every node that has credentials, so
+        // advertising them would only pull traffic across the network
+        if (server->get_recipe_options().get_recipe() == "cloud") {
+            continue;
+        }
+        models.insert(model_manager_->get_public_model_name(server->get_model_name()));
+        if (server->get_model_type() == ModelType::LLM) {
+            ++local_llms;
+        }
+    }
+
+    PeerStatus status;
+    status.loaded_models.assign(models.begin(), models.end());
+    status.queue_depth = queue_depth;
+    const int max_models = config_->max_loaded_models();
+    status.has_free_slot = max_models == -1 || local_llms < max_models;
+    {
+        // Measuring memory queries the system; peers poll every few seconds
+        std::lock_guard<std::mutex> lock(peer_status_mutex_);
+        const auto now = std::chrono::steady_clock::now();
+        if (free_vram_measured_ == std::chrono::steady_clock::time_point{} ||
+            now - free_vram_measured_ > std::chrono::seconds(5)) {
+            const double free_gb = get_available_memory_gb(DEVICE_GPU);
+            free_vram_bytes_ = free_gb > 0.0 ? static_cast<int64_t>(free_gb * 1024.0 * 1024.0 * 1024.0) : -1;
+            free_vram_measured_ = now;
+        }
+        status.free_vram_bytes = free_vram_bytes_;
+    }
+    return status.to_json();
+}
+
 std::string Router::get_loaded_model() const {
-    std::lock_guard<std::mutex> lock(load_mutex_);
-    WrappedServer* server = get_most_recent_server();
+    auto server = most_recent_server();
     return server ? model_manager_->get_public_model_name(server->get_model_name()) : "";
 }
 
 std::string Router::get_loaded_recipe() const {
-    std::lock_guard<std::mutex> lock(load_mutex_);
-    WrappedServer* server = get_most_recent_server();
+    auto server = most_recent_server();
     if (!server) return "";
 
     // Get the actual recipe from the server's recipe options
     return server->get_recipe_options().get_recipe();
 }
 
+std::vector<std::pair<std::string, int>> Router::get_backend_pids() const {
+    std::vector<std::pair<std::string, int>> result;
+    for (const auto& server : registry_snapshot()->servers) {
+        int pid = server->get_process_id();
+        if (pid > 0 && server->is_backend_alive()) {
+            result.emplace_back(model_manager_->get_public_model_name(server->get_model_name()), pid);
+        }
+    }
+    return result;
+}
+
 json Router::get_all_loaded_models() const {
-    std::lock_guard<std::mutex> lock(load_mutex_);
+    auto registry = registry_snapshot();
 
     json result = json::array();
 
-    for (const auto& server : loaded_servers_) {
+    for (const auto& server : registry->servers) {
         const bool backend_alive = server->is_backend_alive();
         if (!backend_alive) {
             continue;
@@ -695,9 +1290,26 @@ json Router::get_all_loaded_models() const {
             model_info["watchdog_reset_reason"] = watchdog_reason;
         }
         model_info["pinned"] = server->is_pinned();
+        model_info["replica"] = server->get_replica_index();
+        model_info["replicas"] = server->get_replica_count();
+        model_info["active_requests"] = server->get_active_request_count();
         RecipeOptions recipe_options =  server->get_recipe_options();
         model_info["recipe"] = recipe_options.get_recipe();
         model_info["recipe_options"] = recipe_options.to_json();
+        model_info["load_timing"] = server->get_load_timing().to_json();
+        model_info["priority"] = server->is_interactive() ? "interactive" : "batch";
+        const int64_t memory_bytes = server->get_memory_bytes();
+        model_info["memory_bytes"] = memory_bytes >= 0 ? json(memory_bytes) : json(nullptr);
+        const utils::CpuPlacement placement = server->get_cpu_placement();
+        if (placement.empty()) {
+            model_info["cpu_placement"] = nullptr;
+        } else {
+            model_info["cpu_placement"] = {
+                {"cpus", format_cpu_list(placement.cpus)},
+                {"cores", placement.physical_cores},
+                {"numa_node", placement.numa_node}
+            };
+        }
 
         // Static metadata from the registry entry. Cloud models carry the
         // provider-reported context window + per-million-token cost (recorded
@@ -743,8 +1355,7 @@ json Router::get_max_model_limits() const {
 }
 
 bool Router::is_model_loaded() const {
-    std::lock_guard<std::mutex> lock(load_mutex_);
-    for (const auto& server : loaded_servers_) {
+    for (const auto& server : registry_snapshot()->servers) {
         if (server->is_backend_alive()) {
             return true;
         }
@@ -753,50 +1364,52 @@ bool Router::is_model_loaded() const {
 }
 
 bool Router::is_model_loaded(const std::string& model_name) const {
-    std::lock_guard<std::mutex> lock(load_mutex_);
-    auto* server = find_server_by_model_name(resolve_model_name(model_name));
+    auto server = lookup_server(resolve_model_name(model_name));
     return server != nullptr && server->is_backend_alive();
 }
 
 RecipeOptions Router::get_model_recipe_options(const std::string& model_name) const {
-    std::lock_guard<std::mutex> lock(load_mutex_);
-    auto* server = find_server_by_model_name(resolve_model_name(model_name));
+    auto server = lookup_server(resolve_model_name(model_name));
     if (server && server->is_backend_alive()) return server->get_recipe_options();
     return RecipeOptions();
 }
 
 ModelType Router::get_model_type(const std::string& model_name) const {
-    std::lock_guard<std::mutex> lock(load_mutex_);
-    WrappedServer* server = model_name.empty()
-        ? get_most_recent_server()
-        : find_server_by_model_name(resolve_model_name(model_name));
+    auto server = model_name.empty()
+        ? most_recent_server()
+        : lookup_server(resolve_model_name(model_name));
     return (server && server->is_backend_alive()) ? server->get_model_type() : ModelType::LLM;
 }
 
 std::string Router::get_backend_address() const {
-    std::lock_guard<std::mutex> lock(load_mutex_);
-    WrappedServer* server = get_most_recent_server();
+    auto server = most_recent_server();
     return (server && server->is_backend_alive()) ? server->get_address() : "";
 }
 
 std::string Router::get_streaming_transcription_address(const std::string& model_name) const {
-    std::lock_guard<std::mutex> lock(load_mutex_);
-    WrappedServer* server = nullptr;
-    if (!model_name.empty()) {
-        // Route by the session's requested model, like the normal inference
-        // path — most-recent would misroute multi-model setups (e.g. a
-        // Whisper session connecting to Moonshine's stream)
-        server = find_server_by_model_name(resolve_model_name(model_name));
-    } else {
-        server = get_most_recent_server();
-    }
+    // Route by the session's requested model, like the normal inference
+    // path — most-recent would misroute multi-model setups (e.g. a
+    // Whisper session connecting to Moonshine's stream).
+    auto server = model_name.empty()
+        ? most_recent_server()
+        : lookup_server(resolve_model_name(model_name));
     if (!server) {
         return "";
     }
-    auto* streaming = dynamic_cast<IStreamingTranscriptionServer*>(server);
+    auto* streaming = dynamic_cast<IStreamingTranscriptionServer*>(server.get());
     return streaming ? streaming->get_streaming_address() : "";
 }
 
+int Router::serving_replica_count(const std::string& model_name) const {
+    auto registry = registry_snapshot();
+    auto it = registry->by_name.find(resolve_model_name(model_name));
+    if (it == registry->by_name.end()) {
+        return 0;
+    }
+    return static_cast<int>(std::count_if(it->second.begin(), it->second.end(),
+        [](const std::shared_ptr<WrappedServer>& server) { return server->is_backend_alive(); }));
+}
+
 template<typename Func>
 auto Router::execute_inference(const json& request, Func&& inference_func) -> decltype(inference_func(nullptr)) {
     std::string requested_model;
@@ -812,29 +1425,23 @@ auto Router::execute_inference(const json& request, Func&& inference_func) -> de
     // backend died before any response was returned. Retry exactly once after a
     // lazy reload; streaming paths deliberately do not retry after partial data.
     for (int attempt = 0; attempt < 2; ++attempt) {
-        WrappedServer* server = nullptr;
+        std::shared_ptr<WrappedServer> server_handle;  // Keeps the server alive for this attempt
         RecipeOptions restart_options;
         std::string restart_model_name;
         bool should_reload_before_request = false;
 
-        {
-            std::lock_guard<std::mutex> lock(load_mutex_);
-            server = find_server_by_model_name(resolve_model_name(requested_model));
-            if (!server) {
+        switch (acquire_server(resolve_model_name(requested_model), server_handle)) {
+            case AcquireStatus::NotLoaded:
                 return ErrorResponse::from_exception(ModelNotLoadedException(requested_model));
-            }
-
-            if (!server->is_backend_alive()) {
-                restart_options = server->get_recipe_options();
-                restart_model_name = server->get_model_name();
+            case AcquireStatus::BackendDead:
+                restart_options = server_handle->get_recipe_options();
+                restart_model_name = server_handle->get_model_name();
                 should_reload_before_request = true;
-            } else {
-                if (!server->acquire_for_inference()) {
-                    return ErrorResponse::from_exception(ModelNotLoadedException(requested_model));
-                }
-                server->update_access_time();
-            }
-        } // Lock released here
+                break;
+            case AcquireStatus::Acquired:
+                break;
+        }
+        WrappedServer* server = server_handle.get();
 
         if (should_reload_before_request) {
             if (restart_model_name.empty()) {
@@ -851,7 +1458,11 @@ auto Router::execute_inference(const json& request, Func&& inference_func) -> de
         }
 
         try {
+            const auto started = std::chrono::steady_clock::now();
             auto response = inference_func(server);
+            server->note_request_duration(std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - started).count());
+            note_if_cancelled(response, server->get_model_name());
             const bool watchdog_reset =
                 server->was_watchdog_triggered() || is_watchdog_reset_response(response);
 
@@ -910,37 +1521,28 @@ void Router::execute_streaming(const std::string& request_body, httplib::DataSin
     }
 
     for (int attempt = 0; attempt < 2; ++attempt) {
+        std::shared_ptr<WrappedServer> server_handle;  // Keeps the server alive for this attempt
         RecipeOptions restart_options;
         std::string restart_model_name;
         bool should_reload_before_request = false;
 
-        {
-            std::lock_guard<std::mutex> lock(load_mutex_);
-            server = find_server_by_model_name(resolve_model_name(requested_model));
-            if (!server) {
+        switch (acquire_server(resolve_model_name(requested_model), server_handle)) {
+            case AcquireStatus::NotLoaded: {
                 json error = ErrorResponse::from_exception(ModelNotLoadedException(requested_model));
                 std::string error_msg = "data: " + error.dump() + "\n\n";
                 sink.write(error_msg.c_str(), error_msg.size());
                 sink.done();
                 return;
             }
-
-            if (!server->is_backend_alive()) {
-                restart_options = server->get_recipe_options();
-                restart_model_name = server->get_model_name();
+            case AcquireStatus::BackendDead:
+                restart_options = server_handle->get_recipe_options();
+                restart_model_name = server_handle->get_model_name();
                 should_reload_before_request = true;
-            } else {
-                if (!server->acquire_for_inference()) {
-                    std::string error_msg =
-                        "data: {\"error\":{\"message\":\"Model evicted: " + requested_model +
-                        "\",\"type\":\"model_not_loaded\"}}\n\n";
-                    sink.write(error_msg.c_str(), error_msg.size());
-                    sink.done();
-                    return;
-                }
-                server->update_access_time();
-            }
-        } // Lock released here
+                break;
+            case AcquireStatus::Acquired:
+                break;
+        }
+        server = server_handle.get();
 
         if (should_reload_before_request) {
             if (restart_model_name.empty()) {
@@ -962,7 +1564,10 @@ void Router::execute_streaming(const std::string& request_body, httplib::DataSin
         }
 
         try {
+            const auto started = std::chrono::steady_clock::now();
             streaming_func(server);
+            server->note_request_duration(std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - started).count());
             const bool watchdog_reset = server->was_watchdog_triggered();
 
             if (watchdog_reset) {
@@ -1011,71 +1616,493 @@ void Router::execute_streaming(const std::string& request_body, httplib::DataSin
     }
 }
 
-json Router::chat_completion(const json& request) {
-    return execute_inference(request, [&](WrappedServer* server) {
-        return server->chat_completion(request);
+std::string Router::model_cache_scope(const json& request) const {
+    // The scope pins cached results to the exact weights and launch options of
+    // the loaded model, so a re-download or different recipe never serves
+    // stale output. Unknown models get no scope and skip caching; the normal
+    // path then reports the usual error.
+    if (!request.contains("model") || !request["model"].is_string()) {
+        return "";
+    }
+    auto server = lookup_server(resolve_model_name(request["model"].get<std::string>()));
+    if (!server || server->get_checkpoint().empty()) {
+        return "";
+    }
+    return server->get_checkpoint() + "\n" + server->get_recipe_options().to_json().dump();
+}
+
+std::string Router::response_cache_key(const std::string& endpoint, const json& request) {
+    response_cache_.configure(static_cast<size_t>(config_->response_cache_mb()) * 1024 * 1024,
+                              config_->response_cache_ttl_seconds(),
+                              config_->response_single_flight());
+    if (!ResponseCache::is_deterministic(request)) {
+        return "";
+    }
+    if (config_->response_cache_mb() == 0 && !config_->response_single_flight()) {
+        return "";
+    }
+    std::string scope = model_cache_scope(request);
+    return scope.empty() ? "" : ResponseCache::make_key(endpoint, scope, request);
+}
+
+namespace {
+
+// Prompt text of a chat/completion request: message contents (plain or text
+// parts) and completion prompts. Token-id prompts are left out.
+void collect_prompt_texts(const json& request, std::vector<const std::string*>& texts) {
+    auto add = [&texts](const json& value) {
+        if (value.is_string()) {
+            texts.push_back(&value.get_ref<const std::string&>());
+        }
+    };
+    if (request.contains("messages") && request["messages"].is_array()) {
+        for (const auto& message : request["messages"]) {
+            if (!message.is_object() || !message.contains("content")) {
+                continue;
+            }
+            const auto& content = message["content"];
+            if (content.is_array()) {
+                for (const auto& part : content) {
+                    if (part.is_object() && part.contains("text")) {
+                        add(part["text"]);
+                    }
+                }
+            } else {
+                add(content);
+            }
+        }
+    }
+    if (request.contains("prompt")) {
+        const auto& prompt = request["prompt"];
+        if (prompt.is_array()) {
+            for (const auto& item : prompt) {
+                add(item);
+            }
+        } else {
+            add(prompt);
+        }
+    }
+}
+
+bool is_valid_utf8(const std::string& text) {
+    size_t i = 0;
+    while (i < text.size()) {
+        const auto lead = static_cast<unsigned char>(text[i]);
+        const size_t n = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+        if (n == 0 || i + n > text.size()) {
+            return false;
+        }
+        for (size_t k = 1; k < n; ++k) {
+            if ((static_cast<unsigned char>(text[i + k]) & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+        i += n;
+    }
+    return true;
+}
+
+// Whether llama-server was started with --context-shift, which drops old
+// tokens instead of failing once the context fills. The last of
+// --context-shift and --no-context-shift wins, as on its command line.
+bool context_shift_enabled(const RecipeOptions& options) {
+    const json args_option = options.get_option("llamacpp_args");
+    if (!args_option.is_string()) {
+        return false;
+    }
+    bool enabled = false;
+    for (const auto& arg : utils::parse_custom_args(args_option.get<std::string>())) {
+        if (arg == "--context-shift") {
+            enabled = true;
+        } else if (arg == "--no-context-shift") {
+            enabled = false;
+        }
+    }
+    return enabled;
+}
+
+// Prompts are tokenized in pieces of this size so counting can stop once the
+// context is full, instead of tokenizing a huge paste end to end
+constexpr size_t PROMPT_CHECK_CHUNK_BYTES = 16 * 1024;
+
+// Counts the tokens of `text` until `limit` is reached. Pieces end before a
+// space where possible, otherwise on a UTF-8 boundary; each cut can add a
+// token at the seam, so it is counted in `cuts` for the caller to discount.
+int64_t count_tokens_up_to(const GgufTokenizer& tokenizer, const std::string& text, int64_t limit,
+                           int64_t& cuts) {
+    int64_t count = 0;
+    size_t pos = 0;
+    while (pos < text.size() && count < limit) {
+        size_t end = text.size();
+        if (end - pos > PROMPT_CHECK_CHUNK_BYTES) {
+            end = pos + PROMPT_CHECK_CHUNK_BYTES;
+            const size_t space = text.rfind(' ', end);
+            if (space != std::string::npos && space > pos + PROMPT_CHECK_CHUNK_BYTES / 2) {
+                end = space;
+            } else {
+                while (end > pos + 1 && (static_cast<unsigned char>(text[end]) & 0xC0) == 0x80) {
+                    --end;
+                }
+            }
+            ++cuts;
+            ++limit;
+        }
+        count += static_cast<int64_t>(tokenizer.tokenize(text.substr(pos, end - pos), false, true).size());
+        pos = end;
+    }
+    return count;
+}
+
+// Same request fields, defaults and response shape as llama-server's /tokenize
+json tokenize_with(const GgufTokenizer& tokenizer, const json& request) {
+    const bool add_special = request.value("add_special", false);
+    const bool parse_special = request.value("parse_special", true);
+    const bool with_pieces = request.value("with_pieces", false);
+    const auto ids = tokenizer.tokenize(request["content"].get<std::string>(), add_special, parse_special);
+
+    json tokens = json::array();
+    for (int32_t id : ids) {
+        if (!with_pieces) {
+            tokens.push_back(id);
+            continue;
+        }
+        // Pieces that split a UTF-8 sequence are returned as byte arrays
+        const std::string piece = tokenizer.token_to_piece(id);
+        json piece_json;
+        if (is_valid_utf8(piece)) {
+            piece_json = piece;
+        } else {
+            piece_json = json::array();
+            for (unsigned char c : piece) {
+                piece_json.push_back(static_cast<int>(c));
+            }
+        }
+        tokens.push_back({{"id", id}, {"piece", piece_json}});
+    }
+    return {{"tokens", tokens}};
+}
+
+} // namespace
+
+std::shared_ptr<const GgufTokenizer> Router::tokenizer_for(const std::string& canonical_model_name) {
+    ModelInfo model_info;
+    try {
+        model_info = model_manager_->get_model_info(canonical_model_name);
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+    if (model_info.recipe != "llamacpp") {
+        return nullptr;
+    }
+    // Skip models that are not downloaded so the cache never remembers a
+    // missing file as unsupported
+    const std::string path = model_info.resolved_path();
+    std::error_code ec;
+    if (path.empty() || !std::filesystem::is_regular_file(utils::path_from_utf8(path), ec)) {
+        return nullptr;
+    }
+    return tokenizers_.get(path);
+}
+
+json Router::check_prompt_fits(const json& request) {
+    if (!request.contains("model") || !request["model"].is_string()) {
+        return nullptr;
+    }
+    auto server = lookup_server(resolve_model_name(request["model"].get<std::string>()));
+    if (!server || server->get_model_type() != ModelType::LLM ||
+        !dynamic_cast<ITokenizerServer*>(server.get())) {
+        return nullptr;
+    }
+    const json ctx_option = server->get_recipe_options().get_option("ctx_size");
+    if (!ctx_option.is_number_integer() || ctx_option.get<int64_t>() <= 0) {
+        return nullptr;
+    }
+    const int64_t ctx_size = ctx_option.get<int64_t>();
+    // With context shift llama-server accepts prompts longer than the context
+    if (context_shift_enabled(server->get_recipe_options())) {
+        return nullptr;
+    }
+
+    std::vector<const std::string*> texts;
+    collect_prompt_texts(request, texts);
+    size_t bytes = 0;
+    for (const auto* text : texts) {
+        bytes += text->size();
+    }
+    // A token spans at least one byte, so prompts shorter than the context
+    // (plus BOS) fit without being tokenized
+    if (static_cast<int64_t>(bytes) + 1 < ctx_size) {
+        return nullptr;
+    }
+
+    auto tokenizer = tokenizer_for(server->get_model_name());
+    if (!tokenizer) {
+        return nullptr;
+    }
+    // Message text only: the chat template adds to it, so this never rejects
+    // a prompt llama-server would have accepted. Counting stops at the
+    // context size, so prompt_tokens is a lower bound for longer prompts.
+    int64_t counted = 0;
+    int64_t cuts = 0;
+    for (const auto* text : texts) {
+        if (counted - cuts >= ctx_size) {
+            break;
+        }
+        counted += count_tokens_up_to(*tokenizer, *text, ctx_size + cuts - counted, cuts);
+    }
+    const int64_t prompt_tokens = counted - cuts;
+    if (prompt_tokens < ctx_size) {
+        return nullptr;
+    }
+
+    LOG(INFO, "Router") << "Rejecting request for " << server->get_model_name() << ": prompt is at least "
+                        << prompt_tokens << " tokens, ctx_size is " << ctx_size << std::endl;
+    json error = ErrorResponse::create(
+        "The prompt is at least " + std::to_string(prompt_tokens) + " tokens, which exceeds the " +
+            std::to_string(ctx_size) + "-token context of model '" + server->get_model_name() + "'",
+        "invalid_request_error",
+        {{"prompt_tokens", prompt_tokens}, {"ctx_size", ctx_size}}
+    );
+    error["error"]["code"] = "context_length_exceeded";
+    error["error"]["status_code"] = 400;
+    return error;
+}
+
+bool Router::reject_oversized_stream(const std::string& request_body, httplib::DataSink& sink) {
+    json request = json::parse(request_body, nullptr, false);
+    json error = request.is_discarded() ? json() : check_prompt_fits(request);
+    if (error.is_null()) {
+        return false;
+    }
+    std::string error_msg = "data: " + error.dump() + "\n\n";
+    sink.write(error_msg.c_str(), error_msg.size());
+    sink.done();
+    return true;
+}
+
+void Router::stream_with_response_cache(const std::string& endpoint, const std::string& request_body,
+                                        httplib::DataSink& sink,
+                                        const std::function<void(httplib::DataSink&)>& run) {
+    json request = json::parse(request_body, nullptr, false);
+    std::string key = request.is_discarded() ? "" : response_cache_key(endpoint, request);
+    if (key.empty()) {
+        run(sink);
+        return;
+    }
+
+    std::string replay = response_cache_.run_stream(key, [&]() {
+        // Tee the live stream into a buffer so it can be shared with
+        // identical in-flight requests and cached for later replay.
+        std::string captured;
+        httplib::DataSink capture;
+        capture.is_writable = sink.is_writable;
+        capture.write = [&](const char* data, size_t len) -> bool {
+            captured.append(data, len);
+            return sink.write(data, len);
+        };
+        capture.done = [&]() { sink.done(); };
+        run(capture);
+        return captured;
     });
+
+    if (!replay.empty()) {
+        LOG(DEBUG, "Router") << "Replaying deterministic " << endpoint << " stream ("
+                             << replay.size() << " bytes)" << std::endl;
+        sink.write(replay.data(), replay.size());
+        sink.done();
+    }
+}
+
+json Router::chat_completion(const json& request) {
+    json oversized = check_prompt_fits(request);
+    if (!oversized.is_null()) {
+        return oversized;
+    }
+    auto compute = [&]() {
+        return execute_inference(request, [&](WrappedServer* server) {
+            return server->chat_completion(request);
+        });
+    };
+    std::string key = response_cache_key("/v1/chat/completions", request);
+    return key.empty() ? compute() : response_cache_.run(key, compute);
 }
 
 json Router::completion(const json& request) {
-    return execute_inference(request, [&](WrappedServer* server) {
-        return server->completion(request);
-    });
+    json oversized = check_prompt_fits(request);
+    if (!oversized.is_null()) {
+        return oversized;
+    }
+    auto compute = [&]() {
+        return execute_inference(request, [&](WrappedServer* server) {
+            return server->completion(request);
+        });
+    };
+    std::string key = response_cache_key("/v1/completions", request);
+    return key.empty() ? compute() : response_cache_.run(key, compute);
+}
+
+void Router::configure_embedding_cache() {
+    const long long cache_mb = config_->embedding_cache_mb();
+    const long long disk_mb = config_->embedding_cache_disk_mb();
+    embedding_cache_.configure(static_cast<size_t>(cache_mb) * 1024 * 1024,
+                               static_cast<size_t>(disk_mb) * 1024 * 1024,
+                               (utils::path_from_utf8(utils::get_cache_dir()) / "embeddings").string());
+}
+
+EmbeddingBatcher::Limits Router::embedding_batch_limits() const {
+    EmbeddingBatcher::Limits limits;
+    limits.window_ms = config_->embedding_batch_window_ms();
+    limits.max_batch_size = config_->embedding_batch_max_size();
+    limits.max_batch_tokens = config_->embedding_batch_max_tokens();
+    return limits;
 }
 
 json Router::embeddings(const json& request) {
-    return execute_inference(request, [&](WrappedServer* server) {
-        auto embeddings_server = dynamic_cast<IEmbeddingsServer*>(server);
-        if (!embeddings_server) {
-            return ErrorResponse::from_exception(
-                UnsupportedOperationException("Embeddings", device_type_to_string(server->get_device_type()))
-            );
+    auto dispatch = [this](const json& backend_request) {
+        return execute_inference(backend_request, [&](WrappedServer* server) {
+            auto embeddings_server = dynamic_cast<IEmbeddingsServer*>(server);
+            if (!embeddings_server) {
+                return ErrorResponse::from_exception(
+                    UnsupportedOperationException("Embeddings", device_type_to_string(server->get_device_type()))
+                );
+            }
+            return embeddings_server->embeddings(backend_request);
+        });
+    };
+    auto forward = [&](const json& backend_request) {
+        return embedding_batcher_.submit(EmbeddingBatcher::Kind::Embeddings, backend_request,
+                                         embedding_batch_limits(), dispatch);
+    };
+
+    std::string cache_scope;
+    std::vector<json> items;
+    if (embedding_cache_.enabled() &&
+        EmbeddingBatcher::extract_items(EmbeddingBatcher::Kind::Embeddings, request, items)) {
+        cache_scope = model_cache_scope(request);
+    }
+    if (cache_scope.empty()) {
+        return forward(request);
+    }
+    return embeddings_with_cache(request, cache_scope, items, forward);
+}
+
+json Router::embeddings_with_cache(const json& request, const std::string& cache_scope,
+                                   const std::vector<json>& items,
+                                   const std::function<json(const json&)>& forward) {
+    // Everything except the inputs themselves (encoding_format, dimensions,
+    // normalization flags, ...) can change the returned vectors.
+    json options = request;
+    options.erase("input");
+    options.erase("model");
+    options.erase("user");
+
+    std::vector<std::string> keys(items.size());
+    std::vector<json> embeddings(items.size());
+    std::vector<size_t> misses;
+    for (size_t i = 0; i < items.size(); ++i) {
+        keys[i] = EmbeddingCache::make_key(cache_scope, options, items[i]);
+        const size_t input_bytes = items[i].is_string()
+            ? items[i].get_ref<const std::string&>().size()
+            : items[i].dump().size();
+        if (!embedding_cache_.lookup(keys[i], input_bytes, embeddings[i])) {
+            misses.push_back(i);
         }
-        return embeddings_server->embeddings(request);
-    });
+    }
+
+    json response = {
+        {"object", "list"},
+        {"model", request["model"]},
+        {"usage", {{"prompt_tokens", 0}, {"total_tokens", 0}}}
+    };
+    if (!misses.empty()) {
+        json backend_request = request;
+        if (misses.size() != items.size()) {
+            json miss_items = json::array();
+            for (size_t i : misses) {
+                miss_items.push_back(items[i]);
+            }
+            backend_request["input"] = std::move(miss_items);
+        }
+        json backend_response = forward(backend_request);
+        if (!backend_response.is_object() || backend_response.contains("error") ||
+            !backend_response.contains("data") || !backend_response["data"].is_array()) {
+            return backend_response;
+        }
+
+        const json& data = backend_response["data"];
+        for (size_t pos = 0; pos < data.size(); ++pos) {
+            size_t index = pos;
+            if (data[pos].contains("index") && data[pos]["index"].is_number_unsigned()) {
+                index = data[pos]["index"].get<size_t>();
+            }
+            if (index < misses.size() && data[pos].contains("embedding")) {
+                embeddings[misses[index]] = data[pos]["embedding"];
+                embedding_cache_.insert(keys[misses[index]], data[pos]["embedding"]);
+            }
+        }
+        for (size_t i : misses) {
+            if (embeddings[i].is_null()) {
+                return ErrorResponse::create(
+                    "Backend returned " + std::to_string(data.size()) + " embeddings for " +
+                        std::to_string(misses.size()) + " inputs",
+                    ErrorType::BACKEND_ERROR);
+            }
+        }
+        // Usage reflects the work the backend actually did for the misses.
+        backend_response.erase("data");
+        response.update(backend_response);
+    }
+
+    json data = json::array();
+    for (size_t i = 0; i < embeddings.size(); ++i) {
+        data.push_back({{"object", "embedding"}, {"index", i}, {"embedding", std::move(embeddings[i])}});
+    }
+    response["data"] = std::move(data);
+    return response;
 }
 
 json Router::reranking(const json& request) {
-    return execute_inference(request, [&](WrappedServer* server) {
-        auto reranking_server = dynamic_cast<IRerankingServer*>(server);
-        if (!reranking_server) {
-            return ErrorResponse::from_exception(
-                UnsupportedOperationException("Reranking", device_type_to_string(server->get_device_type()))
-            );
-        }
-        return reranking_server->reranking(request);
-    });
+    auto dispatch = [this](const json& backend_request) {
+        return execute_inference(backend_request, [&](WrappedServer* server) {
+            auto reranking_server = dynamic_cast<IRerankingServer*>(server);
+            if (!reranking_server) {
+                return ErrorResponse::from_exception(
+                    UnsupportedOperationException("Reranking", device_type_to_string(server->get_device_type()))
+                );
+            }
+            return reranking_server->reranking(backend_request);
+        });
+    };
+    return embedding_batcher_.submit(EmbeddingBatcher::Kind::Reranking, request,
+                                     embedding_batch_limits(), dispatch);
 }
 
 json Router::get_slots() {
-    WrappedServer* server = nullptr;
+    std::shared_ptr<WrappedServer> server_handle = most_recent_server();
+    WrappedServer* server = server_handle.get();
     ISlotsServer* slots_server = nullptr;
 
-    {
-        std::lock_guard<std::mutex> lock(load_mutex_);
-        server = get_most_recent_server();
-        if (!server) {
-            return ErrorResponse::from_exception(
-                ModelNotLoadedException("No models loaded")
-            );
-        }
+    if (!server) {
+        return ErrorResponse::from_exception(
+            ModelNotLoadedException("No models loaded")
+        );
+    }
 
-        // Check if server supports slots capability
-        slots_server = dynamic_cast<ISlotsServer*>(server);
-        if (!slots_server) {
-            return ErrorResponse::from_exception(
-                UnsupportedOperationException("Slots", device_type_to_string(server->get_device_type()))
-            );
-        }
+    // Check if server supports slots capability
+    slots_server = dynamic_cast<ISlotsServer*>(server);
+    if (!slots_server) {
+        return ErrorResponse::from_exception(
+            UnsupportedOperationException("Slots", device_type_to_string(server->get_device_type()))
+        );
+    }
 
-        // Mark as busy and update access time
-        if (!server->acquire_for_inference()) {
-            return ErrorResponse::from_exception(ModelNotLoadedException("No models loaded"));
-        }
-        server->update_access_time();
-    } // Lock released here
+    // Mark as busy and update access time
+    if (!server->acquire_for_inference()) {
+        return ErrorResponse::from_exception(ModelNotLoadedException("No models loaded"));
+    }
+    server->update_access_time();
 
-    // Execute without holding lock (but busy flag prevents eviction)
+    // The handle keeps the server alive; the busy flag defers its eviction
     try {
         auto response = slots_server->get_slots();
         server->release_inference();
@@ -1087,34 +2114,31 @@ json Router::get_slots() {
 }
 
 json Router::slots_action(int slot_id, const std::string& action, const json& request_body) {
-    WrappedServer* server = nullptr;
+    std::shared_ptr<WrappedServer> server_handle = most_recent_server();
+    WrappedServer* server = server_handle.get();
     ISlotsServer* slots_server = nullptr;
 
-    {
-        std::lock_guard<std::mutex> lock(load_mutex_);
-        server = get_most_recent_server();
-        if (!server) {
-            return ErrorResponse::from_exception(
-                ModelNotLoadedException("No models loaded")
-            );
-        }
+    if (!server) {
+        return ErrorResponse::from_exception(
+            ModelNotLoadedException("No models loaded")
+        );
+    }
 
-        // Check if server supports slots capability
-        slots_server = dynamic_cast<ISlotsServer*>(server);
-        if (!slots_server) {
-            return ErrorResponse::from_exception(
-                UnsupportedOperationException("Slots", device_type_to_string(server->get_device_type()))
-            );
-        }
+    // Check if server supports slots capability
+    slots_server = dynamic_cast<ISlotsServer*>(server);
+    if (!slots_server) {
+        return ErrorResponse::from_exception(
+            UnsupportedOperationException("Slots", device_type_to_string(server->get_device_type()))
+        );
+    }
 
-        // Mark as busy and update access time
-        if (!server->acquire_for_inference()) {
-            return ErrorResponse::from_exception(ModelNotLoadedException("No models loaded"));
-        }
-        server->update_access_time();
-    } // Lock released here
+    // Mark as busy and update access time
+    if (!server->acquire_for_inference()) {
+        return ErrorResponse::from_exception(ModelNotLoadedException("No models loaded"));
+    }
+    server->update_access_time();
 
-    // Execute without holding lock (but busy flag prevents eviction)
+    // The handle keeps the server alive; the busy flag defers its eviction
     try {
         auto response = slots_server->slots_action(slot_id, action, request_body);
         server->release_inference();
@@ -1126,34 +2150,45 @@ json Router::slots_action(int slot_id, const std::string& action, const json& re
 }
 
 json Router::tokenize(const json& request_body) {
-    WrappedServer* server = nullptr;
+    // Answer from the model's GGUF vocabulary when it can be read here: no
+    // backend round trip, and a model named in the request need not be loaded
+    std::string model_name;
+    if (request_body.contains("model") && request_body["model"].is_string()) {
+        model_name = resolve_model_name(request_body["model"].get<std::string>());
+    } else if (auto recent = most_recent_server()) {
+        model_name = recent->get_model_name();
+    }
+    if (!model_name.empty() && request_body.contains("content") && request_body["content"].is_string()) {
+        if (auto tokenizer = tokenizer_for(model_name)) {
+            return tokenize_with(*tokenizer, request_body);
+        }
+    }
+
+    std::shared_ptr<WrappedServer> server_handle = most_recent_server();
+    WrappedServer* server = server_handle.get();
     ITokenizerServer* tokenizer_server = nullptr;
 
-    {
-        std::lock_guard<std::mutex> lock(load_mutex_);
-        server = get_most_recent_server();
-        if (!server) {
-            return ErrorResponse::from_exception(
-                ModelNotLoadedException("No models loaded")
-            );
-        }
+    if (!server) {
+        return ErrorResponse::from_exception(
+            ModelNotLoadedException("No models loaded")
+        );
+    }
 
-        // Check if server supports tokenize capability
-        tokenizer_server = dynamic_cast<ITokenizerServer*>(server);
-        if (!tokenizer_server) {
-            return ErrorResponse::from_exception(
-                UnsupportedOperationException("Tokenization", device_type_to_string(server->get_device_type()))
-            );
-        }
+    // Check if server supports tokenize capability
+    tokenizer_server = dynamic_cast<ITokenizerServer*>(server);
+    if (!tokenizer_server) {
+        return ErrorResponse::from_exception(
+            UnsupportedOperationException("Tokenization", device_type_to_string(server->get_device_type()))
+        );
+    }
 
-        // Mark as busy and update access time
-        if (!server->acquire_for_inference()) {
-            return ErrorResponse::from_exception(ModelNotLoadedException("No models loaded"));
-        }
-        server->update_access_time();
-    } // Lock released here
+    // Mark as busy and update access time
+    if (!server->acquire_for_inference()) {
+        return ErrorResponse::from_exception(ModelNotLoadedException("No models loaded"));
+    }
+    server->update_access_time();
 
-    // Execute without holding lock (but busy flag prevents eviction)
+    // The handle keeps the server alive; the busy flag defers its eviction
     try {
         auto response = tokenizer_server->tokenize(request_body);
         server->release_inference();
@@ -1247,8 +2282,7 @@ json Router::get_metrics_snapshot() const {
     std::map<std::string, ModelTelemetryIdentity> loaded_identities;
 
     {
-        std::lock_guard<std::mutex> lock(load_mutex_);
-        for (const auto& server : loaded_servers_) {
+        for (const auto& server : registry_snapshot()->servers) {
             ModelTelemetryIdentity identity = get_telemetry_identity(server.get());
             loaded_identities[identity.key()] = identity;
 
@@ -1260,6 +2294,9 @@ json Router::get_metrics_snapshot() const {
             model_info["backend_url"] = server->get_address();
             model_info["pid"] = server->get_process_id();
             model_info["recipe"] = identity.recipe;
+            model_info["replica"] = server->get_replica_index();
+            model_info["active_requests"] = server->get_active_request_count();
+            model_info["load_timing"] = server->get_load_timing().to_json();
             result["loaded_models"].push_back(model_info);
         }
     }
@@ -1276,6 +2313,7 @@ json Router::get_metrics_snapshot() const {
             model_info["recipe"] = record.identity.recipe;
             model_info["loaded"] = loaded_identities.find(item.first) != loaded_identities.end();
             model_info["telemetry"] = record.telemetry.to_json();
+            add_estimated_cost(model_info, record.identity.model_name, record.telemetry);
             result["model_metrics"].push_back(model_info);
         }
 
@@ -1301,9 +2339,63 @@ json Router::get_metrics_snapshot() const {
         result["totals"]["prompt_tokens"] = aggregate_telemetry_.prompt_tokens_total;
     }
 
+    if (peer_cluster_) {
+        result["peers"] = peer_cluster_->snapshot();
+    }
+
+    result["spillover"] = json::array();
+    {
+        std::lock_guard<std::mutex> lock(spillover_mutex_);
+        for (const auto& [key, count] : spillover_counts_) {
+            result["spillover"].push_back({
+                {"model_name", model_manager_->get_public_model_name(std::get<0>(key))},
+                {"fallback", model_manager_->get_public_model_name(std::get<1>(key))},
+                {"reason", std::get<2>(key)},
+                {"requests", count}
+            });
+        }
+    }
+
+    result["cancelled"] = json::array();
+    {
+        std::lock_guard<std::mutex> lock(cancelled_mutex_);
+        for (const auto& [model_name, count] : cancelled_counts_) {
+            result["cancelled"].push_back({
+                {"model_name", model_manager_->get_public_model_name(model_name)},
+                {"requests", count}
+            });
+        }
+    }
+
+    result["embedding_batcher"] = embedding_batcher_.get_stats();
+    result["embedding_cache"] = embedding_cache_.get_stats();
+    result["response_cache"] = response_cache_.get_stats();
+
     return result;
 }
 
+void Router::add_estimated_cost(json& model_info, const std::string& model_name,
+                                const Telemetry& telemetry) const {
+    // Priced from the provider-reported per-million-token costs recorded for
+    // cloud models; local models have none
+    try {
+        const ModelInfo info = model_manager_->get_model_info(model_name);
+        if (info.cost_input_per_million < 0 && info.cost_output_per_million < 0) {
+            return;
+        }
+        double cost = 0.0;
+        if (info.cost_input_per_million > 0) {
+            cost += static_cast<double>(telemetry.input_tokens_total) * info.cost_input_per_million / 1e6;
+        }
+        if (info.cost_output_per_million > 0) {
+            cost += static_cast<double>(telemetry.output_tokens_total) * info.cost_output_per_million / 1e6;
+        }
+        model_info["estimated_cost"] = cost;
+    } catch (...) {
+        // Registry entry gone (e.g. deleted); no price to apply
+    }
+}
+
 ModelTelemetryIdentity Router::get_telemetry_identity(WrappedServer* server) const {
     if (!server) {
         return {};
@@ -1376,11 +2468,10 @@ void Router::update_telemetry(const std::string& model_name,
                               double time_to_first_token, double tokens_per_second) {
     ModelTelemetryIdentity identity;
     {
-        std::lock_guard<std::mutex> lock(load_mutex_);
-        WrappedServer* server = model_name.empty()
-            ? get_most_recent_server()
-            : find_server_by_model_name(resolve_model_name(model_name));
-        identity = get_telemetry_identity(server);
+        auto server = model_name.empty()
+            ? most_recent_server()
+            : lookup_server(resolve_model_name(model_name));
+        identity = get_telemetry_identity(server.get());
     }
     record_telemetry_for_model(identity, input_tokens, output_tokens,
                                time_to_first_token, tokens_per_second);
@@ -1389,42 +2480,51 @@ void Router::update_telemetry(const std::string& model_name,
 void Router::update_prompt_tokens(const std::string& model_name, int prompt_tokens) {
     ModelTelemetryIdentity identity;
     {
-        std::lock_guard<std::mutex> lock(load_mutex_);
-        WrappedServer* server = model_name.empty()
-            ? get_most_recent_server()
-            : find_server_by_model_name(resolve_model_name(model_name));
-        identity = get_telemetry_identity(server);
+        auto server = model_name.empty()
+            ? most_recent_server()
+            : lookup_server(resolve_model_name(model_name));
+        identity = get_telemetry_identity(server.get());
     }
     record_prompt_tokens_for_model(identity, prompt_tokens);
 }
 
 void Router::chat_completion_stream(const std::string& request_body, httplib::DataSink& sink) {
-    execute_streaming(request_body, sink, [&](WrappedServer* server) {
-        ModelTelemetryIdentity identity = get_telemetry_identity(server);
-        server->forward_streaming_request("/v1/chat/completions", request_body, sink, true, 0,
-            [this, identity](int input_tokens,
-                             int output_tokens,
-                             double time_to_first_token,
-                             double tokens_per_second) {
-                record_telemetry_for_model(identity, input_tokens, output_tokens,
-                                           time_to_first_token, tokens_per_second);
-                record_prompt_tokens_for_model(identity, input_tokens);
-            });
+    if (reject_oversized_stream(request_body, sink)) {
+        return;
+    }
+    stream_with_response_cache("/v1/chat/completions", request_body, sink, [&](httplib::DataSink& target) {
+        execute_streaming(request_body, target, [&](WrappedServer* server) {
+            ModelTelemetryIdentity identity = get_telemetry_identity(server);
+            server->forward_streaming_request("/v1/chat/completions", request_body, target, true, 0,
+                [this, identity](int input_tokens,
+                                 int output_tokens,
+                                 double time_to_first_token,
+                                 double tokens_per_second) {
+                    record_telemetry_for_model(identity, input_tokens, output_tokens,
+                                               time_to_first_token, tokens_per_second);
+                    record_prompt_tokens_for_model(identity, input_tokens);
+                });
+        });
     });
 }
 
 void Router::completion_stream(const std::string& request_body, httplib::DataSink& sink) {
-    execute_streaming(request_body, sink, [&](WrappedServer* server) {
-        ModelTelemetryIdentity identity = get_telemetry_identity(server);
-        server->forward_streaming_request("/v1/completions", request_body, sink, true, 0,
-            [this, identity](int input_tokens,
-                             int output_tokens,
-                             double time_to_first_token,
-                             double tokens_per_second) {
-                record_telemetry_for_model(identity, input_tokens, output_tokens,
-                                           time_to_first_token, tokens_per_second);
-                record_prompt_tokens_for_model(identity, input_tokens);
-            });
+    if (reject_oversized_stream(request_body, sink)) {
+        return;
+    }
+    stream_with_response_cache("/v1/completions", request_body, sink, [&](httplib::DataSink& target) {
+        execute_streaming(request_body, target, [&](WrappedServer* server) {
+            ModelTelemetryIdentity identity = get_telemetry_identity(server);
+            server->forward_streaming_request("/v1/completions", request_body, target, true, 0,
+                [this, identity](int input_tokens,
+                                 int output_tokens,
+                                 double time_to_first_token,
+                                 double tokens_per_second) {
+                    record_telemetry_for_model(identity, input_tokens, output_tokens,
+                                               time_to_first_token, tokens_per_second);
+                    record_prompt_tokens_for_model(identity, input_tokens);
+                });
+        });
     });
 }
 
@@ -1444,20 +2544,19 @@ void Router::responses_stream(const std::string& request_body, httplib::DataSink
 }
 
 int Router::count_pinned_servers_by_type(ModelType type) const {
-    int count = 0;
-    for (const auto& server : loaded_servers_) {
+    std::set<std::string> models;
+    for (const auto& server : registry_snapshot()->servers) {
         if (server->get_recipe_options().get_recipe() == "cloud") {
             continue;
         }
         if (server->is_backend_alive() && server->get_model_type() == type && server->is_pinned()) {
-            count++;
+            models.insert(server->get_model_name());
         }
     }
-    return count;
+    return static_cast<int>(models.size());
 }
 
 json Router::get_pinned_model_counts() const {
-    std::lock_guard<std::mutex> lock(load_mutex_);
     return {
         {"llm", count_pinned_servers_by_type(ModelType::LLM)},
         {"embedding", count_pinned_servers_by_type(ModelType::EMBEDDING)},
@@ -1470,11 +2569,18 @@ json Router::get_pinned_model_counts() const {
 
 void Router::set_model_pinned(const std::string& model_name, bool pinned) {
     std::lock_guard<std::mutex> lock(load_mutex_);
-    WrappedServer* server = find_server_by_model_name(model_name);
-    if (!server) {
+    auto replicas = find_replicas_locked(model_name);
+    if (replicas.empty()) {
         throw std::runtime_error("Model not loaded: " + model_name);
     }
-    server->set_pinned(pinned);
+    for (auto* replica : replicas) {
+        replica->set_pinned(pinned);
+        // Pinned models are never armed, so arm now instead of leaving it to
+        // the engine's fallback pass
+        if (!pinned) {
+            eviction_engine_->note_activity(replica);
+        }
+    }
 }
 
 } // namespace lemon
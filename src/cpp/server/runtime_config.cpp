@@ -250,6 +250,100 @@ double RuntimeConfig::auto_evict_threshold_pct() const {
     return 0.90;
 }
 
+int RuntimeConfig::embedding_batch_window_ms() const {
+    std::shared_lock lock(mutex_);
+    if (config_.contains("embedding_batch_window_ms")) {
+        return config_["embedding_batch_window_ms"].get<int>();
+    }
+    // Default: coalescing disabled; every request goes straight to the backend.
+    return 0;
+}
+
+int RuntimeConfig::embedding_batch_max_size() const {
+    std::shared_lock lock(mutex_);
+    if (config_.contains("embedding_batch_max_size")) {
+        return config_["embedding_batch_max_size"].get<int>();
+    }
+    return 64;
+}
+
+int RuntimeConfig::embedding_batch_max_tokens() const {
+    std::shared_lock lock(mutex_);
+    if (config_.contains("embedding_batch_max_tokens")) {
+        return config_["embedding_batch_max_tokens"].get<int>();
+    }
+    return 8192;
+}
+
+int RuntimeConfig::embedding_cache_mb() const {
+    std::shared_lock lock(mutex_);
+    if (config_.contains("embedding_cache_mb")) {
+        return config_["embedding_cache_mb"].get<int>();
+    }
+    // Default: cache disabled; every input is embedded by the backend.
+    return 0;
+}
+
+int RuntimeConfig::embedding_cache_disk_mb() const {
+    std::shared_lock lock(mutex_);
+    if (config_.contains("embedding_cache_disk_mb")) {
+        return config_["embedding_cache_disk_mb"].get<int>();
+    }
+    return 0;
+}
+
+int RuntimeConfig::response_cache_mb() const {
+    std::shared_lock lock(mutex_);
+    if (config_.contains("response_cache_mb")) {
+        return config_["response_cache_mb"].get<int>();
+    }
+    // Default: no response caching
+    return 0;
+}
+
+int RuntimeConfig::response_cache_ttl_seconds() const {
+    std::shared_lock lock(mutex_);
+    if (config_.contains("response_cache_ttl_seconds")) {
+        return config_["response_cache_ttl_seconds"].get<int>();
+    }
+    return 300;
+}
+
+bool RuntimeConfig::response_single_flight() const {
+    std::shared_lock lock(mutex_);
+    if (config_.contains("response_single_flight")) {
+        return config_["response_single_flight"].get<bool>();
+    }
+    // Opt-in: a joining streaming request gets no output until the leader's
+    // stream has finished, then a replay of it
+    return false;
+}
+
+bool RuntimeConfig::peer_forwarding() const {
+    std::shared_lock lock(mutex_);
+    if (config_.contains("peer_forwarding")) {
+        return config_["peer_forwarding"].get<bool>();
+    }
+    return false;
+}
+
+std::string RuntimeConfig::peers() const {
+    std::shared_lock lock(mutex_);
+    if (config_.contains("peers")) {
+        return config_["peers"].get<std::string>();
+    }
+    return "";
+}
+
+bool RuntimeConfig::peer_discovery() const {
+    std::shared_lock lock(mutex_);
+    if (config_.contains("peer_discovery")) {
+        return config_["peer_discovery"].get<bool>();
+    }
+    // Opt-in: beacon peers are sent the API key and forwarded prompts
+    return false;
+}
+
 bool RuntimeConfig::offline() const {
 
     std::shared_lock lock(mutex_);
@@ -480,6 +574,57 @@ void RuntimeConfig::validate(const std::string& key, const json& value) const {
         if (value.get<double>() <= 0.0 || value.get<double>() > 1.0) {
             throw std::invalid_argument("'auto_evict_threshold_pct' must be between 0.0 and 1.0");
         }
+    } else if (key == "embedding_batch_window_ms") {
+        if (!value.is_number_integer()) {
+            throw std::invalid_argument("'embedding_batch_window_ms' must be an integer");
+        }
+        if (value.get<int>() < 0 || value.get<int>() > 1000) {
+            throw std::invalid_argument("'embedding_batch_window_ms' must be between 0 and 1000");
+        }
+    } else if (key == "embedding_batch_max_size" || key == "embedding_batch_max_tokens") {
+        if (!value.is_number_integer()) {
+            throw std::invalid_argument("'" + key + "' must be an integer");
+        }
+        if (value.get<int>() <= 0) {
+            throw std::invalid_argument("'" + key + "' must be positive");
+        }
+    } else if (key == "embedding_cache_mb" || key == "embedding_cache_disk_mb") {
+        if (!value.is_number_integer()) {
+            throw std::invalid_argument("'" + key + "' must be an integer");
+        }
+        if (value.get<int>() < 0) {
+            throw std::invalid_argument("'" + key + "' must be >= 0");
+        }
+    } else if (key == "response_cache_mb") {
+        if (!value.is_number_integer()) {
+            throw std::invalid_argument("'response_cache_mb' must be an integer");
+        }
+        if (value.get<int>() < 0) {
+            throw std::invalid_argument("'response_cache_mb' must be >= 0");
+        }
+    } else if (key == "response_cache_ttl_seconds") {
+        if (!value.is_number_integer()) {
+            throw std::invalid_argument("'response_cache_ttl_seconds' must be an integer");
+        }
+        if (value.get<int>() <= 0) {
+            throw std::invalid_argument("'response_cache_ttl_seconds' must be positive");
+        }
+    } else if (key == "response_single_flight") {
+        if (!value.is_boolean()) {
+            throw std::invalid_argument("'response_single_flight' must be a boolean");
+        }
+    } else if (key == "peer_forwarding") {
+        if (!value.is_boolean()) {
+            throw std::invalid_argument("'peer_forwarding' must be a boolean");
+        }
+    } else if (key == "peers") {
+        if (!value.is_string()) {
+            throw std::invalid_argument("'peers' must be a string");
+        }
+    } else if (key == "peer_discovery") {
+        if (!value.is_boolean()) {
+            throw std::invalid_argument("'peer_discovery' must be a boolean");
+        }
     } else if (key == "config_version") {
         if (!value.is_number_integer()) {
             throw std::invalid_argument("'config_version' must be an integer");
@@ -3,6 +3,7 @@
 #include "lemon/collection_orchestrator.h"
 #include "lemon/hf_variants.h"
 #include "lemon/config_file.h"
+#include "lemon/cpu_placement.h"
 #include "lemon/mcp_server.h"
 #include "lemon/ollama_api.h"
 #include "lemon/backends/cloud_server.h"
@@ -16,6 +17,7 @@
 #include "lemon/prometheus_metrics.h"
 #include "lemon/runtime_config.h"
 #include "lemon/system_info.h"
+#include "lemon/static_asset_cache.h"
 #include "lemon/version.h"
 #include <cctype>
 #include <cstdint>
@@ -27,6 +29,7 @@
 #include <map>
 #include <memory>
 #include <thread>
+#include <future>
 #include <chrono>
 #include <mutex>
 #include <filesystem>
@@ -196,6 +199,8 @@ bool is_quiet_polling_path(const std::string& path) {
            path == "/v0/downloads" || path == "/v1/downloads" ||
            path == "/api/v0/system-stats" || path == "/api/v1/system-stats" ||
            path == "/v0/system-stats" || path == "/v1/system-stats" ||
+           path == "/api/v0/system-stats/history" || path == "/api/v1/system-stats/history" ||
+           path == "/v0/system-stats/history" || path == "/v1/system-stats/history" ||
            path == "/api/v0/stats" || path == "/api/v1/stats" ||
            path == "/v0/stats" || path == "/v1/stats";
 }
@@ -235,8 +240,7 @@ static const json MIME_TYPES = {
 Server::Server(std::shared_ptr<RuntimeConfig> config, const std::string& cache_dir)
     : config_(config),
       cache_dir_(cache_dir),
-      port_(config->port()), running_(false), udp_beacon_(),
-      metrics_platform_(create_metrics_platform()) {
+      port_(config->port()), running_(false), udp_beacon_() {
 
     // Set global HttpClient timeout
     utils::HttpClient::set_default_timeout(config->global_timeout());
@@ -263,6 +267,45 @@ Server::Server(std::shared_ptr<RuntimeConfig> config, const std::string& cache_d
                                        backend_manager_.get());
     router_->set_cloud_registry(cloud_registry_.get());
 
+    peer_cluster_ = std::make_unique<PeerCluster>();
+    router_->set_peer_cluster(peer_cluster_.get());
+
+    upscale_workers_ = std::make_unique<backends::UpscaleWorkerPool>(
+        [](const std::string& b64_image, const std::string& upscale_model_path,
+           const std::string& cli_exe_path, const backends::UpscaleWorkerPool::EnvVars& env_vars) {
+            return backends::SDServer::upscale_via_cli(b64_image, upscale_model_path, cli_exe_path, env_vars);
+        });
+
+    // One sampler feeds /metrics, /system-stats and its history, so polling
+    // clients never hit /proc, sysfs or driver ioctls on the request path.
+    metrics_sampler_ = std::make_unique<SystemMetricsSampler>(create_metrics_platform());
+    metrics_sampler_->set_backend_provider([this]() { return router_->get_backend_pids(); });
+    metrics_sampler_->start();
+
+    // Backend-native metrics are scraped off the request path and cached
+    backend_metrics_ = std::make_unique<BackendMetricsCollector>(
+        [this]() {
+            std::vector<BackendMetricsCollector::Target> targets;
+            json snapshot = router_->get_metrics_snapshot();
+            for (const auto& model : snapshot.value("loaded_models", json::array())) {
+                targets.push_back({
+                    model.value("backend_url", ""),
+                    model.value("recipe", ""),
+                    {
+                        {"model_name", model.value("model_name", "")},
+                        {"checkpoint", model.value("checkpoint", "")},
+                        {"type", model.value("type", "")},
+                        {"device", model.value("device", "")},
+                        {"recipe", model.value("recipe", "")},
+                        {"replica", std::to_string(model.value("replica", 0))}
+                    }
+                });
+            }
+            return targets;
+        },
+        make_backend_metrics_fetcher());
+    backend_metrics_->start();
+
     LOG(DEBUG, "Server") << "Debug logging enabled - subprocess output will be visible" << std::endl;
 
     const char* api_key_env = std::getenv("LEMONADE_API_KEY");
@@ -371,7 +414,10 @@ void Server::stop_http_listeners() {
 }
 
 Server::~Server() {
+    backend_metrics_->stop();
+    metrics_sampler_->stop();
     cancel_download_jobs();
+    cancel_autotune_job();
     stop();
 }
 
@@ -506,6 +552,11 @@ void Server::setup_routes(httplib::Server &web_server) {
         handle_health(req, res);
     });
 
+    // Load report polled by other nodes of a cluster (see peer_forwarding)
+    register_get("peer/status", [this](const httplib::Request& req, httplib::Response& res) {
+        handle_peer_status(req, res);
+    });
+
     // Models endpoints
     register_get("models", [this](const httplib::Request& req, httplib::Response& res) {
         handle_models(req, res);
@@ -619,6 +670,14 @@ void Server::setup_routes(httplib::Server &web_server) {
         handle_load(req, res);
     });
 
+    register_post("autotune", [this](const httplib::Request& req, httplib::Response& res) {
+        handle_autotune(req, res);
+    });
+
+    register_get("autotune", [this](const httplib::Request& req, httplib::Response& res) {
+        handle_autotune_status(req, res);
+    });
+
     register_post("unload", [this](const httplib::Request& req, httplib::Response& res) {
         handle_unload(req, res);
     });
@@ -653,6 +712,10 @@ void Server::setup_routes(httplib::Server &web_server) {
         handle_system_stats(req, res);
     });
 
+    register_get("system-stats/history", [this](const httplib::Request& req, httplib::Response& res) {
+        handle_system_stats_history(req, res);
+    });
+
     register_post("log-level", [this](const httplib::Request& req, httplib::Response& res) {
         handle_log_level(req, res);
     });
@@ -944,79 +1007,48 @@ window.api = {
 
         // Serve all static assets from the web app directory (JS, CSS, fonts, assets, etc.)
         // Handle both root-level assets and /web-app/ prefixed paths for backwards compatibility
-        auto serve_web_app_asset = [web_app_dir](const httplib::Request& req, httplib::Response& res, const std::string& file_path) {
-            std::error_code ec;
-            namespace fs = std::filesystem;
-
-            auto base = fs::weakly_canonical(fs::path(web_app_dir), ec);
-            if (ec) {
-                res.status = 500;
-                res.set_content("Internal server error", "text/plain");
-                return;
-            }
-
-            auto candidate = fs::weakly_canonical(base / file_path, ec);
-            if (ec) {
-                // Path doesn't exist or cannot be canonicalized
+        // Assets are served from an in-memory, precompressed snapshot that is
+        // rebuilt when the directory changes (see StaticAssetCache).
+        if (!web_app_assets_) {
+            web_app_assets_ = std::make_shared<StaticAssetCache>(web_app_dir);
+        }
+        auto serve_web_app_asset = [assets = web_app_assets_](const httplib::Request& req, httplib::Response& res, const std::string& file_path) {
+            std::shared_ptr<const StaticAssetCache::Table> snapshot;
+            const StaticAssetCache::Asset* asset = assets->find(file_path, snapshot);
+            if (!asset) {
                 res.status = 404;
                 res.set_content("File not found", "text/plain");
                 return;
             }
 
-            // Verify the resolved path is confined under the base directory.
-            // Use std::filesystem::relative (not string prefix) so it works
-            // correctly on Windows where path separators differ.
-            auto relative = fs::relative(candidate, base, ec);
-            if (ec || relative.empty() || relative.is_absolute()) {
-                // empty = candidate == base (directory, not a file)
-                // is_absolute = somehow escaped (shouldn't happen after canonicalization)
-                res.status = 403;
-                res.set_content("Forbidden", "text/plain");
+            std::string encoding;
+            const std::string& body = StaticAssetCache::select_encoding(
+                *asset, req.get_header_value("Accept-Encoding"), encoding);
+
+            res.set_header("ETag", StaticAssetCache::etag_for(*asset, encoding));
+            res.set_header("Vary", "Accept-Encoding");
+            // Hashed filenames never change content, so browsers may keep them
+            // forever; everything else is revalidated cheaply via If-None-Match.
+            res.set_header("Cache-Control", asset->immutable
+                ? "public, max-age=31536000, immutable"
+                : "no-cache");
+
+            if (req.has_header("If-None-Match") &&
+                StaticAssetCache::etag_matches(*asset, req.get_header_value("If-None-Match"))) {
+                res.status = 304;
                 return;
             }
-            // Belt-and-suspenders: reject if any path component is ".."
-            // (weakly_canonical should have resolved it, but this catches
-            // edge cases on exotic filesystems). Check components, not
-            // substrings, so legitimate filenames like "my..file.js" are allowed.
-            for (const auto& part : relative) {
-                if (part == "..") {
-                    res.status = 403;
-                    res.set_content("Forbidden", "text/plain");
-                    return;
-                }
-            }
 
-            // Serve the file
-            std::ifstream file(candidate, std::ios::binary);
-            if (!file.is_open()) {
-                res.status = 404;
-                res.set_content("File not found", "text/plain");
-                return;
+            if (!encoding.empty()) {
+                res.set_header("Content-Encoding", encoding);
             }
-
-            // Read file content
-            std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-            file.close();
-
-            // Determine content type based on extension
-            std::string content_type = "application/octet-stream";
-            size_t dot_pos = file_path.rfind('.');
-            if (dot_pos != std::string::npos) {
-                std::string ext = file_path.substr(dot_pos);
-                if (ext == ".js") content_type = "text/javascript";
-                else if (ext == ".css") content_type = "text/css";
-                else if (ext == ".html") content_type = "text/html";
-                else if (ext == ".woff") content_type = "font/woff";
-                else if (ext == ".woff2") content_type = "font/woff2";
-                else if (ext == ".ttf") content_type = "font/ttf";
-                else if (ext == ".svg") content_type = "image/svg+xml";
-                else if (ext == ".png") content_type = "image/png";
-                else if (ext == ".jpg" || ext == ".jpeg") content_type = "image/jpeg";
-                else if (ext == ".json") content_type = "application/json";
-                else if (ext == ".ico") content_type = "image/x-icon";
-            }
-
-            res.set_content(content, content_type);
+            // Stream straight from the snapshot: no per-request copy of the
+            // body, and httplib does not re-compress provider content.
+            res.set_content_provider(
+                body.size(), asset->content_type,
+                [snapshot, data = &body](size_t offset, size_t length, httplib::DataSink& sink) {
+                    return sink.write(data->data() + offset, length);
+                });
         };
 
         // Serve favicon from web-app directory at root
@@ -1431,6 +1463,8 @@ void Server::run() {
                         << "or hostname that resolves to RFC1918 IPv4." << std::endl;
         }
 
+        update_peer_forwarding();
+
         // Wait for listener threads, but check periodically for shutdown or rebind signals.
         // The threads are blocked in listen_after_bind(), which only returns when
         // the server is stopped or an error occurs.
@@ -1520,6 +1554,9 @@ void Server::stop() {
     if (running_) {
         LOG(INFO, "Server") << "Stopping HTTP server..." << std::endl;
         udp_beacon_.stopBroadcasting();
+        udp_beacon_.stopListening();
+        peer_cluster_->stop();
+        upscale_workers_->clear();
         stop_http_listeners();
         running_ = false;
         shutdown_requested_ = false;  // Reset for potential future use
@@ -1530,6 +1567,9 @@ void Server::stop() {
             websocket_server_->stop();
         }
 
+        // The sweep drives the router, so it has to finish first
+        cancel_autotune_job();
+
         // Explicitly clean up router (unload models, stop backend servers)
         if (router_) {
             LOG(INFO, "Server") << "Unloading models and stopping backend servers..." << std::endl;
@@ -1658,6 +1698,131 @@ nlohmann::json Server::create_model_error(const std::string& requested_model, co
     return error_response;
 }
 
+// Moves a request to its cloud fallback model when the local backend is
+// saturated or still loading (see Router::choose_spillover). Returns true if
+// the request's model was replaced.
+bool Server::apply_spillover(nlohmann::json& request_json) {
+    if (!request_json.contains("model") || !request_json["model"].is_string()) {
+        return false;
+    }
+    try {
+        const std::string fallback = router_->choose_spillover(request_json["model"].get<std::string>());
+        if (fallback.empty()) {
+            return false;
+        }
+        request_json["model"] = fallback;
+        return true;
+    } catch (const std::exception& e) {
+        // Spillover is best effort; the request is served locally
+        LOG(DEBUG, "Server") << "Spillover check failed: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+// Serves the request from another node of the cluster when the router picks
+// one. Returns true if `res` has been filled (or will be, when streaming).
+bool Server::forward_to_peer(const httplib::Request& req,
+                             httplib::Response& res,
+                             const nlohmann::json& request_json,
+                             const std::string& endpoint) {
+    // A forwarded request is served where it lands
+    if (req.has_header(PEER_FORWARDED_HEADER) ||
+        !request_json.contains("model") || !request_json["model"].is_string()) {
+        return false;
+    }
+    std::string peer_url;
+    try {
+        peer_url = router_->choose_peer(request_json["model"].get<std::string>());
+    } catch (const std::exception& e) {
+        LOG(DEBUG, "Server") << "Peer routing failed: " << e.what() << std::endl;
+        return false;
+    }
+    if (peer_url.empty()) {
+        return false;
+    }
+
+    const std::string url = peer_url + endpoint;
+    const std::string body = request_json.dump();
+    std::map<std::string, std::string> headers = {
+        {"Content-Type", "application/json"},
+        {PEER_FORWARDED_HEADER, peer_cluster_->node_id()}
+    };
+    if (req.has_header("Authorization")) {
+        headers["Authorization"] = req.get_header_value("Authorization");
+    }
+
+    const bool is_streaming = request_json.contains("stream") && request_json["stream"].is_boolean() &&
+                              request_json["stream"].get<bool>();
+    if (is_streaming) {
+        LOG(INFO, "Server") << "POST /api/v1/" << endpoint << " - Streaming from peer " << peer_url << std::endl;
+        res.set_header("Cache-Control", "no-cache");
+        res.set_header("Connection", "keep-alive");
+        res.set_header("X-Accel-Buffering", "no");
+        res.set_chunked_content_provider(
+            "text/event-stream",
+            [url, body, headers](size_t offset, httplib::DataSink& sink) {
+                if (offset > 0) {
+                    return false;
+                }
+                try {
+                    auto result = utils::HttpClient::post_stream(
+                        url, body,
+                        [&sink](const char* data, size_t length) { return sink.write(data, length); },
+                        headers, utils::HttpClient::get_default_timeout());
+                    if (result.status_code != 200) {
+                        LOG(ERROR, "Server") << "Peer " << url << " returned " << result.status_code << std::endl;
+                    }
+                } catch (const std::exception& e) {
+                    // Headers are already sent; report the failure in-band
+                    LOG(ERROR, "Server") << "Streaming from peer failed: " << e.what() << std::endl;
+                    const std::string event = "data: " + nlohmann::json({{"error", {
+                        {"message", std::string("Peer request failed: ") + e.what()},
+                        {"type", "server_error"}
+                    }}}).dump() + "\n\n";
+                    sink.write(event.data(), event.size());
+                }
+                sink.done();
+                return false;
+            });
+        return true;
+    }
+
+    try {
+        auto result = utils::HttpClient::post(url, body, headers, utils::HttpClient::get_default_timeout());
+        LOG(INFO, "Server") << "POST /api/v1/" << endpoint << " - " << result.status_code
+                            << " from peer " << peer_url << std::endl;
+        res.status = result.status_code;
+        res.set_content(result.body, "application/json");
+    } catch (const std::exception& e) {
+        LOG(ERROR, "Server") << "Forwarding to peer " << peer_url << " failed: " << e.what() << std::endl;
+        res.status = 502;
+        nlohmann::json error = {{"error", {
+            {"message", std::string("Peer request failed: ") + e.what()},
+            {"type", "server_error"}
+        }}};
+        res.set_content(error.dump(), "application/json");
+    }
+    return true;
+}
+
+void Server::update_peer_forwarding() {
+    udp_beacon_.stopListening();
+    peer_cluster_->stop();
+    if (!config_->peer_forwarding()) {
+        return;
+    }
+    // Beacon peers would be sent the API key and clients' prompts, so they are
+    // only used when the operator opts in
+    const bool discovery = config_->peer_discovery() && !config_->no_broadcast();
+    peer_cluster_->start(parse_peer_urls(config_->peers()), api_key_, discovery);
+    if (discovery) {
+        PeerCluster* cluster = peer_cluster_.get();
+        udp_beacon_.startListening(13305, [cluster](const std::string& payload) {
+            cluster->add_discovered(peer_url_from_beacon(payload));
+        });
+    }
+}
+
 // This function is called by:
 //   - handle_chat_completions() - /chat/completions endpoint
 //   - handle_completions() - /completions endpoint
@@ -1692,6 +1857,12 @@ void Server::auto_load_model_if_needed(const std::string& requested_model) {
         return;
     }
 
+    // Start pulling the weights into the page cache while the router waits
+    // for other loads, evicts and spawns the backend
+    if (info.downloaded) {
+        router_->prewarm_model(info);
+    }
+
     // Download model if not cached (first-time use)
     // IMPORTANT: Use do_not_upgrade=true to prevent checking HuggingFace for updates
     // This means:
@@ -1718,6 +1889,9 @@ void Server::auto_load_model_if_needed(const std::string& requested_model) {
 
 void Server::ensure_collection_loaded(const ModelInfo& info) {
     LOG(INFO, "Server") << "Loading collection components for: " << info.model_name << std::endl;
+    // Components are prepared concurrently so downloads and backend startups
+    // overlap; the router still admits one backend load at a time.
+    std::vector<std::future<void>> pending;
     for (const auto& component : info.components) {
         if (!model_manager_->model_exists(component)) {
             LOG(WARNING, "Server") << "Skipping unknown component: " << component << std::endl;
@@ -1727,20 +1901,42 @@ void Server::ensure_collection_loaded(const ModelInfo& info) {
             LOG(INFO, "Server") << "Component already loaded: " << component << std::endl;
             continue;
         }
-        auto comp_info = model_manager_->get_model_info(component);
-        if (!comp_info.downloaded) {
-            LOG(INFO, "Server") << "Downloading component: " << component << std::endl;
-            model_manager_->download_registered_model(comp_info);
-            comp_info = model_manager_->get_model_info(component);
+        pending.push_back(std::async(std::launch::async, [this, component]() {
+            auto comp_info = model_manager_->get_model_info(component);
+            if (!comp_info.downloaded) {
+                LOG(INFO, "Server") << "Downloading component: " << component << std::endl;
+                model_manager_->download_registered_model(comp_info);
+                comp_info = model_manager_->get_model_info(component);
+            }
+            LOG(INFO, "Server") << "Loading component: " << component << std::endl;
+            // Per the documented contract, per-model options like ctx_size or
+            // llamacpp_backend are NOT forwarded from the collection's load request
+            // to its components. Each component uses its own saved recipe_options.json
+            // entry.
+            router_->load_model(component, comp_info, comp_info.recipe_options, true,
+                                /*allow_reload_on_option_change=*/true);
+        }));
+    }
+    // Wait for every component before reporting the first failure.
+    std::exception_ptr first_error;
+    for (auto& f : pending) {
+        try {
+            f.get();
+        } catch (...) {
+            if (!first_error) first_error = std::current_exception();
         }
-        LOG(INFO, "Server") << "Loading component: " << component << std::endl;
-        // Per the documented contract, per-model options like ctx_size or
-        // llamacpp_backend are NOT forwarded from the collection's load request
-        // to its components. Each component uses its own saved recipe_options.json
-        // entry.
-        router_->load_model(component, comp_info, comp_info.recipe_options, true,
-                            /*allow_reload_on_option_change=*/true);
     }
+    if (first_error) {
+        std::rethrow_exception(first_error);
+    }
+}
+
+void Server::handle_peer_status(const httplib::Request& req, httplib::Response& res) {
+    (void)req;
+    nlohmann::json status = router_->get_peer_status();
+    status["node_id"] = peer_cluster_->node_id();
+    status["hostname"] = udp_beacon_.getLocalHostname();
+    res.set_content(status.dump(), "application/json");
 }
 
 void Server::handle_health(const httplib::Request& req, httplib::Response& res) {
@@ -1769,6 +1965,9 @@ void Server::handle_health(const httplib::Request& req, httplib::Response& res)
     // Add pinned model counts
     response["pinned_models"] = router_->get_pinned_model_counts();
 
+    // Cores handed out to CPU backends
+    response["cpu_placement"] = CpuPlacementPlanner::global().to_json();
+
     // Add WebSocket server port for realtime API and log streaming
     if (websocket_server_ && websocket_server_->is_running()) {
         response["websocket_port"] = websocket_server_->get_port();
@@ -2024,6 +2223,16 @@ void Server::handle_chat_completions(const httplib::Request& req, httplib::Respo
             }
         }
 
+        // Overflow goes to the model's cloud fallback before anything waits
+        // on the local backend
+        apply_spillover(request_json);
+
+        // A peer that has the model hot (or room this node lacks) takes it
+        // before anything is loaded or evicted here
+        if (forward_to_peer(req, res, request_json, "chat/completions")) {
+            return;
+        }
+
         // Handle model loading/switching
         if (request_json.contains("model")) {
             std::string requested_model = request_json["model"];
@@ -2109,6 +2318,8 @@ void Server::handle_chat_completions(const httplib::Request& req, httplib::Respo
             // Log the HTTP request
             LOG(INFO, "Server") << "POST /api/v1/chat/completions - 200 OK" << std::endl;
 
+            // Drop the backend request if the client hangs up mid-generation
+            utils::CancelScope cancel_on_disconnect([&req] { return req.is_connection_closed(); });
             auto response = router_->chat_completion(request_json);
 
             if (response.contains("error")) {
@@ -2230,6 +2441,12 @@ void Server::handle_completions(const httplib::Request& req, httplib::Response&
         // Must be done before any model_manager/router lookups and before forwarding
         normalize_client_model_name(request_json);
 
+        apply_spillover(request_json);
+
+        if (forward_to_peer(req, res, request_json, "completions")) {
+            return;
+        }
+
         // Handle model loading/switching (same logic as chat_completions)
         if (request_json.contains("model")) {
             std::string requested_model = request_json["model"];
@@ -2301,6 +2518,7 @@ void Server::handle_completions(const httplib::Request& req, httplib::Response&
             }
         } else {
             // Non-streaming
+            utils::CancelScope cancel_on_disconnect([&req] { return req.is_connection_closed(); });
             auto response = router_->completion(request_json);
 
             // Check if response contains an error
@@ -2595,8 +2813,9 @@ void Server::handle_tokenize(const httplib::Request& req, httplib::Response& res
             return;
         }
 
-        // Tokenization requires a model to be loaded
-        if (!router_->is_model_loaded()) {
+        // Tokenization requires a model to be loaded, unless one is named and
+        // its vocabulary can be read from the GGUF file
+        if (!request_body.contains("model") && !router_->is_model_loaded()) {
             LOG(ERROR, "Server") << "No model loaded for tokenization" << std::endl;
             res.status = 400;
             res.set_content("{\"error\": \"No model loaded for tokenization\"}", "application/json");
@@ -3240,9 +3459,10 @@ void Server::handle_image_upscale(const httplib::Request& req, httplib::Response
 
         // sd-server's HTTP API does not expose an upscaling endpoint.
         // Upscaling is only available via the sd-cli binary's -M upscale mode,
-        // so we shell out to sd-cli as a subprocess. This also keeps upscaling
-        // as a separate request from generation, which lets the frontend show
-        // the original and upscaled images side by side with independent timing.
+        // so it runs in sd-cli processes kept primed by upscale_workers_. This
+        // also keeps upscaling as a separate request from generation, which
+        // lets the frontend show the original and upscaled images side by side
+        // with independent timing.
         std::string exe_dir = lemon::backends::BackendUtils::get_backend_binary_path(
             lemon::backends::SDServer::SPEC, backend);
         std::filesystem::path cli_exe = std::filesystem::path(exe_dir).parent_path() /
@@ -3310,7 +3530,7 @@ void Server::handle_image_upscale(const httplib::Request& req, httplib::Response
 #endif
 
         std::string b64_image = request_json["image"].get<std::string>();
-        std::string upscaled = lemon::backends::SDServer::upscale_via_cli(
+        std::string upscaled = upscale_workers_->upscale(
             b64_image, upscale_model_path, cli_exe.string(), env_vars);
 
         if (upscaled.empty()) {
@@ -3352,6 +3572,12 @@ void Server::handle_responses(const httplib::Request& req, httplib::Response& re
     try {
         auto request_json = nlohmann::json::parse(req.body);
 
+        const bool spilled = apply_spillover(request_json);
+
+        if (forward_to_peer(req, res, request_json, "responses")) {
+            return;
+        }
+
         // Handle model loading/switching using helper function
         if (request_json.contains("model")) {
             std::string requested_model = request_json["model"];
@@ -3375,7 +3601,7 @@ void Server::handle_responses(const httplib::Request& req, httplib::Response& re
         // Check if streaming is requested
         bool is_streaming = request_json.contains("stream") && request_json["stream"].get<bool>();
 
-        std::string request_body = req.body;
+        std::string request_body = spilled ? request_json.dump() : req.body;
 
         if (is_streaming) {
             try {
@@ -3408,6 +3634,7 @@ void Server::handle_responses(const httplib::Request& req, httplib::Response& re
         } else {
             LOG(INFO, "Server") << "POST /api/v1/responses - Non-streaming" << std::endl;
 
+            utils::CancelScope cancel_on_disconnect([&req] { return req.is_connection_closed(); });
             auto response = router_->responses(request_json);
 
             if (response.contains("error")) {
@@ -3669,9 +3896,14 @@ void Server::handle_load(const httplib::Request& req, httplib::Response& res) {
         LOG(INFO, "Server") << " " << options.to_log_string(false);
         LOG(INFO, "Server") << std::endl;
 
-        // Persist request options to model info if requested
+        // Persist request options to model info if requested. Autotune
+        // results are measurements rather than settings, so they survive.
         if (save_options) {
+            json saved_tuning = info.recipe_options.to_json().value("llamacpp_tuning", json());
             info.recipe_options = options;
+            if (!saved_tuning.is_null() && !options.to_json().contains("llamacpp_tuning")) {
+                info.recipe_options.set_option("llamacpp_tuning", saved_tuning);
+            }
             model_manager_->save_model_options(info);
         }
 
@@ -3734,6 +3966,174 @@ void Server::handle_load(const httplib::Request& req, httplib::Response& res) {
     }
 }
 
+void Server::handle_autotune(const httplib::Request& req, httplib::Response& res) {
+    std::string model_name;
+
+    nlohmann::json request_json;
+    if (!parse_required_json_body(req, res, request_json)) return;
+
+    try {
+        model_name = request_json.value("model_name", "");
+        const bool save = request_json.value("save", true);
+
+        if (!model_manager_->model_exists(model_name)) {
+            res.status = 404;
+            res.set_content(create_model_error(model_name, "Model not found").dump(), "application/json");
+            return;
+        }
+
+        // The benchmarks need the memory and cores the loaded model holds
+        if (router_->is_model_loaded(model_name)) {
+            res.status = 409;
+            nlohmann::json error = {{"error", {
+                {"message", "Model " + model_name + " is loaded; unload it before running autotune"},
+                {"type", "invalid_request_error"},
+                {"code", "model_loaded"}}}};
+            res.set_content(error.dump(), "application/json");
+            return;
+        }
+
+        auto info = model_manager_->get_model_info(model_name);
+        if (info.recipe != "llamacpp") {
+            throw std::invalid_argument("Autotune supports llamacpp models only, not " + info.recipe);
+        }
+
+        auto job = std::make_shared<AutotuneJob>();
+        job->model_name = model_name;
+        job->save = save;
+        job->status = "running";
+
+        std::thread previous;
+        {
+            std::lock_guard<std::mutex> lock(autotune_mutex_);
+            // Two sweeps at once would measure each other
+            if (autotune_job_ && autotune_job_->status == "running") {
+                res.status = 409;
+                nlohmann::json error = {{"error", {
+                    {"message", "Autotune of " + autotune_job_->model_name + " is already running"},
+                    {"type", "invalid_request_error"},
+                    {"code", "autotune_running"}}}};
+                res.set_content(error.dump(), "application/json");
+                return;
+            }
+            previous = std::move(autotune_worker_);
+            autotune_job_ = job;
+            autotune_cancel_ = false;
+        }
+        // The previous worker has published its result and is about to exit
+        if (previous.joinable()) {
+            previous.join();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(autotune_mutex_);
+            if (autotune_cancel_) {
+                // The server started shutting down while we joined
+                job->status = "error";
+                job->error = "Server is shutting down";
+            } else {
+                autotune_worker_ = std::thread([this, job]() { run_autotune_job(job); });
+            }
+            res.status = 202;
+            res.set_content(autotune_job_to_json(*job).dump(), "application/json");
+        }
+    } catch (const std::invalid_argument& e) {
+        res.status = 400;
+        nlohmann::json error = {{"error", {
+            {"message", e.what()},
+            {"type", "invalid_request_error"},
+            {"code", "invalid_request"}}}};
+        res.set_content(error.dump(), "application/json");
+    } catch (const std::exception& e) {
+        LOG(ERROR, "Server") << "Autotune failed: " << e.what() << std::endl;
+        auto error_response = create_model_error(model_name, std::string("Autotune failed: ") + e.what());
+        res.status = get_http_status_from_error(error_response["error"]["code"].get<std::string>());
+        res.set_content(error_response.dump(), "application/json");
+    }
+}
+
+void Server::handle_autotune_status(const httplib::Request& req, httplib::Response& res) {
+    std::lock_guard<std::mutex> lock(autotune_mutex_);
+    if (!autotune_job_) {
+        res.status = 404;
+        nlohmann::json error = {{"error", {
+            {"message", "No autotune has run since the server started"},
+            {"type", "not_found"},
+            {"code", "autotune_not_found"}}}};
+        res.set_content(error.dump(), "application/json");
+        return;
+    }
+    res.set_content(autotune_job_to_json(*autotune_job_).dump(), "application/json");
+}
+
+nlohmann::json Server::autotune_job_to_json(const AutotuneJob& job) const {
+    nlohmann::json item = {
+        {"status", job.status},
+        {"model_name", job.model_name},
+        {"save", job.save}
+    };
+    if (job.status == "success") {
+        item["fingerprint"] = job.result["fingerprint"];
+        item["tuning"] = job.result["tuning"];
+        item["saved"] = job.save;
+    } else if (job.status == "error") {
+        item["error"] = job.error;
+    }
+    return item;
+}
+
+void Server::run_autotune_job(std::shared_ptr<AutotuneJob> job) {
+    const std::string& model_name = job->model_name;
+    try {
+        auto info = model_manager_->get_model_info(model_name);
+        if (!model_manager_->is_model_downloaded(model_name)) {
+            LOG(INFO, "Server") << "Model not downloaded, downloading..." << std::endl;
+            model_manager_->download_registered_model(info);
+            info = model_manager_->get_model_info(model_name);
+        }
+
+        LOG(INFO, "Server") << "Autotuning " << model_name << " (this takes a few minutes)" << std::endl;
+        nlohmann::json result = router_->autotune_model(info, [this]() { return autotune_cancel_.load(); });
+
+        if (job->save) {
+            // Re-read so options saved while the sweep ran are kept
+            info = model_manager_->get_model_info(model_name);
+            json tunings = info.recipe_options.to_json().value("llamacpp_tuning", json::object());
+            if (!tunings.is_object()) {
+                tunings = json::object();
+            }
+            tunings[result["fingerprint"].get<std::string>()] = result["tuning"];
+            info.recipe_options.set_option("llamacpp_tuning", tunings);
+            model_manager_->save_model_options(info);
+        }
+
+        LOG(INFO, "Server") << "Autotune of " << model_name << " finished" << std::endl;
+        std::lock_guard<std::mutex> lock(autotune_mutex_);
+        job->result = std::move(result);
+        job->status = "success";
+    } catch (const std::exception& e) {
+        LOG(ERROR, "Server") << "Autotune failed: " << e.what() << std::endl;
+        std::lock_guard<std::mutex> lock(autotune_mutex_);
+        job->error = e.what();
+        job->status = "error";
+    }
+}
+
+void Server::cancel_autotune_job() {
+    // The worker captures `this` and drives router_, so it must not outlive
+    // either. Cancelling kills the running bench; join outside the lock
+    // because the worker takes it to publish its result.
+    std::thread worker;
+    {
+        std::lock_guard<std::mutex> lock(autotune_mutex_);
+        autotune_cancel_ = true;
+        worker = std::move(autotune_worker_);
+    }
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
 void Server::handle_unload(const httplib::Request& req, httplib::Response& res) {
     try {
         LOG(INFO, "Server") << "Unload request received" << std::endl;
@@ -3758,6 +4158,7 @@ void Server::handle_unload(const httplib::Request& req, httplib::Response& res)
         router_->unload_model(model_name);  // Empty string = unload all
 
         if (model_name.empty()) {
+            upscale_workers_->clear();
             LOG(INFO, "Server") << "All models unloaded successfully" << std::endl;
             nlohmann::json response = {
                 {"status", "success"},
@@ -4279,13 +4680,20 @@ void Server::handle_metrics(const httplib::Request& req, httplib::Response& res)
     }
 
     try {
+        SystemMetricsSample sample = metrics_sampler_->latest();
         SystemMetrics system_metrics;
-        system_metrics.cpu_percent = get_cpu_usage();
-        system_metrics.gpu_percent = get_gpu_usage();
-        system_metrics.vram_gb = get_vram_usage();
-        system_metrics.npu_percent = get_npu_utilization();
-
-        res.set_content(build_prometheus_metrics(*router_, system_metrics),
+        system_metrics.cpu_percent = sample.cpu_percent;
+        system_metrics.memory_gb = sample.memory_gb;
+        system_metrics.gpu_percent = sample.gpu_percent;
+        system_metrics.vram_gb = sample.vram_gb;
+        system_metrics.npu_percent = sample.npu_percent;
+        system_metrics.backends = std::move(sample.backends);
+
+        const json realtime_transcription = websocket_server_
+            ? websocket_server_->get_realtime_transcription_stats()
+            : json::object();
+        res.set_content(build_prometheus_metrics(*router_, system_metrics, backend_metrics_.get(),
+                                                 realtime_transcription),
                         "text/plain; version=0.0.4; charset=utf-8");
     } catch (const std::exception& e) {
         LOG(ERROR, "Server") << "ERROR in handle_metrics: " << e.what() << std::endl;
@@ -4345,34 +4753,6 @@ void Server::handle_system_info(const httplib::Request& req, httplib::Response&
     res.set_content(system_info.dump(), "application/json");
 }
 
-// Get CPU usage percentage
-double Server::get_cpu_usage() {
-#if defined(__linux__) || defined(_WIN32)
-    return metrics_platform_->get_cpu_usage(cpu_stats_mutex_,
-                                            last_cpu_stats_.total,
-                                            last_cpu_stats_.total_idle);
-#else
-    uint64_t dummy_total = 0, dummy_idle = 0;
-    std::mutex dummy_mutex;
-    return metrics_platform_->get_cpu_usage(dummy_mutex, dummy_total, dummy_idle);
-#endif
-}
-
-// Get GPU usage percentage (AMD GPUs on Linux)
-double Server::get_gpu_usage() {
-    return metrics_platform_->get_gpu_usage();
-}
-
-// Get VRAM/GTT usage in GB (AMD GPUs on Linux)
-double Server::get_vram_usage() {
-    return metrics_platform_->get_vram_usage_gb();
-}
-
-// Helper: Get NPU utilization (AMD NPU on Linux)
-double Server::get_npu_utilization() {
-    return metrics_platform_->get_npu_utilization();
-}
-
 void Server::handle_system_stats(const httplib::Request& req, httplib::Response& res) {
     // For HEAD requests, just return 200 OK without processing
     if (req.method == "HEAD") {
@@ -4380,28 +4760,47 @@ void Server::handle_system_stats(const httplib::Request& req, httplib::Response&
         return;
     }
 
-    nlohmann::json stats;
-
-    // CPU usage
-    double cpu_percent = get_cpu_usage();
-    stats["cpu_percent"] = (cpu_percent >= 0) ? nlohmann::json(cpu_percent) : nlohmann::json();
-
-    // Get memory info
-    stats["memory_gb"] = metrics_platform_->get_memory_usage_gb();
+    // Latest background sample; no I/O on the request path
+    res.set_content(metrics_sampler_->latest().to_json().dump(), "application/json");
+}
 
-    // GPU usage
-    double gpu_percent = get_gpu_usage();
-    stats["gpu_percent"] = (gpu_percent >= 0) ? nlohmann::json(gpu_percent) : nlohmann::json();
+void Server::handle_system_stats_history(const httplib::Request& req, httplib::Response& res) {
+    if (req.method == "HEAD") {
+        res.status = 200;
+        return;
+    }
 
-    // VRAM usage
-    double vram_gb = get_vram_usage();
-    stats["vram_gb"] = (vram_gb >= 0) ? nlohmann::json(vram_gb) : nlohmann::json();
+    // `since` is an epoch-milliseconds cursor (the last timestamp_ms a client
+    // already has); `seconds` is a convenience window ending now.
+    int64_t since_ms = 0;
+    try {
+        if (req.has_param("since")) {
+            since_ms = std::stoll(req.get_param_value("since"));
+        } else if (req.has_param("seconds")) {
+            int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            since_ms = now_ms - std::stoll(req.get_param_value("seconds")) * 1000;
+        }
+    } catch (const std::exception&) {
+        res.status = 400;
+        res.set_content(nlohmann::json({{"error", {
+            {"message", "'since' and 'seconds' must be integers"},
+            {"type", "invalid_request_error"}
+        }}}).dump(), "application/json");
+        return;
+    }
 
-    // NPU Utilization
-    double npu_percent = get_npu_utilization();
-    stats["npu_percent"] = (npu_percent >= 0) ? nlohmann::json(npu_percent) : nlohmann::json();
+    nlohmann::json samples = nlohmann::json::array();
+    for (const auto& sample : metrics_sampler_->history(since_ms)) {
+        samples.push_back(sample.to_json());
+    }
 
-    res.set_content(stats.dump(), "application/json");
+    nlohmann::json body = {
+        {"interval_ms", metrics_sampler_->interval_ms()},
+        {"capacity", metrics_sampler_->capacity()},
+        {"samples", samples}
+    };
+    res.set_content(body.dump(), "application/json");
 }
 
 void Server::handle_log_level(const httplib::Request& req, httplib::Response& res) {
@@ -4660,6 +5059,11 @@ void Server::apply_config_side_effects(const json& applied_changes) {
                     udp_beacon_.startBroadcasting(13305, port_, 2);
                 }
             }
+            update_peer_forwarding();
+        } else if (key == "peer_forwarding" || key == "peers" || key == "peer_discovery") {
+            update_peer_forwarding();
+        } else if (key == "embedding_cache_mb" || key == "embedding_cache_disk_mb") {
+            router_->configure_embedding_cache();
         } else if (key == "extra_models_dir") {
             std::string dir = config_->extra_models_dir();
             LOG(INFO, "Server") << "Extra models dir changed to: " << dir << std::endl;
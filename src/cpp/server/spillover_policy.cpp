@@ -0,0 +1,51 @@
+#include "lemon/spillover_policy.h"
+
+namespace lemon {
+
+using json = nlohmann::json;
+
+SpilloverPolicy SpilloverPolicy::from_recipe_options(const json& recipe_opts) {
+    SpilloverPolicy policy;
+    if (recipe_opts.contains("cloud_fallback") && recipe_opts["cloud_fallback"].is_string()) {
+        policy.fallback_model = recipe_opts["cloud_fallback"].get<std::string>();
+    }
+    if (recipe_opts.contains("spill_queue_depth") && recipe_opts["spill_queue_depth"].is_number_integer()) {
+        policy.max_queue_depth = recipe_opts["spill_queue_depth"].get<int>();
+    }
+    if (recipe_opts.contains("spill_max_wait") && recipe_opts["spill_max_wait"].is_number()) {
+        policy.max_wait_seconds = recipe_opts["spill_max_wait"].get<double>();
+    }
+    if (recipe_opts.contains("spill_while_loading") && recipe_opts["spill_while_loading"].is_boolean()) {
+        policy.while_loading = recipe_opts["spill_while_loading"].get<bool>();
+    }
+    return policy;
+}
+
+const char* spill_reason_to_string(SpillReason reason) {
+    switch (reason) {
+        case SpillReason::QueueDepth: return "queue_depth";
+        case SpillReason::PredictedWait: return "predicted_wait";
+        case SpillReason::Loading: return "loading";
+        case SpillReason::None: break;
+    }
+    return "none";
+}
+
+SpillReason decide_spillover(const SpilloverPolicy& policy, const LocalModelLoad& load) {
+    if (!policy.enabled()) {
+        return SpillReason::None;
+    }
+    if (!load.loaded) {
+        return (load.loading && policy.while_loading) ? SpillReason::Loading : SpillReason::None;
+    }
+    if (policy.max_queue_depth > 0 && load.outstanding >= policy.max_queue_depth) {
+        return SpillReason::QueueDepth;
+    }
+    if (policy.max_wait_seconds > 0.0 && load.mean_request_seconds > 0.0 &&
+        load.outstanding * load.mean_request_seconds > policy.max_wait_seconds) {
+        return SpillReason::PredictedWait;
+    }
+    return SpillReason::None;
+}
+
+} // namespace lemon
@@ -0,0 +1,634 @@
+#include "lemon/sse_transcoder.h"
+#include <lemon/utils/aixlog.hpp>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <nlohmann/json.hpp>
+
+namespace lemon {
+
+namespace {
+
+constexpr size_t kMaxDepth = 64;
+
+bool is_json_string(std::string_view raw) {
+    return raw.size() >= 2 && raw.front() == '"';
+}
+
+// Forward-only reader over one JSON text. Values are either skipped or
+// handed back as raw slices; nothing is decoded or allocated.
+class JsonScanner {
+public:
+    explicit JsonScanner(std::string_view text)
+        : p_(text.data()), end_(text.data() + text.size()) {}
+
+    char peek() {
+        skip_ws();
+        return p_ < end_ ? *p_ : '\0';
+    }
+
+    bool at_end() {
+        skip_ws();
+        return p_ == end_;
+    }
+
+    bool value(std::string_view& raw) {
+        skip_ws();
+        const char* start = p_;
+        if (!skip(0)) {
+            return false;
+        }
+        raw = std::string_view(start, static_cast<size_t>(p_ - start));
+        return true;
+    }
+
+    bool skip_value() { return skip(0); }
+
+    // Calls on_member(key) for each member; it must consume the value. Keys
+    // are raw, i.e. quoted.
+    template <typename F>
+    bool object(F&& on_member) {
+        if (!consume('{')) {
+            return false;
+        }
+        if (consume('}')) {
+            return true;
+        }
+        do {
+            std::string_view key;
+            if (!string(key) || !consume(':') || !on_member(key)) {
+                return false;
+            }
+        } while (consume(','));
+        return consume('}');
+    }
+
+    // Calls on_element(i) for each element; it must consume the value
+    template <typename F>
+    bool array(F&& on_element) {
+        if (!consume('[')) {
+            return false;
+        }
+        if (consume(']')) {
+            return true;
+        }
+        size_t i = 0;
+        do {
+            if (!on_element(i++)) {
+                return false;
+            }
+        } while (consume(','));
+        return consume(']');
+    }
+
+private:
+    void skip_ws() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) {
+            ++p_;
+        }
+    }
+
+    bool consume(char c) {
+        skip_ws();
+        if (p_ < end_ && *p_ == c) {
+            ++p_;
+            return true;
+        }
+        return false;
+    }
+
+    bool string(std::string_view& raw) {
+        skip_ws();
+        if (p_ >= end_ || *p_ != '"') {
+            return false;
+        }
+        const char* start = p_++;
+        while (p_ < end_) {
+            const char c = *p_++;
+            if (c == '\\') {
+                if (p_ >= end_) {
+                    return false;
+                }
+                ++p_;
+            } else if (c == '"') {
+                raw = std::string_view(start, static_cast<size_t>(p_ - start));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool skip(size_t depth) {
+        if (depth > kMaxDepth) {
+            return false;
+        }
+        switch (peek()) {
+        case '"': {
+            std::string_view ignored;
+            return string(ignored);
+        }
+        case '{':
+            return object([&](std::string_view) { return skip(depth + 1); });
+        case '[':
+            return array([&](size_t) { return skip(depth + 1); });
+        default: {
+            // Number or literal
+            const char* start = p_;
+            while (p_ < end_ && (std::isalnum(static_cast<unsigned char>(*p_)) ||
+                                 *p_ == '-' || *p_ == '+' || *p_ == '.')) {
+                ++p_;
+            }
+            return p_ > start;
+        }
+        }
+    }
+
+    const char* p_;
+    const char* end_;
+};
+
+bool parse_long(std::string_view raw, long& out) {
+    long value = 0;
+    auto result = std::from_chars(raw.data(), raw.data() + raw.size(), value);
+    if (result.ec != std::errc() || result.ptr != raw.data() + raw.size()) {
+        return false;
+    }
+    out = value;
+    return true;
+}
+
+bool scan_tool_call(JsonScanner& s, OpenAIStreamDelta& out) {
+    if (s.peek() != '{') {
+        return s.skip_value();
+    }
+    OpenAIStreamDelta::ToolCall call;
+    const bool ok = s.object([&](std::string_view key) {
+        std::string_view raw;
+        if (key == "\"index\"") {
+            if (!s.value(raw)) {
+                return false;
+            }
+            parse_long(raw, call.index);
+            return true;
+        }
+        if (key == "\"id\"") {
+            return s.value(call.id);
+        }
+        if (key == "\"function\"" && s.peek() == '{') {
+            return s.object([&](std::string_view fn_key) {
+                if (fn_key == "\"name\"") {
+                    return s.value(call.name);
+                }
+                if (fn_key == "\"arguments\"") {
+                    return s.value(call.arguments);
+                }
+                return s.skip_value();
+            });
+        }
+        return s.skip_value();
+    });
+    out.tool_call_deltas.push_back(call);
+    return ok;
+}
+
+bool scan_delta(JsonScanner& s, OpenAIStreamDelta& out) {
+    if (s.peek() != '{') {
+        return s.skip_value();
+    }
+    out.has_delta = true;
+    return s.object([&](std::string_view key) {
+        if (key == "\"role\"") {
+            return s.value(out.role);
+        }
+        if (key == "\"content\"") {
+            return s.value(out.content);
+        }
+        if (key == "\"reasoning_content\"") {
+            return s.value(out.reasoning_content);
+        }
+        if (key == "\"tool_calls\"") {
+            if (s.peek() != '[') {
+                return s.value(out.tool_calls);
+            }
+            // Slice the array once, then walk the slice for its elements
+            if (!s.value(out.tool_calls)) {
+                return false;
+            }
+            JsonScanner calls(out.tool_calls);
+            return calls.array([&](size_t) { return scan_tool_call(calls, out); });
+        }
+        return s.skip_value();
+    });
+}
+
+bool scan_choice(JsonScanner& s, OpenAIStreamDelta& out) {
+    out.has_choice = true;
+    if (s.peek() != '{') {
+        return s.skip_value();
+    }
+    return s.object([&](std::string_view key) {
+        if (key == "\"delta\"") {
+            return scan_delta(s, out);
+        }
+        if (key == "\"text\"") {
+            return s.value(out.text);
+        }
+        if (key == "\"finish_reason\"") {
+            return s.value(out.finish_reason);
+        }
+        return s.skip_value();
+    });
+}
+
+std::string generate_message_id_json() {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+    return "\"msg_" + std::to_string(millis) + "\"";
+}
+
+constexpr std::string_view kCreatedAt = R"({"created_at":"2024-01-01T00:00:00Z","done":)";
+
+} // namespace
+
+// ============================================================================
+// SseLineFramer
+// ============================================================================
+
+void SseLineFramer::append(const char* data, size_t len) {
+    // Drop consumed lines once per append rather than once per line
+    if (read_ > 0) {
+        buffer_.erase(0, read_);
+        read_ = 0;
+    }
+    buffer_.append(data, len);
+}
+
+bool SseLineFramer::next_line(std::string_view& line) {
+    if (read_ >= buffer_.size()) {
+        return false;
+    }
+    const char* start = buffer_.data() + read_;
+    const void* newline = std::memchr(start, '\n', buffer_.size() - read_);
+    if (!newline) {
+        return false;
+    }
+    size_t len = static_cast<size_t>(static_cast<const char*>(newline) - start);
+    read_ += len + 1;
+    if (len > 0 && start[len - 1] == '\r') {
+        --len;
+    }
+    line = std::string_view(start, len);
+    return true;
+}
+
+// ============================================================================
+// Chunk scanning
+// ============================================================================
+
+void OpenAIStreamDelta::clear() {
+    id = {};
+    has_choice = false;
+    has_delta = false;
+    text = {};
+    finish_reason = {};
+    role = {};
+    content = {};
+    reasoning_content = {};
+    tool_calls = {};
+    tool_call_deltas.clear();
+    prompt_tokens = -1;
+    completion_tokens = -1;
+}
+
+bool scan_openai_stream_chunk(std::string_view chunk, OpenAIStreamDelta& out) {
+    out.clear();
+    JsonScanner s(chunk);
+    const bool ok = s.object([&](std::string_view key) {
+        if (key == "\"id\"") {
+            return s.value(out.id);
+        }
+        if (key == "\"choices\"") {
+            if (s.peek() != '[') {
+                return s.skip_value();
+            }
+            return s.array([&](size_t i) {
+                return i == 0 ? scan_choice(s, out) : s.skip_value();
+            });
+        }
+        if (key == "\"usage\"") {
+            if (s.peek() != '{') {
+                return s.skip_value();
+            }
+            return s.object([&](std::string_view usage_key) {
+                std::string_view raw;
+                if (!s.value(raw)) {
+                    return false;
+                }
+                if (usage_key == "\"prompt_tokens\"") {
+                    parse_long(raw, out.prompt_tokens);
+                } else if (usage_key == "\"completion_tokens\"") {
+                    parse_long(raw, out.completion_tokens);
+                }
+                return true;
+            });
+        }
+        return s.skip_value();
+    });
+    return ok && s.at_end();
+}
+
+// ============================================================================
+// SseTranscoder
+// ============================================================================
+
+SseTranscoder::SseTranscoder(Target target, const std::string& model,
+                             std::vector<std::string> warnings)
+    : target_(target),
+      model_json_(nlohmann::json(model).dump()),
+      warnings_(std::move(warnings)) {
+    out_.reserve(1024);
+}
+
+bool SseTranscoder::feed(const char* data, size_t len, const Writer& write) {
+    framer_.append(data, len);
+
+    std::string_view line;
+    while (framer_.next_line(line)) {
+        constexpr std::string_view kDataPrefix = "data: ";
+        if (line.compare(0, kDataPrefix.size(), kDataPrefix) != 0) {
+            continue;
+        }
+        const std::string_view payload = line.substr(kDataPrefix.size());
+        if (payload == "[DONE]") {
+            continue;
+        }
+        if (!scan_openai_stream_chunk(payload, chunk_)) {
+            LOG(ERROR, "SseTranscoder") << "Failed to parse SSE chunk: "
+                                        << std::string(payload.substr(0, 200)) << std::endl;
+            continue;
+        }
+        on_chunk(chunk_);
+    }
+    // The chunk's views point into the framer buffer
+    chunk_.clear();
+    return flush(write);
+}
+
+bool SseTranscoder::flush(const Writer& write) {
+    if (out_.empty()) {
+        return true;
+    }
+    const bool ok = write(out_.data(), out_.size());
+    out_.clear();
+    return ok;
+}
+
+void SseTranscoder::on_chunk(const OpenAIStreamDelta& chunk) {
+    if (chunk.prompt_tokens >= 0) {
+        prompt_tokens_ = chunk.prompt_tokens;
+    }
+    if (chunk.completion_tokens >= 0) {
+        completion_tokens_ = chunk.completion_tokens;
+    }
+
+    switch (target_) {
+    case Target::OllamaChat:
+        append_ollama_chat(chunk);
+        break;
+    case Target::OllamaGenerate:
+        append_ollama_generate(chunk);
+        break;
+    case Target::Anthropic:
+        append_anthropic(chunk);
+        break;
+    }
+}
+
+// Keys are written in the sorted order json::dump() used for these lines
+void SseTranscoder::append_ollama_chat(const OpenAIStreamDelta& chunk) {
+    const bool done = chunk.has_choice && !chunk.finish_reason.empty() && chunk.finish_reason != "null";
+    out_ += kCreatedAt;
+    out_ += done ? "true" : "false";
+    if (done) {
+        out_ += R"(,"done_reason":)";
+        out_ += chunk.finish_reason;
+    }
+    if (chunk.has_delta) {
+        out_ += R"(,"message":{"content":)";
+        out_ += is_json_string(chunk.content) ? chunk.content : std::string_view(R"("")");
+        out_ += R"(,"role":)";
+        out_ += is_json_string(chunk.role) ? chunk.role : std::string_view(R"("assistant")");
+        if (is_json_string(chunk.reasoning_content)) {
+            // Ollama reports reasoning as "thinking"
+            out_ += R"(,"thinking":)";
+            out_ += chunk.reasoning_content;
+        }
+        if (!chunk.tool_calls.empty()) {
+            out_ += R"(,"tool_calls":)";
+            out_ += chunk.tool_calls;
+        }
+        out_ += '}';
+    }
+    out_ += R"(,"model":)";
+    out_ += model_json_;
+    out_ += "}\n";
+}
+
+void SseTranscoder::append_ollama_generate(const OpenAIStreamDelta& chunk) {
+    const bool done = chunk.has_choice && !chunk.finish_reason.empty() && chunk.finish_reason != "null";
+    out_ += kCreatedAt;
+    out_ += done ? "true" : "false";
+    if (done) {
+        out_ += R"(,"done_reason":)";
+        out_ += chunk.finish_reason;
+    }
+    out_ += R"(,"model":)";
+    out_ += model_json_;
+    if (chunk.has_choice) {
+        out_ += R"(,"response":)";
+        if (!chunk.text.empty()) {
+            out_ += chunk.text;
+        } else if (!chunk.content.empty()) {
+            out_ += chunk.content;
+        } else {
+            out_ += R"("")";
+        }
+    }
+    out_ += "}\n";
+}
+
+void SseTranscoder::append_event(std::string_view event, std::string_view prefix,
+                                 std::string_view value, std::string_view suffix) {
+    out_ += "event: ";
+    out_ += event;
+    out_ += "\ndata: ";
+    out_ += prefix;
+    out_ += value;
+    out_ += suffix;
+    out_ += "\n\n";
+}
+
+void SseTranscoder::append_anthropic_message_start(std::string_view id) {
+    std::string generated;
+    if (id.empty()) {
+        generated = generate_message_id_json();
+        id = generated;
+    }
+    out_ += R"(event: message_start
+data: {"type":"message_start","message":{"id":)";
+    out_ += id;
+    out_ += R"(,"type":"message","role":"assistant","model":)";
+    out_ += model_json_;
+    out_ += R"(,"content":[],"stop_reason":null,"stop_sequence":null,"usage":{"input_tokens":0,"output_tokens":0}}})";
+    out_ += "\n\n";
+    sent_message_start_ = true;
+}
+
+void SseTranscoder::append_anthropic(const OpenAIStreamDelta& chunk) {
+    if (!sent_message_start_) {
+        append_anthropic_message_start(is_json_string(chunk.id) ? chunk.id : std::string_view());
+    }
+
+    if (!chunk.has_choice) {
+        return;
+    }
+
+    if (is_json_string(chunk.content) && chunk.content != R"("")") {
+        if (!sent_text_start_) {
+            append_event("content_block_start",
+                         R"({"type":"content_block_start","index":0,"content_block":{"type":"text","text":""}})",
+                         "", "");
+            sent_text_start_ = true;
+        }
+        append_event("content_block_delta",
+                     R"({"type":"content_block_delta","index":0,"delta":{"type":"text_delta","text":)",
+                     chunk.content, "}}");
+    }
+
+    for (const auto& call : chunk.tool_call_deltas) {
+        if (call.index < 0) {
+            continue;
+        }
+        const size_t idx = static_cast<size_t>(call.index);
+        if (started_tools_.size() <= idx) {
+            started_tools_.resize(idx + 1, false);
+            tool_ids_.resize(idx + 1);
+            tool_names_.resize(idx + 1);
+        }
+        if (is_json_string(call.id)) {
+            tool_ids_[idx] = std::string(call.id);
+        }
+        if (is_json_string(call.name)) {
+            tool_names_[idx] = std::string(call.name);
+        }
+
+        // Anthropic block 0 is the text block, so tool N is block N + 1
+        const std::string block_index = std::to_string(idx + 1);
+        if (!started_tools_[idx]) {
+            if (tool_ids_[idx].empty()) {
+                tool_ids_[idx] = generate_message_id_json();
+            }
+            if (tool_names_[idx].empty()) {
+                tool_names_[idx] = R"("unknown_tool")";
+            }
+            append_event("content_block_start",
+                         R"({"type":"content_block_start","index":)", block_index,
+                         R"(,"content_block":{"type":"tool_use","id":)" + tool_ids_[idx] +
+                             R"(,"name":)" + tool_names_[idx] + R"(,"input":{}}})");
+            started_tools_[idx] = true;
+        }
+
+        if (is_json_string(call.arguments) && call.arguments != R"("")") {
+            append_event("content_block_delta",
+                         R"({"type":"content_block_delta","index":)" + block_index +
+                             R"(,"delta":{"type":"input_json_delta","partial_json":)",
+                         call.arguments, "}}");
+        }
+    }
+
+    if (!chunk.finish_reason.empty() && chunk.finish_reason != "null") {
+        if (chunk.finish_reason == R"("length")") {
+            stop_reason_ = "max_tokens";
+        } else if (chunk.finish_reason == R"("tool_calls")") {
+            stop_reason_ = "tool_use";
+        } else {
+            stop_reason_ = "end_turn";
+        }
+    }
+}
+
+bool SseTranscoder::finish(const Writer& write) {
+    const std::string prompt = std::to_string(prompt_tokens_);
+    const std::string completion = std::to_string(completion_tokens_);
+
+    switch (target_) {
+    case Target::OllamaChat:
+        out_ += R"({"created_at":"2024-01-01T00:00:00Z","done":true,"done_reason":"stop","eval_count":)";
+        out_ += completion;
+        out_ += R"(,"eval_duration":0,"load_duration":0,"message":{"content":"","role":"assistant"},"model":)";
+        out_ += model_json_;
+        out_ += R"(,"prompt_eval_count":)";
+        out_ += prompt;
+        out_ += R"(,"prompt_eval_duration":0,"total_duration":0})";
+        out_ += "\n";
+        return flush(write);
+
+    case Target::OllamaGenerate:
+        out_ += R"({"context":[],"created_at":"2024-01-01T00:00:00Z","done":true,"done_reason":"stop","eval_count":)";
+        out_ += completion;
+        out_ += R"(,"eval_duration":0,"load_duration":0,"model":)";
+        out_ += model_json_;
+        out_ += R"(,"prompt_eval_count":)";
+        out_ += prompt;
+        out_ += R"(,"prompt_eval_duration":0,"response":"","total_duration":0})";
+        out_ += "\n";
+        return flush(write);
+
+    case Target::Anthropic:
+        break;
+    }
+
+    if (!sent_message_start_) {
+        append_anthropic_message_start({});
+    }
+
+    bool any_tool = false;
+    for (bool started : started_tools_) {
+        any_tool = any_tool || started;
+    }
+
+    if (!sent_text_start_ && !any_tool) {
+        append_event("content_block_start",
+                     R"({"type":"content_block_start","index":0,"content_block":{"type":"text","text":""}})",
+                     "", "");
+        sent_text_start_ = true;
+    }
+    if (sent_text_start_) {
+        append_event("content_block_stop", R"({"type":"content_block_stop","index":0})", "", "");
+    }
+    for (size_t idx = 0; idx < started_tools_.size(); ++idx) {
+        if (started_tools_[idx]) {
+            append_event("content_block_stop", R"({"type":"content_block_stop","index":)",
+                         std::to_string(idx + 1), "}");
+        }
+    }
+
+    if (stop_reason_ == "end_turn" && any_tool) {
+        stop_reason_ = "tool_use";
+    }
+
+    std::string message_delta = R"({"type":"message_delta","delta":{"stop_reason":")";
+    message_delta += stop_reason_;
+    message_delta += R"(","stop_sequence":null},"usage":{"input_tokens":)" + prompt +
+                     R"(,"output_tokens":)" + completion + "}";
+    if (!warnings_.empty()) {
+        message_delta += R"(,"warnings":)" + nlohmann::json(warnings_).dump();
+    }
+    message_delta += "}";
+    append_event("message_delta", message_delta, "", "");
+    append_event("message_stop", R"({"type":"message_stop"})", "", "");
+    return flush(write);
+}
+
+} // namespace lemon
@@ -0,0 +1,381 @@
+#include "lemon/static_asset_cache.h"
+#include "lemon/directory_watcher.h"
+#include "lemon/utils/aixlog.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <zstd.h>
+
+#ifdef HAVE_BROTLI_ENCODER
+#include <brotli/encode.h>
+#endif
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace lemon {
+
+namespace {
+
+// Bodies smaller than this gain nothing from compression once headers are
+// accounted for.
+constexpr size_t kMinCompressSize = 1024;
+
+bool is_compressible(const std::string& content_type) {
+    return content_type.rfind("text/", 0) == 0 ||
+           content_type == "application/json" ||
+           content_type == "image/svg+xml" ||
+           content_type == "font/ttf" ||
+           content_type == "image/x-icon";
+}
+
+// Compression levels. Builds run on a background thread, but the web app
+// bundle is a few MB and a rebuild follows every change in development, so
+// these sit where extra effort stops buying much size.
+constexpr int kZstdLevel = 9;
+constexpr int kBrotliQuality = 5;
+constexpr int kGzipLevel = 6;
+
+// Keep a compressed body only when it is meaningfully smaller.
+void keep_if_smaller(std::string& compressed, size_t identity_size) {
+    if (compressed.size() >= identity_size - identity_size / 10) {
+        compressed.clear();
+    }
+}
+
+std::string compress_zstd(const std::string& input) {
+    std::string out(ZSTD_compressBound(input.size()), '\0');
+    size_t n = ZSTD_compress(&out[0], out.size(), input.data(), input.size(), kZstdLevel);
+    if (ZSTD_isError(n)) {
+        return "";
+    }
+    out.resize(n);
+    return out;
+}
+
+std::string compress_brotli(const std::string& input) {
+#ifdef HAVE_BROTLI_ENCODER
+    size_t n = BrotliEncoderMaxCompressedSize(input.size());
+    if (n == 0) {
+        return "";
+    }
+    std::string out(n, '\0');
+    if (!BrotliEncoderCompress(kBrotliQuality, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT, input.size(),
+                               reinterpret_cast<const uint8_t*>(input.data()), &n,
+                               reinterpret_cast<uint8_t*>(&out[0]))) {
+        return "";
+    }
+    out.resize(n);
+    return out;
+#else
+    (void)input;
+    return "";
+#endif
+}
+
+std::string compress_gzip(const std::string& input) {
+#ifdef HAVE_ZLIB
+    z_stream zs{};
+    // windowBits 15 + 16 selects the gzip wrapper
+    if (deflateInit2(&zs, kGzipLevel, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return "";
+    }
+    std::string out(deflateBound(&zs, static_cast<uLong>(input.size())), '\0');
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    zs.avail_in = static_cast<uInt>(input.size());
+    zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    zs.avail_out = static_cast<uInt>(out.size());
+    int rc = deflate(&zs, Z_FINISH);
+    out.resize(zs.total_out);
+    deflateEnd(&zs);
+    return rc == Z_STREAM_END ? out : "";
+#else
+    (void)input;
+    return "";
+#endif
+}
+
+std::string content_hash_etag(const std::string& body) {
+    // FNV-1a 64 plus the length: not cryptographic, but an ETag only has to
+    // change when the content does.
+    uint64_t hash = 1469598103934665603ULL;
+    for (unsigned char c : body) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    char buf[48];
+    std::snprintf(buf, sizeof(buf), "\"%zx-%016llx\"", body.size(), static_cast<unsigned long long>(hash));
+    return buf;
+}
+
+// True when `coding` (or "*") is listed in Accept-Encoding without q=0.
+bool accepts(const std::string& accept_encoding, const std::string& coding) {
+    size_t start = 0;
+    while (start <= accept_encoding.size()) {
+        size_t end = accept_encoding.find(',', start);
+        if (end == std::string::npos) {
+            end = accept_encoding.size();
+        }
+        std::string item = accept_encoding.substr(start, end - start);
+        std::transform(item.begin(), item.end(), item.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        item.erase(std::remove_if(item.begin(), item.end(),
+                                  [](unsigned char c) { return std::isspace(c); }),
+                   item.end());
+        const size_t semi = item.find(';');
+        const std::string name = item.substr(0, semi);
+        if (name == coding || name == "*") {
+            const bool refused = semi != std::string::npos &&
+                (item.compare(semi, std::string::npos, ";q=0") == 0 ||
+                 item.compare(semi, std::string::npos, ";q=0.0") == 0 ||
+                 item.compare(semi, std::string::npos, ";q=0.00") == 0 ||
+                 item.compare(semi, std::string::npos, ";q=0.000") == 0);
+            return !refused;
+        }
+        start = end + 1;
+    }
+    return false;
+}
+
+} // namespace
+
+StaticAssetCache::StaticAssetCache(const std::string& root_dir) : root_dir_(root_dir) {
+    // Serve uncompressed right away; the builder adds the compressed bodies
+    table_ = load(false);
+    builder_ = std::thread([this]() { run_builder(); });
+
+    watcher_ = std::make_unique<DirectoryWatcher>(root_dir_);
+    watcher_->set_callback([this]() {
+        LOG(DEBUG, "Server") << "Web app directory changed, reloading static assets" << std::endl;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stale_ = true;
+        }
+        builder_cv_.notify_one();
+    });
+    watcher_->start();
+}
+
+StaticAssetCache::~StaticAssetCache() {
+    if (watcher_) {
+        watcher_->stop();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    builder_cv_.notify_one();
+    if (builder_.joinable()) {
+        builder_.join();
+    }
+}
+
+void StaticAssetCache::run_builder() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        builder_cv_.wait(lock, [this]() { return stale_ || stopping_; });
+        if (stopping_) {
+            return;
+        }
+        stale_ = false;
+        // Build outside the lock; readers keep using the current table
+        lock.unlock();
+        std::shared_ptr<const Table> fresh = load(true);
+        lock.lock();
+        table_ = std::move(fresh);
+    }
+}
+
+const StaticAssetCache::Asset* StaticAssetCache::find(const std::string& relative_path,
+                                                      std::shared_ptr<const Table>& holder) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        holder = table_;
+    }
+    if (!holder) {
+        return nullptr;
+    }
+
+    // Only files captured at load time can be served, so this lookup can
+    // never reach outside the root; normalising just maps "a/./b" to "a/b".
+    fs::path normalized = fs::path(relative_path).lexically_normal();
+    if (normalized.empty() || normalized.is_absolute() || *normalized.begin() == "..") {
+        return nullptr;
+    }
+    auto it = holder->find(normalized.generic_string());
+    return it == holder->end() ? nullptr : &it->second;
+}
+
+std::shared_ptr<const StaticAssetCache::Table> StaticAssetCache::load(bool compress) const {
+    auto table = std::make_shared<Table>();
+    std::error_code ec;
+    const fs::path base = fs::weakly_canonical(fs::path(root_dir_), ec);
+    if (ec || !fs::is_directory(base, ec)) {
+        return table;
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    size_t identity_bytes = 0;
+    size_t best_bytes = 0;
+    for (auto it = fs::recursive_directory_iterator(base, fs::directory_options::skip_permission_denied, ec);
+         !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        std::error_code file_ec;
+        if (!it->is_regular_file(file_ec)) {
+            continue;
+        }
+        // Symlinks pointing outside the web app directory are not served,
+        // matching the confinement check the per-request path used to do.
+        const fs::path target = fs::weakly_canonical(it->path(), file_ec);
+        const fs::path relative = file_ec ? fs::path() : fs::relative(target, base, file_ec);
+        if (file_ec || relative.empty() || *relative.begin() == "..") {
+            continue;
+        }
+        const std::string key = it->path().lexically_relative(base).generic_string();
+
+        std::ifstream file(target, std::ios::binary);
+        if (!file) {
+            continue;
+        }
+        Asset asset;
+        asset.identity.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        asset.content_type = content_type_for(key);
+        asset.etag = content_hash_etag(asset.identity);
+        asset.immutable = is_hashed_filename(key);
+
+        if (compress && asset.identity.size() >= kMinCompressSize && is_compressible(asset.content_type)) {
+            asset.zstd = compress_zstd(asset.identity);
+            asset.br = compress_brotli(asset.identity);
+            asset.gzip = compress_gzip(asset.identity);
+            keep_if_smaller(asset.zstd, asset.identity.size());
+            keep_if_smaller(asset.br, asset.identity.size());
+            keep_if_smaller(asset.gzip, asset.identity.size());
+        }
+
+        identity_bytes += asset.identity.size();
+        size_t best = asset.identity.size();
+        for (const std::string* body : {&asset.br, &asset.zstd, &asset.gzip}) {
+            if (!body->empty()) {
+                best = std::min(best, body->size());
+            }
+        }
+        best_bytes += best;
+        (*table)[key] = std::move(asset);
+    }
+
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started).count();
+    if (compress) {
+        LOG(INFO, "Server") << "Cached " << table->size() << " web app assets (" << identity_bytes
+                            << " bytes, " << best_bytes << " compressed) in " << elapsed_ms << " ms" << std::endl;
+    }
+    return table;
+}
+
+const std::string& StaticAssetCache::select_encoding(const Asset& asset, const std::string& accept_encoding,
+                                                     std::string& encoding) {
+    // Preference: brotli, then zstd, then gzip (smallest first for text).
+    if (!asset.br.empty() && accepts(accept_encoding, "br")) {
+        encoding = "br";
+        return asset.br;
+    }
+    if (!asset.zstd.empty() && accepts(accept_encoding, "zstd")) {
+        encoding = "zstd";
+        return asset.zstd;
+    }
+    if (!asset.gzip.empty() && accepts(accept_encoding, "gzip")) {
+        encoding = "gzip";
+        return asset.gzip;
+    }
+    encoding.clear();
+    return asset.identity;
+}
+
+std::string StaticAssetCache::etag_for(const Asset& asset, const std::string& encoding) {
+    if (encoding.empty()) {
+        return asset.etag;
+    }
+    std::string tag = asset.etag;
+    tag.insert(tag.size() - 1, "-" + encoding);
+    return tag;
+}
+
+bool StaticAssetCache::etag_matches(const Asset& asset, const std::string& if_none_match) {
+    size_t start = 0;
+    while (start < if_none_match.size()) {
+        size_t end = if_none_match.find(',', start);
+        if (end == std::string::npos) {
+            end = if_none_match.size();
+        }
+        std::string tag = if_none_match.substr(start, end - start);
+        tag.erase(0, tag.find_first_not_of(" \t"));
+        tag.erase(tag.find_last_not_of(" \t") + 1);
+        if (tag.rfind("W/", 0) == 0) {
+            tag.erase(0, 2);  // If-None-Match uses weak comparison
+        }
+        if (tag == "*") {
+            return true;
+        }
+        for (const char* encoding : {"", "br", "zstd", "gzip"}) {
+            if (tag == etag_for(asset, encoding)) {
+                return true;
+            }
+        }
+        start = end + 1;
+    }
+    return false;
+}
+
+bool StaticAssetCache::is_hashed_filename(const std::string& path) {
+    // webpack 5 hashes are hex digests cut to output.hashDigestLength
+    constexpr size_t kWebpackHashLength = 20;
+
+    std::string name = fs::path(path).filename().string();
+    const size_t ext = name.rfind('.');
+    if (ext == std::string::npos || ext == 0) {
+        return false;
+    }
+    name.erase(ext);
+
+    size_t start = 0;
+    while (start <= name.size()) {
+        size_t end = name.find('.', start);
+        if (end == std::string::npos) {
+            end = name.size();
+        }
+        if (end - start == kWebpackHashLength &&
+            std::all_of(name.begin() + start, name.begin() + end,
+                        [](unsigned char c) { return std::isdigit(c) || (c >= 'a' && c <= 'f'); })) {
+            return true;
+        }
+        start = end + 1;
+    }
+    return false;
+}
+
+std::string StaticAssetCache::content_type_for(const std::string& path) {
+    const size_t dot_pos = path.rfind('.');
+    if (dot_pos == std::string::npos) {
+        return "application/octet-stream";
+    }
+    const std::string ext = path.substr(dot_pos);
+    if (ext == ".js") return "text/javascript";
+    if (ext == ".css") return "text/css";
+    if (ext == ".html") return "text/html";
+    if (ext == ".woff") return "font/woff";
+    if (ext == ".woff2") return "font/woff2";
+    if (ext == ".ttf") return "font/ttf";
+    if (ext == ".svg") return "image/svg+xml";
+    if (ext == ".png") return "image/png";
+    if (ext == ".jpg" || ext == ".jpeg") return "image/jpeg";
+    if (ext == ".json") return "application/json";
+    if (ext == ".ico") return "image/x-icon";
+    if (ext == ".map") return "application/json";
+    return "application/octet-stream";
+}
+
+} // namespace lemon
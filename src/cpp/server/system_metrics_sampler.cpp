@@ -0,0 +1,174 @@
+#include "lemon/system_metrics_sampler.h"
+
+#include <algorithm>
+#include "lemon/utils/aixlog.hpp"
+
+namespace lemon {
+
+nlohmann::json SystemMetricsSample::to_json() const {
+    // Negative values mean unavailable; report them as null like /system-stats always has
+    auto value = [](double v) -> nlohmann::json {
+        return v >= 0 ? nlohmann::json(v) : nlohmann::json(nullptr);
+    };
+
+    nlohmann::json backend_list = nlohmann::json::array();
+    for (const auto& backend : backends) {
+        backend_list.push_back({
+            {"model_name", backend.model_name},
+            {"pid", backend.pid},
+            {"cpu_percent", value(backend.cpu_percent)},
+            {"rss_gb", value(backend.rss_gb)}
+        });
+    }
+
+    return {
+        {"timestamp_ms", timestamp_ms},
+        {"cpu_percent", value(cpu_percent)},
+        {"memory_gb", value(memory_gb)},
+        {"gpu_percent", value(gpu_percent)},
+        {"vram_gb", value(vram_gb)},
+        {"npu_percent", value(npu_percent)},
+        {"backends", backend_list}
+    };
+}
+
+SystemMetricsSampler::SystemMetricsSampler(std::unique_ptr<SystemMetricsPlatform> platform,
+                                           int interval_ms, size_t capacity)
+    : platform_(std::move(platform)),
+      interval_ms_(std::max(interval_ms, 50)),
+      capacity_(std::max<size_t>(capacity, 1)) {}
+
+SystemMetricsSampler::~SystemMetricsSampler() {
+    stop();
+}
+
+void SystemMetricsSampler::set_backend_provider(BackendProvider provider) {
+    std::lock_guard<std::mutex> lock(collect_mutex_);
+    backend_provider_ = std::move(provider);
+}
+
+void SystemMetricsSampler::start() {
+    {
+        std::lock_guard<std::mutex> lock(run_mutex_);
+        if (running_) {
+            return;
+        }
+        running_ = true;
+    }
+    sample_now();
+    thread_ = std::thread(&SystemMetricsSampler::sampling_loop, this);
+    LOG(DEBUG, "SystemMetrics") << "Sampling every " << interval_ms_ << " ms, keeping "
+                                << capacity_ << " samples" << std::endl;
+}
+
+void SystemMetricsSampler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(run_mutex_);
+        running_ = false;
+    }
+    run_cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void SystemMetricsSampler::sampling_loop() {
+    std::unique_lock<std::mutex> lock(run_mutex_);
+    auto next = std::chrono::steady_clock::now() + std::chrono::milliseconds(interval_ms_);
+    while (running_) {
+        if (run_cv_.wait_until(lock, next, [this] { return !running_; })) {
+            break;
+        }
+        lock.unlock();
+        sample_now();
+        lock.lock();
+
+        // Fixed cadence: schedule from the previous deadline, but never try to
+        // catch up on samples missed while the machine was suspended or stalled.
+        next += std::chrono::milliseconds(interval_ms_);
+        auto now = std::chrono::steady_clock::now();
+        if (next < now) {
+            next = now + std::chrono::milliseconds(interval_ms_);
+        }
+    }
+}
+
+void SystemMetricsSampler::sample_now() {
+    SystemMetricsSample sample = collect();
+
+    std::lock_guard<std::mutex> lock(samples_mutex_);
+    samples_.push_back(std::move(sample));
+    while (samples_.size() > capacity_) {
+        samples_.pop_front();
+    }
+}
+
+SystemMetricsSample SystemMetricsSampler::collect() {
+    std::lock_guard<std::mutex> lock(collect_mutex_);
+
+    SystemMetricsSample sample;
+    sample.timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    if (!platform_) {
+        return sample;
+    }
+
+    sample.cpu_percent = platform_->get_cpu_usage(cpu_state_mutex_, last_cpu_total_, last_cpu_idle_);
+    sample.memory_gb = platform_->get_memory_usage_gb();
+    sample.gpu_percent = platform_->get_gpu_usage();
+    sample.vram_gb = platform_->get_vram_usage_gb();
+    sample.npu_percent = platform_->get_npu_utilization();
+
+    if (!backend_provider_) {
+        return sample;
+    }
+
+    std::unordered_map<int, ProcessCpuState> current_cpu;
+    for (const auto& [model_name, pid] : backend_provider_()) {
+        BackendProcessSample backend;
+        backend.model_name = model_name;
+        backend.pid = pid;
+
+        ProcessUsage usage;
+        if (pid > 0 && platform_->get_process_usage(pid, usage)) {
+            auto now = std::chrono::steady_clock::now();
+            backend.rss_gb = static_cast<double>(usage.rss_bytes) / (1024.0 * 1024.0 * 1024.0);
+
+            auto prev = last_process_cpu_.find(pid);
+            if (prev != last_process_cpu_.end() && usage.cpu_time_ns >= prev->second.cpu_time_ns) {
+                auto wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    now - prev->second.taken).count();
+                if (wall_ns > 0) {
+                    backend.cpu_percent = 100.0 *
+                        static_cast<double>(usage.cpu_time_ns - prev->second.cpu_time_ns) /
+                        static_cast<double>(wall_ns);
+                }
+            }
+            current_cpu[pid] = ProcessCpuState{usage.cpu_time_ns, now};
+        }
+        sample.backends.push_back(std::move(backend));
+    }
+    // Exited backends drop out here, so a recycled PID starts from a fresh baseline
+    last_process_cpu_ = std::move(current_cpu);
+
+    return sample;
+}
+
+SystemMetricsSample SystemMetricsSampler::latest() const {
+    std::lock_guard<std::mutex> lock(samples_mutex_);
+    if (samples_.empty()) {
+        return SystemMetricsSample{};
+    }
+    return samples_.back();
+}
+
+std::vector<SystemMetricsSample> SystemMetricsSampler::history(int64_t since_ms) const {
+    std::lock_guard<std::mutex> lock(samples_mutex_);
+    auto first = std::find_if(samples_.begin(), samples_.end(), [since_ms](const SystemMetricsSample& s) {
+        return s.timestamp_ms > since_ms;
+    });
+    return std::vector<SystemMetricsSample>(first, samples_.end());
+}
+
+} // namespace lemon
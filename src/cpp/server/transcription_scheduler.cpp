@@ -0,0 +1,273 @@
+#include "lemon/transcription_scheduler.h"
+
+#include <algorithm>
+#include <lemon/utils/aixlog.hpp>
+
+namespace lemon {
+
+namespace {
+
+std::vector<double> transcription_seconds_buckets() {
+    return {0.05, 0.1, 0.25, 0.5, 1.0, 2.0, 4.0, 8.0, 15.0, 30.0};
+}
+
+const char* kind_name(TranscriptionScheduler::Kind kind) {
+    return kind == TranscriptionScheduler::Kind::Final ? "final" : "interim";
+}
+
+} // namespace
+
+TranscriptionScheduler::KindStats::KindStats()
+    : queue_wait_seconds(transcription_seconds_buckets()),
+      latency_seconds(transcription_seconds_buckets()) {}
+
+TranscriptionScheduler::TranscriptionScheduler(CapacityFn capacity, int workers)
+    : capacity_(std::move(capacity)) {
+    const int count = std::max(1, workers);
+    workers_.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        workers_.emplace_back([this] { worker_loop(); });
+    }
+}
+
+TranscriptionScheduler::~TranscriptionScheduler() {
+    shutdown();
+}
+
+bool TranscriptionScheduler::submit(const std::string& session_id, const std::string& model,
+                                    Kind kind, Job job) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+        return false;
+    }
+
+    auto [it, inserted] = queues_.try_emplace(session_id);
+    if (inserted) {
+        round_robin_.push_back(session_id);
+    }
+    SessionQueue& queue = it->second;
+    session_latency_.try_emplace(session_id);
+
+    // Whatever replaces or supersedes a queued interim covers its audio
+    if (queue.interim) {
+        queue.interim.reset();
+        interim_stats_.dropped_total++;
+    }
+
+    Pending pending{model, std::move(job), Clock::now()};
+    if (kind == Kind::Final) {
+        queue.finals.push_back(std::move(pending));
+    } else {
+        queue.interim = std::make_unique<Pending>(std::move(pending));
+    }
+    stats_for(kind).submitted_total++;
+    cv_.notify_one();
+    return true;
+}
+
+void TranscriptionScheduler::close_session(const std::string& session_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    session_latency_.erase(session_id);
+    auto it = queues_.find(session_id);
+    if (it == queues_.end()) {
+        return;
+    }
+    SessionQueue& queue = it->second;
+    final_stats_.dropped_total += queue.finals.size();
+    queue.finals.clear();
+    if (queue.interim) {
+        queue.interim.reset();
+        interim_stats_.dropped_total++;
+    }
+    // A running job removes the entry when it finishes
+    if (!queue.running) {
+        queues_.erase(it);
+        round_robin_.erase(std::remove(round_robin_.begin(), round_robin_.end(), session_id),
+                           round_robin_.end());
+    }
+}
+
+void TranscriptionScheduler::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ && workers_.empty()) {
+            return;
+        }
+        stopping_ = true;
+        for (auto it = queues_.begin(); it != queues_.end();) {
+            SessionQueue& queue = it->second;
+            if (queue.interim) {
+                queue.interim.reset();
+                interim_stats_.dropped_total++;
+            }
+            if (queue.finals.empty() && !queue.running) {
+                round_robin_.erase(std::remove(round_robin_.begin(), round_robin_.end(), it->first),
+                                   round_robin_.end());
+                it = queues_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+}
+
+bool TranscriptionScheduler::model_has_capacity(const std::string& model) const {
+    const int capacity = capacity_ ? std::max(1, capacity_(model)) : 1;
+    auto it = in_flight_.find(model);
+    return it == in_flight_.end() || it->second < capacity;
+}
+
+bool TranscriptionScheduler::take_next(std::string& session_id, Kind& kind, Pending& pending) {
+    for (Kind pass : {Kind::Final, Kind::Interim}) {
+        for (auto rr = round_robin_.begin(); rr != round_robin_.end(); ++rr) {
+            SessionQueue& queue = queues_[*rr];
+            if (queue.running) {
+                continue;
+            }
+            Pending* candidate = nullptr;
+            if (pass == Kind::Final && !queue.finals.empty()) {
+                candidate = &queue.finals.front();
+            } else if (pass == Kind::Interim && queue.interim) {
+                candidate = queue.interim.get();
+            }
+            if (!candidate || !model_has_capacity(candidate->model)) {
+                continue;
+            }
+
+            pending = std::move(*candidate);
+            if (pass == Kind::Final) {
+                queue.finals.pop_front();
+            } else {
+                queue.interim.reset();
+            }
+            queue.running = true;
+            in_flight_[pending.model]++;
+            kind = pass;
+            session_id = *rr;
+            // Served sessions go to the back of the line
+            round_robin_.erase(rr);
+            round_robin_.push_back(session_id);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranscriptionScheduler::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        std::string session_id;
+        Kind kind = Kind::Final;
+        Pending pending;
+        if (!take_next(session_id, kind, pending)) {
+            if (stopping_ && queues_.empty()) {
+                return;
+            }
+            cv_.wait(lock);
+            continue;
+        }
+
+        const Clock::time_point started = Clock::now();
+        stats_for(kind).queue_wait_seconds.observe(
+            std::chrono::duration<double>(started - pending.queued).count());
+
+        lock.unlock();
+        try {
+            pending.job();
+        } catch (const std::exception& e) {
+            LOG(ERROR, "TranscriptionScheduler") << kind_name(kind) << " transcription for "
+                                                 << session_id << " failed: " << e.what() << std::endl;
+        } catch (...) {
+            LOG(ERROR, "TranscriptionScheduler") << kind_name(kind) << " transcription for "
+                                                 << session_id << " failed" << std::endl;
+        }
+        lock.lock();
+
+        const double latency = std::chrono::duration<double>(Clock::now() - pending.queued).count();
+        KindStats& stats = stats_for(kind);
+        stats.latency_seconds.observe(latency);
+        stats.completed_total++;
+
+        auto latency_it = session_latency_.find(session_id);
+        if (latency_it != session_latency_.end()) {
+            SessionLatency& session = latency_it->second;
+            if (kind == Kind::Final) {
+                session.finals++;
+                session.final_seconds_sum += latency;
+                session.final_seconds_max = std::max(session.final_seconds_max, latency);
+                session.last_final_seconds = latency;
+            } else {
+                session.interims++;
+                session.interim_seconds_sum += latency;
+            }
+        }
+
+        if (--in_flight_[pending.model] <= 0) {
+            in_flight_.erase(pending.model);
+        }
+        auto queue_it = queues_.find(session_id);
+        if (queue_it != queues_.end()) {
+            SessionQueue& queue = queue_it->second;
+            queue.running = false;
+            if (queue.finals.empty() && !queue.interim) {
+                queues_.erase(queue_it);
+                round_robin_.erase(std::remove(round_robin_.begin(), round_robin_.end(), session_id),
+                                   round_robin_.end());
+            }
+        }
+        // A freed session or model slot may unblock jobs other workers skipped
+        cv_.notify_all();
+    }
+}
+
+json TranscriptionScheduler::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t queued_finals = 0;
+    uint64_t queued_interims = 0;
+    uint64_t running = 0;
+    for (const auto& [session_id, queue] : queues_) {
+        queued_finals += queue.finals.size();
+        queued_interims += queue.interim ? 1 : 0;
+        running += queue.running ? 1 : 0;
+    }
+
+    json result = {
+        {"workers", workers_.size()},
+        {"running", running},
+        {"queued", {{"final", queued_finals}, {"interim", queued_interims}}}
+    };
+    for (Kind kind : {Kind::Final, Kind::Interim}) {
+        const KindStats& stats = stats_for(kind);
+        result[kind_name(kind)] = {
+            {"submitted_total", stats.submitted_total},
+            {"completed_total", stats.completed_total},
+            {"dropped_total", stats.dropped_total},
+            {"queue_wait_seconds", stats.queue_wait_seconds.to_json()},
+            {"latency_seconds", stats.latency_seconds.to_json()}
+        };
+    }
+
+    json sessions = json::array();
+    for (const auto& [session_id, session] : session_latency_) {
+        sessions.push_back({
+            {"session_id", session_id},
+            {"finals", session.finals},
+            {"interims", session.interims},
+            {"final_latency_avg_seconds", session.finals ? session.final_seconds_sum / session.finals : 0.0},
+            {"final_latency_max_seconds", session.final_seconds_max},
+            {"final_latency_last_seconds", session.last_final_seconds},
+            {"interim_latency_avg_seconds", session.interims ? session.interim_seconds_sum / session.interims : 0.0}
+        });
+    }
+    result["sessions"] = sessions;
+    return result;
+}
+
+} // namespace lemon
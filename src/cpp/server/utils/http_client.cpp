@@ -13,6 +13,7 @@
 #include <cctype>
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <mbedtls/md.h>
 
@@ -25,6 +26,39 @@ std::atomic<long> HttpClient::default_timeout_seconds_{300};
 
 namespace {
 
+thread_local CancelScope* g_cancel_scope = nullptr;
+
+std::mutex g_unix_routes_mutex;
+std::map<std::string, std::string> g_unix_routes;  // authority -> socket path
+
+std::string url_authority(const std::string& url) {
+    const size_t scheme = url.find("://");
+    const size_t start = scheme == std::string::npos ? 0 : scheme + 3;
+    const size_t end = url.find_first_of("/?#", start);
+    return url.substr(start, end == std::string::npos ? std::string::npos : end - start);
+}
+
+// Points a request at its backend's Unix socket when it has one
+void apply_unix_socket(CURL* curl, const std::string& url) {
+    const std::string socket_path = HttpClient::unix_socket_for(url);
+    if (!socket_path.empty()) {
+        curl_easy_setopt(curl, CURLOPT_UNIX_SOCKET_PATH, socket_path.c_str());
+    }
+}
+
+// libcurl progress hook; a non-zero return aborts the transfer
+int cancel_xferinfo_callback(void*, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+    return CancelScope::requested() ? 1 : 0;
+}
+
+// Lets the thread's CancelScope abort a blocking request
+void apply_cancel_scope(CURL* curl) {
+    if (CancelScope::active()) {
+        curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, cancel_xferinfo_callback);
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    }
+}
+
 static std::string trim_copy(const std::string& value) {
     const auto first = value.find_first_not_of(" \t\r\n\"'");
     if (first == std::string::npos) {
@@ -235,6 +269,23 @@ static HashCheckResult verify_file_hash(const fs::path& path, const ExpectedHash
 
 } // namespace
 
+CancelScope::CancelScope(std::function<bool()> cancelled)
+    : cancelled_(std::move(cancelled)), previous_(g_cancel_scope) {
+    g_cancel_scope = this;
+}
+
+CancelScope::~CancelScope() {
+    g_cancel_scope = previous_;
+}
+
+bool CancelScope::active() {
+    return g_cancel_scope != nullptr;
+}
+
+bool CancelScope::requested() {
+    return g_cancel_scope && g_cancel_scope->cancelled_ && g_cancel_scope->cancelled_();
+}
+
 // Callback for writing response data to string
 static size_t write_callback(void* contents, size_t size, size_t nmemb, void* userp) {
     size_t total_size = size * nmemb;
@@ -244,8 +295,25 @@ static size_t write_callback(void* contents, size_t size, size_t nmemb, void* us
 }
 
 // Callback for writing to file
-static size_t write_file_callback(void* ptr, size_t size, size_t nmemb, void* stream) {
-    size_t written = fwrite(ptr, size, nmemb, static_cast<FILE*>(stream));
+struct FileWriteData {
+    CURL* curl = nullptr;
+    FILE* fp = nullptr;
+    DataCallback on_data;
+    uint64_t offset = 0;  // Position of the next byte in the output file
+};
+
+static size_t write_file_callback(void* ptr, size_t size, size_t nmemb, void* userp) {
+    auto* data = static_cast<FileWriteData*>(userp);
+    size_t written = fwrite(ptr, size, nmemb, data->fp);
+    if (data->on_data && written > 0) {
+        // Error pages are written to the file like before, but are not archive bytes
+        long http_code = 0;
+        curl_easy_getinfo(data->curl, CURLINFO_RESPONSE_CODE, &http_code);
+        if (http_code < 300) {
+            data->on_data(static_cast<const char*>(ptr), written * size, data->offset);
+        }
+    }
+    data->offset += written * size;
     return written;
 }
 
@@ -303,6 +371,7 @@ HttpResponse HttpClient::get(const std::string& url,
     std::string response_body;
 
     curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    apply_unix_socket(curl, url);
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_body);
     curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
@@ -353,6 +422,7 @@ HttpResponse HttpClient::post(const std::string& url,
     std::string response_body;
 
     curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    apply_unix_socket(curl, url);
     curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_body);
@@ -367,6 +437,7 @@ HttpResponse HttpClient::post(const std::string& url,
         header_list = curl_slist_append(header_list, header_str.c_str());
     }
     curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header_list);
+    apply_cancel_scope(curl);
 
     CURLcode res = curl_easy_perform(curl);
 
@@ -374,6 +445,9 @@ HttpResponse HttpClient::post(const std::string& url,
         std::string error = "CURL error: " + std::string(curl_easy_strerror(res));
         curl_slist_free_all(header_list);
         curl_easy_cleanup(curl);
+        if (res == CURLE_ABORTED_BY_CALLBACK) {
+            throw RequestCancelledError("request cancelled by caller");
+        }
         throw std::runtime_error(error);
     }
 
@@ -414,11 +488,13 @@ HttpResponse HttpClient::post_multipart(const std::string& url,
     }
 
     curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    apply_unix_socket(curl, url);
     curl_easy_setopt(curl, CURLOPT_MIMEPOST, mime);
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_body);
     curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout_seconds);
     curl_easy_setopt(curl, CURLOPT_USERAGENT, "lemon.cpp/1.0");
+    apply_cancel_scope(curl);
 
     CURLcode res = curl_easy_perform(curl);
 
@@ -426,6 +502,9 @@ HttpResponse HttpClient::post_multipart(const std::string& url,
         std::string error = "CURL error: " + std::string(curl_easy_strerror(res));
         curl_mime_free(mime);
         curl_easy_cleanup(curl);
+        if (res == CURLE_ABORTED_BY_CALLBACK) {
+            throw RequestCancelledError("request cancelled by caller");
+        }
         throw std::runtime_error(error);
     }
 
@@ -489,6 +568,7 @@ HttpResponse HttpClient::post_stream(const std::string& url,
     callback_data.buffer = nullptr;
 
     curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    apply_unix_socket(curl, url);
     curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, stream_write_callback);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &callback_data);
@@ -567,9 +647,15 @@ DownloadResult HttpClient::download_attempt(const std::string& url,
         return result;
     }
 
+    FileWriteData write_data;
+    write_data.curl = curl;
+    write_data.fp = fp;
+    write_data.on_data = options.on_data;
+    write_data.offset = resume_from;
+
     curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_file_callback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, fp);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &write_data);
     curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
     curl_easy_setopt(curl, CURLOPT_TIMEOUT, 0L);
     curl_easy_setopt(curl, CURLOPT_USERAGENT, "lemon.cpp/1.0");
@@ -995,6 +1081,24 @@ DownloadResult HttpClient::download_file(const std::string& url,
     return final_result;
 }
 
+void HttpClient::set_unix_socket_route(const std::string& authority, const std::string& socket_path) {
+    std::lock_guard<std::mutex> lock(g_unix_routes_mutex);
+    if (socket_path.empty()) {
+        g_unix_routes.erase(authority);
+    } else {
+        g_unix_routes[authority] = socket_path;
+    }
+}
+
+std::string HttpClient::unix_socket_for(const std::string& url) {
+    std::lock_guard<std::mutex> lock(g_unix_routes_mutex);
+    if (g_unix_routes.empty()) {
+        return "";
+    }
+    auto it = g_unix_routes.find(url_authority(url));
+    return it == g_unix_routes.end() ? "" : it->second;
+}
+
 bool HttpClient::is_reachable(const std::string& url, int timeout_seconds) {
     CURL* curl = curl_easy_init();
     if (!curl) {
@@ -1004,6 +1108,7 @@ bool HttpClient::is_reachable(const std::string& url, int timeout_seconds) {
     std::string response_body;
 
     curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    apply_unix_socket(curl, url);
     curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout_seconds);
     curl_easy_setopt(curl, CURLOPT_USERAGENT, "lemon.cpp/1.0");
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
@@ -26,7 +26,8 @@
     #define INVALID_SOCKET_NB -1
 #endif
 
-NetworkBeacon::NetworkBeacon() : _socket(INVALID_SOCKET_NB), _isInitialized(false), _netThreadRunning(false) {
+NetworkBeacon::NetworkBeacon() : _socket(INVALID_SOCKET_NB), _isInitialized(false), _netThreadRunning(false),
+                                 _listenSocket(INVALID_SOCKET_NB) {
 #ifdef _WIN32
     WSADATA wsaData;
     if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
@@ -38,6 +39,7 @@ NetworkBeacon::NetworkBeacon() : _socket(INVALID_SOCKET_NB), _isInitialized(fals
 
 NetworkBeacon::~NetworkBeacon() {
     stopBroadcasting();
+    stopListening();
     cleanup();
 }
 
@@ -296,3 +298,76 @@ void NetworkBeacon::broadcastThreadLoop() {
         std::this_thread::sleep_for(std::chrono::seconds(interval));
     }
 }
+
+void NetworkBeacon::startListening(int beaconPort, std::function<void(const std::string&)> onPayload) {
+    std::lock_guard<std::mutex> lock(_netMtx);
+
+    if (_listenThreadRunning) return;
+
+    _listenSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (_listenSocket == INVALID_SOCKET_NB) {
+        std::cerr << "[NetworkBeacon] Could not create listen socket" << std::endl;
+        return;
+    }
+
+    // Other listeners (the CLI's server discovery, other instances) share the port
+    int reuseAddr = 1;
+    setsockopt(_listenSocket, SOL_SOCKET, SO_REUSEADDR, (char*)&reuseAddr, sizeof(reuseAddr));
+
+    // Wake up regularly so stopListening() does not wait for a beacon
+#ifdef _WIN32
+    DWORD timeoutMs = 500;
+    setsockopt(_listenSocket, SOL_SOCKET, SO_RCVTIMEO, (char*)&timeoutMs, sizeof(timeoutMs));
+#else
+    struct timeval timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_usec = 500 * 1000;
+    setsockopt(_listenSocket, SOL_SOCKET, SO_RCVTIMEO, (char*)&timeout, sizeof(timeout));
+#endif
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(beaconPort);
+    if (bind(_listenSocket, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        std::cerr << "[NetworkBeacon] Could not bind beacon port " << beaconPort << std::endl;
+        closesocket(_listenSocket);
+        _listenSocket = INVALID_SOCKET_NB;
+        return;
+    }
+
+    _listenThreadRunning = true;
+    _listenThread = std::thread(&NetworkBeacon::listenThreadLoop, this, std::move(onPayload));
+}
+
+void NetworkBeacon::stopListening() {
+    {
+        std::lock_guard<std::mutex> lock(_netMtx);
+        if (!_listenThreadRunning) return;
+        _listenThreadRunning = false;
+    }
+
+    if (_listenThread.joinable()) {
+        _listenThread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(_netMtx);
+    if (_listenSocket != INVALID_SOCKET_NB) {
+        closesocket(_listenSocket);
+        _listenSocket = INVALID_SOCKET_NB;
+    }
+}
+
+void NetworkBeacon::listenThreadLoop(std::function<void(const std::string&)> onPayload) {
+    char buffer[2048];
+
+    while (_listenThreadRunning) {
+        sockaddr_in sender{};
+        socklen_t senderSize = sizeof(sender);
+        int received = recvfrom(_listenSocket, buffer, sizeof(buffer), 0, (sockaddr*)&sender, &senderSize);
+        if (received <= 0) {
+            continue; // Timeout; check whether to stop
+        }
+        onPayload(std::string(buffer, static_cast<size_t>(received)));
+    }
+}
@@ -8,6 +8,7 @@
 #include <sys/wait.h>
 #include <signal.h>
 #include <sys/socket.h>
+#include <sys/un.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <fcntl.h>
@@ -77,6 +78,8 @@ public:
         int timeout_seconds) override;
 
     int find_free_port(int start_port) override;
+    bool is_port_listening(int port) override;
+    bool is_unix_socket_listening(const std::string& path) override;
     int run_command(const std::string& command, std::string& output, int timeout_seconds) override;
 };
 
@@ -217,7 +220,7 @@ ProcessHandle MacOSProcessPlatform::spawn(
         close(stdout_pipe[1]);
         close(stderr_pipe[1]);
 
-        std::thread([fd = stdout_pipe[0]]() {
+        std::thread([fd = stdout_pipe[0], pid]() {
             char buffer[4096];
             std::string line_buffer;
             ssize_t bytes_read;
@@ -230,18 +233,20 @@ ProcessHandle MacOSProcessPlatform::spawn(
                 while ((pos = line_buffer.find('\n')) != std::string::npos) {
                     std::string line = line_buffer.substr(0, pos);
                     line_buffer = line_buffer.substr(pos + 1);
+                    ProcessManager::notify_output_line(pid, line);
                     log_process_line(line);
                 }
             }
 
             if (!line_buffer.empty()) {
+                ProcessManager::notify_output_line(pid, line_buffer);
                 log_process_line(line_buffer);
             }
 
             close(fd);
         }).detach();
 
-        std::thread([fd = stderr_pipe[0]]() {
+        std::thread([fd = stderr_pipe[0], pid]() {
             char buffer[4096];
             std::string line_buffer;
             ssize_t bytes_read;
@@ -254,11 +259,13 @@ ProcessHandle MacOSProcessPlatform::spawn(
                 while ((pos = line_buffer.find('\n')) != std::string::npos) {
                     std::string line = line_buffer.substr(0, pos);
                     line_buffer = line_buffer.substr(pos + 1);
+                    ProcessManager::notify_output_line(pid, line);
                     log_process_line(line);
                 }
             }
 
             if (!line_buffer.empty()) {
+                ProcessManager::notify_output_line(pid, line_buffer);
                 log_process_line(line_buffer);
             }
 
@@ -622,6 +629,42 @@ int MacOSProcessPlatform::find_free_port(int start_port) {
     return -1;
 }
 
+bool MacOSProcessPlatform::is_port_listening(int port) {
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) {
+        // Cannot tell; let the caller fall back to its HTTP probe
+        return true;
+    }
+
+    sockaddr_in addr;
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+    // Loopback connects complete or are refused immediately
+    int result = connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    close(sock);
+    return result == 0;
+}
+
+bool MacOSProcessPlatform::is_unix_socket_listening(const std::string& path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0) {
+        // Cannot tell; let the caller fall back to its HTTP probe
+        return true;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    int result = connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    close(sock);
+    return result == 0;
+}
+
 int MacOSProcessPlatform::run_command(const std::string& command, std::string& output, int timeout_seconds) {
     output.clear();
 
@@ -1,4 +1,5 @@
 #include <lemon/utils/process_platform.h>
+#include <lemon/utils/process_reactor.h>
 #include <lemon/utils/aixlog.hpp>
 
 #include <stdexcept>
@@ -9,6 +10,7 @@
 #include <sys/wait.h>
 #include <signal.h>
 #include <sys/socket.h>
+#include <sys/un.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <fcntl.h>
@@ -20,7 +22,10 @@
 #include <cctype>
 
 #ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sched.h>
 #include <sys/prctl.h>
+#include <sys/syscall.h>
 #endif
 
 #ifdef HAVE_LIBCAP
@@ -56,6 +61,46 @@ static void log_process_line(const std::string& line) {
     }
 }
 
+// Reads a backend output pipe line by line until EOF, handing every line to
+// the process's output observer and, if `log_output`, to the log. On Linux
+// every pipe is multiplexed on the shared ProcessReactor; a dedicated reader
+// thread is only used if the reactor cannot take the descriptor.
+static void watch_process_output(int fd, int pid, bool log_output) {
+    auto on_line = [pid, log_output](const std::string& line) {
+        ProcessManager::notify_output_line(pid, line);
+        if (log_output) {
+            log_process_line(line);
+        }
+    };
+    if (ProcessReactor::instance().watch_output(fd, on_line)) {
+        return;
+    }
+
+    std::thread([fd, on_line]() {
+        char buffer[4096];
+        std::string line_buffer;
+        ssize_t bytes_read;
+
+        while ((bytes_read = read(fd, buffer, sizeof(buffer) - 1)) > 0) {
+            buffer[bytes_read] = '\0';
+            line_buffer += buffer;
+
+            size_t pos;
+            while ((pos = line_buffer.find('\n')) != std::string::npos) {
+                std::string line = line_buffer.substr(0, pos);
+                line_buffer = line_buffer.substr(pos + 1);
+                on_line(line);
+            }
+        }
+
+        if (!line_buffer.empty()) {
+            on_line(line_buffer);
+        }
+
+        close(fd);
+    }).detach();
+}
+
 #ifdef HAVE_LIBCAP
 static void preserve_capabilities_for_exec() {
     cap_t caps = cap_get_proc();
@@ -92,6 +137,15 @@ public:
         bool filter_health_logs,
         const std::vector<std::pair<std::string, std::string>>& env_vars) override;
 
+    ProcessHandle spawn_placed(
+        const std::string& executable,
+        const std::vector<std::string>& args,
+        const std::string& working_dir,
+        bool inherit_output,
+        bool filter_health_logs,
+        const std::vector<std::pair<std::string, std::string>>& env_vars,
+        const CpuPlacement& placement) override;
+
     void terminate(ProcessHandle handle) override;
     bool is_running(ProcessHandle handle) override;
     int get_exit_code(ProcessHandle handle) override;
@@ -108,6 +162,8 @@ public:
         int timeout_seconds) override;
 
     int find_free_port(int start_port) override;
+    bool is_port_listening(int port) override;
+    bool is_unix_socket_listening(const std::string& path) override;
     int run_command(const std::string& command, std::string& output, int timeout_seconds) override;
 
 protected:
@@ -119,6 +175,7 @@ protected:
         bool inherit_output,
         bool filter_health_logs,
         const std::vector<std::pair<std::string, std::string>>& env_vars,
+        const CpuPlacement& placement,
         int stdout_pipe[2],
         int stderr_pipe[2]);
 };
@@ -131,9 +188,28 @@ pid_t UnixProcessPlatform::spawn_process(
     bool inherit_output,
     bool filter_health_logs,
     const std::vector<std::pair<std::string, std::string>>& env_vars,
+    const CpuPlacement& placement,
     int stdout_pipe[2],
     int stderr_pipe[2]) {
 
+#ifdef __linux__
+    // Masks are built before fork() so the child only makes the syscalls
+    cpu_set_t cpu_mask;
+    CPU_ZERO(&cpu_mask);
+    for (int cpu : placement.cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &cpu_mask);
+        }
+    }
+    constexpr int kMaxNumaNodes = 1024;
+    constexpr int kBitsPerWord = 8 * sizeof(unsigned long);
+    unsigned long node_mask[kMaxNumaNodes / kBitsPerWord] = {};
+    const bool bind_memory = placement.numa_node >= 0 && placement.numa_node < kMaxNumaNodes;
+    if (bind_memory) {
+        node_mask[placement.numa_node / kBitsPerWord] |= 1UL << (placement.numa_node % kBitsPerWord);
+    }
+#endif
+
     pid_t pid = fork();
 
     if (pid < 0) {
@@ -146,6 +222,17 @@ pid_t UnixProcessPlatform::spawn_process(
         prctl(PR_SET_PDEATHSIG, SIGTERM);
 #endif
 
+#ifdef __linux__
+        // Threads and allocations of the backend inherit both. Failures
+        // (e.g. CPUs outside this process's cpuset) leave it unconfined.
+        if (!placement.empty()) {
+            sched_setaffinity(0, sizeof(cpu_mask), &cpu_mask);
+        }
+        if (bind_memory) {
+            syscall(SYS_set_mempolicy, MPOL_PREFERRED, node_mask, kMaxNumaNodes);
+        }
+#endif
+
         if (!working_dir.empty()) {
             chdir(working_dir.c_str());
         }
@@ -155,8 +242,8 @@ pid_t UnixProcessPlatform::spawn_process(
             setenv(env_pair.first.c_str(), env_pair.second.c_str(), 1);
         }
 
-        // Redirect stdout/stderr to pipes if filtering
-        if (inherit_output && filter_health_logs) {
+        // Redirect stdout/stderr to pipes if capturing
+        if (stdout_pipe[0] >= 0) {
             close(stdout_pipe[0]);
             close(stderr_pipe[0]);
             dup2(stdout_pipe[1], STDOUT_FILENO);
@@ -201,6 +288,17 @@ ProcessHandle UnixProcessPlatform::spawn(
     bool inherit_output,
     bool filter_health_logs,
     const std::vector<std::pair<std::string, std::string>>& env_vars) {
+    return spawn_placed(executable, args, working_dir, inherit_output, filter_health_logs, env_vars, {});
+}
+
+ProcessHandle UnixProcessPlatform::spawn_placed(
+    const std::string& executable,
+    const std::vector<std::string>& args,
+    const std::string& working_dir,
+    bool inherit_output,
+    bool filter_health_logs,
+    const std::vector<std::pair<std::string, std::string>>& env_vars,
+    const CpuPlacement& placement) {
 
     ProcessHandle handle;
     handle.handle = nullptr;
@@ -209,8 +307,13 @@ ProcessHandle UnixProcessPlatform::spawn(
     int stdout_pipe[2] = {-1, -1};
     int stderr_pipe[2] = {-1, -1};
 
-    // Create pipes for filtering if requested
-    if (inherit_output && filter_health_logs) {
+    // Create pipes for filtering if requested. Backend servers (filter_health_logs)
+    // are captured even when their output is not logged, so readiness lines
+    // reach output observers; that costs nothing extra once the reactor
+    // multiplexes the pipes.
+    const bool capture_output = filter_health_logs &&
+        (inherit_output || ProcessReactor::instance().supports_pipes());
+    if (capture_output) {
         if (pipe(stdout_pipe) < 0 || pipe(stderr_pipe) < 0) {
             throw std::runtime_error("Failed to create pipes for output filtering");
         }
@@ -229,7 +332,7 @@ ProcessHandle UnixProcessPlatform::spawn(
     }
 
     pid_t pid = spawn_process(executable, args, working_dir, inherit_output,
-                              filter_health_logs, env_vars, stdout_pipe, stderr_pipe);
+                              filter_health_logs, env_vars, placement, stdout_pipe, stderr_pipe);
 
     handle.pid = pid;
 
@@ -238,57 +341,12 @@ ProcessHandle UnixProcessPlatform::spawn(
     }
 
     // Start filter threads if needed
-    if (inherit_output && filter_health_logs) {
+    if (capture_output) {
         close(stdout_pipe[1]);
         close(stderr_pipe[1]);
 
-        std::thread([fd = stdout_pipe[0]]() {
-            char buffer[4096];
-            std::string line_buffer;
-            ssize_t bytes_read;
-
-            while ((bytes_read = read(fd, buffer, sizeof(buffer) - 1)) > 0) {
-                buffer[bytes_read] = '\0';
-                line_buffer += buffer;
-
-                size_t pos;
-                while ((pos = line_buffer.find('\n')) != std::string::npos) {
-                    std::string line = line_buffer.substr(0, pos);
-                    line_buffer = line_buffer.substr(pos + 1);
-                    log_process_line(line);
-                }
-            }
-
-            if (!line_buffer.empty()) {
-                log_process_line(line_buffer);
-            }
-
-            close(fd);
-        }).detach();
-
-        std::thread([fd = stderr_pipe[0]]() {
-            char buffer[4096];
-            std::string line_buffer;
-            ssize_t bytes_read;
-
-            while ((bytes_read = read(fd, buffer, sizeof(buffer) - 1)) > 0) {
-                buffer[bytes_read] = '\0';
-                line_buffer += buffer;
-
-                size_t pos;
-                while ((pos = line_buffer.find('\n')) != std::string::npos) {
-                    std::string line = line_buffer.substr(0, pos);
-                    line_buffer = line_buffer.substr(pos + 1);
-                    log_process_line(line);
-                }
-            }
-
-            if (!line_buffer.empty()) {
-                log_process_line(line_buffer);
-            }
-
-            close(fd);
-        }).detach();
+        watch_process_output(stdout_pipe[0], pid, inherit_output);
+        watch_process_output(stderr_pipe[0], pid, inherit_output);
     }
 
     return handle;
@@ -658,6 +716,42 @@ int UnixProcessPlatform::find_free_port(int start_port) {
     return -1;
 }
 
+bool UnixProcessPlatform::is_port_listening(int port) {
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) {
+        // Cannot tell; let the caller fall back to its HTTP probe
+        return true;
+    }
+
+    sockaddr_in addr;
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+    // Loopback connects complete or are refused immediately
+    int result = connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    close(sock);
+    return result == 0;
+}
+
+bool UnixProcessPlatform::is_unix_socket_listening(const std::string& path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0) {
+        // Cannot tell; let the caller fall back to its HTTP probe
+        return true;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    int result = connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    close(sock);
+    return result == 0;
+}
+
 int UnixProcessPlatform::run_command(const std::string& command, std::string& output, int timeout_seconds) {
     output.clear();
 
@@ -656,6 +656,54 @@ public:
         return -1;
     }
 
+    bool is_unix_socket_listening(const std::string& path) override {
+        // Backends are always reached over TCP on Windows
+        (void)path;
+        return false;
+    }
+
+    bool is_port_listening(int port) override {
+        WSADATA wsa_data;
+        WSAStartup(MAKEWORD(2, 2), &wsa_data);
+
+        SOCKET sock = socket(AF_INET, SOCK_STREAM, 0);
+        if (sock == INVALID_SOCKET) {
+            WSACleanup();
+            // Cannot tell; let the caller fall back to its HTTP probe
+            return true;
+        }
+
+        // Windows retries refused connects for about a second, so connect
+        // non-blocking and only wait briefly for loopback to answer.
+        u_long non_blocking = 1;
+        ioctlsocket(sock, FIONBIO, &non_blocking);
+
+        sockaddr_in addr;
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+        bool listening = false;
+        if (connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+            listening = true;
+        } else if (WSAGetLastError() == WSAEWOULDBLOCK) {
+            fd_set write_set;
+            fd_set error_set;
+            FD_ZERO(&write_set);
+            FD_ZERO(&error_set);
+            FD_SET(sock, &write_set);
+            FD_SET(sock, &error_set);
+            timeval timeout{0, 50000};
+            if (select(0, nullptr, &write_set, &error_set, &timeout) > 0) {
+                listening = FD_ISSET(sock, &write_set) && !FD_ISSET(sock, &error_set);
+            }
+        }
+
+        closesocket(sock);
+        WSACleanup();
+        return listening;
+    }
+
     int run_command(const std::string& command, std::string& output, int timeout_seconds) override {
         output.clear();
 
@@ -1,18 +1,36 @@
 #include <lemon/utils/process_manager.h>
 #include <lemon/utils/process_platform.h>
 
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
 namespace lemon {
 namespace utils {
 
+namespace {
+
+std::mutex g_output_observers_mutex;
+std::unordered_map<int, OutputObserver> g_output_observers;
+// Lets notify_output_line() skip the lock while nobody is observing
+std::atomic<size_t> g_output_observer_count{0};
+
+} // namespace
+
 ProcessHandle ProcessManager::start_process(
     const std::string& executable,
     const std::vector<std::string>& args,
     const std::string& working_dir,
     bool inherit_output,
     bool filter_health_logs,
-    const std::vector<std::pair<std::string, std::string>>& env_vars) {
+    const std::vector<std::pair<std::string, std::string>>& env_vars,
+    const CpuPlacement& placement) {
 
     auto platform = create_process_platform();
+    if (!placement.empty()) {
+        return platform->spawn_placed(executable, args, working_dir, inherit_output, filter_health_logs,
+                                      env_vars, placement);
+    }
     return platform->spawn(executable, args, working_dir, inherit_output, filter_health_logs, env_vars);
 }
 
@@ -73,6 +91,44 @@ int ProcessManager::find_free_port(int start_port) {
     return platform->find_free_port(start_port);
 }
 
+bool ProcessManager::is_port_listening(int port) {
+    auto platform = create_process_platform();
+    return platform->is_port_listening(port);
+}
+
+bool ProcessManager::is_unix_socket_listening(const std::string& path) {
+    auto platform = create_process_platform();
+    return platform->is_unix_socket_listening(path);
+}
+
+void ProcessManager::set_output_observer(int pid, OutputObserver observer) {
+    std::lock_guard<std::mutex> lock(g_output_observers_mutex);
+    g_output_observers[pid] = std::move(observer);
+    g_output_observer_count.store(g_output_observers.size(), std::memory_order_release);
+}
+
+void ProcessManager::clear_output_observer(int pid) {
+    std::lock_guard<std::mutex> lock(g_output_observers_mutex);
+    g_output_observers.erase(pid);
+    g_output_observer_count.store(g_output_observers.size(), std::memory_order_release);
+}
+
+void ProcessManager::notify_output_line(int pid, const std::string& line) {
+    if (g_output_observer_count.load(std::memory_order_acquire) == 0) {
+        return;
+    }
+    OutputObserver observer;
+    {
+        std::lock_guard<std::mutex> lock(g_output_observers_mutex);
+        auto it = g_output_observers.find(pid);
+        if (it == g_output_observers.end()) {
+            return;
+        }
+        observer = it->second;
+    }
+    observer(line);
+}
+
 int ProcessManager::run_command(const std::string& command, std::string& output, int timeout_seconds) {
     auto platform = create_process_platform();
     return platform->run_command(command, output, timeout_seconds);
@@ -0,0 +1,556 @@
+#include <lemon/utils/process_reactor.h>
+#include <lemon/utils/aixlog.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434  // Same number on every architecture
+#endif
+#endif
+
+namespace lemon::utils {
+
+namespace {
+
+#ifdef __linux__
+int open_pidfd(int pid) {
+    return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+}
+#endif
+
+} // namespace
+
+ProcessReactor& ProcessReactor::instance() {
+    // Intentionally leaked: backends may still be torn down from static
+    // destructors, after a function-local static would already be gone.
+    static ProcessReactor* reactor = new ProcessReactor();
+    return *reactor;
+}
+
+ProcessReactor::ProcessReactor()
+    : wheel_(kWheelSlots),
+      last_tick_(std::chrono::steady_clock::now()) {
+#ifdef __linux__
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd_ >= 0 && wake_fd_ >= 0) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = wake_fd_;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event);
+    } else {
+        LOG(WARNING, "ProcessReactor") << "epoll unavailable (" << strerror(errno)
+                                       << "), falling back to polling" << std::endl;
+        if (epoll_fd_ >= 0) close(epoll_fd_);
+        if (wake_fd_ >= 0) close(wake_fd_);
+        epoll_fd_ = -1;
+        wake_fd_ = -1;
+    }
+#endif
+    reactor_thread_ = std::thread(&ProcessReactor::reactor_loop, this);
+}
+
+ProcessReactor::~ProcessReactor() {
+    stopping_.store(true);
+    wake();
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        workers.swap(workers_);
+    }
+    jobs_cv_.notify_all();
+    if (reactor_thread_.joinable()) {
+        reactor_thread_.join();
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+#ifdef __linux__
+    for (auto& [fd, watch] : outputs_) {
+        close(fd);
+    }
+    for (auto& [id, watch] : exits_) {
+        if (watch.pidfd >= 0) {
+            close(watch.pidfd);
+        }
+    }
+    if (epoll_fd_ >= 0) close(epoll_fd_);
+    if (wake_fd_ >= 0) close(wake_fd_);
+#endif
+}
+
+void ProcessReactor::wake() {
+#ifdef __linux__
+    if (wake_fd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t ignored = write(wake_fd_, &one, sizeof(one));
+        (void)ignored;
+        return;
+    }
+#endif
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wake_pending_ = true;
+    }
+    wake_cv_.notify_all();
+}
+
+bool ProcessReactor::watch_output(int fd, LineCallback on_line) {
+#ifdef __linux__
+    if (epoll_fd_ < 0) {
+        return false;
+    }
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    outputs_[fd] = OutputWatch{std::move(on_line), std::string()};
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP;
+    event.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+        outputs_.erase(fd);
+        return false;
+    }
+    return true;
+#else
+    (void)fd;
+    (void)on_line;
+    return false;
+#endif
+}
+
+ProcessReactor::Id ProcessReactor::watch_exit(int pid, std::function<bool()> is_running,
+                                              std::function<void()> on_exit) {
+    const Id id = next_id_++;
+    ExitWatch watch;
+    watch.pid = pid;
+    watch.is_running = std::move(is_running);
+    watch.on_exit = std::move(on_exit);
+
+#ifdef __linux__
+    if (epoll_fd_ >= 0 && pid > 0) {
+        watch.pidfd = open_pidfd(pid);
+        if (watch.pidfd >= 0) {
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = watch.pidfd;
+            if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, watch.pidfd, &event) != 0) {
+                close(watch.pidfd);
+                watch.pidfd = -1;
+            }
+        }
+    }
+#endif
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        live_.insert(id);
+        if (watch.pidfd >= 0) {
+            exits_by_pidfd_[watch.pidfd] = id;
+        } else {
+            if (polled_exits_++ == 0) {
+                next_exit_poll_ = std::chrono::steady_clock::now() + kExitPollInterval;
+            }
+        }
+        exits_[id] = std::move(watch);
+    }
+    wake();
+    return id;
+}
+
+ProcessReactor::Id ProcessReactor::add_timer(std::chrono::milliseconds delay,
+                                             std::function<void()> callback, bool periodic) {
+    const Id id = next_id_++;
+    const int64_t ticks = std::max<int64_t>(1, (delay.count() + kTick.count() - 1) / kTick.count());
+
+    Timer timer;
+    timer.callback = std::move(callback);
+    timer.interval_ticks = periodic ? ticks : 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        live_.insert(id);
+        schedule_locked(id, std::move(timer), ticks);
+    }
+    wake();
+    return id;
+}
+
+void ProcessReactor::schedule_locked(Id id, Timer timer, int64_t delay_ticks) {
+    // The wheel only advances when the reactor wakes, so count from the
+    // current time rather than from the last processed tick.
+    const auto now = std::chrono::steady_clock::now();
+    if (timer_slots_.empty()) {
+        last_tick_ = now;
+    }
+    delay_ticks += (now - last_tick_) / kTick;
+
+    const size_t slot = (current_slot_ + static_cast<size_t>(delay_ticks)) % kWheelSlots;
+    timer.rounds = (delay_ticks - 1) / static_cast<int64_t>(kWheelSlots);
+    wheel_[slot][id] = std::move(timer);
+    timer_slots_[id] = slot;
+}
+
+void ProcessReactor::remove_exit_locked(Id id) {
+    auto it = exits_.find(id);
+    if (it == exits_.end()) {
+        return;
+    }
+#ifdef __linux__
+    if (it->second.pidfd >= 0) {
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, it->second.pidfd, nullptr);
+        close(it->second.pidfd);
+        exits_by_pidfd_.erase(it->second.pidfd);
+    } else
+#endif
+    {
+        --polled_exits_;
+    }
+    exits_.erase(it);
+}
+
+void ProcessReactor::cancel(Id id) {
+    if (id == 0) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    live_.erase(id);
+
+    auto slot = timer_slots_.find(id);
+    if (slot != timer_slots_.end()) {
+        wheel_[slot->second].erase(id);
+        timer_slots_.erase(slot);
+    }
+    remove_exit_locked(id);
+
+    if (std::this_thread::get_id() != reactor_thread_id_) {
+        callback_done_cv_.wait(lock, [this, id] { return running_callback_ != id; });
+    }
+}
+
+void ProcessReactor::post(const void* owner, std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        if (stopping_.load()) {
+            return;
+        }
+        jobs_.push_back({owner, std::move(job)});
+        // One job per owner can start now; start a worker if the idle ones
+        // cannot take them all, e.g. because the rest are stuck on a hung
+        // backend
+        std::unordered_set<const void*> runnable;
+        for (const auto& queued : jobs_) {
+            if (!busy_owners_.count(queued.owner)) {
+                runnable.insert(queued.owner);
+            }
+        }
+        if (runnable.size() > idle_workers_ && workers_.size() < kMaxWorkers) {
+            workers_.emplace_back(&ProcessReactor::worker_loop, this);
+        }
+    }
+    jobs_cv_.notify_one();
+}
+
+int ProcessReactor::next_timeout_ms_locked() const {
+    using namespace std::chrono;
+    const auto now = steady_clock::now();
+    int64_t timeout_ms = -1;
+
+    // Sleep until the nearest timer is due instead of waking every tick
+    if (!timer_slots_.empty()) {
+        int64_t nearest_ticks = std::numeric_limits<int64_t>::max();
+        for (const auto& [id, slot] : timer_slots_) {
+            const Timer& timer = wheel_[slot].at(id);
+            int64_t distance = static_cast<int64_t>((slot + kWheelSlots - current_slot_) % kWheelSlots);
+            if (distance == 0) {
+                distance = static_cast<int64_t>(kWheelSlots);
+            }
+            nearest_ticks = std::min(nearest_ticks, distance + timer.rounds * static_cast<int64_t>(kWheelSlots));
+        }
+        const auto due = last_tick_ + kTick * nearest_ticks;
+        timeout_ms = std::max<int64_t>(0, duration_cast<milliseconds>(due - now).count() + 1);
+    }
+
+    if (polled_exits_ > 0) {
+        int64_t poll_ms = std::max<int64_t>(0, duration_cast<milliseconds>(next_exit_poll_ - now).count());
+        timeout_ms = timeout_ms < 0 ? poll_ms : std::min(timeout_ms, poll_ms);
+    }
+
+    return timeout_ms > std::numeric_limits<int>::max() ? std::numeric_limits<int>::max()
+                                                       : static_cast<int>(timeout_ms);
+}
+
+void ProcessReactor::collect_due_timers_locked(std::vector<Callback>& due) {
+    const auto now = std::chrono::steady_clock::now();
+    if (timer_slots_.empty()) {
+        return;  // schedule_locked() re-bases the empty wheel
+    }
+    while (now - last_tick_ >= kTick) {
+        last_tick_ += kTick;
+        current_slot_ = (current_slot_ + 1) % kWheelSlots;
+
+        auto& slot = wheel_[current_slot_];
+        std::vector<std::pair<Id, Timer>> fired;
+        for (auto it = slot.begin(); it != slot.end();) {
+            if (it->second.rounds > 0) {
+                --it->second.rounds;
+                ++it;
+                continue;
+            }
+            fired.emplace_back(it->first, std::move(it->second));
+            timer_slots_.erase(it->first);
+            it = slot.erase(it);
+        }
+
+        for (auto& [id, timer] : fired) {
+            const bool one_shot = timer.interval_ticks == 0;
+            due.push_back(Callback{id, timer.callback, one_shot});
+            if (!one_shot) {
+                const int64_t interval = timer.interval_ticks;
+                schedule_locked(id, std::move(timer), interval);
+            }
+        }
+    }
+}
+
+void ProcessReactor::poll_exits(std::vector<Callback>& due) {
+    std::vector<std::pair<Id, std::function<bool()>>> candidates;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto now = std::chrono::steady_clock::now();
+        if (polled_exits_ == 0 || now < next_exit_poll_) {
+            return;
+        }
+        next_exit_poll_ = now + kExitPollInterval;
+        for (const auto& [id, watch] : exits_) {
+            if (watch.pidfd < 0) {
+                candidates.emplace_back(id, watch.is_running);
+            }
+        }
+    }
+
+    // Liveness checks run without the lock; they are cheap but still syscalls
+    std::vector<Id> exited;
+    for (const auto& [id, is_running] : candidates) {
+        if (!is_running || !is_running()) {
+            exited.push_back(id);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Id id : exited) {
+        auto it = exits_.find(id);
+        if (it == exits_.end()) {
+            continue;
+        }
+        due.push_back(Callback{id, std::move(it->second.on_exit), true});
+        remove_exit_locked(id);
+    }
+}
+
+void ProcessReactor::run_callbacks(std::vector<Callback>& callbacks) {
+    for (auto& callback : callbacks) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!live_.count(callback.id)) {
+                continue;  // Cancelled after it became due
+            }
+            running_callback_ = callback.id;
+            if (callback.one_shot) {
+                live_.erase(callback.id);
+            }
+        }
+        try {
+            if (callback.fn) {
+                callback.fn();
+            }
+        } catch (const std::exception& e) {
+            LOG(ERROR, "ProcessReactor") << "Callback failed: " << e.what() << std::endl;
+        } catch (...) {
+            LOG(ERROR, "ProcessReactor") << "Callback failed" << std::endl;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            running_callback_ = 0;
+        }
+        callback_done_cv_.notify_all();
+    }
+    callbacks.clear();
+}
+
+void ProcessReactor::drain_output(int fd) {
+#ifdef __linux__
+    std::vector<std::string> lines;
+    LineCallback on_line;
+    bool closed = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = outputs_.find(fd);
+        if (it == outputs_.end()) {
+            return;
+        }
+        OutputWatch& watch = it->second;
+
+        // Bounded per wakeup so a chatty backend cannot starve the others;
+        // epoll is level-triggered and reports the rest on the next pass.
+        char buffer[4096];
+        for (int chunk = 0; chunk < 16; ++chunk) {
+            ssize_t n = read(fd, buffer, sizeof(buffer));
+            if (n > 0) {
+                watch.buffer.append(buffer, static_cast<size_t>(n));
+                continue;
+            }
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            // EAGAIN: drained for now. 0 or any other error: the writer is gone.
+            closed = !(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+            break;
+        }
+
+        size_t start = 0;
+        size_t pos;
+        while ((pos = watch.buffer.find('\n', start)) != std::string::npos) {
+            lines.emplace_back(watch.buffer, start, pos - start);
+            start = pos + 1;
+        }
+        watch.buffer.erase(0, start);
+
+        if (closed) {
+            if (!watch.buffer.empty()) {
+                lines.push_back(std::move(watch.buffer));
+            }
+            epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+            close(fd);
+        }
+        on_line = closed ? std::move(watch.on_line) : watch.on_line;
+        if (closed) {
+            outputs_.erase(it);
+        }
+    }
+
+    if (on_line) {
+        for (const auto& line : lines) {
+            on_line(line);
+        }
+    }
+#else
+    (void)fd;
+#endif
+}
+
+void ProcessReactor::reactor_loop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reactor_thread_id_ = std::this_thread::get_id();
+    }
+
+    std::vector<Callback> due;
+    while (!stopping_.load()) {
+        int timeout_ms;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            timeout_ms = next_timeout_ms_locked();
+        }
+
+#ifdef __linux__
+        if (epoll_fd_ >= 0) {
+            epoll_event events[64];
+            int count = epoll_wait(epoll_fd_, events, 64, timeout_ms);
+            if (count < 0 && errno != EINTR) {
+                LOG(ERROR, "ProcessReactor") << "epoll_wait failed: " << strerror(errno) << std::endl;
+                std::this_thread::sleep_for(kTick);
+            }
+            for (int i = 0; i < count; ++i) {
+                const int fd = events[i].data.fd;
+                if (fd == wake_fd_) {
+                    uint64_t value;
+                    while (read(wake_fd_, &value, sizeof(value)) > 0) {}
+                    continue;
+                }
+
+                bool is_exit = false;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    auto pidfd = exits_by_pidfd_.find(fd);
+                    if (pidfd != exits_by_pidfd_.end()) {
+                        is_exit = true;
+                        const Id id = pidfd->second;
+                        due.push_back(Callback{id, std::move(exits_[id].on_exit), true});
+                        remove_exit_locked(id);
+                    }
+                }
+                if (!is_exit) {
+                    drain_output(fd);
+                }
+            }
+        } else
+#endif
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            auto woken = [this] { return wake_pending_ || stopping_.load(); };
+            if (timeout_ms < 0) {
+                wake_cv_.wait(lock, woken);
+            } else {
+                wake_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), woken);
+            }
+            wake_pending_ = false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            collect_due_timers_locked(due);
+        }
+        poll_exits(due);
+        run_callbacks(due);
+    }
+}
+
+void ProcessReactor::worker_loop() {
+    std::unique_lock<std::mutex> lock(jobs_mutex_);
+    while (true) {
+        if (stopping_.load()) {
+            return;
+        }
+        // The oldest job whose owner is not already running one
+        auto next = std::find_if(jobs_.begin(), jobs_.end(),
+                                 [this](const Job& job) { return !busy_owners_.count(job.owner); });
+        if (next == jobs_.end()) {
+            ++idle_workers_;
+            jobs_cv_.wait(lock);
+            --idle_workers_;
+            continue;
+        }
+        Job job = std::move(*next);
+        jobs_.erase(next);
+        busy_owners_.insert(job.owner);
+        lock.unlock();
+
+        try {
+            job.fn();
+        } catch (const std::exception& e) {
+            LOG(ERROR, "ProcessReactor") << "Background job failed: " << e.what() << std::endl;
+        } catch (...) {
+            LOG(ERROR, "ProcessReactor") << "Background job failed" << std::endl;
+        }
+
+        lock.lock();
+        busy_owners_.erase(job.owner);
+        // The owner's next job may be waiting for this one
+        jobs_cv_.notify_all();
+    }
+}
+
+} // namespace lemon::utils
@@ -0,0 +1,995 @@
+#include "lemon/utils/stream_extractor.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_LZMA
+#include <lzma.h>
+#endif
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace lemon::utils {
+
+namespace {
+
+constexpr size_t OUTPUT_CHUNK = 256 * 1024;
+
+// Longest GNU long-name or pax record we accept
+constexpr uint64_t MAX_METADATA_BYTES = 1024 * 1024;
+
+bool ends_with(const std::string& value, const std::string& suffix) {
+    return value.size() >= suffix.size() &&
+           value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+uint16_t read_le16(const unsigned char* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t read_le32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint64_t read_le64(const unsigned char* p) {
+    return static_cast<uint64_t>(read_le32(p)) | (static_cast<uint64_t>(read_le32(p + 4)) << 32);
+}
+
+using Sink = std::function<bool(const char* data, size_t length)>;
+
+// Decompresses the outer stream of a tarball
+class Decoder {
+public:
+    virtual ~Decoder() = default;
+    virtual bool decode(const char* data, size_t length, const Sink& sink, std::string& error) = 0;
+    virtual bool ended() const = 0;
+};
+
+#ifdef HAVE_ZLIB
+class GzipDecoder : public Decoder {
+public:
+    GzipDecoder() : out_(OUTPUT_CHUNK) {
+        // 16 + MAX_WBITS: expect a gzip header and trailer
+        ok_ = inflateInit2(&stream_, 16 + MAX_WBITS) == Z_OK;
+    }
+    ~GzipDecoder() override {
+        if (ok_) {
+            inflateEnd(&stream_);
+        }
+    }
+
+    bool decode(const char* data, size_t length, const Sink& sink, std::string& error) override {
+        if (!ok_) {
+            error = "could not initialize zlib";
+            return false;
+        }
+        stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        stream_.avail_in = static_cast<uInt>(length);
+        do {
+            if (ended_) {
+                // Another gzip member follows
+                inflateReset(&stream_);
+                ended_ = false;
+            }
+            stream_.next_out = reinterpret_cast<Bytef*>(out_.data());
+            stream_.avail_out = static_cast<uInt>(out_.size());
+            const int rc = inflate(&stream_, Z_NO_FLUSH);
+            const size_t produced = out_.size() - stream_.avail_out;
+            if (produced > 0 && !sink(out_.data(), produced)) {
+                return false;
+            }
+            if (rc == Z_STREAM_END) {
+                ended_ = true;
+            } else if (rc == Z_BUF_ERROR) {
+                break;  // Needs more input
+            } else if (rc != Z_OK) {
+                error = std::string("gzip data error: ") + (stream_.msg ? stream_.msg : "corrupt stream");
+                return false;
+            }
+        } while (stream_.avail_in > 0 || stream_.avail_out == 0);
+        return true;
+    }
+
+    bool ended() const override { return ended_; }
+
+private:
+    z_stream stream_{};
+    bool ok_ = false;
+    bool ended_ = false;
+    std::vector<char> out_;
+};
+#endif
+
+#ifdef HAVE_LZMA
+class XzDecoder : public Decoder {
+public:
+    XzDecoder() : out_(OUTPUT_CHUNK) {
+        ok_ = lzma_stream_decoder(&stream_, UINT64_MAX, 0) == LZMA_OK;
+    }
+    ~XzDecoder() override {
+        lzma_end(&stream_);
+    }
+
+    bool decode(const char* data, size_t length, const Sink& sink, std::string& error) override {
+        if (!ok_) {
+            error = "could not initialize liblzma";
+            return false;
+        }
+        if (ended_) {
+            return true;  // Stream padding after the end
+        }
+        stream_.next_in = reinterpret_cast<const uint8_t*>(data);
+        stream_.avail_in = length;
+        do {
+            stream_.next_out = reinterpret_cast<uint8_t*>(out_.data());
+            stream_.avail_out = out_.size();
+            const lzma_ret rc = lzma_code(&stream_, LZMA_RUN);
+            const size_t produced = out_.size() - stream_.avail_out;
+            if (produced > 0 && !sink(out_.data(), produced)) {
+                return false;
+            }
+            if (rc == LZMA_STREAM_END) {
+                ended_ = true;
+                break;
+            }
+            if (rc == LZMA_BUF_ERROR) {
+                break;
+            }
+            if (rc != LZMA_OK) {
+                error = "xz data error (code " + std::to_string(static_cast<int>(rc)) + ")";
+                return false;
+            }
+        } while (stream_.avail_in > 0 || stream_.avail_out == 0);
+        return true;
+    }
+
+    bool ended() const override { return ended_; }
+
+private:
+    lzma_stream stream_ = LZMA_STREAM_INIT;
+    bool ok_ = false;
+    bool ended_ = false;
+    std::vector<char> out_;
+};
+#endif
+
+} // namespace
+
+// Shared by the tar and zip parsers: bookkeeping plus safe output below root
+struct StreamExtractor::Impl {
+    explicit Impl(fs::path dest) : root(std::move(dest)) {}
+    virtual ~Impl() = default;
+
+    // Raw archive bytes, in order
+    virtual bool consume(const char* data, size_t length) = 0;
+    // The archive's end marker has been seen
+    virtual bool complete() const = 0;
+
+    fs::path root;
+    std::string error;
+    uint64_t fed = 0;
+    uint64_t entry_count = 0;
+
+    std::ofstream file;
+    fs::path file_path;
+    uint32_t file_mode = 0;
+
+    bool fail(const std::string& message) {
+        if (error.empty()) {
+            error = message;
+        }
+        close_file();
+        return false;
+    }
+
+    // Maps an archive path to a path below root, dropping the first
+    // `strip` components. Returns false (after fail()) for paths that could
+    // escape root; leaves `out` empty for entries stripped away entirely.
+    bool resolve(const std::string& name, int strip, fs::path& out) {
+        out.clear();
+        std::vector<std::string> parts;
+        std::string part;
+        auto push = [&parts, &part]() {
+            if (!part.empty() && part != ".") {
+                parts.push_back(part);
+            }
+            part.clear();
+        };
+        for (char c : name) {
+            if (c == '/' || c == '\\') {
+                push();
+            } else {
+                part += c;
+            }
+        }
+        push();
+        for (const auto& p : parts) {
+            if (p == ".." || p.find(':') != std::string::npos) {
+                return fail("unsafe path in archive: " + name);
+            }
+        }
+        if (static_cast<int>(parts.size()) <= strip) {
+            return true;
+        }
+        fs::path path = root;
+        for (size_t i = static_cast<size_t>(strip); i < parts.size(); ++i) {
+            // A link planted by an earlier entry must not redirect later ones
+            std::error_code ec;
+            if (fs::is_symlink(path, ec) && path != root) {
+                return fail("archive writes through a symbolic link: " + name);
+            }
+            path /= fs::u8path(parts[i]);
+        }
+        out = path;
+        return true;
+    }
+
+    bool prepare_parent(const fs::path& path) {
+        std::error_code ec;
+        fs::create_directories(path.parent_path(), ec);
+        if (ec) {
+            return fail("could not create " + path.parent_path().u8string() + ": " + ec.message());
+        }
+        if (fs::is_symlink(path, ec)) {
+            fs::remove(path, ec);
+        }
+        return true;
+    }
+
+    bool open_file(const fs::path& path, uint32_t mode) {
+        if (!prepare_parent(path)) {
+            return false;
+        }
+        file.open(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return fail("could not create " + path.u8string());
+        }
+        file_path = path;
+        file_mode = mode;
+        ++entry_count;
+        return true;
+    }
+
+    bool write_file(const char* data, size_t length) {
+        if (!file.is_open()) {
+            return true;  // Entry is being skipped
+        }
+        file.write(data, static_cast<std::streamsize>(length));
+        if (!file) {
+            return fail("could not write " + file_path.u8string());
+        }
+        return true;
+    }
+
+    bool close_file() {
+        if (!file.is_open()) {
+            return true;
+        }
+        file.close();
+        const bool ok = !file.fail();
+        apply_mode(file_path, file_mode);
+        file.clear();
+        if (!ok && error.empty()) {
+            error = "could not write " + file_path.u8string();
+        }
+        return ok;
+    }
+
+    bool make_directory(const fs::path& path, uint32_t mode) {
+        std::error_code ec;
+        fs::create_directories(path, ec);
+        if (ec) {
+            return fail("could not create " + path.u8string() + ": " + ec.message());
+        }
+        apply_mode(path, mode);
+        ++entry_count;
+        return true;
+    }
+
+    bool make_symlink(const fs::path& path, const std::string& target) {
+        if (!prepare_parent(path)) {
+            return false;
+        }
+        std::error_code ec;
+        fs::remove(path, ec);
+        fs::create_symlink(fs::u8path(target), path, ec);
+        if (ec) {
+            return fail("could not link " + path.u8string() + ": " + ec.message());
+        }
+        ++entry_count;
+        return true;
+    }
+
+    bool make_hardlink(const fs::path& path, const fs::path& target) {
+        if (!prepare_parent(path)) {
+            return false;
+        }
+        std::error_code ec;
+        fs::remove(path, ec);
+        fs::create_hard_link(target, path, ec);
+        if (ec) {
+            // Filesystems without hard links get a copy
+            ec.clear();
+            fs::copy_file(target, path, fs::copy_options::overwrite_existing, ec);
+            if (ec) {
+                return fail("could not link " + path.u8string() + ": " + ec.message());
+            }
+        }
+        ++entry_count;
+        return true;
+    }
+
+    static void apply_mode(const fs::path& path, uint32_t mode) {
+#ifndef _WIN32
+        if ((mode & 0777) != 0) {
+            chmod(path.c_str(), static_cast<mode_t>(mode & 0777));
+        }
+#else
+        (void)path;
+        (void)mode;
+#endif
+    }
+};
+
+namespace {
+
+// ustar/GNU/pax tar reader over the decompressed stream
+class TarExtractor : public StreamExtractor::Impl {
+public:
+    TarExtractor(fs::path dest, std::unique_ptr<Decoder> decoder)
+        : Impl(std::move(dest)), decoder_(std::move(decoder)) {}
+
+    ~TarExtractor() override {
+        close_file();
+    }
+
+    bool consume(const char* data, size_t length) override {
+        if (done_ && decoder_->ended()) {
+            return true;  // Trailing padding after the archive
+        }
+        std::string decode_error;
+        if (!decoder_->decode(data, length,
+                              [this](const char* p, size_t n) { return tar_bytes(p, n); },
+                              decode_error)) {
+            return fail(decode_error.empty() ? error : decode_error);
+        }
+        return true;
+    }
+
+    bool complete() const override {
+        return decoder_->ended() && (done_ || (state_ == State::Header && header_fill_ == 0 && entry_count > 0));
+    }
+
+private:
+    enum class State { Header, Data, Metadata, Padding, Done };
+
+    bool tar_bytes(const char* data, size_t length) {
+        while (length > 0) {
+            switch (state_) {
+                case State::Header: {
+                    const size_t take = std::min(length, sizeof(header_) - header_fill_);
+                    std::memcpy(header_ + header_fill_, data, take);
+                    header_fill_ += take;
+                    data += take;
+                    length -= take;
+                    if (header_fill_ == sizeof(header_)) {
+                        header_fill_ = 0;
+                        if (!handle_header()) {
+                            return false;
+                        }
+                    }
+                    break;
+                }
+                case State::Data:
+                case State::Metadata: {
+                    const size_t take = static_cast<size_t>(std::min<uint64_t>(length, remaining_));
+                    if (state_ == State::Data) {
+                        if (!write_file(data, take)) {
+                            return false;
+                        }
+                    } else {
+                        metadata_.append(data, take);
+                    }
+                    data += take;
+                    length -= take;
+                    remaining_ -= take;
+                    if (remaining_ == 0 && !end_entry()) {
+                        return false;
+                    }
+                    break;
+                }
+                case State::Padding: {
+                    const size_t take = static_cast<size_t>(std::min<uint64_t>(length, padding_));
+                    data += take;
+                    length -= take;
+                    padding_ -= take;
+                    if (padding_ == 0) {
+                        state_ = State::Header;
+                    }
+                    break;
+                }
+                case State::Done:
+                    return true;
+            }
+        }
+        return true;
+    }
+
+    std::string field(size_t offset, size_t size) const {
+        const char* start = header_ + offset;
+        return std::string(start, strnlen(start, size));
+    }
+
+    uint64_t number(size_t offset, size_t size) const {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(header_ + offset);
+        uint64_t value = 0;
+        if (p[0] & 0x80) {
+            // GNU base-256 for values that do not fit in octal
+            for (size_t i = 1; i < size; ++i) {
+                value = (value << 8) | p[i];
+            }
+            return value;
+        }
+        for (size_t i = 0; i < size; ++i) {
+            if (p[i] >= '0' && p[i] <= '7') {
+                value = (value << 3) | static_cast<uint64_t>(p[i] - '0');
+            } else if (p[i] != ' ' || value != 0) {
+                break;
+            }
+        }
+        return value;
+    }
+
+    bool handle_header() {
+        if (std::all_of(header_, header_ + sizeof(header_), [](char c) { return c == 0; })) {
+            close_file();
+            state_ = State::Done;
+            done_ = true;
+            return true;
+        }
+
+        unsigned sum = 0;
+        for (size_t i = 0; i < sizeof(header_); ++i) {
+            sum += (i >= 148 && i < 156) ? ' ' : static_cast<unsigned char>(header_[i]);
+        }
+        if (sum != number(148, 8)) {
+            return fail("tar header checksum mismatch");
+        }
+
+        const char type = header_[156];
+        uint64_t size = number(124, 12);
+        if (pax_size_set_) {
+            size = pax_size_;
+        }
+        const uint32_t mode = static_cast<uint32_t>(number(100, 8));
+
+        std::string name = field(0, 100);
+        if (field(257, 5) == "ustar") {
+            const std::string prefix = field(345, 155);
+            if (!prefix.empty()) {
+                name = prefix + "/" + name;
+            }
+        }
+        std::string link = field(157, 100);
+        if (!pax_path_.empty()) name = pax_path_;
+        if (!long_name_.empty()) name = long_name_;
+        if (!pax_link_.empty()) link = pax_link_;
+        if (!long_link_.empty()) link = long_link_;
+
+        remaining_ = size;
+        padding_ = (512 - size % 512) % 512;
+        entry_type_ = type;
+
+        if (type == 'L' || type == 'K' || type == 'x' || type == 'g') {
+            if (size > MAX_METADATA_BYTES) {
+                return fail("oversized tar metadata record");
+            }
+            metadata_.clear();
+            state_ = State::Metadata;
+            return size > 0 ? true : end_entry();
+        }
+
+        long_name_.clear();
+        long_link_.clear();
+        pax_path_.clear();
+        pax_link_.clear();
+        pax_size_set_ = false;
+
+        fs::path path;
+        if (!resolve(name, 1, path)) {
+            return false;
+        }
+
+        switch (type) {
+            case '0':
+            case '\0':
+            case '7':
+                if (!path.empty() && !open_file(path, mode)) {
+                    return false;
+                }
+                break;
+            case '5':
+                if (!path.empty() && !make_directory(path, mode)) {
+                    return false;
+                }
+                break;
+            case '2':
+                if (!path.empty() && !make_symlink(path, link)) {
+                    return false;
+                }
+                break;
+            case '1': {
+                fs::path target;
+                if (!resolve(link, 1, target)) {
+                    return false;
+                }
+                if (!path.empty() && !target.empty() && !make_hardlink(path, target)) {
+                    return false;
+                }
+                break;
+            }
+            case 'S':
+                return fail("sparse tar entries are not supported");
+            default:
+                break;  // Devices and FIFOs: skip
+        }
+
+        state_ = State::Data;
+        return size > 0 ? true : end_entry();
+    }
+
+    bool end_entry() {
+        if (state_ == State::Metadata) {
+            const std::string value(metadata_.c_str());
+            if (entry_type_ == 'L') {
+                long_name_ = value;
+            } else if (entry_type_ == 'K') {
+                long_link_ = value;
+            } else if (entry_type_ == 'x') {
+                parse_pax(metadata_);
+            }
+        } else if (!close_file()) {
+            return fail(error);
+        }
+        state_ = padding_ > 0 ? State::Padding : State::Header;
+        return true;
+    }
+
+    // Records are "<length> <key>=<value>\n"
+    void parse_pax(const std::string& records) {
+        size_t pos = 0;
+        while (pos < records.size()) {
+            const size_t space = records.find(' ', pos);
+            if (space == std::string::npos) {
+                return;
+            }
+            const size_t record_length = static_cast<size_t>(std::strtoull(records.c_str() + pos, nullptr, 10));
+            if (record_length == 0 || pos + record_length > records.size()) {
+                return;
+            }
+            const std::string record = records.substr(space + 1, pos + record_length - space - 2);
+            const size_t eq = record.find('=');
+            if (eq != std::string::npos) {
+                const std::string key = record.substr(0, eq);
+                const std::string value = record.substr(eq + 1);
+                if (key == "path") {
+                    pax_path_ = value;
+                } else if (key == "linkpath") {
+                    pax_link_ = value;
+                } else if (key == "size") {
+                    pax_size_ = std::strtoull(value.c_str(), nullptr, 10);
+                    pax_size_set_ = true;
+                }
+            }
+            pos += record_length;
+        }
+    }
+
+    std::unique_ptr<Decoder> decoder_;
+    State state_ = State::Header;
+    bool done_ = false;
+    char header_[512] = {};
+    size_t header_fill_ = 0;
+    uint64_t remaining_ = 0;
+    uint64_t padding_ = 0;
+    char entry_type_ = 0;
+    std::string metadata_;
+    std::string long_name_;
+    std::string long_link_;
+    std::string pax_path_;
+    std::string pax_link_;
+    uint64_t pax_size_ = 0;
+    bool pax_size_set_ = false;
+};
+
+#ifdef HAVE_ZLIB
+// Reads zip entries from their local headers as they arrive; the central
+// directory at the end only supplies Unix permissions
+class ZipExtractor : public StreamExtractor::Impl {
+public:
+    explicit ZipExtractor(fs::path dest) : Impl(std::move(dest)), out_(OUTPUT_CHUNK) {
+        inflate_ok_ = inflateInit2(&inflate_, -MAX_WBITS) == Z_OK;
+    }
+
+    ~ZipExtractor() override {
+        close_file();
+        if (inflate_ok_) {
+            inflateEnd(&inflate_);
+        }
+    }
+
+    bool consume(const char* data, size_t length) override {
+        while (length > 0) {
+            switch (state_) {
+                case State::Signature:
+                    if (gather(data, length, 4)) {
+                        const uint32_t signature = read_le32(buf());
+                        buffer_.clear();
+                        if (signature == 0x04034b50) {
+                            state_ = State::LocalHeader;
+                        } else if (signature == 0x02014b50) {
+                            state_ = State::CentralHeader;
+                        } else if (signature == 0x06054b50 || signature == 0x06064b50 ||
+                                   signature == 0x07064b50) {
+                            state_ = State::Done;  // End of central directory
+                        } else {
+                            return fail("unexpected zip record");
+                        }
+                    }
+                    break;
+                case State::LocalHeader:
+                    if (gather(data, length, 26)) {
+                        const unsigned char* h = buf();
+                        flags_ = read_le16(h + 2);
+                        method_ = read_le16(h + 4);
+                        crc_expected_ = read_le32(h + 10);
+                        compressed_ = read_le32(h + 14);
+                        name_length_ = read_le16(h + 22);
+                        extra_length_ = read_le16(h + 24);
+                        buffer_.clear();
+                        state_ = State::LocalNames;
+                        if (name_length_ + extra_length_ == 0) {
+                            return fail("zip entry without a name");
+                        }
+                    }
+                    break;
+                case State::LocalNames:
+                    if (gather(data, length, name_length_ + extra_length_) && !begin_entry()) {
+                        return false;
+                    }
+                    break;
+                case State::Data:
+                    if (!entry_bytes(data, length)) {
+                        return false;
+                    }
+                    break;
+                case State::Descriptor:
+                    if (!descriptor_bytes(data, length)) {
+                        return false;
+                    }
+                    break;
+                case State::CentralHeader:
+                    if (gather(data, length, 42)) {
+                        const unsigned char* h = buf();
+                        made_by_ = read_le16(h);
+                        external_attributes_ = read_le32(h + 34);
+                        name_length_ = read_le16(h + 24);
+                        extra_length_ = read_le16(h + 26);
+                        comment_length_ = read_le16(h + 28);
+                        buffer_.clear();
+                        state_ = State::CentralNames;
+                    }
+                    break;
+                case State::CentralNames:
+                    if (gather(data, length, name_length_ + extra_length_ + comment_length_)) {
+                        apply_central_mode();
+                        buffer_.clear();
+                        state_ = State::Signature;
+                    }
+                    break;
+                case State::Done:
+                    return true;
+            }
+        }
+        return true;
+    }
+
+    bool complete() const override { return state_ == State::Done; }
+
+private:
+    enum class State { Signature, LocalHeader, LocalNames, Data, Descriptor, CentralHeader, CentralNames, Done };
+
+    const unsigned char* buf() const { return reinterpret_cast<const unsigned char*>(buffer_.data()); }
+
+    // Accumulates `want` bytes in buffer_; true once they are all there
+    bool gather(const char*& data, size_t& length, size_t want) {
+        const size_t take = std::min(length, want - buffer_.size());
+        buffer_.append(data, take);
+        data += take;
+        length -= take;
+        return buffer_.size() == want;
+    }
+
+    bool begin_entry() {
+        const std::string name = buffer_.substr(0, name_length_);
+        zip64_ = false;
+        // A zip64 extra field carries sizes that overflow the 32-bit fields
+        const unsigned char* extra = buf() + name_length_;
+        for (size_t pos = 0; pos + 4 <= extra_length_;) {
+            const uint16_t id = read_le16(extra + pos);
+            const uint16_t size = read_le16(extra + pos + 2);
+            if (id == 0x0001) {
+                zip64_ = true;
+                if (size >= 16 && pos + 4 + 16 <= extra_length_) {
+                    compressed_ = read_le64(extra + pos + 4 + 8);
+                }
+            }
+            pos += 4 + size;
+        }
+        buffer_.clear();
+
+        if (flags_ & 0x0001) {
+            return fail("encrypted zip entries are not supported");
+        }
+        if (method_ != 0 && method_ != 8) {
+            return fail("unsupported zip compression method " + std::to_string(method_));
+        }
+        has_descriptor_ = (flags_ & 0x0008) != 0;
+        if (has_descriptor_ && method_ == 0) {
+            return fail("stored zip entry without a size");
+        }
+
+        fs::path path;
+        if (!resolve(name, 0, path)) {
+            return false;
+        }
+        const bool is_directory = !name.empty() && (name.back() == '/' || name.back() == '\\');
+        if (!path.empty()) {
+            if (is_directory ? !make_directory(path, 0) : !open_file(path, 0)) {
+                return false;
+            }
+        }
+
+        crc_ = crc32(0L, Z_NULL, 0);
+        remaining_ = compressed_;
+        if (method_ == 8) {
+            inflateReset(&inflate_);
+        }
+        state_ = State::Data;
+        if (!has_descriptor_ && remaining_ == 0) {
+            return end_entry();
+        }
+        return true;
+    }
+
+    bool emit(const char* data, size_t length) {
+        crc_ = crc32(crc_, reinterpret_cast<const Bytef*>(data), static_cast<uInt>(length));
+        return write_file(data, length);
+    }
+
+    bool entry_bytes(const char*& data, size_t& length) {
+        size_t available = length;
+        if (!has_descriptor_) {
+            available = static_cast<size_t>(std::min<uint64_t>(available, remaining_));
+        }
+        if (method_ == 0) {
+            if (!emit(data, available)) {
+                return false;
+            }
+            data += available;
+            length -= available;
+            remaining_ -= available;
+            return remaining_ == 0 ? end_entry() : true;
+        }
+
+        if (!inflate_ok_) {
+            return fail("could not initialize zlib");
+        }
+        inflate_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        inflate_.avail_in = static_cast<uInt>(available);
+        int rc = Z_OK;
+        do {
+            inflate_.next_out = reinterpret_cast<Bytef*>(out_.data());
+            inflate_.avail_out = static_cast<uInt>(out_.size());
+            rc = inflate(&inflate_, Z_NO_FLUSH);
+            const size_t produced = out_.size() - inflate_.avail_out;
+            if (produced > 0 && !emit(out_.data(), produced)) {
+                return false;
+            }
+            if (rc != Z_OK && rc != Z_STREAM_END && rc != Z_BUF_ERROR) {
+                return fail(std::string("zip data error: ") + (inflate_.msg ? inflate_.msg : "corrupt entry"));
+            }
+        } while (rc == Z_OK && (inflate_.avail_in > 0 || inflate_.avail_out == 0));
+
+        const size_t used = available - inflate_.avail_in;
+        data += used;
+        length -= used;
+        if (!has_descriptor_) {
+            remaining_ -= used;
+        }
+        if (rc == Z_STREAM_END) {
+            if (!has_descriptor_ && remaining_ != 0) {
+                return fail("zip entry size mismatch");
+            }
+            return end_entry();
+        }
+        if (!has_descriptor_ && remaining_ == 0) {
+            return fail("truncated zip entry");
+        }
+        return true;
+    }
+
+    bool descriptor_bytes(const char*& data, size_t& length) {
+        // Optional signature, then CRC-32 and the two sizes (8 bytes each
+        // for zip64 entries)
+        const size_t sizes = zip64_ ? 16 : 8;
+        if (buffer_.size() < 4 && !gather(data, length, 4)) {
+            return true;
+        }
+        const bool signed_descriptor = read_le32(buf()) == 0x08074b50;
+        const size_t want = (signed_descriptor ? 8 : 4) + sizes;
+        if (!gather(data, length, want)) {
+            return true;
+        }
+        crc_expected_ = read_le32(buf() + (signed_descriptor ? 4 : 0));
+        buffer_.clear();
+        return check_crc();
+    }
+
+    bool end_entry() {
+        if (!close_file()) {
+            return fail(error);
+        }
+        if (has_descriptor_) {
+            buffer_.clear();
+            state_ = State::Descriptor;
+            return true;
+        }
+        return check_crc();
+    }
+
+    bool check_crc() {
+        if (crc_ != crc_expected_) {
+            return fail("zip entry CRC mismatch");
+        }
+        state_ = State::Signature;
+        return true;
+    }
+
+    void apply_central_mode() {
+        // Only archives made on Unix carry a mode in the high 16 bits
+        if ((made_by_ >> 8) != 3) {
+            return;
+        }
+        const uint32_t mode = external_attributes_ >> 16;
+        if ((mode & 0777) == 0) {
+            return;
+        }
+        fs::path path;
+        if (!resolve(buffer_.substr(0, name_length_), 0, path) || path.empty()) {
+            return;
+        }
+        std::error_code ec;
+        if ((mode & 0170000) == 0120000 && fs::is_regular_file(path, ec)) {
+            // Symlinks are stored as a file holding the target; nothing is
+            // written after the central directory, so the link is safe here
+            std::ifstream in(path, std::ios::binary);
+            const std::string target((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            in.close();
+            fs::remove(path, ec);
+            fs::create_symlink(fs::u8path(target), path, ec);
+            if (ec) {
+                fail("could not link " + path.u8string() + ": " + ec.message());
+            }
+        } else if (fs::is_regular_file(path, ec) || fs::is_directory(path, ec)) {
+            apply_mode(path, mode);
+        }
+    }
+
+    State state_ = State::Signature;
+    std::string buffer_;
+    std::vector<char> out_;
+    z_stream inflate_{};
+    bool inflate_ok_ = false;
+
+    uint16_t flags_ = 0;
+    uint16_t method_ = 0;
+    uint16_t name_length_ = 0;
+    uint16_t extra_length_ = 0;
+    uint16_t comment_length_ = 0;
+    uint16_t made_by_ = 0;
+    uint32_t external_attributes_ = 0;
+    uint64_t compressed_ = 0;
+    uint64_t remaining_ = 0;
+    uLong crc_ = 0;
+    uint32_t crc_expected_ = 0;
+    bool has_descriptor_ = false;
+    bool zip64_ = false;
+};
+#endif
+
+} // namespace
+
+StreamExtractor::StreamExtractor(std::unique_ptr<Impl> impl) : impl_(std::move(impl)) {}
+
+StreamExtractor::~StreamExtractor() = default;
+
+std::unique_ptr<StreamExtractor> StreamExtractor::create(const std::string& archive_name,
+                                                         const std::string& dest_dir) {
+    const char* raw = std::getenv("LEMONADE_STREAM_EXTRACT");
+    if (raw && std::string(raw) == "0") {
+        return nullptr;
+    }
+
+    std::string name = archive_name;
+    std::transform(name.begin(), name.end(), name.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    const fs::path root = fs::u8path(dest_dir);
+    std::unique_ptr<Impl> impl;
+#ifdef HAVE_ZLIB
+    if (ends_with(name, ".tar.gz") || ends_with(name, ".tgz")) {
+        impl = std::make_unique<TarExtractor>(root, std::make_unique<GzipDecoder>());
+    } else if (ends_with(name, ".zip")) {
+        impl = std::make_unique<ZipExtractor>(root);
+    }
+#endif
+#ifdef HAVE_LZMA
+    if (ends_with(name, ".tar.xz") || ends_with(name, ".txz")) {
+        impl = std::make_unique<TarExtractor>(root, std::make_unique<XzDecoder>());
+    }
+#endif
+    if (!impl) {
+        return nullptr;
+    }
+    return std::unique_ptr<StreamExtractor>(new StreamExtractor(std::move(impl)));
+}
+
+void StreamExtractor::feed(const char* data, size_t length, uint64_t offset) {
+    if (!impl_->error.empty() || length == 0) {
+        return;
+    }
+    if (offset != impl_->fed) {
+        impl_->fail("download restarted at byte " + std::to_string(offset) + " after " +
+                    std::to_string(impl_->fed) + " bytes were extracted");
+        return;
+    }
+    impl_->fed += length;
+    impl_->consume(data, length);
+}
+
+bool StreamExtractor::finish(uint64_t archive_size) {
+    if (!impl_->error.empty()) {
+        return false;
+    }
+    if (impl_->fed != archive_size) {
+        return impl_->fail("extracted " + std::to_string(impl_->fed) + " of " +
+                           std::to_string(archive_size) + " archive bytes");
+    }
+    if (!impl_->complete()) {
+        return impl_->fail("archive ended before its end marker");
+    }
+    return impl_->close_file();
+}
+
+const std::string& StreamExtractor::error() const {
+    return impl_->error;
+}
+
+uint64_t StreamExtractor::entries() const {
+    return impl_->entry_count;
+}
+
+} // namespace lemon::utils
@@ -234,6 +234,10 @@ void WebSocketServer::stop() {
     LOG(INFO, "WebSocket") << "Server stopped" << std::endl;
 }
 
+nlohmann::json WebSocketServer::get_realtime_transcription_stats() const {
+    return session_manager_ ? session_manager_->get_transcription_stats() : nlohmann::json::object();
+}
+
 bool WebSocketServer::adopt_socket(intptr_t fd) {
     if (!running_.load() || !context_) {
         return false;
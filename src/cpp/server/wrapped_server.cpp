@@ -1,6 +1,10 @@
 #include <lemon/wrapped_server.h>
+#include <lemon/cgroup_manager.h>
+#include <lemon/cpu_placement.h>
 #include <lemon/utils/process_manager.h>
 #include <lemon/utils/http_client.h>
+#include <lemon/utils/process_reactor.h>
+#include <lemon/utils/path_utils.h>
 #include <lemon/streaming_proxy.h>
 #include <lemon/error_types.h>
 #include <httplib.h>
@@ -10,8 +14,14 @@
 #include <chrono>
 #include <iostream>
 #include <cstdlib>
+#include <filesystem>
+#include <set>
 #include <lemon/utils/aixlog.hpp>
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
 namespace lemon {
 
 namespace {
@@ -67,6 +77,22 @@ std::string normalize_endpoint(std::string endpoint) {
     return endpoint;
 }
 
+// Lines backends print once they accept requests (llama-server,
+// whisper-server, sd-server, uvicorn-based servers, flm). A match only
+// triggers an early probe, so loose matching is harmless.
+bool is_readiness_line(const std::string& line) {
+    const std::string lowered = lower_copy(line);
+    return lowered.find("listening") != std::string::npos ||
+           lowered.find("model loaded") != std::string::npos ||
+           lowered.find("startup complete") != std::string::npos ||
+           lowered.find("running on http") != std::string::npos;
+}
+
+long elapsed_ms(std::chrono::steady_clock::time_point since) {
+    return static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - since).count());
+}
+
 bool is_backend_connection_failure(const std::string& message) {
     const std::string lowered = lower_copy(message);
     return lowered.find("server returned nothing") != std::string::npos ||
@@ -147,6 +173,9 @@ json create_backend_error_response(const std::string& server_name, int status_co
 
 WrappedServer::~WrappedServer() {
     stop_backend_watchdog();
+    release_unix_socket();
+    release_cpu_placement();
+    release_cgroup();
 }
 
 WrappedServer::BackendRequestScope::BackendRequestScope(WrappedServer& server, BackendRequestKind kind)
@@ -172,8 +201,52 @@ ProcessHandle WrappedServer::get_process_handle_snapshot() const {
 }
 
 void WrappedServer::set_process_handle(ProcessHandle handle) {
-    std::lock_guard<std::mutex> lock(process_mutex_);
-    process_handle_ = handle;
+    {
+        std::lock_guard<std::mutex> lock(process_mutex_);
+        process_handle_ = handle;
+    }
+    if (has_process_handle(handle)) {
+        // The backend leaves lemond's cgroup for one of its own, sized by
+        // the model; where cgroups are unavailable it stays where it is
+        const int64_t expected_bytes = static_cast<int64_t>(expected_memory_gb_ * 1024.0 * 1024.0 * 1024.0);
+        const std::string leaf = CgroupManager::global().attach(
+            model_name_, handle.pid, CgroupLimits::for_backend(is_interactive(), expected_bytes));
+        std::string previous;
+        {
+            std::lock_guard<std::mutex> lock(process_mutex_);
+            previous = cgroup_leaf_;
+            cgroup_leaf_ = leaf;
+        }
+        CgroupManager::global().release(previous);
+
+        std::lock_guard<std::mutex> lock(load_timing_mutex_);
+        spawned_at_ = std::chrono::steady_clock::now();
+        if (load_started_at_ != std::chrono::steady_clock::time_point{}) {
+            load_timing_.spawn_ms = elapsed_ms(load_started_at_);
+        }
+    }
+}
+
+void WrappedServer::begin_load_timing() {
+    std::lock_guard<std::mutex> lock(load_timing_mutex_);
+    load_timing_ = BackendLoadTiming{};
+    load_started_at_ = std::chrono::steady_clock::now();
+    spawned_at_ = std::chrono::steady_clock::time_point{};
+}
+
+void WrappedServer::set_prewarm_timing(long ms, uint64_t bytes, double mb_per_second, bool completed) {
+    std::lock_guard<std::mutex> lock(load_timing_mutex_);
+    load_timing_.prewarm_ms = ms;
+    load_timing_.prewarm_bytes = bytes;
+    load_timing_.prewarm_mb_per_second = mb_per_second;
+    load_timing_.prewarm_completed = completed;
+}
+
+BackendLoadTiming WrappedServer::get_load_timing() const {
+    std::lock_guard<std::mutex> lock(load_timing_mutex_);
+    BackendLoadTiming timing = load_timing_;
+    timing.total_ms = load_duration_ms_ > 0 ? load_duration_ms_ : -1;
+    return timing;
 }
 
 int WrappedServer::get_backend_port() const {
@@ -182,13 +255,187 @@ int WrappedServer::get_backend_port() const {
 }
 
 ProcessHandle WrappedServer::consume_process_handle_for_cleanup() {
-    std::lock_guard<std::mutex> lock(process_mutex_);
-    ProcessHandle handle = process_handle_;
-    process_handle_ = {nullptr, 0};
-    port_ = 0;
+    ProcessHandle handle;
+    {
+        std::lock_guard<std::mutex> lock(process_mutex_);
+        handle = process_handle_;
+        process_handle_ = {nullptr, 0};
+        port_ = 0;
+    }
+    release_unix_socket();
+    release_cpu_placement();
+    release_cgroup();
     return handle;
 }
 
+std::string WrappedServer::get_base_url() const {
+    std::lock_guard<std::mutex> lock(process_mutex_);
+    if (!unix_authority_.empty()) {
+        return "http://" + unix_authority_;
+    }
+    return "http://127.0.0.1:" + std::to_string(port_);
+}
+
+bool WrappedServer::uses_unix_socket() const {
+    std::lock_guard<std::mutex> lock(process_mutex_);
+    return !unix_socket_path_.empty();
+}
+
+namespace {
+
+std::mutex g_tcp_only_mutex;
+std::set<std::string> g_tcp_only_executables;  // Builds that rejected a socket --host
+
+std::atomic<uint64_t> g_next_socket_id{1};
+
+} // namespace
+
+std::string WrappedServer::choose_unix_socket(const std::string& executable) {
+#ifdef _WIN32
+    (void)executable;
+    return "";
+#else
+    const char* env = std::getenv("LEMONADE_BACKEND_UNIX_SOCKETS");
+    if (env && std::string(env) == "0") {
+        return "";
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_tcp_only_mutex);
+        if (g_tcp_only_executables.count(executable)) {
+            return "";
+        }
+    }
+
+    std::string runtime_dir;
+    try {
+        runtime_dir = utils::get_runtime_dir();
+    } catch (const std::exception&) {
+        return "";
+    }
+    const uint64_t id = g_next_socket_id.fetch_add(1);
+    const std::string path = runtime_dir + "/backend-" + std::to_string(getpid()) + "-" +
+                             std::to_string(id) + ".sock";
+    // sockaddr_un::sun_path is 104-108 bytes depending on the platform
+    if (path.size() >= 100) {
+        return "";
+    }
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    release_unix_socket();
+    const std::string authority = "lemonade-backend-" + std::to_string(id);
+    utils::HttpClient::set_unix_socket_route(authority, path);
+    {
+        std::lock_guard<std::mutex> lock(process_mutex_);
+        unix_socket_path_ = path;
+        unix_authority_ = authority;
+        port_ = 0;
+    }
+    LOG(DEBUG, "WrappedServer") << server_name_ << " will use socket: " << path << std::endl;
+    return path;
+#endif
+}
+
+void WrappedServer::fall_back_to_tcp() {
+    release_unix_socket();
+    LOG(INFO, "WrappedServer") << server_name_ << " did not come up on a Unix socket; "
+                               << "retrying over TCP" << std::endl;
+}
+
+void WrappedServer::mark_tcp_only(const std::string& executable) {
+    {
+        std::lock_guard<std::mutex> lock(g_tcp_only_mutex);
+        g_tcp_only_executables.insert(executable);
+    }
+    LOG(INFO, "WrappedServer") << "Using TCP for " << executable << " from now on" << std::endl;
+}
+
+utils::CpuPlacement WrappedServer::reserve_cpu_placement(int threads) {
+    CpuPlacementPlanner& planner = CpuPlacementPlanner::global();
+    const int cores = planner.core_demand(recipe_options_.get_recipe(), threads, replica_count_);
+    std::string label = model_name_;
+    if (replica_count_ > 1) {
+        label += " #" + std::to_string(replica_index_ + 1);
+    }
+    const utils::CpuPlacement placement =
+        planner.reserve(reinterpret_cast<uintptr_t>(this), label, cores);
+    {
+        std::lock_guard<std::mutex> lock(process_mutex_);
+        cpu_placement_ = placement;
+    }
+    if (!placement.empty()) {
+        LOG(INFO, "WrappedServer") << label << " runs on CPUs " << format_cpu_list(placement.cpus)
+                                   << " (" << placement.physical_cores << " cores, NUMA node "
+                                   << placement.numa_node << ")" << std::endl;
+    } else if (planner.enabled() && cores > 0) {
+        LOG(INFO, "WrappedServer") << "No free cores for " << label << ", running unplaced" << std::endl;
+    }
+    return placement;
+}
+
+utils::CpuPlacement WrappedServer::get_cpu_placement() const {
+    std::lock_guard<std::mutex> lock(process_mutex_);
+    return cpu_placement_;
+}
+
+bool WrappedServer::is_interactive() const {
+    if (!eviction_policy_.priority.empty()) {
+        return eviction_policy_.priority == "interactive";
+    }
+    return model_type_ == ModelType::LLM || model_type_ == ModelType::TRANSCRIPTION ||
+           model_type_ == ModelType::TTS;
+}
+
+int64_t WrappedServer::get_memory_bytes() const {
+    std::string leaf;
+    {
+        std::lock_guard<std::mutex> lock(process_mutex_);
+        leaf = cgroup_leaf_;
+    }
+    return CgroupManager::memory_current(leaf);
+}
+
+std::string WrappedServer::get_cgroup_leaf() const {
+    std::lock_guard<std::mutex> lock(process_mutex_);
+    return cgroup_leaf_;
+}
+
+void WrappedServer::release_cgroup() {
+    std::string leaf;
+    {
+        std::lock_guard<std::mutex> lock(process_mutex_);
+        leaf.swap(cgroup_leaf_);
+    }
+    CgroupManager::global().release(leaf);
+}
+
+void WrappedServer::release_cpu_placement() {
+    {
+        std::lock_guard<std::mutex> lock(process_mutex_);
+        if (cpu_placement_.empty()) {
+            return;
+        }
+        cpu_placement_ = {};
+    }
+    CpuPlacementPlanner::global().release(reinterpret_cast<uintptr_t>(this));
+}
+
+void WrappedServer::release_unix_socket() {
+    std::string path;
+    std::string authority;
+    {
+        std::lock_guard<std::mutex> lock(process_mutex_);
+        path.swap(unix_socket_path_);
+        authority.swap(unix_authority_);
+    }
+    if (authority.empty()) {
+        return;
+    }
+    utils::HttpClient::set_unix_socket_route(authority, "");
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+}
+
 bool WrappedServer::is_backend_alive() const {
     if (watchdog_triggered_.load(std::memory_order_acquire)) {
         return false;
@@ -242,7 +489,6 @@ void WrappedServer::note_backend_activity() {
         std::lock_guard<std::mutex> lock(watchdog_mutex_);
         last_backend_activity_ = std::chrono::steady_clock::now();
     }
-    watchdog_cv_.notify_all();
 }
 
 void WrappedServer::begin_backend_request(BackendRequestKind kind) {
@@ -274,8 +520,6 @@ void WrappedServer::end_backend_request(BackendRequestKind kind) {
             active_non_streaming_requests_.store(0, std::memory_order_release);
         }
     }
-
-    watchdog_cv_.notify_all();
 }
 
 void WrappedServer::set_watchdog_health_endpoint(const std::string& endpoint) {
@@ -311,10 +555,9 @@ void WrappedServer::start_backend_watchdog(const BackendWatchdogPolicy& policy)
 
     bool expected = false;
     if (!watchdog_running_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
-        // Idempotent start: keep the existing thread and just publish the new
+        // Idempotent start: keep the existing timer and just publish the new
         // policy. Do not reset active counters or watchdog state while requests
         // may already be in flight.
-        watchdog_cv_.notify_all();
         return;
     }
 
@@ -327,9 +570,46 @@ void WrappedServer::start_backend_watchdog(const BackendWatchdogPolicy& policy)
         std::lock_guard<std::mutex> lock(watchdog_mutex_);
         watchdog_reset_reason_.clear();
         last_backend_activity_ = std::chrono::steady_clock::now();
+        watchdog_failures_ = 0;
+        watchdog_probe_pending_ = false;
+        watchdog_grace_ = std::chrono::seconds(
+            get_env_long("LEMONADE_BACKEND_WATCHDOG_GRACE_SECONDS", 90, 10));
+        watchdog_probe_timeout_seconds_ = static_cast<int>(
+            get_env_long("LEMONADE_BACKEND_WATCHDOG_PROBE_TIMEOUT_SECONDS", 2, 1));
+        watchdog_max_failures_ = static_cast<int>(
+            get_env_long("LEMONADE_BACKEND_WATCHDOG_MAX_FAILURES", 3, 1));
     }
+    const auto poll = std::chrono::seconds(
+        get_env_long("LEMONADE_BACKEND_WATCHDOG_POLL_SECONDS", 5, 1));
 
-    watchdog_thread_ = std::thread(&WrappedServer::backend_watchdog_loop, this);
+    auto& reactor = utils::ProcessReactor::instance();
+
+    // Always detect child-process exit, even when there is no active request
+    // or when the active request is non-streaming. The reactor reports the
+    // exit as soon as it happens rather than on the next poll, so a crashed
+    // backend is marked unavailable before the router retries against it.
+    const ProcessHandle handle = get_process_handle_snapshot();
+    utils::ProcessReactor::Id exit_watch = 0;
+    if (has_process_handle(handle)) {
+        exit_watch = reactor.watch_exit(
+            handle.pid,
+            [handle]() { return utils::ProcessManager::is_running(handle); },
+            [this]() {
+                std::lock_guard<std::mutex> lock(watchdog_mutex_);
+                post_watchdog_job_locked([this]() {
+                    request_backend_reset_from_watchdog("backend process exited while watchdog was active");
+                });
+            });
+    }
+    const utils::ProcessReactor::Id timer = reactor.add_timer(
+        std::chrono::duration_cast<std::chrono::milliseconds>(poll),
+        [this]() { on_watchdog_timer(); },
+        true);
+    {
+        std::lock_guard<std::mutex> lock(watchdog_mutex_);
+        watchdog_exit_watch_ = exit_watch;
+        watchdog_timer_ = timer;
+    }
 
     LOG(INFO, "BackendWatchdog") << "Started watchdog for " << server_name_
                                   << " using " << get_base_url() << effective_policy.health_endpoint
@@ -346,10 +626,22 @@ void WrappedServer::stop_backend_watchdog() {
     }
 
     watchdog_stop_requested_.store(true, std::memory_order_release);
-    watchdog_cv_.notify_all();
 
-    if (watchdog_thread_.joinable()) {
-        watchdog_thread_.join();
+    utils::ProcessReactor::Id timer = 0;
+    utils::ProcessReactor::Id exit_watch = 0;
+    {
+        std::lock_guard<std::mutex> lock(watchdog_mutex_);
+        std::swap(timer, watchdog_timer_);
+        std::swap(exit_watch, watchdog_exit_watch_);
+    }
+    // cancel() waits for a callback that is already running, so no new
+    // watchdog job can be posted once both return.
+    auto& reactor = utils::ProcessReactor::instance();
+    reactor.cancel(timer);
+    reactor.cancel(exit_watch);
+    {
+        std::unique_lock<std::mutex> lock(watchdog_mutex_);
+        watchdog_jobs_cv_.wait(lock, [this]() { return watchdog_jobs_in_flight_ == 0; });
     }
 
     watchdog_running_.store(false, std::memory_order_release);
@@ -404,100 +696,108 @@ void WrappedServer::request_backend_reset_from_watchdog(const std::string& reaso
                                       << reason << "; no process handle to reap"
                                       << std::endl;
     }
-
-    watchdog_cv_.notify_all();
 }
 
-void WrappedServer::backend_watchdog_loop() {
-    const auto grace = std::chrono::seconds(
-        get_env_long("LEMONADE_BACKEND_WATCHDOG_GRACE_SECONDS", 90, 10));
-    const auto poll = std::chrono::seconds(
-        get_env_long("LEMONADE_BACKEND_WATCHDOG_POLL_SECONDS", 5, 1));
-    const int probe_timeout_seconds = static_cast<int>(
-        get_env_long("LEMONADE_BACKEND_WATCHDOG_PROBE_TIMEOUT_SECONDS", 2, 1));
-    const int max_failures = static_cast<int>(
-        get_env_long("LEMONADE_BACKEND_WATCHDOG_MAX_FAILURES", 3, 1));
-
-    int consecutive_failures = 0;
-
-    while (!watchdog_stop_requested_.load(std::memory_order_acquire)) {
-        std::unique_lock<std::mutex> lock(watchdog_mutex_);
-        watchdog_cv_.wait_for(lock, poll, [this]() {
-            return watchdog_stop_requested_.load(std::memory_order_acquire);
-        });
-
-        if (watchdog_stop_requested_.load(std::memory_order_acquire) ||
-            watchdog_triggered_.load(std::memory_order_acquire)) {
-            break;
+void WrappedServer::post_watchdog_job_locked(std::function<void()> job) {
+    ++watchdog_jobs_in_flight_;
+    utils::ProcessReactor::instance().post(this, [this, job = std::move(job)]() {
+        if (!watchdog_stop_requested_.load(std::memory_order_acquire) &&
+            !watchdog_triggered_.load(std::memory_order_acquire)) {
+            job();
         }
+        std::lock_guard<std::mutex> lock(watchdog_mutex_);
+        watchdog_probe_pending_ = false;
+        --watchdog_jobs_in_flight_;
+        watchdog_jobs_cv_.notify_all();
+    });
+}
 
-        // Always detect child-process exit/zombie state, even when there is no
-        // active request or when the active request is non-streaming. This is a
-        // cheap process-handle/PID check, not an HTTP /health probe, so long
-        // non-streaming work such as image generation is not killed just because
-        // it takes a long time. If the backend has crashed, mark it unavailable
-        // so the router can lazily reload/retry recoverable calls.
-        if (has_backend_process_exited()) {
-            lock.unlock();
-            request_backend_reset_from_watchdog("backend process exited while watchdog was active");
-            break;
-        }
+void WrappedServer::on_watchdog_timer() {
+    // Runs on the reactor thread: decide whether a probe is due and hand the
+    // blocking part to the reactor's workers.
+    if (watchdog_stop_requested_.load(std::memory_order_acquire) ||
+        watchdog_triggered_.load(std::memory_order_acquire)) {
+        return;
+    }
 
-        const int active = active_backend_requests_.load(std::memory_order_acquire);
-        if (active <= 0) {
-            consecutive_failures = 0;
-            continue;
-        }
+    std::lock_guard<std::mutex> lock(watchdog_mutex_);
+    if (watchdog_probe_pending_) {
+        return;
+    }
 
-        const BackendWatchdogPolicy policy = watchdog_policy_;
-        const bool has_streaming = active_streaming_requests_.load(std::memory_order_acquire) > 0;
-        const bool has_non_streaming = active_non_streaming_requests_.load(std::memory_order_acquire) > 0;
-        const bool should_monitor =
-            (has_streaming && policy.monitor_streaming_requests) ||
-            has_non_streaming;
+    const int active = active_backend_requests_.load(std::memory_order_acquire);
+    if (active <= 0) {
+        watchdog_failures_ = 0;
+        return;
+    }
 
-        if (!policy.enabled || policy.health_endpoint.empty() || !should_monitor) {
-            consecutive_failures = 0;
-            continue;
-        }
+    const BackendWatchdogPolicy& policy = watchdog_policy_;
+    const bool has_streaming = active_streaming_requests_.load(std::memory_order_acquire) > 0;
+    const bool has_non_streaming = active_non_streaming_requests_.load(std::memory_order_acquire) > 0;
+    const bool should_monitor =
+        (has_streaming && policy.monitor_streaming_requests) ||
+        has_non_streaming;
 
-        const auto last_activity = last_backend_activity_;
-        const auto idle_for = std::chrono::steady_clock::now() - last_activity;
-        if (idle_for < grace) {
-            consecutive_failures = 0;
-            continue;
-        }
+    if (!policy.enabled || policy.health_endpoint.empty() || !should_monitor) {
+        watchdog_failures_ = 0;
+        return;
+    }
 
-        const std::string health_url = get_base_url() + policy.health_endpoint;
-        lock.unlock();
+    const auto idle_for = std::chrono::steady_clock::now() - last_backend_activity_;
+    if (idle_for < watchdog_grace_) {
+        watchdog_failures_ = 0;
+        return;
+    }
 
-        const ProcessHandle handle = get_process_handle_snapshot();
-        if (!has_process_handle(handle) || !utils::ProcessManager::is_running(handle)) {
-            request_backend_reset_from_watchdog("backend process exited during an active request");
-            break;
-        }
+    const std::string health_url = get_base_url() + policy.health_endpoint;
+    const long idle_seconds = static_cast<long>(
+        std::chrono::duration_cast<std::chrono::seconds>(idle_for).count());
+    watchdog_probe_pending_ = true;
+    post_watchdog_job_locked([this, health_url, idle_seconds]() {
+        run_watchdog_probe(health_url, idle_seconds);
+    });
+}
 
-        const bool reachable = utils::HttpClient::is_reachable(health_url, probe_timeout_seconds);
-        if (reachable) {
-            consecutive_failures = 0;
-            note_backend_activity();
-            continue;
-        }
+void WrappedServer::run_watchdog_probe(const std::string& health_url, long idle_seconds) {
+    const ProcessHandle handle = get_process_handle_snapshot();
+    if (!has_process_handle(handle) || !utils::ProcessManager::is_running(handle)) {
+        request_backend_reset_from_watchdog("backend process exited during an active request");
+        return;
+    }
 
-        ++consecutive_failures;
-        LOG(WARNING, "BackendWatchdog") << server_name_ << " health probe failed "
-                                         << consecutive_failures << "/" << max_failures
-                                         << " after "
-                                         << std::chrono::duration_cast<std::chrono::seconds>(idle_for).count()
-                                         << "s without observable progress"
-                                         << std::endl;
+    int probe_timeout_seconds = 0;
+    int max_failures = 0;
+    {
+        std::lock_guard<std::mutex> lock(watchdog_mutex_);
+        probe_timeout_seconds = watchdog_probe_timeout_seconds_;
+        max_failures = watchdog_max_failures_;
+    }
 
-        if (consecutive_failures >= max_failures) {
-            request_backend_reset_from_watchdog(
-                "health endpoint did not respond after " + std::to_string(max_failures) +
-                " consecutive probes while a request was active");
-            break;
+    const bool reachable = utils::HttpClient::is_reachable(health_url, probe_timeout_seconds);
+    if (reachable) {
+        {
+            std::lock_guard<std::mutex> lock(watchdog_mutex_);
+            watchdog_failures_ = 0;
         }
+        note_backend_activity();
+        return;
+    }
+
+    int failures = 0;
+    {
+        std::lock_guard<std::mutex> lock(watchdog_mutex_);
+        failures = ++watchdog_failures_;
+    }
+    LOG(WARNING, "BackendWatchdog") << server_name_ << " health probe failed "
+                                     << failures << "/" << max_failures
+                                     << " after " << idle_seconds
+                                     << "s without observable progress"
+                                     << std::endl;
+
+    if (failures >= max_failures) {
+        request_backend_reset_from_watchdog(
+            "health endpoint did not respond after " + std::to_string(max_failures) +
+            " consecutive probes while a request was active");
     }
 }
 
@@ -514,9 +814,106 @@ int WrappedServer::choose_port() {
     return chosen_port;
 }
 
+WrappedServer::ReadyWaitResult WrappedServer::await_backend_ready(
+    const std::string& endpoint,
+    std::chrono::milliseconds timeout,
+    std::chrono::milliseconds max_poll_interval) {
+    constexpr auto kMinPollInterval = std::chrono::milliseconds(10);
+    const std::string health_url = get_base_url() + normalize_endpoint(endpoint);
+    const int port = get_backend_port();
+    std::string socket_path;
+    {
+        std::lock_guard<std::mutex> lock(process_mutex_);
+        socket_path = unix_socket_path_;
+    }
+    max_poll_interval = std::max(max_poll_interval, kMinPollInterval);
+
+    // Readiness log lines wake the wait below for an immediate probe
+    struct ReadinessSignal {
+        std::mutex mutex;
+        std::condition_variable cv;
+        uint64_t lines = 0;
+    };
+    auto signal = std::make_shared<ReadinessSignal>();
+    const int pid = get_process_handle_snapshot().pid;
+    if (pid > 0) {
+        utils::ProcessManager::set_output_observer(pid, [signal](const std::string& line) {
+            if (!is_readiness_line(line)) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(signal->mutex);
+                ++signal->lines;
+            }
+            signal->cv.notify_all();
+        });
+    }
+    struct ObserverGuard {
+        int pid;
+        ~ObserverGuard() {
+            if (pid > 0) {
+                utils::ProcessManager::clear_output_observer(pid);
+            }
+        }
+    } observer_guard{pid};
+
+    auto stamp = [this](long BackendLoadTiming::*phase, const char* ready_signal) {
+        std::lock_guard<std::mutex> lock(load_timing_mutex_);
+        if (spawned_at_ != std::chrono::steady_clock::time_point{}) {
+            load_timing_.*phase = elapsed_ms(spawned_at_);
+        }
+        if (ready_signal) {
+            load_timing_.ready_signal = ready_signal;
+        }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + timeout;
+    auto next_progress_log = start + std::chrono::seconds(10);
+    auto delay = kMinPollInterval;
+    uint64_t seen_lines = 0;
+    bool listening = false;
+    bool woke_on_output = false;
+
+    while (true) {
+        const ProcessHandle handle = get_process_handle_snapshot();
+        if (!has_process_handle(handle) || !utils::ProcessManager::is_running(handle)) {
+            return ReadyWaitResult::Exited;
+        }
+
+        // A refused loopback connect is far cheaper than an HTTP request, so
+        // only start probing the health endpoint once the port is open.
+        if (!listening && (socket_path.empty()
+                               ? utils::ProcessManager::is_port_listening(port)
+                               : utils::ProcessManager::is_unix_socket_listening(socket_path))) {
+            listening = true;
+            stamp(&BackendLoadTiming::listen_ms, nullptr);
+        }
+        if (listening && utils::HttpClient::is_reachable(health_url, 1)) {
+            stamp(&BackendLoadTiming::ready_ms, woke_on_output ? "output" : "poll");
+            return ReadyWaitResult::Ready;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return ReadyWaitResult::TimedOut;
+        }
+        if (now >= next_progress_log) {
+            LOG(DEBUG, "WrappedServer") << "Still waiting for " + server_name_ + "..." << std::endl;
+            next_progress_log = now + std::chrono::seconds(10);
+        }
+
+        std::unique_lock<std::mutex> lock(signal->mutex);
+        woke_on_output = signal->cv.wait_until(lock, std::min(now + delay, deadline), [&]() {
+            return signal->lines != seen_lines;
+        });
+        seen_lines = signal->lines;
+        delay = woke_on_output ? kMinPollInterval : std::min(delay * 2, max_poll_interval);
+    }
+}
+
 bool WrappedServer::wait_for_ready(const std::string& endpoint, long timeout_seconds, long poll_interval_ms) {
     const std::string normalized_endpoint = normalize_endpoint(endpoint);
-    std::string health_url = get_base_url() + normalized_endpoint;
 
     // Use global default if not specified
     if (timeout_seconds == 0) {
@@ -526,40 +923,35 @@ bool WrappedServer::wait_for_ready(const std::string& endpoint, long timeout_sec
     std::cout << "Waiting for " + server_name_ + " to be ready (timeout: " << timeout_seconds << "s)..." << std::endl;
     LOG(DEBUG, "WrappedServer") << "Waiting for " + server_name_ + " to be ready..." << std::endl;
 
-    const int max_attempts = (timeout_seconds * 1000) / poll_interval_ms;
+    const ReadyWaitResult result = await_backend_ready(normalized_endpoint,
+                                                       std::chrono::seconds(timeout_seconds),
+                                                       std::chrono::milliseconds(poll_interval_ms));
+
+    if (result == ReadyWaitResult::Ready) {
+        const BackendLoadTiming timing = get_load_timing();
+        LOG(INFO, "WrappedServer") << server_name_ + " is ready!"
+                                   << " (listening after " << timing.listen_ms << "ms, ready after "
+                                   << timing.ready_ms << "ms, detected by " << timing.ready_signal << ")"
+                                   << std::endl;
+        start_backend_watchdog(normalized_endpoint);
+        return true;
+    }
 
-    for (int i = 0; i < max_attempts; i++) {
-        // Check if process is still running. If it already exited, consume and
-        // reap the owned handle here so the caller cannot later signal a stale
-        // PID while cleaning up a failed startup.
-        const ProcessHandle handle = get_process_handle_snapshot();
-        if (!has_process_handle(handle) || !utils::ProcessManager::is_running(handle)) {
-            const ProcessHandle exited_handle = consume_process_handle_for_cleanup();
-            int exit_code = has_process_handle(exited_handle)
-                ? utils::ProcessManager::reap_process(exited_handle)
-                : -1;
-            LOG(ERROR, "WrappedServer") << server_name_ << " process has terminated with exit code: "
-                     << exit_code << std::endl;
-            LOG(ERROR, "WrappedServer") << "This usually means:" << std::endl;
-            LOG(ERROR, "WrappedServer") << "  - Missing required drivers or dependencies" << std::endl;
-            LOG(ERROR, "WrappedServer") << "  - Incompatible model file" << std::endl;
-            LOG(ERROR, "WrappedServer") << "  - Try running the server manually to see the actual error" << std::endl;
-            return false;
-        }
-
-        // Try health endpoint
-        if (utils::HttpClient::is_reachable(health_url, 1)) {
-            LOG(INFO, "WrappedServer") << server_name_ + " is ready!" << std::endl;
-            start_backend_watchdog(normalized_endpoint);
-            return true;
-        }
-
-        std::this_thread::sleep_for(std::chrono::milliseconds(poll_interval_ms));
-
-        // Print progress every 10 seconds
-        if (i % 100 == 0 && i > 0) {
-            LOG(DEBUG, "WrappedServer") << "Still waiting for " + server_name_ + "..." << std::endl;
-        }
+    if (result == ReadyWaitResult::Exited) {
+        // The process already exited: consume and reap the owned handle here so
+        // the caller cannot later signal a stale PID while cleaning up a failed
+        // startup.
+        const ProcessHandle exited_handle = consume_process_handle_for_cleanup();
+        int exit_code = has_process_handle(exited_handle)
+            ? utils::ProcessManager::reap_process(exited_handle)
+            : -1;
+        LOG(ERROR, "WrappedServer") << server_name_ << " process has terminated with exit code: "
+                 << exit_code << std::endl;
+        LOG(ERROR, "WrappedServer") << "This usually means:" << std::endl;
+        LOG(ERROR, "WrappedServer") << "  - Missing required drivers or dependencies" << std::endl;
+        LOG(ERROR, "WrappedServer") << "  - Incompatible model file" << std::endl;
+        LOG(ERROR, "WrappedServer") << "  - Try running the server manually to see the actual error" << std::endl;
+        return false;
     }
 
     LOG(ERROR, "WrappedServer") << server_name_ + " failed to start within timeout" << std::endl;
@@ -655,6 +1047,12 @@ json WrappedServer::forward_request(const std::string& endpoint, const json& req
                 error_details
             );
         }
+    } catch (const utils::RequestCancelledError&) {
+        // The client hung up: dropping the connection stopped the backend's
+        // generation, which is not a backend failure
+        LOG(INFO, "WrappedServer") << server_name_ << " request to " << endpoint
+                                   << " cancelled after the client disconnected" << std::endl;
+        return ErrorResponse::from_exception(RequestCancelledException("client disconnected"));
     } catch (const std::exception& e) {
         if (was_watchdog_triggered() || has_backend_process_exited() || is_backend_connection_failure(e.what())) {
             if (!was_watchdog_triggered()) {
@@ -712,6 +1110,12 @@ json WrappedServer::forward_multipart_request(const std::string& endpoint,
                 }
             );
         }
+    } catch (const utils::RequestCancelledError&) {
+        // The client hung up: dropping the connection stopped the backend's
+        // generation, which is not a backend failure
+        LOG(INFO, "WrappedServer") << server_name_ << " request to " << endpoint
+                                   << " cancelled after the client disconnected" << std::endl;
+        return ErrorResponse::from_exception(RequestCancelledException("client disconnected"));
     } catch (const std::exception& e) {
         if (was_watchdog_triggered() || has_backend_process_exited() || is_backend_connection_failure(e.what())) {
             if (!was_watchdog_triggered()) {
@@ -0,0 +1,205 @@
+// Standalone test for lemon::BackendMetricsCollector.
+//
+// Uses a fake fetcher to check that backend metric names are prefixed and
+// labelled, that several backends merge into one HELP/TYPE per family, that
+// render() never fetches, that unreachable, unsupported and unloaded
+// backends are reported or dropped correctly, and that the first render()
+// after an idle park still returns the last sample.
+//
+// Compile with:
+//   g++ -std=c++17 -pthread -I src/cpp/include test/cpp/test_backend_metrics_collector.cpp src/cpp/server/backend_metrics_collector.cpp -o backend_metrics_collector_test
+
+#include "lemon/backend_metrics_collector.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using lemon::BackendMetricsCollector;
+
+struct TestResult {
+    int passed = 0;
+    int failed = 0;
+
+    void check(bool cond, const std::string& name) {
+        if (cond) {
+            printf("[PASS] %s\n", name.c_str());
+            ++passed;
+        } else {
+            printf("[FAIL] %s\n", name.c_str());
+            ++failed;
+        }
+    }
+};
+
+static const char* kLlamaMetrics =
+    "# HELP llamacpp:prompt_tokens_total Number of prompt tokens processed.\r\n"
+    "# TYPE llamacpp:prompt_tokens_total counter\r\n"
+    "llamacpp:prompt_tokens_total 42\r\n"
+    "# HELP llamacpp:requests_processing Number of requests processing.\n"
+    "# TYPE llamacpp:requests_processing gauge\n"
+    "llamacpp:requests_processing 1\n";
+
+static const char* kVllmMetrics =
+    "# HELP vllm:e2e_request_latency_seconds Histogram of e2e request latency.\n"
+    "# TYPE vllm:e2e_request_latency_seconds histogram\n"
+    "vllm:e2e_request_latency_seconds_bucket{le=\"1.0\",model_name=\"m\"} 3\n"
+    "vllm:e2e_request_latency_seconds_count{model_name=\"m\"} 3\n";
+
+static size_t count_of(const std::string& haystack, const std::string& needle) {
+    size_t count = 0;
+    for (size_t pos = haystack.find(needle); pos != std::string::npos; pos = haystack.find(needle, pos + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+static BackendMetricsCollector::Target target(const std::string& url, const std::string& recipe,
+                                              const std::string& model) {
+    return {url, recipe, {{"model_name", model}, {"recipe", recipe}}};
+}
+
+static void test_rewrite(TestResult& r) {
+    std::map<std::string, std::string> metadata, samples;
+    BackendMetricsCollector::rewrite_exposition(kVllmMetrics, "vllm", {{"model_name", "Qwen \"x\""}},
+                                                metadata, samples);
+    const std::string family = "lemonade_vllm_e2e_request_latency_seconds";
+    r.check(samples.size() == 1 && samples.count(family), "histogram samples group under their family");
+    r.check(metadata.count(family) && metadata[family].find("# TYPE " + family + " histogram") != std::string::npos,
+            "TYPE line is renamed with the recipe prefix");
+    r.check(samples[family].find("lemonade_vllm_e2e_request_latency_seconds_bucket{le=\"1.0\",model_name=\"m\","
+                                 "model_name=\"Qwen \\\"x\\\"\"} 3") != std::string::npos,
+            "Lemonade labels are appended and escaped");
+
+    std::map<std::string, std::string> none_meta, none_samples;
+    BackendMetricsCollector::rewrite_exposition(kLlamaMetrics, "kokoro", {}, none_meta, none_samples);
+    r.check(none_samples.empty() && BackendMetricsCollector::metric_prefix_for_recipe("kokoro").empty(),
+            "recipes without /metrics are not federated");
+}
+
+static void test_federation(TestResult& r) {
+    std::vector<BackendMetricsCollector::Target> targets = {
+        target("http://127.0.0.1:8001/v1", "llamacpp", "a"),
+        target("http://127.0.0.1:8002/v1", "llamacpp", "b"),
+        target("http://127.0.0.1:8003/v1", "whispercpp", "w"),
+        target("http://127.0.0.1:8004/v1", "llamacpp", "down"),
+        target("http://127.0.0.1:8005/v1", "kokoro", "tts"),
+    };
+    std::atomic<int> fetches{0};
+    std::atomic<int> whisper_fetches{0};
+
+    BackendMetricsCollector collector(
+        [&] { return targets; },
+        [&](const std::string& url, int& status, std::string& body) {
+            fetches++;
+            if (url.find(":8003") != std::string::npos) {
+                whisper_fetches++;
+                status = 404;
+                return true;
+            }
+            if (url.find(":8004") != std::string::npos) {
+                return false;
+            }
+            status = 200;
+            body = kLlamaMetrics;
+            return true;
+        });
+
+    collector.scrape_now();
+    const int after_scrape = fetches;
+    BackendMetricsCollector::Snapshot snapshot = collector.render();
+    r.check(fetches == after_scrape, "render() serves the cache without fetching");
+    r.check(after_scrape == 4, "only recipes with a metrics endpoint are scraped");
+
+    const std::string& text = snapshot.text;
+    r.check(count_of(text, "# TYPE lemonade_llamacpp_prompt_tokens_total counter") == 1,
+            "each family is described once across backends");
+    r.check(text.find("lemonade_llamacpp_prompt_tokens_total{model_name=\"a\",recipe=\"llamacpp\"} 42") != std::string::npos &&
+                text.find("lemonade_llamacpp_prompt_tokens_total{model_name=\"b\",recipe=\"llamacpp\"} 42") != std::string::npos,
+            "every backend's samples are labelled with its model");
+    r.check(text.find("# TYPE lemonade_llamacpp_prompt_tokens_total") <
+                text.find("lemonade_llamacpp_prompt_tokens_total{model_name=\"b\""),
+            "samples follow their family's TYPE line");
+    r.check(text.find("model_name=\"down\"") == std::string::npos, "unreachable backends contribute no samples");
+
+    bool down_reported = false, whisper_reported = false;
+    for (const auto& status : snapshot.statuses) {
+        if (status.labels.at("model_name") == "down") {
+            down_reported = !status.up && status.age_seconds < 0;
+        }
+        if (status.labels.at("model_name") == "w") {
+            whisper_reported = true;
+        }
+    }
+    r.check(down_reported, "unreachable backends are reported as down");
+    r.check(!whisper_reported, "backends without /metrics are not reported as down");
+
+    collector.scrape_now();
+    r.check(whisper_fetches == 1, "a backend that answered 404 is not scraped again");
+
+    targets.erase(targets.begin());
+    collector.scrape_now();
+    snapshot = collector.render();
+    r.check(snapshot.text.find("model_name=\"a\"") == std::string::npos, "unloaded backends drop out of the cache");
+}
+
+static void test_idle_park_keeps_cache(TestResult& r) {
+    std::vector<BackendMetricsCollector::Target> targets = {
+        target("http://127.0.0.1:8001/v1", "llamacpp", "a"),
+        target("http://127.0.0.1:8002/v1", "llamacpp", "b"),
+    };
+    std::mutex targets_mutex;
+    std::atomic<int> fetches{0};
+
+    BackendMetricsCollector collector(
+        [&] {
+            std::lock_guard<std::mutex> lock(targets_mutex);
+            return targets;
+        },
+        [&](const std::string&, int& status, std::string& body) {
+            fetches++;
+            status = 200;
+            body = kLlamaMetrics;
+            return true;
+        },
+        100, std::chrono::seconds(1));
+    collector.start();
+
+    // The first render wakes the collector; wait for its first round
+    collector.render();
+    for (int i = 0; i < 50 && fetches < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    // Let it park, and unload one backend while it is parked
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    {
+        std::lock_guard<std::mutex> lock(targets_mutex);
+        targets.pop_back();
+    }
+    const int parked_fetches = fetches;
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    r.check(fetches == parked_fetches, "an idle collector stops scraping");
+
+    BackendMetricsCollector::Snapshot snapshot = collector.render();
+    r.check(snapshot.text.find("model_name=\"a\"") != std::string::npos,
+            "the first render after parking returns the last sample");
+    r.check(snapshot.text.find("model_name=\"b\"") == std::string::npos,
+            "backends unloaded while parked are not served");
+    collector.stop();
+}
+
+int main() {
+    TestResult r;
+    test_rewrite(r);
+    test_federation(r);
+    test_idle_park_keeps_cache(r);
+
+    printf("\n%d passed, %d failed\n", r.passed, r.failed);
+    return r.failed == 0 ? 0 : 1;
+}
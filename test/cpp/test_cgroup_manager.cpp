@@ -0,0 +1,123 @@
+// Standalone test for the per-backend cgroup manager.
+//
+// Checks the limits derived from a model's priority and expected size, the
+// memory.events parsing and deltas that drive pressure handling, and that a
+// backend leaf is created with its limits and process in a cgroup tree (a
+// plain directory here, since the test cannot assume a writable cgroupfs).
+//
+// Compile with:
+//   g++ -std=c++17 -I src/cpp/include test/cpp/test_cgroup_manager.cpp src/cpp/server/cgroup_manager.cpp -o cgroup_manager_test -pthread
+
+#include "lemon/cgroup_manager.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace fs = std::filesystem;
+using lemon::CgroupLimits;
+using lemon::CgroupManager;
+using lemon::CgroupMemoryEvents;
+
+struct TestResult {
+    int passed = 0;
+    int failed = 0;
+
+    void check(bool cond, const std::string& name) {
+        if (cond) {
+            printf("[PASS] %s\n", name.c_str());
+            ++passed;
+        } else {
+            printf("[FAIL] %s\n", name.c_str());
+            ++failed;
+        }
+    }
+};
+
+static std::string read_file(const fs::path& path) {
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+static void test_limits(TestResult& r) {
+    const int64_t gib = 1024LL * 1024 * 1024;
+    const CgroupLimits interactive = CgroupLimits::for_backend(true, 4 * gib);
+    r.check(interactive.memory_low == 4 * gib && interactive.memory_high < 0 && interactive.memory_max < 0,
+            "interactive backends get their expected memory protected and no ceiling");
+
+    const CgroupLimits batch = CgroupLimits::for_backend(false, 4 * gib);
+    r.check(batch.memory_low == 0 && batch.memory_high > 4 * gib && batch.memory_max < 0,
+            "batch backends are throttled above their size but never hard-capped");
+    r.check(interactive.cpu_weight > 100 && batch.cpu_weight < 100,
+            "interactive backends outweigh batch ones for CPU");
+
+    const CgroupLimits unknown = CgroupLimits::for_backend(false, 0);
+    r.check(unknown.memory_high < 0 && unknown.memory_max < 0, "an unknown size leaves memory unlimited");
+}
+
+static void test_events(TestResult& r) {
+    const CgroupMemoryEvents before = lemon::parse_memory_events("low 0\nhigh 3\nmax 0\noom 0\noom_kill 0\noom_group_kill 0\n");
+    r.check(before.high == 3 && before.max == 0, "memory.events counters are parsed");
+
+    const CgroupMemoryEvents throttled = lemon::parse_memory_events("low 0\nhigh 5\nmax 0\noom 0\noom_kill 0\n").since(before);
+    r.check(throttled.high == 2 && throttled.any() && !throttled.hard(), "throttling is pressure below the hard limit");
+
+    const CgroupMemoryEvents killed = lemon::parse_memory_events("low 0\nhigh 5\nmax 1\noom 1\noom_kill 1\n").since(before);
+    r.check(killed.hard(), "hitting memory.max is a hard limit");
+
+    r.check(!before.since(before).any() && !lemon::parse_memory_events("high 1").since(before).any(),
+            "unchanged or reset counters report nothing");
+}
+
+static void test_leaves(TestResult& r) {
+    const fs::path base = fs::temp_directory_path() / "lemonade_cgroup_test";
+    fs::remove_all(base);
+    fs::create_directories(base);
+
+    {
+        CgroupManager manager(base.string());
+        r.check(manager.available(), "a manager with a base directory is available");
+
+        const std::string leaf = manager.attach("user.Qwen3 0.6B/GGUF", 4242, CgroupLimits::for_backend(false, 1024 * 1024 * 1024));
+        r.check(fs::path(leaf).parent_path() == base && fs::path(leaf).filename() == "user.Qwen3_0.6B_GGUF-4242",
+                "a leaf is named after the model and PID");
+        r.check(read_file(fs::path(leaf) / "cgroup.procs") == "4242", "the process is moved into its leaf");
+        r.check(read_file(fs::path(leaf) / "memory.high") == std::to_string(2LL * 1024 * 1024 * 1024) &&
+                read_file(fs::path(leaf) / "memory.max") == "max" &&
+                read_file(fs::path(leaf) / "cpu.weight") == "50" &&
+                read_file(fs::path(leaf) / "memory.oom.group") == "1",
+                "limits are written to the leaf");
+
+        r.check(CgroupManager::memory_current(leaf) == -1, "a leaf without memory.current reports unknown");
+        std::ofstream(fs::path(leaf) / "memory.current") << "123456789\n";
+        r.check(CgroupManager::memory_current(leaf) == 123456789, "memory.current is read per leaf");
+
+        const std::string interactive = manager.attach("chat", 77, CgroupLimits::for_backend(true, 0));
+        r.check(read_file(fs::path(interactive) / "memory.high") == "max" &&
+                !fs::exists(fs::path(interactive) / "memory.low"),
+                "unlimited values are written as max and unset protection is skipped");
+
+        manager.release(leaf);
+        manager.release(interactive);
+    }
+
+    CgroupManager disabled("");
+    r.check(!disabled.available() && disabled.attach("model", 1, {}).empty() &&
+            CgroupManager::memory_current("") == -1,
+            "without cgroups nothing is attached");
+    fs::remove_all(base);
+}
+
+int main() {
+    TestResult r;
+    test_limits(r);
+    test_events(r);
+    test_leaves(r);
+
+    printf("\n%d passed, %d failed\n", r.passed, r.failed);
+    return r.failed == 0 ? 0 : 1;
+}
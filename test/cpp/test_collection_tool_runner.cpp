@@ -0,0 +1,190 @@
+// Standalone test for the collection-mode omni tool runner.
+//
+// Stands in for the router and the model loader with stubs, then checks that
+// an edit waits for the image calls before it and edits their result, that
+// outcomes are committed in call order however the backends finish, the
+// tool_timings fields, skipped and failing calls, and that a throwing commit
+// still waits for every worker.
+//
+// Compile with:
+//   g++ -std=c++17 -I src/cpp/include test/cpp/test_collection_tool_runner.cpp src/cpp/server/collection_tool_runner.cpp -o collection_tool_runner_test -pthread
+
+#include "lemon/collection_tool_runner.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using lemon::CollectionArtifact;
+using lemon::CollectionToolRunner;
+
+struct TestResult {
+    int passed = 0;
+    int failed = 0;
+
+    void check(bool cond, const std::string& name) {
+        if (cond) {
+            printf("[PASS] %s\n", name.c_str());
+            ++passed;
+        } else {
+            printf("[FAIL] %s\n", name.c_str());
+            ++failed;
+        }
+    }
+};
+
+// Plays the router: a slow image model, a fast TTS voice and an edit model
+// that reports which image it was given.
+struct StubBackends {
+    std::mutex mutex;
+    std::vector<std::string> loaded;
+    std::vector<std::string> finished;
+    std::atomic<int> running{0};
+
+    CollectionToolRunner runner() {
+        return CollectionToolRunner(
+            [this](const std::string& model) {
+                std::lock_guard<std::mutex> lock(mutex);
+                loaded.push_back(model);
+            },
+            [this](const CollectionToolRunner::Call& call, const std::string& source_b64,
+                   const std::string&, std::optional<CollectionArtifact>& produced, std::string& text) {
+                ++running;
+                bool ok = true;
+                if (call.name == "generate_image") {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+                    produced = CollectionArtifact{"image", call.args.value("prompt", ""), "image/png"};
+                    text = "Image generated successfully.";
+                } else if (call.name == "edit_image") {
+                    if (source_b64.empty()) {
+                        --running;
+                        throw std::runtime_error("no source image");
+                    }
+                    produced = CollectionArtifact{"image", source_b64 + "+edited", "image/png"};
+                    text = "Image edited successfully.";
+                } else if (call.name == "text_to_speech") {
+                    produced = CollectionArtifact{"audio", "speech", "audio/mpeg"};
+                    text = "Audio generated successfully.";
+                } else {
+                    text = "Unknown tool: " + call.name;
+                    ok = false;
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                finished.push_back(call.name);
+                --running;
+                return ok;
+            });
+    }
+};
+
+static CollectionToolRunner::Call make_call(const std::string& name, const std::string& model,
+                                            const std::string& prompt = "") {
+    CollectionToolRunner::Call call;
+    call.name = name;
+    call.model = model;
+    call.args = {{"prompt", prompt}};
+    return call;
+}
+
+static void test_edit_waits_for_generate(TestResult& r) {
+    StubBackends stub;
+    std::vector<CollectionToolRunner::Call> calls = {
+        make_call("generate_image", "sd", "cat"),
+        make_call("text_to_speech", "kokoro"),
+        make_call("edit_image", "sd-edit"),
+    };
+    calls[2].deps = {0};
+
+    std::vector<size_t> committed;
+    std::vector<CollectionToolRunner::Outcome> outcomes;
+    stub.runner().run(calls, "", "image/png", [&](size_t i, const CollectionToolRunner::Outcome& out) {
+        committed.push_back(i);
+        outcomes.push_back(out);
+    });
+
+    r.check(committed == std::vector<size_t>({0, 1, 2}), "outcomes are committed in call order");
+    r.check(stub.finished.size() == 3 && stub.finished[0] == "text_to_speech",
+            "independent calls run concurrently (the fast TTS finishes first)");
+    r.check(outcomes[2].produced && outcomes[2].produced->data == "cat+edited",
+            "an edit operates on the image its dependency generated");
+    r.check(outcomes[2].wait_ms >= 50.0 && outcomes[1].wait_ms < 50.0,
+            "only the dependent call reports waiting");
+    r.check(stub.loaded.size() == 3, "every component is loaded before it runs");
+
+    const auto& timing = outcomes[2].timing;
+    r.check(timing["tool"] == "edit_image" && timing["model"] == "sd-edit" && timing["status"] == "ok" &&
+            timing.contains("wait_ms") && timing.contains("load_ms") && timing.contains("execute_ms"),
+            "timings carry tool, model, status and the three phases");
+    r.check(outcomes[0].timing["execute_ms"].get<double>() >= 50.0,
+            "execute_ms covers the backend call");
+}
+
+static void test_prior_image_skip_and_error(TestResult& r) {
+    StubBackends stub;
+    std::vector<CollectionToolRunner::Call> calls = {
+        make_call("edit_image", "sd-edit"),
+        make_call("generate_image", ""),
+        make_call("bogus", "x"),
+    };
+    calls[1].skip = true;
+
+    std::vector<CollectionToolRunner::Outcome> outcomes;
+    stub.runner().run(calls, "history", "image/jpeg", [&](size_t, const CollectionToolRunner::Outcome& out) {
+        outcomes.push_back(out);
+    });
+
+    r.check(outcomes.size() == 3 && outcomes[0].produced && outcomes[0].produced->data == "history+edited",
+            "an edit with no dependency uses the prior image");
+    r.check(outcomes[1].timing["status"] == "skipped" && !outcomes[1].timing.contains("execute_ms") &&
+            stub.loaded.size() == 2,
+            "skipped calls are reported but never loaded or run");
+    r.check(outcomes[2].timing["status"] == "error" && !outcomes[2].ok,
+            "a call the backend rejects is reported as an error");
+
+    StubBackends failing;
+    std::vector<CollectionToolRunner::Call> edit_only = {make_call("edit_image", "sd-edit")};
+    CollectionToolRunner::Outcome failed;
+    failing.runner().run(edit_only, "", "image/png", [&](size_t, const CollectionToolRunner::Outcome& out) {
+        failed = out;
+    });
+    r.check(!failed.ok && failed.text == "Error: no source image" && !failed.produced,
+            "a throwing backend becomes an error outcome");
+}
+
+static void test_throwing_commit_waits_for_workers(TestResult& r) {
+    StubBackends stub;
+    std::vector<CollectionToolRunner::Call> calls = {
+        make_call("text_to_speech", "kokoro"),
+        make_call("generate_image", "sd", "dog"),
+        make_call("edit_image", "sd-edit"),
+    };
+    calls[2].deps = {1};
+
+    bool threw = false;
+    try {
+        stub.runner().run(calls, "", "image/png", [&](size_t, const CollectionToolRunner::Outcome&) {
+            throw std::runtime_error("client went away");
+        });
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    r.check(threw, "a commit error propagates to the caller");
+    r.check(stub.running == 0 && stub.finished.size() == 3,
+            "every worker has finished before run() returns");
+}
+
+int main() {
+    TestResult r;
+    test_edit_waits_for_generate(r);
+    test_prior_image_skip_and_error(r);
+    test_throwing_commit_waits_for_workers(r);
+
+    printf("\n%d passed, %d failed\n", r.passed, r.failed);
+    return r.failed == 0 ? 0 : 1;
+}
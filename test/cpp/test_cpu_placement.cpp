@@ -0,0 +1,145 @@
+// Standalone test for the CPU placement planner.
+//
+// Builds a fake sysfs tree for a two-node host (4 cores per node, 2 SMT
+// threads per core) and checks that the topology is read per physical core,
+// that reservations stay on one NUMA node when they fit (best fit first),
+// span nodes only when they must, and that released cores are reused.
+//
+// Compile with:
+//   g++ -std=c++17 -I src/cpp/include test/cpp/test_cpu_placement.cpp src/cpp/server/cpu_placement.cpp -o cpu_placement_test
+
+#include "lemon/cpu_placement.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using lemon::CpuPlacementPlanner;
+using lemon::CpuTopology;
+
+struct TestResult {
+    int passed = 0;
+    int failed = 0;
+
+    void check(bool cond, const std::string& name) {
+        if (cond) {
+            printf("[PASS] %s\n", name.c_str());
+            ++passed;
+        } else {
+            printf("[FAIL] %s\n", name.c_str());
+            ++failed;
+        }
+    }
+};
+
+static void write_file(const fs::path& path, const std::string& content) {
+    fs::create_directories(path.parent_path());
+    std::ofstream(path) << content << "\n";
+}
+
+// CPUs 0-7 are the first SMT thread of cores 0-7, CPUs 8-15 their siblings.
+// Cores 0-3 sit on node 0 and cores 4-7 on node 1. Node 2 has memory only.
+static fs::path make_sysfs() {
+    const fs::path root = fs::temp_directory_path() / "lemonade_cpu_placement_test";
+    fs::remove_all(root);
+    write_file(root / "cpu" / "online", "0-15");
+    for (int cpu = 0; cpu < 16; ++cpu) {
+        const fs::path topo = root / "cpu" / ("cpu" + std::to_string(cpu)) / "topology";
+        write_file(topo / "physical_package_id", "0");
+        write_file(topo / "core_id", std::to_string(cpu % 8));
+    }
+    write_file(root / "node" / "node0" / "cpulist", "0-3,8-11");
+    write_file(root / "node" / "node1" / "cpulist", "4-7,12-15");
+    write_file(root / "node" / "node2" / "cpulist", "");
+    write_file(root / "node" / "possible", "0-2");
+    return root;
+}
+
+static void test_cpu_lists(TestResult& r) {
+    r.check(lemon::parse_cpu_list("0-3,8, 10-11") == std::vector<int>({0, 1, 2, 3, 8, 10, 11}),
+            "cpu lists with ranges and spaces are parsed");
+    r.check(lemon::parse_cpu_list("3-1").empty() && lemon::parse_cpu_list("x").empty(),
+            "malformed cpu lists parse as empty");
+    r.check(lemon::format_cpu_list({11, 0, 2, 1, 10, 8}) == "0-2,8,10-11",
+            "cpu lists are formatted as sorted ranges");
+}
+
+static void test_topology(TestResult& r, const fs::path& root) {
+    const CpuTopology topology = CpuTopology::read_sysfs(root.string());
+    r.check(topology.cores.size() == 8 && topology.node_count == 2,
+            "SMT siblings form one core and memory-only nodes are skipped");
+    r.check(topology.cores[0].cpus == std::vector<int>({0, 8}) && topology.cores[4].node == 1,
+            "cores are ordered by node and carry their siblings");
+    r.check(topology.cores_on_node(1) == 4 && topology.largest_node_cores() == 4,
+            "cores are counted per node");
+    r.check(CpuTopology::read_sysfs((root / "missing").string()).cores.empty(),
+            "an unreadable layout gives an empty topology");
+}
+
+static void test_reservations(TestResult& r, const fs::path& root) {
+    CpuPlacementPlanner planner(CpuTopology::read_sysfs(root.string()));
+
+    const auto a = planner.reserve(1, "a", 3);
+    r.check(a.physical_cores == 3 && a.numa_node == 0 && a.cpus == std::vector<int>({0, 1, 2, 8, 9, 10}),
+            "a reservation gets whole cores on one node");
+
+    // Node 0 has one core left and node 1 has four: best fit picks node 0
+    const auto b = planner.reserve(2, "b", 1);
+    r.check(b.numa_node == 0 && b.cpus == std::vector<int>({3, 11}),
+            "small requests fill the fullest node that fits them");
+
+    const auto c = planner.reserve(3, "c", 4);
+    r.check(c.numa_node == 1 && c.physical_cores == 4, "a node-sized request gets the free node");
+
+    r.check(planner.reserve(4, "d", 2).empty(), "requests without free cores run unplaced");
+
+    planner.release(1);
+    planner.release(3);
+    const auto e = planner.reserve(5, "e", 6);
+    r.check(e.physical_cores == 6 && e.numa_node == 1,
+            "requests larger than any node span nodes, memory on the largest share");
+
+    const auto e2 = planner.reserve(5, "e", 2);
+    r.check(e2.physical_cores == 2 && planner.to_json()["free_cores"] == 5,
+            "reserving again replaces the owner's cores");
+
+    const auto json = planner.to_json();
+    r.check(json["assignments"].size() == 2 && json["assignments"][0]["label"] == "b" &&
+            json["assignments"][0]["cpus"] == "3,11",
+            "assignments are reported by label");
+
+    planner.release(2);
+    planner.release(5);
+    planner.reserve(6, "f", 5);
+    r.check(planner.reserve(7, "g", 7).empty(), "requests that would get under half their cores run unplaced");
+}
+
+static void test_demand_and_disabled(TestResult& r, const fs::path& root) {
+    CpuPlacementPlanner planner(CpuTopology::read_sysfs(root.string()));
+    r.check(planner.core_demand("llamacpp", 0, 1) == 4 && planner.core_demand("llamacpp", 0, 2) == 2,
+            "LLM backends default to a node shared between replicas");
+    r.check(planner.core_demand("llamacpp", 6, 1) == 6 && planner.core_demand("sd-cpp", 20, 1) == 8,
+            "configured threads size the request, capped at the host");
+    r.check(planner.core_demand("whispercpp", 0, 1) == 4 && planner.core_demand("flm", 0, 1) == 0,
+            "speech backends get 4 cores and NPU backends none");
+
+    CpuPlacementPlanner disabled(CpuTopology::read_sysfs(root.string()), false);
+    r.check(disabled.reserve(1, "a", 2).empty() && disabled.to_json()["enabled"] == false,
+            "a disabled planner places nothing");
+}
+
+int main() {
+    TestResult r;
+    const fs::path root = make_sysfs();
+    test_cpu_lists(r);
+    test_topology(r, root);
+    test_reservations(r, root);
+    test_demand_and_disabled(r, root);
+    fs::remove_all(root);
+
+    printf("\n%d passed, %d failed\n", r.passed, r.failed);
+    return r.failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,236 @@
+// Standalone test for lemon::EmbeddingBatcher.
+//
+// Fires concurrent embeddings/rerank requests through the coalescer against a
+// fake backend and checks that they are combined into one call and that the
+// scatter step hands each caller its own results, re-indexed from zero, with
+// the backend's usage apportioned so per-caller totals add up.
+//
+// Compile with:
+//   g++ -std=c++17 -pthread -I src/cpp/include test/cpp/test_embedding_batcher.cpp src/cpp/server/embedding_batcher.cpp -o embedding_batcher_test
+
+#include "lemon/embedding_batcher.h"
+
+#include <atomic>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using lemon::EmbeddingBatcher;
+using json = nlohmann::json;
+
+struct TestResult {
+    int passed = 0;
+    int failed = 0;
+
+    void check(bool cond, const std::string& name) {
+        if (cond) {
+            printf("[PASS] %s\n", name.c_str());
+            ++passed;
+        } else {
+            printf("[FAIL] %s\n", name.c_str());
+            ++failed;
+        }
+    }
+};
+
+// Fake llama.cpp /v1/embeddings: embedding = [input length], 3 tokens per input.
+static json fake_embeddings(const json& request, std::atomic<int>& calls) {
+    calls++;
+    json data = json::array();
+    const json& input = request["input"];
+    json items = input.is_array() ? input : json::array({input});
+    for (size_t i = 0; i < items.size(); ++i) {
+        data.push_back({{"object", "embedding"}, {"index", i},
+                        {"embedding", {static_cast<double>(items[i].get<std::string>().size())}}});
+    }
+    int tokens = static_cast<int>(items.size()) * 3;
+    return {{"object", "list"}, {"data", data}, {"model", request["model"]},
+            {"usage", {{"prompt_tokens", tokens}, {"total_tokens", tokens}}}};
+}
+
+// Fake /v1/rerank: relevance_score = document length.
+static json fake_rerank(const json& request, std::atomic<int>& calls) {
+    calls++;
+    json results = json::array();
+    const json& docs = request["documents"];
+    for (size_t i = 0; i < docs.size(); ++i) {
+        results.push_back({{"index", i},
+                           {"relevance_score", static_cast<double>(docs[i].get<std::string>().size())}});
+    }
+    return {{"results", results}, {"usage", {{"prompt_tokens", 10}, {"total_tokens", 10}}}};
+}
+
+static void test_disabled_passthrough(TestResult& r) {
+    EmbeddingBatcher batcher;
+    std::atomic<int> calls{0};
+    EmbeddingBatcher::Limits limits;  // window_ms = 0
+    json req = {{"model", "m"}, {"input", "hello"}};
+    json res = batcher.submit(EmbeddingBatcher::Kind::Embeddings, req, limits,
+                              [&](const json& q) { return fake_embeddings(q, calls); });
+    r.check(calls == 1 && res["data"].size() == 1, "disabled batcher forwards request unchanged");
+}
+
+static void test_concurrent_embeddings_coalesce(TestResult& r) {
+    EmbeddingBatcher batcher;
+    std::atomic<int> calls{0};
+    EmbeddingBatcher::Limits limits;
+    limits.window_ms = 200;
+
+    const int kCallers = 4;
+    std::vector<json> results(kCallers);
+    std::vector<std::thread> threads;
+    for (int c = 0; c < kCallers; ++c) {
+        threads.emplace_back([&, c] {
+            // Caller c sends c+1 inputs of length (c+1)*10 + k.
+            json input = json::array();
+            for (int k = 0; k <= c; ++k) {
+                input.push_back(std::string(static_cast<size_t>((c + 1) * 10 + k), 'x'));
+            }
+            json req = {{"model", "embed"}, {"input", input}};
+            results[c] = batcher.submit(EmbeddingBatcher::Kind::Embeddings, req, limits,
+                                        [&](const json& q) { return fake_embeddings(q, calls); });
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    r.check(calls == 1, "concurrent embeddings share one backend call");
+
+    bool shapes_ok = true;
+    long long prompt_sum = 0;
+    for (int c = 0; c < kCallers; ++c) {
+        const json& data = results[c]["data"];
+        if (!data.is_array() || data.size() != static_cast<size_t>(c + 1)) {
+            shapes_ok = false;
+            continue;
+        }
+        for (int k = 0; k <= c; ++k) {
+            if (data[k]["index"] != k ||
+                data[k]["embedding"][0].get<double>() != static_cast<double>((c + 1) * 10 + k)) {
+                shapes_ok = false;
+            }
+        }
+        prompt_sum += results[c]["usage"]["prompt_tokens"].get<long long>();
+    }
+    r.check(shapes_ok, "each caller receives its own embeddings re-indexed from 0");
+    r.check(prompt_sum == 3 * (1 + 2 + 3 + 4), "apportioned usage sums to backend total");
+
+    json stats = batcher.get_stats()["embeddings"];
+    r.check(stats["requests_total"] == kCallers && stats["batches_total"] == 1,
+            "stats count requests and backend calls");
+}
+
+static void test_max_batch_size_flushes(TestResult& r) {
+    EmbeddingBatcher batcher;
+    std::atomic<int> calls{0};
+    EmbeddingBatcher::Limits limits;
+    limits.window_ms = 10000;  // Only the size cap can release the batch in time
+    limits.max_batch_size = 2;
+
+    std::vector<std::thread> threads;
+    std::atomic<int> ok{0};
+    for (int c = 0; c < 2; ++c) {
+        threads.emplace_back([&] {
+            json req = {{"model", "embed"}, {"input", "abc"}};
+            json res = batcher.submit(EmbeddingBatcher::Kind::Embeddings, req, limits,
+                                      [&](const json& q) { return fake_embeddings(q, calls); });
+            if (res["data"].size() == 1) ok++;
+        });
+    }
+    for (auto& t : threads) t.join();
+    r.check(calls == 1 && ok == 2, "reaching max_batch_size dispatches without waiting for the window");
+}
+
+static void test_rerank_scatter_and_top_n(TestResult& r) {
+    EmbeddingBatcher batcher;
+    std::atomic<int> calls{0};
+    EmbeddingBatcher::Limits limits;
+    limits.window_ms = 200;
+
+    json a, b;
+    std::thread ta([&] {
+        json req = {{"model", "rr"}, {"query", "q"}, {"documents", {"a", "aaa", "aa"}}, {"top_n", 2}};
+        a = batcher.submit(EmbeddingBatcher::Kind::Reranking, req, limits,
+                           [&](const json& q) { return fake_rerank(q, calls); });
+    });
+    std::thread tb([&] {
+        json req = {{"model", "rr"}, {"query", "q"}, {"documents", {"bbbb", "b"}}};
+        b = batcher.submit(EmbeddingBatcher::Kind::Reranking, req, limits,
+                           [&](const json& q) { return fake_rerank(q, calls); });
+    });
+    ta.join();
+    tb.join();
+
+    r.check(calls == 1, "rerank requests with the same query share one backend call");
+    r.check(a["results"].size() == 2 && a["results"][0]["index"] == 1 && a["results"][1]["index"] == 2,
+            "rerank results are re-indexed, sorted and truncated to the caller's top_n");
+    r.check(b["results"].size() == 2 && b["results"][0]["index"] == 0,
+            "second caller gets only its own documents");
+}
+
+static void test_rerank_single_request_sorted(TestResult& r) {
+    EmbeddingBatcher batcher;
+    std::atomic<int> calls{0};
+    EmbeddingBatcher::Limits limits;
+    limits.window_ms = 20;
+
+    json req = {{"model", "rr"}, {"query", "q"}, {"documents", {"a", "aaa", "aa"}}};
+    json batched = batcher.submit(EmbeddingBatcher::Kind::Reranking, req, limits,
+                                  [&](const json& q) { return fake_rerank(q, calls); });
+    json direct = batcher.submit(EmbeddingBatcher::Kind::Reranking, req, EmbeddingBatcher::Limits{},
+                                 [&](const json& q) { return fake_rerank(q, calls); });
+    r.check(batched["results"][0]["index"] == 1 && batched["results"][2]["index"] == 0,
+            "a rerank request alone in its batch is sorted by relevance");
+    r.check(direct["results"] == fake_rerank(req, calls)["results"],
+            "rerank results keep backend order when coalescing is disabled");
+}
+
+static void test_backend_error_propagates(TestResult& r) {
+    EmbeddingBatcher batcher;
+    EmbeddingBatcher::Limits limits;
+    limits.window_ms = 200;
+
+    std::atomic<int> threw{0};
+    std::vector<std::thread> threads;
+    for (int c = 0; c < 3; ++c) {
+        threads.emplace_back([&] {
+            json req = {{"model", "embed"}, {"input", "abc"}};
+            try {
+                batcher.submit(EmbeddingBatcher::Kind::Embeddings, req, limits,
+                               [](const json&) -> json { throw std::runtime_error("backend down"); });
+            } catch (const std::runtime_error&) {
+                threw++;
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    r.check(threw == 3, "backend exception is rethrown to every caller in the batch");
+}
+
+static void test_group_keys(TestResult& r) {
+    using K = EmbeddingBatcher::Kind;
+    r.check(EmbeddingBatcher::group_key(K::Embeddings, {{"model", "m"}, {"input", "a"}}) ==
+                EmbeddingBatcher::group_key(K::Embeddings, {{"model", "m"}, {"input", {"b", "c"}}}),
+            "text inputs of the same model share a group");
+    r.check(EmbeddingBatcher::group_key(K::Embeddings, {{"model", "m"}, {"input", "a"}}) !=
+                EmbeddingBatcher::group_key(K::Embeddings, {{"model", "m"}, {"input", {1, 2}}}),
+            "token inputs are not mixed with text inputs");
+    r.check(EmbeddingBatcher::group_key(K::Reranking, {{"model", "m"}, {"query", "x"}, {"documents", {"a"}}}) !=
+                EmbeddingBatcher::group_key(K::Reranking, {{"model", "m"}, {"query", "y"}, {"documents", {"a"}}}),
+            "rerank requests with different queries are not combined");
+}
+
+int main() {
+    TestResult r;
+    test_disabled_passthrough(r);
+    test_concurrent_embeddings_coalesce(r);
+    test_max_batch_size_flushes(r);
+    test_rerank_scatter_and_top_n(r);
+    test_rerank_single_request_sorted(r);
+    test_backend_error_propagates(r);
+    test_group_keys(r);
+
+    printf("\n%d passed, %d failed\n", r.passed, r.failed);
+    return r.failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+// Standalone test for lemon::EmbeddingCache.
+//
+// Covers the float32 packing round trip, key separation by checkpoint /
+// options / input, LRU eviction under the memory budget, and the on-disk
+// tier surviving a fresh cache instance (i.e. a server restart).
+//
+// Compile with (mbedcrypto from libmbedtls-dev):
+//   g++ -std=c++17 -I src/cpp/include test/cpp/test_embedding_cache.cpp src/cpp/server/embedding_cache.cpp -lmbedcrypto -o embedding_cache_test
+
+#include "lemon/embedding_cache.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+using lemon::EmbeddingCache;
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+struct TestResult {
+    int passed = 0;
+    int failed = 0;
+
+    void check(bool cond, const std::string& name) {
+        if (cond) {
+            printf("[PASS] %s\n", name.c_str());
+            ++passed;
+        } else {
+            printf("[FAIL] %s\n", name.c_str());
+            ++failed;
+        }
+    }
+};
+
+static void test_encode_roundtrip(TestResult& r) {
+    json vec = {0.25, -1.5, 3.0};
+    std::string blob = EmbeddingCache::encode(vec);
+    json out;
+    r.check(blob.size() == 1 + 3 * sizeof(float), "float vectors are packed as float32");
+    r.check(EmbeddingCache::decode(blob.data(), blob.size(), out) && out == vec,
+            "float32 blob decodes to the original vector");
+
+    json b64 = "AAAAPw==";
+    blob = EmbeddingCache::encode(b64);
+    r.check(EmbeddingCache::decode(blob.data(), blob.size(), out) && out == b64,
+            "base64 embeddings round-trip as JSON");
+    r.check(!EmbeddingCache::decode("F12", 3, out), "truncated float blob is rejected");
+}
+
+static void test_keys(TestResult& r) {
+    json opts = {{"encoding_format", "float"}};
+    std::string base = EmbeddingCache::make_key("ckpt-a", opts, "hello");
+    r.check(base.size() == 64, "key is a hex SHA-256");
+    r.check(base == EmbeddingCache::make_key("ckpt-a", opts, "hello"), "key is deterministic");
+    r.check(base != EmbeddingCache::make_key("ckpt-b", opts, "hello"), "checkpoint is part of the key");
+    r.check(base != EmbeddingCache::make_key("ckpt-a", {{"encoding_format", "base64"}}, "hello"),
+            "request options are part of the key");
+    r.check(base != EmbeddingCache::make_key("ckpt-a", opts, "hello!"), "input is part of the key");
+}
+
+static void test_memory_lru(TestResult& r) {
+    EmbeddingCache cache;
+    json out;
+    cache.configure(0, 0, "");
+    cache.insert("k", json{1.0});
+    r.check(!cache.enabled() && !cache.lookup("k", 1, out), "zero budget disables the cache");
+
+    // Each 4-float vector packs to 17 bytes; a 40 byte budget holds two.
+    cache.configure(40, 0, "");
+    cache.insert("a", json{1.0, 2.0, 3.0, 4.0});
+    cache.insert("b", json{5.0, 6.0, 7.0, 8.0});
+    r.check(cache.lookup("a", 10, out) && out[0] == 1.0, "hit returns the stored vector");
+    cache.insert("c", json{9.0, 9.0, 9.0, 9.0});  // Evicts b (a was just used)
+    r.check(!cache.lookup("b", 10, out), "least recently used entry is evicted");
+    r.check(cache.lookup("a", 10, out) && cache.lookup("c", 10, out), "recent entries survive");
+
+    json stats = cache.get_stats();
+    r.check(stats["hits"] == 3 && stats["misses"] == 1 && stats["bytes_saved"] == 30,
+            "stats count hits, misses and bytes saved");
+    r.check(stats["memory_bytes"].get<size_t>() <= 40, "memory stays within budget");
+}
+
+static void test_disk_tier(TestResult& r) {
+    fs::path dir = fs::temp_directory_path() / "lemonade_embedding_cache_test";
+    fs::remove_all(dir);
+
+    {
+        EmbeddingCache cache;
+        cache.configure(1024, 1024, dir.string());
+        cache.insert("abcdef", json{0.5, 0.75});
+    }
+
+    EmbeddingCache restarted;
+    restarted.configure(1024, 1024, dir.string());
+    json out;
+    r.check(restarted.lookup("abcdef", 4, out) && out == json({0.5, 0.75}),
+            "disk tier serves entries written by a previous instance");
+    r.check(restarted.get_stats()["disk_hits"] == 1, "disk hits are counted");
+
+    // Shrinking the disk budget below one entry trims the files.
+    restarted.configure(1024, 1, dir.string());
+    r.check(restarted.get_stats()["disk_entries"] == 0 && !fs::exists(dir / "ab" / "abcdef.bin"),
+            "disk tier is trimmed to its budget");
+
+    fs::remove_all(dir);
+}
+
+int main() {
+    TestResult r;
+    test_encode_roundtrip(r);
+    test_keys(r);
+    test_memory_lru(r);
+    test_disk_tier(r);
+
+    printf("\n%d passed, %d failed\n", r.passed, r.failed);
+    return r.failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,318 @@
+// Standalone test for lemon::GgufTokenizer.
+//
+// Writes small GGUF files holding a SentencePiece and a byte-level BPE
+// vocabulary and checks the ids against what llama.cpp's algorithms give for
+// them: score-ordered SPM merges with space prefix and <0xXX> byte fallback,
+// ranked BPE merges inside llama3 / qwen2 / gpt-2 pre-tokenizer words, and
+// special-token splitting. Also checks that the cache reads a file once and
+// remembers unsupported vocabularies.
+//
+// Compile with:
+//   g++ -std=c++17 -I src/cpp/include test/cpp/test_gguf_tokenizer.cpp src/cpp/server/gguf_tokenizer.cpp -o gguf_tokenizer_test
+
+#include "lemon/gguf_tokenizer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+using lemon::GgufTokenizer;
+namespace fs = std::filesystem;
+
+struct TestResult {
+    int passed = 0;
+    int failed = 0;
+
+    void check(bool cond, const std::string& name) {
+        if (cond) {
+            printf("[PASS] %s\n", name.c_str());
+            ++passed;
+        } else {
+            printf("[FAIL] %s\n", name.c_str());
+            ++failed;
+        }
+    }
+};
+
+// Minimal GGUF v3 writer: KV header only, no tensors
+class GgufWriter {
+public:
+    void add_string(const std::string& key, const std::string& value) {
+        begin(key, 8);
+        put_string(value);
+    }
+    void add_strings(const std::string& key, const std::vector<std::string>& values) {
+        begin(key, 9);
+        put<uint32_t>(8);
+        put<uint64_t>(values.size());
+        for (const auto& v : values) put_string(v);
+    }
+    void add_floats(const std::string& key, const std::vector<float>& values) {
+        begin(key, 9);
+        put<uint32_t>(6);
+        put<uint64_t>(values.size());
+        for (float v : values) put(v);
+    }
+    void add_int32s(const std::string& key, const std::vector<int32_t>& values) {
+        begin(key, 9);
+        put<uint32_t>(5);
+        put<uint64_t>(values.size());
+        for (int32_t v : values) put(v);
+    }
+    void add_uint32(const std::string& key, uint32_t value) {
+        begin(key, 4);
+        put(value);
+    }
+    void add_bool(const std::string& key, bool value) {
+        begin(key, 7);
+        put<uint8_t>(value ? 1 : 0);
+    }
+
+    void save(const fs::path& path) const {
+        std::ofstream out(path, std::ios::binary);
+        out.write("GGUF", 4);
+        const uint32_t version = 3;
+        const uint64_t tensors = 0;
+        out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        out.write(reinterpret_cast<const char*>(&tensors), sizeof(tensors));
+        out.write(reinterpret_cast<const char*>(&kv_count_), sizeof(kv_count_));
+        out.write(body_.data(), static_cast<std::streamsize>(body_.size()));
+    }
+
+private:
+    template <typename T>
+    void put(T value) {
+        body_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    void put_string(const std::string& s) {
+        put<uint64_t>(s.size());
+        body_ += s;
+    }
+    void begin(const std::string& key, uint32_t type) {
+        put_string(key);
+        put(type);
+        ++kv_count_;
+    }
+
+    std::string body_;
+    uint64_t kv_count_ = 0;
+};
+
+struct Vocab {
+    std::vector<std::string> tokens;
+    std::vector<float> scores;
+    std::vector<int32_t> types;
+    std::map<std::string, int32_t> ids;
+
+    int32_t add(const std::string& text, int32_t type = 1, float score = 0.0f) {
+        ids[text] = static_cast<int32_t>(tokens.size());
+        tokens.push_back(text);
+        scores.push_back(score);
+        types.push_back(type);
+        return ids[text];
+    }
+};
+
+static std::string spm_path;
+
+static std::string byte_level(unsigned char b) {
+    // GPT-2 byte stand-ins for the bytes the BPE test uses
+    if (b == ' ') return "\xc4\xa0";  // U+0120
+    if (b == '\n') return "\xc4\x8a"; // U+010A
+    return std::string(1, static_cast<char>(b));
+}
+
+static void test_spm(TestResult& r, const fs::path& dir) {
+    Vocab v;
+    v.add("<unk>", 2);
+    v.add("<s>", 3);
+    v.add("</s>", 3);
+    for (int b = 0; b < 256; ++b) {
+        char hex[8];
+        std::snprintf(hex, sizeof(hex), "<0x%02X>", b);
+        v.add(hex, 6);
+    }
+    const std::string sp = "\xe2\x96\x81";
+    v.add(sp, 1, -1.0f);
+    for (const char* c : {"h", "e", "l", "o", "w", "r", "d"}) v.add(c, 1, -2.0f);
+    v.add(sp + "h", 1, -3.0f);
+    v.add("ll", 1, -3.5f);
+    v.add("llo", 1, -4.0f);
+    v.add(sp + "hello", 1, -5.0f);
+    v.add("he", 1, -6.0f);
+    v.add("or", 1, -3.0f);
+    v.add(sp + "w", 1, -3.0f);
+    v.add(sp + "wor", 1, -4.5f);
+    v.add(sp + "worl", 1, -4.8f);
+    v.add(sp + "world", 1, -5.0f);
+    v.add(sp + "he", 1, -4.0f);
+    v.add("<|im_start|>", 3);
+    v.add("<tool>", 4);
+
+    GgufWriter w;
+    w.add_string("general.architecture", "llama");
+    w.add_uint32("llama.context_length", 4096);
+    w.add_string("tokenizer.ggml.model", "llama");
+    w.add_strings("tokenizer.ggml.tokens", v.tokens);
+    w.add_floats("tokenizer.ggml.scores", v.scores);
+    w.add_int32s("tokenizer.ggml.token_type", v.types);
+    w.add_uint32("tokenizer.ggml.bos_token_id", 1);
+    w.add_uint32("tokenizer.ggml.eos_token_id", 2);
+    spm_path = (dir / "spm.gguf").string();
+    w.save(spm_path);
+
+    std::string error;
+    auto tok = GgufTokenizer::load(spm_path, &error);
+    r.check(tok && tok->model_type() == "llama" && tok->vocab_size() == v.tokens.size(),
+            "SentencePiece vocabulary loads");
+    if (!tok) return;
+
+    const std::vector<int32_t> hello_world = {1, v.ids[sp + "hello"], v.ids[sp + "world"]};
+    r.check(tok->tokenize("hello world", true, true) == hello_world,
+            "SPM merges by score with a space prefix and BOS");
+    r.check(tok->tokenize("hello world", false, true) ==
+                std::vector<int32_t>(hello_world.begin() + 1, hello_world.end()),
+            "add_special=false leaves out BOS");
+
+    const std::vector<int32_t> hix = {v.ids[sp + "h"], v.ids["<0x69>"], v.ids["<0xC3>"], v.ids["<0xA9>"]};
+    r.check(tok->tokenize("hi\xc3\xa9", false, true) == hix,
+            "characters outside the vocabulary fall back to byte tokens");
+
+    const std::vector<int32_t> special = {v.ids["<|im_start|>"], v.ids[sp + "hello"], v.ids["<tool>"],
+                                          v.ids[sp + "w"]};
+    r.check(tok->tokenize("<|im_start|>hello<tool>w", false, true) == special,
+            "control and user-defined tokens split the text");
+    const auto literal = tok->tokenize("<|im_start|>hello<tool>w", false, false);
+    r.check(literal.size() > special.size() && literal.front() != v.ids["<|im_start|>"] &&
+                std::count(literal.begin(), literal.end(), v.ids["<tool>"]) == 1,
+            "parse_special=false keeps control tokens as text");
+
+    std::string decoded;
+    for (int32_t id : tok->tokenize("hi\xc3\xa9 world", false, true)) decoded += tok->token_to_piece(id);
+    r.check(decoded == " hi\xc3\xa9 world", "token_to_piece restores spaces and bytes");
+}
+
+static void write_bpe(const fs::path& path, const std::string& pre, Vocab& v) {
+    v = Vocab();
+    for (int b = 0; b < 256; ++b) {
+        // Stand-ins for every byte; only the ones the texts use matter here
+        const std::string text = b == ' ' || b == '\n' || (b >= '!' && b <= '~')
+                                     ? byte_level(static_cast<unsigned char>(b))
+                                     : "<byte" + std::to_string(b) + ">";
+        v.add(text);
+    }
+    const std::vector<std::string> merges = {
+        "\xc4\xa0 h", "l o", "l lo", "e llo", "\xc4\xa0h ello",
+        "1 2", "12 3", "123 4", "4 5", "' S", "\xc4\x8a \xc4\x8a",
+    };
+    for (const auto& m : merges) {
+        const size_t split = m.find(' ');
+        v.add(m.substr(0, split) + m.substr(split + 1));
+    }
+    v.add("<|endoftext|>", 3);
+
+    GgufWriter w;
+    w.add_string("tokenizer.ggml.model", "gpt2");
+    w.add_string("tokenizer.ggml.pre", pre);
+    w.add_strings("tokenizer.ggml.tokens", v.tokens);
+    w.add_int32s("tokenizer.ggml.token_type", v.types);
+    w.add_strings("tokenizer.ggml.merges", merges);
+    w.add_uint32("tokenizer.ggml.bos_token_id", v.ids["<|endoftext|>"]);
+    w.add_bool("tokenizer.ggml.add_bos_token", false);
+    w.save(path);
+}
+
+static std::vector<int32_t> ids_of(Vocab& v, const std::vector<std::string>& pieces) {
+    std::vector<int32_t> ids;
+    for (const auto& p : pieces) ids.push_back(v.ids.at(p));
+    return ids;
+}
+
+static void test_bpe(TestResult& r, const fs::path& dir) {
+    const std::string G = "\xc4\xa0";  // Byte-level space
+    const std::string N = "\xc4\x8a";  // Byte-level newline
+    Vocab v;
+
+    write_bpe(dir / "llama3.gguf", "llama-bpe", v);
+    auto llama3 = GgufTokenizer::load((dir / "llama3.gguf").string());
+    r.check(llama3 && llama3->model_type() == "gpt2", "byte-level BPE vocabulary loads");
+    if (!llama3) return;
+
+    r.check(llama3->tokenize(" hello", false, false) == ids_of(v, {G + "hello"}) &&
+                llama3->tokenize("hello", false, false) == ids_of(v, {"h", "ello"}),
+            "BPE applies merges lowest rank first");
+    r.check(llama3->tokenize("12345", false, false) == ids_of(v, {"123", "45"}),
+            "llama3 pre-tokenizer splits digits in threes");
+    r.check(llama3->tokenize("x'S", false, false) == ids_of(v, {"x", "'S"}),
+            "llama3 contractions are case-insensitive");
+    r.check(llama3->tokenize("a\n\nb", false, false) == ids_of(v, {"a", N + N, "b"}),
+            "newline runs become their own word");
+    r.check(llama3->tokenize("a<|endoftext|>b", false, true) == ids_of(v, {"a", "<|endoftext|>", "b"}),
+            "BPE splits out control tokens");
+    r.check(llama3->tokenize("a", true, false) == ids_of(v, {"a"}),
+            "add_bos_token=false in the file overrides the llama3 default");
+
+    std::string decoded;
+    for (int32_t id : llama3->tokenize(" hello 12345\n\n", false, false)) decoded += llama3->token_to_piece(id);
+    r.check(decoded == " hello 12345\n\n", "token_to_piece decodes byte-level pieces");
+
+    write_bpe(dir / "qwen2.gguf", "qwen2", v);
+    auto qwen2 = GgufTokenizer::load((dir / "qwen2.gguf").string());
+    r.check(qwen2 && qwen2->tokenize("12345", false, false) == ids_of(v, {"1", "2", "3", "4", "5"}),
+            "qwen2 pre-tokenizer splits single digits");
+
+    write_bpe(dir / "gpt2.gguf", "gpt-2", v);
+    auto gpt2 = GgufTokenizer::load((dir / "gpt2.gguf").string());
+    r.check(gpt2 && gpt2->tokenize("12345", false, false) == ids_of(v, {"1234", "5"}) &&
+                gpt2->tokenize("x'S", false, false) == ids_of(v, {"x", "'", "S"}),
+            "gpt-2 pre-tokenizer keeps digit runs and case-sensitive contractions");
+
+    write_bpe(dir / "unknown_pre.gguf", "some-new-model", v);
+    std::string error;
+    r.check(!GgufTokenizer::load((dir / "unknown_pre.gguf").string(), &error) &&
+                error.find("some-new-model") != std::string::npos,
+            "unsupported pre-tokenizers are reported, not guessed");
+}
+
+static void test_cache(TestResult& r, const fs::path& dir) {
+    lemon::GgufTokenizerCache cache(2);
+    auto first = cache.get(spm_path);
+    r.check(first && cache.get(spm_path) == first, "cache returns the loaded tokenizer");
+
+    GgufWriter w;
+    w.add_string("tokenizer.ggml.model", "bert");
+    w.add_strings("tokenizer.ggml.tokens", {"[CLS]"});
+    const fs::path bert = dir / "bert.gguf";
+    w.save(bert);
+    r.check(!cache.get(bert.string()), "unsupported vocab types yield no tokenizer");
+
+    // Replace the file: a cached "unsupported" answer is served until evicted
+    fs::copy_file(spm_path, bert, fs::copy_options::overwrite_existing);
+    r.check(!cache.get(bert.string()), "unsupported files are remembered");
+
+    cache.get(spm_path);
+    cache.get((dir / "llama3.gguf").string());
+    r.check(cache.get(spm_path) == first && cache.get(bert.string()) != nullptr,
+            "least recently used entries are evicted first");
+}
+
+int main() {
+    const fs::path dir = fs::temp_directory_path() / "lemonade_gguf_tokenizer_test";
+    fs::create_directories(dir);
+
+    TestResult r;
+    test_spm(r, dir);
+    test_bpe(r, dir);
+    test_cache(r, dir);
+
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+
+    printf("\n%d passed, %d failed\n", r.passed, r.failed);
+    return r.failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,190 @@
+// Standalone test for cancelling blocking HttpClient calls with CancelScope.
+//
+// Points HttpClient::post at a local listener that accepts the connection and
+// never answers, then checks that a CancelScope whose predicate turns true
+// aborts the call with RequestCancelledError long before its timeout. Also
+// checks that a scope that never fires leaves a normal response alone and
+// that nested scopes restore the enclosing one, and that the error a cancelled
+// backend call turns into carries the 499 status. POSIX only.
+//
+// Compile with:
+//   g++ -std=c++17 -I src/cpp/include test/cpp/test_http_cancel.cpp src/cpp/server/utils/http_client.cpp src/cpp/server/utils/path_utils.cpp src/cpp/server/utils/json_utils.cpp src/cpp/server/utils/platform/path_linux.cpp -o http_cancel_test -lcurl -lmbedcrypto -pthread
+
+#include "lemon/error_types.h"
+#include "lemon/utils/http_client.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using lemon::utils::CancelScope;
+using lemon::utils::HttpClient;
+using lemon::utils::RequestCancelledError;
+
+struct TestResult {
+    int passed = 0;
+    int failed = 0;
+
+    void check(bool cond, const std::string& name) {
+        if (cond) {
+            printf("[PASS] %s\n", name.c_str());
+            ++passed;
+        } else {
+            printf("[FAIL] %s\n", name.c_str());
+            ++failed;
+        }
+    }
+};
+
+#ifndef _WIN32
+// A loopback server that reads one request and, unless `reply` is set,
+// holds the connection open without answering until stopped
+struct LocalListener {
+    int fd = -1;
+    int port = 0;
+    std::string reply;
+    std::atomic<bool> stopping{false};
+    std::thread thread;
+
+    bool start() {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&addr), len) != 0 || listen(fd, 4) != 0 ||
+            getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+            return false;
+        }
+        port = ntohs(addr.sin_port);
+        thread = std::thread([this] {
+            const int client = accept(fd, nullptr, nullptr);
+            if (client < 0) {
+                return;
+            }
+            char buf[4096];
+            (void)recv(client, buf, sizeof(buf), 0);
+            if (!reply.empty()) {
+                (void)send(client, reply.data(), reply.size(), 0);
+            }
+            while (!stopping) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            close(client);
+        });
+        return true;
+    }
+
+    std::string url() const {
+        return "http://127.0.0.1:" + std::to_string(port) + "/v1/chat/completions";
+    }
+
+    ~LocalListener() {
+        stopping = true;
+        if (fd >= 0) {
+            shutdown(fd, SHUT_RDWR);
+            close(fd);
+        }
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+};
+
+static void test_cancel_aborts_post(TestResult& r) {
+    LocalListener listener;
+    if (!listener.start()) {
+        r.check(false, "a loopback listener starts");
+        return;
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    bool cancelled = false;
+    std::string other_error;
+    {
+        CancelScope scope([started] {
+            return std::chrono::steady_clock::now() - started > std::chrono::milliseconds(200);
+        });
+        try {
+            HttpClient::post(listener.url(), "{}", {}, 30);
+        } catch (const RequestCancelledError&) {
+            cancelled = true;
+        } catch (const std::exception& e) {
+            other_error = e.what();
+        }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - started;
+
+    r.check(cancelled && other_error.empty(), "a cancelled post throws RequestCancelledError");
+    r.check(elapsed < std::chrono::seconds(5), "the post returns well before its timeout");
+    r.check(!CancelScope::active(), "the scope is gone once it goes out of scope");
+}
+
+static void test_quiet_scope_keeps_response(TestResult& r) {
+    LocalListener listener;
+    listener.reply = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: 2\r\n"
+                     "Connection: close\r\n\r\n{}";
+    if (!listener.start()) {
+        r.check(false, "a loopback listener starts");
+        return;
+    }
+
+    CancelScope scope([] { return false; });
+    bool ok = false;
+    try {
+        const auto response = HttpClient::post(listener.url(), "{}", {}, 30);
+        ok = response.status_code == 200 && response.body == "{}";
+    } catch (const std::exception&) {
+    }
+    r.check(ok, "a scope that never fires leaves the response alone");
+}
+
+static void test_nested_scopes(TestResult& r) {
+    CancelScope outer([] { return false; });
+    {
+        CancelScope inner([] { return true; });
+        r.check(CancelScope::requested(), "the innermost scope decides");
+    }
+    r.check(CancelScope::active() && !CancelScope::requested(),
+            "the enclosing scope is restored");
+}
+#endif
+
+static void test_cancelled_error_status(TestResult& r) {
+    const auto error = lemon::ErrorResponse::from_exception(
+        lemon::RequestCancelledException("client disconnected"));
+    r.check(error["error"]["type"] == lemon::ErrorType::REQUEST_CANCELLED &&
+            error["error"].value("status_code", 0) == 499,
+            "the forwarded cancellation error carries status 499");
+
+    const auto backend = lemon::ErrorResponse::from_exception(lemon::BackendException("llamacpp", "busy", 503));
+    r.check(backend["error"].value("status_code", 0) == 503 && backend["error"]["backend"] == "llamacpp",
+            "subclass fields survive from_exception");
+}
+
+int main() {
+    TestResult r;
+#ifndef _WIN32
+    // Loopback requests must not go through a proxy from the environment
+    setenv("no_proxy", "127.0.0.1", 1);
+    setenv("NO_PROXY", "127.0.0.1", 1);
+
+    test_cancel_aborts_post(r);
+    test_quiet_scope_keeps_response(r);
+    test_nested_scopes(r);
+#endif
+    test_cancelled_error_status(r);
+
+    printf("\n%d passed, %d failed\n", r.passed, r.failed);
+    return r.failed == 0 ? 0 : 1;
+}
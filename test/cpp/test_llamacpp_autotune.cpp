@@ -0,0 +1,137 @@
+// Standalone test for the llama.cpp autotuner helpers.
+//
+// Checks that llama-bench and llama-batched-bench JSONL output is parsed with
+// log lines mixed in, that prompt and generation rows of one configuration are
+// merged, that the winner is the fastest at serving the reference request, and
+// that tunings round-trip through the recipe option keyed by host fingerprint.
+//
+// Compile with:
+//   g++ -std=c++17 -I src/cpp/include test/cpp/test_llamacpp_autotune.cpp src/cpp/server/llamacpp_autotune.cpp -o llamacpp_autotune_test
+
+#include "lemon/llamacpp_autotune.h"
+
+#include <nlohmann/json.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+using lemon::LlamaCppTuning;
+
+struct TestResult {
+    int passed = 0;
+    int failed = 0;
+
+    void check(bool cond, const std::string& name) {
+        if (cond) {
+            printf("[PASS] %s\n", name.c_str());
+            ++passed;
+        } else {
+            printf("[FAIL] %s\n", name.c_str());
+            ++failed;
+        }
+    }
+};
+
+static std::string bench_row(int threads, int batch, int ubatch, bool fa, int n_prompt, int n_gen, double ts) {
+    json row = {
+        {"build_commit", "abc123"}, {"model_type", "qwen3 0.6B Q4_0"},
+        {"n_threads", threads}, {"n_batch", batch}, {"n_ubatch", ubatch}, {"flash_attn", fa},
+        {"n_prompt", n_prompt}, {"n_gen", n_gen}, {"avg_ts", ts}, {"stddev_ts", 0.5}
+    };
+    return row.dump() + "\n";
+}
+
+static void test_llama_bench(TestResult& r) {
+    const std::string output =
+        "load_backend: loaded CPU backend from libggml-cpu.so\n" +
+        bench_row(8, 2048, 512, false, 256, 0, 400.0) +
+        bench_row(8, 2048, 512, false, 0, 32, 20.0) +
+        "  {not json\n" +
+        bench_row(16, 2048, 512, false, 256, 0, 700.0) +
+        bench_row(16, 2048, 512, false, 0, 32, 18.0) +
+        bench_row(4, 2048, 512, false, 256, 0, 250.0);
+
+    const auto results = lemon::parse_llama_bench_jsonl(output);
+    r.check(results.size() == 3 && results[0].threads == 8 && results[0].prefill_tps == 400.0 &&
+            results[0].decode_tps == 20.0 && results[0].flash_attn == 0,
+            "prompt and generation rows of one configuration are merged");
+
+    // 512/400 + 128/20 = 7.68 s against 512/700 + 128/18 = 7.84 s
+    const LlamaCppTuning best = lemon::pick_fastest(results);
+    r.check(best.threads == 8, "winner serves the reference request fastest, not the fastest prefill");
+    r.check(std::isinf(lemon::reference_request_seconds(250.0, 0.0)),
+            "configurations missing a measurement cannot win");
+
+    const std::string int_fa = R"({"n_threads":8,"n_batch":512,"n_ubatch":1024,"flash_attn":1,"n_prompt":256,"n_gen":0,"avg_ts":900})" "\n"
+                               R"({"n_threads":8,"n_batch":512,"n_ubatch":1024,"flash_attn":1,"n_prompt":0,"n_gen":32,"avg_ts":30})" "\n"
+                               R"({"n_threads":8,"n_batch":512,"n_ubatch":256,"flash_attn":1,"n_prompt":256,"n_gen":0,"avg_ts":500})" "\n"
+                               R"({"n_threads":8,"n_batch":512,"n_ubatch":256,"flash_attn":1,"n_prompt":0,"n_gen":32,"avg_ts":30})" "\n";
+    const LlamaCppTuning batch_best = lemon::pick_fastest(lemon::parse_llama_bench_jsonl(int_fa));
+    r.check(batch_best.ubatch_size == 256 && batch_best.flash_attn == 1,
+            "integer flash_attn is read and ubatch larger than batch is skipped");
+
+    r.check(!lemon::pick_fastest(lemon::parse_llama_bench_jsonl("error: failed to load model\n")).valid(),
+            "output without results gives an invalid tuning");
+}
+
+static void test_batched_bench(TestResult& r) {
+    const std::string output =
+        "main: n_kv_max = 2048, n_batch = 2048\n"
+        R"({"n_kv_max":2048,"pp":128,"tg":32,"pl":1,"n_kv":160,"speed_pp":300.0,"speed_tg":20.0})" "\n"
+        R"({"n_kv_max":2048,"pp":128,"tg":32,"pl":2,"n_kv":320,"speed_pp":310.0,"speed_tg":36.0})" "\n"
+        R"({"n_kv_max":2048,"pp":128,"tg":32,"pl":4,"n_kv":640,"speed_pp":310.0,"speed_tg":50.0})" "\n"
+        R"({"n_kv_max":2048,"pp":128,"tg":32,"pl":8,"n_kv":1280,"speed_pp":310.0,"speed_tg":60.0})" "\n";
+    const auto results = lemon::parse_batched_bench_jsonl(output);
+    r.check(results.size() == 4 && results[3].parallel == 8 && results[3].decode_tps == 60.0,
+            "batched-bench rows are parsed");
+    // Per sequence: 20, 18, 12.5, 7.5 tokens/s
+    r.check(lemon::pick_parallel(results) == 4, "parallel stops where per-sequence decode halves");
+
+    const std::vector<lemon::BatchedBenchResult> flat = {{1, 20.0}, {2, 19.0}};
+    r.check(lemon::pick_parallel(flat) == 1, "batching without an aggregate gain keeps one slot");
+}
+
+static void test_candidates_and_fingerprint(TestResult& r) {
+    r.check(lemon::autotune_thread_candidates(8, 16) == std::vector<int>({4, 8, 16}),
+            "thread candidates are half the cores, the cores and the threads");
+    r.check(lemon::autotune_thread_candidates(1, 1) == std::vector<int>({1}),
+            "thread candidates drop zero and duplicates");
+
+    const json devices = {
+        {"cpu", {{"name", "AMD Ryzen 7 7840U"}, {"cores", 8}, {"threads", 16}}},
+        {"amd_gpu", {{{"name", "AMD Radeon 780M"}, {"available", true}}}},
+        {"nvidia_gpu", json::array()}
+    };
+    const std::string cpu_key = lemon::host_fingerprint(devices, "cpu");
+    const std::string gpu_key = lemon::host_fingerprint(devices, "vulkan");
+    r.check(cpu_key == "cpu|AMD Ryzen 7 7840U|16t", "CPU fingerprint leaves GPUs out");
+    r.check(gpu_key == "vulkan|AMD Ryzen 7 7840U|16t|AMD Radeon 780M", "GPU fingerprint names the GPUs");
+
+    LlamaCppTuning t;
+    t.threads = 8;
+    t.batch_size = 2048;
+    t.ubatch_size = 256;
+    t.parallel = 4;
+    t.flash_attn = 1;
+    t.prefill_tps = 412.5;
+    t.decode_tps = 21.0;
+    const json stored = {{cpu_key, t.to_json()}, {"broken", "x"}};
+    const auto found = lemon::find_tuning(stored, cpu_key);
+    r.check(found && found->to_json() == t.to_json(), "tuning round-trips through the option value");
+    r.check(!lemon::find_tuning(stored, gpu_key) && !lemon::find_tuning(stored, "broken") &&
+            !lemon::find_tuning(json(), cpu_key),
+            "other hosts and malformed entries have no tuning");
+}
+
+int main() {
+    TestResult r;
+    test_llama_bench(r);
+    test_batched_bench(r);
+    test_candidates_and_fingerprint(r);
+
+    printf("\n%d passed, %d failed\n", r.passed, r.failed);
+    return r.failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+// Standalone test for the model replica helpers in lemon/model_replicas.h.
+//
+// Checks that the least-outstanding balancer skips dead replicas, prefers the
+// replica with the fewest in-flight requests, rotates between equally loaded
+// replicas by last access, and that CPU slices cover every core exactly once.
+//
+// Compile with:
+//   g++ -std=c++17 -I src/cpp/include test/cpp/test_model_replicas.cpp -o model_replicas_test
+
+#include <lemon/model_replicas.h>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+using lemon::pick_least_outstanding;
+using lemon::replica_cpu_slice;
+using lemon::ReplicaCpuSlice;
+
+struct TestResult {
+    int passed = 0;
+    int failed = 0;
+
+    void check(bool cond, const std::string& name) {
+        if (cond) {
+            printf("[PASS] %s\n", name.c_str());
+            ++passed;
+        } else {
+            printf("[FAIL] %s\n", name.c_str());
+            ++failed;
+        }
+    }
+};
+
+struct FakeReplica {
+    int id = 0;
+    bool alive = true;
+    int outstanding = 0;
+    std::chrono::steady_clock::time_point last_access;
+
+    bool is_backend_alive() const { return alive; }
+    int get_active_request_count() const { return outstanding; }
+    std::chrono::steady_clock::time_point get_last_access_time() const { return last_access; }
+};
+
+static std::shared_ptr<FakeReplica> make_replica(int id, int outstanding, int accessed_seconds_ago, bool alive = true) {
+    auto replica = std::make_shared<FakeReplica>();
+    replica->id = id;
+    replica->alive = alive;
+    replica->outstanding = outstanding;
+    replica->last_access = std::chrono::steady_clock::now() - std::chrono::seconds(accessed_seconds_ago);
+    return replica;
+}
+
+static void test_balancer(TestResult& r) {
+    std::vector<std::shared_ptr<FakeReplica>> none;
+    r.check(pick_least_outstanding(none) == nullptr, "no replicas picks nothing");
+
+    std::vector<std::shared_ptr<FakeReplica>> replicas = {
+        make_replica(0, 3, 0),
+        make_replica(1, 1, 0),
+        make_replica(2, 2, 0),
+    };
+    r.check(pick_least_outstanding(replicas)->id == 1, "fewest outstanding requests wins");
+
+    replicas[1]->alive = false;
+    r.check(pick_least_outstanding(replicas)->id == 2, "dead replicas are skipped");
+
+    for (auto& replica : replicas) {
+        replica->alive = false;
+    }
+    r.check(pick_least_outstanding(replicas)->id == 0, "all dead falls back to the first replica");
+
+    // Equal load: the replica that has waited longest goes next
+    std::vector<std::shared_ptr<FakeReplica>> idle = {
+        make_replica(0, 0, 1),
+        make_replica(1, 0, 5),
+        make_replica(2, 0, 3),
+    };
+    auto first = pick_least_outstanding(idle);
+    r.check(first->id == 1, "ties go to the least recently used replica");
+
+    // Simulate dispatching: each pick is touched, so idle replicas rotate
+    std::vector<int> order;
+    for (int i = 0; i < 3; ++i) {
+        auto next = pick_least_outstanding(idle);
+        order.push_back(next->id);
+        next->last_access = std::chrono::steady_clock::now() + std::chrono::seconds(i + 1);
+    }
+    r.check(order == std::vector<int>({1, 2, 0}), "idle replicas take turns");
+}
+
+static void test_cpu_slices(TestResult& r) {
+    ReplicaCpuSlice a = replica_cpu_slice(16, 0, 2);
+    ReplicaCpuSlice b = replica_cpu_slice(16, 1, 2);
+    r.check(a.valid() && a.range() == "0-7" && a.threads == 8, "first half of 16 CPUs");
+    r.check(b.valid() && b.range() == "8-15" && b.threads == 8, "second half of 16 CPUs");
+
+    // 10 CPUs over 3 replicas: 4 + 3 + 3, contiguous and non-overlapping
+    int next_cpu = 0;
+    bool contiguous = true;
+    int total = 0;
+    for (int i = 0; i < 3; ++i) {
+        ReplicaCpuSlice s = replica_cpu_slice(10, i, 3);
+        contiguous = contiguous && s.valid() && s.first_cpu == next_cpu &&
+                     s.last_cpu - s.first_cpu + 1 == s.threads;
+        next_cpu = s.last_cpu + 1;
+        total += s.threads;
+    }
+    r.check(contiguous && total == 10, "uneven split covers every CPU exactly once");
+    r.check(replica_cpu_slice(10, 0, 3).threads == 4, "leftover CPUs go to the lowest replica");
+
+    r.check(!replica_cpu_slice(2, 0, 4).valid(), "fewer CPUs than replicas gives no slice");
+    r.check(!replica_cpu_slice(8, 2, 2).valid(), "out-of-range replica index gives no slice");
+    r.check(!replica_cpu_slice(0, 0, 1).valid(), "unknown CPU count gives no slice");
+}
+
+int main() {
+    TestResult r;
+
+    test_balancer(r);
+    test_cpu_slices(r);
+
+    printf("\n%d passed, %d failed\n", r.passed, r.failed);
+    return r.failed == 0 ? 0 : 1;
+}
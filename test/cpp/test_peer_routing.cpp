@@ -0,0 +1,110 @@
+// Standalone test for the peer routing helpers in lemon/peer_routing.h.
+//
+// Checks the /peer/status round trip, parsing of the `peers` setting and of
+// beacon payloads, and choose_peer(): local models stay local, hot peers win
+// by queue depth, and a peer only loads a model when this node would evict.
+//
+// Compile with:
+//   g++ -std=c++17 -I src/cpp/include test/cpp/test_peer_routing.cpp src/cpp/server/peer_routing.cpp -o peer_routing_test
+
+#include <lemon/peer_routing.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using lemon::choose_peer;
+using lemon::parse_peer_urls;
+using lemon::peer_url_from_beacon;
+using lemon::PeerChoice;
+using lemon::PeerRoute;
+using lemon::PeerStatus;
+
+struct TestResult {
+    int passed = 0;
+    int failed = 0;
+
+    void check(bool cond, const std::string& name) {
+        if (cond) {
+            printf("[PASS] %s\n", name.c_str());
+            ++passed;
+        } else {
+            printf("[FAIL] %s\n", name.c_str());
+            ++failed;
+        }
+    }
+};
+
+static PeerStatus make_peer(const std::string& url, std::vector<std::string> models, int queue_depth,
+                            int64_t free_vram_bytes, bool has_free_slot) {
+    PeerStatus peer;
+    peer.url = url;
+    peer.loaded_models = std::move(models);
+    peer.queue_depth = queue_depth;
+    peer.free_vram_bytes = free_vram_bytes;
+    peer.has_free_slot = has_free_slot;
+    return peer;
+}
+
+static void test_status(TestResult& r) {
+    PeerStatus status = make_peer("http://10.0.0.2:13305/api/v1/", {"Qwen3-4B-GGUF"}, 3, 8LL << 30, false);
+    status.node_id = "abc";
+    PeerStatus parsed = PeerStatus::from_json(status.to_json());
+    r.check(parsed.node_id == "abc" && parsed.url == status.url && parsed.has_model("Qwen3-4B-GGUF") &&
+                parsed.queue_depth == 3 && parsed.free_vram_bytes == (8LL << 30) && !parsed.has_free_slot,
+            "status survives a JSON round trip");
+
+    PeerStatus defaults = PeerStatus::from_json(nlohmann::json::parse(R"({"queue_depth":"x"})"));
+    r.check(defaults.queue_depth == 0 && defaults.free_vram_bytes == -1 && defaults.has_free_slot,
+            "malformed fields fall back to defaults");
+}
+
+static void test_parsing(TestResult& r) {
+    auto urls = parse_peer_urls("127.0.0.1:13306, http://10.0.0.5:8000/  http://h:1/api/v1/,127.0.0.1:13306");
+    r.check(urls == std::vector<std::string>({"http://127.0.0.1:13306/api/v1/",
+                                              "http://10.0.0.5:8000/api/v1/",
+                                              "http://h:1/api/v1/"}),
+            "peer addresses normalize to API bases without duplicates");
+    r.check(parse_peer_urls("").empty(), "empty setting gives no peers");
+
+    r.check(peer_url_from_beacon(R"({"service": "lemonade", "hostname": "a", "url": "http://10.0.0.9:13305/api/v1/"})") ==
+                "http://10.0.0.9:13305/api/v1/",
+            "beacon payload yields its URL");
+    r.check(peer_url_from_beacon(R"({"service": "other", "url": "http://x/"})").empty(), "foreign beacon ignored");
+    r.check(peer_url_from_beacon("not json").empty(), "garbage beacon ignored");
+}
+
+static void test_choice(TestResult& r) {
+    std::vector<PeerStatus> peers = {
+        make_peer("a", {"big"}, 4, 1LL << 30, true),
+        make_peer("b", {"big", "small"}, 1, 2LL << 30, false),
+        make_peer("c", {}, 0, 16LL << 30, true),
+    };
+
+    r.check(choose_peer("big", true, true, peers).route == PeerRoute::Local, "loaded locally stays local");
+
+    PeerChoice hot = choose_peer("big", false, false, peers);
+    r.check(hot.route == PeerRoute::HotPeer && hot.peer == 1, "hot peer with the shortest queue wins");
+
+    PeerChoice cold = choose_peer("other", false, false, peers);
+    r.check(cold.route == PeerRoute::Local, "no forward when this node can load without evicting");
+
+    PeerChoice roomy = choose_peer("other", false, true, peers);
+    r.check(roomy.route == PeerRoute::RoomyPeer && roomy.peer == 2, "eviction here goes to the roomiest free peer");
+
+    std::vector<PeerStatus> full = {make_peer("a", {}, 0, 16LL << 30, false)};
+    r.check(choose_peer("other", false, true, full).route == PeerRoute::Local,
+            "peers without a free slot are not asked to load");
+    r.check(choose_peer("big", false, true, {}).route == PeerRoute::Local, "no peers means local");
+}
+
+int main() {
+    TestResult r;
+
+    test_status(r);
+    test_parsing(r);
+    test_choice(r);
+
+    printf("\n%d passed, %d failed\n", r.passed, r.failed);
+    return r.failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,226 @@
+// Standalone test for lemon::utils::ProcessReactor.
+//
+// Checks one-shot and periodic timers on the timing wheel, cancellation,
+// line splitting of watched pipes, instant exit detection of a child
+// process, and that posted jobs run off the reactor thread, in order per owner
+// and without a hung owner holding up the others.
+//
+// Compile with:
+//   g++ -std=c++17 -pthread -I src/cpp/include test/cpp/test_process_reactor.cpp src/cpp/server/utils/process_reactor.cpp -o process_reactor_test
+
+#include <lemon/utils/process_reactor.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using lemon::utils::ProcessReactor;
+using namespace std::chrono;
+
+struct TestResult {
+    int passed = 0;
+    int failed = 0;
+
+    void check(bool cond, const std::string& name) {
+        if (cond) {
+            printf("[PASS] %s\n", name.c_str());
+            ++passed;
+        } else {
+            printf("[FAIL] %s\n", name.c_str());
+            ++failed;
+        }
+    }
+};
+
+template <typename Pred>
+static bool wait_for(Pred pred, milliseconds timeout) {
+    const auto deadline = steady_clock::now() + timeout;
+    while (!pred()) {
+        if (steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(milliseconds(5));
+    }
+    return true;
+}
+
+static void test_timers(TestResult& r, ProcessReactor& reactor) {
+    std::atomic<int> one_shot{0};
+    std::atomic<int> periodic{0};
+    std::atomic<int> cancelled{0};
+    const auto start = steady_clock::now();
+    std::atomic<long long> fired_after_ms{0};
+
+    reactor.add_timer(milliseconds(200), [&] {
+        fired_after_ms = duration_cast<milliseconds>(steady_clock::now() - start).count();
+        one_shot++;
+    });
+    ProcessReactor::Id tick = reactor.add_timer(milliseconds(50), [&] { periodic++; }, true);
+    ProcessReactor::Id never = reactor.add_timer(milliseconds(100), [&] { cancelled++; });
+    reactor.cancel(never);
+
+    r.check(wait_for([&] { return one_shot == 1; }, milliseconds(2000)), "one-shot timer fires");
+    r.check(fired_after_ms >= 180 && fired_after_ms < 600, "one-shot timer fires on time");
+    r.check(wait_for([&] { return periodic >= 4; }, milliseconds(2000)), "periodic timer repeats");
+
+    reactor.cancel(tick);
+    const int after_cancel = periodic;
+    std::this_thread::sleep_for(milliseconds(200));
+    r.check(periodic == after_cancel, "cancelled periodic timer stops");
+    r.check(cancelled == 0 && one_shot == 1, "cancelled timer never fires and one-shot fires once");
+
+    // Longer than one wheel revolution (256 ticks of 50 ms)
+    std::atomic<bool> long_fired{false};
+    ProcessReactor::Id long_timer = reactor.add_timer(seconds(20), [&] { long_fired = true; });
+    std::this_thread::sleep_for(milliseconds(300));
+    r.check(!long_fired, "timer beyond one wheel revolution waits its rounds");
+    reactor.cancel(long_timer);
+}
+
+static void test_cancel_waits_for_callback(TestResult& r, ProcessReactor& reactor) {
+    std::atomic<bool> entered{false};
+    std::atomic<bool> finished{false};
+    ProcessReactor::Id id = reactor.add_timer(milliseconds(50), [&] {
+        entered = true;
+        std::this_thread::sleep_for(milliseconds(200));
+        finished = true;
+    });
+    wait_for([&] { return entered.load(); }, milliseconds(2000));
+    reactor.cancel(id);
+    r.check(finished, "cancel() waits for a running callback");
+}
+
+static void test_post(TestResult& r, ProcessReactor& reactor) {
+    std::atomic<bool> ran{false};
+    std::atomic<bool> timer_ran{false};
+    reactor.post([&] {
+        std::this_thread::sleep_for(milliseconds(300));
+        ran = true;
+    });
+    // A slow job must not delay reactor callbacks
+    reactor.add_timer(milliseconds(50), [&] { timer_ran = true; });
+    r.check(wait_for([&] { return timer_ran.load(); }, milliseconds(250)), "posted jobs do not block timers");
+    r.check(wait_for([&] { return ran.load(); }, milliseconds(2000)), "posted job runs");
+}
+
+static void test_post_owners(TestResult& r, ProcessReactor& reactor) {
+    int hung_backend = 0;
+    int other_backend = 0;
+    std::atomic<bool> release{false};
+    std::atomic<bool> other_ran{false};
+    std::mutex order_mutex;
+    std::vector<int> order;
+
+    // A probe stuck on one backend
+    reactor.post(&hung_backend, [&] {
+        wait_for([&] { return release.load(); }, milliseconds(5000));
+        std::lock_guard<std::mutex> lock(order_mutex);
+        order.push_back(1);
+    });
+    reactor.post(&hung_backend, [&] {
+        std::lock_guard<std::mutex> lock(order_mutex);
+        order.push_back(2);
+    });
+    reactor.post(&other_backend, [&] { other_ran = true; });
+
+    r.check(wait_for([&] { return other_ran.load(); }, milliseconds(1000)),
+            "a hung job does not hold up another owner's jobs");
+    {
+        std::lock_guard<std::mutex> lock(order_mutex);
+        r.check(order.empty(), "an owner's next job waits for its running one");
+    }
+    release = true;
+    r.check(wait_for([&] {
+                std::lock_guard<std::mutex> lock(order_mutex);
+                return order.size() == 2;
+            }, milliseconds(2000)) && order == std::vector<int>({1, 2}),
+            "an owner's jobs run in submission order");
+}
+
+#ifndef _WIN32
+static void test_output(TestResult& r, ProcessReactor& reactor) {
+    if (!reactor.supports_pipes()) {
+        printf("[SKIP] pipe watching not supported on this platform\n");
+        return;
+    }
+    int fds[2];
+    if (pipe(fds) != 0) {
+        r.check(false, "pipe() for output test");
+        return;
+    }
+
+    std::mutex lines_mutex;
+    std::vector<std::string> lines;
+    r.check(reactor.watch_output(fds[0], [&](const std::string& line) {
+        std::lock_guard<std::mutex> lock(lines_mutex);
+        lines.push_back(line);
+    }), "pipe can be watched");
+
+    const std::string first = "hello\nwor";
+    const std::string second = "ld\npartial";
+    ssize_t ignored = write(fds[1], first.data(), first.size());
+    std::this_thread::sleep_for(milliseconds(50));
+    ignored = write(fds[1], second.data(), second.size());
+    (void)ignored;
+    close(fds[1]);
+
+    bool got_all = wait_for([&] {
+        std::lock_guard<std::mutex> lock(lines_mutex);
+        return lines.size() == 3;
+    }, milliseconds(2000));
+    std::lock_guard<std::mutex> lock(lines_mutex);
+    r.check(got_all && lines[0] == "hello" && lines[1] == "world" && lines[2] == "partial",
+            "output is split into lines and flushed at EOF");
+}
+
+static void test_exit(TestResult& r, ProcessReactor& reactor) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        std::this_thread::sleep_for(milliseconds(200));
+        _exit(0);
+    }
+
+    std::atomic<bool> exited{false};
+    const auto start = steady_clock::now();
+    std::atomic<long long> detected_after_ms{0};
+    reactor.watch_exit(pid,
+        [pid] { return kill(pid, 0) == 0 && waitpid(pid, nullptr, WNOHANG) == 0; },
+        [&] {
+            detected_after_ms = duration_cast<milliseconds>(steady_clock::now() - start).count();
+            exited = true;
+        });
+
+    r.check(wait_for([&] { return exited.load(); }, milliseconds(3000)), "process exit is reported");
+    // With pidfds the exit is seen immediately; the polling fallback takes up to a second
+    printf("       exit detected after %lld ms\n", detected_after_ms.load());
+    r.check(detected_after_ms >= 150, "exit is not reported before it happens");
+    waitpid(pid, nullptr, 0);
+}
+#endif
+
+int main() {
+    TestResult r;
+    ProcessReactor reactor;
+
+    test_timers(r, reactor);
+    test_cancel_waits_for_callback(r, reactor);
+    test_post(r, reactor);
+    test_post_owners(r, reactor);
+#ifndef _WIN32
+    test_output(r, reactor);
+    test_exit(r, reactor);
+#endif
+
+    printf("\n%d passed, %d failed\n", r.passed, r.failed);
+    return r.failed == 0 ? 0 : 1;
+}
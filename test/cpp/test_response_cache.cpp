@@ -0,0 +1,145 @@
+// Standalone test for lemon::ResponseCache.
+//
+// Checks which requests count as deterministic, that identical concurrent
+// requests share one backend call (single-flight), that cached responses and
+// SSE streams are replayed, and that errors and incomplete streams are never
+// shared or cached.
+//
+// Compile with:
+//   g++ -std=c++17 -pthread -I src/cpp/include test/cpp/test_response_cache.cpp src/cpp/server/response_cache.cpp -o response_cache_test
+
+#include "lemon/response_cache.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using lemon::ResponseCache;
+using json = nlohmann::json;
+
+struct TestResult {
+    int passed = 0;
+    int failed = 0;
+
+    void check(bool cond, const std::string& name) {
+        if (cond) {
+            printf("[PASS] %s\n", name.c_str());
+            ++passed;
+        } else {
+            printf("[FAIL] %s\n", name.c_str());
+            ++failed;
+        }
+    }
+};
+
+static void test_is_deterministic(TestResult& r) {
+    r.check(ResponseCache::is_deterministic({{"temperature", 0}}), "temperature 0 is deterministic");
+    r.check(ResponseCache::is_deterministic({{"temperature", 0.7}, {"seed", 42}}), "fixed seed is deterministic");
+    r.check(!ResponseCache::is_deterministic({{"temperature", 0.7}}), "sampled request is not deterministic");
+    r.check(!ResponseCache::is_deterministic({{"seed", -1}}), "seed -1 (random) is not deterministic");
+    r.check(!ResponseCache::is_deterministic(json::object()), "backend-default temperature is not deterministic");
+}
+
+static void test_key_canonical(TestResult& r) {
+    json a = json::parse(R"({"model":"m","temperature":0,"messages":[{"role":"user","content":"hi"}]})");
+    json b = json::parse(R"({"messages":[{"role":"user","content":"hi"}],"temperature":0,"model":"m"})");
+    r.check(ResponseCache::make_key("/v1/chat/completions", "ckpt", a) ==
+                ResponseCache::make_key("/v1/chat/completions", "ckpt", b),
+            "field order does not change the key");
+    r.check(ResponseCache::make_key("/v1/chat/completions", "ckpt", a) !=
+                ResponseCache::make_key("/v1/chat/completions", "ckpt2", a),
+            "model scope is part of the key");
+}
+
+static void test_single_flight(TestResult& r) {
+    ResponseCache cache;
+    cache.configure(0, 300, true);  // Single-flight only, no caching
+    std::atomic<int> calls{0};
+
+    const int kCallers = 4;
+    std::vector<json> results(kCallers);
+    std::vector<std::thread> threads;
+    for (int c = 0; c < kCallers; ++c) {
+        threads.emplace_back([&, c] {
+            results[c] = cache.run("k", [&] {
+                calls++;
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                return json{{"choices", {{{"text", "answer"}}}}};
+            });
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    bool same = true;
+    for (const auto& res : results) {
+        same = same && res["choices"][0]["text"] == "answer";
+    }
+    r.check(calls == 1, "identical in-flight requests share one backend call");
+    r.check(same, "every caller receives the shared response");
+
+    json again = cache.run("k", [&] { calls++; return json{{"choices", json::array()}}; });
+    r.check(calls == 2, "without a cache budget finished responses are not reused");
+}
+
+static void test_cache_hit_and_errors(TestResult& r) {
+    ResponseCache cache;
+    cache.configure(1024 * 1024, 300, true);
+    std::atomic<int> calls{0};
+
+    auto ok = [&] { calls++; return json{{"id", "x"}, {"choices", json::array()}}; };
+    cache.run("ok", ok);
+    json hit = cache.run("ok", ok);
+    r.check(calls == 1 && hit["id"] == "x", "second identical request is served from the cache");
+
+    auto err = [&] { calls++; return json{{"error", {{"message", "boom"}}}}; };
+    cache.run("err", err);
+    cache.run("err", err);
+    r.check(calls == 3, "error responses are not cached");
+
+    json stats = cache.get_stats();
+    r.check(stats["hits"]["json"] == 1 && stats["entries"] == 1, "stats count hits and entries");
+}
+
+static void test_stream_replay(TestResult& r) {
+    ResponseCache cache;
+    cache.configure(1024 * 1024, 300, true);
+    std::atomic<int> calls{0};
+    const std::string sse = "data: {\"choices\":[{\"delta\":{\"content\":\"hi\"}}]}\n\ndata: [DONE]\n\n";
+
+    std::string first = cache.run_stream("s", [&] { calls++; return sse; });
+    std::string second = cache.run_stream("s", [&] { calls++; return sse; });
+    r.check(first.empty(), "first streaming request serves the client itself");
+    r.check(calls == 1 && second == sse, "repeat streaming request is replayed as SSE");
+
+    const std::string cut = "data: {\"choices\":[]}\n\n";  // Client went away before [DONE]
+    cache.run_stream("cut", [&] { calls++; return cut; });
+    std::string retry = cache.run_stream("cut", [&] { calls++; return cut; });
+    r.check(calls == 3 && retry.empty(), "incomplete streams are not cached");
+}
+
+static void test_ttl_expiry(TestResult& r) {
+    ResponseCache cache;
+    cache.configure(1024 * 1024, 1, false);
+    std::atomic<int> calls{0};
+    auto ok = [&] { calls++; return json{{"choices", json::array()}}; };
+    cache.run("t", ok);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    cache.run("t", ok);
+    r.check(calls == 2 && cache.get_stats()["expired"] == 1, "entries expire after the TTL");
+}
+
+int main() {
+    TestResult r;
+    test_is_deterministic(r);
+    test_key_canonical(r);
+    test_single_flight(r);
+    test_cache_hit_and_errors(r);
+    test_stream_replay(r);
+    test_ttl_expiry(r);
+
+    printf("\n%d passed, %d failed\n", r.passed, r.failed);
+    return r.failed == 0 ? 0 : 1;
+}
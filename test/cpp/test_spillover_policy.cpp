@@ -0,0 +1,106 @@
+// Standalone test for lemon::SpilloverPolicy and decide_spillover().
+//
+// Checks parsing of the spillover recipe options, that nothing spills
+// without a cloud_fallback, and each spill trigger: queue depth, predicted
+// wait and a load in progress.
+//
+// Compile with:
+//   g++ -std=c++17 -I src/cpp/include test/cpp/test_spillover_policy.cpp src/cpp/server/spillover_policy.cpp -o spillover_policy_test
+
+#include <lemon/spillover_policy.h>
+
+#include <cstdio>
+#include <string>
+
+using lemon::decide_spillover;
+using lemon::LocalModelLoad;
+using lemon::SpillReason;
+using lemon::SpilloverPolicy;
+using json = nlohmann::json;
+
+struct TestResult {
+    int passed = 0;
+    int failed = 0;
+
+    void check(bool cond, const std::string& name) {
+        if (cond) {
+            printf("[PASS] %s\n", name.c_str());
+            ++passed;
+        } else {
+            printf("[FAIL] %s\n", name.c_str());
+            ++failed;
+        }
+    }
+};
+
+static LocalModelLoad loaded(int outstanding, double mean_seconds = 0.0) {
+    LocalModelLoad load;
+    load.loaded = true;
+    load.outstanding = outstanding;
+    load.mean_request_seconds = mean_seconds;
+    return load;
+}
+
+static void test_parsing(TestResult& r) {
+    SpilloverPolicy defaults = SpilloverPolicy::from_recipe_options(json::object());
+    r.check(!defaults.enabled() && defaults.max_queue_depth == 0 &&
+            defaults.max_wait_seconds == 0.0 && defaults.while_loading,
+            "defaults disable spillover");
+
+    SpilloverPolicy policy = SpilloverPolicy::from_recipe_options({
+        {"cloud_fallback", "cloud.gpt-4o-mini"},
+        {"spill_queue_depth", 4},
+        {"spill_max_wait", 2.5},
+        {"spill_while_loading", false}
+    });
+    r.check(policy.enabled() && policy.fallback_model == "cloud.gpt-4o-mini", "fallback model is read");
+    r.check(policy.max_queue_depth == 4 && policy.max_wait_seconds == 2.5 && !policy.while_loading,
+            "thresholds are read");
+
+    SpilloverPolicy wrong_types = SpilloverPolicy::from_recipe_options({
+        {"cloud_fallback", 7},
+        {"spill_queue_depth", "4"}
+    });
+    r.check(!wrong_types.enabled() && wrong_types.max_queue_depth == 0, "mistyped options are ignored");
+}
+
+static void test_decisions(TestResult& r) {
+    SpilloverPolicy off;
+    off.max_queue_depth = 1;
+    r.check(decide_spillover(off, loaded(10)) == SpillReason::None, "no fallback never spills");
+
+    SpilloverPolicy depth;
+    depth.fallback_model = "cloud.model";
+    depth.max_queue_depth = 3;
+    r.check(decide_spillover(depth, loaded(2)) == SpillReason::None, "below queue depth stays local");
+    r.check(decide_spillover(depth, loaded(3)) == SpillReason::QueueDepth, "at queue depth spills");
+
+    SpilloverPolicy wait;
+    wait.fallback_model = "cloud.model";
+    wait.max_wait_seconds = 5.0;
+    r.check(decide_spillover(wait, loaded(2, 2.0)) == SpillReason::None, "4s predicted wait stays local");
+    r.check(decide_spillover(wait, loaded(3, 2.0)) == SpillReason::PredictedWait, "6s predicted wait spills");
+    r.check(decide_spillover(wait, loaded(10, 0.0)) == SpillReason::None, "unknown request time never predicts a wait");
+
+    SpilloverPolicy loading;
+    loading.fallback_model = "cloud.model";
+    LocalModelLoad cold;
+    r.check(decide_spillover(loading, cold) == SpillReason::None, "unloaded model with no load in progress stays local");
+    cold.loading = true;
+    r.check(decide_spillover(loading, cold) == SpillReason::Loading, "requests during a load spill");
+    loading.while_loading = false;
+    r.check(decide_spillover(loading, cold) == SpillReason::None, "spill_while_loading=false waits for the load");
+
+    r.check(std::string(lemon::spill_reason_to_string(SpillReason::PredictedWait)) == "predicted_wait",
+            "reasons have metric label names");
+}
+
+int main() {
+    TestResult r;
+
+    test_parsing(r);
+    test_decisions(r);
+
+    printf("\n%d passed, %d failed\n", r.passed, r.failed);
+    return r.failed == 0 ? 0 : 1;
+}
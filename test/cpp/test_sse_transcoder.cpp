@@ -0,0 +1,210 @@
+// Standalone test for lemon::SseTranscoder.
+//
+// Checks that the chunk scanner picks out the fields the translators use,
+// that lines split at any byte boundary are framed correctly, and that the
+// Ollama chat/generate NDJSON and Anthropic SSE output of a text stream and a
+// tool-call stream parse to the documents the old json-based conversion built.
+//
+// Compile with:
+//   g++ -std=c++17 -I src/cpp/include test/cpp/test_sse_transcoder.cpp src/cpp/server/sse_transcoder.cpp -o sse_transcoder_test
+
+#include "lemon/sse_transcoder.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using lemon::OpenAIStreamDelta;
+using lemon::SseTranscoder;
+using json = nlohmann::json;
+
+struct TestResult {
+    int passed = 0;
+    int failed = 0;
+
+    void check(bool cond, const std::string& name) {
+        if (cond) {
+            printf("[PASS] %s\n", name.c_str());
+            ++passed;
+        } else {
+            printf("[FAIL] %s\n", name.c_str());
+            ++failed;
+        }
+    }
+};
+
+static const std::string kTextStream =
+    "data: {\"id\":\"chatcmpl-1\",\"choices\":[{\"index\":0,\"delta\":{\"role\":\"assistant\",\"content\":\"\"}}]}\n\n"
+    "data: {\"id\":\"chatcmpl-1\",\"choices\":[{\"index\":0,\"delta\":{\"content\":\"Hel\"}}]}\n\n"
+    "data: {\"id\":\"chatcmpl-1\",\"choices\":[{\"index\":0,\"delta\":{\"content\":\"lo \\\"w\\u00f6rld\\\"\\n\"}}]}\n\n"
+    "data: {\"id\":\"chatcmpl-1\",\"choices\":[{\"index\":0,\"delta\":{},\"finish_reason\":\"stop\"}]}\n\n"
+    "data: {\"id\":\"chatcmpl-1\",\"choices\":[],\"usage\":{\"prompt_tokens\":7,\"completion_tokens\":3}}\n\n"
+    "data: [DONE]\n\n";
+
+static const std::string kToolStream =
+    "data: {\"id\":\"chatcmpl-2\",\"choices\":[{\"delta\":{\"role\":\"assistant\",\"tool_calls\":"
+    "[{\"index\":0,\"id\":\"call_1\",\"type\":\"function\",\"function\":{\"name\":\"get_weather\",\"arguments\":\"\"}}]}}]}\r\n\r\n"
+    "data: {\"id\":\"chatcmpl-2\",\"choices\":[{\"delta\":{\"tool_calls\":[{\"index\":0,\"function\":{\"arguments\":\"{\\\"city\\\":\"}}]}}]}\r\n\r\n"
+    "data: {\"id\":\"chatcmpl-2\",\"choices\":[{\"delta\":{\"tool_calls\":[{\"index\":0,\"function\":{\"arguments\":\"\\\"Oslo\\\"}\"}}]}}]}\r\n\r\n"
+    "data: {\"id\":\"chatcmpl-2\",\"choices\":[{\"delta\":{},\"finish_reason\":\"tool_calls\"}]}\r\n\r\n"
+    "data: [DONE]\r\n\r\n";
+
+// Runs `stream` through a transcoder, feeding `step` bytes at a time
+static std::string transcode(SseTranscoder::Target target, const std::string& stream, size_t step,
+                             const std::vector<std::string>& warnings = {}) {
+    SseTranscoder transcoder(target, "Qwen3-0.6B-GGUF", warnings);
+    std::string out;
+    auto write = [&out](const char* data, size_t len) {
+        out.append(data, len);
+        return true;
+    };
+    for (size_t pos = 0; pos < stream.size(); pos += step) {
+        transcoder.feed(stream.data() + pos, std::min(step, stream.size() - pos), write);
+    }
+    transcoder.finish(write);
+    return out;
+}
+
+static std::vector<json> parse_ndjson(const std::string& text) {
+    std::vector<json> lines;
+    size_t start = 0;
+    size_t end;
+    while ((end = text.find('\n', start)) != std::string::npos) {
+        lines.push_back(json::parse(text.substr(start, end - start)));
+        start = end + 1;
+    }
+    return lines;
+}
+
+// (event, data) pairs of an SSE stream
+static std::vector<std::pair<std::string, json>> parse_sse(const std::string& text) {
+    std::vector<std::pair<std::string, json>> events;
+    size_t start = 0;
+    size_t end;
+    while ((end = text.find("\n\n", start)) != std::string::npos) {
+        const std::string block = text.substr(start, end - start);
+        const size_t data = block.find("\ndata: ");
+        events.emplace_back(block.substr(7, data - 7), json::parse(block.substr(data + 7)));
+        start = end + 2;
+    }
+    return events;
+}
+
+static void test_scanner(TestResult& r) {
+    OpenAIStreamDelta d;
+    const std::string chunk =
+        R"({"id":"x","object":"chat.completion.chunk","choices":[{"index":0,"delta":{"content":"a\"b","reasoning_content":null,)"
+        R"("tool_calls":[{"index":1,"id":"c","function":{"name":"f","arguments":"{}"}}]},"finish_reason":null},{"delta":{"content":"ignored"}}],)"
+        R"("usage":{"prompt_tokens":12,"completion_tokens":4,"prompt_tokens_details":{"cached_tokens":2}},"timings":{"a":[1,2.5e3,true]}})";
+    r.check(lemon::scan_openai_stream_chunk(chunk, d), "scanner accepts a full chunk");
+    r.check(d.id == "\"x\"" && d.content == "\"a\\\"b\"" && d.reasoning_content == "null" &&
+            d.finish_reason == "null", "scanner keeps raw string and null slices from choices[0]");
+    r.check(d.tool_call_deltas.size() == 1 && d.tool_call_deltas[0].index == 1 &&
+            d.tool_call_deltas[0].name == "\"f\"" && d.tool_call_deltas[0].arguments == "\"{}\"" &&
+            json::parse(std::string(d.tool_calls)).size() == 1, "scanner extracts tool call deltas");
+    r.check(d.prompt_tokens == 12 && d.completion_tokens == 4, "scanner reads usage counts");
+    r.check(!lemon::scan_openai_stream_chunk(R"({"choices":[{"delta":{"content":"x"})", d) &&
+            !lemon::scan_openai_stream_chunk(R"({"a":1} trailing)", d), "scanner rejects malformed chunks");
+}
+
+static void test_ollama_chat(TestResult& r) {
+    const std::string whole = transcode(SseTranscoder::Target::OllamaChat, kTextStream, kTextStream.size());
+    bool same_when_split = true;
+    for (size_t step : {1, 2, 7, 64}) {
+        same_when_split = same_when_split &&
+            transcode(SseTranscoder::Target::OllamaChat, kTextStream, step) == whole;
+    }
+    r.check(same_when_split, "output does not depend on how the upstream bytes are split");
+
+    const auto lines = parse_ndjson(whole);
+    const json expected_delta = {
+        {"model", "Qwen3-0.6B-GGUF"}, {"created_at", "2024-01-01T00:00:00Z"}, {"done", false},
+        {"message", {{"role", "assistant"}, {"content", "lo \"w\u00f6rld\"\n"}}}
+    };
+    const json expected_done = {
+        {"model", "Qwen3-0.6B-GGUF"}, {"created_at", "2024-01-01T00:00:00Z"},
+        {"message", {{"role", "assistant"}, {"content", ""}}},
+        {"done", true}, {"done_reason", "stop"},
+        {"total_duration", 0}, {"load_duration", 0},
+        {"prompt_eval_count", 7}, {"prompt_eval_duration", 0},
+        {"eval_count", 3}, {"eval_duration", 0}
+    };
+    r.check(lines.size() == 6 && lines[2] == expected_delta, "chat deltas become Ollama message chunks");
+    r.check(lines.size() == 6 && lines[3]["done"] == true && lines[3]["done_reason"] == "stop" &&
+            !lines[4].contains("message") && lines[5] == expected_done,
+            "finish, usage-only and closing lines match the Ollama format");
+
+    const auto tool_lines = parse_ndjson(transcode(SseTranscoder::Target::OllamaChat, kToolStream, 5));
+    r.check(tool_lines.size() == 5 && tool_lines[0]["message"]["tool_calls"][0]["function"]["name"] == "get_weather",
+            "tool call deltas are passed through to Ollama");
+}
+
+static void test_ollama_generate(TestResult& r) {
+    const std::string stream =
+        "data: {\"choices\":[{\"text\":\"Once\",\"index\":0,\"finish_reason\":null}]}\n\n"
+        "data: {\"choices\":[{\"text\":\" upon\",\"index\":0,\"finish_reason\":\"length\"}],\"usage\":{\"prompt_tokens\":2,\"completion_tokens\":2}}\n\n"
+        "data: [DONE]\n\n";
+    const auto lines = parse_ndjson(transcode(SseTranscoder::Target::OllamaGenerate, stream, 3));
+    const json expected_first = {
+        {"model", "Qwen3-0.6B-GGUF"}, {"created_at", "2024-01-01T00:00:00Z"}, {"done", false}, {"response", "Once"}
+    };
+    r.check(lines.size() == 3 && lines[0] == expected_first && lines[1]["done_reason"] == "length" &&
+            lines[2]["context"] == json::array() && lines[2]["eval_count"] == 2 && lines[2]["response"] == "",
+            "completion chunks become Ollama generate lines");
+}
+
+static void test_anthropic(TestResult& r) {
+    const auto events = parse_sse(transcode(SseTranscoder::Target::Anthropic, kTextStream, 11, {"Ignored 'metadata' field"}));
+    std::vector<std::string> names;
+    for (const auto& e : events) {
+        names.push_back(e.first);
+    }
+    const std::vector<std::string> expected_names = {
+        "message_start", "content_block_start", "content_block_delta", "content_block_delta",
+        "content_block_stop", "message_delta", "message_stop"
+    };
+    r.check(names == expected_names, "text stream yields the Anthropic event sequence");
+    r.check(events.size() == 7 && events[0].second["message"]["id"] == "chatcmpl-1" &&
+            events[3].second["delta"] == json{{"type", "text_delta"}, {"text", "lo \"w\u00f6rld\"\n"}},
+            "message id and text deltas carry over");
+    r.check(events.size() == 7 &&
+            events[5].second == json{{"type", "message_delta"},
+                                     {"delta", {{"stop_reason", "end_turn"}, {"stop_sequence", nullptr}}},
+                                     {"usage", {{"input_tokens", 7}, {"output_tokens", 3}}},
+                                     {"warnings", {"Ignored 'metadata' field"}}},
+            "message_delta reports stop reason, usage and warnings");
+
+    const auto tool_events = parse_sse(transcode(SseTranscoder::Target::Anthropic, kToolStream, 4));
+    std::string partial_json;
+    for (const auto& e : tool_events) {
+        if (e.first == "content_block_delta") {
+            partial_json += e.second["delta"]["partial_json"].get<std::string>();
+        }
+    }
+    r.check(tool_events.size() == 7 &&
+            tool_events[1].second["content_block"] ==
+                json{{"type", "tool_use"}, {"id", "call_1"}, {"name", "get_weather"}, {"input", json::object()}} &&
+            tool_events[1].second["index"] == 1,
+            "tool calls open tool_use blocks after the text block");
+    r.check(json::parse(partial_json) == json{{"city", "Oslo"}} &&
+            tool_events[5].second["delta"]["stop_reason"] == "tool_use",
+            "tool arguments stream as input_json_delta and stop as tool_use");
+
+    const auto empty = parse_sse(transcode(SseTranscoder::Target::Anthropic, "data: [DONE]\n\n", 64));
+    r.check(empty.size() == 5 && empty[0].first == "message_start" && empty[1].first == "content_block_start",
+            "an empty backend stream still produces a complete message");
+}
+
+int main() {
+    TestResult r;
+    test_scanner(r);
+    test_ollama_chat(r);
+    test_ollama_generate(r);
+    test_anthropic(r);
+
+    printf("\n%d passed, %d failed\n", r.passed, r.failed);
+    return r.failed == 0 ? 0 : 1;
+}
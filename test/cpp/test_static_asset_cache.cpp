@@ -0,0 +1,123 @@
+// Standalone test for lemon::StaticAssetCache.
+//
+// Builds a throwaway web app directory and checks that assets are served from
+// the in-memory snapshot and gain a compressed variant in the background, that
+// Accept-Encoding and If-None-Match are honoured, that only webpack-hashed
+// filenames are immutable, that lookups cannot escape the root, and that
+// directory changes trigger a reload.
+//
+// Compile with:
+//   g++ -std=c++17 -pthread -I src/cpp/include test/cpp/test_static_asset_cache.cpp src/cpp/server/static_asset_cache.cpp src/cpp/server/directory_watcher.cpp -lzstd -o static_asset_cache_test
+
+#include "lemon/static_asset_cache.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+using lemon::StaticAssetCache;
+namespace fs = std::filesystem;
+
+struct TestResult {
+    int passed = 0;
+    int failed = 0;
+
+    void check(bool cond, const std::string& name) {
+        if (cond) {
+            printf("[PASS] %s\n", name.c_str());
+            ++passed;
+        } else {
+            printf("[FAIL] %s\n", name.c_str());
+            ++failed;
+        }
+    }
+};
+
+static void write_file(const fs::path& path, const std::string& content) {
+    std::ofstream out(path, std::ios::binary);
+    out << content;
+}
+
+int main() {
+    TestResult r;
+
+    fs::path dir = fs::temp_directory_path() / "lemonade_static_asset_cache_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "assets");
+
+    std::string bundle;
+    for (int i = 0; i < 2000; ++i) {
+        bundle += "console.log('hello world " + std::to_string(i % 7) + "');\n";
+    }
+    write_file(dir / "renderer.bundle.js", bundle);
+    write_file(dir / "assets" / "main.0c1d2e3f4a5b6c7d8e9f.css", "body{}");
+    write_file(dir / "assets" / "index-BQx2k9aZ.css", "body{}");
+    write_file(dir / "font.woff2", std::string(4096, '\x7f'));
+
+    StaticAssetCache cache(dir.string());
+    std::shared_ptr<const StaticAssetCache::Table> snapshot;
+
+    const StaticAssetCache::Asset* js = cache.find("renderer.bundle.js", snapshot);
+    r.check(js && js->identity == bundle, "asset is served from memory");
+
+    // Compression happens on the builder thread after construction
+    for (int i = 0; i < 50 && js && js->zstd.empty(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        js = cache.find("renderer.bundle.js", snapshot);
+    }
+    r.check(js && !js->zstd.empty() && js->zstd.size() < bundle.size(), "text assets get a zstd variant");
+    r.check(js && js->content_type == "text/javascript" && !js->immutable,
+            "unhashed bundle is revalidated, not immutable");
+
+    const StaticAssetCache::Asset* font = cache.find("font.woff2", snapshot);
+    r.check(font && font->zstd.empty() && font->br.empty() && font->gzip.empty(),
+            "already-compressed fonts are not recompressed");
+
+    const StaticAssetCache::Asset* css = cache.find("assets/./main.0c1d2e3f4a5b6c7d8e9f.css", snapshot);
+    r.check(css && css->immutable, "hashed filename in a subdirectory is immutable");
+    const StaticAssetCache::Asset* named = cache.find("assets/index-BQx2k9aZ.css", snapshot);
+    r.check(named && !named->immutable, "name that only looks hashed is revalidated");
+    r.check(cache.find("../" + dir.filename().string() + "/renderer.bundle.js", snapshot) == nullptr,
+            "lookups cannot leave the root");
+    r.check(cache.find("missing.js", snapshot) == nullptr, "unknown files are not found");
+
+    if (js) {
+        std::string encoding;
+        const std::string& body = StaticAssetCache::select_encoding(*js, "gzip, br;q=0, zstd", encoding);
+        r.check(encoding == "zstd" && &body == &js->zstd, "client-accepted encoding is selected");
+        StaticAssetCache::select_encoding(*js, "", encoding);
+        r.check(encoding.empty(), "identity is used without Accept-Encoding");
+
+        const std::string zstd_tag = StaticAssetCache::etag_for(*js, "zstd");
+        r.check(zstd_tag != js->etag, "encoded representations have their own ETag");
+        r.check(StaticAssetCache::etag_matches(*js, "\"other\", W/" + zstd_tag),
+                "If-None-Match matches weak and listed ETags");
+        r.check(!StaticAssetCache::etag_matches(*js, "\"other\""), "stale ETag does not match");
+    }
+
+    r.check(StaticAssetCache::is_hashed_filename("3f2a9c1b0d4e5f6a7b8c.svg") &&
+                StaticAssetCache::is_hashed_filename("main.3f2a9c1b0d4e5f6a7b8c.js") &&
+                !StaticAssetCache::is_hashed_filename("renderer.bundle.js") &&
+                !StaticAssetCache::is_hashed_filename("main.3f2a9c1b.js") &&
+                !StaticAssetCache::is_hashed_filename("release20240101.js") &&
+                !StaticAssetCache::is_hashed_filename("3F2A9C1B0D4E5F6A7B8C.svg"),
+            "hashed filename detection");
+
+    // Give the watcher time to arm, then change the directory.
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    write_file(dir / "added.js", "1");
+    bool reloaded = false;
+    for (int i = 0; i < 30 && !reloaded; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        reloaded = cache.find("added.js", snapshot) != nullptr;
+    }
+    r.check(reloaded, "directory change reloads the snapshot");
+
+    fs::remove_all(dir);
+
+    printf("\n%d passed, %d failed\n", r.passed, r.failed);
+    return r.failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,340 @@
+// Standalone test for lemon::utils::StreamExtractor.
+//
+// Builds small .tar.gz and .zip archives in memory, feeds them in chunks of
+// various sizes and checks the extracted tree: the tarball's top directory is
+// stripped, GNU long names and symlinks work, zip entries are stored or
+// deflated (with and without data descriptors) and keep their Unix modes.
+// Paths escaping the destination, corrupt data and gaps in the byte stream
+// make finish() fail so the installer can fall back to tar/unzip.
+//
+// Compile with:
+//   g++ -std=c++17 -DHAVE_ZLIB -I src/cpp/include test/cpp/test_stream_extractor.cpp src/cpp/server/utils/stream_extractor.cpp -lz -o stream_extractor_test
+
+#include <lemon/utils/stream_extractor.h>
+
+#include <zlib.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+namespace fs = std::filesystem;
+using lemon::utils::StreamExtractor;
+
+struct TestResult {
+    int passed = 0;
+    int failed = 0;
+
+    void check(bool cond, const std::string& name) {
+        if (cond) {
+            printf("[PASS] %s\n", name.c_str());
+            ++passed;
+        } else {
+            printf("[FAIL] %s\n", name.c_str());
+            ++failed;
+        }
+    }
+};
+
+// ---- Archive builders ----
+
+static void put_octal(std::string& header, size_t offset, size_t width, uint64_t value) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%0*llo", static_cast<int>(width - 1), static_cast<unsigned long long>(value));
+    std::memcpy(&header[offset], buf, width - 1);
+}
+
+static void tar_entry(std::string& tar, const std::string& name, char type, const std::string& body,
+                      unsigned mode = 0644, const std::string& link = "") {
+    std::string header(512, '\0');
+    std::memcpy(&header[0], name.data(), std::min<size_t>(name.size(), 100));
+    put_octal(header, 100, 8, mode);
+    put_octal(header, 108, 8, 0);
+    put_octal(header, 116, 8, 0);
+    put_octal(header, 124, 12, body.size());
+    put_octal(header, 136, 12, 0);
+    header[156] = type;
+    std::memcpy(&header[157], link.data(), std::min<size_t>(link.size(), 100));
+    std::memcpy(&header[257], "ustar\0" "00", 8);
+    std::memset(&header[148], ' ', 8);
+    unsigned sum = 0;
+    for (unsigned char c : header) {
+        sum += c;
+    }
+    put_octal(header, 148, 7, sum);
+    tar += header;
+    tar += body;
+    tar.append((512 - body.size() % 512) % 512, '\0');
+}
+
+static std::string gzip(const std::string& data) {
+    z_stream s{};
+    deflateInit2(&s, Z_BEST_SPEED, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    std::string out(deflateBound(&s, data.size()) + 64, '\0');
+    s.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    s.avail_in = static_cast<uInt>(data.size());
+    s.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    s.avail_out = static_cast<uInt>(out.size());
+    deflate(&s, Z_FINISH);
+    out.resize(s.total_out);
+    deflateEnd(&s);
+    return out;
+}
+
+static std::string raw_deflate(const std::string& data) {
+    z_stream s{};
+    deflateInit2(&s, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    std::string out(deflateBound(&s, data.size()) + 64, '\0');
+    s.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    s.avail_in = static_cast<uInt>(data.size());
+    s.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    s.avail_out = static_cast<uInt>(out.size());
+    deflate(&s, Z_FINISH);
+    out.resize(s.total_out);
+    deflateEnd(&s);
+    return out;
+}
+
+static void le16(std::string& out, uint16_t v) {
+    out += static_cast<char>(v & 0xff);
+    out += static_cast<char>(v >> 8);
+}
+
+static void le32(std::string& out, uint32_t v) {
+    le16(out, static_cast<uint16_t>(v & 0xffff));
+    le16(out, static_cast<uint16_t>(v >> 16));
+}
+
+struct ZipBuilder {
+    std::string data;
+    std::string central;
+    uint16_t count = 0;
+
+    void add(const std::string& name, const std::string& body, bool deflated, bool descriptor, unsigned mode) {
+        const uint32_t crc = static_cast<uint32_t>(
+            crc32(0L, reinterpret_cast<const Bytef*>(body.data()), static_cast<uInt>(body.size())));
+        const std::string stored = deflated ? raw_deflate(body) : body;
+        const uint32_t offset = static_cast<uint32_t>(data.size());
+        const uint16_t flags = descriptor ? 0x0008 : 0;
+        const uint16_t method = deflated ? 8 : 0;
+
+        le32(data, 0x04034b50);
+        le16(data, 20);
+        le16(data, flags);
+        le16(data, method);
+        le32(data, 0);  // time, date
+        le32(data, descriptor ? 0 : crc);
+        le32(data, descriptor ? 0 : static_cast<uint32_t>(stored.size()));
+        le32(data, descriptor ? 0 : static_cast<uint32_t>(body.size()));
+        le16(data, static_cast<uint16_t>(name.size()));
+        le16(data, 0);
+        data += name;
+        data += stored;
+        if (descriptor) {
+            le32(data, 0x08074b50);
+            le32(data, crc);
+            le32(data, static_cast<uint32_t>(stored.size()));
+            le32(data, static_cast<uint32_t>(body.size()));
+        }
+
+        le32(central, 0x02014b50);
+        le16(central, (3 << 8) | 20);  // Made on Unix
+        le16(central, 20);
+        le16(central, flags);
+        le16(central, method);
+        le32(central, 0);
+        le32(central, crc);
+        le32(central, static_cast<uint32_t>(stored.size()));
+        le32(central, static_cast<uint32_t>(body.size()));
+        le16(central, static_cast<uint16_t>(name.size()));
+        le16(central, 0);
+        le16(central, 0);
+        le16(central, 0);
+        le16(central, 0);
+        le32(central, (0100000u | mode) << 16);
+        le32(central, offset);
+        central += name;
+        ++count;
+    }
+
+    std::string finish() const {
+        std::string out = data + central;
+        le32(out, 0x06054b50);
+        le16(out, 0);
+        le16(out, 0);
+        le16(out, count);
+        le16(out, count);
+        le32(out, static_cast<uint32_t>(central.size()));
+        le32(out, static_cast<uint32_t>(data.size()));
+        le16(out, 0);
+        return out;
+    }
+};
+
+// ---- Helpers ----
+
+static std::string read_file(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+static fs::path fresh_dir(const std::string& name) {
+    fs::path dir = fs::temp_directory_path() / ("lemon_stream_extractor_test_" + name);
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir;
+}
+
+static bool extract(const std::string& archive_name, const std::string& bytes, const fs::path& dest,
+                    size_t chunk) {
+    auto extractor = StreamExtractor::create(archive_name, dest.string());
+    if (!extractor) {
+        return false;
+    }
+    for (size_t offset = 0; offset < bytes.size(); offset += chunk) {
+        const size_t length = std::min(chunk, bytes.size() - offset);
+        extractor->feed(bytes.data() + offset, length, offset);
+    }
+    return extractor->finish(bytes.size());
+}
+
+static std::string pattern(size_t size) {
+    std::string body(size, '\0');
+    for (size_t i = 0; i < size; ++i) {
+        body[i] = static_cast<char>((i * 31 + i / 7) & 0xff);
+    }
+    return body;
+}
+
+// ---- Tests ----
+
+static void test_tarball(TestResult& r) {
+    const std::string big = pattern(300000);
+    const std::string long_name = "llama/" + std::string(120, 'n') + ".txt";
+
+    std::string tar;
+    tar_entry(tar, "llama/", '5', "", 0755);
+    tar_entry(tar, "llama/bin/", '5', "", 0755);
+    tar_entry(tar, "llama/bin/llama-server", '0', big, 0755);
+    tar_entry(tar, "llama/README", '0', "hello\n");
+    tar_entry(tar, "llama/bin/alias", '2', "", 0777, "llama-server");
+    tar_entry(tar, "././@LongLink", 'L', long_name + '\0');
+    tar_entry(tar, long_name.substr(0, 100), '0', "long");
+    tar.append(1024, '\0');
+    const std::string archive = gzip(tar);
+
+    bool all_ok = true;
+    for (size_t chunk : {size_t(1), size_t(7), size_t(4096), archive.size()}) {
+        fs::path dest = fresh_dir("tar");
+        const bool ok = extract("llama-b1234-bin-ubuntu-x64.tar.gz", archive, dest, chunk) &&
+                        read_file(dest / "bin" / "llama-server") == big &&
+                        read_file(dest / "README") == "hello\n" &&
+                        read_file(dest / (std::string(120, 'n') + ".txt")) == "long";
+        if (!ok) {
+            printf("  chunk size %zu failed\n", chunk);
+        }
+        all_ok = all_ok && ok;
+    }
+    r.check(all_ok, "tar.gz extracts identically for every chunk size");
+
+    fs::path dest = fresh_dir("tar");
+    extract("x.tgz", archive, dest, 65536);
+    r.check(!fs::exists(dest / "llama"), "top-level directory is stripped");
+#ifndef _WIN32
+    r.check(fs::is_symlink(dest / "bin" / "alias") &&
+                fs::read_symlink(dest / "bin" / "alias") == "llama-server",
+            "symlinks are recreated");
+    struct stat st{};
+    stat((dest / "bin" / "llama-server").c_str(), &st);
+    r.check((st.st_mode & 0777) == 0755, "executable mode is kept");
+#endif
+}
+
+static void test_zip(TestResult& r) {
+    const std::string big = pattern(200000);
+    ZipBuilder zip;
+    zip.add("bin/", "", false, false, 0755);
+    zip.add("bin/sd-server", big, true, true, 0755);
+    zip.add("bin/notes.txt", "stored text", false, false, 0644);
+    zip.add("lib/libsd.so", big.substr(0, 5000), true, false, 0644);
+    const std::string archive = zip.finish();
+
+    bool all_ok = true;
+    for (size_t chunk : {size_t(1), size_t(13), size_t(8192), archive.size()}) {
+        fs::path dest = fresh_dir("zip");
+        const bool ok = extract("sd-master-bin-win-x64.zip", archive, dest, chunk) &&
+                        read_file(dest / "bin" / "sd-server") == big &&
+                        read_file(dest / "bin" / "notes.txt") == "stored text" &&
+                        read_file(dest / "lib" / "libsd.so") == big.substr(0, 5000);
+        if (!ok) {
+            printf("  chunk size %zu failed\n", chunk);
+        }
+        all_ok = all_ok && ok;
+    }
+    r.check(all_ok, "zip extracts identically for every chunk size");
+
+#ifndef _WIN32
+    fs::path dest = fresh_dir("zip");
+    extract("a.zip", archive, dest, 4096);
+    struct stat st{};
+    stat((dest / "bin" / "sd-server").c_str(), &st);
+    r.check((st.st_mode & 0777) == 0755, "zip applies Unix modes from the central directory");
+#endif
+
+    std::string corrupt = archive;
+    corrupt[corrupt.find("stored text")] = 'S';
+    r.check(!extract("a.zip", corrupt, fresh_dir("zip"), 4096), "CRC mismatch fails");
+}
+
+static void test_failures(TestResult& r) {
+    std::string tar;
+    tar_entry(tar, "top/ok.txt", '0', "fine");
+    tar_entry(tar, "top/../../escape.txt", '0', "bad");
+    tar.append(1024, '\0');
+    fs::path dest = fresh_dir("escape");
+    r.check(!extract("x.tar.gz", gzip(tar), dest, 512) && !fs::exists(dest.parent_path() / "escape.txt"),
+            "path traversal is rejected");
+
+    std::string clean;
+    tar_entry(clean, "top/a.txt", '0', "a");
+    clean.append(1024, '\0');
+    const std::string archive = gzip(clean);
+
+    auto gap = StreamExtractor::create("x.tar.gz", fresh_dir("gap").string());
+    gap->feed(archive.data(), 10, 0);
+    gap->feed(archive.data() + 20, archive.size() - 20, 20);
+    r.check(!gap->finish(archive.size()) && !gap->error().empty(), "a gap in the stream abandons extraction");
+
+    auto truncated = StreamExtractor::create("x.tar.gz", fresh_dir("short").string());
+    truncated->feed(archive.data(), archive.size() - 8, 0);
+    r.check(!truncated->finish(archive.size() - 8), "a truncated archive does not finish");
+
+    r.check(StreamExtractor::create("x.tar.bz2", fresh_dir("other").string()) == nullptr &&
+                StreamExtractor::create("x.exe", fresh_dir("other").string()) == nullptr,
+            "unsupported formats are declined");
+}
+
+int main() {
+    TestResult r;
+
+    test_tarball(r);
+    test_zip(r);
+    test_failures(r);
+
+    for (const char* name : {"tar", "zip", "escape", "gap", "short", "other"}) {
+        fs::remove_all(fs::temp_directory_path() / (std::string("lemon_stream_extractor_test_") + name));
+    }
+
+    printf("\n%d passed, %d failed\n", r.passed, r.failed);
+    return r.failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+// Standalone test for lemon::SystemMetricsSampler.
+//
+// Drives the sampler with a fake platform and checks that the ring buffer
+// keeps only the newest samples, that latest() and history(since) read them
+// back in order, that per-backend CPU is a delta between samples, and that
+// the background thread keeps sampling until stopped.
+//
+// Compile with:
+//   g++ -std=c++17 -pthread -I src/cpp/include test/cpp/test_system_metrics_sampler.cpp src/cpp/server/system_metrics_sampler.cpp -o system_metrics_sampler_test
+
+#include "lemon/system_metrics_sampler.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+using lemon::ProcessUsage;
+using lemon::SystemMetricsPlatform;
+using lemon::SystemMetricsSampler;
+
+struct TestResult {
+    int passed = 0;
+    int failed = 0;
+
+    void check(bool cond, const std::string& name) {
+        if (cond) {
+            printf("[PASS] %s\n", name.c_str());
+            ++passed;
+        } else {
+            printf("[FAIL] %s\n", name.c_str());
+            ++failed;
+        }
+    }
+};
+
+// Counts calls so the sample sequence is observable; the backend process
+// burns 50 ms of CPU time per call.
+class FakePlatform : public SystemMetricsPlatform {
+public:
+    std::atomic<int> calls{0};
+    std::atomic<uint64_t> backend_cpu_ns{0};
+
+    const char* get_platform_name() const override { return "fake"; }
+    double get_cpu_usage(std::mutex&, uint64_t&, uint64_t&) override { return ++calls; }
+    double get_memory_usage_gb() override { return 8.0; }
+    double get_gpu_usage() override { return -1.0; }
+    double get_vram_usage_gb() override { return 2.5; }
+    double get_npu_utilization() override { return -1.0; }
+
+    bool get_process_usage(int pid, ProcessUsage& usage) override {
+        if (pid != 42) {
+            return false;
+        }
+        usage.cpu_time_ns = backend_cpu_ns += 50000000ULL;
+        usage.rss_bytes = 1024ULL * 1024 * 1024;
+        return true;
+    }
+};
+
+static void test_ring_buffer(TestResult& r) {
+    auto platform = std::make_unique<FakePlatform>();
+    SystemMetricsSampler sampler(std::move(platform), 1000, 3);
+
+    r.check(sampler.history().empty() && sampler.latest().timestamp_ms == 0,
+            "empty sampler has no history");
+
+    for (int i = 0; i < 5; ++i) {
+        sampler.sample_now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    auto history = sampler.history();
+    r.check(history.size() == 3, "ring buffer keeps only `capacity` samples");
+    r.check(history.size() == 3 && history.front().cpu_percent == 3 && history.back().cpu_percent == 5,
+            "history is oldest first and drops the oldest samples");
+    r.check(sampler.latest().cpu_percent == 5, "latest() returns the newest sample");
+
+    auto newer = sampler.history(history[1].timestamp_ms);
+    r.check(newer.size() == 1 && newer[0].cpu_percent == 5, "history(since) excludes older samples");
+
+    auto json = sampler.latest().to_json();
+    r.check(json["gpu_percent"].is_null() && json["vram_gb"] == 2.5,
+            "unavailable metrics are reported as null");
+}
+
+static void test_backend_cpu_delta(TestResult& r) {
+    auto platform = std::make_unique<FakePlatform>();
+    SystemMetricsSampler sampler(std::move(platform), 1000, 10);
+    sampler.set_backend_provider([] {
+        return std::vector<std::pair<std::string, int>>{{"model-a", 42}, {"model-b", 7}};
+    });
+
+    sampler.sample_now();
+    auto first = sampler.latest();
+    r.check(first.backends.size() == 2 && first.backends[0].cpu_percent < 0,
+            "first sample has no CPU baseline yet");
+    r.check(first.backends.size() == 2 && first.backends[0].rss_gb == 1.0,
+            "backend RSS is reported in GB");
+    r.check(first.backends.size() == 2 && first.backends[1].rss_gb < 0,
+            "unreadable processes are reported as unavailable");
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    sampler.sample_now();
+    auto second = sampler.latest();
+    // 50 ms of CPU time over ~100 ms of wall time
+    double cpu = second.backends.empty() ? -1.0 : second.backends[0].cpu_percent;
+    r.check(cpu > 20.0 && cpu <= 50.0, "backend CPU is a delta between samples");
+}
+
+static void test_background_thread(TestResult& r) {
+    auto platform = std::make_unique<FakePlatform>();
+    SystemMetricsSampler sampler(std::move(platform), 50, 100);
+
+    sampler.start();
+    r.check(!sampler.history().empty(), "start() takes a sample synchronously");
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    sampler.stop();
+
+    size_t count = sampler.history().size();
+    r.check(count >= 3, "background thread samples at the configured cadence");
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    r.check(sampler.history().size() == count, "stop() ends sampling");
+}
+
+int main() {
+    TestResult r;
+    test_ring_buffer(r);
+    test_backend_cpu_delta(r);
+    test_background_thread(r);
+
+    printf("\n%d passed, %d failed\n", r.passed, r.failed);
+    return r.failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+// Standalone test for the realtime transcription scheduler.
+//
+// Holds the only worker on a blocking job while work queues up, then checks
+// the order it runs in: finals before interims, sessions round-robin, one job
+// per session at a time, and stale interims replaced by newer ones. Also
+// checks the per-model concurrency cap, closing sessions and shutdown.
+//
+// Compile with:
+//   g++ -std=c++17 -I src/cpp/include test/cpp/test_transcription_scheduler.cpp src/cpp/server/transcription_scheduler.cpp -o transcription_scheduler_test -pthread
+
+#include "lemon/transcription_scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using lemon::TranscriptionScheduler;
+using Kind = lemon::TranscriptionScheduler::Kind;
+
+struct TestResult {
+    int passed = 0;
+    int failed = 0;
+
+    void check(bool cond, const std::string& name) {
+        if (cond) {
+            printf("[PASS] %s\n", name.c_str());
+            ++passed;
+        } else {
+            printf("[FAIL] %s\n", name.c_str());
+            ++failed;
+        }
+    }
+};
+
+// Records the order jobs run in
+struct Recorder {
+    std::mutex mutex;
+    std::vector<std::string> order;
+
+    TranscriptionScheduler::Job job(const std::string& name) {
+        return [this, name] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(name);
+        };
+    }
+
+    std::vector<std::string> snapshot() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return order;
+    }
+};
+
+// Occupies a worker until released
+struct Blocker {
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+
+    TranscriptionScheduler::Job job() {
+        return [this] {
+            started.set_value();
+            released.wait();
+        };
+    }
+};
+
+static bool wait_for(const std::function<bool()>& done) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return true;
+}
+
+static uint64_t completed(const TranscriptionScheduler& scheduler) {
+    const auto stats = scheduler.get_stats();
+    return stats["final"]["completed_total"].get<uint64_t>() +
+           stats["interim"]["completed_total"].get<uint64_t>();
+}
+
+static void test_priority_and_fairness(TestResult& r) {
+    TranscriptionScheduler scheduler(nullptr, 1);
+    Recorder recorder;
+    Blocker blocker;
+    auto started = blocker.started.get_future();
+    scheduler.submit("busy", "whisper", Kind::Final, blocker.job());
+    started.wait();
+
+    scheduler.submit("a", "whisper", Kind::Interim, recorder.job("a-interim-1"));
+    scheduler.submit("b", "whisper", Kind::Interim, recorder.job("b-interim-1"));
+    scheduler.submit("b", "whisper", Kind::Interim, recorder.job("b-interim-2"));
+    scheduler.submit("a", "whisper", Kind::Final, recorder.job("a-final-1"));
+    scheduler.submit("a", "whisper", Kind::Final, recorder.job("a-final-2"));
+    scheduler.submit("c", "whisper", Kind::Final, recorder.job("c-final-1"));
+
+    const auto queued = scheduler.get_stats()["queued"];
+    r.check(queued["final"] == 3 && queued["interim"] == 1,
+            "a newer interim replaces the queued one and a final drops it");
+
+    blocker.release.set_value();
+    r.check(wait_for([&] { return completed(scheduler) == 5; }), "queued jobs run once the worker frees up");
+
+    const std::vector<std::string> expected = {"a-final-1", "c-final-1", "a-final-2", "b-interim-2"};
+    r.check(recorder.snapshot() == expected,
+            "finals run before interims and sessions take turns");
+
+    const auto stats = scheduler.get_stats();
+    r.check(stats["interim"]["dropped_total"] == 2 && stats["interim"]["submitted_total"] == 3,
+            "superseded interims are counted as dropped");
+}
+
+static void test_one_job_per_session(TestResult& r) {
+    TranscriptionScheduler scheduler(nullptr, 4);
+    std::atomic<int> running{0};
+    std::atomic<int> peak{0};
+    auto job = [&] {
+        const int now = ++running;
+        int seen = peak.load();
+        while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        --running;
+    };
+    for (int i = 0; i < 4; ++i) {
+        // Separate models so only the per-session rule applies
+        scheduler.submit("solo", "model-" + std::to_string(i), Kind::Final, job);
+    }
+    r.check(wait_for([&] { return completed(scheduler) == 4; }) && peak == 1,
+            "a session's jobs run one at a time");
+}
+
+static void test_model_capacity(TestResult& r) {
+    TranscriptionScheduler scheduler([](const std::string& model) { return model == "two" ? 2 : 0; }, 4);
+    std::mutex mutex;
+    std::map<std::string, int> running;
+    std::map<std::string, int> peak;
+    auto job = [&](const std::string& model) {
+        return [&, model] {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                peak[model] = std::max(peak[model], ++running[model]);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            std::lock_guard<std::mutex> lock(mutex);
+            --running[model];
+        };
+    };
+    for (int i = 0; i < 6; ++i) {
+        scheduler.submit("two-" + std::to_string(i), "two", Kind::Final, job("two"));
+        scheduler.submit("one-" + std::to_string(i), "one", Kind::Final, job("one"));
+    }
+    r.check(wait_for([&] { return completed(scheduler) == 12; }), "capped jobs all complete");
+    r.check(peak["two"] == 2 && peak["one"] == 1,
+            "each model runs at most its capacity, at least one");
+}
+
+static void test_close_and_shutdown(TestResult& r) {
+    TranscriptionScheduler scheduler(nullptr, 1);
+    Recorder recorder;
+    Blocker blocker;
+    auto started = blocker.started.get_future();
+    scheduler.submit("busy", "whisper", Kind::Final, blocker.job());
+    started.wait();
+
+    scheduler.submit("gone", "whisper", Kind::Final, recorder.job("gone-final"));
+    scheduler.submit("kept", "whisper", Kind::Interim, recorder.job("kept-interim"));
+    scheduler.submit("kept", "whisper", Kind::Final, recorder.job("kept-final"));
+    scheduler.submit("late", "whisper", Kind::Interim, recorder.job("late-interim"));
+    scheduler.close_session("gone");
+
+    const auto sessions = scheduler.get_stats()["sessions"];
+    r.check(std::none_of(sessions.begin(), sessions.end(),
+                         [](const lemon::json& s) { return s["session_id"] == "gone"; }),
+            "closing a session drops its queued jobs and stats");
+
+    std::thread release([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        blocker.release.set_value();
+    });
+    scheduler.shutdown();
+    release.join();
+    r.check(recorder.snapshot() == std::vector<std::string>({"kept-final"}),
+            "shutdown runs queued finals and drops interims");
+    r.check(!scheduler.submit("kept", "whisper", Kind::Final, recorder.job("after")),
+            "nothing is accepted after shutdown");
+
+    const auto stats = scheduler.get_stats();
+    r.check(stats["final"]["latency_seconds"]["count"] == 2 &&
+            stats["final"]["queue_wait_seconds"]["count"] == 2,
+            "latency is observed for every job that ran");
+    bool kept_reported = false;
+    for (const auto& session : stats["sessions"]) {
+        if (session["session_id"] == "kept") {
+            kept_reported = session["finals"] == 1 && session["final_latency_last_seconds"].get<double>() > 0.0;
+        }
+    }
+    r.check(kept_reported, "per-session final latency is reported for open sessions");
+}
+
+int main() {
+    TestResult r;
+    test_priority_and_fairness(r);
+    test_one_job_per_session(r);
+    test_model_capacity(r);
+    test_close_and_shutdown(r);
+
+    printf("\n%d passed, %d failed\n", r.passed, r.failed);
+    return r.failed == 0 ? 0 : 1;
+}
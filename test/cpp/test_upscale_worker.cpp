@@ -0,0 +1,146 @@
+// Standalone test for the primed sd-cli upscale worker pool.
+//
+// Drives the pool with a fake sd-cli script that echoes a PNG from its input
+// FIFO to its output FIFO and writes nothing for anything else. Checks that a
+// primed worker serves requests, that a bad image fails the request without
+// giving up on the worker, that an sd-cli which never opens its input sends
+// the model to one-shot runs, and that LEMONADE_UPSCALE_WORKER=0 skips the
+// workers entirely. POSIX only, like the workers themselves.
+//
+// Compile with:
+//   g++ -std=c++17 -I src/cpp/include test/cpp/test_upscale_worker.cpp src/cpp/server/backends/upscale_worker.cpp src/cpp/server/utils/process_manager.cpp src/cpp/server/utils/process_reactor.cpp src/cpp/server/utils/json_utils.cpp src/cpp/server/utils/path_utils.cpp src/cpp/server/utils/platform/path_linux.cpp src/cpp/server/utils/platform/process_unix.cpp -o upscale_worker_test -pthread
+
+#include "lemon/backends/upscale_worker.h"
+#include "lemon/utils/json_utils.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+using lemon::backends::UpscaleWorkerPool;
+using lemon::utils::JsonUtils;
+
+struct TestResult {
+    int passed = 0;
+    int failed = 0;
+
+    void check(bool cond, const std::string& name) {
+        if (cond) {
+            printf("[PASS] %s\n", name.c_str());
+            ++passed;
+        } else {
+            printf("[FAIL] %s\n", name.c_str());
+            ++failed;
+        }
+    }
+};
+
+#ifndef _WIN32
+static std::string write_script(const fs::path& path, const std::string& body) {
+    std::ofstream(path) << "#!/bin/sh\n" << body;
+    fs::permissions(path, fs::perms::owner_all);
+    return path.string();
+}
+
+// Echoes a PNG from -i to -o; anything else produces no output
+static const char* ECHO_CLI = R"sh(while [ $# -gt 0 ]; do
+  case "$1" in -i) in="$2"; shift ;; -o) out="$2"; shift ;; esac
+  shift
+done
+data="$(mktemp)"
+cat "$in" > "$data"
+if head -c 4 "$data" | grep -q PNG; then cat "$data" > "$out"; fi
+rm -f "$data"
+)sh";
+
+static std::string tiny_png() {
+    std::string png("\x89PNG\r\n\x1a\n", 8);
+    png += "IHDR-and-some-pixels";
+    png += std::string("\0\0\0\0IEND\xae\x42\x60\x82", 12);
+    return png;
+}
+
+struct OneShot {
+    std::atomic<int> calls{0};
+
+    UpscaleWorkerPool::OneShotFn fn() {
+        return [this](const std::string&, const std::string&, const std::string&,
+                      const UpscaleWorkerPool::EnvVars&) {
+            ++calls;
+            return std::string("one-shot");
+        };
+    }
+};
+
+static void test_primed_worker(TestResult& r, const fs::path& dir) {
+    const std::string cli = write_script(dir / "sd-cli-echo", ECHO_CLI);
+    OneShot one_shot;
+    UpscaleWorkerPool pool(one_shot.fn());
+    const std::string png = JsonUtils::base64_encode(tiny_png());
+
+    r.check(pool.upscale(png, "esrgan.pth", cli, {}) == png && one_shot.calls == 0,
+            "a worker upscales through its standby");
+    r.check(pool.standby_count() == 1, "the next standby is primed after a request");
+    r.check(pool.upscale(png, "esrgan.pth", cli, {}) == png && one_shot.calls == 0,
+            "the primed standby serves the next request");
+
+    r.check(pool.upscale(JsonUtils::base64_encode("not an image"), "esrgan.pth", cli, {}).empty() &&
+            one_shot.calls == 0,
+            "a bad image fails the request without a one-shot retry");
+    r.check(pool.upscale(png, "esrgan.pth", cli, {}) == png && one_shot.calls == 0,
+            "the worker keeps serving after a bad image");
+
+    pool.clear();
+    r.check(pool.standby_count() == 0, "clear() stops every standby");
+}
+
+static void test_broken_standby(TestResult& r, const fs::path& dir) {
+    const std::string cli = write_script(dir / "sd-cli-exits", "exit 1\n");
+    OneShot one_shot;
+    UpscaleWorkerPool pool(one_shot.fn());
+    const std::string png = JsonUtils::base64_encode(tiny_png());
+
+    r.check(pool.upscale(png, "esrgan.pth", cli, {}) == "one-shot" && one_shot.calls == 1,
+            "a standby that never opens its input falls back to a one-shot run");
+    r.check(pool.upscale(png, "esrgan.pth", cli, {}) == "one-shot" && one_shot.calls == 2 &&
+            pool.standby_count() == 0,
+            "the model then stays on one-shot runs");
+}
+
+static void test_disabled(TestResult& r, const fs::path& dir) {
+    const std::string cli = write_script(dir / "sd-cli-echo-2", ECHO_CLI);
+    setenv("LEMONADE_UPSCALE_WORKER", "0", 1);
+    OneShot one_shot;
+    UpscaleWorkerPool pool(one_shot.fn());
+    unsetenv("LEMONADE_UPSCALE_WORKER");
+
+    r.check(pool.upscale(JsonUtils::base64_encode(tiny_png()), "esrgan.pth", cli, {}) == "one-shot" &&
+            pool.standby_count() == 0,
+            "LEMONADE_UPSCALE_WORKER=0 uses one-shot runs only");
+}
+#endif
+
+int main() {
+    TestResult r;
+#ifndef _WIN32
+    const fs::path dir = fs::temp_directory_path() / "lemonade_upscale_worker_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "run");
+    fs::permissions(dir / "run", fs::perms::owner_all);
+    // Workers keep their FIFOs in the runtime directory
+    setenv("XDG_RUNTIME_DIR", (dir / "run").c_str(), 1);
+
+    test_primed_worker(r, dir);
+    test_broken_standby(r, dir);
+    test_disabled(r, dir);
+
+    fs::remove_all(dir);
+#endif
+
+    printf("\n%d passed, %d failed\n", r.passed, r.failed);
+    return r.failed == 0 ? 0 : 1;
+}